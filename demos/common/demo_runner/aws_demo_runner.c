@@ -43,6 +43,7 @@ extern void vStartMQTTEchoDemo( void );
 /* extern void vStartShadowDemoTasks( void ); */
 /* extern void vStartSimpleTCPServerTasks( void ); */
 /* extern void vStartSubpubDemoTasks( void ); */
+/* extern void vStartTCPBenchmarkTask( void ); */
 /* extern void vStartTCPEchoClientTasks_SeparateTasks( void ); */
 /* extern void vStartTCPEchoClientTasks_SingleTasks( void ); */
 
@@ -60,6 +61,7 @@ void DEMO_RUNNER_RunDemos( void )
     /* vStartShadowDemoTasks(); */
     /* vStartSimpleTCPServerTasks(); */
     /* vStartSubpubDemoTasks(); */
+    /* vStartTCPBenchmarkTask(); */
     /* vStartTCPEchoClientTasks_SeparateTasks(); */
     /* vStartTCPEchoClientTasks_SingleTasks(); */
 }
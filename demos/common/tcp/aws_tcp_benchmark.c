@@ -0,0 +1,743 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*
+ * A single task benchmarks the Secure Sockets API against the echo servers in
+ * tools/echo_server - echo_server.go for plaintext connections and
+ * tls_echo_server.go for TLS connections.  Both servers are expected to run on
+ * the host at the IP address set by the configECHO_SERVER_ADDR0 to
+ * configECHO_SERVER_ADDR3 constants.
+ *
+ * For each transport, and for democonfigTCP_BENCHMARK_ITERATIONS runs, the task
+ * measures:
+ *
+ * + Bulk throughput - democonfigTCP_BENCHMARK_BULK_BYTES are streamed to the
+ *   server with a bounded amount of data in flight, and the echo is drained as
+ *   it arrives.  The throughput reported is that of the echoed payload.
+ *
+ * + CPU cost per byte - the run time of every task other than the idle task
+ *   during the bulk transfer, divided by the number of bytes echoed.
+ *
+ * + Request/response latency - democonfigTCP_BENCHMARK_LATENCY_SAMPLES small
+ *   messages are sent one at a time and the round trip of each is recorded.
+ *   The minimum, 50th, 90th and 99th percentiles, and maximum are reported.
+ *
+ * + Connection setup rate - democonfigTCP_BENCHMARK_CONNECTIONS connections
+ *   are opened one after the other.  Only SOCKETS_Connect() is timed, so for
+ *   TLS connections the figure includes the handshake.
+ *
+ * Every result is printed as a single line JSON object, prefixed with
+ * benchRESULT_PREFIX so the lines can be picked out of the rest of the log and
+ * compared between builds.  Timing uses the run time stats counter when
+ * democonfigTCP_BENCHMARK_RUN_TIME_HZ gives its frequency, otherwise the tick
+ * count, in which case latencies are only as good as the tick period and the
+ * CPU cost is reported as 0.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* TCP/IP abstraction includes. */
+#include "aws_secure_sockets.h"
+
+/* Demo configuration */
+#include "aws_demo_config.h"
+#include "aws_tcp_benchmark.h"
+
+/* Sanity check the configuration constants required by this demo are
+ * present. */
+#if !defined( configECHO_SERVER_ADDR0 ) || !defined( configECHO_SERVER_ADDR1 ) || !defined( configECHO_SERVER_ADDR2 ) || !defined( configECHO_SERVER_ADDR3 )
+    #error configECHO_SERVER_ADDR0 to configECHO_SERVER_ADDR3 must be defined in FreeRTOSConfig.h to specify the IP address of the echo server.
+#endif
+
+/* The ports used by echo_server.go and tls_echo_server.go respectively. */
+#ifndef democonfigTCP_BENCHMARK_PORT
+    #define democonfigTCP_BENCHMARK_PORT    ( 9001 )
+#endif
+
+#ifndef democonfigTCP_BENCHMARK_TLS_PORT
+    #define democonfigTCP_BENCHMARK_TLS_PORT    ( 9000 )
+#endif
+
+/* Set to 0 to benchmark the plaintext server only. */
+#ifndef democonfigTCP_BENCHMARK_TLS_ENABLED
+    #define democonfigTCP_BENCHMARK_TLS_ENABLED    ( 1 )
+#endif
+
+/* The number of times the full set of measurements is repeated. */
+#ifndef democonfigTCP_BENCHMARK_ITERATIONS
+    #define democonfigTCP_BENCHMARK_ITERATIONS    ( 3 )
+#endif
+
+/* The number of bytes echoed by the throughput test. */
+#ifndef democonfigTCP_BENCHMARK_BULK_BYTES
+    #define democonfigTCP_BENCHMARK_BULK_BYTES    ( 1024UL * 1024UL )
+#endif
+
+/* The number of round trips timed by the latency test, and the size of the
+ * message used for each. */
+#ifndef democonfigTCP_BENCHMARK_LATENCY_SAMPLES
+    #define democonfigTCP_BENCHMARK_LATENCY_SAMPLES    ( 200 )
+#endif
+
+#ifndef democonfigTCP_BENCHMARK_LATENCY_MESSAGE_SIZE
+    #define democonfigTCP_BENCHMARK_LATENCY_MESSAGE_SIZE    ( 64 )
+#endif
+
+/* The number of connections opened by the connection setup test. */
+#ifndef democonfigTCP_BENCHMARK_CONNECTIONS
+    #define democonfigTCP_BENCHMARK_CONNECTIONS    ( 20 )
+#endif
+
+/* Use the run time stats counter as the clock when its frequency is known,
+ * otherwise fall back to the tick count. */
+#if ( configGENERATE_RUN_TIME_STATS == 1 ) && defined( portGET_RUN_TIME_COUNTER_VALUE ) && defined( democonfigTCP_BENCHMARK_RUN_TIME_HZ )
+    #define benchCLOCK_HZ    ( ( uint32_t ) democonfigTCP_BENCHMARK_RUN_TIME_HZ )
+    #define benchNOW()       ( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+
+    /* The CPU cost is derived from the per task run time counters, which
+     * need the trace facility to be read. */
+    #if ( configUSE_TRACE_FACILITY == 1 )
+        #define benchCPU_COST_AVAILABLE    1
+    #endif
+#else
+    #define benchCLOCK_HZ    ( ( uint32_t ) configTICK_RATE_HZ )
+    #define benchNOW()       ( ( uint32_t ) xTaskGetTickCount() )
+#endif
+
+#ifndef benchCPU_COST_AVAILABLE
+    #define benchCPU_COST_AVAILABLE    0
+#endif
+
+/* Matches the default in tasks.c - used to find the idle task(s) when the
+ * task states are read. */
+#ifndef configIDLE_TASK_NAME
+    #define configIDLE_TASK_NAME    "IDLE"
+#endif
+
+/* Every result line starts with this so it can be grepped out of the log. */
+#define benchRESULT_PREFIX           "BENCH "
+
+/* Size of the buffer used for each send and receive in the throughput test,
+ * and the most data allowed to be outstanding at the echo server.  The in
+ * flight limit keeps the task from blocking in SOCKETS_Send() while the echo
+ * of earlier data sits unread in the receive buffer. */
+#define benchCHUNK_SIZE              ( 1024 )
+#define benchMAX_IN_FLIGHT           ( 4 * benchCHUNK_SIZE )
+
+/* Round trips made before the latency samples are taken, so the first
+ * samples are not skewed by ARP, slow start and the like. */
+#define benchWARM_UP_EXCHANGES       ( 10 )
+
+/* Rx and Tx time outs are used to ensure the sockets do not wait too long for
+ * missing data. */
+#define benchSOCKET_TIME_OUT         pdMS_TO_TICKS( 5000 )
+
+/* Pause between tests so the previous connection has closed down and the
+ * network is quiet before the next measurement starts. */
+#define benchSETTLE_DELAY            pdMS_TO_TICKS( 500 )
+
+/*
+ * PEM-encoded certificate of tls_echo_server.go, see
+ * tools/echo_server/readme-gencert.txt.
+ *
+ * Must include the PEM header and footer:
+ * "-----BEGIN CERTIFICATE-----\n"\
+ * "...base64 data...\n"\
+ * "-----END CERTIFICATE-----\n"
+ */
+#if ( democonfigTCP_BENCHMARK_TLS_ENABLED == 1 )
+    static const char cBenchECHO_SERVER_CERTIFICATE_PEM[] = "Paste the echo server certificate here.";
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Runs every measurement democonfigTCP_BENCHMARK_ITERATIONS times, then
+ * deletes itself.
+ */
+static void prvBenchmarkTask( void * pvParameters );
+
+/*
+ * Opens a connection to the plaintext or TLS echo server.  Returns
+ * SOCKETS_INVALID_SOCKET if the connection could not be made.
+ */
+static Socket_t prvConnect( BaseType_t xUseTls );
+
+/*
+ * Shuts down and closes a connection opened by prvConnect().
+ */
+static void prvDisconnect( Socket_t xSocket );
+
+/*
+ * Sends or receives exactly xLength bytes, returning pdFAIL on an error or
+ * time out.
+ */
+static BaseType_t prvSendAll( Socket_t xSocket,
+                              const char * pcBuffer,
+                              size_t xLength );
+static BaseType_t prvReceiveAll( Socket_t xSocket,
+                                 char * pcBuffer,
+                                 size_t xLength );
+
+/*
+ * The individual measurements.  Each prints a result line.
+ */
+static BaseType_t prvMeasureThroughput( Socket_t xSocket,
+                                        const char * pcTransport,
+                                        uint32_t ulRun );
+static BaseType_t prvMeasureLatency( Socket_t xSocket,
+                                     const char * pcTransport,
+                                     uint32_t ulRun );
+static BaseType_t prvMeasureConnectionSetup( BaseType_t xUseTls,
+                                             const char * pcTransport,
+                                             uint32_t ulRun );
+
+/*
+ * qsort() comparison function for the samples.
+ */
+static int prvCompareSamples( const void * pvLeft,
+                              const void * pvRight );
+
+/*
+ * Sorts ulSampleCount samples in place and prints the percentiles.
+ */
+static void prvPrintPercentiles( const char * pcTransport,
+                                 const char * pcTest,
+                                 uint32_t ulRun,
+                                 uint32_t * pulSamples,
+                                 uint32_t ulSampleCount );
+
+/*
+ * Converts a number of clock counts to microseconds.
+ */
+static uint32_t prvToMicroseconds( uint32_t ulCounts );
+
+#if ( benchCPU_COST_AVAILABLE == 1 )
+
+/*
+ * Returns the accumulated run time of the idle task(s), and the run time
+ * counter value at which it was read.
+ */
+    static uint32_t prvIdleRunTime( uint32_t * pulTotalRunTime );
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Payload and receive buffers.  The payload is a fixed pattern so every run
+ * sends the same bytes. */
+static char cTxBuffer[ benchCHUNK_SIZE ], cRxBuffer[ benchCHUNK_SIZE ];
+
+/* Round trip or connection setup time of each sample, in clock counts. */
+static uint32_t ulSamples[ ( democonfigTCP_BENCHMARK_LATENCY_SAMPLES > democonfigTCP_BENCHMARK_CONNECTIONS ) ? democonfigTCP_BENCHMARK_LATENCY_SAMPLES : democonfigTCP_BENCHMARK_CONNECTIONS ];
+
+/*-----------------------------------------------------------*/
+
+void vStartTCPBenchmarkTask( void )
+{
+    xTaskCreate( prvBenchmarkTask,                           /* The function that implements the task. */
+                 "TCPBench",                                 /* Just a text name for the task to aid debugging. */
+                 democonfigTCP_BENCHMARK_TASK_STACK_SIZE,    /* The stack size is defined in aws_demo_config.h. */
+                 NULL,                                       /* The task parameter, not used in this case. */
+                 democonfigTCP_BENCHMARK_TASK_PRIORITY,      /* The priority assigned to the task is defined in aws_demo_config.h. */
+                 NULL );                                     /* The task handle is not used. */
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void * pvParameters )
+{
+    const char * const pcTransports[] = { "tcp", "tls" };
+    const BaseType_t xTransportCount = ( democonfigTCP_BENCHMARK_TLS_ENABLED == 1 ) ? 2 : 1;
+    BaseType_t xTransport;
+    uint32_t ulRun, ulByte;
+    Socket_t xSocket;
+
+    /* Remove compiler warnings about unused parameters. */
+    ( void ) pvParameters;
+
+    for( ulByte = 0; ulByte < benchCHUNK_SIZE; ulByte++ )
+    {
+        cTxBuffer[ ulByte ] = ( char ) ( 'a' + ( ulByte % 26UL ) );
+    }
+
+    /* Record the parameters alongside the results so runs made with different
+     * settings are not compared by mistake. */
+    configPRINTF( ( benchRESULT_PREFIX "{\"test\":\"config\",\"server\":\"%d.%d.%d.%d\",\"port\":%d,\"tls_port\":%d,"
+                    "\"iterations\":%d,\"bulk_bytes\":%lu,\"chunk\":%d,\"in_flight\":%d,\"latency_samples\":%d,"
+                    "\"message_size\":%d,\"connections\":%d,\"clock_hz\":%lu}\r\n",
+                    configECHO_SERVER_ADDR0,
+                    configECHO_SERVER_ADDR1,
+                    configECHO_SERVER_ADDR2,
+                    configECHO_SERVER_ADDR3,
+                    democonfigTCP_BENCHMARK_PORT,
+                    democonfigTCP_BENCHMARK_TLS_PORT,
+                    democonfigTCP_BENCHMARK_ITERATIONS,
+                    ( unsigned long ) democonfigTCP_BENCHMARK_BULK_BYTES,
+                    benchCHUNK_SIZE,
+                    benchMAX_IN_FLIGHT,
+                    democonfigTCP_BENCHMARK_LATENCY_SAMPLES,
+                    democonfigTCP_BENCHMARK_LATENCY_MESSAGE_SIZE,
+                    democonfigTCP_BENCHMARK_CONNECTIONS,
+                    ( unsigned long ) benchCLOCK_HZ ) );
+
+    for( ulRun = 0; ulRun < ( uint32_t ) democonfigTCP_BENCHMARK_ITERATIONS; ulRun++ )
+    {
+        for( xTransport = 0; xTransport < xTransportCount; xTransport++ )
+        {
+            /* Throughput and latency share one connection. */
+            xSocket = prvConnect( xTransport );
+
+            if( xSocket == SOCKETS_INVALID_SOCKET )
+            {
+                configPRINTF( ( benchRESULT_PREFIX "{\"test\":\"error\",\"transport\":\"%s\",\"run\":%lu,\"reason\":\"connect\"}\r\n",
+                                pcTransports[ xTransport ],
+                                ( unsigned long ) ulRun ) );
+                continue;
+            }
+
+            if( prvMeasureThroughput( xSocket, pcTransports[ xTransport ], ulRun ) == pdPASS )
+            {
+                ( void ) prvMeasureLatency( xSocket, pcTransports[ xTransport ], ulRun );
+            }
+
+            prvDisconnect( xSocket );
+            vTaskDelay( benchSETTLE_DELAY );
+
+            ( void ) prvMeasureConnectionSetup( xTransport, pcTransports[ xTransport ], ulRun );
+            vTaskDelay( benchSETTLE_DELAY );
+        }
+    }
+
+    configPRINTF( ( benchRESULT_PREFIX "{\"test\":\"done\"}\r\n" ) );
+
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static Socket_t prvConnect( BaseType_t xUseTls )
+{
+    Socket_t xSocket;
+    SocketsSockaddr_t xEchoServerAddress;
+    const TickType_t xTimeOut = benchSOCKET_TIME_OUT;
+
+    xEchoServerAddress.usPort = SOCKETS_htons( ( xUseTls != pdFALSE ) ? democonfigTCP_BENCHMARK_TLS_PORT : democonfigTCP_BENCHMARK_PORT );
+    xEchoServerAddress.ulAddress = SOCKETS_inet_addr_quick( configECHO_SERVER_ADDR0,
+                                                            configECHO_SERVER_ADDR1,
+                                                            configECHO_SERVER_ADDR2,
+                                                            configECHO_SERVER_ADDR3 );
+
+    xSocket = SOCKETS_Socket( SOCKETS_AF_INET, SOCKETS_SOCK_STREAM, SOCKETS_IPPROTO_TCP );
+
+    if( xSocket != SOCKETS_INVALID_SOCKET )
+    {
+        SOCKETS_SetSockOpt( xSocket, 0, SOCKETS_SO_RCVTIMEO, &xTimeOut, sizeof( xTimeOut ) );
+        SOCKETS_SetSockOpt( xSocket, 0, SOCKETS_SO_SNDTIMEO, &xTimeOut, sizeof( xTimeOut ) );
+
+        #if ( democonfigTCP_BENCHMARK_TLS_ENABLED == 1 )
+            {
+                if( xUseTls != pdFALSE )
+                {
+                    SOCKETS_SetSockOpt( xSocket, 0, SOCKETS_SO_REQUIRE_TLS, NULL, ( size_t ) 0 );
+                    SOCKETS_SetSockOpt( xSocket, 0, SOCKETS_SO_TRUSTED_SERVER_CERTIFICATE, cBenchECHO_SERVER_CERTIFICATE_PEM, sizeof( cBenchECHO_SERVER_CERTIFICATE_PEM ) );
+                }
+            }
+        #endif /* democonfigTCP_BENCHMARK_TLS_ENABLED */
+
+        if( SOCKETS_Connect( xSocket, &xEchoServerAddress, sizeof( xEchoServerAddress ) ) != SOCKETS_ERROR_NONE )
+        {
+            ( void ) SOCKETS_Close( xSocket );
+            xSocket = SOCKETS_INVALID_SOCKET;
+        }
+    }
+
+    return xSocket;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDisconnect( Socket_t xSocket )
+{
+    TickType_t xTimeOnEntering;
+
+    /* Initiate a graceful close, then wait for SOCKETS_Recv() to return an
+     * error to show the shutdown is complete. */
+    SOCKETS_Shutdown( xSocket, SOCKETS_SHUT_RDWR );
+    xTimeOnEntering = xTaskGetTickCount();
+
+    do
+    {
+        if( SOCKETS_Recv( xSocket, cRxBuffer, sizeof( cRxBuffer ), 0 ) < 0 )
+        {
+            break;
+        }
+    } while( ( xTaskGetTickCount() - xTimeOnEntering ) < benchSOCKET_TIME_OUT );
+
+    ( void ) SOCKETS_Close( xSocket );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSendAll( Socket_t xSocket,
+                              const char * pcBuffer,
+                              size_t xLength )
+{
+    size_t xSent = 0;
+    int32_t lReturned;
+    BaseType_t xReturn = pdPASS;
+
+    while( xSent < xLength )
+    {
+        lReturned = SOCKETS_Send( xSocket, &( pcBuffer[ xSent ] ), xLength - xSent, 0 );
+
+        if( lReturned <= 0 )
+        {
+            xReturn = pdFAIL;
+            break;
+        }
+
+        xSent += ( size_t ) lReturned;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReceiveAll( Socket_t xSocket,
+                                 char * pcBuffer,
+                                 size_t xLength )
+{
+    size_t xReceived = 0;
+    int32_t lReturned;
+    BaseType_t xReturn = pdPASS;
+
+    while( xReceived < xLength )
+    {
+        lReturned = SOCKETS_Recv( xSocket, &( pcBuffer[ xReceived ] ), xLength - xReceived, 0 );
+
+        if( lReturned <= 0 )
+        {
+            xReturn = pdFAIL;
+            break;
+        }
+
+        xReceived += ( size_t ) lReturned;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvMeasureThroughput( Socket_t xSocket,
+                                        const char * pcTransport,
+                                        uint32_t ulRun )
+{
+    uint32_t ulSent = 0, ulReceived = 0, ulStart, ulElapsed, ulLength;
+    uint32_t ulKbps, ulCpuNsPerKB = 0;
+    int32_t lReturned;
+    BaseType_t xReturn = pdPASS;
+
+    #if ( benchCPU_COST_AVAILABLE == 1 )
+        uint32_t ulIdleStart, ulIdleEnd, ulTotalStart, ulTotalEnd, ulBusy;
+
+        ulIdleStart = prvIdleRunTime( &ulTotalStart );
+    #endif
+
+    ulStart = benchNOW();
+
+    while( ulReceived < democonfigTCP_BENCHMARK_BULK_BYTES )
+    {
+        /* Keep sending while there is room in flight, otherwise drain the
+         * echo.  Without the limit both directions could fill at once and
+         * SOCKETS_Send() would block until it timed out. */
+        if( ( ulSent < democonfigTCP_BENCHMARK_BULK_BYTES ) &&
+            ( ( ulSent - ulReceived ) + benchCHUNK_SIZE <= benchMAX_IN_FLIGHT ) )
+        {
+            ulLength = democonfigTCP_BENCHMARK_BULK_BYTES - ulSent;
+
+            if( ulLength > benchCHUNK_SIZE )
+            {
+                ulLength = benchCHUNK_SIZE;
+            }
+
+            lReturned = SOCKETS_Send( xSocket, cTxBuffer, ulLength, 0 );
+
+            if( lReturned <= 0 )
+            {
+                xReturn = pdFAIL;
+                break;
+            }
+
+            ulSent += ( uint32_t ) lReturned;
+        }
+        else
+        {
+            lReturned = SOCKETS_Recv( xSocket, cRxBuffer, sizeof( cRxBuffer ), 0 );
+
+            if( lReturned <= 0 )
+            {
+                xReturn = pdFAIL;
+                break;
+            }
+
+            ulReceived += ( uint32_t ) lReturned;
+        }
+    }
+
+    ulElapsed = benchNOW() - ulStart;
+
+    if( xReturn != pdPASS )
+    {
+        configPRINTF( ( benchRESULT_PREFIX "{\"test\":\"error\",\"transport\":\"%s\",\"run\":%lu,\"reason\":\"throughput\",\"bytes\":%lu}\r\n",
+                        pcTransport,
+                        ( unsigned long ) ulRun,
+                        ( unsigned long ) ulReceived ) );
+    }
+    else
+    {
+        if( ulElapsed == 0 )
+        {
+            ulElapsed = 1;
+        }
+
+        ulKbps = ( uint32_t ) ( ( ( uint64_t ) ulReceived * 8ULL * benchCLOCK_HZ ) / ( ( uint64_t ) ulElapsed * 1000ULL ) );
+
+        #if ( benchCPU_COST_AVAILABLE == 1 )
+            {
+                /* Time the CPU was not idle during the transfer, which covers
+                 * the IP task, the TLS library and this task alike. */
+                ulIdleEnd = prvIdleRunTime( &ulTotalEnd );
+                ulBusy = ( ulTotalEnd - ulTotalStart ) - ( ulIdleEnd - ulIdleStart );
+
+                if( ulBusy > ( ulTotalEnd - ulTotalStart ) )
+                {
+                    ulBusy = 0;
+                }
+
+                ulCpuNsPerKB = ( uint32_t ) ( ( ( uint64_t ) ulBusy * 1000000000ULL ) / benchCLOCK_HZ * 1024ULL / ulReceived );
+            }
+        #endif
+
+        configPRINTF( ( benchRESULT_PREFIX "{\"test\":\"throughput\",\"transport\":\"%s\",\"run\":%lu,\"bytes\":%lu,"
+                        "\"us\":%lu,\"kbps\":%lu,\"cpu_ns_per_kb\":%lu}\r\n",
+                        pcTransport,
+                        ( unsigned long ) ulRun,
+                        ( unsigned long ) ulReceived,
+                        ( unsigned long ) prvToMicroseconds( ulElapsed ),
+                        ( unsigned long ) ulKbps,
+                        ( unsigned long ) ulCpuNsPerKB ) );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvMeasureLatency( Socket_t xSocket,
+                                     const char * pcTransport,
+                                     uint32_t ulRun )
+{
+    uint32_t ulExchange, ulStart;
+    const size_t xLength = democonfigTCP_BENCHMARK_LATENCY_MESSAGE_SIZE;
+    BaseType_t xReturn = pdPASS;
+
+    configASSERT( xLength <= sizeof( cTxBuffer ) );
+
+    for( ulExchange = 0; ulExchange < ( benchWARM_UP_EXCHANGES + democonfigTCP_BENCHMARK_LATENCY_SAMPLES ); ulExchange++ )
+    {
+        ulStart = benchNOW();
+
+        if( ( prvSendAll( xSocket, cTxBuffer, xLength ) != pdPASS ) ||
+            ( prvReceiveAll( xSocket, cRxBuffer, xLength ) != pdPASS ) ||
+            ( memcmp( cTxBuffer, cRxBuffer, xLength ) != 0 ) )
+        {
+            xReturn = pdFAIL;
+            break;
+        }
+
+        if( ulExchange >= benchWARM_UP_EXCHANGES )
+        {
+            ulSamples[ ulExchange - benchWARM_UP_EXCHANGES ] = benchNOW() - ulStart;
+        }
+    }
+
+    if( xReturn != pdPASS )
+    {
+        configPRINTF( ( benchRESULT_PREFIX "{\"test\":\"error\",\"transport\":\"%s\",\"run\":%lu,\"reason\":\"latency\"}\r\n",
+                        pcTransport,
+                        ( unsigned long ) ulRun ) );
+    }
+    else
+    {
+        prvPrintPercentiles( pcTransport, "latency", ulRun, ulSamples, democonfigTCP_BENCHMARK_LATENCY_SAMPLES );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvMeasureConnectionSetup( BaseType_t xUseTls,
+                                             const char * pcTransport,
+                                             uint32_t ulRun )
+{
+    uint32_t ulConnection, ulStart, ulTotal = 0;
+    Socket_t xSocket;
+    BaseType_t xReturn = pdPASS;
+
+    for( ulConnection = 0; ulConnection < democonfigTCP_BENCHMARK_CONNECTIONS; ulConnection++ )
+    {
+        ulStart = benchNOW();
+        xSocket = prvConnect( xUseTls );
+        ulSamples[ ulConnection ] = benchNOW() - ulStart;
+
+        if( xSocket == SOCKETS_INVALID_SOCKET )
+        {
+            xReturn = pdFAIL;
+            break;
+        }
+
+        ulTotal += ulSamples[ ulConnection ];
+
+        /* Closing is not part of the measurement. */
+        prvDisconnect( xSocket );
+    }
+
+    if( xReturn != pdPASS )
+    {
+        configPRINTF( ( benchRESULT_PREFIX "{\"test\":\"error\",\"transport\":\"%s\",\"run\":%lu,\"reason\":\"connect\",\"connections\":%lu}\r\n",
+                        pcTransport,
+                        ( unsigned long ) ulRun,
+                        ( unsigned long ) ulConnection ) );
+    }
+    else
+    {
+        if( ulTotal == 0 )
+        {
+            ulTotal = 1;
+        }
+
+        /* Connections per second, scaled by 100 to keep two decimal places
+         * without printing floating point. */
+        configPRINTF( ( benchRESULT_PREFIX "{\"test\":\"connect_rate\",\"transport\":\"%s\",\"run\":%lu,\"connections\":%lu,"
+                        "\"us\":%lu,\"per_sec_x100\":%lu}\r\n",
+                        pcTransport,
+                        ( unsigned long ) ulRun,
+                        ( unsigned long ) ulConnection,
+                        ( unsigned long ) prvToMicroseconds( ulTotal ),
+                        ( unsigned long ) ( ( ( uint64_t ) ulConnection * benchCLOCK_HZ * 100ULL ) / ulTotal ) ) );
+
+        prvPrintPercentiles( pcTransport, "connect", ulRun, ulSamples, ulConnection );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareSamples( const void * pvLeft,
+                              const void * pvRight )
+{
+    uint32_t ulLeft = *( ( const uint32_t * ) pvLeft );
+    uint32_t ulRight = *( ( const uint32_t * ) pvRight );
+
+    return ( ulLeft > ulRight ) - ( ulLeft < ulRight );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintPercentiles( const char * pcTransport,
+                                 const char * pcTest,
+                                 uint32_t ulRun,
+                                 uint32_t * pulSamples,
+                                 uint32_t ulSampleCount )
+{
+    /* Nearest rank on the sorted samples. */
+    #define benchPERCENTILE( ulPercent )    prvToMicroseconds( pulSamples[ ( ( ulSampleCount - 1UL ) * ( ulPercent ) ) / 100UL ] )
+
+    configASSERT( ulSampleCount > 0 );
+
+    qsort( pulSamples, ulSampleCount, sizeof( uint32_t ), prvCompareSamples );
+
+    configPRINTF( ( benchRESULT_PREFIX "{\"test\":\"%s\",\"transport\":\"%s\",\"run\":%lu,\"samples\":%lu,"
+                    "\"min_us\":%lu,\"p50_us\":%lu,\"p90_us\":%lu,\"p99_us\":%lu,\"max_us\":%lu}\r\n",
+                    pcTest,
+                    pcTransport,
+                    ( unsigned long ) ulRun,
+                    ( unsigned long ) ulSampleCount,
+                    ( unsigned long ) benchPERCENTILE( 0UL ),
+                    ( unsigned long ) benchPERCENTILE( 50UL ),
+                    ( unsigned long ) benchPERCENTILE( 90UL ),
+                    ( unsigned long ) benchPERCENTILE( 99UL ),
+                    ( unsigned long ) benchPERCENTILE( 100UL ) ) );
+
+    #undef benchPERCENTILE
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvToMicroseconds( uint32_t ulCounts )
+{
+    return ( uint32_t ) ( ( ( uint64_t ) ulCounts * 1000000ULL ) / benchCLOCK_HZ );
+}
+/*-----------------------------------------------------------*/
+
+#if ( benchCPU_COST_AVAILABLE == 1 )
+
+    static uint32_t prvIdleRunTime( uint32_t * pulTotalRunTime )
+    {
+        TaskStatus_t * pxTaskStatus;
+        UBaseType_t uxTasks, uxTask;
+        uint32_t ulIdle = 0;
+        const size_t xIdleNameLength = sizeof( configIDLE_TASK_NAME ) - 1;
+
+        *pulTotalRunTime = benchNOW();
+
+        /* Allow for a few tasks being created between the two calls. */
+        uxTasks = uxTaskGetNumberOfTasks() + 4;
+        pxTaskStatus = pvPortMalloc( uxTasks * sizeof( TaskStatus_t ) );
+
+        if( pxTaskStatus != NULL )
+        {
+            uxTasks = uxTaskGetSystemState( pxTaskStatus, uxTasks, pulTotalRunTime );
+
+            /* Compare only the prefix so every idle task is counted on ports
+             * that number them. */
+            for( uxTask = 0; uxTask < uxTasks; uxTask++ )
+            {
+                if( strncmp( pxTaskStatus[ uxTask ].pcTaskName, configIDLE_TASK_NAME, xIdleNameLength ) == 0 )
+                {
+                    ulIdle += pxTaskStatus[ uxTask ].ulRunTimeCounter;
+                }
+            }
+
+            vPortFree( pxTaskStatus );
+        }
+
+        return ulIdle;
+    }
+
+#endif /* benchCPU_COST_AVAILABLE */
+/*-----------------------------------------------------------*/
@@ -0,0 +1,435 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Compares aebACTIVITIES lightweight activities implemented as native tasks
+ * with the same activities implemented as async tasks sharing one async engine.
+ * The activities form a ring, and pass a token around it by notifying the next
+ * activity in the ring.  The benchmark reports the heap used by each activity
+ * and how long the token takes to make aebHOPS hops.  Each native task
+ * allocates a TCB and a stack from the heap.  On the simulator the stack is
+ * nominal as the task really runs on its host thread's stack, so on hardware,
+ * where each stack must hold the task's deepest call chain, the difference is
+ * larger than reported.  The benchmark then checks that async tasks can await
+ * queues, semaphores and delays, and that awaits time out as documented.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "async_engine.h"
+
+/* The number of activities in the ring. */
+#define aebACTIVITIES           ( 64U )
+
+/* The number of times the token is passed from one activity to the next. */
+#define aebHOPS                 ( 64000UL )
+
+/* The length of the queue awaited by the checks. */
+#define aebQUEUE_LENGTH         ( 4U )
+
+/* The number of items the checks send to the queue. */
+#define aebQUEUE_ITEMS          ( 3U )
+
+/* The timeout and delay used by the checks, in ticks. */
+#define aebTIMEOUT_TICKS        ( pdMS_TO_TICKS( 20 ) )
+
+/* The native tasks and the engine's host task run below the benchmark task, so
+ * only run once the benchmark task blocks. */
+#define aebACTIVITY_PRIORITY    ( tskIDLE_PRIORITY + 1 )
+
+/*-----------------------------------------------------------*/
+
+/* The state of one activity in the ring of async tasks. */
+typedef struct AsyncRingActivity
+{
+    AsyncTask_t xTask;
+    AsyncTask_t * pxNext; /* The next activity in the ring. */
+    BaseType_t xResult;
+} AsyncRingActivity_t;
+
+/* The state of the async task that performs the checks, which must persist
+ * across awaits. */
+typedef struct AsyncCheckContext
+{
+    AsyncTask_t xTask;
+    TickType_t xStartTime;
+    TickType_t xReceiveTimeoutTicks; /* How long a receive from the empty queue waited. */
+    TickType_t xDelayTicks;          /* How long asyncDELAY() waited. */
+    TickType_t xSendTimeoutTicks;    /* How long a send to the full queue waited. */
+    BaseType_t xReceiveTimeoutResult;
+    BaseType_t xTakeResult;
+    BaseType_t xSendTimeoutResult;
+    BaseType_t xResult;
+    uint32_t ulItem;
+    uint32_t ulItemTotal;
+    UBaseType_t uxItemsReceived;
+} AsyncCheckContext_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that hosts the engine.
+ */
+static void prvHostTask( void * pvParameters );
+
+/*
+ * One activity in the ring of native tasks.  Waits for the token, then passes
+ * it on, until the benchmark stops the ring.
+ */
+static void prvNativeRingTask( void * pvParameters );
+
+/*
+ * One activity in the ring of async tasks.
+ */
+static void prvAsyncRingTask( AsyncTask_t * pxTask,
+                              void * pvParameters );
+
+/*
+ * Passes the token on from an activity, or notifies the benchmark task once
+ * the token has made aebHOPS hops.
+ */
+static BaseType_t prvPassToken( void );
+
+/*
+ * Creates the ring of native tasks, passes the token around it, then deletes
+ * the tasks.
+ */
+static void prvRunNativeRing( void );
+
+/*
+ * Starts the ring of async tasks, passes the token around it, then ends the
+ * tasks.
+ */
+static void prvRunAsyncRing( void );
+
+/*
+ * The async task that performs the checks.
+ */
+static void prvAsyncCheckTask( AsyncTask_t * pxTask,
+                               void * pvParameters );
+
+/*
+ * Starts prvAsyncCheckTask(), feeds it the items and the semaphore it awaits,
+ * then checks the results.
+ */
+static void prvCheckAwaits( void );
+
+/*-----------------------------------------------------------*/
+
+/* The task running the benchmark. */
+static TaskHandle_t xBenchmarkTask = NULL;
+
+/* The engine used by the async tasks, and the objects they await. */
+static AsyncEngineHandle_t xEngine = NULL;
+static QueueHandle_t xCheckQueue = NULL;
+static SemaphoreHandle_t xCheckSemaphore = NULL;
+static QueueHandle_t xFullQueue = NULL;
+
+/* The number of hops the token still has to make, and whether the ring is being
+ * stopped.  Only one activity holds the token at a time. */
+static volatile uint32_t ulHopsRemaining = 0UL;
+static volatile BaseType_t xStopping = pdFALSE;
+
+/* The native tasks in the ring. */
+static TaskHandle_t xNativeTasks[ aebACTIVITIES ];
+
+/* The state of the check task. */
+static AsyncCheckContext_t xCheckContext;
+
+/*-----------------------------------------------------------*/
+
+static void prvHostTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    vAsyncEngineRun( xEngine );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvPassToken( void )
+{
+    BaseType_t xPassOn = pdFALSE;
+
+    ulHopsRemaining--;
+
+    if( ulHopsRemaining == 0UL )
+    {
+        xTaskNotifyGive( xBenchmarkTask );
+    }
+    else
+    {
+        xPassOn = pdTRUE;
+    }
+
+    return xPassOn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvNativeRingTask( void * pvParameters )
+{
+    UBaseType_t uxNext = ( ( UBaseType_t ) pvParameters + 1U ) % aebACTIVITIES;
+
+    for( ; ; )
+    {
+        ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        if( xStopping != pdFALSE )
+        {
+            break;
+        }
+
+        if( prvPassToken() != pdFALSE )
+        {
+            xTaskNotifyGive( xNativeTasks[ uxNext ] );
+        }
+    }
+
+    xTaskNotifyGive( xBenchmarkTask );
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvAsyncRingTask( AsyncTask_t * pxTask,
+                              void * pvParameters )
+{
+    AsyncRingActivity_t * pxActivity = ( AsyncRingActivity_t * ) pvParameters;
+
+    asyncSTART( pxTask );
+
+    for( ; ; )
+    {
+        asyncNOTIFY_WAIT( pxTask, NULL, portMAX_DELAY, &( pxActivity->xResult ) );
+
+        if( xStopping != pdFALSE )
+        {
+            break;
+        }
+
+        if( prvPassToken() != pdFALSE )
+        {
+            vAsyncTaskNotify( pxActivity->pxNext, 1UL );
+        }
+    }
+
+    xTaskNotifyGive( xBenchmarkTask );
+
+    asyncEND( pxTask );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunNativeRing( void )
+{
+    size_t xFreeBefore, xBytesPerActivity;
+    TickType_t xStartTime, xElapsed;
+    UBaseType_t uxActivity;
+
+    xStopping = pdFALSE;
+    xFreeBefore = xPortGetFreeHeapSize();
+
+    for( uxActivity = 0; uxActivity < aebACTIVITIES; uxActivity++ )
+    {
+        configASSERT( xTaskCreate( prvNativeRingTask, "Ring", configMINIMAL_STACK_SIZE, ( void * ) uxActivity, aebACTIVITY_PRIORITY, &( xNativeTasks[ uxActivity ] ) ) == pdPASS );
+    }
+
+    xBytesPerActivity = ( xFreeBefore - xPortGetFreeHeapSize() ) / aebACTIVITIES;
+
+    xStartTime = xTaskGetTickCount();
+    ulHopsRemaining = aebHOPS;
+    xTaskNotifyGive( xNativeTasks[ 0 ] );
+    ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    xElapsed = xTaskGetTickCount() - xStartTime;
+
+    configPRINTF( ( "%u native tasks: %lu bytes of heap each, %lu hops in %lu ms\r\n",
+                    ( unsigned ) aebACTIVITIES,
+                    ( unsigned long ) xBytesPerActivity,
+                    ( unsigned long ) aebHOPS,
+                    ( unsigned long ) ( xElapsed * portTICK_PERIOD_MS ) ) );
+
+    /* Stop the ring.  Each task notifies the benchmark task as it exits. */
+    xStopping = pdTRUE;
+
+    for( uxActivity = 0; uxActivity < aebACTIVITIES; uxActivity++ )
+    {
+        xTaskNotifyGive( xNativeTasks[ uxActivity ] );
+        ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunAsyncRing( void )
+{
+    AsyncRingActivity_t * pxActivities;
+    size_t xFreeBefore, xBytesPerActivity;
+    TickType_t xStartTime, xElapsed;
+    UBaseType_t uxActivity;
+
+    xStopping = pdFALSE;
+    xFreeBefore = xPortGetFreeHeapSize();
+
+    pxActivities = ( AsyncRingActivity_t * ) pvPortMalloc( aebACTIVITIES * sizeof( AsyncRingActivity_t ) );
+    configASSERT( pxActivities != NULL );
+
+    for( uxActivity = 0; uxActivity < aebACTIVITIES; uxActivity++ )
+    {
+        pxActivities[ uxActivity ].pxNext = &( pxActivities[ ( uxActivity + 1U ) % aebACTIVITIES ].xTask );
+        vAsyncTaskStart( xEngine, &( pxActivities[ uxActivity ].xTask ), prvAsyncRingTask, &( pxActivities[ uxActivity ] ) );
+    }
+
+    xBytesPerActivity = ( xFreeBefore - xPortGetFreeHeapSize() ) / aebACTIVITIES;
+
+    xStartTime = xTaskGetTickCount();
+    ulHopsRemaining = aebHOPS;
+    vAsyncTaskNotify( &( pxActivities[ 0 ].xTask ), 1UL );
+    ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    xElapsed = xTaskGetTickCount() - xStartTime;
+
+    configPRINTF( ( "%u async tasks: %lu bytes of heap each, %lu hops in %lu ms\r\n",
+                    ( unsigned ) aebACTIVITIES,
+                    ( unsigned long ) xBytesPerActivity,
+                    ( unsigned long ) aebHOPS,
+                    ( unsigned long ) ( xElapsed * portTICK_PERIOD_MS ) ) );
+
+    /* Stop the ring.  Each task notifies the benchmark task just before it
+     * ends, so wait for the engine to finish with each task before freeing
+     * them. */
+    xStopping = pdTRUE;
+
+    for( uxActivity = 0; uxActivity < aebACTIVITIES; uxActivity++ )
+    {
+        vAsyncTaskNotify( &( pxActivities[ uxActivity ].xTask ), 1UL );
+        ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        while( pxActivities[ uxActivity ].xTask.uxState != asyncSTATE_ENDED )
+        {
+            vTaskDelay( 1 );
+        }
+    }
+
+    vPortFree( pxActivities );
+}
+/*-----------------------------------------------------------*/
+
+static void prvAsyncCheckTask( AsyncTask_t * pxTask,
+                               void * pvParameters )
+{
+    AsyncCheckContext_t * pxContext = ( AsyncCheckContext_t * ) pvParameters;
+
+    asyncSTART( pxTask );
+
+    /* The queue is empty, so the receive times out. */
+    pxContext->xStartTime = xTaskGetTickCount();
+    asyncQUEUE_RECEIVE( pxTask, xCheckQueue, &( pxContext->ulItem ), aebTIMEOUT_TICKS, &( pxContext->xReceiveTimeoutResult ) );
+    pxContext->xReceiveTimeoutTicks = xTaskGetTickCount() - pxContext->xStartTime;
+    xTaskNotifyGive( xBenchmarkTask );
+
+    /* The benchmark task now sends the items, then gives the semaphore. */
+    for( pxContext->uxItemsReceived = 0; pxContext->uxItemsReceived < aebQUEUE_ITEMS; pxContext->uxItemsReceived++ )
+    {
+        asyncQUEUE_RECEIVE( pxTask, xCheckQueue, &( pxContext->ulItem ), portMAX_DELAY, &( pxContext->xResult ) );
+        configASSERT( pxContext->xResult == pdPASS );
+        pxContext->ulItemTotal += pxContext->ulItem;
+    }
+
+    asyncSEMAPHORE_TAKE( pxTask, xCheckSemaphore, portMAX_DELAY, &( pxContext->xTakeResult ) );
+
+    pxContext->xStartTime = xTaskGetTickCount();
+    asyncDELAY( pxTask, aebTIMEOUT_TICKS );
+    pxContext->xDelayTicks = xTaskGetTickCount() - pxContext->xStartTime;
+
+    /* The benchmark task filled the queue, so the send times out. */
+    pxContext->ulItem = 0UL;
+    pxContext->xStartTime = xTaskGetTickCount();
+    asyncQUEUE_SEND( pxTask, xFullQueue, &( pxContext->ulItem ), aebTIMEOUT_TICKS, &( pxContext->xSendTimeoutResult ) );
+    pxContext->xSendTimeoutTicks = xTaskGetTickCount() - pxContext->xStartTime;
+
+    xTaskNotifyGive( xBenchmarkTask );
+
+    asyncEND( pxTask );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckAwaits( void )
+{
+    uint32_t ulItem;
+
+    ulItem = 0UL;
+    configASSERT( xQueueSend( xFullQueue, &ulItem, 0 ) == pdPASS );
+
+    vAsyncTaskStart( xEngine, &( xCheckContext.xTask ), prvAsyncCheckTask, &xCheckContext );
+    ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    configASSERT( xCheckContext.xReceiveTimeoutResult == errQUEUE_EMPTY );
+    configASSERT( xCheckContext.xReceiveTimeoutTicks >= aebTIMEOUT_TICKS );
+
+    for( ulItem = 1UL; ulItem <= aebQUEUE_ITEMS; ulItem++ )
+    {
+        configASSERT( xQueueSend( xCheckQueue, &ulItem, 0 ) == pdPASS );
+    }
+
+    xSemaphoreGive( xCheckSemaphore );
+
+    ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    configASSERT( xCheckContext.ulItemTotal == ( ( aebQUEUE_ITEMS * ( aebQUEUE_ITEMS + 1UL ) ) / 2UL ) );
+    configASSERT( xCheckContext.xTakeResult == pdPASS );
+    configASSERT( xCheckContext.xDelayTicks >= ( aebTIMEOUT_TICKS - 1U ) );
+    configASSERT( xCheckContext.xSendTimeoutResult == errQUEUE_FULL );
+    configASSERT( xCheckContext.xSendTimeoutTicks >= aebTIMEOUT_TICKS );
+
+    configPRINTF( ( "Async tasks: receive timed out after %lu ms, delay took %lu ms, send timed out after %lu ms\r\n",
+                    ( unsigned long ) ( xCheckContext.xReceiveTimeoutTicks * portTICK_PERIOD_MS ),
+                    ( unsigned long ) ( xCheckContext.xDelayTicks * portTICK_PERIOD_MS ),
+                    ( unsigned long ) ( xCheckContext.xSendTimeoutTicks * portTICK_PERIOD_MS ) ) );
+}
+/*-----------------------------------------------------------*/
+
+void vRunAsyncEngineBenchmark( void )
+{
+    size_t xFreeBefore;
+
+    xBenchmarkTask = xTaskGetCurrentTaskHandle();
+
+    xCheckQueue = xQueueCreate( aebQUEUE_LENGTH, sizeof( uint32_t ) );
+    xCheckSemaphore = xSemaphoreCreateBinary();
+    xFullQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+    configASSERT( ( xCheckQueue != NULL ) && ( xCheckSemaphore != NULL ) && ( xFullQueue != NULL ) );
+
+    /* The fixed cost of an engine is the engine itself and its host task.  The
+     * objects the checks await are added before the host task starts. */
+    xFreeBefore = xPortGetFreeHeapSize();
+    xEngine = xAsyncEngineCreate( aebQUEUE_LENGTH + 1U );
+    configASSERT( xEngine != NULL );
+    configASSERT( xAsyncEngineAddObject( xEngine, xCheckQueue ) == pdPASS );
+    configASSERT( xAsyncEngineAddObject( xEngine, xCheckSemaphore ) == pdPASS );
+    configASSERT( xTaskCreate( prvHostTask, "Async", configMINIMAL_STACK_SIZE * 4, NULL, aebACTIVITY_PRIORITY, NULL ) == pdPASS );
+    configPRINTF( ( "Async engine: %lu bytes of heap for the engine and its host task\r\n",
+                    ( unsigned long ) ( xFreeBefore - xPortGetFreeHeapSize() ) ) );
+
+    prvRunNativeRing();
+    prvRunAsyncRing();
+    prvCheckAwaits();
+}
+/*-----------------------------------------------------------*/
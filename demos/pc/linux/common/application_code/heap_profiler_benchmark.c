@@ -0,0 +1,273 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Measures the cost of the heap profiler on pvPortMalloc() and vPortFree(),
+ * then runs two tasks that allocate memory under different tags, one of which
+ * deliberately leaks a few blocks.  The peak memory used by each tag and the
+ * fragmentation of the heap are printed, the leaked blocks are found by
+ * comparing against a snapshot taken before the tasks ran, and a dump is saved
+ * to heap_profile.txt, which can be analysed with
+ * tools/heap_profiler/heap_report.py.  Only runs when the demo is built with
+ * "make HEAPPROF=1" - the heap figures printed by the memory pool benchmark
+ * in builds with and without the profiler show its overhead in context.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <time.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if ( configUSE_HEAP_PROFILER == 1 )
+
+/* The file the dump is saved to, in the directory the demo is run from. */
+#define hpbDUMP_FILE_NAME        "heap_profile.txt"
+
+/* The tags used by the demo.  hpTAG_NONE is used for everything else. */
+#define hpbBUFFER_TAG            ( 1U )
+#define hpbMESSAGE_TAG           ( 2U )
+
+/* The number of alloc/free pairs timed, and the size of each block. */
+#define hpbTIMED_PAIRS           ( 1000000UL )
+#define hpbTIMED_BLOCK_SIZE      ( 64 )
+
+/* The number of blocks each task allocates, the number it holds at once, and
+ * the number the buffer task leaks. */
+#define hpbWORKLOAD_BLOCKS       ( 20000UL )
+#define hpbHELD_BLOCKS           ( 32 )
+#define hpbLEAKED_BLOCKS         ( 3 )
+
+/* The most leaked blocks read back from the profiler. */
+#define hpbMAX_REPORTED_BLOCKS   ( 16 )
+
+/* The workload tasks run at the same priority as the benchmark task. */
+#define hpbTASK_PRIORITY         ( tskIDLE_PRIORITY + 2 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Allocates hpbWORKLOAD_BLOCKS blocks of varying sizes under the tag passed in
+ * pvParameters, holding up to hpbHELD_BLOCKS at once, then notifies the
+ * benchmark task.  The buffer task leaks hpbLEAKED_BLOCKS blocks.
+ */
+static void prvWorkloadTask( void * pvParameters );
+
+/*
+ * Writes one line of the dump to the file passed in pvContext.
+ */
+static void prvWriteDumpLine( const char * pcLine,
+                              void * pvContext );
+
+/*
+ * Saves a dump of the blocks allocated since pxSince to hpbDUMP_FILE_NAME.
+ */
+static void prvSaveDump( const HeapProfilerSnapshot_t * pxSince );
+
+/*
+ * Returns the time from the host's monotonic clock in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*-----------------------------------------------------------*/
+
+/* The task notified when each workload task completes. */
+static TaskHandle_t xBenchmarkTask = NULL;
+
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWorkloadTask( void * pvParameters )
+{
+    UBaseType_t uxTag = ( UBaseType_t ) pvParameters;
+    void * pvBlocks[ hpbHELD_BLOCKS ] = { NULL };
+    uint32_t ulBlock, ulSlot, ulRandom = 0x2545f491UL + ( uint32_t ) uxTag;
+    size_t xSize;
+
+    ( void ) uxTaskSetHeapTag( uxTag );
+
+    for( ulBlock = 0; ulBlock < hpbWORKLOAD_BLOCKS; ulBlock++ )
+    {
+        /* xorshift32 picks the slot to replace and the size of the new block,
+         * from 16 bytes to a little over 1KB, so blocks are freed in a
+         * different order to the order they were allocated in. */
+        ulRandom ^= ulRandom << 13;
+        ulRandom ^= ulRandom >> 17;
+        ulRandom ^= ulRandom << 5;
+        ulSlot = ulRandom % hpbHELD_BLOCKS;
+        xSize = 16 + ( ( ulRandom >> 8 ) % 1024 );
+
+        vPortFree( pvBlocks[ ulSlot ] );
+        pvBlocks[ ulSlot ] = pvPortMalloc( xSize );
+        configASSERT( pvBlocks[ ulSlot ] != NULL );
+    }
+
+    for( ulSlot = 0; ulSlot < hpbHELD_BLOCKS; ulSlot++ )
+    {
+        /* The buffer task "forgets" its first few blocks. */
+        if( ( uxTag != hpbBUFFER_TAG ) || ( ulSlot >= hpbLEAKED_BLOCKS ) )
+        {
+            vPortFree( pvBlocks[ ulSlot ] );
+        }
+    }
+
+    xTaskNotifyGive( xBenchmarkTask );
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteDumpLine( const char * pcLine,
+                              void * pvContext )
+{
+    /* The C library must only be called with interrupts masked when using the
+     * POSIX port, see the notes at the top of port.c. */
+    taskENTER_CRITICAL();
+    {
+        fprintf( ( FILE * ) pvContext, "%s\n", pcLine );
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void prvSaveDump( const HeapProfilerSnapshot_t * pxSince )
+{
+    FILE * pxFile;
+
+    taskENTER_CRITICAL();
+    {
+        pxFile = fopen( hpbDUMP_FILE_NAME, "w" );
+    }
+    taskEXIT_CRITICAL();
+
+    if( pxFile != NULL )
+    {
+        vHeapProfilerDump( pxSince, prvWriteDumpLine, pxFile );
+
+        taskENTER_CRITICAL();
+        {
+            fclose( pxFile );
+        }
+        taskEXIT_CRITICAL();
+
+        configPRINTF( ( "Saved heap profile to %s, analyse with tools/heap_profiler/heap_report.py\r\n", hpbDUMP_FILE_NAME ) );
+    }
+    else
+    {
+        configPRINTF( ( "Could not save the heap profile to %s\r\n", hpbDUMP_FILE_NAME ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vRunHeapProfilerBenchmark( void )
+{
+    static HeapProfilerSnapshot_t xBefore, xAfter;
+    static HeapProfilerAllocation_t xLeaks[ hpbMAX_REPORTED_BLOCKS ];
+    uint64_t ullTime;
+    uint32_t ulPair;
+    UBaseType_t uxLeaks, uxLeak, uxTag;
+    void * pvBlock;
+
+    vHeapProfilerSetTagName( hpTAG_NONE, "untagged" );
+    vHeapProfilerSetTagName( hpbBUFFER_TAG, "buffers" );
+    vHeapProfilerSetTagName( hpbMESSAGE_TAG, "messages" );
+    xBenchmarkTask = xTaskGetCurrentTaskHandle();
+
+    /* The cost of an alloc/free pair with the profiler recording every
+     * block. */
+    ullTime = prvGetTimeNs();
+
+    for( ulPair = 0; ulPair < hpbTIMED_PAIRS; ulPair++ )
+    {
+        pvBlock = pvPortMalloc( hpbTIMED_BLOCK_SIZE );
+        configASSERT( pvBlock != NULL );
+        vPortFree( pvBlock );
+    }
+
+    ullTime = prvGetTimeNs() - ullTime;
+
+    configPRINTF( ( "Heap profiler: %lu alloc/free pairs of %lu bytes at %lu ns/pair including profiling\r\n",
+                    ( unsigned long ) hpbTIMED_PAIRS,
+                    ( unsigned long ) hpbTIMED_BLOCK_SIZE,
+                    ( unsigned long ) ( ullTime / hpbTIMED_PAIRS ) ) );
+
+    /* Run the tagged workload, measuring the peak of each tag from here. */
+    vHeapProfilerGetSnapshot( &xBefore );
+    vHeapProfilerResetPeaks();
+
+    xTaskCreate( prvWorkloadTask, "BufferUser", configMINIMAL_STACK_SIZE, ( void * ) hpbBUFFER_TAG, hpbTASK_PRIORITY, NULL );
+    xTaskCreate( prvWorkloadTask, "MessageUser", configMINIMAL_STACK_SIZE, ( void * ) hpbMESSAGE_TAG, hpbTASK_PRIORITY, NULL );
+    ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+
+    /* Let the idle task free the deleted tasks' stacks and TCBs. */
+    vTaskDelay( pdMS_TO_TICKS( 100 ) );
+
+    vHeapProfilerGetSnapshot( &xAfter );
+
+    for( uxTag = hpbBUFFER_TAG; uxTag <= hpbMESSAGE_TAG; uxTag++ )
+    {
+        configPRINTF( ( "Heap profiler: tag %lu peak %lu bytes, %lu bytes in use, %lu allocations\r\n",
+                        ( unsigned long ) uxTag,
+                        ( unsigned long ) xAfter.xTags[ uxTag ].xPeakBytes,
+                        ( unsigned long ) xAfter.xTags[ uxTag ].xCurrentBytes,
+                        ( unsigned long ) ( xAfter.xTags[ uxTag ].ulAllocations - xBefore.xTags[ uxTag ].ulAllocations ) ) );
+    }
+
+    configPRINTF( ( "Heap profiler: %lu bytes free in %lu blocks, largest %lu bytes\r\n",
+                    ( unsigned long ) xAfter.xHeapStats.xAvailableHeapSpaceInBytes,
+                    ( unsigned long ) xAfter.xHeapStats.xNumberOfFreeBlocks,
+                    ( unsigned long ) xAfter.xHeapStats.xSizeOfLargestFreeBlockInBytes ) );
+
+    /* The blocks allocated since the first snapshot that are still allocated
+     * are the leaked blocks. */
+    prvSaveDump( &xBefore );
+    uxLeaks = uxHeapProfilerGetAllocations( &xBefore, xLeaks, hpbMAX_REPORTED_BLOCKS );
+    configPRINTF( ( "Heap profiler: %lu blocks allocated by the workload were not freed\r\n", ( unsigned long ) uxLeaks ) );
+
+    for( uxLeak = 0; uxLeak < uxLeaks; uxLeak++ )
+    {
+        configPRINTF( ( "Heap profiler:   %lu bytes, tag %u, allocated from %p\r\n",
+                        ( unsigned long ) xLeaks[ uxLeak ].ulSize,
+                        ( unsigned ) xLeaks[ uxLeak ].ucTag,
+                        xLeaks[ uxLeak ].pvCallSite ) );
+
+        /* Clean up after the workload. */
+        vPortFree( xLeaks[ uxLeak ].pvAddress );
+    }
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_HEAP_PROFILER */
@@ -0,0 +1,252 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Measures the high resolution time that FreeRTOS+POSIX clock_gettime() and
+ * nanosleep() are built on.  Reports the cost of reading it compared with
+ * reading the tick count, and has a task on each simulated core read it
+ * continuously across many ticks to check it never goes backwards and does
+ * advance between ticks.  Then compares how late sleeps of various lengths
+ * wake when they block for whole ticks, as nanosleep() does by default, and
+ * when they use vTaskDelayUntilHighResolutionTime(), as nanosleep() does when
+ * posixconfigENABLE_HIGH_RESOLUTION_SLEEP is 1, and checks neither wakes
+ * early.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The number of reads timed to measure the cost of a read. */
+#define hrbREADS                    ( 1000000UL )
+
+/* How long each reader task checks the time for. */
+#define hrbREADER_TIME_NS           ( 50000000ULL )
+
+/* The readers run below the benchmark task, so the benchmark task can wait
+ * for them to finish. */
+#define hrbREADER_PRIORITY          ( tskIDLE_PRIORITY + 1 )
+
+/* The number of sleeps of each length. */
+#define hrbSLEEPS                   ( 20U )
+
+#define hrbNANOSECONDS_PER_TICK     ( 1000000000ULL / ( uint64_t ) configTICK_RATE_HZ )
+
+/*-----------------------------------------------------------*/
+
+/* How late the sleeps of one length woke. */
+typedef struct SleepResult
+{
+    uint64_t ullTotalLateNs;
+    uint64_t ullMaxLateNs;
+} SleepResult_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Reads the high resolution time until hrbREADER_TIME_NS has passed, checking
+ * it never goes backwards, then adds the number of times it advanced by less
+ * than a tick to ulReaderSubTickSteps, notifies the benchmark task and deletes
+ * itself.
+ */
+static void prvReaderTask( void * pvParameters );
+
+/*
+ * Makes hrbSLEEPS sleeps of ullSleepNs each, using vTaskDelay() if
+ * xHighResolution is pdFALSE and vTaskDelayUntilHighResolutionTime()
+ * otherwise, and records how late they woke in *pxResult.
+ */
+static void prvMeasureSleeps( uint64_t ullSleepNs,
+                              BaseType_t xHighResolution,
+                              SleepResult_t * pxResult );
+
+/*-----------------------------------------------------------*/
+
+/* The task waiting for the readers to finish. */
+static TaskHandle_t xBenchmarkTask = NULL;
+
+/* The number of times the readers saw the time advance by less than a tick. */
+static uint32_t ulReaderSubTickSteps = 0;
+
+/* The sleep lengths compared, from a fraction of a tick to several ticks. */
+static const uint64_t ullSleepLengths[] = { 100000ULL, 250000ULL, 1500000ULL, 5250000ULL };
+
+/*-----------------------------------------------------------*/
+
+static void prvReaderTask( void * pvParameters )
+{
+    uint64_t ullStartTime, ullPreviousTime, ullTimeNow;
+    uint32_t ulSubTickSteps = 0;
+
+    ( void ) pvParameters;
+
+    ullStartTime = ullTaskGetHighResolutionTime();
+    ullPreviousTime = ullStartTime;
+
+    do
+    {
+        ullTimeNow = ullTaskGetHighResolutionTime();
+        configASSERT( ullTimeNow >= ullPreviousTime );
+
+        if( ( ullTimeNow != ullPreviousTime ) && ( ( ullTimeNow - ullPreviousTime ) < hrbNANOSECONDS_PER_TICK ) )
+        {
+            ulSubTickSteps++;
+        }
+
+        ullPreviousTime = ullTimeNow;
+    } while( ( ullTimeNow - ullStartTime ) < hrbREADER_TIME_NS );
+
+    configASSERT( ulSubTickSteps > 0 );
+
+    taskENTER_CRITICAL();
+    {
+        ulReaderSubTickSteps += ulSubTickSteps;
+    }
+    taskEXIT_CRITICAL();
+
+    xTaskNotifyGive( xBenchmarkTask );
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMeasureSleeps( uint64_t ullSleepNs,
+                              BaseType_t xHighResolution,
+                              SleepResult_t * pxResult )
+{
+    uint64_t ullStartTime, ullLateNs;
+    uint32_t ulSleep;
+
+    pxResult->ullTotalLateNs = 0;
+    pxResult->ullMaxLateNs = 0;
+
+    for( ulSleep = 0; ulSleep < hrbSLEEPS; ulSleep++ )
+    {
+        /* Start the sleeps at points spread across the tick period. */
+        vTaskDelay( 1 );
+        ullStartTime = ullTaskGetHighResolutionTime();
+
+        while( ( ullTaskGetHighResolutionTime() - ullStartTime ) < ( ( uint64_t ) ulSleep * hrbNANOSECONDS_PER_TICK / hrbSLEEPS ) )
+        {
+        }
+
+        ullStartTime = ullTaskGetHighResolutionTime();
+
+        if( xHighResolution != pdFALSE )
+        {
+            vTaskDelayUntilHighResolutionTime( ullStartTime + ullSleepNs );
+        }
+        else
+        {
+            /* Round up to whole ticks, as nanosleep() does. */
+            vTaskDelay( ( TickType_t ) ( ( ullSleepNs + hrbNANOSECONDS_PER_TICK - 1ULL ) / hrbNANOSECONDS_PER_TICK ) );
+        }
+
+        ullLateNs = ullTaskGetHighResolutionTime() - ullStartTime;
+
+        /* A sleep that blocks for whole ticks can end on the next tick, so
+         * only the high resolution sleep is guaranteed not to wake early. */
+        if( xHighResolution != pdFALSE )
+        {
+            configASSERT( ullLateNs >= ullSleepNs );
+        }
+
+        ullLateNs = ( ullLateNs > ullSleepNs ) ? ( ullLateNs - ullSleepNs ) : 0ULL;
+        pxResult->ullTotalLateNs += ullLateNs;
+
+        if( ullLateNs > pxResult->ullMaxLateNs )
+        {
+            pxResult->ullMaxLateNs = ullLateNs;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vRunHighResolutionTimeBenchmark( void )
+{
+    uint64_t ullStartTime, ullTimeNow, ullPreviousTime, ullReadTime, ullTickReadTime;
+    uint32_t ulRead;
+    BaseType_t xReader, xSleep;
+    volatile TickType_t xTicks;
+    SleepResult_t xTickSleep, xHighResolutionSleep;
+
+    xBenchmarkTask = xTaskGetCurrentTaskHandle();
+    ulReaderSubTickSteps = 0;
+
+    /* The cost of reading the high resolution time, which also checks it never
+     * goes backwards. */
+    ullStartTime = ullTaskGetHighResolutionTime();
+    ullPreviousTime = ullStartTime;
+
+    for( ulRead = 0; ulRead < hrbREADS; ulRead++ )
+    {
+        ullTimeNow = ullTaskGetHighResolutionTime();
+        configASSERT( ullTimeNow >= ullPreviousTime );
+        ullPreviousTime = ullTimeNow;
+    }
+
+    ullReadTime = ullTaskGetHighResolutionTime() - ullStartTime;
+
+    /* The cost of reading the tick count, for comparison. */
+    ullStartTime = ullTaskGetHighResolutionTime();
+
+    for( ulRead = 0; ulRead < hrbREADS; ulRead++ )
+    {
+        xTicks = xTaskGetTickCount();
+    }
+
+    ( void ) xTicks;
+    ullTickReadTime = ullTaskGetHighResolutionTime() - ullStartTime;
+
+    /* Read the time on every core at once, while the tick updates it. */
+    for( xReader = 0; xReader < configNUM_CORES; xReader++ )
+    {
+        xTaskCreate( prvReaderTask, "HrRead", configMINIMAL_STACK_SIZE, NULL, hrbREADER_PRIORITY, NULL );
+    }
+
+    for( xReader = 0; xReader < configNUM_CORES; xReader++ )
+    {
+        ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    }
+
+    configPRINTF( ( "High resolution time: %lu ns per read, tick count %lu ns per read, %lu steps between ticks on %u cores\r\n",
+                    ( unsigned long ) ( ullReadTime / hrbREADS ),
+                    ( unsigned long ) ( ullTickReadTime / hrbREADS ),
+                    ( unsigned long ) ulReaderSubTickSteps,
+                    ( unsigned ) configNUM_CORES ) );
+
+    for( xSleep = 0; xSleep < ( BaseType_t ) ( sizeof( ullSleepLengths ) / sizeof( ullSleepLengths[ 0 ] ) ); xSleep++ )
+    {
+        prvMeasureSleeps( ullSleepLengths[ xSleep ], pdFALSE, &xTickSleep );
+        prvMeasureSleeps( ullSleepLengths[ xSleep ], pdTRUE, &xHighResolutionSleep );
+
+        configPRINTF( ( "Sleep %lu us: whole ticks %lu us late on average (max %lu), high resolution %lu us late on average (max %lu)\r\n",
+                        ( unsigned long ) ( ullSleepLengths[ xSleep ] / 1000ULL ),
+                        ( unsigned long ) ( xTickSleep.ullTotalLateNs / hrbSLEEPS / 1000ULL ),
+                        ( unsigned long ) ( xTickSleep.ullMaxLateNs / 1000ULL ),
+                        ( unsigned long ) ( xHighResolutionSleep.ullTotalLateNs / hrbSLEEPS / 1000ULL ),
+                        ( unsigned long ) ( xHighResolutionSleep.ullMaxLateNs / 1000ULL ) ) );
+    }
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,479 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*
+ * Setup information:
+ *
+ * Runs the kernel on the POSIX simulator port with configNUM_CORES simulated
+ * cores, each of which executes tasks on its own host thread.  The demo
+ * measures how a fixed amount of CPU bound work spread across worker tasks, and
+ * a queue ping-pong between two tasks, scale with the number of cores, then
+ * compares the throughput of the copying and zero-copy stream buffer APIs, of
+ * ring buffers and queues with an increasing number of producers, and of memory
+ * pool and heap allocations, of a reader-writer lock and a mutex guarding a
+ * table searched by several tasks, and of the high resolution time and sleeps
+ * that wake between ticks, and how long deferred functions wait to run on
+ * the timer service task and on the system work queue, and the heap used and
+ * notification throughput of activities run as native tasks and as async tasks
+ * sharing one task, and the AES-GCM throughput of TLS records with and without
+ * the AES instructions, and the packets per second, latency and CPU time of
+ * frames received and sent by the polled Linux network interface and by a per
+ * frame design over the loopback interface, and the throughput of small UDP
+ * datagrams received and sent by the IP stack one at a time and in batches,
+ * which need the CAP_NET_RAW capability.  Build with "make" in ../../make, or "make CORES=1" for
+ * the single core scheduler, then run ./aws_demos.  Add TRACE=1 to also measure the cost of the trace ring and save
+ * a trace of kernel events, and HEAPPROF=1 to profile the heap and save a dump
+ * of the blocks a test workload leaks.  The host needs at least as many CPUs as simulated
+ * cores for the results to be meaningful.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* The number of tasks the CPU bound work is split between, and the work done by
+ * each. */
+#define mainNUM_WORKERS                ( 8 )
+#define mainWORK_ITERATIONS            ( 40000000UL )
+
+/* The number of items passed back and forth by the ping-pong tasks. */
+#define mainPING_PONG_ITEMS            ( 20000UL )
+
+/* Task priorities. */
+#define mainBENCHMARK_TASK_PRIORITY    ( tskIDLE_PRIORITY + 2 )
+#define mainWORKER_TASK_PRIORITY       ( tskIDLE_PRIORITY + 1 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Creates the workers and the ping-pong tasks, reports how long each takes,
+ * then ends the scheduler.
+ */
+static void prvBenchmarkTask( void * pvParameters );
+
+/*
+ * Performs mainWORK_ITERATIONS of CPU bound work, then notifies the benchmark
+ * task and deletes itself.
+ */
+static void prvWorkerTask( void * pvParameters );
+
+/*
+ * Echoes every item received on one queue back on another.
+ */
+static void prvPongTask( void * pvParameters );
+
+/*
+ * Compares the copying and zero-copy stream buffer APIs, defined in
+ * stream_buffer_benchmark.c.
+ */
+extern void vRunStreamBufferBenchmark( void );
+
+/*
+ * Compares ring buffers with queues as the number of producers increases,
+ * defined in ring_buffer_benchmark.c.
+ */
+extern void vRunRingBufferBenchmark( void );
+
+/*
+ * Compares memory pool allocations with heap allocations, defined in
+ * mem_pool_benchmark.c.
+ */
+extern void vRunMemPoolBenchmark( void );
+
+/*
+ * Compares a reader-writer lock with a mutex protecting read-mostly data,
+ * defined in rw_lock_benchmark.c.
+ */
+extern void vRunRwLockBenchmark( void );
+
+/*
+ * Measures the high resolution time and compares sleeps that block for whole
+ * ticks with high resolution sleeps, defined in high_resolution_time_benchmark.c.
+ */
+extern void vRunHighResolutionTimeBenchmark( void );
+
+/*
+ * Compares functions pended to the timer service task with functions pended to
+ * the system work queue, defined in work_queue_benchmark.c.
+ */
+extern void vRunWorkQueueBenchmark( void );
+
+/*
+ * Compares activities implemented as native tasks with the same activities
+ * implemented as async tasks, defined in async_engine_benchmark.c.
+ */
+extern void vRunAsyncEngineBenchmark( void );
+
+/*
+ * Checks and measures the AES-GCM encryption of TLS records, defined in
+ * tls_cipher_benchmark.c.
+ */
+extern void vRunTlsCipherBenchmark( void );
+
+/*
+ * Measures the copies made of received TLS data, and the CPU time taken to
+ * read it, with and without decrypting records in the network buffer, defined
+ * in tls_record_benchmark.c.
+ */
+extern void vRunTlsRecordBenchmark( void );
+
+/*
+ * Measures the cost of recording kernel events and saves a trace, defined in
+ * trace_ring_benchmark.c.
+ */
+extern void vRunTraceRingBenchmark( void );
+
+/*
+ * Measures the cost of the heap profiler and saves a dump of leaked blocks,
+ * defined in heap_profiler_benchmark.c.
+ */
+extern void vRunHeapProfilerBenchmark( void );
+
+/*
+ * Starts the IP stack, then compares the packets per second, latency and CPU
+ * time of the Linux network interface, polled by the IP task, with a per frame
+ * design, defined in network_interface_benchmark.c.
+ */
+extern void vRunNetworkInterfaceBenchmark( void );
+
+/*
+ * Compares the throughput of small UDP datagrams received and sent one at a
+ * time and in batches, defined in udp_batch_benchmark.c.
+ */
+extern void vRunUdpBatchBenchmark( void );
+
+/*
+ * Measures the rate at which a listening TCP socket accepts connections, and
+ * the heap it uses, during a flood of SYNs, defined in tcp_syn_benchmark.c.
+ */
+extern void vRunTcpSynBenchmark( void );
+
+/*
+ * Checks how late segments of connections closed by the IP stack are answered
+ * from its TIME_WAIT table, defined in tcp_time_wait_check.c.
+ */
+extern void vRunTcpTimeWaitCheck( void );
+
+/*
+ * Measures the MQTT core library's parser and serializer without a network,
+ * defined in mqtt_codec_benchmark.c.
+ */
+extern void vRunMqttCodecBenchmark( void );
+
+/*-----------------------------------------------------------*/
+
+/* The benchmark task, notified by each worker as it completes. */
+static TaskHandle_t xBenchmarkTask = NULL;
+
+/* Queues used by the ping-pong test. */
+static QueueHandle_t xPingQueue = NULL;
+static QueueHandle_t xPongQueue = NULL;
+
+/* Prevents the workers' results from being optimised away. */
+static volatile uint32_t ulWorkResult = 0UL;
+
+/* The state of the IP stack's random number generator. */
+static uint32_t ulNextRand = 1UL;
+
+/* The CPU clock of the IP task's host thread, set when the IP task starts. */
+static clockid_t xIPTaskClock;
+static volatile BaseType_t xIPTaskClockValid = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    ulNextRand = ( uint32_t ) time( NULL ) | 1UL;
+
+    xTaskCreate( prvBenchmarkTask, "Bench", configMINIMAL_STACK_SIZE * 4, NULL, mainBENCHMARK_TASK_PRIORITY, &xBenchmarkTask );
+
+    /* Start the scheduler.  The tasks run in their own host threads, and
+     * vTaskEndScheduler() exits the process once the benchmark completes. */
+    vTaskStartScheduler();
+
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBenchmarkTask( void * pvParameters )
+{
+    TickType_t xStartTime, xWorkTime, xPingPongTime;
+    uint32_t ulItem, ulReceived, ulWorker;
+
+    ( void ) pvParameters;
+
+    configPRINTF( ( "Running on %d simulated core(s).\r\n", ( int ) configNUM_CORES ) );
+
+    /* CPU bound work spread across the worker tasks. */
+    xStartTime = xTaskGetTickCount();
+
+    for( ulWorker = 0; ulWorker < mainNUM_WORKERS; ulWorker++ )
+    {
+        xTaskCreate( prvWorkerTask, "Worker", configMINIMAL_STACK_SIZE, NULL, mainWORKER_TASK_PRIORITY, NULL );
+    }
+
+    for( ulWorker = 0; ulWorker < mainNUM_WORKERS; ulWorker++ )
+    {
+        ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    }
+
+    xWorkTime = xTaskGetTickCount() - xStartTime;
+
+    /* Queue ping-pong, where every item wakes a task that might be on another
+     * core. */
+    xPingQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+    xPongQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+    configASSERT( ( xPingQueue != NULL ) && ( xPongQueue != NULL ) );
+    xTaskCreate( prvPongTask, "Pong", configMINIMAL_STACK_SIZE, NULL, mainBENCHMARK_TASK_PRIORITY, NULL );
+
+    xStartTime = xTaskGetTickCount();
+
+    for( ulItem = 0; ulItem < mainPING_PONG_ITEMS; ulItem++ )
+    {
+        xQueueSend( xPingQueue, &ulItem, portMAX_DELAY );
+        xQueueReceive( xPongQueue, &ulReceived, portMAX_DELAY );
+        configASSERT( ulReceived == ulItem );
+    }
+
+    xPingPongTime = xTaskGetTickCount() - xStartTime;
+
+    configPRINTF( ( "%d workers x %lu iterations: %lu ms\r\n",
+                    ( int ) mainNUM_WORKERS,
+                    ( unsigned long ) mainWORK_ITERATIONS,
+                    ( unsigned long ) ( xWorkTime * portTICK_PERIOD_MS ) ) );
+    configPRINTF( ( "%lu ping-pong round trips: %lu ms\r\n",
+                    ( unsigned long ) mainPING_PONG_ITEMS,
+                    ( unsigned long ) ( xPingPongTime * portTICK_PERIOD_MS ) ) );
+
+    vRunStreamBufferBenchmark();
+    vRunRingBufferBenchmark();
+    vRunMemPoolBenchmark();
+    vRunRwLockBenchmark();
+    vRunHighResolutionTimeBenchmark();
+    vRunWorkQueueBenchmark();
+    vRunAsyncEngineBenchmark();
+    vRunTlsCipherBenchmark();
+    vRunTlsRecordBenchmark();
+    vRunNetworkInterfaceBenchmark();
+    vRunUdpBatchBenchmark();
+    vRunTcpSynBenchmark();
+    vRunTcpTimeWaitCheck();
+    vRunMqttCodecBenchmark();
+
+    #if ( configUSE_TRACE_RING == 1 )
+        vRunTraceRingBenchmark();
+    #endif
+
+    #if ( configUSE_HEAP_PROFILER == 1 )
+        vRunHeapProfilerBenchmark();
+    #endif
+
+    vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvWorkerTask( void * pvParameters )
+{
+    uint32_t ulValue = ( uint32_t ) xTaskGetTickCount() | 1UL, ulIteration;
+
+    ( void ) pvParameters;
+
+    /* xorshift32, which the compiler cannot reduce to a closed form. */
+    for( ulIteration = 0; ulIteration < mainWORK_ITERATIONS; ulIteration++ )
+    {
+        ulValue ^= ulValue << 13;
+        ulValue ^= ulValue >> 17;
+        ulValue ^= ulValue << 5;
+    }
+
+    ulWorkResult += ulValue;
+
+    xTaskNotifyGive( xBenchmarkTask );
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPongTask( void * pvParameters )
+{
+    uint32_t ulItem;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        xQueueReceive( xPingQueue, &ulItem, portMAX_DELAY );
+        xQueueSend( xPongQueue, &ulItem, portMAX_DELAY );
+    }
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulRand( void )
+{
+    /* xorshift32, as rand() takes a C library lock. */
+    ulNextRand ^= ulNextRand << 13;
+    ulNextRand ^= ulNextRand >> 17;
+    ulNextRand ^= ulNextRand << 5;
+
+    return ulNextRand;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulApplicationGetNextSequenceNumber( uint32_t ulSourceAddress,
+                                             uint16_t usSourcePort,
+                                             uint32_t ulDestinationAddress,
+                                             uint16_t usDestinationPort )
+{
+    ( void ) ulSourceAddress;
+    ( void ) usSourcePort;
+    ( void ) ulDestinationAddress;
+    ( void ) usDestinationPort;
+
+    /* The benchmarks do not need ISNs as hard to guess as RFC 6528's. */
+    return ulRand();
+}
+/*-----------------------------------------------------------*/
+
+void vRecordIPTaskClock( void )
+{
+    /* Called by the IP task as it starts.  Each task of the POSIX port runs in
+     * its own host thread, so the thread's CPU clock measures the IP task. */
+    if( pthread_getcpuclockid( pthread_self(), &xIPTaskClock ) == 0 )
+    {
+        xIPTaskClockValid = pdTRUE;
+    }
+}
+/*-----------------------------------------------------------*/
+
+uint64_t ullGetIPTaskCpuTime( void )
+{
+    struct timespec xNow = { 0, 0 };
+
+    /* clock_gettime() takes no C library locks. */
+    if( xIPTaskClockValid != pdFALSE )
+    {
+        clock_gettime( xIPTaskClock, &xNow );
+    }
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingPrintf( const char * pcFormat,
+                     ... )
+{
+    va_list xArgs;
+
+    /* The C library must only be called with interrupts masked when using the
+     * POSIX port, see the notes at the top of port.c. */
+    taskENTER_CRITICAL();
+    {
+        va_start( xArgs, pcFormat );
+        vprintf( pcFormat, xArgs );
+        va_end( xArgs );
+        fflush( stdout );
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vAssertCalled( const char * pcFile,
+                    uint32_t ulLine )
+{
+    taskDISABLE_INTERRUPTS();
+    printf( "vAssertCalled %s, %ld\n", pcFile, ( long ) ulLine );
+    fflush( stdout );
+    abort();
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationMallocFailedHook()
+{
+    taskDISABLE_INTERRUPTS();
+    printf( "Malloc failed\n" );
+    fflush( stdout );
+    abort();
+}
+/*-----------------------------------------------------------*/
+
+/* configUSE_STATIC_ALLOCATION is set to 1, so the application must provide an
+ * implementation of vApplicationGetIdleTaskMemory() to provide the memory that is
+ * used by the Idle task. */
+void vApplicationGetIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer,
+                                    StackType_t ** ppxIdleTaskStackBuffer,
+                                    uint32_t * pulIdleTaskStackSize )
+{
+    static StaticTask_t xIdleTaskTCB;
+    static StackType_t uxIdleTaskStack[ configMINIMAL_STACK_SIZE ];
+
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+    *ppxIdleTaskStackBuffer = uxIdleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configNUM_CORES > 1 )
+
+/* Each core other than core 0 runs a passive idle task, which with static
+ * allocation also needs memory provided by the application. */
+    void vApplicationGetPassiveIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer,
+                                               StackType_t ** ppxIdleTaskStackBuffer,
+                                               uint32_t * pulIdleTaskStackSize,
+                                               BaseType_t xPassiveIdleTaskIndex )
+    {
+        static StaticTask_t xIdleTaskTCBs[ configNUM_CORES - 1 ];
+        static StackType_t uxIdleTaskStacks[ configNUM_CORES - 1 ][ configMINIMAL_STACK_SIZE ];
+
+        *ppxIdleTaskTCBBuffer = &( xIdleTaskTCBs[ xPassiveIdleTaskIndex ] );
+        *ppxIdleTaskStackBuffer = uxIdleTaskStacks[ xPassiveIdleTaskIndex ];
+        *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+    }
+
+#endif /* configNUM_CORES */
+/*-----------------------------------------------------------*/
+
+/* configUSE_STATIC_ALLOCATION and configUSE_TIMERS are both set to 1, so the
+ * application must provide an implementation of vApplicationGetTimerTaskMemory()
+ * to provide the memory that is used by the Timer service task. */
+void vApplicationGetTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
+                                     StackType_t ** ppxTimerTaskStackBuffer,
+                                     uint32_t * pulTimerTaskStackSize )
+{
+    static StaticTask_t xTimerTaskTCB;
+    static StackType_t uxTimerTaskStack[ configTIMER_TASK_STACK_DEPTH ];
+
+    *ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+    *ppxTimerTaskStackBuffer = uxTimerTaskStack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+/*-----------------------------------------------------------*/
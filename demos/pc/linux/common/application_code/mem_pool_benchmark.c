@@ -0,0 +1,234 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Compares the time taken to allocate and free blocks from a memory pool with
+ * the time taken to allocate and free the same sized blocks from the heap using
+ * pvPortMalloc() and vPortFree(), for a range of block sizes typical of network
+ * buffers.  A number of blocks are held at once, and freed in a different order
+ * to the order in which they were allocated, so the heap's free list does not
+ * stay trivially short.  The benchmark then checks that a task blocked on an
+ * empty pool is given the next block freed, and that the pool's statistics
+ * agree with the allocations made.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mem_pool.h"
+
+/* The number of blocks held at once, which is also the number of blocks in the
+ * pool. */
+#define mpbLIVE_BLOCKS           ( 16U )
+
+/* The number of allocate and free pairs made by each test. */
+#define mpbPAIRS_PER_TEST        ( 2000000UL )
+
+/* The task that frees a block to the pool while the benchmark task is blocked
+ * on it runs at a lower priority, so only runs once the benchmark task has
+ * blocked. */
+#define mpbFREEING_TASK_PRIORITY ( tskIDLE_PRIORITY + 1 )
+
+/*-----------------------------------------------------------*/
+
+/* Where a test allocates blocks from. */
+typedef enum
+{
+    eMemPool,
+    eHeap
+} BenchmarkAllocator_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Makes mpbPAIRS_PER_TEST allocate and free pairs of xBlockSize byte blocks and
+ * returns the time taken in milliseconds.
+ */
+static uint32_t prvRunTest( BenchmarkAllocator_t eAllocator,
+                            size_t xBlockSize );
+
+/*
+ * Checks an allocation from an empty pool blocks until a block is freed, and
+ * that the pool statistics count the allocations made.
+ */
+static void prvCheckBlocking( void );
+
+/*
+ * Frees the block passed in as the parameter to the pool being checked by
+ * prvCheckBlocking(), then deletes itself.
+ */
+static void prvFreeingTask( void * pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* The pool used by prvCheckBlocking(). */
+static MemPoolHandle_t xBlockingPool = NULL;
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRunTest( BenchmarkAllocator_t eAllocator,
+                            size_t xBlockSize )
+{
+    MemPoolHandle_t xPool = NULL;
+    void * pvBlocks[ mpbLIVE_BLOCKS ];
+    uint32_t ulPair, ulSlot;
+    TickType_t xStartTime, xElapsed;
+
+    if( eAllocator == eMemPool )
+    {
+        xPool = xMemPoolCreate( mpbLIVE_BLOCKS, xBlockSize );
+        configASSERT( xPool != NULL );
+    }
+
+    /* Fill every slot before timing starts. */
+    for( ulSlot = 0; ulSlot < mpbLIVE_BLOCKS; ulSlot++ )
+    {
+        if( eAllocator == eMemPool )
+        {
+            pvBlocks[ ulSlot ] = pvMemPoolAlloc( xPool, 0 );
+        }
+        else
+        {
+            pvBlocks[ ulSlot ] = pvPortMalloc( xBlockSize );
+        }
+
+        configASSERT( pvBlocks[ ulSlot ] != NULL );
+    }
+
+    xStartTime = xTaskGetTickCount();
+
+    for( ulPair = 0; ulPair < mpbPAIRS_PER_TEST; ulPair++ )
+    {
+        /* Step through the slots by a number that is coprime with the number
+         * of slots, so blocks are freed out of allocation order. */
+        ulSlot = ( ulPair * 7UL ) % mpbLIVE_BLOCKS;
+
+        if( eAllocator == eMemPool )
+        {
+            vMemPoolFree( xPool, pvBlocks[ ulSlot ] );
+            pvBlocks[ ulSlot ] = pvMemPoolAlloc( xPool, 0 );
+        }
+        else
+        {
+            vPortFree( pvBlocks[ ulSlot ] );
+            pvBlocks[ ulSlot ] = pvPortMalloc( xBlockSize );
+        }
+
+        configASSERT( pvBlocks[ ulSlot ] != NULL );
+
+        /* Touch the block as an application would. */
+        *( ( volatile uint8_t * ) pvBlocks[ ulSlot ] ) = ( uint8_t ) ulPair;
+    }
+
+    xElapsed = xTaskGetTickCount() - xStartTime;
+
+    for( ulSlot = 0; ulSlot < mpbLIVE_BLOCKS; ulSlot++ )
+    {
+        if( eAllocator == eMemPool )
+        {
+            vMemPoolFree( xPool, pvBlocks[ ulSlot ] );
+        }
+        else
+        {
+            vPortFree( pvBlocks[ ulSlot ] );
+        }
+    }
+
+    if( xPool != NULL )
+    {
+        vMemPoolDelete( xPool );
+    }
+
+    return ( uint32_t ) ( xElapsed * portTICK_PERIOD_MS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckBlocking( void )
+{
+    static StaticMemPool_t xPoolStructure;
+    static uint8_t ucPoolStorage[ mpSTORAGE_SIZE_BYTES( 2, 64 ) ] __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) );
+    MemPoolStats_t xStats;
+    void * pvFirst, * pvSecond, * pvThird;
+
+    xBlockingPool = xMemPoolCreateStatic( 2, 64, ucPoolStorage, &xPoolStructure );
+    configASSERT( xBlockingPool != NULL );
+
+    pvFirst = pvMemPoolAlloc( xBlockingPool, 0 );
+    pvSecond = pvMemPoolAlloc( xBlockingPool, 0 );
+    configASSERT( ( pvFirst != NULL ) && ( pvSecond != NULL ) && ( pvFirst != pvSecond ) );
+
+    /* The pool is empty, so this allocation fails without blocking. */
+    configASSERT( pvMemPoolAlloc( xBlockingPool, 0 ) == NULL );
+
+    /* This allocation blocks until the lower priority task frees a block. */
+    xTaskCreate( prvFreeingTask, "PoolFree", configMINIMAL_STACK_SIZE, pvSecond, mpbFREEING_TASK_PRIORITY, NULL );
+    pvThird = pvMemPoolAlloc( xBlockingPool, portMAX_DELAY );
+    configASSERT( pvThird == pvSecond );
+
+    vMemPoolGetStats( xBlockingPool, &xStats );
+    configASSERT( xStats.uxBlockCount == 2 );
+    configASSERT( xStats.uxBlocksFree == 0 );
+    configASSERT( xStats.uxMinimumEverBlocksFree == 0 );
+    configASSERT( xStats.uxAllocations == 3 );
+    configASSERT( xStats.uxFailedAllocations == 1 );
+
+    vMemPoolFree( xBlockingPool, pvFirst );
+    vMemPoolFree( xBlockingPool, pvThird );
+    vMemPoolDelete( xBlockingPool );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFreeingTask( void * pvParameters )
+{
+    vMemPoolFree( xBlockingPool, pvParameters );
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vRunMemPoolBenchmark( void )
+{
+    static const size_t xBlockSizes[] = { 32, 128, 512, 1536 };
+    uint32_t ulPoolTime, ulHeapTime, ulSize;
+
+    for( ulSize = 0; ulSize < ( sizeof( xBlockSizes ) / sizeof( xBlockSizes[ 0 ] ) ); ulSize++ )
+    {
+        ulPoolTime = prvRunTest( eMemPool, xBlockSizes[ ulSize ] );
+        ulHeapTime = prvRunTest( eHeap, xBlockSizes[ ulSize ] );
+
+        configPRINTF( ( "%lu alloc/free pairs of %lu bytes: pool %lu ms (%lu ns/pair), heap %lu ms (%lu ns/pair)\r\n",
+                        ( unsigned long ) mpbPAIRS_PER_TEST,
+                        ( unsigned long ) xBlockSizes[ ulSize ],
+                        ( unsigned long ) ulPoolTime,
+                        ( unsigned long ) ( ( ( uint64_t ) ulPoolTime * 1000000ULL ) / mpbPAIRS_PER_TEST ),
+                        ( unsigned long ) ulHeapTime,
+                        ( unsigned long ) ( ( ( uint64_t ) ulHeapTime * 1000000ULL ) / mpbPAIRS_PER_TEST ) ) );
+    }
+
+    prvCheckBlocking();
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,379 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Measures the MQTT core library's parser, MQTT_ParseReceivedData(), and
+ * serializer, MQTT_Publish(), using the harness in mqtt_codec_harness.c.
+ *
+ * Each parser scenario builds a stream of PUBLISH packets as a broker would
+ * send them - small QoS0 messages, QoS1 messages that each cause a PUBACK to be
+ * sent, large messages, and small messages received with the subscription
+ * manager full - and feeds it to the parser whole, a packet at a time, in
+ * pseudo random chunks and a byte at a time.  If the MQTT_REPLAY_FILE
+ * environment variable names a file, the bytes in it, for example a broker to
+ * client stream recorded with a packet capture tool, are fed in the same ways.
+ * The serializer is measured publishing QoS0 messages, and QoS1 messages with
+ * the PUBACK fed back in.
+ *
+ * Every measurement is repeated until it has run for at least
+ * mcbMINIMUM_RUN_TIME_NS, and reports the messages handled per second and the
+ * buffers taken from the MQTT buffer pool for each message.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* MQTT includes. */
+#include "mqtt_codec_harness.h"
+
+/* The shortest time a measurement runs for. */
+#define mcbMINIMUM_RUN_TIME_NS    ( 100000000ULL )
+
+/* The largest replay file that is loaded. */
+#define mcbMAX_REPLAY_LENGTH      ( 16UL * 1024UL * 1024UL )
+
+/* The topic the streams publish on, which matches the harness's first
+ * subscription. */
+#define mcbTOPIC                  mchTOPIC_PREFIX "0"
+
+/*-----------------------------------------------------------*/
+
+/* A stream of identical PUBLISH packets fed to the parser. */
+typedef struct ParseScenario
+{
+    const char * pcName;
+    uint32_t ulMessages;
+    uint32_t ulPayloadLength;
+    MQTTQoS_t xQos;
+    uint32_t ulSubscriptions;
+} ParseScenario_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Builds the stream for pxScenario and measures the parser with it in each
+ * chunking mode.
+ */
+static void prvRunParseScenario( const ParseScenario_t * pxScenario );
+
+/*
+ * Feeds xLength bytes of pucStream to a harness with ulSubscriptions
+ * subscriptions, chunked as eChunking describes, until mcbMINIMUM_RUN_TIME_NS
+ * has passed, and prints the result.  If ulExpectedPublishes is not zero it is
+ * checked against the publishes received from each pass over the stream.
+ */
+static void prvMeasureParse( const char * pcName,
+                             const uint8_t * pucStream,
+                             size_t xLength,
+                             uint32_t ulSubscriptions,
+                             uint32_t ulExpectedPublishes,
+                             MqttChunking_t eChunking );
+
+/*
+ * Loads the file named by MQTT_REPLAY_FILE, if there is one, and measures the
+ * parser with it in each chunking mode.
+ */
+static void prvRunReplay( void );
+
+/*
+ * Measures MQTT_Publish() with xQos and ulPayloadLength bytes of payload.  For
+ * QoS1 the PUBACK for each message is fed back in, so the message's buffer is
+ * returned.
+ */
+static void prvMeasurePublish( MQTTQoS_t xQos,
+                               uint32_t ulPayloadLength );
+
+/*
+ * Prints one result line.
+ */
+static void prvPrintResult( const char * pcOperation,
+                            const char * pcName,
+                            const char * pcMode,
+                            uint64_t ullMessages,
+                            uint64_t ullElapsedNs,
+                            uint64_t ullAllocations );
+
+/*-----------------------------------------------------------*/
+
+static const ParseScenario_t xParseScenarios[] =
+{
+    { "QoS0 32 bytes",      20000, 32,    eMQTTQoS0, 1                                                },
+    { "QoS1 256 bytes",     10000, 256,   eMQTTQoS1, 1                                                },
+    { "QoS0 60000 bytes",   32,    60000, eMQTTQoS0, 1                                                },
+    { "32 subscriptions",   20000, 32,    eMQTTQoS0, mqttconfigSUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS }
+};
+
+/*-----------------------------------------------------------*/
+
+static void prvPrintResult( const char * pcOperation,
+                            const char * pcName,
+                            const char * pcMode,
+                            uint64_t ullMessages,
+                            uint64_t ullElapsedNs,
+                            uint64_t ullAllocations )
+{
+    uint64_t ullAllocationsX100 = 0;
+
+    if( ullElapsedNs == 0 )
+    {
+        ullElapsedNs = 1;
+    }
+
+    if( ullMessages != 0 )
+    {
+        ullAllocationsX100 = ( ullAllocations * 100ULL ) / ullMessages;
+    }
+
+    configPRINTF( ( "MQTT %s %s, %s: %lu msgs/s, %lu ns/msg, %lu.%02lu buffers/msg\r\n",
+                    pcOperation,
+                    pcName,
+                    pcMode,
+                    ( unsigned long ) ( ( ullMessages * 1000000000ULL ) / ullElapsedNs ),
+                    ( unsigned long ) ( ( ullMessages != 0 ) ? ( ullElapsedNs / ullMessages ) : 0 ),
+                    ( unsigned long ) ( ullAllocationsX100 / 100ULL ),
+                    ( unsigned long ) ( ullAllocationsX100 % 100ULL ) ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMeasureParse( const char * pcName,
+                             const uint8_t * pucStream,
+                             size_t xLength,
+                             uint32_t ulSubscriptions,
+                             uint32_t ulExpectedPublishes,
+                             MqttChunking_t eChunking )
+{
+    MqttHarness_t * pxHarness;
+    uint64_t ullStartTime, ullElapsed, ullMessages = 0;
+    uint32_t ulPublishesBefore;
+    MQTTReturnCode_t xReturn;
+
+    /* The harness holds an MQTT context, which is large with many
+     * subscriptions, so is not put on the stack. */
+    pxHarness = malloc( sizeof( MqttHarness_t ) );
+    configASSERT( pxHarness != NULL );
+
+    xReturn = xMqttHarnessInit( pxHarness, ulSubscriptions, UINT32_MAX, 0x12345678UL );
+    configASSERT( xReturn == eMQTTSuccess );
+
+    ullStartTime = ullTaskGetHighResolutionTime();
+
+    do
+    {
+        ulPublishesBefore = pxHarness->xStats.ulPublishes;
+        xReturn = xMqttHarnessFeed( pxHarness, pucStream, xLength, eChunking );
+
+        /* A replayed stream may contain anything, so only the synthetic ones
+         * are required to parse cleanly. */
+        if( ulExpectedPublishes != 0 )
+        {
+            configASSERT( xReturn == eMQTTSuccess );
+            configASSERT( ( pxHarness->xStats.ulPublishes - ulPublishesBefore ) == ulExpectedPublishes );
+        }
+        else if( xReturn != eMQTTSuccess )
+        {
+            break;
+        }
+
+        ullElapsed = ullTaskGetHighResolutionTime() - ullStartTime;
+    } while( ullElapsed < mcbMINIMUM_RUN_TIME_NS );
+
+    ullElapsed = ullTaskGetHighResolutionTime() - ullStartTime;
+    ullMessages = pxHarness->xStats.ulPublishes;
+
+    prvPrintResult( "parse", pcName, pcMqttHarnessChunkingName( eChunking ), ullMessages, ullElapsed, pxHarness->xStats.ulAllocations );
+
+    if( xReturn != eMQTTSuccess )
+    {
+        configPRINTF( ( "MQTT parse %s stopped with error %d after %lu publishes, %lu other packets\r\n",
+                        pcName,
+                        ( int ) xReturn,
+                        ( unsigned long ) pxHarness->xStats.ulPublishes,
+                        ( unsigned long ) pxHarness->xStats.ulOtherEvents ) );
+    }
+
+    /* Every buffer the library took must have been given back. */
+    vMqttHarnessDeinit( pxHarness );
+    configASSERT( pxHarness->xStats.ulAllocations == pxHarness->xStats.ulFrees );
+
+    free( pxHarness );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunParseScenario( const ParseScenario_t * pxScenario )
+{
+    uint8_t * pucStream;
+    size_t xPacketLength, xBufferLength, xLength = 0;
+    uint32_t ulMessage;
+    MqttChunking_t eChunking;
+
+    /* The control byte, the largest "Remaining Length", the topic and its
+     * length, and the packet identifier. */
+    xPacketLength = 1U + mqttREMAINING_LENGTH_MAX_BYTES + 2U + strlen( mcbTOPIC ) + 2U + pxScenario->ulPayloadLength;
+    xBufferLength = xPacketLength * pxScenario->ulMessages;
+    pucStream = malloc( xBufferLength );
+    configASSERT( pucStream != NULL );
+
+    for( ulMessage = 0; ulMessage < pxScenario->ulMessages; ulMessage++ )
+    {
+        xLength += xMqttHarnessWritePublish( &( pucStream[ xLength ] ),
+                                             xBufferLength - xLength,
+                                             mcbTOPIC,
+                                             pxScenario->xQos,
+                                             ( uint16_t ) ( ( ulMessage % 0xFFFFUL ) + 1UL ),
+                                             pxScenario->ulPayloadLength );
+    }
+
+    for( eChunking = eMqttChunkWholeStream; eChunking < eMqttChunkModes; eChunking++ )
+    {
+        prvMeasureParse( pxScenario->pcName, pucStream, xLength, pxScenario->ulSubscriptions, pxScenario->ulMessages, eChunking );
+    }
+
+    free( pucStream );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunReplay( void )
+{
+    const char * pcFileName = getenv( "MQTT_REPLAY_FILE" );
+    FILE * pxFile;
+    uint8_t * pucStream = NULL;
+    size_t xLength = 0;
+    MqttChunking_t eChunking;
+
+    if( pcFileName != NULL )
+    {
+        pxFile = fopen( pcFileName, "rb" );
+
+        if( pxFile != NULL )
+        {
+            pucStream = malloc( mcbMAX_REPLAY_LENGTH );
+
+            if( pucStream != NULL )
+            {
+                xLength = fread( pucStream, 1, mcbMAX_REPLAY_LENGTH, pxFile );
+            }
+
+            fclose( pxFile );
+        }
+
+        if( xLength == 0 )
+        {
+            configPRINTF( ( "MQTT replay file %s could not be read\r\n", pcFileName ) );
+        }
+        else
+        {
+            for( eChunking = eMqttChunkWholeStream; eChunking < eMqttChunkModes; eChunking++ )
+            {
+                prvMeasureParse( "replay", pucStream, xLength, 1, 0, eChunking );
+            }
+        }
+
+        free( pucStream );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvMeasurePublish( MQTTQoS_t xQos,
+                               uint32_t ulPayloadLength )
+{
+    MqttHarness_t * pxHarness;
+    MQTTPublishParams_t xPublishParams;
+    uint8_t * pucPayload;
+    uint8_t ucPubAck[ 4 ] = { 0x40, 2, 0, 0 };
+    uint64_t ullStartTime, ullElapsed, ullMessages = 0;
+    char cName[ 32 ];
+    MQTTReturnCode_t xReturn;
+
+    pxHarness = malloc( sizeof( MqttHarness_t ) );
+    pucPayload = calloc( 1, ulPayloadLength );
+    configASSERT( ( pxHarness != NULL ) && ( pucPayload != NULL ) );
+
+    xReturn = xMqttHarnessInit( pxHarness, 0, UINT32_MAX, 1 );
+    configASSERT( xReturn == eMQTTSuccess );
+
+    memset( &xPublishParams, 0x00, sizeof( xPublishParams ) );
+    xPublishParams.pucTopic = ( const uint8_t * ) mcbTOPIC;
+    xPublishParams.usTopicLength = ( uint16_t ) strlen( mcbTOPIC );
+    xPublishParams.xQos = xQos;
+    xPublishParams.pvData = pucPayload;
+    xPublishParams.ulDataLength = ulPayloadLength;
+    xPublishParams.ulTimeoutTicks = UINT32_MAX;
+
+    ullStartTime = ullTaskGetHighResolutionTime();
+
+    do
+    {
+        xPublishParams.usPacketIdentifier = ( uint16_t ) ( ( ullMessages % 0xFFFFULL ) + 1ULL );
+        xReturn = MQTT_Publish( &( pxHarness->xContext ), &xPublishParams );
+        configASSERT( xReturn == eMQTTSuccess );
+
+        if( xQos != eMQTTQoS0 )
+        {
+            ucPubAck[ 2 ] = ( uint8_t ) ( xPublishParams.usPacketIdentifier >> 8 );
+            ucPubAck[ 3 ] = ( uint8_t ) ( xPublishParams.usPacketIdentifier & 0xFFU );
+            xReturn = MQTT_ParseReceivedData( &( pxHarness->xContext ), ucPubAck, sizeof( ucPubAck ) );
+            configASSERT( xReturn == eMQTTSuccess );
+        }
+
+        ullMessages++;
+        ullElapsed = ullTaskGetHighResolutionTime() - ullStartTime;
+    } while( ullElapsed < mcbMINIMUM_RUN_TIME_NS );
+
+    /* QoS0 messages are sent from the caller's data, QoS1 messages from a
+     * buffer held until the PUBACK arrives. */
+    snprintf( cName, sizeof( cName ), "QoS%d %lu bytes", ( int ) xQos, ( unsigned long ) ulPayloadLength );
+    prvPrintResult( "publish", cName, ( xQos == eMQTTQoS0 ) ? "no ack" : "PUBACK fed back", ullMessages, ullElapsed, pxHarness->xStats.ulAllocations );
+
+    vMqttHarnessDeinit( pxHarness );
+    configASSERT( pxHarness->xStats.ulAllocations == pxHarness->xStats.ulFrees );
+
+    free( pucPayload );
+    free( pxHarness );
+}
+/*-----------------------------------------------------------*/
+
+void vRunMqttCodecBenchmark( void )
+{
+    uint32_t ulScenario;
+
+    for( ulScenario = 0; ulScenario < ( sizeof( xParseScenarios ) / sizeof( xParseScenarios[ 0 ] ) ); ulScenario++ )
+    {
+        prvRunParseScenario( &( xParseScenarios[ ulScenario ] ) );
+    }
+
+    prvRunReplay();
+
+    prvMeasurePublish( eMQTTQoS0, 32 );
+    prvMeasurePublish( eMQTTQoS0, 1024 );
+    prvMeasurePublish( eMQTTQoS1, 32 );
+    prvMeasurePublish( eMQTTQoS1, 1024 );
+}
+/*-----------------------------------------------------------*/
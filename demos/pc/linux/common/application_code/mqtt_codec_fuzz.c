@@ -0,0 +1,164 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Fuzz target for MQTT_ParseReceivedData(), built by the mqtt_fuzz and
+ * mqtt_fuzz_replay targets in demos/pc/linux/make/Makefile rather than into the
+ * demo.
+ *
+ * The first mcfHEADER_LENGTH bytes of each input choose how the harness is set
+ * up:
+ *  byte 0    - the chunking mode.
+ *  byte 1    - the number of subscriptions, up to the subscription manager's
+ *              limit.
+ *  bytes 2-3 - the largest buffer the pool hands out, in units of 16 bytes, so
+ *              small values drive the library's drop path.  0 means no limit.
+ *  bytes 4-7 - the seed for the random chunk sizes.
+ * The rest of the input is fed to the parser as bytes received from the broker.
+ * Once it has been parsed the context is disconnected, after which every buffer
+ * taken from the pool must have been returned.
+ *
+ * With mcfSTANDALONE defined a main() is added that runs each file named on the
+ * command line through the target, so a corpus or a crash can be replayed with
+ * any compiler that supports -fsanitize=address.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* MQTT includes. */
+#include "mqtt_codec_harness.h"
+
+/* Bytes at the start of each input that configure the harness. */
+#define mcfHEADER_LENGTH       ( 8U )
+
+/* Units of the buffer limit in the header. */
+#define mcfBUFFER_LIMIT_UNIT    ( 16UL )
+
+/*-----------------------------------------------------------*/
+
+int LLVMFuzzerTestOneInput( const uint8_t * pucData,
+                            size_t xSize );
+
+/*-----------------------------------------------------------*/
+
+/* Static, as the context is too large for some fuzzers' default stacks. */
+static MqttHarness_t xHarness;
+
+/*-----------------------------------------------------------*/
+
+int LLVMFuzzerTestOneInput( const uint8_t * pucData,
+                            size_t xSize )
+{
+    MqttChunking_t eChunking;
+    uint32_t ulSubscriptions, ulMaxBufferLength, ulSeed;
+
+    if( xSize >= mcfHEADER_LENGTH )
+    {
+        eChunking = ( MqttChunking_t ) ( pucData[ 0 ] % ( uint8_t ) eMqttChunkModes );
+        ulSubscriptions = ( uint32_t ) pucData[ 1 ] % ( mqttconfigSUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS + 1UL );
+        ulMaxBufferLength = ( ( uint32_t ) pucData[ 2 ] << 8 ) | ( uint32_t ) pucData[ 3 ];
+        ulMaxBufferLength = ( ulMaxBufferLength == 0U ) ? UINT32_MAX : ( ulMaxBufferLength * mcfBUFFER_LIMIT_UNIT );
+        ulSeed = ( ( uint32_t ) pucData[ 4 ] << 24 ) | ( ( uint32_t ) pucData[ 5 ] << 16 ) |
+                 ( ( uint32_t ) pucData[ 6 ] << 8 ) | ( uint32_t ) pucData[ 7 ];
+
+        /* The set up only fails if the buffer limit is too small for the
+         * CONNECT or SUBSCRIBE packets, which is not interesting. */
+        if( xMqttHarnessInit( &xHarness, ulSubscriptions, ulMaxBufferLength, ulSeed ) == eMQTTSuccess )
+        {
+            ( void ) xMqttHarnessFeed( &xHarness, &( pucData[ mcfHEADER_LENGTH ] ), xSize - mcfHEADER_LENGTH, eChunking );
+        }
+
+        vMqttHarnessDeinit( &xHarness );
+
+        if( xHarness.xStats.ulAllocations != xHarness.xStats.ulFrees )
+        {
+            fprintf( stderr, "MQTT buffer leak: %lu taken, %lu returned\n",
+                     ( unsigned long ) xHarness.xStats.ulAllocations,
+                     ( unsigned long ) xHarness.xStats.ulFrees );
+            abort();
+        }
+    }
+
+    return 0;
+}
+/*-----------------------------------------------------------*/
+
+#ifdef mcfSTANDALONE
+
+    int main( int argc,
+              char ** argv )
+    {
+        FILE * pxFile;
+        uint8_t * pucData;
+        long lLength;
+        int iFile, iReturn = 0;
+
+        for( iFile = 1; ( iFile < argc ) && ( iReturn == 0 ); iFile++ )
+        {
+            pxFile = fopen( argv[ iFile ], "rb" );
+
+            if( pxFile == NULL )
+            {
+                fprintf( stderr, "Cannot open %s\n", argv[ iFile ] );
+                iReturn = 1;
+            }
+            else
+            {
+                ( void ) fseek( pxFile, 0, SEEK_END );
+                lLength = ftell( pxFile );
+                ( void ) fseek( pxFile, 0, SEEK_SET );
+
+                /* An exact size allocation, so the sanitizer catches reads
+                 * past the end of the input. */
+                pucData = malloc( ( lLength > 0 ) ? ( size_t ) lLength : 1U );
+
+                if( ( lLength < 0 ) || ( pucData == NULL ) ||
+                    ( fread( pucData, 1, ( size_t ) lLength, pxFile ) != ( size_t ) lLength ) )
+                {
+                    fprintf( stderr, "Cannot read %s\n", argv[ iFile ] );
+                    iReturn = 1;
+                }
+                else
+                {
+                    ( void ) LLVMFuzzerTestOneInput( pucData, ( size_t ) lLength );
+                    printf( "%s: %lu publishes, %lu dropped, %lu disconnects\n",
+                            argv[ iFile ],
+                            ( unsigned long ) xHarness.xStats.ulPublishes,
+                            ( unsigned long ) xHarness.xStats.ulDropped,
+                            ( unsigned long ) xHarness.xStats.ulDisconnects );
+                }
+
+                free( pucData );
+                fclose( pxFile );
+            }
+        }
+
+        return iReturn;
+    }
+
+#endif /* mcfSTANDALONE */
+/*-----------------------------------------------------------*/
@@ -0,0 +1,438 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * See mqtt_codec_harness.h.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mqtt_codec_harness.h"
+
+/* The MQTT control packets the harness writes as the broker. */
+#define mchCONNACK_BYTE          ( ( uint8_t ) 0x20 )
+#define mchPUBLISH_BYTE          ( ( uint8_t ) 0x30 )
+#define mchSUBACK_BYTE           ( ( uint8_t ) 0x90 )
+
+/* Every fourth subscription is to a topic filter with a wild card, so
+ * dispatch has both kinds of entry to search. */
+#define mchWILD_CARD_INTERVAL    ( 4U )
+
+/* Long enough for any topic filter the harness subscribes to. */
+#define mchMAX_TOPIC_LENGTH      ( 32U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The buffer pool, send and event callbacks registered with the MQTT context.
+ */
+static uint8_t * prvGetBuffer( uint32_t * pulBufferLength );
+static void prvReturnBuffer( uint8_t * pucBuffer );
+static uint32_t prvSend( void * pvSendContext,
+                         const uint8_t * const pucData,
+                         uint32_t ulDataLength );
+static MQTTBool_t prvEventCallback( void * pvCallbackContext,
+                                    const MQTTEventCallbackParams_t * const pxParams );
+static MQTTBool_t prvPublishCallback( void * pvPublishCallbackContext,
+                                      const MQTTPublishData_t * const pxPublishData );
+
+/*
+ * Counts a publish passed to either callback, and reads the ends of its topic
+ * and payload so a sanitizer sees any that lie outside the packet.
+ */
+static void prvCountPublish( MqttHarness_t * pxHarness,
+                             const MQTTPublishData_t * const pxPublishData );
+
+/*
+ * Returns the length of the MQTT packet at the start of pucStream, or
+ * xLength if the stream does not hold a whole, well formed, fixed header.
+ */
+static size_t prvPacketLength( const uint8_t * pucStream,
+                               size_t xLength );
+
+/*
+ * The next number from the eMqttChunkRandom generator.
+ */
+static uint32_t prvRandom( MqttHarness_t * pxHarness );
+
+/*-----------------------------------------------------------*/
+
+/* The buffer pool interface passes no context, so the pool callbacks account to
+ * the harness most recently initialised.  Only one harness is used at a
+ * time. */
+static MqttHarness_t * pxPoolHarness = NULL;
+
+/* Written with the bytes the callbacks read, so the reads are not optimised
+ * away. */
+static volatile uint8_t ucReadSink;
+
+/*-----------------------------------------------------------*/
+
+static uint8_t * prvGetBuffer( uint32_t * pulBufferLength )
+{
+    uint8_t * pucBuffer = NULL;
+
+    if( *pulBufferLength <= pxPoolHarness->ulMaxBufferLength )
+    {
+        pucBuffer = malloc( *pulBufferLength );
+
+        if( pucBuffer != NULL )
+        {
+            pxPoolHarness->xStats.ulAllocations++;
+        }
+    }
+
+    return pucBuffer;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReturnBuffer( uint8_t * pucBuffer )
+{
+    pxPoolHarness->xStats.ulFrees++;
+    free( pucBuffer );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvSend( void * pvSendContext,
+                         const uint8_t * const pucData,
+                         uint32_t ulDataLength )
+{
+    MqttHarness_t * pxHarness = ( MqttHarness_t * ) pvSendContext;
+
+    ( void ) pucData;
+    pxHarness->xStats.ullBytesSent += ulDataLength;
+
+    return ulDataLength;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCountPublish( MqttHarness_t * pxHarness,
+                             const MQTTPublishData_t * const pxPublishData )
+{
+    const uint8_t * pucPayload = ( const uint8_t * ) pxPublishData->pvData;
+
+    pxHarness->xStats.ulPublishes++;
+    pxHarness->xStats.ullPayloadBytes += pxPublishData->ulDataLength;
+
+    if( pxPublishData->usTopicLength > 0U )
+    {
+        ucReadSink = pxPublishData->pucTopic[ 0 ];
+        ucReadSink = pxPublishData->pucTopic[ pxPublishData->usTopicLength - 1U ];
+    }
+
+    if( pxPublishData->ulDataLength > 0U )
+    {
+        ucReadSink = pucPayload[ 0 ];
+        ucReadSink = pucPayload[ pxPublishData->ulDataLength - 1U ];
+    }
+}
+/*-----------------------------------------------------------*/
+
+static MQTTBool_t prvEventCallback( void * pvCallbackContext,
+                                    const MQTTEventCallbackParams_t * const pxParams )
+{
+    MqttHarness_t * pxHarness = ( MqttHarness_t * ) pvCallbackContext;
+
+    switch( pxParams->xEventType )
+    {
+        case eMQTTPublish:
+            prvCountPublish( pxHarness, &( pxParams->u.xPublishData ) );
+            break;
+
+        case eMQTTPacketDropped:
+            pxHarness->xStats.ulDropped++;
+            break;
+
+        case eMQTTClientDisconnected:
+            pxHarness->xStats.ulDisconnects++;
+            break;
+
+        default:
+            pxHarness->xStats.ulOtherEvents++;
+            break;
+    }
+
+    /* Never keep the buffer. */
+    return eMQTTFalse;
+}
+/*-----------------------------------------------------------*/
+
+static MQTTBool_t prvPublishCallback( void * pvPublishCallbackContext,
+                                      const MQTTPublishData_t * const pxPublishData )
+{
+    prvCountPublish( ( MqttHarness_t * ) pvPublishCallbackContext, pxPublishData );
+
+    return eMQTTFalse;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvPacketLength( const uint8_t * pucStream,
+                               size_t xLength )
+{
+    size_t xOffset = 1, xPacketLength = xLength;
+    uint32_t ulRemainingLength = 0, ulMultiplier = 1;
+
+    /* The "Remaining Length" takes up to four bytes after the control byte,
+     * seven bits in each, least significant first. */
+    while( ( xOffset < xLength ) && ( xOffset <= mqttREMAINING_LENGTH_MAX_BYTES ) )
+    {
+        ulRemainingLength += ( uint32_t ) ( pucStream[ xOffset ] & 0x7FU ) * ulMultiplier;
+        ulMultiplier *= 128U;
+
+        if( ( pucStream[ xOffset++ ] & 0x80U ) == 0U )
+        {
+            if( ( xLength - xOffset ) >= ulRemainingLength )
+            {
+                xPacketLength = xOffset + ulRemainingLength;
+            }
+
+            break;
+        }
+    }
+
+    return xPacketLength;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( MqttHarness_t * pxHarness )
+{
+    /* xorshift32 - cheap, and the same sequence on every host. */
+    pxHarness->ulRandomState ^= pxHarness->ulRandomState << 13;
+    pxHarness->ulRandomState ^= pxHarness->ulRandomState >> 17;
+    pxHarness->ulRandomState ^= pxHarness->ulRandomState << 5;
+
+    return pxHarness->ulRandomState;
+}
+/*-----------------------------------------------------------*/
+
+MQTTReturnCode_t xMqttHarnessInit( MqttHarness_t * pxHarness,
+                                   uint32_t ulSubscriptions,
+                                   uint32_t ulMaxBufferLength,
+                                   uint32_t ulSeed )
+{
+    MQTTInitParams_t xInitParams;
+    MQTTConnectParams_t xConnectParams;
+    MQTTSubscribeParams_t xSubscribeParams;
+    MQTTReturnCode_t xReturn;
+    char cTopic[ mchMAX_TOPIC_LENGTH ];
+    uint8_t ucSubAck[ 5 ] = { mchSUBACK_BYTE, 3, 0, 0, 0 };
+    static const uint8_t ucConnAck[ 4 ] = { mchCONNACK_BYTE, 2, 0, 0 };
+    static const char cClientId[] = "mqttbench";
+    uint32_t ulSubscription;
+
+    memset( pxHarness, 0x00, sizeof( MqttHarness_t ) );
+    pxHarness->ulMaxBufferLength = ulMaxBufferLength;
+    pxHarness->ulRandomState = ( ulSeed != 0U ) ? ulSeed : 1U;
+    pxPoolHarness = pxHarness;
+
+    memset( &xInitParams, 0x00, sizeof( xInitParams ) );
+    xInitParams.pvCallbackContext = pxHarness;
+    xInitParams.pxCallback = prvEventCallback;
+    xInitParams.pvSendContext = pxHarness;
+    xInitParams.pxMQTTSendFxn = prvSend;
+    xInitParams.xBufferPoolInterface.pxGetBufferFxn = prvGetBuffer;
+    xInitParams.xBufferPoolInterface.pxReturnBufferFxn = prvReturnBuffer;
+    ( void ) MQTT_Init( &( pxHarness->xContext ), &xInitParams );
+
+    /* No ticks callback is registered and MQTT_Periodic() is never called, so
+     * the keep alive and timeouts never expire. */
+    memset( &xConnectParams, 0x00, sizeof( xConnectParams ) );
+    xConnectParams.usKeepAliveIntervalSeconds = 60;
+    xConnectParams.ulKeepAliveActualIntervalTicks = UINT32_MAX;
+    xConnectParams.ulPingRequestTimeoutTicks = UINT32_MAX;
+    xConnectParams.pucClientId = ( const uint8_t * ) cClientId;
+    xConnectParams.usClientIdLength = ( uint16_t ) ( sizeof( cClientId ) - 1U );
+    xConnectParams.usPacketIdentifier = 1;
+    xConnectParams.ulTimeoutTicks = UINT32_MAX;
+
+    xReturn = MQTT_Connect( &( pxHarness->xContext ), &xConnectParams );
+
+    if( xReturn == eMQTTSuccess )
+    {
+        xReturn = MQTT_ParseReceivedData( &( pxHarness->xContext ), ucConnAck, sizeof( ucConnAck ) );
+    }
+
+    if( ( xReturn == eMQTTSuccess ) && ( pxHarness->xContext.xConnectionState != eMQTTConnected ) )
+    {
+        xReturn = eMQTTFailure;
+    }
+
+    for( ulSubscription = 0; ( ulSubscription < ulSubscriptions ) && ( xReturn == eMQTTSuccess ); ulSubscription++ )
+    {
+        if( ( ulSubscription % mchWILD_CARD_INTERVAL ) == ( mchWILD_CARD_INTERVAL - 1U ) )
+        {
+            ( void ) snprintf( cTopic, sizeof( cTopic ), "mqttbench/+/%lu", ( unsigned long ) ulSubscription );
+        }
+        else
+        {
+            ( void ) snprintf( cTopic, sizeof( cTopic ), mchTOPIC_PREFIX "%lu", ( unsigned long ) ulSubscription );
+        }
+
+        memset( &xSubscribeParams, 0x00, sizeof( xSubscribeParams ) );
+        xSubscribeParams.pucTopic = ( const uint8_t * ) cTopic;
+        xSubscribeParams.usTopicLength = ( uint16_t ) strlen( cTopic );
+        xSubscribeParams.xQos = eMQTTQoS1;
+        xSubscribeParams.usPacketIdentifier = ( uint16_t ) ( ulSubscription + 2U );
+        xSubscribeParams.ulTimeoutTicks = UINT32_MAX;
+        #if ( mqttconfigENABLE_SUBSCRIPTION_MANAGEMENT == 1 )
+            xSubscribeParams.pvPublishCallbackContext = pxHarness;
+            xSubscribeParams.pxPublishCallback = prvPublishCallback;
+        #endif
+
+        xReturn = MQTT_Subscribe( &( pxHarness->xContext ), &xSubscribeParams );
+
+        if( xReturn == eMQTTSuccess )
+        {
+            ucSubAck[ 2 ] = ( uint8_t ) ( xSubscribeParams.usPacketIdentifier >> 8 );
+            ucSubAck[ 3 ] = ( uint8_t ) ( xSubscribeParams.usPacketIdentifier & 0xFFU );
+            xReturn = MQTT_ParseReceivedData( &( pxHarness->xContext ), ucSubAck, sizeof( ucSubAck ) );
+        }
+    }
+
+    memset( &( pxHarness->xStats ), 0x00, sizeof( pxHarness->xStats ) );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vMqttHarnessDeinit( MqttHarness_t * pxHarness )
+{
+    ( void ) MQTT_Disconnect( &( pxHarness->xContext ) );
+}
+/*-----------------------------------------------------------*/
+
+MQTTReturnCode_t xMqttHarnessFeed( MqttHarness_t * pxHarness,
+                                   const uint8_t * pucStream,
+                                   size_t xLength,
+                                   MqttChunking_t eChunking )
+{
+    MQTTReturnCode_t xReturn = eMQTTSuccess;
+    size_t xOffset = 0, xChunk;
+
+    while( ( xOffset < xLength ) && ( xReturn == eMQTTSuccess ) )
+    {
+        switch( eChunking )
+        {
+            case eMqttChunkPacket:
+                xChunk = prvPacketLength( &( pucStream[ xOffset ] ), xLength - xOffset );
+                break;
+
+            case eMqttChunkRandom:
+                xChunk = ( size_t ) ( prvRandom( pxHarness ) % mchRANDOM_CHUNK_MAX ) + 1U;
+                break;
+
+            case eMqttChunkSingleByte:
+                xChunk = 1;
+                break;
+
+            default:
+                xChunk = xLength;
+                break;
+        }
+
+        if( xChunk > ( xLength - xOffset ) )
+        {
+            xChunk = xLength - xOffset;
+        }
+
+        xReturn = MQTT_ParseReceivedData( &( pxHarness->xContext ), &( pucStream[ xOffset ] ), xChunk );
+        xOffset += xChunk;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xMqttHarnessWritePublish( uint8_t * pucBuffer,
+                                 size_t xBufferLength,
+                                 const char * pcTopic,
+                                 MQTTQoS_t xQos,
+                                 uint16_t usPacketIdentifier,
+                                 uint32_t ulPayloadLength )
+{
+    const size_t xTopicLength = strlen( pcTopic );
+    uint32_t ulRemainingLength, ulByte;
+    size_t xOffset = 0;
+    uint8_t ucEncoded;
+
+    ulRemainingLength = 2U + ( uint32_t ) xTopicLength + ulPayloadLength;
+
+    if( xQos != eMQTTQoS0 )
+    {
+        ulRemainingLength += 2U;
+    }
+
+    /* The control byte, up to four bytes of "Remaining Length", and the rest
+     * of the packet. */
+    if( ( size_t ) ( 1U + mqttREMAINING_LENGTH_MAX_BYTES + ulRemainingLength ) <= xBufferLength )
+    {
+        pucBuffer[ xOffset++ ] = ( uint8_t ) ( mchPUBLISH_BYTE | ( ( uint8_t ) xQos << 1 ) );
+
+        ulByte = ulRemainingLength;
+
+        do
+        {
+            ucEncoded = ( uint8_t ) ( ulByte & 0x7FU );
+            ulByte >>= 7;
+
+            if( ulByte != 0U )
+            {
+                ucEncoded |= 0x80U;
+            }
+
+            pucBuffer[ xOffset++ ] = ucEncoded;
+        } while( ulByte != 0U );
+
+        pucBuffer[ xOffset++ ] = ( uint8_t ) ( xTopicLength >> 8 );
+        pucBuffer[ xOffset++ ] = ( uint8_t ) ( xTopicLength & 0xFFU );
+        memcpy( &( pucBuffer[ xOffset ] ), pcTopic, xTopicLength );
+        xOffset += xTopicLength;
+
+        if( xQos != eMQTTQoS0 )
+        {
+            pucBuffer[ xOffset++ ] = ( uint8_t ) ( usPacketIdentifier >> 8 );
+            pucBuffer[ xOffset++ ] = ( uint8_t ) ( usPacketIdentifier & 0xFFU );
+        }
+
+        for( ulByte = 0; ulByte < ulPayloadLength; ulByte++ )
+        {
+            pucBuffer[ xOffset++ ] = ( uint8_t ) ( ulByte * 7U );
+        }
+    }
+
+    return xOffset;
+}
+/*-----------------------------------------------------------*/
+
+const char * pcMqttHarnessChunkingName( MqttChunking_t eChunking )
+{
+    static const char * const pcNames[ eMqttChunkModes ] = { "whole stream", "per packet", "random", "single byte" };
+
+    return ( eChunking < eMqttChunkModes ) ? pcNames[ eChunking ] : "unknown";
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,134 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef MQTT_CODEC_HARNESS_H
+#define MQTT_CODEC_HARNESS_H
+
+/*
+ * Drives the MQTT core library (aws_mqtt_lib.c) without a network or a broker,
+ * for the MQTT codec benchmark and fuzz target.  A harness owns an MQTT context
+ * that has been connected and, optionally, subscribed by feeding it the broker's
+ * replies, a buffer pool that counts the buffers the library takes, and a send
+ * function that counts and discards what the library transmits.  Broker byte
+ * streams are then fed to MQTT_ParseReceivedData() split up as they would be by
+ * reads from a socket.
+ *
+ * The harness uses the C library heap rather than the FreeRTOS heap, and does
+ * not otherwise depend on the kernel, so it can be built on its own into a
+ * host fuzzer.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "aws_mqtt_lib.h"
+
+/* How a stream is split up between the calls to MQTT_ParseReceivedData(). */
+typedef enum
+{
+    eMqttChunkWholeStream, /* The whole stream in one call. */
+    eMqttChunkPacket,      /* One complete MQTT packet per call. */
+    eMqttChunkRandom,      /* Pseudo random sizes between 1 and mchRANDOM_CHUNK_MAX bytes. */
+    eMqttChunkSingleByte,  /* One byte per call. */
+    eMqttChunkModes
+} MqttChunking_t;
+
+/* The largest chunk fed by eMqttChunkRandom - a little more than one
+ * Ethernet MSS, so chunks both split and join packets. */
+#define mchRANDOM_CHUNK_MAX    ( 1536U )
+
+/* The topic that the first subscription is made to, and that the streams built
+ * by the benchmark publish on.  Further subscriptions are made to topics with
+ * a different last level. */
+#define mchTOPIC_PREFIX        "mqttbench/sensor/"
+
+/* Counters kept by a harness. */
+typedef struct MqttHarnessStats
+{
+    uint32_t ulPublishes;     /* Publishes passed to a callback. */
+    uint64_t ullPayloadBytes; /* Payload bytes of those publishes. */
+    uint32_t ulOtherEvents;   /* Events other than publishes. */
+    uint32_t ulDropped;       /* Packets dropped for want of a buffer. */
+    uint32_t ulDisconnects;   /* Disconnects, including for malformed packets. */
+    uint32_t ulAllocations;   /* Buffers taken from the pool. */
+    uint32_t ulFrees;         /* Buffers returned to the pool. */
+    uint64_t ullBytesSent;    /* Bytes passed to the send function. */
+} MqttHarnessStats_t;
+
+typedef struct MqttHarness
+{
+    MQTTContext_t xContext;
+    MqttHarnessStats_t xStats;
+    uint32_t ulMaxBufferLength; /* Larger requests to the pool fail. */
+    uint32_t ulRandomState;     /* State of the eMqttChunkRandom generator. */
+} MqttHarness_t;
+
+/*
+ * Initialises the harness, connects its MQTT context and makes
+ * ulSubscriptions subscriptions, each with a publish callback.  The buffer pool
+ * refuses requests for more than ulMaxBufferLength bytes, so the library's drop
+ * path can be exercised, and ulSeed seeds eMqttChunkRandom.  The counters are
+ * cleared once the setup is complete.  Returns eMQTTSuccess if the context was
+ * connected and every subscription acknowledged.
+ */
+MQTTReturnCode_t xMqttHarnessInit( MqttHarness_t * pxHarness,
+                                   uint32_t ulSubscriptions,
+                                   uint32_t ulMaxBufferLength,
+                                   uint32_t ulSeed );
+
+/*
+ * Disconnects the harness's MQTT context, returning any buffers the library
+ * still holds to the pool.
+ */
+void vMqttHarnessDeinit( MqttHarness_t * pxHarness );
+
+/*
+ * Feeds xLength bytes to MQTT_ParseReceivedData() split up as eChunking
+ * describes.  Stops at, and returns, the first result that is not
+ * eMQTTSuccess.
+ */
+MQTTReturnCode_t xMqttHarnessFeed( MqttHarness_t * pxHarness,
+                                   const uint8_t * pucStream,
+                                   size_t xLength,
+                                   MqttChunking_t eChunking );
+
+/*
+ * Writes a PUBLISH packet, as a broker would send it, to pucBuffer.  The
+ * payload is ulPayloadLength bytes of a fixed pattern.  Returns the length of
+ * the packet, or 0 if it does not fit in xBufferLength bytes.
+ */
+size_t xMqttHarnessWritePublish( uint8_t * pucBuffer,
+                                 size_t xBufferLength,
+                                 const char * pcTopic,
+                                 MQTTQoS_t xQos,
+                                 uint16_t usPacketIdentifier,
+                                 uint32_t ulPayloadLength );
+
+/*
+ * Returns the name of a chunking mode for printing.
+ */
+const char * pcMqttHarnessChunkingName( MqttChunking_t eChunking );
+
+#endif /* MQTT_CODEC_HARNESS_H */
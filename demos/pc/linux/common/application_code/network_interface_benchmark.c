@@ -0,0 +1,894 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Compares the packets per second the Linux network interface moves between
+ * the host and the IP task with those of the per frame design of the WinPCap
+ * network interface, run on a packet socket so both use the same host
+ * interface.  In the per frame design a host thread reads each frame with its
+ * own system call into a stream buffer, and a task polls the stream buffer
+ * once a tick and sends each frame to the IP task in its own event, while a
+ * second host thread sends each transmitted frame with its own system call.
+ * The network interface is built with ipconfigUSE_NETWORK_POLL set to 1, so the
+ * IP task polls it for frames.
+ *
+ * The IP stack is started here, with the network interface as its interface,
+ * and the per frame design passes the IP task the frames sent to a second MAC
+ * address, which the network interface's filter drops.  A host thread sends
+ * timestamped UDP datagrams to a socket over the loopback interface, as fast as
+ * it can and then one at a time with a gap between them, for the receive
+ * tests.  A receive handler counts the datagrams in the IP task, and the tests
+ * report how long they took to get there and the CPU time the tasks that passed
+ * them there used.  The transmit tests have the IP task send frames through
+ * each design and count those that reach the loopback interface.  Frames that
+ * cannot be buffered are dropped, as they would be with real traffic, and are
+ * reported.
+ */
+
+/* sendmmsg() is a GNU extension. */
+#define _GNU_SOURCE
+
+/* Standard includes. */
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <time.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Sockets.h"
+#include "NetworkInterface.h"
+#include "NetworkBufferManagement.h"
+#include "FreeRTOS_Stream_Buffer.h"
+
+/* The frames sent by each test, and their length. */
+#define nibFRAMES                    ( 200000UL )
+#define nibFRAME_LENGTH              ( 64U )
+
+/* The Ethernet type, from the range for local experiments, of the frames sent
+ * by the transmit tests. */
+#define nibTX_ETHERNET_TYPE          ( 0x88B6U )
+
+/* The UDP port the receive tests send to, and the address they send from. */
+#define nibRX_PORT                   ( 5001U )
+#define nibPEER_PORT                 ( 5000U )
+#define nibPEER_IP_ADDRESS           FreeRTOS_inet_addr_quick( configIP_ADDR0, configIP_ADDR1, configIP_ADDR2, 1 )
+
+/* The frames the sender thread passes to the kernel in one system call. */
+#define nibSENDER_BATCH              ( 32U )
+
+/* The frames sent by the light load receive tests, one every
+ * nibLIGHT_LOAD_GAP_US microseconds, which is not a whole number of ticks so
+ * the frames do not all arrive at the same point in a tick. */
+#define nibLIGHT_LOAD_FRAMES         ( 500UL )
+#define nibLIGHT_LOAD_GAP_US         ( 1237UL )
+
+/* Where the sender thread stores the time it sent a frame, at the start of the
+ * UDP payload. */
+#define nibTIMESTAMP_OFFSET          ipUDP_PAYLOAD_OFFSET_IPv4
+
+/* How long to wait for the IP stack to bring the network up. */
+#define nibNETWORK_UP_TIMEOUT        pdMS_TO_TICKS( 5000UL )
+
+/* The size of the stream buffers in the per frame design, as in the WinPCap
+ * network interface. */
+#define nibSTREAM_BUFFER_SIZE        ( 32768U )
+
+/* A test ends once no frame has arrived for this long. */
+#define nibIDLE_TIMEOUT              pdMS_TO_TICKS( 100UL )
+
+/* The per frame design's polling task runs at the priority the network
+ * interface's deferred handler does. */
+#define nibPOLL_TASK_PRIORITY        configMAC_ISR_SIMULATOR_PRIORITY
+
+/*-----------------------------------------------------------*/
+
+/* The results of one test. */
+typedef struct NetworkTestResult
+{
+    uint32_t ulFrames;
+    uint32_t ulSent;
+    uint32_t ulEvents;
+    uint64_t ullTimeNs;
+    uint64_t ullCpuTimeNs;
+    uint64_t ullTotalLatencyNs;
+    uint64_t ullMaxLatencyNs;
+} NetworkTestResult_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Opens a packet socket bound to the loopback interface that receives frames
+ * of type usProtocol, or none if it is 0.  Returns -1 if it cannot.
+ */
+static int prvOpenPacketSocket( uint16_t usProtocol );
+
+/*
+ * Returns the host's monotonic time, or the CPU time used by the calling
+ * thread, in nanoseconds.
+ */
+static uint64_t prvClockNs( clockid_t xClock );
+
+/*
+ * The receive handler of the socket the receive tests send to, which counts
+ * the datagrams in the IP task.
+ */
+static BaseType_t prvCountFrame( Socket_t xSocket,
+                                 void * pvData,
+                                 size_t xLength,
+                                 const struct freertos_sockaddr * pxFrom,
+                                 const struct freertos_sockaddr * pxDest );
+
+/*
+ * Has the IP task call pxJob, after the events already sent to it, and waits
+ * for it to return.
+ */
+static void prvRunInIPTask( void ( * pxJob )( void ) );
+
+/*
+ * Returns the CPU time used so far by the IP task and the per frame design's
+ * polling task.
+ */
+static uint64_t prvReceiveCpuTime( void );
+
+/*
+ * Fills pucFrame with a receive test datagram sent to the MAC address
+ * pucDestination.
+ */
+static void prvFillRxFrame( uint8_t * pucFrame,
+                            const uint8_t * pucDestination );
+
+/*
+ * Fills pucFrame with a transmit test frame, sent to an address nothing
+ * receives.
+ */
+static void prvFillTxFrame( uint8_t * pucFrame );
+
+/*
+ * Creates a host thread with every signal blocked, so the simulator's
+ * interrupts are not delivered to it.
+ */
+static void prvCreateHostThread( void * ( *pxEntry )( void * ) );
+
+/*
+ * Host thread that sends ulSenderFrames copies of ucSenderFrame,
+ * ulSenderGapUs microseconds apart or as fast as it can if that is 0, then
+ * exits.
+ */
+static void * prvSenderThread( void * pvParameters );
+
+/*
+ * The per frame design: a host thread that reads frames into
+ * pxPerFrameRecvBuffer, a task that polls it and sends each frame to the IP
+ * task, and a host thread that sends the frames in pxPerFrameSendBuffer.
+ */
+static void * prvPerFrameRecvThread( void * pvParameters );
+static void prvPerFramePollTask( void * pvParameters );
+static void * prvPerFrameSendThread( void * pvParameters );
+
+/*
+ * Runs a receive test, sending ulFrames datagrams to the MAC address
+ * pucDestination ulGapUs microseconds apart, then waits for them to stop
+ * arriving.
+ */
+static void prvRunRxTest( const uint8_t * pucDestination,
+                          uint32_t ulFrames,
+                          uint32_t ulGapUs,
+                          NetworkTestResult_t * pxResult );
+
+/*
+ * Run by the IP task to transmit nibFRAMES frames with the per frame design or
+ * the network interface.
+ */
+static void prvTransmitFrames( void );
+
+/*
+ * Has the IP task transmit nibFRAMES frames with the per frame design or the
+ * network interface, and counts those that reach the loopback interface.
+ */
+static void prvRunTxTest( BaseType_t xPerFrame,
+                          NetworkTestResult_t * pxResult );
+
+/*
+ * Reads and resets the number of frames a packet socket has seen.
+ */
+static uint32_t prvFramesSeen( int iSocket );
+
+/*
+ * Returns the CPU time used so far by the IP task, defined in main.c.
+ */
+extern uint64_t ullGetIPTaskCpuTime( void );
+
+/*-----------------------------------------------------------*/
+
+/* The MAC addresses the per frame design receives on, and the receive tests
+ * send from. */
+static const uint8_t ucPerFrameMACAddress[ ipMAC_ADDRESS_LENGTH_BYTES ] = { 0x02, 0x11, 0x22, 0x33, 0x44, 0x22 };
+static const uint8_t ucPeerMACAddress[ ipMAC_ADDRESS_LENGTH_BYTES ] = { 0x02, 0x11, 0x22, 0x33, 0x44, 0x01 };
+
+/* The receive test datagrams counted by the receive handler, the events the IP
+ * task took them from the network interface in, and the time they took to
+ * arrive. */
+static volatile uint32_t ulFramesReceived = 0;
+static volatile uint32_t ulEventsReceived = 0;
+static volatile uint64_t ullLastFrameTime = 0;
+static volatile uint64_t ullTotalLatency = 0;
+static volatile uint64_t ullMaxLatency = 0;
+
+/* The CPU time used by the per frame design's polling task, updated each time
+ * it waits. */
+static volatile uint64_t ullPollTaskCpuTime = 0;
+
+/* The frame the sender thread sends, how many times, and the gap between
+ * them. */
+static uint8_t ucSenderFrame[ nibFRAME_LENGTH ];
+static volatile uint32_t ulSenderFrames = 0;
+static volatile uint32_t ulSenderGapUs = 0;
+
+/* The job the IP task is to run, and the task waiting for it. */
+static void ( * volatile pxIPTaskJob )( void ) = NULL;
+static TaskHandle_t xIPTaskJobWaiter = NULL;
+
+/* The frame sent by the transmit tests, and the design that sends it. */
+static NetworkBufferDescriptor_t * pxTxFrame = NULL;
+static BaseType_t xTxPerFrame = pdFALSE;
+
+/* Sockets and stream buffers used by the per frame design. */
+static int iPerFrameRecvSocket = -1;
+static int iPerFrameSendSocket = -1;
+static int iPerFrameSendEvent = -1;
+static StreamBuffer_t * pxPerFrameRecvBuffer = NULL;
+static StreamBuffer_t * pxPerFrameSendBuffer = NULL;
+
+/* Set to stop the per frame design, and counted down as its threads and task
+ * exit. */
+static volatile BaseType_t xStopPerFrame = pdFALSE;
+static volatile uint32_t ulPerFrameRunning = 0;
+
+/*-----------------------------------------------------------*/
+
+void vNetworkBenchmarkIPEvent( int iEventType )
+{
+    void ( * pxJob )( void );
+
+    /* Called by the IP task for each event it takes from its queue, and each
+     * time it wakes without one. */
+    switch( ( eIPEvent_t ) iEventType )
+    {
+        case eNetworkRxEvent:
+        case eNetworkPollEvent:
+            ulEventsReceived++;
+            break;
+
+        case eNoEvent:
+            pxJob = pxIPTaskJob;
+
+            if( pxJob != NULL )
+            {
+                pxIPTaskJob = NULL;
+                pxJob();
+                xTaskNotifyGive( xIPTaskJobWaiter );
+            }
+
+            break;
+
+        default:
+            break;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunInIPTask( void ( * pxJob )( void ) )
+{
+    const IPStackEvent_t xEvent = { eNoEvent, NULL };
+
+    xIPTaskJobWaiter = xTaskGetCurrentTaskHandle();
+    pxIPTaskJob = pxJob;
+    xSendEventStructToIPTask( &xEvent, portMAX_DELAY );
+    ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvClockNs( clockid_t xClock )
+{
+    struct timespec xNow;
+
+    /* clock_gettime() takes no C library locks. */
+    clock_gettime( xClock, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCountFrame( Socket_t xSocket,
+                                 void * pvData,
+                                 size_t xLength,
+                                 const struct freertos_sockaddr * pxFrom,
+                                 const struct freertos_sockaddr * pxDest )
+{
+    uint64_t ullSentTime, ullNow, ullLatency;
+
+    ( void ) xSocket;
+    ( void ) pxFrom;
+    ( void ) pxDest;
+
+    configASSERT( xLength == ( nibFRAME_LENGTH - ipUDP_PAYLOAD_OFFSET_IPv4 ) );
+
+    memcpy( &ullSentTime, pvData, sizeof( ullSentTime ) );
+    ullNow = prvClockNs( CLOCK_MONOTONIC );
+    ullLatency = ullNow - ullSentTime;
+
+    ulFramesReceived++;
+    ullTotalLatency += ullLatency;
+
+    if( ullLatency > ullMaxLatency )
+    {
+        ullMaxLatency = ullLatency;
+    }
+
+    ullLastFrameTime = ullTaskGetHighResolutionTime();
+
+    /* The stack releases the network buffer. */
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvReceiveCpuTime( void )
+{
+    return ullGetIPTaskCpuTime() + ullPollTaskCpuTime;
+}
+/*-----------------------------------------------------------*/
+
+static int prvOpenPacketSocket( uint16_t usProtocol )
+{
+    struct sockaddr_ll xAddress;
+    int iSocket;
+
+    memset( &xAddress, '\0', sizeof( xAddress ) );
+    xAddress.sll_family = AF_PACKET;
+    xAddress.sll_protocol = htons( usProtocol );
+    xAddress.sll_ifindex = ( int ) if_nametoindex( "lo" );
+
+    iSocket = socket( AF_PACKET, SOCK_RAW, htons( usProtocol ) );
+
+    if( ( iSocket >= 0 ) && ( bind( iSocket, ( struct sockaddr * ) &xAddress, sizeof( xAddress ) ) != 0 ) )
+    {
+        close( iSocket );
+        iSocket = -1;
+    }
+
+    return iSocket;
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillRxFrame( uint8_t * pucFrame,
+                            const uint8_t * pucDestination )
+{
+    UDPPacket_t * pxPacket = ( UDPPacket_t * ) pucFrame;
+    IPHeader_t * pxIPHeader = &( pxPacket->xIPHeader );
+
+    memset( pucFrame, 0, nibFRAME_LENGTH );
+    memcpy( pxPacket->xEthernetHeader.xDestinationAddress.ucBytes, pucDestination, ipMAC_ADDRESS_LENGTH_BYTES );
+    memcpy( pxPacket->xEthernetHeader.xSourceAddress.ucBytes, ucPeerMACAddress, ipMAC_ADDRESS_LENGTH_BYTES );
+    pxPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+
+    /* IPv4 with no options.  The datagrams carry no UDP checksum, so only the
+     * IP header's checksum need be filled in. */
+    pxIPHeader->ucVersionHeaderLength = 0x45U;
+    pxIPHeader->usLength = FreeRTOS_htons( nibFRAME_LENGTH - ipSIZE_OF_ETH_HEADER );
+    pxIPHeader->ucTimeToLive = ipconfigUDP_TIME_TO_LIVE;
+    pxIPHeader->ucProtocol = ipPROTOCOL_UDP;
+    pxIPHeader->ulSourceIPAddress = nibPEER_IP_ADDRESS;
+    pxIPHeader->ulDestinationIPAddress = FreeRTOS_GetIPAddress();
+    pxIPHeader->usHeaderChecksum = usGenerateChecksum( 0UL, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER );
+    pxIPHeader->usHeaderChecksum = ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
+
+    pxPacket->xUDPHeader.usSourcePort = FreeRTOS_htons( nibPEER_PORT );
+    pxPacket->xUDPHeader.usDestinationPort = FreeRTOS_htons( nibRX_PORT );
+    pxPacket->xUDPHeader.usLength = FreeRTOS_htons( nibFRAME_LENGTH - ipSIZE_OF_ETH_HEADER - ipSIZE_OF_IPv4_HEADER );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillTxFrame( uint8_t * pucFrame )
+{
+    memset( pucFrame, 0, nibFRAME_LENGTH );
+    memcpy( pucFrame, ucPeerMACAddress, ipMAC_ADDRESS_LENGTH_BYTES );
+    memcpy( pucFrame + ipMAC_ADDRESS_LENGTH_BYTES, ipLOCAL_MAC_ADDRESS, ipMAC_ADDRESS_LENGTH_BYTES );
+    pucFrame[ 12 ] = ( uint8_t ) ( nibTX_ETHERNET_TYPE >> 8 );
+    pucFrame[ 13 ] = ( uint8_t ) nibTX_ETHERNET_TYPE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCreateHostThread( void * ( *pxEntry )( void * ) )
+{
+    pthread_t xThread;
+    sigset_t xSignals, xSavedSignals;
+
+    /* The C library must only be called with interrupts masked when using the
+     * POSIX port, see the notes at the top of port.c. */
+    taskENTER_CRITICAL();
+    {
+        sigfillset( &xSignals );
+        pthread_sigmask( SIG_BLOCK, &xSignals, &xSavedSignals );
+        pthread_create( &xThread, NULL, pxEntry, NULL );
+        pthread_detach( xThread );
+        pthread_sigmask( SIG_SETMASK, &xSavedSignals, NULL );
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void * prvSenderThread( void * pvParameters )
+{
+    struct mmsghdr xMessages[ nibSENDER_BATCH ];
+    struct iovec xVector;
+    uint32_t ulSent = 0;
+    uint64_t ullNow;
+    unsigned int uxMessage, uxBatch;
+    int iSocket, iResult;
+
+    ( void ) pvParameters;
+
+    iSocket = prvOpenPacketSocket( 0 );
+    configASSERT( iSocket >= 0 );
+
+    xVector.iov_base = ucSenderFrame;
+    xVector.iov_len = sizeof( ucSenderFrame );
+    memset( xMessages, '\0', sizeof( xMessages ) );
+
+    for( uxMessage = 0; uxMessage < nibSENDER_BATCH; uxMessage++ )
+    {
+        xMessages[ uxMessage ].msg_hdr.msg_iov = &xVector;
+        xMessages[ uxMessage ].msg_hdr.msg_iovlen = 1;
+    }
+
+    /* Frames are sent in batches as fast as possible, or one at a time with a
+     * gap between them.  All the frames in a batch carry the same time. */
+    uxBatch = ( ulSenderGapUs == 0UL ) ? nibSENDER_BATCH : 1U;
+
+    while( ulSent < ulSenderFrames )
+    {
+        ullNow = prvClockNs( CLOCK_MONOTONIC );
+        memcpy( &ucSenderFrame[ nibTIMESTAMP_OFFSET ], &ullNow, sizeof( ullNow ) );
+        iResult = sendmmsg( iSocket, xMessages, uxBatch, 0 );
+
+        if( iResult > 0 )
+        {
+            ulSent += ( uint32_t ) iResult;
+        }
+
+        if( ulSenderGapUs != 0UL )
+        {
+            usleep( ulSenderGapUs );
+        }
+    }
+
+    close( iSocket );
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void * prvPerFrameRecvThread( void * pvParameters )
+{
+    uint8_t ucFrame[ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
+    struct sockaddr_ll xAddress;
+    socklen_t xAddressLength;
+    ssize_t xReceived;
+    size_t xLength;
+
+    ( void ) pvParameters;
+
+    while( xStopPerFrame == pdFALSE )
+    {
+        /* The socket has a receive timeout, so the thread sees the stop flag. */
+        xAddressLength = sizeof( xAddress );
+        xReceived = recvfrom( iPerFrameRecvSocket, ucFrame, sizeof( ucFrame ), 0, ( struct sockaddr * ) &xAddress, &xAddressLength );
+
+        /* Only the received copy of each frame sent to the per frame design's
+         * MAC address over the loopback interface is taken, as the WinPCap
+         * network interface's capture filter and the network interface do. */
+        if( ( xReceived > ipMAC_ADDRESS_LENGTH_BYTES ) &&
+            ( xAddress.sll_pkttype != PACKET_OUTGOING ) &&
+            ( memcmp( ucFrame, ucPerFrameMACAddress, ipMAC_ADDRESS_LENGTH_BYTES ) == 0 ) )
+        {
+            xLength = ( size_t ) xReceived;
+
+            if( uxStreamBufferGetSpace( pxPerFrameRecvBuffer ) >= ( xLength + sizeof( xLength ) ) )
+            {
+                uxStreamBufferAdd( pxPerFrameRecvBuffer, 0, ( const uint8_t * ) &xLength, sizeof( xLength ) );
+                uxStreamBufferAdd( pxPerFrameRecvBuffer, 0, ucFrame, xLength );
+            }
+        }
+    }
+
+    __atomic_fetch_sub( &ulPerFrameRunning, 1UL, __ATOMIC_SEQ_CST );
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPerFramePollTask( void * pvParameters )
+{
+    NetworkBufferDescriptor_t * pxNetworkBuffer;
+    IPStackEvent_t xRxEvent = { eNetworkRxEvent, NULL };
+    size_t xLength;
+
+    ( void ) pvParameters;
+
+    while( xStopPerFrame == pdFALSE )
+    {
+        if( uxStreamBufferGetSize( pxPerFrameRecvBuffer ) > sizeof( xLength ) )
+        {
+            uxStreamBufferGet( pxPerFrameRecvBuffer, 0, ( uint8_t * ) &xLength, sizeof( xLength ), pdFALSE );
+            pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( xLength, 0 );
+
+            if( pxNetworkBuffer != NULL )
+            {
+                uxStreamBufferGet( pxPerFrameRecvBuffer, 0, pxNetworkBuffer->pucEthernetBuffer, xLength, pdFALSE );
+                pxNetworkBuffer->xDataLength = xLength;
+                pxNetworkBuffer->pxNextBuffer = NULL;
+                xRxEvent.pvData = ( void * ) pxNetworkBuffer;
+
+                if( xSendEventStructToIPTask( &xRxEvent, 0 ) != pdPASS )
+                {
+                    vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                }
+            }
+            else
+            {
+                uxStreamBufferGet( pxPerFrameRecvBuffer, 0, NULL, xLength, pdFALSE );
+            }
+        }
+        else
+        {
+            /* The WinPCap network interface waits 20 ms, the shortest delay
+             * possible is used here. */
+            ullPollTaskCpuTime = prvClockNs( CLOCK_THREAD_CPUTIME_ID );
+            vTaskDelay( 1 );
+        }
+    }
+
+    __atomic_fetch_sub( &ulPerFrameRunning, 1UL, __ATOMIC_SEQ_CST );
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void * prvPerFrameSendThread( void * pvParameters )
+{
+    uint8_t ucFrame[ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
+    uint64_t ullCount;
+    size_t xLength;
+
+    ( void ) pvParameters;
+
+    while( xStopPerFrame == pdFALSE )
+    {
+        /* Wait until notified of something to send. */
+        ( void ) read( iPerFrameSendEvent, &ullCount, sizeof( ullCount ) );
+
+        while( uxStreamBufferGetSize( pxPerFrameSendBuffer ) > sizeof( xLength ) )
+        {
+            uxStreamBufferGet( pxPerFrameSendBuffer, 0, ( uint8_t * ) &xLength, sizeof( xLength ), pdFALSE );
+            uxStreamBufferGet( pxPerFrameSendBuffer, 0, ucFrame, xLength, pdFALSE );
+            ( void ) send( iPerFrameSendSocket, ucFrame, xLength, 0 );
+        }
+    }
+
+    __atomic_fetch_sub( &ulPerFrameRunning, 1UL, __ATOMIC_SEQ_CST );
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunRxTest( const uint8_t * pucDestination,
+                          uint32_t ulFrames,
+                          uint32_t ulGapUs,
+                          NetworkTestResult_t * pxResult )
+{
+    uint64_t ullStartTime, ullStartCpuTime;
+    uint32_t ulReceived, ulWaits = 0;
+
+    ulFramesReceived = 0;
+    ulEventsReceived = 0;
+    ullTotalLatency = 0;
+    ullMaxLatency = 0;
+    ullStartCpuTime = prvReceiveCpuTime();
+    ullStartTime = ullTaskGetHighResolutionTime();
+    ullLastFrameTime = ullStartTime;
+
+    prvFillRxFrame( ucSenderFrame, pucDestination );
+    ulSenderFrames = ulFrames;
+    ulSenderGapUs = ulGapUs;
+    prvCreateHostThread( prvSenderThread );
+
+    /* Allow the sender a few timeouts to start, and the light load tests the
+     * time they take to send. */
+    do
+    {
+        ulReceived = ulFramesReceived;
+        vTaskDelay( nibIDLE_TIMEOUT );
+        ulWaits++;
+    } while( ( ulReceived != ulFramesReceived ) || ( ( ulReceived == 0 ) && ( ulWaits < 10 ) ) );
+
+    pxResult->ulFrames = ulFramesReceived;
+    pxResult->ulSent = ulFrames;
+    pxResult->ulEvents = ulEventsReceived;
+    pxResult->ullTimeNs = ullLastFrameTime - ullStartTime;
+    pxResult->ullCpuTimeNs = prvReceiveCpuTime() - ullStartCpuTime;
+    pxResult->ullTotalLatencyNs = ullTotalLatency;
+    pxResult->ullMaxLatencyNs = ullMaxLatency;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvFramesSeen( int iSocket )
+{
+    struct tpacket_stats xStats;
+    socklen_t xLength = sizeof( xStats );
+    uint32_t ulSeen = 0;
+
+    /* Counts frames the socket dropped as well as those it queued, so the
+     * socket need never be read. */
+    taskENTER_CRITICAL();
+    {
+        if( getsockopt( iSocket, SOL_PACKET, PACKET_STATISTICS, &xStats, &xLength ) == 0 )
+        {
+            ulSeen = xStats.tp_packets;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return ulSeen;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTransmitFrames( void )
+{
+    const uint64_t ullOne = 1ULL;
+    uint32_t ulFrame;
+    size_t xLength = nibFRAME_LENGTH;
+
+    for( ulFrame = 0; ulFrame < nibFRAMES; ulFrame++ )
+    {
+        if( xTxPerFrame != pdFALSE )
+        {
+            /* As the WinPCap network interface does, drop the frame if the
+             * stream buffer is full, and kick the send thread either way. */
+            if( uxStreamBufferGetSpace( pxPerFrameSendBuffer ) >= ( xLength + sizeof( xLength ) ) )
+            {
+                uxStreamBufferAdd( pxPerFrameSendBuffer, 0, ( const uint8_t * ) &xLength, sizeof( xLength ) );
+                uxStreamBufferAdd( pxPerFrameSendBuffer, 0, pxTxFrame->pucEthernetBuffer, xLength );
+            }
+
+            ( void ) write( iPerFrameSendEvent, &ullOne, sizeof( ullOne ) );
+        }
+        else
+        {
+            xNetworkInterfaceOutput( pxTxFrame, pdFALSE );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunTxTest( BaseType_t xPerFrame,
+                          NetworkTestResult_t * pxResult )
+{
+    uint64_t ullStartTime, ullEndTime;
+    uint32_t ulSeen = 0, ulNewlySeen;
+    int iCounter;
+
+    iCounter = prvOpenPacketSocket( nibTX_ETHERNET_TYPE );
+    configASSERT( iCounter >= 0 );
+    ( void ) prvFramesSeen( iCounter );
+
+    pxTxFrame = pxGetNetworkBufferWithDescriptor( nibFRAME_LENGTH, 0 );
+    configASSERT( pxTxFrame != NULL );
+    prvFillTxFrame( pxTxFrame->pucEthernetBuffer );
+    pxTxFrame->xDataLength = nibFRAME_LENGTH;
+    xTxPerFrame = xPerFrame;
+
+    /* The frames are sent by the IP task, as they would be by the stack. */
+    ullStartTime = ullTaskGetHighResolutionTime();
+    prvRunInIPTask( prvTransmitFrames );
+
+    /* Wait for the frames to stop reaching the loopback interface. */
+    do
+    {
+        ullEndTime = ullTaskGetHighResolutionTime();
+        vTaskDelay( nibIDLE_TIMEOUT );
+        ulNewlySeen = prvFramesSeen( iCounter );
+        ulSeen += ulNewlySeen;
+    } while( ulNewlySeen != 0 );
+
+    vReleaseNetworkBufferAndDescriptor( pxTxFrame );
+    pxTxFrame = NULL;
+
+    taskENTER_CRITICAL();
+    {
+        close( iCounter );
+    }
+    taskEXIT_CRITICAL();
+
+    memset( pxResult, '\0', sizeof( *pxResult ) );
+    pxResult->ulFrames = ulSeen;
+    pxResult->ulSent = nibFRAMES;
+    pxResult->ullTimeNs = ullEndTime - ullStartTime;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintResult( const char * pcTest,
+                            const NetworkTestResult_t * pxResult )
+{
+    configPRINTF( ( "%s: %lu of %lu frames in %lu ms, %lu frames per second",
+                    pcTest,
+                    ( unsigned long ) pxResult->ulFrames,
+                    ( unsigned long ) pxResult->ulSent,
+                    ( unsigned long ) ( pxResult->ullTimeNs / 1000000ULL ),
+                    ( unsigned long ) ( ( ( uint64_t ) pxResult->ulFrames * 1000000000ULL ) / ( pxResult->ullTimeNs + 1ULL ) ) ) );
+
+    if( ( pxResult->ulEvents != 0 ) && ( pxResult->ulFrames != 0 ) )
+    {
+        configPRINTF( ( ", %lu frames per IP task event, %lu ns of task CPU time per frame, latency %lu us average %lu us max\r\n",
+                        ( unsigned long ) ( pxResult->ulFrames / pxResult->ulEvents ),
+                        ( unsigned long ) ( pxResult->ullCpuTimeNs / pxResult->ulFrames ),
+                        ( unsigned long ) ( ( pxResult->ullTotalLatencyNs / pxResult->ulFrames ) / 1000ULL ),
+                        ( unsigned long ) ( pxResult->ullMaxLatencyNs / 1000ULL ) ) );
+    }
+    else
+    {
+        configPRINTF( ( "\r\n" ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vRunNetworkInterfaceBenchmark( void )
+{
+    static const uint8_t ucIPAddress[ ipIP_ADDRESS_LENGTH_BYTES ] = { configIP_ADDR0, configIP_ADDR1, configIP_ADDR2, configIP_ADDR3 };
+    static const uint8_t ucNetMask[ ipIP_ADDRESS_LENGTH_BYTES ] = { configNET_MASK0, configNET_MASK1, configNET_MASK2, configNET_MASK3 };
+    static const uint8_t ucGatewayAddress[ ipIP_ADDRESS_LENGTH_BYTES ] = { configGATEWAY_ADDR0, configGATEWAY_ADDR1, configGATEWAY_ADDR2, configGATEWAY_ADDR3 };
+    static const uint8_t ucDNSServerAddress[ ipIP_ADDRESS_LENGTH_BYTES ] = { configDNS_SERVER_ADDR0, configDNS_SERVER_ADDR1, configDNS_SERVER_ADDR2, configDNS_SERVER_ADDR3 };
+    static const uint8_t ucMACAddress[ ipMAC_ADDRESS_LENGTH_BYTES ] = { configMAC_ADDR0, configMAC_ADDR1, configMAC_ADDR2, configMAC_ADDR3, configMAC_ADDR4, configMAC_ADDR5 };
+    NetworkTestResult_t xResult;
+    struct timeval xTimeout = { 0, 100000 };
+    struct freertos_sockaddr xBindAddress;
+    F_TCP_UDP_Handler_t xHandler;
+    Socket_t xSocket;
+    TickType_t xWaited = 0;
+    size_t xBufferSize = sizeof( StreamBuffer_t ) - sizeof( pxPerFrameRecvBuffer->ucArray ) + nibSTREAM_BUFFER_SIZE + 1U;
+    uint64_t ullCount;
+
+    taskENTER_CRITICAL();
+    {
+        iPerFrameRecvSocket = prvOpenPacketSocket( ETH_P_IP );
+        iPerFrameSendSocket = prvOpenPacketSocket( nibTX_ETHERNET_TYPE );
+        iPerFrameSendEvent = eventfd( 0, 0 );
+    }
+    taskEXIT_CRITICAL();
+
+    if( ( iPerFrameRecvSocket < 0 ) || ( iPerFrameSendSocket < 0 ) )
+    {
+        configPRINTF( ( "Network interface benchmark skipped, cannot open a packet socket: %s\r\n", strerror( errno ) ) );
+        return;
+    }
+
+    /* The IP task opens the network interface, and the network is up once it
+     * has. */
+    FreeRTOS_IPInit( ucIPAddress, ucNetMask, ucGatewayAddress, ucDNSServerAddress, ucMACAddress );
+
+    while( ( FreeRTOS_IsNetworkUp() == pdFALSE ) && ( xWaited < nibNETWORK_UP_TIMEOUT ) )
+    {
+        vTaskDelay( pdMS_TO_TICKS( 10UL ) );
+        xWaited += pdMS_TO_TICKS( 10UL );
+    }
+
+    if( FreeRTOS_IsNetworkUp() == pdFALSE )
+    {
+        configPRINTF( ( "Network interface benchmark skipped, cannot open the network interface\r\n" ) );
+        return;
+    }
+
+    /* The socket the receive tests send to. */
+    xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+    configASSERT( xSocket != FREERTOS_INVALID_SOCKET );
+    memset( &xHandler, '\0', sizeof( xHandler ) );
+    xHandler.pxOnUDPReceive = prvCountFrame;
+    FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_UDP_RECV_HANDLER, ( void * ) &xHandler, sizeof( xHandler ) );
+    xBindAddress.sin_port = FreeRTOS_htons( nibRX_PORT );
+    xBindAddress.sin_addr = 0UL;
+    FreeRTOS_bind( xSocket, &xBindAddress, sizeof( xBindAddress ) );
+
+    /* The per frame design. */
+    pxPerFrameRecvBuffer = ( StreamBuffer_t * ) pvPortMalloc( xBufferSize );
+    pxPerFrameSendBuffer = ( StreamBuffer_t * ) pvPortMalloc( xBufferSize );
+    configASSERT( ( pxPerFrameRecvBuffer != NULL ) && ( pxPerFrameSendBuffer != NULL ) );
+    memset( pxPerFrameRecvBuffer, '\0', xBufferSize );
+    memset( pxPerFrameSendBuffer, '\0', xBufferSize );
+    pxPerFrameRecvBuffer->LENGTH = nibSTREAM_BUFFER_SIZE + 1U;
+    pxPerFrameSendBuffer->LENGTH = nibSTREAM_BUFFER_SIZE + 1U;
+
+    taskENTER_CRITICAL();
+    {
+        setsockopt( iPerFrameRecvSocket, SOL_SOCKET, SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+    }
+    taskEXIT_CRITICAL();
+
+    xStopPerFrame = pdFALSE;
+    ulPerFrameRunning = 3;
+    prvCreateHostThread( prvPerFrameRecvThread );
+    prvCreateHostThread( prvPerFrameSendThread );
+    xTaskCreate( prvPerFramePollTask, "NibPoll", configMINIMAL_STACK_SIZE * 2, NULL, nibPOLL_TASK_PRIORITY, NULL );
+
+    prvRunRxTest( ucPerFrameMACAddress, nibFRAMES, 0, &xResult );
+    prvPrintResult( "Per frame receive", &xResult );
+    prvRunRxTest( ucPerFrameMACAddress, nibLIGHT_LOAD_FRAMES, nibLIGHT_LOAD_GAP_US, &xResult );
+    prvPrintResult( "Per frame receive, light load", &xResult );
+    prvRunTxTest( pdTRUE, &xResult );
+    prvPrintResult( "Per frame transmit", &xResult );
+
+    xStopPerFrame = pdTRUE;
+    ullCount = 1ULL;
+    ( void ) write( iPerFrameSendEvent, &ullCount, sizeof( ullCount ) );
+
+    while( ulPerFrameRunning != 0 )
+    {
+        vTaskDelay( 1 );
+    }
+
+    taskENTER_CRITICAL();
+    {
+        close( iPerFrameRecvSocket );
+        close( iPerFrameSendSocket );
+        close( iPerFrameSendEvent );
+    }
+    taskEXIT_CRITICAL();
+
+    vPortFree( pxPerFrameRecvBuffer );
+    vPortFree( pxPerFrameSendBuffer );
+
+    /* The network interface, which the IP stack keeps open. */
+    prvRunRxTest( ipLOCAL_MAC_ADDRESS, nibFRAMES, 0, &xResult );
+    prvPrintResult( "Network interface receive", &xResult );
+    prvRunRxTest( ipLOCAL_MAC_ADDRESS, nibLIGHT_LOAD_FRAMES, nibLIGHT_LOAD_GAP_US, &xResult );
+    prvPrintResult( "Network interface receive, light load", &xResult );
+    prvRunTxTest( pdFALSE, &xResult );
+    prvPrintResult( "Network interface transmit", &xResult );
+
+    FreeRTOS_closesocket( xSocket );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,238 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Measures how the time taken for a number of producer tasks to pass a fixed
+ * number of items to a single consumer task changes with the number of
+ * producers, using a ring buffer and, for comparison, a queue.  The consumer
+ * checks the items from each producer arrive in order, so the benchmark also
+ * verifies no items are lost or duplicated when producers contend for the same
+ * slots.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "ring_buffer.h"
+
+/* The number of slots in the ring buffer, and items in the queue. */
+#define rbbSLOT_COUNT             ( 64U )
+
+/* The number of items passed by each test, split between the producers. */
+#define rbbITEMS_PER_TEST         ( 240000UL )
+
+/* The largest number of producers tested. */
+#define rbbMAX_PRODUCERS          ( 8 )
+
+/* The producers and the consumer share a priority, so the consumer competes
+ * for the cores with the producers as an uplink task would. */
+#define rbbTASK_PRIORITY          ( tskIDLE_PRIORITY + 1 )
+
+/*-----------------------------------------------------------*/
+
+/* The object a test passes items through. */
+typedef enum
+{
+    eRingBuffer,
+    eQueue
+} BenchmarkObject_t;
+
+/* The item passed from the producers to the consumer. */
+typedef struct BenchmarkItem
+{
+    uint32_t ulProducer;
+    uint32_t ulSequence;
+    uint32_t ulPayload[ 2 ];
+} BenchmarkItem_t;
+
+/* Describes the test being run to the producer tasks. */
+typedef struct BenchmarkTest
+{
+    BenchmarkObject_t eObject;
+    RingBufferHandle_t xRingBuffer;
+    QueueHandle_t xQueue;
+    uint32_t ulItemsPerProducer;
+    TaskHandle_t xConsumerTask;
+} BenchmarkTest_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Passes rbbITEMS_PER_TEST items from ulProducers producers to the calling
+ * task, and returns the time taken in milliseconds.
+ */
+static uint32_t prvRunTest( BenchmarkObject_t eObject,
+                            uint32_t ulProducers );
+
+/*
+ * Sends ulItemsPerProducer items, notifies the consumer, then deletes itself.
+ */
+static void prvProducerTask( void * pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* The identifier given to the next producer created. */
+static uint32_t ulNextProducer = 0UL;
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRunTest( BenchmarkObject_t eObject,
+                            uint32_t ulProducers )
+{
+    BenchmarkTest_t xTest;
+    BenchmarkItem_t xItem;
+    uint32_t ulNextSequence[ rbbMAX_PRODUCERS ] = { 0 };
+    uint32_t ulReceived, ulTotalItems, ulProducer;
+    BaseType_t xReceived;
+    TickType_t xStartTime, xElapsed;
+    UBaseType_t uxOriginalPriority = uxTaskPriorityGet( NULL );
+
+    xTest.eObject = eObject;
+    xTest.xRingBuffer = NULL;
+    xTest.xQueue = NULL;
+    xTest.ulItemsPerProducer = rbbITEMS_PER_TEST / ulProducers;
+    xTest.xConsumerTask = xTaskGetCurrentTaskHandle();
+    ulTotalItems = xTest.ulItemsPerProducer * ulProducers;
+
+    if( eObject == eRingBuffer )
+    {
+        xTest.xRingBuffer = xRingBufferCreate( rbbSLOT_COUNT, sizeof( BenchmarkItem_t ) );
+        configASSERT( xTest.xRingBuffer != NULL );
+    }
+    else
+    {
+        xTest.xQueue = xQueueCreate( rbbSLOT_COUNT, sizeof( BenchmarkItem_t ) );
+        configASSERT( xTest.xQueue != NULL );
+    }
+
+    /* The consumer runs at the producers' priority for the duration of the
+     * test. */
+    vTaskPrioritySet( NULL, rbbTASK_PRIORITY );
+    ( void ) xTaskNotifyStateClear( NULL );
+    ulNextProducer = 0UL;
+    xStartTime = xTaskGetTickCount();
+
+    for( ulProducer = 0; ulProducer < ulProducers; ulProducer++ )
+    {
+        xTaskCreate( prvProducerTask, "Producer", configMINIMAL_STACK_SIZE * 2, &xTest, rbbTASK_PRIORITY, NULL );
+    }
+
+    for( ulReceived = 0; ulReceived < ulTotalItems; ulReceived++ )
+    {
+        if( eObject == eRingBuffer )
+        {
+            xReceived = xRingBufferReceive( xTest.xRingBuffer, &xItem, portMAX_DELAY );
+        }
+        else
+        {
+            xReceived = xQueueReceive( xTest.xQueue, &xItem, portMAX_DELAY );
+        }
+
+        /* Items from any one producer must arrive in the order sent. */
+        configASSERT( xReceived == pdPASS );
+        configASSERT( xItem.ulProducer < ulProducers );
+        configASSERT( xItem.ulSequence == ulNextSequence[ xItem.ulProducer ] );
+        ulNextSequence[ xItem.ulProducer ]++;
+    }
+
+    xElapsed = xTaskGetTickCount() - xStartTime;
+
+    /* The producers notify the consumer once they have sent their last item,
+     * so wait for them all before deleting the object they use. */
+    for( ulProducer = 0; ulProducer < ulProducers; ulProducer++ )
+    {
+        while( ulTaskNotifyTake( pdFALSE, portMAX_DELAY ) == 0UL )
+        {
+        }
+    }
+
+    vTaskPrioritySet( NULL, uxOriginalPriority );
+
+    if( eObject == eRingBuffer )
+    {
+        vRingBufferDelete( xTest.xRingBuffer );
+    }
+    else
+    {
+        vQueueDelete( xTest.xQueue );
+    }
+
+    return ( uint32_t ) ( xElapsed * portTICK_PERIOD_MS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvProducerTask( void * pvParameters )
+{
+    BenchmarkTest_t * pxTest = ( BenchmarkTest_t * ) pvParameters;
+    BenchmarkItem_t xItem;
+
+    taskENTER_CRITICAL();
+    {
+        xItem.ulProducer = ulNextProducer++;
+    }
+    taskEXIT_CRITICAL();
+
+    xItem.ulPayload[ 0 ] = 0UL;
+    xItem.ulPayload[ 1 ] = 0UL;
+
+    for( xItem.ulSequence = 0; xItem.ulSequence < pxTest->ulItemsPerProducer; xItem.ulSequence++ )
+    {
+        /* Both objects block the producer while they are full, so neither
+         * test measures producers spinning on a full object. */
+        if( pxTest->eObject == eRingBuffer )
+        {
+            xRingBufferSend( pxTest->xRingBuffer, &xItem, portMAX_DELAY );
+        }
+        else
+        {
+            xQueueSend( pxTest->xQueue, &xItem, portMAX_DELAY );
+        }
+    }
+
+    /* With the notification value used as a counting semaphore, the consumer's
+     * notification from the ring buffer cannot be confused with this one. */
+    xTaskNotifyGive( pxTest->xConsumerTask );
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vRunRingBufferBenchmark( void )
+{
+    uint32_t ulProducers, ulRingBufferTime, ulQueueTime;
+
+    for( ulProducers = 1; ulProducers <= rbbMAX_PRODUCERS; ulProducers *= 2 )
+    {
+        ulRingBufferTime = prvRunTest( eRingBuffer, ulProducers );
+        ulQueueTime = prvRunTest( eQueue, ulProducers );
+
+        configPRINTF( ( "%lu items from %lu producer(s): ring buffer %lu ms, queue %lu ms\r\n",
+                        ( unsigned long ) rbbITEMS_PER_TEST,
+                        ( unsigned long ) ulProducers,
+                        ( unsigned long ) ulRingBufferTime,
+                        ( unsigned long ) ulQueueTime ) );
+    }
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,360 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Compares a reader-writer lock with a mutex protecting a table that several
+ * reader tasks search continuously while a writer task occasionally updates
+ * it.  The readers can search the table in parallel when it is protected by
+ * the reader-writer lock, but only one at a time when it is protected by the
+ * mutex, so the difference grows with the number of simulated cores.  Every
+ * search checks it saw the table from a single update.  The benchmark then
+ * checks that a waiting writer holds back readers of the same priority but
+ * not readers of a higher priority, and that it takes the lock when the last
+ * reader releases it.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "rw_lock.h"
+
+/* The number of tasks searching the table, and the number of searches made by
+ * each. */
+#define rwbREADERS                 ( 4U )
+#define rwbSEARCHES_PER_READER     ( 100000UL )
+
+/* The number of entries in the table, all of which are read by each search. */
+#define rwbTABLE_ENTRIES           ( 512U )
+
+/* How often the writer updates the table. */
+#define rwbWRITE_PERIOD            pdMS_TO_TICKS( 2 )
+
+/* The readers and the writer run below the benchmark task, so the benchmark
+ * task can wait for them to finish.  The writer used by prvCheckPolicy() has
+ * the same priority as the benchmark task. */
+#define rwbREADER_PRIORITY         ( tskIDLE_PRIORITY + 1 )
+#define rwbWRITER_PRIORITY         ( tskIDLE_PRIORITY + 1 )
+#define rwbPOLICY_WRITER_PRIORITY  ( tskIDLE_PRIORITY + 2 )
+
+/*-----------------------------------------------------------*/
+
+/* What protects the table during a test. */
+typedef enum
+{
+    eRwLock,
+    eMutex
+} BenchmarkLock_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Runs rwbREADERS readers and a writer against the table protected by eLock
+ * and returns the time taken for the readers to finish, in milliseconds.
+ * *pulWrites is set to the number of updates the writer made meanwhile.
+ */
+static uint32_t prvRunTest( BenchmarkLock_t eLock,
+                            uint32_t * pulWrites );
+
+/*
+ * Takes and releases the lock protecting the table, for reading if xWrite is
+ * pdFALSE.
+ */
+static void prvLock( BaseType_t xWrite );
+static void prvUnlock( BaseType_t xWrite );
+
+/*
+ * Makes rwbSEARCHES_PER_READER searches of the table, then notifies the
+ * benchmark task and deletes itself.
+ */
+static void prvReaderTask( void * pvParameters );
+
+/*
+ * Updates the table every rwbWRITE_PERIOD until the test ends, then notifies
+ * the benchmark task and deletes itself.
+ */
+static void prvWriterTask( void * pvParameters );
+
+/*
+ * Checks readers are admitted and held back as documented in rw_lock.h.
+ */
+static void prvCheckPolicy( void );
+
+/*
+ * Takes the write lock of the lock passed in as the parameter, notifies the
+ * benchmark task, then releases the lock and deletes itself.
+ */
+static void prvPolicyWriterTask( void * pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* The table being searched, each entry of which holds the number of the
+ * update that last wrote it. */
+static volatile uint32_t ulTable[ rwbTABLE_ENTRIES ];
+
+/* The lock used by the current test, and the task waiting for it to end. */
+static BenchmarkLock_t eTestLock;
+static RwLockHandle_t xTableRwLock = NULL;
+static SemaphoreHandle_t xTableMutex = NULL;
+static TaskHandle_t xBenchmarkTask = NULL;
+
+/* Set when the readers have finished, to stop the writer. */
+static volatile BaseType_t xTestDone = pdFALSE;
+
+/* The number of updates made by the writer. */
+static volatile uint32_t ulWrites = 0;
+
+/*-----------------------------------------------------------*/
+
+static void prvLock( BaseType_t xWrite )
+{
+    if( eTestLock == eMutex )
+    {
+        ( void ) xSemaphoreTake( xTableMutex, portMAX_DELAY );
+    }
+    else if( xWrite != pdFALSE )
+    {
+        ( void ) xRwLockWriteLock( xTableRwLock, portMAX_DELAY );
+    }
+    else
+    {
+        ( void ) xRwLockReadLock( xTableRwLock, portMAX_DELAY );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnlock( BaseType_t xWrite )
+{
+    if( eTestLock == eMutex )
+    {
+        ( void ) xSemaphoreGive( xTableMutex );
+    }
+    else if( xWrite != pdFALSE )
+    {
+        vRwLockWriteUnlock( xTableRwLock );
+    }
+    else
+    {
+        vRwLockReadUnlock( xTableRwLock );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvReaderTask( void * pvParameters )
+{
+    uint32_t ulSearch, ulEntry, ulFirst;
+
+    ( void ) pvParameters;
+
+    for( ulSearch = 0; ulSearch < rwbSEARCHES_PER_READER; ulSearch++ )
+    {
+        prvLock( pdFALSE );
+
+        /* The writer updates every entry while it holds the lock, so every
+         * entry read under the lock comes from the same update. */
+        ulFirst = ulTable[ 0 ];
+
+        for( ulEntry = 1; ulEntry < rwbTABLE_ENTRIES; ulEntry++ )
+        {
+            configASSERT( ulTable[ ulEntry ] == ulFirst );
+        }
+
+        prvUnlock( pdFALSE );
+    }
+
+    xTaskNotifyGive( xBenchmarkTask );
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriterTask( void * pvParameters )
+{
+    uint32_t ulEntry;
+
+    ( void ) pvParameters;
+
+    while( xTestDone == pdFALSE )
+    {
+        vTaskDelay( rwbWRITE_PERIOD );
+
+        prvLock( pdTRUE );
+        ulWrites++;
+
+        for( ulEntry = 0; ulEntry < rwbTABLE_ENTRIES; ulEntry++ )
+        {
+            ulTable[ ulEntry ] = ulWrites;
+        }
+
+        prvUnlock( pdTRUE );
+    }
+
+    xTaskNotifyGive( xBenchmarkTask );
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRunTest( BenchmarkLock_t eLock,
+                            uint32_t * pulWrites )
+{
+    TickType_t xStartTime, xElapsed;
+    uint32_t ulReader;
+
+    eTestLock = eLock;
+    xTestDone = pdFALSE;
+    ulWrites = 0;
+
+    xStartTime = xTaskGetTickCount();
+
+    xTaskCreate( prvWriterTask, "RwWrite", configMINIMAL_STACK_SIZE, NULL, rwbWRITER_PRIORITY, NULL );
+
+    for( ulReader = 0; ulReader < rwbREADERS; ulReader++ )
+    {
+        xTaskCreate( prvReaderTask, "RwRead", configMINIMAL_STACK_SIZE, NULL, rwbREADER_PRIORITY, NULL );
+    }
+
+    for( ulReader = 0; ulReader < rwbREADERS; ulReader++ )
+    {
+        ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    }
+
+    xElapsed = xTaskGetTickCount() - xStartTime;
+
+    /* Stop the writer and wait for it to exit. */
+    xTestDone = pdTRUE;
+    ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+
+    *pulWrites = ulWrites;
+
+    return ( uint32_t ) ( xElapsed * portTICK_PERIOD_MS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPolicyWriterTask( void * pvParameters )
+{
+    RwLockHandle_t xRwLock = ( RwLockHandle_t ) pvParameters;
+
+    configASSERT( xRwLockWriteLock( xRwLock, portMAX_DELAY ) == pdPASS );
+    configASSERT( xRwLockGetWriter( xRwLock ) == xTaskGetCurrentTaskHandle() );
+    xTaskNotifyGive( xBenchmarkTask );
+    vRwLockWriteUnlock( xRwLock );
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckPolicy( void )
+{
+    static StaticRwLock_t xRwLockStructure;
+    RwLockHandle_t xRwLock;
+    RwLockStats_t xStats;
+    UBaseType_t uxPriority = uxTaskPriorityGet( NULL );
+
+    xRwLock = xRwLockCreateStatic( &xRwLockStructure );
+    configASSERT( xRwLock != NULL );
+
+    /* Readers share the lock, and keep writers out. */
+    configASSERT( xRwLockReadLock( xRwLock, 0 ) == pdPASS );
+    configASSERT( xRwLockReadLock( xRwLock, 0 ) == pdPASS );
+    configASSERT( xRwLockWriteLock( xRwLock, pdMS_TO_TICKS( 5 ) ) == pdFAIL );
+    vRwLockReadUnlock( xRwLock );
+
+    /* Wait for a writer with the same priority as this task to start waiting
+     * for the remaining read lock. */
+    xTaskCreate( prvPolicyWriterTask, "RwPolicy", configMINIMAL_STACK_SIZE, ( void * ) xRwLock, rwbPOLICY_WRITER_PRIORITY, NULL );
+
+    do
+    {
+        vTaskDelay( 1 );
+        vRwLockGetStats( xRwLock, &xStats );
+    } while( xStats.uxWaitingWriters == 0 );
+
+    /* A reader of the same priority as the waiting writer is held back... */
+    configASSERT( xRwLockReadLock( xRwLock, 0 ) == pdFAIL );
+
+    /* ...but a reader of a higher priority is not. */
+    vTaskPrioritySet( NULL, rwbPOLICY_WRITER_PRIORITY + 1 );
+    configASSERT( xRwLockReadLock( xRwLock, 0 ) == pdPASS );
+    vTaskPrioritySet( NULL, uxPriority );
+    vRwLockReadUnlock( xRwLock );
+
+    /* The writer takes the lock when the last read lock is released. */
+    vRwLockReadUnlock( xRwLock );
+    ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+
+    /* Wait for the writer to release the lock. */
+    do
+    {
+        vTaskDelay( 1 );
+        vRwLockGetStats( xRwLock, &xStats );
+    } while( xStats.xWriter != NULL );
+
+    configASSERT( xRwLockReadLock( xRwLock, 0 ) == pdPASS );
+    vRwLockReadUnlock( xRwLock );
+
+    vRwLockGetStats( xRwLock, &xStats );
+    configASSERT( xStats.uxReaders == 0 );
+    configASSERT( xStats.uxWaitingReaders == 0 );
+    configASSERT( xStats.uxWaitingWriters == 0 );
+    configASSERT( xStats.uxReadLocks == 4 );
+    configASSERT( xStats.uxWriteLocks == 1 );
+    configASSERT( xStats.uxContendedLocks == 2 );
+    configASSERT( xStats.uxFailedLocks == 2 );
+
+    vRwLockDelete( xRwLock );
+}
+/*-----------------------------------------------------------*/
+
+void vRunRwLockBenchmark( void )
+{
+    uint32_t ulRwLockTime, ulMutexTime, ulRwLockWrites, ulMutexWrites;
+    RwLockStats_t xStats;
+
+    xBenchmarkTask = xTaskGetCurrentTaskHandle();
+
+    xTableRwLock = xRwLockCreate();
+    xTableMutex = xSemaphoreCreateMutex();
+    configASSERT( ( xTableRwLock != NULL ) && ( xTableMutex != NULL ) );
+
+    ulRwLockTime = prvRunTest( eRwLock, &ulRwLockWrites );
+    ulMutexTime = prvRunTest( eMutex, &ulMutexWrites );
+
+    vRwLockGetStats( xTableRwLock, &xStats );
+
+    configPRINTF( ( "%u readers x %lu searches of %u entries: rw lock %lu ms (%lu writes, %lu of %lu locks waited), mutex %lu ms (%lu writes)\r\n",
+                    ( unsigned ) rwbREADERS,
+                    ( unsigned long ) rwbSEARCHES_PER_READER,
+                    ( unsigned ) rwbTABLE_ENTRIES,
+                    ( unsigned long ) ulRwLockTime,
+                    ( unsigned long ) ulRwLockWrites,
+                    ( unsigned long ) xStats.uxContendedLocks,
+                    ( unsigned long ) ( xStats.uxReadLocks + xStats.uxWriteLocks ),
+                    ( unsigned long ) ulMutexTime,
+                    ( unsigned long ) ulMutexWrites ) );
+
+    vRwLockDelete( xTableRwLock );
+    vSemaphoreDelete( xTableMutex );
+
+    prvCheckPolicy();
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,252 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Compares the throughput of the copying stream and message buffer API
+ * (xStreamBufferSend() and xStreamBufferReceive()) with the zero-copy API
+ * (xStreamBufferSendReserve()/xStreamBufferSendCommit() and
+ * xStreamBufferReceiveAcquire()/xStreamBufferReceiveRelease()).  The writer
+ * generates a byte sequence that the reader checks, so the benchmark also
+ * verifies no data is lost, duplicated or reordered as the data wraps around
+ * the end of the buffer.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+
+/* The size of the buffer under test, and the number of bytes passed through it
+ * by each test. */
+#define sbbBUFFER_SIZE_BYTES    ( 4096U )
+#define sbbBYTES_PER_TEST       ( 32UL * 1024UL * 1024UL )
+
+/* The largest block written to the buffer at once.  Message lengths vary up to
+ * this size so messages end at different offsets in the buffer. */
+#define sbbMAX_BLOCK_SIZE       ( 512U )
+
+/* The reader runs at the same priority as the task that runs the benchmark. */
+#define sbbREADER_PRIORITY      ( tskIDLE_PRIORITY + 2 )
+
+/*-----------------------------------------------------------*/
+
+/* The API a test uses. */
+typedef enum
+{
+    eCopy,
+    eZeroCopy
+} BenchmarkMode_t;
+
+/* Describes the test being run to the reader task. */
+typedef struct BenchmarkTest
+{
+    StreamBufferHandle_t xBuffer;
+    BenchmarkMode_t eMode;
+    BaseType_t xIsMessageBuffer;
+    TaskHandle_t xWriterTask;
+    BaseType_t xErrorFound;
+} BenchmarkTest_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Passes sbbBYTES_PER_TEST bytes through a buffer and returns the time taken in
+ * milliseconds.
+ */
+static uint32_t prvRunTest( BaseType_t xIsMessageBuffer,
+                            BenchmarkMode_t eMode );
+
+/*
+ * Reads and checks sbbBYTES_PER_TEST bytes, then notifies the writer and
+ * deletes itself.
+ */
+static void prvReaderTask( void * pvParameters );
+
+/*
+ * The length of the n'th block written.
+ */
+static size_t prvBlockLength( uint32_t ulBlock );
+
+/*-----------------------------------------------------------*/
+
+static size_t prvBlockLength( uint32_t ulBlock )
+{
+    /* Lengths from 1 to sbbMAX_BLOCK_SIZE, stepping by a number that is not a
+     * factor of the buffer size. */
+    return ( size_t ) ( ( ( ulBlock * 97UL ) % sbbMAX_BLOCK_SIZE ) + 1UL );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRunTest( BaseType_t xIsMessageBuffer,
+                            BenchmarkMode_t eMode )
+{
+    BenchmarkTest_t xTest;
+    uint8_t ucTxBuffer[ sbbMAX_BLOCK_SIZE ];
+    uint8_t * pucTxData;
+    uint32_t ulBytesSent = 0UL, ulBlock = 0UL;
+    uint8_t ucNextByte = 0U;
+    size_t xLength, xIndex;
+    TickType_t xStartTime;
+
+    xTest.eMode = eMode;
+    xTest.xIsMessageBuffer = xIsMessageBuffer;
+    xTest.xWriterTask = xTaskGetCurrentTaskHandle();
+    xTest.xErrorFound = pdFALSE;
+
+    if( xIsMessageBuffer != pdFALSE )
+    {
+        xTest.xBuffer = ( StreamBufferHandle_t ) xMessageBufferCreate( sbbBUFFER_SIZE_BYTES );
+    }
+    else
+    {
+        xTest.xBuffer = xStreamBufferCreate( sbbBUFFER_SIZE_BYTES, 1 );
+    }
+
+    configASSERT( xTest.xBuffer != NULL );
+    xTaskCreate( prvReaderTask, "SBRead", configMINIMAL_STACK_SIZE * 2, &xTest, sbbREADER_PRIORITY, NULL );
+
+    xStartTime = xTaskGetTickCount();
+
+    while( ulBytesSent < sbbBYTES_PER_TEST )
+    {
+        xLength = prvBlockLength( ulBlock++ );
+
+        if( eMode == eCopy )
+        {
+            /* Generate the data, then copy it into the buffer. */
+            pucTxData = ucTxBuffer;
+        }
+        else
+        {
+            /* Generate the data directly in the buffer. */
+            xLength = xStreamBufferSendReserve( xTest.xBuffer, ( void ** ) &pucTxData, xLength, portMAX_DELAY );
+            configASSERT( xLength > 0 );
+        }
+
+        for( xIndex = 0; xIndex < xLength; xIndex++ )
+        {
+            pucTxData[ xIndex ] = ucNextByte++;
+        }
+
+        if( eMode == eCopy )
+        {
+            /* A stream buffer accepts as much of the data as there is space for,
+             * so keep sending until it has all been accepted. */
+            xIndex = 0;
+
+            while( xIndex < xLength )
+            {
+                xIndex += xStreamBufferSend( xTest.xBuffer, &( ucTxBuffer[ xIndex ] ), xLength - xIndex, portMAX_DELAY );
+            }
+        }
+        else
+        {
+            ( void ) xStreamBufferSendCommit( xTest.xBuffer, xLength );
+        }
+
+        ulBytesSent += ( uint32_t ) xLength;
+    }
+
+    /* Wait for the reader to receive everything. */
+    ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    configASSERT( xTest.xErrorFound == pdFALSE );
+
+    vStreamBufferDelete( xTest.xBuffer );
+
+    return ( uint32_t ) ( ( xTaskGetTickCount() - xStartTime ) * portTICK_PERIOD_MS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvReaderTask( void * pvParameters )
+{
+    BenchmarkTest_t * pxTest = ( BenchmarkTest_t * ) pvParameters;
+    uint8_t ucRxBuffer[ sbbMAX_BLOCK_SIZE ];
+    uint8_t * pucRxData;
+    uint32_t ulBytesReceived = 0UL, ulBlock = 0UL;
+    uint8_t ucExpectedByte = 0U;
+    size_t xLength, xIndex;
+
+    while( ulBytesReceived < sbbBYTES_PER_TEST )
+    {
+        if( pxTest->eMode == eCopy )
+        {
+            xLength = xStreamBufferReceive( pxTest->xBuffer, ucRxBuffer, sizeof( ucRxBuffer ), portMAX_DELAY );
+            pucRxData = ucRxBuffer;
+        }
+        else
+        {
+            xLength = xStreamBufferReceiveAcquire( pxTest->xBuffer, ( void ** ) &pucRxData, portMAX_DELAY );
+        }
+
+        /* Each message must arrive whole. */
+        if( ( pxTest->xIsMessageBuffer != pdFALSE ) && ( xLength != prvBlockLength( ulBlock++ ) ) )
+        {
+            pxTest->xErrorFound = pdTRUE;
+        }
+
+        for( xIndex = 0; xIndex < xLength; xIndex++ )
+        {
+            if( pucRxData[ xIndex ] != ucExpectedByte++ )
+            {
+                pxTest->xErrorFound = pdTRUE;
+            }
+        }
+
+        if( pxTest->eMode == eZeroCopy )
+        {
+            ( void ) xStreamBufferReceiveRelease( pxTest->xBuffer, xLength );
+        }
+
+        ulBytesReceived += ( uint32_t ) xLength;
+    }
+
+    xTaskNotifyGive( pxTest->xWriterTask );
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vRunStreamBufferBenchmark( void )
+{
+    static const char * const pcBufferNames[] = { "stream", "message" };
+    uint32_t ulCopyTime, ulZeroCopyTime;
+    BaseType_t xIsMessageBuffer;
+
+    for( xIsMessageBuffer = pdFALSE; xIsMessageBuffer <= pdTRUE; xIsMessageBuffer++ )
+    {
+        ulCopyTime = prvRunTest( xIsMessageBuffer, eCopy );
+        ulZeroCopyTime = prvRunTest( xIsMessageBuffer, eZeroCopy );
+
+        configPRINTF( ( "%lu bytes through a %s buffer: copy %lu ms, zero-copy %lu ms\r\n",
+                        ( unsigned long ) sbbBYTES_PER_TEST,
+                        pcBufferNames[ xIsMessageBuffer ],
+                        ( unsigned long ) ulCopyTime,
+                        ( unsigned long ) ulZeroCopyTime ) );
+    }
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,600 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Measures the rate at which a listening TCP socket with a small backlog
+ * accepts connections, and the heap the IP stack uses meanwhile, with and
+ * without a flood of SYNs that are never followed by an ACK, and with and
+ * without SYN cookies.  Runs once the network interface benchmark has started
+ * the IP stack.
+ *
+ * A host thread plays the client, completing one handshake after the other
+ * over the loopback interface, while the benchmark task accepts and closes the
+ * connections.  Another host thread sends the flood, from an address that
+ * nothing answers for and from random ports.  The report gives the connections
+ * accepted per second, the handshakes that failed, the most heap used, and the
+ * heap a socket takes, which is what each SYN used to cost before listening
+ * sockets kept a table of half-open connections.
+ */
+
+/* sendmmsg() is a GNU extension. */
+#define _GNU_SOURCE
+
+/* Standard includes. */
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <time.h>
+#include <sys/socket.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Sockets.h"
+
+/* The handshakes the client completes in each test, and the backlog of the
+ * listening socket. */
+#define tsbCONNECTIONS               ( 500UL )
+#define tsbBACKLOG                   ( 8 )
+
+/* The TCP port the listening socket is bound to, and the first of the ports
+ * the client connects from. */
+#define tsbLISTEN_PORT               ( 5003U )
+#define tsbCLIENT_FIRST_PORT         ( 40000U )
+
+/* The client sends from the peer address the other benchmarks use, the flood
+ * from one that is not in the ARP cache. */
+#define tsbCLIENT_IP_ADDRESS         FreeRTOS_inet_addr_quick( configIP_ADDR0, configIP_ADDR1, configIP_ADDR2, 1 )
+#define tsbFLOOD_IP_ADDRESS          FreeRTOS_inet_addr_quick( configIP_ADDR0, configIP_ADDR1, configIP_ADDR2, 2 )
+
+/* The SYNs the flood thread passes to the kernel in one system call. */
+#define tsbFLOOD_BATCH               ( 32U )
+
+/* The client sends its SYN again if no SYN+ACK arrives within this many
+ * milliseconds, and gives up on the connection after this many SYNs. */
+#define tsbSYN_TIMEOUT_MS            ( 20 )
+#define tsbSYN_ATTEMPTS              ( 5 )
+
+/* The client stops once this many handshakes in a row have failed, as they do
+ * when a flood has filled the backlog and SYN cookies are off. */
+#define tsbMAX_CONSECUTIVE_FAILURES  ( 10UL )
+
+/* The accept timeout of the listening socket. */
+#define tsbACCEPT_TIMEOUT            pdMS_TO_TICKS( 10UL )
+
+/* The TCP flags the host threads send and expect, private to
+ * FreeRTOS_TCP_IP.c. */
+#define tsbTCP_FLAG_SYN              ( 0x02U )
+#define tsbTCP_FLAG_ACK              ( 0x10U )
+
+/* The length of a SYN with an MSS option, and of one that also has a window
+ * scale option. */
+#define tsbSYN_LENGTH                ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER + 4U )
+#define tsbFLOOD_SYN_LENGTH          ( tsbSYN_LENGTH + 4U )
+
+/*-----------------------------------------------------------*/
+
+/* The results of one test. */
+typedef struct TcpSynTestResult
+{
+    uint32_t ulAccepted;
+    uint32_t ulFailed;
+    uint32_t ulFloodSyns;
+    uint64_t ullTimeNs;
+    size_t xMostHeapUsed;
+    uint16_t usMostChildren;
+} TcpSynTestResult_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the host's monotonic time in nanoseconds.
+ */
+static uint64_t prvClockNs( void );
+
+/*
+ * Opens a packet socket bound to the loopback interface that receives the IP
+ * frames sent to ulIPAddress, or none if it is 0.  Returns -1 if it cannot.
+ */
+static int prvOpenPacketSocket( uint32_t ulIPAddress );
+
+/*
+ * Fills pucFrame with a SYN from ulIPAddress and usPort, with an MSS option and,
+ * if xWinScale is pdTRUE, a window scale option.  Returns the frame's length.
+ */
+static size_t prvFillSyn( uint8_t * pucFrame,
+                          uint32_t ulIPAddress,
+                          uint16_t usPort,
+                          uint32_t ulSequenceNumber,
+                          BaseType_t xWinScale );
+
+/*
+ * Fills in the IP and TCP checksums of a frame built by the host threads.
+ */
+static void prvSetChecksums( uint8_t * pucFrame,
+                             size_t xLength );
+
+/*
+ * Host thread that sends SYNs from random ports of tsbFLOOD_IP_ADDRESS as fast
+ * as it can until xStopFlood is set.
+ */
+static void * prvFloodThread( void * pvParameters );
+
+/*
+ * Host thread that completes tsbCONNECTIONS handshakes with the listening
+ * socket, one after the other, then exits.
+ */
+static void * prvClientThread( void * pvParameters );
+
+/*
+ * Starts a host thread with all signals blocked.
+ */
+static void prvStartThread( void * ( *pvThread )( void * ) );
+
+/*
+ * Accepts and closes the connections the client thread makes to a new
+ * listening socket, with or without a flood of SYNs.
+ */
+static void prvRunTest( BaseType_t xFlood,
+                        BaseType_t xSynCookies,
+                        TcpSynTestResult_t * pxResult );
+
+static void prvPrintResult( BaseType_t xFlood,
+                            BaseType_t xSynCookies,
+                            const TcpSynTestResult_t * pxResult );
+
+/*-----------------------------------------------------------*/
+
+/* The MAC addresses the client and the flood send from. */
+static const uint8_t ucClientMACAddress[ ipMAC_ADDRESS_LENGTH_BYTES ] = { 0x02, 0x11, 0x22, 0x33, 0x44, 0x01 };
+static const uint8_t ucFloodMACAddress[ ipMAC_ADDRESS_LENGTH_BYTES ] = { 0x02, 0x11, 0x22, 0x33, 0x44, 0x02 };
+
+/* Set by the benchmark task to stop the flood, and by the host threads once
+ * they have closed their sockets. */
+static volatile BaseType_t xStopFlood = pdFALSE;
+static volatile BaseType_t xFloodDone = pdTRUE;
+static volatile BaseType_t xClientDone = pdTRUE;
+
+/* Counted by the host threads. */
+static volatile uint32_t ulFloodSyns = 0;
+static volatile uint32_t ulClientFailures = 0;
+
+/*-----------------------------------------------------------*/
+
+static uint64_t prvClockNs( void )
+{
+    struct timespec xNow;
+
+    /* clock_gettime() takes no C library locks. */
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static int prvOpenPacketSocket( uint32_t ulIPAddress )
+{
+    struct sockaddr_ll xAddress;
+    const uint16_t usProtocol = ( ulIPAddress != 0UL ) ? ETH_P_IP : 0U;
+
+    /* Accepts only IPv4 frames whose destination address, at offset 30, is
+     * ulIPAddress, so the frames sent to the flood do not fill the socket. */
+    struct sock_filter xInstructions[] =
+    {
+        BPF_STMT( BPF_LD | BPF_W | BPF_ABS, ipSIZE_OF_ETH_HEADER + 16U ),
+        BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, FreeRTOS_ntohl( ulIPAddress ), 0, 1 ),
+        BPF_STMT( BPF_RET | BPF_K, 0xffffU ),
+        BPF_STMT( BPF_RET | BPF_K, 0U )
+    };
+    struct sock_fprog xFilter = { sizeof( xInstructions ) / sizeof( xInstructions[ 0 ] ), xInstructions };
+    int iSocket;
+
+    memset( &xAddress, '\0', sizeof( xAddress ) );
+    xAddress.sll_family = AF_PACKET;
+    xAddress.sll_protocol = htons( usProtocol );
+    xAddress.sll_ifindex = ( int ) if_nametoindex( "lo" );
+
+    iSocket = socket( AF_PACKET, SOCK_RAW, htons( usProtocol ) );
+
+    if( ( iSocket >= 0 ) &&
+        ( ( ( ulIPAddress != 0UL ) && ( setsockopt( iSocket, SOL_SOCKET, SO_ATTACH_FILTER, &xFilter, sizeof( xFilter ) ) != 0 ) ) ||
+          ( bind( iSocket, ( struct sockaddr * ) &xAddress, sizeof( xAddress ) ) != 0 ) ) )
+    {
+        close( iSocket );
+        iSocket = -1;
+    }
+
+    return iSocket;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvFillSyn( uint8_t * pucFrame,
+                          uint32_t ulIPAddress,
+                          uint16_t usPort,
+                          uint32_t ulSequenceNumber,
+                          BaseType_t xWinScale )
+{
+    TCPPacket_t * pxPacket = ( TCPPacket_t * ) pucFrame;
+    const size_t xLength = ( xWinScale != pdFALSE ) ? tsbFLOOD_SYN_LENGTH : tsbSYN_LENGTH;
+
+    memset( pucFrame, 0, xLength );
+    memcpy( pxPacket->xEthernetHeader.xDestinationAddress.ucBytes, ipLOCAL_MAC_ADDRESS, ipMAC_ADDRESS_LENGTH_BYTES );
+    memcpy( pxPacket->xEthernetHeader.xSourceAddress.ucBytes,
+            ( ulIPAddress == tsbFLOOD_IP_ADDRESS ) ? ucFloodMACAddress : ucClientMACAddress,
+            ipMAC_ADDRESS_LENGTH_BYTES );
+    pxPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+
+    pxPacket->xIPHeader.ucVersionHeaderLength = 0x45U;
+    pxPacket->xIPHeader.usLength = FreeRTOS_htons( xLength - ipSIZE_OF_ETH_HEADER );
+    pxPacket->xIPHeader.ucTimeToLive = ipconfigTCP_TIME_TO_LIVE;
+    pxPacket->xIPHeader.ucProtocol = ipPROTOCOL_TCP;
+    pxPacket->xIPHeader.ulSourceIPAddress = ulIPAddress;
+    pxPacket->xIPHeader.ulDestinationIPAddress = FreeRTOS_GetIPAddress();
+
+    pxPacket->xTCPHeader.usSourcePort = FreeRTOS_htons( usPort );
+    pxPacket->xTCPHeader.usDestinationPort = FreeRTOS_htons( tsbLISTEN_PORT );
+    pxPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( ulSequenceNumber );
+    pxPacket->xTCPHeader.ucTCPOffset = ( uint8_t ) ( ( xLength - ipSIZE_OF_ETH_HEADER - ipSIZE_OF_IPv4_HEADER ) << 2 );
+    pxPacket->xTCPHeader.ucTCPFlags = tsbTCP_FLAG_SYN;
+    pxPacket->xTCPHeader.usWindow = FreeRTOS_htons( 0xffffU );
+
+    /* MSS 1460, and window scale 7. */
+    pxPacket->xTCPHeader.ucOptdata[ 0 ] = 2U;
+    pxPacket->xTCPHeader.ucOptdata[ 1 ] = 4U;
+    pxPacket->xTCPHeader.ucOptdata[ 2 ] = ( uint8_t ) ( 1460U >> 8 );
+    pxPacket->xTCPHeader.ucOptdata[ 3 ] = ( uint8_t ) ( 1460U & 0xffU );
+
+    if( xWinScale != pdFALSE )
+    {
+        pxPacket->xTCPHeader.ucOptdata[ 4 ] = 1U;
+        pxPacket->xTCPHeader.ucOptdata[ 5 ] = 3U;
+        pxPacket->xTCPHeader.ucOptdata[ 6 ] = 3U;
+        pxPacket->xTCPHeader.ucOptdata[ 7 ] = 7U;
+    }
+
+    prvSetChecksums( pucFrame, xLength );
+
+    return xLength;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetChecksums( uint8_t * pucFrame,
+                             size_t xLength )
+{
+    IPHeader_t * pxIPHeader = &( ( ( TCPPacket_t * ) pucFrame )->xIPHeader );
+
+    pxIPHeader->usHeaderChecksum = 0U;
+    pxIPHeader->usHeaderChecksum = usGenerateChecksum( 0UL, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER );
+    pxIPHeader->usHeaderChecksum = ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
+
+    /* Only does arithmetic, so may be called by a host thread. */
+    ( void ) usGenerateProtocolChecksum( pucFrame, xLength, pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+static void * prvFloodThread( void * pvParameters )
+{
+    static uint8_t ucFrames[ tsbFLOOD_BATCH ][ tsbFLOOD_SYN_LENGTH ];
+    struct mmsghdr xHostMessages[ tsbFLOOD_BATCH ];
+    struct iovec xVectors[ tsbFLOOD_BATCH ];
+    uint32_t ulRandom = ( uint32_t ) prvClockNs() | 1UL;
+    unsigned int uxMessage;
+    int iSocket, iResult;
+
+    ( void ) pvParameters;
+
+    iSocket = prvOpenPacketSocket( 0UL );
+    configASSERT( iSocket >= 0 );
+
+    memset( xHostMessages, '\0', sizeof( xHostMessages ) );
+
+    for( uxMessage = 0; uxMessage < tsbFLOOD_BATCH; uxMessage++ )
+    {
+        xVectors[ uxMessage ].iov_base = ucFrames[ uxMessage ];
+        xVectors[ uxMessage ].iov_len = tsbFLOOD_SYN_LENGTH;
+        xHostMessages[ uxMessage ].msg_hdr.msg_iov = &( xVectors[ uxMessage ] );
+        xHostMessages[ uxMessage ].msg_hdr.msg_iovlen = 1;
+    }
+
+    while( xStopFlood == pdFALSE )
+    {
+        for( uxMessage = 0; uxMessage < tsbFLOOD_BATCH; uxMessage++ )
+        {
+            /* xorshift32, as rand() takes a C library lock. */
+            ulRandom ^= ulRandom << 13;
+            ulRandom ^= ulRandom >> 17;
+            ulRandom ^= ulRandom << 5;
+
+            ( void ) prvFillSyn( ucFrames[ uxMessage ], tsbFLOOD_IP_ADDRESS, ( uint16_t ) ( 1024U + ( ulRandom % 30000U ) ), ulRandom, pdTRUE );
+        }
+
+        iResult = sendmmsg( iSocket, xHostMessages, tsbFLOOD_BATCH, 0 );
+
+        if( iResult > 0 )
+        {
+            ulFloodSyns += ( uint32_t ) iResult;
+        }
+    }
+
+    close( iSocket );
+    xFloodDone = pdTRUE;
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void * prvClientThread( void * pvParameters )
+{
+    uint8_t ucFrame[ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
+    TCPPacket_t * pxPacket = ( TCPPacket_t * ) ucFrame;
+    const struct timeval xTimeout = { 0, tsbSYN_TIMEOUT_MS * 1000 };
+    uint32_t ulRandom = ( uint32_t ) prvClockNs() | 1UL;
+    uint32_t ulConnection, ulSequenceNumber, ulAckNr, ulConsecutiveFailures = 0;
+    uint16_t usPort;
+    size_t xLength;
+    ssize_t xReceived;
+    BaseType_t xAttempt, xAnswered;
+    uint64_t ullDeadline;
+    int iSocket;
+
+    ( void ) pvParameters;
+
+    iSocket = prvOpenPacketSocket( tsbCLIENT_IP_ADDRESS );
+    configASSERT( iSocket >= 0 );
+    setsockopt( iSocket, SOL_SOCKET, SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+
+    for( ulConnection = 0; ( ulConnection < tsbCONNECTIONS ) && ( ulConsecutiveFailures < tsbMAX_CONSECUTIVE_FAILURES ); ulConnection++ )
+    {
+        ulRandom ^= ulRandom << 13;
+        ulRandom ^= ulRandom >> 17;
+        ulRandom ^= ulRandom << 5;
+
+        ulSequenceNumber = ulRandom;
+        usPort = ( uint16_t ) ( tsbCLIENT_FIRST_PORT + ( ulRandom % 20000U ) );
+        xAnswered = pdFALSE;
+
+        for( xAttempt = 0; ( xAttempt < tsbSYN_ATTEMPTS ) && ( xAnswered == pdFALSE ); xAttempt++ )
+        {
+            xLength = prvFillSyn( ucFrame, tsbCLIENT_IP_ADDRESS, usPort, ulSequenceNumber, pdFALSE );
+            send( iSocket, ucFrame, xLength, 0 );
+
+            ullDeadline = prvClockNs() + ( tsbSYN_TIMEOUT_MS * 1000000ULL );
+
+            while( ( xAnswered == pdFALSE ) && ( prvClockNs() < ullDeadline ) )
+            {
+                xReceived = recv( iSocket, ucFrame, sizeof( ucFrame ), 0 );
+
+                if( ( xReceived >= ( ssize_t ) ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER ) ) &&
+                    ( pxPacket->xIPHeader.ucProtocol == ipPROTOCOL_TCP ) &&
+                    ( pxPacket->xTCPHeader.usDestinationPort == FreeRTOS_htons( usPort ) ) &&
+                    ( pxPacket->xTCPHeader.ucTCPFlags == ( tsbTCP_FLAG_SYN | tsbTCP_FLAG_ACK ) ) &&
+                    ( FreeRTOS_ntohl( pxPacket->xTCPHeader.ulAckNr ) == ( ulSequenceNumber + 1UL ) ) )
+                {
+                    xAnswered = pdTRUE;
+                }
+            }
+        }
+
+        if( xAnswered == pdFALSE )
+        {
+            ulClientFailures++;
+            ulConsecutiveFailures++;
+        }
+        else
+        {
+            ulConsecutiveFailures = 0;
+
+            /* Complete the handshake with a plain ACK. */
+            ulAckNr = FreeRTOS_ntohl( pxPacket->xTCPHeader.ulSequenceNumber ) + 1UL;
+            ( void ) prvFillSyn( ucFrame, tsbCLIENT_IP_ADDRESS, usPort, ulSequenceNumber + 1UL, pdFALSE );
+            xLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER;
+            pxPacket->xIPHeader.usLength = FreeRTOS_htons( xLength - ipSIZE_OF_ETH_HEADER );
+            pxPacket->xTCPHeader.ucTCPOffset = ( uint8_t ) ( ipSIZE_OF_TCP_HEADER << 2 );
+            pxPacket->xTCPHeader.ucTCPFlags = tsbTCP_FLAG_ACK;
+            pxPacket->xTCPHeader.ulAckNr = FreeRTOS_htonl( ulAckNr );
+            prvSetChecksums( ucFrame, xLength );
+            send( iSocket, ucFrame, xLength, 0 );
+        }
+    }
+
+    close( iSocket );
+    xClientDone = pdTRUE;
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartThread( void * ( *pvThread )( void * ) )
+{
+    pthread_t xThread;
+    sigset_t xSignals, xSavedSignals;
+
+    /* The C library must only be called with interrupts masked when using the
+     * POSIX port, see the notes at the top of port.c. */
+    taskENTER_CRITICAL();
+    {
+        sigfillset( &xSignals );
+        pthread_sigmask( SIG_BLOCK, &xSignals, &xSavedSignals );
+        pthread_create( &xThread, NULL, pvThread, NULL );
+        pthread_detach( xThread );
+        pthread_sigmask( SIG_SETMASK, &xSavedSignals, NULL );
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunTest( BaseType_t xFlood,
+                        BaseType_t xSynCookies,
+                        TcpSynTestResult_t * pxResult )
+{
+    struct freertos_sockaddr xBindAddress;
+    const TickType_t xAcceptTimeout = tsbACCEPT_TIMEOUT;
+    const BaseType_t xBacklog = tsbBACKLOG;
+    FreeRTOS_Socket_t * pxListener;
+    Socket_t xListener, xChild;
+    uint64_t ullStartTime, ullLastTime;
+    size_t xFreeHeap, xStartFreeHeap;
+
+    memset( pxResult, '\0', sizeof( *pxResult ) );
+
+    xListener = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+    configASSERT( xListener != FREERTOS_INVALID_SOCKET );
+    pxListener = ( FreeRTOS_Socket_t * ) xListener;
+    FreeRTOS_setsockopt( xListener, 0, FREERTOS_SO_RCVTIMEO, &xAcceptTimeout, sizeof( xAcceptTimeout ) );
+    #if ( ipconfigTCP_SYN_COOKIES == 1 )
+        FreeRTOS_setsockopt( xListener, 0, FREERTOS_SO_SYN_COOKIES, &xSynCookies, sizeof( xSynCookies ) );
+    #endif
+    xBindAddress.sin_port = FreeRTOS_htons( tsbLISTEN_PORT );
+    xBindAddress.sin_addr = 0UL;
+    FreeRTOS_bind( xListener, &xBindAddress, sizeof( xBindAddress ) );
+    FreeRTOS_listen( xListener, xBacklog );
+
+    xStartFreeHeap = xPortGetFreeHeapSize();
+    ulFloodSyns = 0;
+    ulClientFailures = 0;
+
+    if( xFlood != pdFALSE )
+    {
+        /* Give the flood time to fill the backlog before the client starts. */
+        xStopFlood = pdFALSE;
+        xFloodDone = pdFALSE;
+        prvStartThread( prvFloodThread );
+        vTaskDelay( pdMS_TO_TICKS( 50UL ) );
+    }
+
+    ullStartTime = ullTaskGetHighResolutionTime();
+    ullLastTime = ullStartTime;
+    xClientDone = pdFALSE;
+    prvStartThread( prvClientThread );
+
+    /* The accept timeout ends the test once the client has finished. */
+    for( ; ; )
+    {
+        xChild = FreeRTOS_accept( xListener, NULL, NULL );
+
+        xFreeHeap = xPortGetFreeHeapSize();
+
+        if( ( xStartFreeHeap - xFreeHeap ) > pxResult->xMostHeapUsed )
+        {
+            pxResult->xMostHeapUsed = xStartFreeHeap - xFreeHeap;
+        }
+
+        if( pxListener->u.xTCP.usChildCount > pxResult->usMostChildren )
+        {
+            pxResult->usMostChildren = pxListener->u.xTCP.usChildCount;
+        }
+
+        if( ( xChild != NULL ) && ( xChild != FREERTOS_INVALID_SOCKET ) )
+        {
+            pxResult->ulAccepted++;
+            ullLastTime = ullTaskGetHighResolutionTime();
+            FreeRTOS_closesocket( xChild );
+        }
+        else if( xClientDone != pdFALSE )
+        {
+            break;
+        }
+    }
+
+    pxResult->ullTimeNs = ullLastTime - ullStartTime;
+    pxResult->ulFailed = ulClientFailures;
+
+    xStopFlood = pdTRUE;
+
+    while( xFloodDone == pdFALSE )
+    {
+        vTaskDelay( tsbACCEPT_TIMEOUT );
+    }
+
+    pxResult->ulFloodSyns = ulFloodSyns;
+
+    /* Let the IP task process the rest of the flood before the socket that
+     * holds its half-open connections is closed. */
+    vTaskDelay( pdMS_TO_TICKS( 100UL ) );
+    FreeRTOS_closesocket( xListener );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintResult( BaseType_t xFlood,
+                            BaseType_t xSynCookies,
+                            const TcpSynTestResult_t * pxResult )
+{
+    configPRINTF( ( "TCP accept, backlog %d%s%s: %lu of %lu connections in %lu ms, %lu connections per second, %lu handshakes failed, "
+                    "%lu SYNs flooded, at most %u children and %lu bytes of heap used\r\n",
+                    ( int ) tsbBACKLOG,
+                    ( xFlood != pdFALSE ) ? ", SYN flood" : "",
+                    ( xSynCookies != pdFALSE ) ? ", SYN cookies" : "",
+                    ( unsigned long ) pxResult->ulAccepted,
+                    ( unsigned long ) tsbCONNECTIONS,
+                    ( unsigned long ) ( pxResult->ullTimeNs / 1000000ULL ),
+                    ( unsigned long ) ( ( ( uint64_t ) pxResult->ulAccepted * 1000000000ULL ) / ( pxResult->ullTimeNs + 1ULL ) ),
+                    ( unsigned long ) pxResult->ulFailed,
+                    ( unsigned long ) pxResult->ulFloodSyns,
+                    ( unsigned ) pxResult->usMostChildren,
+                    ( unsigned long ) pxResult->xMostHeapUsed ) );
+}
+/*-----------------------------------------------------------*/
+
+void vRunTcpSynBenchmark( void )
+{
+    TcpSynTestResult_t xResult;
+    Socket_t xSocket;
+    size_t xFreeHeap;
+    BaseType_t xFlood, xSynCookies;
+
+    if( FreeRTOS_IsNetworkUp() == pdFALSE )
+    {
+        configPRINTF( ( "TCP SYN benchmark skipped, the IP stack is not running\r\n" ) );
+        return;
+    }
+
+    /* Before a listening socket kept a table of half-open connections, each
+     * SYN took a socket until the handshake completed or timed out. */
+    xFreeHeap = xPortGetFreeHeapSize();
+    xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+    configASSERT( xSocket != FREERTOS_INVALID_SOCKET );
+    configPRINTF( ( "TCP socket: %lu bytes of heap\r\n", ( unsigned long ) ( xFreeHeap - xPortGetFreeHeapSize() ) ) );
+    FreeRTOS_closesocket( xSocket );
+
+    for( xSynCookies = pdFALSE; xSynCookies <= ( ( ipconfigTCP_SYN_COOKIES == 1 ) ? pdTRUE : pdFALSE ); xSynCookies++ )
+    {
+        for( xFlood = pdFALSE; xFlood <= pdTRUE; xFlood++ )
+        {
+            prvRunTest( xFlood, xSynCookies, &xResult );
+            prvPrintResult( xFlood, xSynCookies, &xResult );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
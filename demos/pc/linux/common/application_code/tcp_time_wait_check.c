@@ -0,0 +1,735 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Checks how the IP stack answers late segments of connections it closed
+ * first, which ipconfigTCP_TIME_WAIT_TABLE keeps in a table once the FIN
+ * exchange completes.  Runs after the TCP SYN benchmark.
+ *
+ * A host thread plays the client over the loopback interface, as in
+ * tcp_syn_benchmark.c.  For each connection it completes the handshake, waits
+ * for the FIN the check task sends with FreeRTOS_shutdown(), and answers it
+ * with its own FIN.  It then sends segments of the closed connection and checks
+ * the replies:
+ *  - a repeated FIN is acknowledged, both while the socket still exists and
+ *    after the check task has closed it;
+ *  - a RST removes the entry, after which a repeated FIN gets a RST;
+ *  - a SYN on the same ports removes the entry and is answered by the
+ *    listening socket;
+ *  - when all the entries a connection can be stored in are in use, the oldest
+ *    is replaced.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <time.h>
+#include <sys/socket.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_TCP_IP.h"
+
+#if ( ipconfigTCP_TIME_WAIT_TABLE == 1 )
+
+/* The TCP port the listening socket is bound to, and the first of the ports
+ * the client connects from. */
+    #define twcLISTEN_PORT            ( 5004U )
+    #define twcCLIENT_FIRST_PORT      ( 41000U )
+
+/* The client sends from the peer address the other benchmarks use. */
+    #define twcCLIENT_IP_ADDRESS      FreeRTOS_inet_addr_quick( configIP_ADDR0, configIP_ADDR1, configIP_ADDR2, 1 )
+
+/* The TCP flags the host thread sends and expects, private to
+ * FreeRTOS_TCP_IP.c. */
+    #define twcTCP_FLAG_FIN           ( 0x01U )
+    #define twcTCP_FLAG_SYN           ( 0x02U )
+    #define twcTCP_FLAG_RST           ( 0x04U )
+    #define twcTCP_FLAG_ACK           ( 0x10U )
+
+/* The length of a segment without data, and of a SYN with an MSS option. */
+    #define twcSEGMENT_LENGTH         ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER )
+    #define twcSYN_LENGTH             ( twcSEGMENT_LENGTH + 4U )
+
+/* Milliseconds the client waits for a reply that should come, and for the
+ * check task to accept or close a connection. */
+    #define twcREPLY_TIMEOUT_MS       ( 200U )
+    #define twcTASK_TIMEOUT_MS        ( 2000U )
+
+/* The accept timeout of the listening socket. */
+    #define twcACCEPT_TIMEOUT         pdMS_TO_TICKS( 10UL )
+
+/* A connection is stored in one of this many entries of the table, as in
+ * FreeRTOS_TCP_IP.c, so one more connection with the same hash replaces the
+ * oldest. */
+    #define twcPROBES                 ( ( ipconfigTCP_TIME_WAIT_ENTRIES < 4 ) ? ipconfigTCP_TIME_WAIT_ENTRIES : 4 )
+
+/* The most results the client records. */
+    #define twcMAX_RESULTS            ( 16U )
+
+/*-----------------------------------------------------------*/
+
+/* A connection the client has closed, in host byte order. */
+    typedef struct TimeWaitConnection
+    {
+        uint16_t usPort;         /* The client's port. */
+        uint32_t ulClientFinSeq; /* The sequence number of the client's FIN. */
+        uint32_t ulServerFinSeq; /* The sequence number of the check task's FIN. */
+    } TimeWaitConnection_t;
+
+/* What the client got back for a segment. */
+    typedef enum
+    {
+        eTimeWaitReplyNone,   /* Nothing within twcREPLY_TIMEOUT_MS. */
+        eTimeWaitReplyAck,    /* An ACK of the connection's final sequence numbers. */
+        eTimeWaitReplyRst,    /* A RST. */
+        eTimeWaitReplySynAck, /* A SYN+ACK. */
+        eTimeWaitReplyOther   /* Anything else. */
+    } TimeWaitReply_t;
+
+/* The result of one check, recorded by the client and printed by the task. */
+    typedef struct TimeWaitResult
+    {
+        const char * pcName;
+        TimeWaitReply_t eExpected;
+        TimeWaitReply_t eReceived;
+    } TimeWaitResult_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the host's monotonic time in nanoseconds.
+ */
+    static uint64_t prvClockNs( void );
+
+/*
+ * Sleeps the host thread for ulMs milliseconds.
+ */
+    static void prvSleepMs( uint32_t ulMs );
+
+/*
+ * Opens a packet socket bound to the loopback interface that receives the IP
+ * frames sent to the client.  Returns -1 if it cannot.
+ */
+    static int prvOpenPacketSocket( void );
+
+/*
+ * Sends a segment from the client's usPort to the listening port, with an MSS
+ * option if it is a SYN.
+ */
+    static void prvSendSegment( int iSocket,
+                                uint16_t usPort,
+                                uint32_t ulSequenceNumber,
+                                uint32_t ulAckNr,
+                                uint8_t ucFlags );
+
+/*
+ * Waits up to ulTimeoutMs for a segment to the client's usPort.  Returns
+ * pdTRUE with the segment in pucFrame if one arrived.
+ */
+    static BaseType_t prvReceiveSegment( int iSocket,
+                                         uint16_t usPort,
+                                         uint8_t * pucFrame,
+                                         uint32_t ulTimeoutMs );
+
+/*
+ * Connects from usPort, waits for the check task to send its FIN, and answers
+ * with a FIN, so that the connection enters TIME_WAIT.  Returns pdPASS if the
+ * exchange completed.
+ */
+    static BaseType_t prvConnectAndClose( int iSocket,
+                                          uint16_t usPort,
+                                          TimeWaitConnection_t * pxConnection );
+
+/*
+ * Asks the check task to close the socket of the last connection, and waits
+ * until it has.
+ */
+    static void prvCloseChild( void );
+
+/*
+ * Sends a segment of a closed connection and returns what came back.
+ */
+    static TimeWaitReply_t prvSendLate( int iSocket,
+                                        const TimeWaitConnection_t * pxConnection,
+                                        uint32_t ulSequenceNumber,
+                                        uint8_t ucFlags );
+
+/*
+ * Records the result of a check.
+ */
+    static void prvRecord( const char * pcName,
+                           TimeWaitReply_t eExpected,
+                           TimeWaitReply_t eReceived );
+
+/*
+ * Returns the entry of the TIME_WAIT table that a connection from usPort is
+ * first looked for in, computed as prvTimeWaitHash() in FreeRTOS_TCP_IP.c does.
+ */
+    static uint32_t prvTableIndex( uint16_t usPort );
+
+/*
+ * Host thread that makes the connections and checks the replies, then exits.
+ */
+    static void * prvClientThread( void * pvParameters );
+
+/*
+ * Starts a host thread with all signals blocked.
+ */
+    static void prvStartThread( void * ( *pvThread )( void * ) );
+
+    static const char * pcReplyName( TimeWaitReply_t eReply );
+
+/*-----------------------------------------------------------*/
+
+/* The MAC address the client sends from. */
+    static const uint8_t ucClientMACAddress[ ipMAC_ADDRESS_LENGTH_BYTES ] = { 0x02, 0x11, 0x22, 0x33, 0x44, 0x01 };
+
+/* Set by the client once it has closed its socket. */
+    static volatile BaseType_t xClientDone = pdTRUE;
+
+/* The client asks the check task to close the socket of a connection by
+ * incrementing ulCloseRequests, and the task counts the sockets it closed. */
+    static volatile uint32_t ulCloseRequests = 0;
+    static volatile uint32_t ulChildrenClosed = 0;
+
+/* The client's results. */
+    static TimeWaitResult_t xResults[ twcMAX_RESULTS ];
+    static volatile uint32_t ulResults = 0;
+
+/* State of the client's xorshift32 generator, as rand() takes a C library
+ * lock. */
+    static uint32_t ulRandom = 1UL;
+
+/*-----------------------------------------------------------*/
+
+    static uint64_t prvClockNs( void )
+    {
+        struct timespec xNow;
+
+        /* clock_gettime() takes no C library locks. */
+        clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+        return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSleepMs( uint32_t ulMs )
+    {
+        struct timespec xDelay = { 0, ( long ) ulMs * 1000000L };
+
+        nanosleep( &xDelay, NULL );
+    }
+/*-----------------------------------------------------------*/
+
+    static int prvOpenPacketSocket( void )
+    {
+        struct sockaddr_ll xAddress;
+
+        /* Accepts only IPv4 frames whose destination address, at offset 30, is
+         * the client's. */
+        struct sock_filter xInstructions[] =
+        {
+            BPF_STMT( BPF_LD | BPF_W | BPF_ABS, ipSIZE_OF_ETH_HEADER + 16U ),
+            BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, FreeRTOS_ntohl( twcCLIENT_IP_ADDRESS ), 0, 1 ),
+            BPF_STMT( BPF_RET | BPF_K, 0xffffU ),
+            BPF_STMT( BPF_RET | BPF_K, 0U )
+        };
+        struct sock_fprog xFilter = { sizeof( xInstructions ) / sizeof( xInstructions[ 0 ] ), xInstructions };
+        const struct timeval xTimeout = { 0, 10000 };
+        int iSocket;
+
+        memset( &xAddress, '\0', sizeof( xAddress ) );
+        xAddress.sll_family = AF_PACKET;
+        xAddress.sll_protocol = htons( ETH_P_IP );
+        xAddress.sll_ifindex = ( int ) if_nametoindex( "lo" );
+
+        iSocket = socket( AF_PACKET, SOCK_RAW, htons( ETH_P_IP ) );
+
+        if( ( iSocket >= 0 ) &&
+            ( ( setsockopt( iSocket, SOL_SOCKET, SO_ATTACH_FILTER, &xFilter, sizeof( xFilter ) ) != 0 ) ||
+              ( setsockopt( iSocket, SOL_SOCKET, SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) ) != 0 ) ||
+              ( bind( iSocket, ( struct sockaddr * ) &xAddress, sizeof( xAddress ) ) != 0 ) ) )
+        {
+            close( iSocket );
+            iSocket = -1;
+        }
+
+        return iSocket;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSendSegment( int iSocket,
+                                uint16_t usPort,
+                                uint32_t ulSequenceNumber,
+                                uint32_t ulAckNr,
+                                uint8_t ucFlags )
+    {
+        uint8_t ucFrame[ sizeof( TCPPacket_t ) ];
+        TCPPacket_t * pxPacket = ( TCPPacket_t * ) ucFrame;
+        IPHeader_t * pxIPHeader = &( pxPacket->xIPHeader );
+        const size_t xLength = ( ( ucFlags & twcTCP_FLAG_SYN ) != 0U ) ? twcSYN_LENGTH : twcSEGMENT_LENGTH;
+
+        memset( ucFrame, 0, sizeof( ucFrame ) );
+        memcpy( pxPacket->xEthernetHeader.xDestinationAddress.ucBytes, ipLOCAL_MAC_ADDRESS, ipMAC_ADDRESS_LENGTH_BYTES );
+        memcpy( pxPacket->xEthernetHeader.xSourceAddress.ucBytes, ucClientMACAddress, ipMAC_ADDRESS_LENGTH_BYTES );
+        pxPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+
+        pxIPHeader->ucVersionHeaderLength = 0x45U;
+        pxIPHeader->usLength = FreeRTOS_htons( xLength - ipSIZE_OF_ETH_HEADER );
+        pxIPHeader->ucTimeToLive = ipconfigTCP_TIME_TO_LIVE;
+        pxIPHeader->ucProtocol = ipPROTOCOL_TCP;
+        pxIPHeader->ulSourceIPAddress = twcCLIENT_IP_ADDRESS;
+        pxIPHeader->ulDestinationIPAddress = FreeRTOS_GetIPAddress();
+
+        pxPacket->xTCPHeader.usSourcePort = FreeRTOS_htons( usPort );
+        pxPacket->xTCPHeader.usDestinationPort = FreeRTOS_htons( twcLISTEN_PORT );
+        pxPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( ulSequenceNumber );
+        pxPacket->xTCPHeader.ulAckNr = FreeRTOS_htonl( ulAckNr );
+        pxPacket->xTCPHeader.ucTCPOffset = ( uint8_t ) ( ( xLength - ipSIZE_OF_ETH_HEADER - ipSIZE_OF_IPv4_HEADER ) << 2 );
+        pxPacket->xTCPHeader.ucTCPFlags = ucFlags;
+        pxPacket->xTCPHeader.usWindow = FreeRTOS_htons( 0xffffU );
+
+        if( ( ucFlags & twcTCP_FLAG_SYN ) != 0U )
+        {
+            /* MSS 1460. */
+            pxPacket->xTCPHeader.ucOptdata[ 0 ] = 2U;
+            pxPacket->xTCPHeader.ucOptdata[ 1 ] = 4U;
+            pxPacket->xTCPHeader.ucOptdata[ 2 ] = ( uint8_t ) ( 1460U >> 8 );
+            pxPacket->xTCPHeader.ucOptdata[ 3 ] = ( uint8_t ) ( 1460U & 0xffU );
+        }
+
+        pxIPHeader->usHeaderChecksum = 0U;
+        pxIPHeader->usHeaderChecksum = usGenerateChecksum( 0UL, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER );
+        pxIPHeader->usHeaderChecksum = ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
+
+        /* Only does arithmetic, so may be called by a host thread. */
+        ( void ) usGenerateProtocolChecksum( ucFrame, xLength, pdTRUE );
+
+        send( iSocket, ucFrame, xLength, 0 );
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvReceiveSegment( int iSocket,
+                                         uint16_t usPort,
+                                         uint8_t * pucFrame,
+                                         uint32_t ulTimeoutMs )
+    {
+        const TCPPacket_t * pxPacket = ( const TCPPacket_t * ) pucFrame;
+        const uint64_t ullDeadline = prvClockNs() + ( ( uint64_t ) ulTimeoutMs * 1000000ULL );
+        BaseType_t xReceived = pdFALSE;
+        ssize_t xLength;
+
+        while( ( xReceived == pdFALSE ) && ( prvClockNs() < ullDeadline ) )
+        {
+            xLength = recv( iSocket, pucFrame, ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER, 0 );
+
+            if( ( xLength >= ( ssize_t ) twcSEGMENT_LENGTH ) &&
+                ( pxPacket->xIPHeader.ucProtocol == ipPROTOCOL_TCP ) &&
+                ( pxPacket->xTCPHeader.usSourcePort == FreeRTOS_htons( twcLISTEN_PORT ) ) &&
+                ( pxPacket->xTCPHeader.usDestinationPort == FreeRTOS_htons( usPort ) ) )
+            {
+                xReceived = pdTRUE;
+            }
+        }
+
+        return xReceived;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvConnectAndClose( int iSocket,
+                                          uint16_t usPort,
+                                          TimeWaitConnection_t * pxConnection )
+    {
+        uint8_t ucFrame[ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
+        const TCPPacket_t * pxPacket = ( const TCPPacket_t * ) ucFrame;
+        uint32_t ulClientSeq, ulServerSeq = 0;
+        BaseType_t xStatus = pdFAIL;
+
+        ulRandom ^= ulRandom << 13;
+        ulRandom ^= ulRandom >> 17;
+        ulRandom ^= ulRandom << 5;
+        ulClientSeq = ulRandom;
+
+        prvSendSegment( iSocket, usPort, ulClientSeq, 0UL, twcTCP_FLAG_SYN );
+
+        while( prvReceiveSegment( iSocket, usPort, ucFrame, twcREPLY_TIMEOUT_MS ) != pdFALSE )
+        {
+            if( ( pxPacket->xTCPHeader.ucTCPFlags == ( twcTCP_FLAG_SYN | twcTCP_FLAG_ACK ) ) &&
+                ( FreeRTOS_ntohl( pxPacket->xTCPHeader.ulAckNr ) == ( ulClientSeq + 1UL ) ) )
+            {
+                ulServerSeq = FreeRTOS_ntohl( pxPacket->xTCPHeader.ulSequenceNumber ) + 1UL;
+                xStatus = pdPASS;
+                break;
+            }
+        }
+
+        if( xStatus == pdPASS )
+        {
+            /* Complete the handshake, then wait for the check task to accept
+             * the connection and shut it down. */
+            ulClientSeq++;
+            prvSendSegment( iSocket, usPort, ulClientSeq, ulServerSeq, twcTCP_FLAG_ACK );
+            xStatus = pdFAIL;
+
+            while( prvReceiveSegment( iSocket, usPort, ucFrame, twcTASK_TIMEOUT_MS ) != pdFALSE )
+            {
+                if( ( pxPacket->xTCPHeader.ucTCPFlags & twcTCP_FLAG_FIN ) != 0U )
+                {
+                    ulServerSeq = FreeRTOS_ntohl( pxPacket->xTCPHeader.ulSequenceNumber );
+                    xStatus = pdPASS;
+                    break;
+                }
+            }
+        }
+
+        if( xStatus == pdPASS )
+        {
+            /* Acknowledge the FIN with a FIN of our own, and wait for the last
+             * ACK. */
+            prvSendSegment( iSocket, usPort, ulClientSeq, ulServerSeq + 1UL, twcTCP_FLAG_FIN | twcTCP_FLAG_ACK );
+            xStatus = pdFAIL;
+
+            while( prvReceiveSegment( iSocket, usPort, ucFrame, twcREPLY_TIMEOUT_MS ) != pdFALSE )
+            {
+                if( ( pxPacket->xTCPHeader.ucTCPFlags == twcTCP_FLAG_ACK ) &&
+                    ( FreeRTOS_ntohl( pxPacket->xTCPHeader.ulAckNr ) == ( ulClientSeq + 1UL ) ) )
+                {
+                    xStatus = pdPASS;
+                    break;
+                }
+            }
+        }
+
+        pxConnection->usPort = usPort;
+        pxConnection->ulClientFinSeq = ulClientSeq;
+        pxConnection->ulServerFinSeq = ulServerSeq;
+
+        return xStatus;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvCloseChild( void )
+    {
+        const uint64_t ullDeadline = prvClockNs() + ( ( uint64_t ) twcTASK_TIMEOUT_MS * 1000000ULL );
+        const uint32_t ulRequest = ulCloseRequests + 1UL;
+
+        ulCloseRequests = ulRequest;
+
+        while( ( ulChildrenClosed < ulRequest ) && ( prvClockNs() < ullDeadline ) )
+        {
+            prvSleepMs( 1U );
+        }
+
+        /* FreeRTOS_closesocket() leaves freeing the socket to the IP task. */
+        prvSleepMs( 20U );
+    }
+/*-----------------------------------------------------------*/
+
+    static TimeWaitReply_t prvSendLate( int iSocket,
+                                        const TimeWaitConnection_t * pxConnection,
+                                        uint32_t ulSequenceNumber,
+                                        uint8_t ucFlags )
+    {
+        uint8_t ucFrame[ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
+        const TCPPacket_t * pxPacket = ( const TCPPacket_t * ) ucFrame;
+        TimeWaitReply_t eReply = eTimeWaitReplyNone;
+        uint8_t ucReplyFlags;
+
+        prvSendSegment( iSocket, pxConnection->usPort, ulSequenceNumber, pxConnection->ulServerFinSeq + 1UL, ucFlags );
+
+        if( prvReceiveSegment( iSocket, pxConnection->usPort, ucFrame, twcREPLY_TIMEOUT_MS ) != pdFALSE )
+        {
+            ucReplyFlags = pxPacket->xTCPHeader.ucTCPFlags;
+
+            if( ( ucReplyFlags & twcTCP_FLAG_RST ) != 0U )
+            {
+                eReply = eTimeWaitReplyRst;
+            }
+            else if( ucReplyFlags == ( twcTCP_FLAG_SYN | twcTCP_FLAG_ACK ) )
+            {
+                eReply = eTimeWaitReplySynAck;
+            }
+            else if( ( ucReplyFlags == twcTCP_FLAG_ACK ) &&
+                     ( FreeRTOS_ntohl( pxPacket->xTCPHeader.ulSequenceNumber ) == ( pxConnection->ulServerFinSeq + 1UL ) ) &&
+                     ( FreeRTOS_ntohl( pxPacket->xTCPHeader.ulAckNr ) == ( pxConnection->ulClientFinSeq + 1UL ) ) )
+            {
+                eReply = eTimeWaitReplyAck;
+            }
+            else
+            {
+                eReply = eTimeWaitReplyOther;
+            }
+        }
+
+        return eReply;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvRecord( const char * pcName,
+                           TimeWaitReply_t eExpected,
+                           TimeWaitReply_t eReceived )
+    {
+        if( ulResults < twcMAX_RESULTS )
+        {
+            xResults[ ulResults ].pcName = pcName;
+            xResults[ ulResults ].eExpected = eExpected;
+            xResults[ ulResults ].eReceived = eReceived;
+            ulResults++;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static uint32_t prvTableIndex( uint16_t usPort )
+    {
+        uint32_t ulHash;
+
+        ulHash = twcCLIENT_IP_ADDRESS ^ ( ( ( uint32_t ) FreeRTOS_htons( usPort ) << 16 ) | FreeRTOS_htons( twcLISTEN_PORT ) );
+        ulHash *= 0x9E3779B1UL;
+
+        return ( ulHash >> 16 ) % ( uint32_t ) ipconfigTCP_TIME_WAIT_ENTRIES;
+    }
+/*-----------------------------------------------------------*/
+
+    static void * prvClientThread( void * pvParameters )
+    {
+        TimeWaitConnection_t xConnection, xFull[ twcPROBES + 1 ];
+        uint16_t usPort = twcCLIENT_FIRST_PORT;
+        uint32_t ulIndex, ulConnection;
+        BaseType_t xStatus;
+        int iSocket;
+
+        ( void ) pvParameters;
+
+        ulRandom = ( uint32_t ) prvClockNs() | 1UL;
+        iSocket = prvOpenPacketSocket();
+        configASSERT( iSocket >= 0 );
+
+        /* A repeated FIN is acknowledged whether or not the socket has been
+         * closed, and a RST removes the entry. */
+        if( prvConnectAndClose( iSocket, usPort++, &xConnection ) != pdPASS )
+        {
+            prvRecord( "connect and close", eTimeWaitReplyAck, eTimeWaitReplyNone );
+            prvCloseChild();
+        }
+        else
+        {
+            prvRecord( "repeated FIN, socket open", eTimeWaitReplyAck,
+                       prvSendLate( iSocket, &xConnection, xConnection.ulClientFinSeq, twcTCP_FLAG_FIN | twcTCP_FLAG_ACK ) );
+            prvCloseChild();
+            prvRecord( "repeated FIN, socket closed", eTimeWaitReplyAck,
+                       prvSendLate( iSocket, &xConnection, xConnection.ulClientFinSeq, twcTCP_FLAG_FIN | twcTCP_FLAG_ACK ) );
+            prvRecord( "RST", eTimeWaitReplyNone,
+                       prvSendLate( iSocket, &xConnection, xConnection.ulClientFinSeq + 1UL, twcTCP_FLAG_RST ) );
+            prvRecord( "repeated FIN after RST", eTimeWaitReplyRst,
+                       prvSendLate( iSocket, &xConnection, xConnection.ulClientFinSeq, twcTCP_FLAG_FIN | twcTCP_FLAG_ACK ) );
+        }
+
+        /* A SYN on the same ports starts a new connection. */
+        if( prvConnectAndClose( iSocket, usPort++, &xConnection ) != pdPASS )
+        {
+            prvRecord( "connect and close", eTimeWaitReplyAck, eTimeWaitReplyNone );
+            prvCloseChild();
+        }
+        else
+        {
+            prvCloseChild();
+            prvRecord( "new SYN", eTimeWaitReplySynAck,
+                       prvSendLate( iSocket, &xConnection, xConnection.ulClientFinSeq + 0x10000UL, twcTCP_FLAG_SYN ) );
+
+            /* Give up on the new handshake, which leaves nothing of either
+             * connection. */
+            prvSendSegment( iSocket, xConnection.usPort, xConnection.ulClientFinSeq + 0x10001UL, 0UL, twcTCP_FLAG_RST );
+            prvRecord( "repeated FIN after new SYN", eTimeWaitReplyRst,
+                       prvSendLate( iSocket, &xConnection, xConnection.ulClientFinSeq, twcTCP_FLAG_FIN | twcTCP_FLAG_ACK ) );
+        }
+
+        /* Close one more connection than there are entries for it to be
+         * stored in, each a tick or more after the one before, so the first is
+         * the oldest. */
+        ulIndex = prvTableIndex( usPort );
+        xStatus = pdPASS;
+
+        for( ulConnection = 0; ( ulConnection <= twcPROBES ) && ( xStatus == pdPASS ); ulConnection++ )
+        {
+            while( prvTableIndex( usPort ) != ulIndex )
+            {
+                usPort++;
+            }
+
+            xStatus = prvConnectAndClose( iSocket, usPort++, &( xFull[ ulConnection ] ) );
+            prvCloseChild();
+            prvSleepMs( 5U );
+        }
+
+        if( xStatus != pdPASS )
+        {
+            prvRecord( "connect and close", eTimeWaitReplyAck, eTimeWaitReplyNone );
+        }
+        else
+        {
+            prvRecord( "table full, oldest", eTimeWaitReplyRst,
+                       prvSendLate( iSocket, &( xFull[ 0 ] ), xFull[ 0 ].ulClientFinSeq, twcTCP_FLAG_FIN | twcTCP_FLAG_ACK ) );
+
+            for( ulConnection = 1; ulConnection <= twcPROBES; ulConnection++ )
+            {
+                prvRecord( "table full, newer", eTimeWaitReplyAck,
+                           prvSendLate( iSocket, &( xFull[ ulConnection ] ), xFull[ ulConnection ].ulClientFinSeq, twcTCP_FLAG_FIN | twcTCP_FLAG_ACK ) );
+            }
+        }
+
+        close( iSocket );
+        xClientDone = pdTRUE;
+
+        return NULL;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvStartThread( void * ( *pvThread )( void * ) )
+    {
+        pthread_t xThread;
+        sigset_t xSignals, xSavedSignals;
+
+        /* The C library must only be called with interrupts masked when using
+         * the POSIX port, see the notes at the top of port.c. */
+        taskENTER_CRITICAL();
+        {
+            sigfillset( &xSignals );
+            pthread_sigmask( SIG_BLOCK, &xSignals, &xSavedSignals );
+            pthread_create( &xThread, NULL, pvThread, NULL );
+            pthread_detach( xThread );
+            pthread_sigmask( SIG_SETMASK, &xSavedSignals, NULL );
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    static const char * pcReplyName( TimeWaitReply_t eReply )
+    {
+        static const char * const pcNames[] = { "nothing", "ACK", "RST", "SYN+ACK", "another segment" };
+
+        return pcNames[ eReply ];
+    }
+/*-----------------------------------------------------------*/
+
+    void vRunTcpTimeWaitCheck( void )
+    {
+        struct freertos_sockaddr xBindAddress;
+        const TickType_t xAcceptTimeout = twcACCEPT_TIMEOUT;
+        const BaseType_t xBacklog = 4;
+        Socket_t xListener, xChild;
+        TickType_t xStartTime;
+        uint32_t ulResult, ulPassed = 0;
+
+        if( FreeRTOS_IsNetworkUp() == pdFALSE )
+        {
+            configPRINTF( ( "TCP TIME_WAIT check skipped, the IP stack is not running\r\n" ) );
+            return;
+        }
+
+        xListener = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+        configASSERT( xListener != FREERTOS_INVALID_SOCKET );
+        FreeRTOS_setsockopt( xListener, 0, FREERTOS_SO_RCVTIMEO, &xAcceptTimeout, sizeof( xAcceptTimeout ) );
+        xBindAddress.sin_port = FreeRTOS_htons( twcLISTEN_PORT );
+        xBindAddress.sin_addr = 0UL;
+        FreeRTOS_bind( xListener, &xBindAddress, sizeof( xBindAddress ) );
+        FreeRTOS_listen( xListener, xBacklog );
+
+        ulResults = 0;
+        ulCloseRequests = 0;
+        ulChildrenClosed = 0;
+        xClientDone = pdFALSE;
+        prvStartThread( prvClientThread );
+
+        /* Close each connection first, then close its socket when the client
+         * asks, so the client can send segments both before and after. */
+        for( ; ; )
+        {
+            xChild = FreeRTOS_accept( xListener, NULL, NULL );
+
+            if( ( xChild != NULL ) && ( xChild != FREERTOS_INVALID_SOCKET ) )
+            {
+                FreeRTOS_shutdown( xChild, FREERTOS_SHUT_RDWR );
+
+                xStartTime = xTaskGetTickCount();
+
+                while( ( ulChildrenClosed >= ulCloseRequests ) &&
+                       ( xClientDone == pdFALSE ) &&
+                       ( ( xTaskGetTickCount() - xStartTime ) < pdMS_TO_TICKS( twcTASK_TIMEOUT_MS ) ) )
+                {
+                    vTaskDelay( pdMS_TO_TICKS( 1UL ) );
+                }
+
+                FreeRTOS_closesocket( xChild );
+                ulChildrenClosed++;
+            }
+            else if( xClientDone != pdFALSE )
+            {
+                break;
+            }
+        }
+
+        FreeRTOS_closesocket( xListener );
+
+        for( ulResult = 0; ulResult < ulResults; ulResult++ )
+        {
+            if( xResults[ ulResult ].eReceived == xResults[ ulResult ].eExpected )
+            {
+                ulPassed++;
+            }
+
+            configPRINTF( ( "TCP TIME_WAIT, %s: %s, expected %s\r\n",
+                            xResults[ ulResult ].pcName,
+                            pcReplyName( xResults[ ulResult ].eReceived ),
+                            pcReplyName( xResults[ ulResult ].eExpected ) ) );
+        }
+
+        configPRINTF( ( "TCP TIME_WAIT check: %lu of %lu passed\r\n",
+                        ( unsigned long ) ulPassed,
+                        ( unsigned long ) ulResults ) );
+    }
+/*-----------------------------------------------------------*/
+
+#else /* if ( ipconfigTCP_TIME_WAIT_TABLE == 1 ) */
+
+    void vRunTcpTimeWaitCheck( void )
+    {
+        configPRINTF( ( "TCP TIME_WAIT check skipped, ipconfigTCP_TIME_WAIT_TABLE is 0\r\n" ) );
+    }
+
+#endif /* if ( ipconfigTCP_TIME_WAIT_TABLE == 1 ) */
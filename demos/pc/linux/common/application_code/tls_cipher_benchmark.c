@@ -0,0 +1,314 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Measures the AES-GCM encryption that protects TLS records.  First runs the
+ * mbedTLS AES and GCM known answer tests, and checks the AES block function,
+ * which uses the AES-NI instructions when the CPU has them, gives the same
+ * results as the portable C implementation.  Then reports the cost of an AES
+ * block with each, and the throughput of encrypting and decrypting records of
+ * various sizes as the TLS record layer does, with the 13 byte additional data
+ * and 12 byte nonce of a TLS 1.2 record.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* mbedTLS includes. */
+#include "mbedtls/platform.h"
+#include "mbedtls/aes.h"
+#include "mbedtls/aesni.h"
+#include "mbedtls/gcm.h"
+
+/* The number of blocks encrypted to measure the cost of a block. */
+#define tcbBLOCKS                ( 200000UL )
+
+/* The number of random blocks each implementation of AES encrypts when
+ * checking they match. */
+#define tcbCHECK_BLOCKS          ( 1000UL )
+
+/* The number of bytes encrypted, and then decrypted, for each record size. */
+#define tcbBYTES_PER_SIZE        ( 8UL * 1024UL * 1024UL )
+
+/* The largest record, which is the largest a TLS record can hold. */
+#define tcbMAX_RECORD_SIZE       ( 16384UL )
+
+/* The lengths of the additional data, nonce and tag of a TLS 1.2 record. */
+#define tcbADDITIONAL_LENGTH     ( 13U )
+#define tcbNONCE_LENGTH          ( 12U )
+#define tcbTAG_LENGTH            ( 16U )
+
+#define tcbAES_BLOCK_LENGTH      ( 16U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Allocates from the FreeRTOS heap for mbedTLS, as CRYPTO_ConfigureHeap() does
+ * on the targets.
+ */
+static void * prvCalloc( size_t xNumberOfElements,
+                         size_t xSize );
+
+/*
+ * Runs the known answer tests, and checks AES as dispatched by
+ * mbedtls_aes_crypt_ecb() gives the same results as the portable C
+ * implementation for keys of xKeyBits bits.
+ */
+static void prvCheckKnownAnswers( void );
+static void prvCompareImplementations( unsigned int uxKeyBits );
+
+/*
+ * Returns the number of nanoseconds taken to encrypt tcbBLOCKS blocks, using
+ * mbedtls_aes_crypt_ecb() if xPortable is pdFALSE and the portable C
+ * implementation otherwise.
+ */
+static uint64_t prvTimeBlocks( mbedtls_aes_context * pxAes,
+                               BaseType_t xPortable );
+
+/*
+ * Encrypts then decrypts tcbBYTES_PER_SIZE bytes in records of xRecordSize
+ * bytes, checking each decrypts to the original, and returns the nanoseconds
+ * taken by each in *pullEncryptNs and *pullDecryptNs.
+ */
+static void prvTimeRecords( mbedtls_gcm_context * pxGcm,
+                            size_t xRecordSize,
+                            uint64_t * pullEncryptNs,
+                            uint64_t * pullDecryptNs );
+
+/*-----------------------------------------------------------*/
+
+/* Records are encrypted from one buffer to the other and back. */
+static unsigned char ucPlaintext[ tcbMAX_RECORD_SIZE ];
+static unsigned char ucCiphertext[ tcbMAX_RECORD_SIZE ];
+static unsigned char ucDecrypted[ tcbMAX_RECORD_SIZE ];
+
+/* The record sizes measured, from a small MQTT publish to a full record. */
+static const size_t xRecordSizes[] = { 256U, 1024U, 4096U, tcbMAX_RECORD_SIZE };
+
+/* Arbitrary key, which is only used by this benchmark. */
+static const unsigned char ucKey[ 32 ] =
+{
+    0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+    0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4
+};
+
+/*-----------------------------------------------------------*/
+
+static void * prvCalloc( size_t xNumberOfElements,
+                         size_t xSize )
+{
+    void * pvNew = pvPortMalloc( xNumberOfElements * xSize );
+
+    if( NULL != pvNew )
+    {
+        memset( pvNew, 0, xNumberOfElements * xSize );
+    }
+
+    return pvNew;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCompareImplementations( unsigned int uxKeyBits )
+{
+    mbedtls_aes_context xAes;
+    unsigned char ucBlock[ tcbAES_BLOCK_LENGTH ], ucDispatched[ tcbAES_BLOCK_LENGTH ], ucPortable[ tcbAES_BLOCK_LENGTH ];
+    uint32_t ulBlock, ulValue = 0x12345678UL;
+    size_t xByte;
+    int lResult;
+
+    mbedtls_aes_init( &xAes );
+    lResult = mbedtls_aes_setkey_enc( &xAes, ucKey, uxKeyBits );
+    configASSERT( 0 == lResult );
+
+    for( ulBlock = 0; ulBlock < tcbCHECK_BLOCKS; ulBlock++ )
+    {
+        for( xByte = 0; xByte < sizeof( ucBlock ); xByte++ )
+        {
+            /* xorshift32. */
+            ulValue ^= ulValue << 13;
+            ulValue ^= ulValue >> 17;
+            ulValue ^= ulValue << 5;
+            ucBlock[ xByte ] = ( unsigned char ) ulValue;
+        }
+
+        lResult = mbedtls_aes_crypt_ecb( &xAes, MBEDTLS_AES_ENCRYPT, ucBlock, ucDispatched );
+        configASSERT( 0 == lResult );
+        lResult = mbedtls_internal_aes_encrypt( &xAes, ucBlock, ucPortable );
+        configASSERT( 0 == lResult );
+        configASSERT( 0 == memcmp( ucDispatched, ucPortable, sizeof( ucDispatched ) ) );
+    }
+
+    ( void ) lResult;
+    mbedtls_aes_free( &xAes );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckKnownAnswers( void )
+{
+    int lResult;
+
+    lResult = mbedtls_aes_self_test( 0 );
+    configASSERT( 0 == lResult );
+    lResult = mbedtls_gcm_self_test( 0 );
+    configASSERT( 0 == lResult );
+    ( void ) lResult;
+
+    prvCompareImplementations( 128 );
+    prvCompareImplementations( 256 );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeBlocks( mbedtls_aes_context * pxAes,
+                               BaseType_t xPortable )
+{
+    unsigned char ucBlock[ tcbAES_BLOCK_LENGTH ] = { 0 };
+    uint64_t ullStartTime;
+    uint32_t ulBlock;
+
+    ullStartTime = ullTaskGetHighResolutionTime();
+
+    /* Each block encrypts the previous one, so the blocks cannot overlap. */
+    for( ulBlock = 0; ulBlock < tcbBLOCKS; ulBlock++ )
+    {
+        if( xPortable != pdFALSE )
+        {
+            ( void ) mbedtls_internal_aes_encrypt( pxAes, ucBlock, ucBlock );
+        }
+        else
+        {
+            ( void ) mbedtls_aes_crypt_ecb( pxAes, MBEDTLS_AES_ENCRYPT, ucBlock, ucBlock );
+        }
+    }
+
+    return ullTaskGetHighResolutionTime() - ullStartTime;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeRecords( mbedtls_gcm_context * pxGcm,
+                            size_t xRecordSize,
+                            uint64_t * pullEncryptNs,
+                            uint64_t * pullDecryptNs )
+{
+    unsigned char ucNonce[ tcbNONCE_LENGTH ] = { 0 };
+    unsigned char ucAdditional[ tcbADDITIONAL_LENGTH ] = { 0 };
+    unsigned char ucTag[ tcbTAG_LENGTH ];
+    uint32_t ulRecord, ulRecords = ( uint32_t ) ( tcbBYTES_PER_SIZE / xRecordSize );
+    uint64_t ullStartTime;
+    int lResult;
+
+    *pullEncryptNs = 0;
+    *pullDecryptNs = 0;
+
+    for( ulRecord = 0; ulRecord < ulRecords; ulRecord++ )
+    {
+        /* The explicit part of the nonce and the sequence number in the
+         * additional data change with each record. */
+        memcpy( &ucNonce[ tcbNONCE_LENGTH - sizeof( ulRecord ) ], &ulRecord, sizeof( ulRecord ) );
+        memcpy( ucAdditional, &ulRecord, sizeof( ulRecord ) );
+        ucPlaintext[ 0 ] = ( unsigned char ) ulRecord;
+
+        ullStartTime = ullTaskGetHighResolutionTime();
+        lResult = mbedtls_gcm_crypt_and_tag( pxGcm, MBEDTLS_GCM_ENCRYPT, xRecordSize,
+                                             ucNonce, sizeof( ucNonce ),
+                                             ucAdditional, sizeof( ucAdditional ),
+                                             ucPlaintext, ucCiphertext,
+                                             sizeof( ucTag ), ucTag );
+        *pullEncryptNs += ullTaskGetHighResolutionTime() - ullStartTime;
+        configASSERT( 0 == lResult );
+
+        ullStartTime = ullTaskGetHighResolutionTime();
+        lResult = mbedtls_gcm_auth_decrypt( pxGcm, xRecordSize,
+                                            ucNonce, sizeof( ucNonce ),
+                                            ucAdditional, sizeof( ucAdditional ),
+                                            ucTag, sizeof( ucTag ),
+                                            ucCiphertext, ucDecrypted );
+        *pullDecryptNs += ullTaskGetHighResolutionTime() - ullStartTime;
+        configASSERT( 0 == lResult );
+        configASSERT( 0 == memcmp( ucPlaintext, ucDecrypted, xRecordSize ) );
+    }
+
+    ( void ) lResult;
+}
+/*-----------------------------------------------------------*/
+
+void vRunTlsCipherBenchmark( void )
+{
+    mbedtls_aes_context xAes;
+    mbedtls_gcm_context xGcm;
+    uint64_t ullDispatchedNs, ullPortableNs, ullEncryptNs, ullDecryptNs;
+    BaseType_t xAesInstructions = pdFALSE, xClmulInstructions = pdFALSE;
+    size_t xSize, xByte;
+    int lResult;
+
+    ( void ) mbedtls_platform_set_calloc_free( prvCalloc, vPortFree );
+
+    #if defined( MBEDTLS_AESNI_C ) && defined( MBEDTLS_HAVE_X86_64 )
+        xAesInstructions = ( BaseType_t ) mbedtls_aesni_has_support( MBEDTLS_AESNI_AES );
+        xClmulInstructions = ( BaseType_t ) mbedtls_aesni_has_support( MBEDTLS_AESNI_CLMUL );
+    #endif
+
+    prvCheckKnownAnswers();
+
+    mbedtls_aes_init( &xAes );
+    lResult = mbedtls_aes_setkey_enc( &xAes, ucKey, 128 );
+    configASSERT( 0 == lResult );
+    ullDispatchedNs = prvTimeBlocks( &xAes, pdFALSE );
+    ullPortableNs = prvTimeBlocks( &xAes, pdTRUE );
+    mbedtls_aes_free( &xAes );
+
+    configPRINTF( ( "AES-128 block: %lu ns with AES instructions %s, %lu ns portable, GHASH with carry-less multiply %s\r\n",
+                    ( unsigned long ) ( ullDispatchedNs / tcbBLOCKS ),
+                    ( xAesInstructions != pdFALSE ) ? "used" : "not available",
+                    ( unsigned long ) ( ullPortableNs / tcbBLOCKS ),
+                    ( xClmulInstructions != pdFALSE ) ? "used" : "not available" ) );
+
+    for( xByte = 0; xByte < sizeof( ucPlaintext ); xByte++ )
+    {
+        ucPlaintext[ xByte ] = ( unsigned char ) xByte;
+    }
+
+    mbedtls_gcm_init( &xGcm );
+    lResult = mbedtls_gcm_setkey( &xGcm, MBEDTLS_CIPHER_ID_AES, ucKey, 128 );
+    configASSERT( 0 == lResult );
+    ( void ) lResult;
+
+    for( xSize = 0; xSize < ( sizeof( xRecordSizes ) / sizeof( xRecordSizes[ 0 ] ) ); xSize++ )
+    {
+        prvTimeRecords( &xGcm, xRecordSizes[ xSize ], &ullEncryptNs, &ullDecryptNs );
+
+        /* Bytes per microsecond is millions of bytes per second. */
+        configPRINTF( ( "AES-128-GCM %lu byte records: encrypt %lu MB/s, decrypt %lu MB/s\r\n",
+                        ( unsigned long ) xRecordSizes[ xSize ],
+                        ( unsigned long ) ( ( uint64_t ) tcbBYTES_PER_SIZE * 1000ULL / ullEncryptNs ),
+                        ( unsigned long ) ( ( uint64_t ) tcbBYTES_PER_SIZE * 1000ULL / ullDecryptNs ) ) );
+    }
+
+    mbedtls_gcm_free( &xGcm );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,226 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Measures the cost of recording an event in the trace ring, first by recording
+ * application events in a loop, then by comparing a queue ping-pong between two
+ * tasks with recording stopped and with recording running.  A short ping-pong
+ * is then recorded on its own and the trace data saved to kernel_trace.bin,
+ * which can be decoded with tools/kernel_trace/trace_decode.py.  Only runs when
+ * the demo is built with "make TRACE=1".
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <time.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#if ( configUSE_TRACE_RING == 1 )
+
+/* The file the trace data is saved to, in the directory the demo is run from. */
+#define trbTRACE_FILE_NAME       "kernel_trace.bin"
+
+/* The number of application events recorded by the direct test. */
+#define trbUSER_EVENTS           ( 10000000UL )
+
+/* The number of round trips made by the ping-pong test, and by the ping-pong
+ * saved to the trace file. */
+#define trbPING_PONG_ITEMS       ( 20000UL )
+#define trbRECORDED_ITEMS        ( 200UL )
+
+/* The pong task runs at the same priority as the benchmark task. */
+#define trbPONG_TASK_PRIORITY    ( tskIDLE_PRIORITY + 2 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Passes ulItems items to the pong task and back, and returns the time taken
+ * in nanoseconds.
+ */
+static uint64_t prvPingPong( uint32_t ulItems );
+
+/*
+ * Echoes every item received on one queue back on another.
+ */
+static void prvPongTask( void * pvParameters );
+
+/*
+ * Returns the time from the host's monotonic clock in nanoseconds.
+ */
+static uint64_t prvGetTimeNs( void );
+
+/*
+ * Saves the trace data to trbTRACE_FILE_NAME.
+ */
+static void prvSaveTrace( void );
+
+/*-----------------------------------------------------------*/
+
+/* Queues used by the ping-pong test. */
+static QueueHandle_t xPingQueue = NULL;
+static QueueHandle_t xPongQueue = NULL;
+
+/*-----------------------------------------------------------*/
+
+uint32_t ulGetTraceTimestamp( void )
+{
+    /* Wraps every 4.3 seconds, which the decoder allows for. */
+    return ( uint32_t ) prvGetTimeNs();
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvGetTimeNs( void )
+{
+    struct timespec xNow;
+
+    /* clock_gettime() is async-signal-safe, so can be called with the
+     * simulated interrupts masked. */
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvPingPong( uint32_t ulItems )
+{
+    uint32_t ulItem, ulReceived;
+    uint64_t ullStartTime;
+
+    ullStartTime = prvGetTimeNs();
+
+    for( ulItem = 0; ulItem < ulItems; ulItem++ )
+    {
+        xQueueSend( xPingQueue, &ulItem, portMAX_DELAY );
+        xQueueReceive( xPongQueue, &ulReceived, portMAX_DELAY );
+        configASSERT( ulReceived == ulItem );
+    }
+
+    return prvGetTimeNs() - ullStartTime;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPongTask( void * pvParameters )
+{
+    uint32_t ulItem;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        xQueueReceive( xPingQueue, &ulItem, portMAX_DELAY );
+        xQueueSend( xPongQueue, &ulItem, portMAX_DELAY );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvSaveTrace( void )
+{
+    const void * pvData;
+    size_t xSize, xWritten = 0;
+    FILE * pxFile;
+
+    pvData = pvTraceRingGetData( &xSize );
+
+    /* The C library must only be called with interrupts masked when using the
+     * POSIX port, see the notes at the top of port.c. */
+    taskENTER_CRITICAL();
+    {
+        pxFile = fopen( trbTRACE_FILE_NAME, "wb" );
+
+        if( pxFile != NULL )
+        {
+            xWritten = fwrite( pvData, 1, xSize, pxFile );
+            fclose( pxFile );
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if( xWritten == xSize )
+    {
+        configPRINTF( ( "Saved %lu bytes of trace data to %s, decode with tools/kernel_trace/trace_decode.py\r\n",
+                        ( unsigned long ) xSize,
+                        trbTRACE_FILE_NAME ) );
+    }
+    else
+    {
+        configPRINTF( ( "Could not save the trace data to %s\r\n", trbTRACE_FILE_NAME ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vRunTraceRingBenchmark( void )
+{
+    uint64_t ullDirectTime, ullStoppedTime, ullRecordingTime;
+    uint32_t ulEvent, ulEvents;
+
+    xPingQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+    xPongQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+    configASSERT( ( xPingQueue != NULL ) && ( xPongQueue != NULL ) );
+    xTaskCreate( prvPongTask, "TracePong", configMINIMAL_STACK_SIZE, NULL, trbPONG_TASK_PRIORITY, NULL );
+
+    /* The cost of recording an event, with the event's cache lines not in use
+     * by any other core. */
+    ullDirectTime = prvGetTimeNs();
+
+    for( ulEvent = 0; ulEvent < trbUSER_EVENTS; ulEvent++ )
+    {
+        vTraceRingUserEvent( 0, ulEvent );
+    }
+
+    ullDirectTime = prvGetTimeNs() - ullDirectTime;
+
+    /* The cost of recording the events the kernel generates during a
+     * ping-pong. */
+    vTraceRingStop();
+    ullStoppedTime = prvPingPong( trbPING_PONG_ITEMS );
+
+    vTraceRingStart( pdTRUE );
+    ullRecordingTime = prvPingPong( trbPING_PONG_ITEMS );
+    ulEvents = ulTraceRingGetEventCount();
+
+    configPRINTF( ( "Trace ring: %lu application events at %lu ns/event\r\n",
+                    ( unsigned long ) trbUSER_EVENTS,
+                    ( unsigned long ) ( ullDirectTime / trbUSER_EVENTS ) ) );
+    configPRINTF( ( "Trace ring: %lu ping-pong round trips take %lu us without recording, %lu us recording %lu events (%ld ns/event)\r\n",
+                    ( unsigned long ) trbPING_PONG_ITEMS,
+                    ( unsigned long ) ( ullStoppedTime / 1000ULL ),
+                    ( unsigned long ) ( ullRecordingTime / 1000ULL ),
+                    ( unsigned long ) ulEvents,
+                    ( long ) ( ( ( int64_t ) ullRecordingTime - ( int64_t ) ullStoppedTime ) / ( int64_t ) ulEvents ) ) );
+
+    /* Record a short ping-pong on its own for the decoder. */
+    vTraceRingStart( pdTRUE );
+    ( void ) prvPingPong( trbRECORDED_ITEMS );
+    vTraceRingStop();
+
+    prvSaveTrace();
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TRACE_RING */
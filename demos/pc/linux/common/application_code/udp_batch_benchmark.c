@@ -0,0 +1,614 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Compares the throughput of small UDP datagrams received and sent by the IP
+ * stack one at a time, with FreeRTOS_recvfrom() and FreeRTOS_sendto(), with
+ * that of batches of them, with FreeRTOS_recvmmsg() and FreeRTOS_sendmmsg(),
+ * each with and without FREERTOS_ZERO_COPY.  Runs once the network interface
+ * benchmark has started the IP stack.
+ *
+ * For the receive tests a host thread sends datagrams to a socket over the
+ * loopback interface as fast as it can, and the benchmark task reads them.  For
+ * the transmit tests the benchmark task sends datagrams to an address nothing
+ * answers for, which the receive tests have added to the ARP cache, and counts
+ * those that reach the loopback interface.  Both report the datagrams per
+ * second, the datagrams taken by each call, and the CPU time the benchmark task
+ * and the IP task used for each datagram.  Datagrams that arrive while no
+ * network buffer is free are dropped, as they would be with real traffic, and
+ * are reported.
+ */
+
+/* sendmmsg() is a GNU extension. */
+#define _GNU_SOURCE
+
+/* Standard includes. */
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <time.h>
+#include <sys/socket.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Sockets.h"
+
+/* The datagrams sent by each test, and the largest number passed to or taken
+ * from the stack in one call. */
+#define ubbDATAGRAMS                 ( 100000UL )
+#define ubbBATCH                     ( 32U )
+
+/* The largest payload sent by the tests. */
+#define ubbMAX_PAYLOAD_LENGTH        ( 256U )
+
+/* The UDP port the receive tests send to, and the address the receive tests
+ * send from and the transmit tests send to. */
+#define ubbRX_PORT                   ( 5002U )
+#define ubbPEER_PORT                 ( 5000U )
+#define ubbPEER_IP_ADDRESS           FreeRTOS_inet_addr_quick( configIP_ADDR0, configIP_ADDR1, configIP_ADDR2, 1 )
+
+/* The frames the sender thread passes to the kernel in one system call. */
+#define ubbSENDER_BATCH              ( 32U )
+
+/* A test ends once no datagram has arrived for this long. */
+#define ubbIDLE_TIMEOUT              pdMS_TO_TICKS( 100UL )
+
+/*-----------------------------------------------------------*/
+
+/* The results of one test. */
+typedef struct UdpTestResult
+{
+    uint32_t ulDatagrams;
+    uint32_t ulSent;
+    uint32_t ulCalls;
+    uint64_t ullTimeNs;
+    uint64_t ullCpuTimeNs;
+} UdpTestResult_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the host's monotonic time, or the CPU time used by the calling
+ * thread, in nanoseconds.
+ */
+static uint64_t prvClockNs( clockid_t xClock );
+
+/*
+ * Returns the CPU time used so far by the calling task and the IP task.
+ */
+static uint64_t prvTaskCpuTime( void );
+
+/*
+ * Opens a packet socket bound to the loopback interface that receives frames
+ * of type usProtocol, or none if it is 0.  Returns -1 if it cannot.
+ */
+static int prvOpenPacketSocket( uint16_t usProtocol );
+
+/*
+ * Fills ucSenderFrame with a datagram carrying xPayloadLength bytes, sent from
+ * the peer to the receive tests' socket.
+ */
+static void prvFillFrame( size_t xPayloadLength );
+
+/*
+ * Host thread that sends ubbDATAGRAMS copies of ucSenderFrame as fast as it
+ * can, then exits.
+ */
+static void * prvSenderThread( void * pvParameters );
+
+/*
+ * Reads and resets the number of frames a packet socket has seen.
+ */
+static uint32_t prvFramesSeen( int iSocket );
+
+/*
+ * Receives the datagrams sent by the sender thread, one or ubbBATCH at a time.
+ */
+static void prvRunRxTest( Socket_t xSocket,
+                          BaseType_t xBatch,
+                          BaseType_t xFlags,
+                          size_t xPayloadLength,
+                          UdpTestResult_t * pxResult );
+
+/*
+ * Sends ubbDATAGRAMS datagrams to the peer, one or ubbBATCH at a time.
+ */
+static void prvRunTxTest( Socket_t xSocket,
+                          BaseType_t xBatch,
+                          BaseType_t xFlags,
+                          size_t xPayloadLength,
+                          UdpTestResult_t * pxResult );
+
+static void prvPrintResult( const char * pcTest,
+                            BaseType_t xBatch,
+                            BaseType_t xFlags,
+                            size_t xPayloadLength,
+                            const UdpTestResult_t * pxResult );
+
+/*
+ * Returns the CPU time used so far by the IP task, defined in main.c.
+ */
+extern uint64_t ullGetIPTaskCpuTime( void );
+
+/*-----------------------------------------------------------*/
+
+/* The MAC address the receive tests send from, as the network interface
+ * benchmark does. */
+static const uint8_t ucPeerMACAddress[ ipMAC_ADDRESS_LENGTH_BYTES ] = { 0x02, 0x11, 0x22, 0x33, 0x44, 0x01 };
+
+/* The payload lengths tested. */
+static const size_t xPayloadLengths[] = { 16U, 64U, 256U };
+
+/* The frame the sender thread sends, and its length. */
+static uint8_t ucSenderFrame[ ipUDP_PAYLOAD_OFFSET_IPv4 + ubbMAX_PAYLOAD_LENGTH ];
+static size_t xSenderFrameLength = 0;
+
+/* Set by the sender thread once it has sent all its frames. */
+static volatile BaseType_t xSenderDone = pdFALSE;
+
+/* The buffers datagrams are copied to and from. */
+static uint8_t ucBuffers[ ubbBATCH ][ ubbMAX_PAYLOAD_LENGTH ];
+static struct freertos_mmsghdr xMessages[ ubbBATCH ];
+
+/*-----------------------------------------------------------*/
+
+static uint64_t prvClockNs( clockid_t xClock )
+{
+    struct timespec xNow;
+
+    /* clock_gettime() takes no C library locks. */
+    clock_gettime( xClock, &xNow );
+
+    return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTaskCpuTime( void )
+{
+    return prvClockNs( CLOCK_THREAD_CPUTIME_ID ) + ullGetIPTaskCpuTime();
+}
+/*-----------------------------------------------------------*/
+
+static int prvOpenPacketSocket( uint16_t usProtocol )
+{
+    struct sockaddr_ll xAddress;
+    int iSocket;
+
+    memset( &xAddress, '\0', sizeof( xAddress ) );
+    xAddress.sll_family = AF_PACKET;
+    xAddress.sll_protocol = htons( usProtocol );
+    xAddress.sll_ifindex = ( int ) if_nametoindex( "lo" );
+
+    iSocket = socket( AF_PACKET, SOCK_RAW, htons( usProtocol ) );
+
+    if( ( iSocket >= 0 ) && ( bind( iSocket, ( struct sockaddr * ) &xAddress, sizeof( xAddress ) ) != 0 ) )
+    {
+        close( iSocket );
+        iSocket = -1;
+    }
+
+    return iSocket;
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillFrame( size_t xPayloadLength )
+{
+    UDPPacket_t * pxPacket = ( UDPPacket_t * ) ucSenderFrame;
+    IPHeader_t * pxIPHeader = &( pxPacket->xIPHeader );
+
+    xSenderFrameLength = ipUDP_PAYLOAD_OFFSET_IPv4 + xPayloadLength;
+
+    memset( ucSenderFrame, 0, sizeof( ucSenderFrame ) );
+    memcpy( pxPacket->xEthernetHeader.xDestinationAddress.ucBytes, ipLOCAL_MAC_ADDRESS, ipMAC_ADDRESS_LENGTH_BYTES );
+    memcpy( pxPacket->xEthernetHeader.xSourceAddress.ucBytes, ucPeerMACAddress, ipMAC_ADDRESS_LENGTH_BYTES );
+    pxPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+
+    /* IPv4 with no options.  The datagrams carry no UDP checksum, so only the
+     * IP header's checksum need be filled in. */
+    pxIPHeader->ucVersionHeaderLength = 0x45U;
+    pxIPHeader->usLength = FreeRTOS_htons( xSenderFrameLength - ipSIZE_OF_ETH_HEADER );
+    pxIPHeader->ucTimeToLive = ipconfigUDP_TIME_TO_LIVE;
+    pxIPHeader->ucProtocol = ipPROTOCOL_UDP;
+    pxIPHeader->ulSourceIPAddress = ubbPEER_IP_ADDRESS;
+    pxIPHeader->ulDestinationIPAddress = FreeRTOS_GetIPAddress();
+    pxIPHeader->usHeaderChecksum = usGenerateChecksum( 0UL, ( uint8_t * ) &( pxIPHeader->ucVersionHeaderLength ), ipSIZE_OF_IPv4_HEADER );
+    pxIPHeader->usHeaderChecksum = ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
+
+    pxPacket->xUDPHeader.usSourcePort = FreeRTOS_htons( ubbPEER_PORT );
+    pxPacket->xUDPHeader.usDestinationPort = FreeRTOS_htons( ubbRX_PORT );
+    pxPacket->xUDPHeader.usLength = FreeRTOS_htons( xSenderFrameLength - ipSIZE_OF_ETH_HEADER - ipSIZE_OF_IPv4_HEADER );
+}
+/*-----------------------------------------------------------*/
+
+static void * prvSenderThread( void * pvParameters )
+{
+    struct mmsghdr xHostMessages[ ubbSENDER_BATCH ];
+    struct iovec xVector;
+    uint32_t ulSent = 0;
+    unsigned int uxMessage;
+    int iSocket, iResult;
+
+    ( void ) pvParameters;
+
+    iSocket = prvOpenPacketSocket( 0 );
+    configASSERT( iSocket >= 0 );
+
+    xVector.iov_base = ucSenderFrame;
+    xVector.iov_len = xSenderFrameLength;
+    memset( xHostMessages, '\0', sizeof( xHostMessages ) );
+
+    for( uxMessage = 0; uxMessage < ubbSENDER_BATCH; uxMessage++ )
+    {
+        xHostMessages[ uxMessage ].msg_hdr.msg_iov = &xVector;
+        xHostMessages[ uxMessage ].msg_hdr.msg_iovlen = 1;
+    }
+
+    while( ulSent < ubbDATAGRAMS )
+    {
+        iResult = sendmmsg( iSocket, xHostMessages, ubbSENDER_BATCH, 0 );
+
+        if( iResult > 0 )
+        {
+            ulSent += ( uint32_t ) iResult;
+        }
+    }
+
+    close( iSocket );
+    xSenderDone = pdTRUE;
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvFramesSeen( int iSocket )
+{
+    struct tpacket_stats xStats;
+    socklen_t xLength = sizeof( xStats );
+    uint32_t ulSeen = 0;
+
+    /* Counts frames the socket dropped as well as those it queued, so the
+     * socket need never be read. */
+    taskENTER_CRITICAL();
+    {
+        if( getsockopt( iSocket, SOL_PACKET, PACKET_STATISTICS, &xStats, &xLength ) == 0 )
+        {
+            ulSeen = xStats.tp_packets;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return ulSeen;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunRxTest( Socket_t xSocket,
+                          BaseType_t xBatch,
+                          BaseType_t xFlags,
+                          size_t xPayloadLength,
+                          UdpTestResult_t * pxResult )
+{
+    struct freertos_sockaddr xAddress;
+    socklen_t xAddressLength = sizeof( xAddress );
+    uint64_t ullStartTime, ullLastTime, ullStartCpuTime;
+    uint8_t * pucZeroCopyBuffer;
+    pthread_t xThread;
+    sigset_t xSignals, xSavedSignals;
+    int32_t lReceived;
+    uint32_t ulDatagrams = 0, ulCalls = 0, ulWaits = 0;
+    size_t xMessage;
+
+    prvFillFrame( xPayloadLength );
+    xSenderDone = pdFALSE;
+
+    ullStartCpuTime = prvTaskCpuTime();
+    ullStartTime = ullTaskGetHighResolutionTime();
+    ullLastTime = ullStartTime;
+
+    /* The C library must only be called with interrupts masked when using the
+     * POSIX port, see the notes at the top of port.c. */
+    taskENTER_CRITICAL();
+    {
+        sigfillset( &xSignals );
+        pthread_sigmask( SIG_BLOCK, &xSignals, &xSavedSignals );
+        pthread_create( &xThread, NULL, prvSenderThread, NULL );
+        pthread_detach( xThread );
+        pthread_sigmask( SIG_SETMASK, &xSavedSignals, NULL );
+    }
+    taskEXIT_CRITICAL();
+
+    /* The socket's receive timeout ends the test once the sender has
+     * finished, and allows it a few timeouts to start. */
+    for( ; ; )
+    {
+        if( xBatch == pdFALSE )
+        {
+            if( ( xFlags & FREERTOS_ZERO_COPY ) != 0 )
+            {
+                lReceived = FreeRTOS_recvfrom( xSocket, &pucZeroCopyBuffer, 0, FREERTOS_ZERO_COPY, &xAddress, &xAddressLength );
+
+                if( lReceived > 0 )
+                {
+                    FreeRTOS_ReleaseUDPPayloadBuffer( pucZeroCopyBuffer );
+                }
+            }
+            else
+            {
+                lReceived = FreeRTOS_recvfrom( xSocket, ucBuffers[ 0 ], sizeof( ucBuffers[ 0 ] ), 0, &xAddress, &xAddressLength );
+            }
+
+            lReceived = ( lReceived > 0 ) ? 1 : 0;
+        }
+        else
+        {
+            for( xMessage = 0; xMessage < ubbBATCH; xMessage++ )
+            {
+                xMessages[ xMessage ].pvBuffer = ucBuffers[ xMessage ];
+                xMessages[ xMessage ].xLength = sizeof( ucBuffers[ xMessage ] );
+            }
+
+            lReceived = FreeRTOS_recvmmsg( xSocket, xMessages, ubbBATCH, xFlags );
+
+            if( ( xFlags & FREERTOS_ZERO_COPY ) != 0 )
+            {
+                for( xMessage = 0; ( int32_t ) xMessage < lReceived; xMessage++ )
+                {
+                    FreeRTOS_ReleaseUDPPayloadBuffer( xMessages[ xMessage ].pvBuffer );
+                }
+            }
+        }
+
+        if( lReceived > 0 )
+        {
+            ulDatagrams += ( uint32_t ) lReceived;
+            ulCalls++;
+            ullLastTime = ullTaskGetHighResolutionTime();
+        }
+        else if( ( xSenderDone != pdFALSE ) || ( ++ulWaits >= 10UL ) )
+        {
+            break;
+        }
+    }
+
+    pxResult->ulDatagrams = ulDatagrams;
+    pxResult->ulSent = ubbDATAGRAMS;
+    pxResult->ulCalls = ulCalls;
+    pxResult->ullTimeNs = ullLastTime - ullStartTime;
+    pxResult->ullCpuTimeNs = prvTaskCpuTime() - ullStartCpuTime;
+
+    /* Do not start the next test until the sender has closed its socket. */
+    while( xSenderDone == pdFALSE )
+    {
+        vTaskDelay( ubbIDLE_TIMEOUT );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunTxTest( Socket_t xSocket,
+                          BaseType_t xBatch,
+                          BaseType_t xFlags,
+                          size_t xPayloadLength,
+                          UdpTestResult_t * pxResult )
+{
+    struct freertos_sockaddr xDestination;
+    uint64_t ullStartTime, ullEndTime, ullStartCpuTime, ullCpuTime;
+    uint8_t * pucZeroCopyBuffer;
+    int32_t lSent;
+    uint32_t ulAttempted = 0, ulSent = 0, ulCalls = 0, ulSeen = 0, ulNewlySeen;
+    size_t xMessage, xCount;
+    int iCounter;
+
+    xDestination.sin_addr = ubbPEER_IP_ADDRESS;
+    xDestination.sin_port = FreeRTOS_htons( ubbPEER_PORT );
+
+    taskENTER_CRITICAL();
+    {
+        iCounter = prvOpenPacketSocket( ETH_P_IP );
+    }
+    taskEXIT_CRITICAL();
+
+    configASSERT( iCounter >= 0 );
+    ( void ) prvFramesSeen( iCounter );
+
+    ullStartCpuTime = prvTaskCpuTime();
+    ullStartTime = ullTaskGetHighResolutionTime();
+
+    while( ulAttempted < ubbDATAGRAMS )
+    {
+        if( xBatch == pdFALSE )
+        {
+            xCount = 1U;
+
+            if( ( xFlags & FREERTOS_ZERO_COPY ) != 0 )
+            {
+                pucZeroCopyBuffer = ( uint8_t * ) FreeRTOS_GetUDPPayloadBuffer( xPayloadLength, portMAX_DELAY );
+                configASSERT( pucZeroCopyBuffer != NULL );
+                memcpy( pucZeroCopyBuffer, &ulAttempted, sizeof( ulAttempted ) );
+                lSent = FreeRTOS_sendto( xSocket, pucZeroCopyBuffer, xPayloadLength, FREERTOS_ZERO_COPY, &xDestination, sizeof( xDestination ) );
+
+                if( lSent <= 0 )
+                {
+                    FreeRTOS_ReleaseUDPPayloadBuffer( pucZeroCopyBuffer );
+                }
+            }
+            else
+            {
+                memcpy( ucBuffers[ 0 ], &ulAttempted, sizeof( ulAttempted ) );
+                lSent = FreeRTOS_sendto( xSocket, ucBuffers[ 0 ], xPayloadLength, 0, &xDestination, sizeof( xDestination ) );
+            }
+
+            lSent = ( lSent > 0 ) ? 1 : 0;
+        }
+        else
+        {
+            xCount = ubbBATCH;
+
+            for( xMessage = 0; xMessage < xCount; xMessage++ )
+            {
+                if( ( xFlags & FREERTOS_ZERO_COPY ) != 0 )
+                {
+                    xMessages[ xMessage ].pvBuffer = FreeRTOS_GetUDPPayloadBuffer( xPayloadLength, portMAX_DELAY );
+                    configASSERT( xMessages[ xMessage ].pvBuffer != NULL );
+                }
+                else
+                {
+                    xMessages[ xMessage ].pvBuffer = ucBuffers[ xMessage ];
+                }
+
+                memcpy( xMessages[ xMessage ].pvBuffer, &ulAttempted, sizeof( ulAttempted ) );
+                xMessages[ xMessage ].xLength = xPayloadLength;
+                xMessages[ xMessage ].xAddress = xDestination;
+            }
+
+            lSent = FreeRTOS_sendmmsg( xSocket, xMessages, xCount, xFlags );
+
+            /* Zero copy buffers that were not sent still belong to the
+             * caller. */
+            if( ( xFlags & FREERTOS_ZERO_COPY ) != 0 )
+            {
+                for( xMessage = ( size_t ) lSent; xMessage < xCount; xMessage++ )
+                {
+                    FreeRTOS_ReleaseUDPPayloadBuffer( xMessages[ xMessage ].pvBuffer );
+                }
+            }
+        }
+
+        ulAttempted += ( uint32_t ) xCount;
+        ulSent += ( uint32_t ) lSent;
+        ulCalls++;
+    }
+
+    ullCpuTime = prvClockNs( CLOCK_THREAD_CPUTIME_ID );
+
+    /* Wait for the frames to stop reaching the loopback interface. */
+    do
+    {
+        ullEndTime = ullTaskGetHighResolutionTime();
+        vTaskDelay( ubbIDLE_TIMEOUT );
+        ulNewlySeen = prvFramesSeen( iCounter );
+        ulSeen += ulNewlySeen;
+    } while( ulNewlySeen != 0 );
+
+    taskENTER_CRITICAL();
+    {
+        close( iCounter );
+    }
+    taskEXIT_CRITICAL();
+
+    pxResult->ulDatagrams = ulSeen;
+    pxResult->ulSent = ulSent;
+    pxResult->ulCalls = ulCalls;
+    pxResult->ullTimeNs = ullEndTime - ullStartTime;
+    pxResult->ullCpuTimeNs = ullCpuTime + ullGetIPTaskCpuTime() - ullStartCpuTime;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintResult( const char * pcTest,
+                            BaseType_t xBatch,
+                            BaseType_t xFlags,
+                            size_t xPayloadLength,
+                            const UdpTestResult_t * pxResult )
+{
+    configPRINTF( ( "UDP %s%s%s, %lu byte payload: %lu of %lu datagrams in %lu ms, %lu datagrams per second",
+                    pcTest,
+                    ( xBatch != pdFALSE ) ? " batched" : "",
+                    ( ( xFlags & FREERTOS_ZERO_COPY ) != 0 ) ? " zero copy" : "",
+                    ( unsigned long ) xPayloadLength,
+                    ( unsigned long ) pxResult->ulDatagrams,
+                    ( unsigned long ) pxResult->ulSent,
+                    ( unsigned long ) ( pxResult->ullTimeNs / 1000000ULL ),
+                    ( unsigned long ) ( ( ( uint64_t ) pxResult->ulDatagrams * 1000000000ULL ) / ( pxResult->ullTimeNs + 1ULL ) ) ) );
+
+    if( ( pxResult->ulCalls != 0 ) && ( pxResult->ulDatagrams != 0 ) )
+    {
+        configPRINTF( ( ", %lu datagrams per call, %lu ns of task CPU time per datagram\r\n",
+                        ( unsigned long ) ( pxResult->ulDatagrams / pxResult->ulCalls ),
+                        ( unsigned long ) ( pxResult->ullCpuTimeNs / pxResult->ulDatagrams ) ) );
+    }
+    else
+    {
+        configPRINTF( ( "\r\n" ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vRunUdpBatchBenchmark( void )
+{
+    UdpTestResult_t xResult;
+    struct freertos_sockaddr xBindAddress;
+    const TickType_t xReceiveTimeout = ubbIDLE_TIMEOUT;
+    Socket_t xSocket;
+    BaseType_t xBatch, xFlags;
+    size_t xLength;
+
+    if( FreeRTOS_IsNetworkUp() == pdFALSE )
+    {
+        configPRINTF( ( "UDP batch benchmark skipped, the IP stack is not running\r\n" ) );
+        return;
+    }
+
+    xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+    configASSERT( xSocket != FREERTOS_INVALID_SOCKET );
+    FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_RCVTIMEO, &xReceiveTimeout, sizeof( xReceiveTimeout ) );
+    xBindAddress.sin_port = FreeRTOS_htons( ubbRX_PORT );
+    xBindAddress.sin_addr = 0UL;
+    FreeRTOS_bind( xSocket, &xBindAddress, sizeof( xBindAddress ) );
+
+    for( xLength = 0; xLength < ( sizeof( xPayloadLengths ) / sizeof( xPayloadLengths[ 0 ] ) ); xLength++ )
+    {
+        for( xBatch = pdFALSE; xBatch <= pdTRUE; xBatch++ )
+        {
+            for( xFlags = 0; xFlags <= FREERTOS_ZERO_COPY; xFlags += FREERTOS_ZERO_COPY )
+            {
+                prvRunRxTest( xSocket, xBatch, xFlags, xPayloadLengths[ xLength ], &xResult );
+                prvPrintResult( "receive", xBatch, xFlags, xPayloadLengths[ xLength ], &xResult );
+            }
+        }
+    }
+
+    for( xLength = 0; xLength < ( sizeof( xPayloadLengths ) / sizeof( xPayloadLengths[ 0 ] ) ); xLength++ )
+    {
+        for( xBatch = pdFALSE; xBatch <= pdTRUE; xBatch++ )
+        {
+            for( xFlags = 0; xFlags <= FREERTOS_ZERO_COPY; xFlags += FREERTOS_ZERO_COPY )
+            {
+                prvRunTxTest( xSocket, xBatch, xFlags, xPayloadLengths[ xLength ], &xResult );
+                prvPrintResult( "transmit", xBatch, xFlags, xPayloadLengths[ xLength ], &xResult );
+            }
+        }
+    }
+
+    FreeRTOS_closesocket( xSocket );
+}
+/*-----------------------------------------------------------*/
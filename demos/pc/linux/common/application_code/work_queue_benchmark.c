@@ -0,0 +1,313 @@
+/*
+ * Amazon FreeRTOS V1.4.6
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Compares how long short deferred functions wait to run when a slow deferred
+ * function is already running, first when the functions are pended to the
+ * timer service task with xTimerPendFunctionCall(), then when they are pended
+ * to the system work queue with xWorkQueuePendFunctionCall().  The timer
+ * service task runs one function at a time, so every short function waits for
+ * the slow one to finish.  The work queue runs the short functions on another
+ * worker.  The benchmark then checks delayed, cancelled and resubmitted work
+ * items behave as documented.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "work_queue.h"
+
+/* The number of times a slow function is pended, followed by
+ * wqbFAST_PER_ROUND short functions. */
+#define wqbROUNDS            ( 10U )
+
+/* The number of short functions pended while each slow function runs. */
+#define wqbFAST_PER_ROUND    ( 4U )
+
+/* How long the slow function runs for, in ticks. */
+#define wqbSLOW_TICKS        ( pdMS_TO_TICKS( 20 ) )
+
+/* The delay used by the delayed work item check, in ticks. */
+#define wqbDELAY_TICKS       ( pdMS_TO_TICKS( 50 ) )
+
+/*-----------------------------------------------------------*/
+
+/* Where a test pends its functions. */
+typedef enum
+{
+    eTimerServiceTask,
+    eSystemWorkQueue
+} BenchmarkServer_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Pends wqbROUNDS slow functions, each followed by wqbFAST_PER_ROUND short
+ * functions, and reports how long the short functions waited to run.
+ */
+static void prvRunTest( BenchmarkServer_t eServer );
+
+/*
+ * Pends a function to the server under test, passing the current tick count
+ * as the second parameter.
+ */
+static void prvPend( BenchmarkServer_t eServer,
+                     WorkFunction_t pxFunction );
+
+/*
+ * Runs for wqbSLOW_TICKS without blocking, as a function that performs a long
+ * calculation or polls a slow peripheral would, then notifies the benchmark
+ * task.
+ */
+static void prvSlowFunction( void * pvParameter1,
+                             uint32_t ulParameter2 );
+
+/*
+ * Records how long it waited to run, then notifies the benchmark task.
+ */
+static void prvFastFunction( void * pvParameter1,
+                             uint32_t ulParameter2 );
+
+/*
+ * Checks delayed submission, cancellation and resubmission of work items.
+ */
+static void prvCheckWorkItems( void );
+
+/*
+ * Counts the times it has run and notifies the benchmark task.  Resubmits its
+ * own work item the first time it runs, while it is still running.
+ */
+static void prvCountingFunction( void * pvParameter1,
+                                 uint32_t ulParameter2 );
+
+/*-----------------------------------------------------------*/
+
+/* The task running the benchmark, notified by each pended function. */
+static TaskHandle_t xBenchmarkTask = NULL;
+
+/* The total and longest time the short functions waited to run, in ticks. */
+static uint32_t ulTotalLatency = 0UL;
+static uint32_t ulMaximumLatency = 0UL;
+
+/* The number of times prvCountingFunction() has run, and the tick count when
+ * it last ran. */
+static volatile uint32_t ulRunCount = 0UL;
+static volatile TickType_t xLastRunTime = 0;
+
+/* The work item used by prvCheckWorkItems(). */
+static WorkItem_t xCountingItem;
+
+/*-----------------------------------------------------------*/
+
+static void prvPend( BenchmarkServer_t eServer,
+                     WorkFunction_t pxFunction )
+{
+    BaseType_t xResult;
+
+    if( eServer == eTimerServiceTask )
+    {
+        xResult = xTimerPendFunctionCall( pxFunction, NULL, ( uint32_t ) xTaskGetTickCount(), portMAX_DELAY );
+    }
+    else
+    {
+        xResult = xWorkQueuePendFunctionCall( NULL, pxFunction, NULL, ( uint32_t ) xTaskGetTickCount(), 0, portMAX_DELAY );
+    }
+
+    configASSERT( xResult == pdPASS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunTest( BenchmarkServer_t eServer )
+{
+    uint32_t ulRound, ulFast, ulDone;
+
+    ulTotalLatency = 0UL;
+    ulMaximumLatency = 0UL;
+
+    for( ulRound = 0; ulRound < wqbROUNDS; ulRound++ )
+    {
+        prvPend( eServer, prvSlowFunction );
+
+        /* Let the slow function start before pending the short functions. */
+        vTaskDelay( 1 );
+
+        for( ulFast = 0; ulFast < wqbFAST_PER_ROUND; ulFast++ )
+        {
+            prvPend( eServer, prvFastFunction );
+        }
+
+        for( ulDone = 0; ulDone < ( wqbFAST_PER_ROUND + 1U ); ulDone++ )
+        {
+            ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+        }
+    }
+
+    configPRINTF( ( "%s: short functions waited %lu ms on average, %lu ms at most\r\n",
+                    ( eServer == eTimerServiceTask ) ? "xTimerPendFunctionCall" : "xWorkQueuePendFunctionCall",
+                    ( unsigned long ) ( ( ulTotalLatency * portTICK_PERIOD_MS ) / ( wqbROUNDS * wqbFAST_PER_ROUND ) ),
+                    ( unsigned long ) ( ulMaximumLatency * portTICK_PERIOD_MS ) ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSlowFunction( void * pvParameter1,
+                             uint32_t ulParameter2 )
+{
+    TickType_t xStartTime = xTaskGetTickCount();
+
+    ( void ) pvParameter1;
+    ( void ) ulParameter2;
+
+    while( ( xTaskGetTickCount() - xStartTime ) < wqbSLOW_TICKS )
+    {
+        /* Busy. */
+    }
+
+    xTaskNotifyGive( xBenchmarkTask );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFastFunction( void * pvParameter1,
+                             uint32_t ulParameter2 )
+{
+    uint32_t ulLatency = ( uint32_t ) xTaskGetTickCount() - ulParameter2;
+
+    ( void ) pvParameter1;
+
+    /* The pended functions update the totals one at a time, as a short
+     * function can run on either worker. */
+    taskENTER_CRITICAL();
+    {
+        ulTotalLatency += ulLatency;
+
+        if( ulLatency > ulMaximumLatency )
+        {
+            ulMaximumLatency = ulLatency;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    xTaskNotifyGive( xBenchmarkTask );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCountingFunction( void * pvParameter1,
+                                 uint32_t ulParameter2 )
+{
+    ( void ) pvParameter1;
+    ( void ) ulParameter2;
+
+    xLastRunTime = xTaskGetTickCount();
+    ulRunCount++;
+
+    if( ulRunCount == 1UL )
+    {
+        /* The item is running, so this queues it to run once more when it
+         * finishes, and a second request is refused. */
+        configASSERT( xWorkItemIsBusy( &xCountingItem ) == pdTRUE );
+        configASSERT( xWorkQueueSubmit( NULL, &xCountingItem, 0 ) == pdPASS );
+        configASSERT( xWorkQueueSubmit( NULL, &xCountingItem, 0 ) == pdFAIL );
+    }
+
+    xTaskNotifyGive( xBenchmarkTask );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckWorkItems( void )
+{
+    TickType_t xSubmitTime;
+
+    vWorkItemInit( &xCountingItem, prvCountingFunction, NULL, 0 );
+
+    /* A delayed item runs no earlier than its delay, and cannot be submitted
+     * again until it has run. */
+    xSubmitTime = xTaskGetTickCount();
+    configASSERT( xWorkQueueSubmitDelayed( NULL, &xCountingItem, 1, wqbDELAY_TICKS ) == pdPASS );
+    configASSERT( xWorkQueueSubmit( NULL, &xCountingItem, 1 ) == pdFAIL );
+    configASSERT( xWorkItemIsBusy( &xCountingItem ) == pdTRUE );
+
+    /* The first run resubmits the item, so it runs twice. */
+    ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    configASSERT( ( xLastRunTime - xSubmitTime ) >= wqbDELAY_TICKS );
+    configASSERT( ulRunCount == 2UL );
+
+    /* Wait for the worker to finish with the item before reusing it. */
+    while( xWorkItemIsBusy( &xCountingItem ) == pdTRUE )
+    {
+        vTaskDelay( 1 );
+    }
+
+    /* A cancelled item does not run. */
+    configASSERT( xWorkQueueSubmitDelayed( NULL, &xCountingItem, 1, wqbDELAY_TICKS ) == pdPASS );
+    configASSERT( xWorkItemCancel( &xCountingItem ) == pdPASS );
+    configASSERT( xWorkItemCancel( &xCountingItem ) == pdFAIL );
+    configASSERT( ulTaskNotifyTake( pdFALSE, wqbDELAY_TICKS * 2 ) == 0 );
+    configASSERT( ulRunCount == 2UL );
+    configASSERT( xWorkItemIsBusy( &xCountingItem ) == pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+void vRunWorkQueueBenchmark( void )
+{
+    WorkQueueStats_t xStats;
+    UBaseType_t uxOriginalPriority, uxBucket;
+
+    xBenchmarkTask = xTaskGetCurrentTaskHandle();
+
+    /* Run at the same priority as the timer service task and the workers, so
+     * time slicing lets the benchmark pend the short functions while a slow
+     * function is running, even with a single core. */
+    uxOriginalPriority = uxTaskPriorityGet( NULL );
+    vTaskPrioritySet( NULL, configTIMER_TASK_PRIORITY );
+
+    prvRunTest( eTimerServiceTask );
+
+    vWorkQueueResetStats( NULL );
+    prvRunTest( eSystemWorkQueue );
+
+    vWorkQueueGetStats( NULL, &xStats );
+    configPRINTF( ( "System work queue: %lu submitted, %lu executed, %lu worker wakeups, largest batch %lu, longest wait %lu ticks\r\n",
+                    ( unsigned long ) xStats.uxSubmitted,
+                    ( unsigned long ) xStats.uxExecuted,
+                    ( unsigned long ) xStats.uxWorkerWakeups,
+                    ( unsigned long ) xStats.uxMaximumBatch,
+                    ( unsigned long ) xStats.ulMaximumLatency ) );
+
+    for( uxBucket = 0; uxBucket < configWORK_QUEUE_HISTOGRAM_BUCKETS; uxBucket++ )
+    {
+        if( xStats.uxLatencyHistogram[ uxBucket ] != 0 )
+        {
+            configPRINTF( ( "  waited %lu+ ticks: %lu\r\n",
+                            ( unsigned long ) ( ( uxBucket == 0 ) ? 0UL : ( 1UL << ( uxBucket - 1 ) ) ),
+                            ( unsigned long ) xStats.uxLatencyHistogram[ uxBucket ] ) );
+        }
+    }
+
+    prvCheckWorkItems();
+
+    vTaskPrioritySet( NULL, uxOriginalPriority );
+}
+/*-----------------------------------------------------------*/
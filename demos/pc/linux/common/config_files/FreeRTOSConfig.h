@@ -0,0 +1,185 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/*-----------------------------------------------------------
+* Application specific definitions.
+*
+* These definitions should be adjusted for your particular hardware and
+* application requirements.
+*
+* THESE PARAMETERS ARE DESCRIBED WITHIN THE 'CONFIGURATION' SECTION OF THE
+* FreeRTOS API DOCUMENTATION AVAILABLE ON THE FreeRTOS.org WEB SITE.
+* http://www.freertos.org/a00110.html
+*----------------------------------------------------------*/
+
+/* The number of simulated cores, each of which runs its tasks on a separate
+ * host thread.  Override on the make command line to compare scaling, for
+ * example "make CORES=1". */
+#ifndef configNUM_CORES
+    #define configNUM_CORES                        4
+#endif
+
+#define configENABLE_BACKWARD_COMPATIBILITY        1
+#define configUSE_PREEMPTION                       1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION    0
+#define configMAX_PRIORITIES                       ( 7 )
+#define configTICK_RATE_HZ                         ( 1000 )
+#define configMINIMAL_STACK_SIZE                   ( ( unsigned short ) 60 ) /* In this simulated case, the stack only has to hold one small structure as the real stack is part of the pthread. */
+#define configTOTAL_HEAP_SIZE                      ( ( size_t ) ( 2048U * 1024U ) )
+#define configMAX_TASK_NAME_LEN                    ( 15 )
+#define configUSE_TRACE_FACILITY                   1
+#define configUSE_16_BIT_TICKS                     0
+#define configIDLE_SHOULD_YIELD                    1
+#define configUSE_CO_ROUTINES                      0
+#define configUSE_MUTEXES                          1
+#define configUSE_RECURSIVE_MUTEXES                1
+#define configQUEUE_REGISTRY_SIZE                  0
+#define configUSE_APPLICATION_TASK_TAG             0
+#define configUSE_COUNTING_SEMAPHORES              1
+#define configUSE_ALTERNATIVE_API                  0
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS    3
+#define configUSE_CORE_AFFINITY                    ( configNUM_CORES > 1 )
+
+/* Hook function related definitions. */
+#define configUSE_TICK_HOOK                        0
+#define configUSE_IDLE_HOOK                        0
+#define configUSE_MALLOC_FAILED_HOOK               1
+#define configCHECK_FOR_STACK_OVERFLOW             0      /* Not applicable to the POSIX port. */
+
+/* Software timer related definitions. */
+#define configUSE_TIMERS                           1
+#define configTIMER_TASK_PRIORITY                  ( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH                   5
+#define configTIMER_TASK_STACK_DEPTH               ( configMINIMAL_STACK_SIZE * 2 )
+
+/* Work queue related definitions.  xTimerPendFunctionCall() is left on the
+ * timer service task so the benchmark can compare the two. */
+#define configUSE_WORK_QUEUES                      1
+#define configSYSTEM_WORK_QUEUE_WORKERS            2
+#define configSYSTEM_WORK_QUEUE_PRIORITY           ( configMAX_PRIORITIES - 1 )
+#define configSYSTEM_WORK_QUEUE_STACK_DEPTH        ( configMINIMAL_STACK_SIZE * 2 )
+#define configPEND_FUNCTION_CALL_USE_WORK_QUEUE    0
+
+/* Async engine related definitions.  The engine waits for events with a queue
+ * set. */
+#define configUSE_ASYNC_ENGINE                     1
+#define configUSE_QUEUE_SETS                       1
+
+/* Trace ring related definitions.  Build with "make TRACE=1" to record kernel
+ * events, which are saved to kernel_trace.bin when the demo ends. */
+#ifndef configUSE_TRACE_RING
+    #define configUSE_TRACE_RING                   0
+#endif
+#define configTRACE_RING_EVENTS                    8192
+#define configTRACE_RING_TIMESTAMP_HZ              1000000000UL
+extern uint32_t ulGetTraceTimestamp( void );
+#define configTRACE_RING_TIMESTAMP()               ulGetTraceTimestamp()
+
+/* Heap profiler related definitions.  Build with "make HEAPPROF=1" to record
+ * every block allocated from the heap. */
+#ifndef configUSE_HEAP_PROFILER
+    #define configUSE_HEAP_PROFILER                0
+#endif
+#define configHEAP_PROFILER_ALLOCATIONS            1024
+
+/* Event group related definitions. */
+#define configUSE_EVENT_GROUPS                     1
+
+/* The host interface used by the Linux network interface.  The benchmark runs
+ * it over the loopback interface, and skips it if it cannot open a packet
+ * socket, which needs the CAP_NET_RAW capability. */
+#define configNETWORK_INTERFACE_NAME               "lo"
+#define configMAC_ISR_SIMULATOR_PRIORITY           ( configMAX_PRIORITIES - 1 )
+
+/* The simulated network interface's MAC address, which is locally
+ * administered, and the IP stack's static address.  Nothing on the loopback
+ * interface answers for the gateway or DNS server. */
+#define configMAC_ADDR0                            0x02
+#define configMAC_ADDR1                            0x11
+#define configMAC_ADDR2                            0x22
+#define configMAC_ADDR3                            0x33
+#define configMAC_ADDR4                            0x44
+#define configMAC_ADDR5                            0x21
+
+#define configIP_ADDR0                             10
+#define configIP_ADDR1                             10
+#define configIP_ADDR2                             0
+#define configIP_ADDR3                             2
+
+#define configNET_MASK0                            255
+#define configNET_MASK1                            255
+#define configNET_MASK2                            255
+#define configNET_MASK3                            0
+
+#define configGATEWAY_ADDR0                        10
+#define configGATEWAY_ADDR1                        10
+#define configGATEWAY_ADDR2                        0
+#define configGATEWAY_ADDR3                        1
+
+#define configDNS_SERVER_ADDR0                     10
+#define configDNS_SERVER_ADDR1                     10
+#define configDNS_SERVER_ADDR2                     0
+#define configDNS_SERVER_ADDR3                     1
+
+/* Both allocation schemes are supported.  The idle tasks use static
+ * allocation. */
+#define configSUPPORT_DYNAMIC_ALLOCATION           1
+#define configSUPPORT_STATIC_ALLOCATION            1
+
+/* Set the following definitions to 1 to include the API function, or zero
+ * to exclude the API function. */
+#define INCLUDE_vTaskPrioritySet                   1
+#define INCLUDE_uxTaskPriorityGet                  1
+#define INCLUDE_vTaskDelete                        1
+#define INCLUDE_vTaskCleanUpResources              0
+#define INCLUDE_vTaskSuspend                       1
+#define INCLUDE_vTaskDelayUntil                    1
+#define INCLUDE_vTaskDelay                         1
+#define INCLUDE_uxTaskGetStackHighWaterMark        1
+#define INCLUDE_xTaskGetSchedulerState             1
+#define INCLUDE_xTimerGetTimerTaskHandle           0
+#define INCLUDE_xTaskGetIdleTaskHandle             1
+#define INCLUDE_xQueueGetMutexHolder               1
+#define INCLUDE_eTaskGetState                      1
+#define INCLUDE_xEventGroupSetBitsFromISR          1
+#define INCLUDE_xTimerPendFunctionCall             1
+#define INCLUDE_xTaskGetCurrentTaskHandle          1
+#define INCLUDE_xTaskAbortDelay                    1
+
+/* Assert call defined for debug builds. */
+extern void vAssertCalled( const char * pcFile,
+                           uint32_t ulLine );
+#define configASSERT( x )    if( ( x ) == 0 ) vAssertCalled( __FILE__, __LINE__ )
+
+/* The function that implements FreeRTOS printf style output, and the macro
+ * that maps the configPRINTF() macros to that function. */
+extern void vLoggingPrintf( const char * pcFormat,
+                            ... );
+#define configPRINTF( X )    vLoggingPrintf X
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,131 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/*****************************************************************************
+*
+* See the following URL for configuration information.
+* http://www.freertos.org/FreeRTOS-Plus/FreeRTOS_Plus_TCP/TCP_IP_Configuration.html
+*
+*****************************************************************************/
+
+#ifndef FREERTOS_IP_CONFIG_H
+#define FREERTOS_IP_CONFIG_H
+
+/* The POSIX simulator demo builds the TCP/IP stack over the Linux network
+ * interface, with a static address and without DHCP or DNS, for its network
+ * benchmarks. */
+
+#define ipconfigHAS_DEBUG_PRINTF    0
+
+#define ipconfigHAS_PRINTF          1
+#if ( ipconfigHAS_PRINTF == 1 )
+    #define FreeRTOS_printf( X )    configPRINTF( X )
+#endif
+
+#define ipconfigBYTE_ORDER                            pdFREERTOS_LITTLE_ENDIAN
+
+/* The host interface has a 1500 byte MTU. */
+#define ipconfigNETWORK_MTU                           1500
+
+/* Enough buffers to hold a full receive ring's worth of small frames while the
+ * IP task catches up. */
+#define ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS        512
+#define ipconfigEVENT_QUEUE_LENGTH                    ( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS + 5 )
+
+/* The network interface passes the frames it receives together to the IP task,
+ * chained through pxNextBuffer, and FreeRTOS_sendmmsg() passes the datagrams it
+ * sends in the same way. */
+#define ipconfigUSE_LINKED_RX_MESSAGES                1
+
+/* The network interface masks its receive interrupt and is polled by the IP
+ * task while frames keep arriving. */
+#define ipconfigUSE_NETWORK_POLL                      1
+
+/* The IP task runs below the network interface's host side.  In this simulated
+ * case the stack only has to hold one small structure, as for the other
+ * tasks. */
+#define ipconfigIP_TASK_PRIORITY                      ( configMAX_PRIORITIES - 2 )
+#define ipconfigIP_TASK_STACK_SIZE_WORDS              ( configMINIMAL_STACK_SIZE * 5 )
+
+/* rand() takes a C library lock, so cannot be called by the tasks of the POSIX
+ * port. */
+extern uint32_t ulRand( void );
+#define ipconfigRAND32()                              ulRand()
+
+/* The address set by FreeRTOSConfig.h is used, and is not resolved. */
+#define ipconfigUSE_TCP                               1
+#define ipconfigUSE_DHCP                              0
+#define ipconfigUSE_DNS                               0
+#define ipconfigARP_CACHE_ENTRIES                     6
+#define ipconfigUDP_TIME_TO_LIVE                      128
+
+/* Listening sockets answer SYNs from a table of half-open connections, and with
+ * SYN cookies once it is full, so that the TCP SYN benchmark's flood does not
+ * take a socket per SYN. */
+#define ipconfigTCP_SYN_TABLE                         1
+#define ipconfigTCP_SYN_COOKIES                       1
+
+/* Connections closed by the demo are remembered in a small table, rather than
+ * by their sockets, for as long as the peer might repeat its FIN. */
+#define ipconfigTCP_TIME_WAIT_TABLE                   1
+
+/* The benchmarks count the datagrams they receive with a receive handler. */
+#define ipconfigUSE_CALLBACKS                         1
+
+/* The host does not check or fill in the checksums of frames sent over the
+ * loopback interface, so the stack does.  The datagrams the benchmarks send
+ * carry no UDP checksum, which the stack accepts. */
+#define ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM        0
+#define ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM        0
+
+/* The network interface has the host drop frames that are not addressed to it,
+ * and passes the stack only the frames it considers need processing. */
+#define ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES   1
+#define ipconfigFILTER_OUT_NON_ETHERNET_II_FRAMES     1
+
+/* The network interface benchmark counts the events the IP task processes,
+ * and runs its transmit tests in the IP task.  The trace ring, when built,
+ * still records the events. */
+extern void vNetworkBenchmarkIPEvent( int iEventType );
+#if ( configUSE_TRACE_RING == 1 )
+    #undef iptraceNETWORK_EVENT_RECEIVED
+    #define iptraceNETWORK_EVENT_RECEIVED( eEvent )                                              \
+    do {                                                                                         \
+        vTraceRingEvent( trEVENT_IP, trIP_NETWORK_EVENT_RECEIVED, ( uint32_t ) ( eEvent ) ); \
+        vNetworkBenchmarkIPEvent( ( int ) ( eEvent ) );                                          \
+    } while( 0 )
+#else
+    #define iptraceNETWORK_EVENT_RECEIVED( eEvent )    vNetworkBenchmarkIPEvent( ( int ) ( eEvent ) )
+#endif
+
+/* The benchmarks measure the CPU time the IP task uses through the CPU clock of
+ * its host thread. */
+extern void vRecordIPTaskClock( void );
+#define iptraceIP_TASK_STARTING()                     vRecordIPTaskClock()
+
+#define ipconfigPACKET_FILLER_SIZE                    2
+
+#endif /* FREERTOS_IP_CONFIG_H */
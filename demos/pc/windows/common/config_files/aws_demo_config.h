@@ -63,6 +63,12 @@
 #define democonfigTCP_ECHO_TASKS_SEPARATE_TASK_STACK_SIZE    ( configMINIMAL_STACK_SIZE * 4 )
 #define democonfigTCP_ECHO_TASKS_SEPARATE_TASK_PRIORITY      ( tskIDLE_PRIORITY )
 
+/* TCP/TLS benchmark task parameters.  The run time stats counter set up in
+ * aws_run-time-stats-utils.c counts in 1/100ths of a millisecond. */
+#define democonfigTCP_BENCHMARK_TASK_STACK_SIZE              ( configMINIMAL_STACK_SIZE * 8 )
+#define democonfigTCP_BENCHMARK_TASK_PRIORITY                ( tskIDLE_PRIORITY + 1 )
+#define democonfigTCP_BENCHMARK_RUN_TIME_HZ                  ( 100000UL )
+
 /* MQTT echo task example parameters. */
 #define democonfigMQTT_ECHO_TASK_STACK_SIZE                  ( configMINIMAL_STACK_SIZE * 2 )
 #define democonfigMQTT_ECHO_TASK_PRIORITY                    ( tskIDLE_PRIORITY )
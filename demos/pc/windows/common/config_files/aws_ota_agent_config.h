@@ -71,4 +71,9 @@
  */
 #define otaconfigMAX_THINGNAME_LEN              64U
 
+/**
+ * @brief Download the file over HTTPS when the job gives an update data URL.
+ */
+#define otaconfigENABLE_HTTP_DATA_PLANE         1
+
 #endif /* _AWS_OTA_AGENT_CONFIG_H_ */
@@ -122,4 +122,27 @@
     } pthread_barrier_internal_t;
 #endif
 
+#if posixconfigENABLE_PTHREAD_RWLOCK_T == 1
+    /**
+     * @brief Read-write lock.
+     */
+    typedef struct pthread_rwlock_internal
+    {
+        BaseType_t xIsInitialized; /**< Set to pdTRUE if this read-write lock is initialized, pdFALSE otherwise. */
+        StaticRwLock_t xRwLock;    /**< FreeRTOS reader-writer lock. */
+    } pthread_rwlock_internal_t;
+
+    /**
+     * @brief Compile-time initializer of pthread_rwlock_internal_t.
+     */
+    #define FREERTOS_POSIX_RWLOCK_INITIALIZER \
+        ( ( ( pthread_rwlock_internal_t )     \
+        {                                     \
+            .xIsInitialized = pdFALSE,        \
+            .xRwLock = { 0 }                  \
+        }                                     \
+          )                                   \
+        )
+#endif
+
 #endif /* _FREERTOS_POSIX_INTERNAL_H_ */
@@ -76,4 +76,10 @@
     typedef void    * PthreadBarrierType_t;
 #endif
 
+#if posixconfigENABLE_PTHREAD_RWLOCK_T == 1
+    typedef pthread_rwlock_internal_t PthreadRwlockType_t;
+#else
+    typedef void    * PthreadRwlockType_t;
+#endif
+
 #endif /* _FREERTOS_POSIX_INTERNAL_TYPES_H_ */
@@ -45,6 +45,17 @@
     #define posixconfigTIMER_NAME    "timer"
 #endif
 
+/**
+ * @brief Set to 1 for nanosleep and clock_nanosleep to wake between ticks.
+ *
+ * They block for whole ticks and then busy wait for up to about one tick
+ * period, see vTaskDelayUntilHighResolutionTime(). When 0 they sleep for whole
+ * ticks only.
+ */
+#ifndef posixconfigENABLE_HIGH_RESOLUTION_SLEEP
+    #define posixconfigENABLE_HIGH_RESOLUTION_SLEEP    0
+#endif
+
 /**
  * @defgroup Defaults for POSIX message queue implementation.
  */
@@ -139,6 +150,9 @@
 #ifndef posixconfigENABLE_PTHREAD_BARRIER_T
     #define posixconfigENABLE_PTHREAD_BARRIER_T      1 /**< pthread_barrier_t in sys/types.h */
 #endif
+#ifndef posixconfigENABLE_PTHREAD_RWLOCK_T
+    #define posixconfigENABLE_PTHREAD_RWLOCK_T       1 /**< pthread_rwlock_t in sys/types.h */
+#endif
 /**@} */
 
 #endif /* ifndef _FREERTOS_POSIX_PORTABLE_DEFAULT_H_ */
@@ -45,8 +45,74 @@ extern int snprintf( char * s,
                      const char * format,
                      ... );
 
+#if ( posixconfigENABLE_HIGH_RESOLUTION_SLEEP == 1 )
+
+/**
+ * @brief Convert a valid timespec to nanoseconds, treating times before 0 as 0.
+ *
+ * @param[in] pxTimespec The timespec to convert.
+ *
+ * @return The time in nanoseconds, saturated at UINT64_MAX.
+ */
+    static uint64_t prvTimespecToNanoseconds( const struct timespec * const pxTimespec );
+
+/**
+ * @brief Add two times in nanoseconds, saturating at UINT64_MAX.
+ *
+ * @param[in] ullTime The first time.
+ * @param[in] ullIncrement The second time.
+ *
+ * @return The sum.
+ */
+    static uint64_t prvAddNanoseconds( uint64_t ullTime,
+                                       uint64_t ullIncrement );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+#if ( posixconfigENABLE_HIGH_RESOLUTION_SLEEP == 1 )
+
+    static uint64_t prvTimespecToNanoseconds( const struct timespec * const pxTimespec )
+    {
+        uint64_t ullNanoseconds = 0ULL;
+
+        if( pxTimespec->tv_sec >= 0 )
+        {
+            if( ( uint64_t ) pxTimespec->tv_sec < ( UINT64_MAX / ( uint64_t ) NANOSECONDS_PER_SECOND ) )
+            {
+                ullNanoseconds = ( ( uint64_t ) pxTimespec->tv_sec * ( uint64_t ) NANOSECONDS_PER_SECOND ) +
+                                 ( uint64_t ) pxTimespec->tv_nsec;
+            }
+            else
+            {
+                ullNanoseconds = UINT64_MAX;
+            }
+        }
+
+        return ullNanoseconds;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static uint64_t prvAddNanoseconds( uint64_t ullTime,
+                                       uint64_t ullIncrement )
+    {
+        uint64_t ullSum = ullTime + ullIncrement;
+
+        /* Unsigned addition wraps, so a sum less than either input overflowed. */
+        if( ullSum < ullTime )
+        {
+            ullSum = UINT64_MAX;
+        }
+
+        return ullSum;
+    }
+
 /*-----------------------------------------------------------*/
 
+#endif /* if ( posixconfigENABLE_HIGH_RESOLUTION_SLEEP == 1 ) */
+
 clock_t clock( void )
 {
     /* This function is currently unsupported. It will always return -1. */
@@ -78,11 +144,13 @@ int clock_getres( clockid_t clock_id,
     /* Silence warnings about unused parameters. */
     ( void ) clock_id;
 
-    /* Convert FreeRTOS tick resolution as timespec. */
+    /* The clock has the resolution of the port's high resolution count, or of
+     * the tick if the port does not have one. Round up to a whole nanosecond. */
     if( res != NULL )
     {
         res->tv_sec = 0;
-        res->tv_nsec = NANOSECONDS_PER_TICK;
+        res->tv_nsec = ( long ) ( ( NANOSECONDS_PER_SECOND + ( long long ) portHIGH_RESOLUTION_COUNT_HZ - 1LL ) /
+                                  ( long long ) portHIGH_RESOLUTION_COUNT_HZ );
     }
 
     return 0;
@@ -93,14 +161,8 @@ int clock_getres( clockid_t clock_id,
 int clock_gettime( clockid_t clock_id,
                    struct timespec * tp )
 {
-    TimeOut_t xCurrentTime = { 0 };
     int iStatus = 0;
 
-    /* Intermediate variable used to convert TimeOut_t to struct timespec.
-     * Also used to detect overflow issues. It must be unsigned because the
-     * behavior of signed integer overflow is undefined. */
-    uint64_t ullTickCount = 0ULL;
-
     /* Silence warnings about unused parameters. */
     ( void ) clock_id;
 
@@ -114,19 +176,10 @@ int clock_gettime( clockid_t clock_id,
 
     if( iStatus == 0 )
     {
-        /* Get the current tick count and overflow count. vTaskSetTimeOutState()
-         * is used to get these values because they are both static in tasks.c. */
-        vTaskSetTimeOutState( &xCurrentTime );
-
-        /* Adjust the tick count for the number of times a TickType_t has overflowed.
-         * portMAX_DELAY should be the maximum value of a TickType_t. */
-        ullTickCount = ( uint64_t ) ( xCurrentTime.xOverflowCount ) << ( sizeof( TickType_t ) * 8 );
-
-        /* Add the current tick count. */
-        ullTickCount += xCurrentTime.xTimeOnEntering;
-
-        /* Convert ullTickCount to timespec. */
-        UTILS_NanosecondsToTimespec( ( int64_t ) ullTickCount * NANOSECONDS_PER_TICK, tp );
+        /* Both clocks read the kernel's high resolution time, which combines
+         * the tick with the port's high resolution count. It is read without a
+         * critical section. */
+        UTILS_NanosecondsToTimespec( ( int64_t ) ullTaskGetHighResolutionTime(), tp );
     }
 
     return iStatus;
@@ -140,8 +193,13 @@ int clock_nanosleep( clockid_t clock_id,
                      struct timespec * rmtp )
 {
     int iStatus = 0;
-    TickType_t xSleepTime = 0;
-    struct timespec xCurrentTime = { 0 };
+
+    #if ( posixconfigENABLE_HIGH_RESOLUTION_SLEEP == 1 )
+        uint64_t ullWakeTime = 0ULL;
+    #else
+        TickType_t xSleepTime = 0;
+        struct timespec xCurrentTime = { 0 };
+    #endif
 
     /* Silence warnings about unused parameters. */
     ( void ) clock_id;
@@ -154,6 +212,22 @@ int clock_nanosleep( clockid_t clock_id,
         iStatus = EINVAL;
     }
 
+    #if ( posixconfigENABLE_HIGH_RESOLUTION_SLEEP == 1 )
+        if( iStatus == 0 )
+        {
+            /* Sleep until the wake time on the clock clock_gettime reads. A
+             * relative sleep starts now. */
+            ullWakeTime = prvTimespecToNanoseconds( rqtp );
+
+            if( ( flags & TIMER_ABSTIME ) != TIMER_ABSTIME )
+            {
+                ullWakeTime = prvAddNanoseconds( ullTaskGetHighResolutionTime(), ullWakeTime );
+            }
+
+            vTaskDelayUntilHighResolutionTime( ullWakeTime );
+        }
+    #else /* if ( posixconfigENABLE_HIGH_RESOLUTION_SLEEP == 1 ) */
+
     /* Get current time */
     if( ( iStatus == 0 ) && ( clock_gettime( CLOCK_REALTIME, &xCurrentTime ) != 0 ) )
     {
@@ -201,6 +275,7 @@ int clock_nanosleep( clockid_t clock_id,
             }
         }
     }
+    #endif /* if ( posixconfigENABLE_HIGH_RESOLUTION_SLEEP == 1 ) */
 
     return iStatus;
 }
@@ -253,7 +328,10 @@ int nanosleep( const struct timespec * rqtp,
                struct timespec * rmtp )
 {
     int iStatus = 0;
-    TickType_t xSleepTime = 0;
+
+    #if ( posixconfigENABLE_HIGH_RESOLUTION_SLEEP == 0 )
+        TickType_t xSleepTime = 0;
+    #endif
 
     /* Silence warnings about unused parameters. */
     ( void ) rmtp;
@@ -267,11 +345,17 @@ int nanosleep( const struct timespec * rqtp,
 
     if( iStatus == 0 )
     {
-        /* Convert rqtp to ticks and delay. */
-        if( UTILS_TimespecToTicks( rqtp, &xSleepTime ) == 0 )
-        {
-            vTaskDelay( xSleepTime );
-        }
+        #if ( posixconfigENABLE_HIGH_RESOLUTION_SLEEP == 1 )
+            /* Sleep until rqtp from now on the high resolution clock. */
+            vTaskDelayUntilHighResolutionTime( prvAddNanoseconds( ullTaskGetHighResolutionTime(),
+                                                                  prvTimespecToNanoseconds( rqtp ) ) );
+        #else
+            /* Convert rqtp to ticks and delay. */
+            if( UTILS_TimespecToTicks( rqtp, &xSleepTime ) == 0 )
+            {
+                vTaskDelay( xSleepTime );
+            }
+        #endif
     }
 
     return iStatus;
@@ -306,8 +390,8 @@ size_t strftime( char * s,
 
 time_t time( time_t * tloc )
 {
-    /* Read the current FreeRTOS tick count and convert it to seconds. */
-    time_t xCurrentTime = ( time_t ) ( xTaskGetTickCount() / configTICK_RATE_HZ );
+    /* Read the clock clock_gettime reads and convert it to seconds. */
+    time_t xCurrentTime = ( time_t ) ( ullTaskGetHighResolutionTime() / ( uint64_t ) NANOSECONDS_PER_SECOND );
 
     /* Set the output parameter if provided. */
     if( tloc != NULL )
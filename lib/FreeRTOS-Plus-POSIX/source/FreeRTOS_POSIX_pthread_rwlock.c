@@ -0,0 +1,329 @@
+/*
+ * Amazon FreeRTOS+POSIX V1.0.2
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_POSIX_pthread_rwlock.c
+ * @brief Implementation of read-write lock functions in pthread.h
+ */
+
+/* C standard library includes. */
+#include <stddef.h>
+
+/* FreeRTOS+POSIX includes. */
+#include "FreeRTOS_POSIX.h"
+#include "FreeRTOS_POSIX/errno.h"
+#include "FreeRTOS_POSIX/pthread.h"
+#include "FreeRTOS_POSIX/utils.h"
+
+/* FreeRTOS includes. */
+#include "rw_lock.h"
+
+/**
+ * @brief Initialize a PTHREAD_RWLOCK_INITIALIZER read-write lock.
+ *
+ * PTHREAD_RWLOCK_INITIALIZER sets a flag for a read-write lock to be
+ * initialized later. This function performs the initialization.
+ * @param[in] pxRwlock The read-write lock to initialize.
+ *
+ * @return nothing
+ */
+static void prvInitializeStaticRwlock( pthread_rwlock_internal_t * pxRwlock );
+
+/**
+ * @brief Lock a read-write lock for reading or writing.
+ *
+ * @param[in] pxRwlock The read-write lock to lock.
+ * @param[in] abstime The time at which to stop waiting, or NULL to wait forever.
+ * @param[in] xIsWriter pdTRUE to lock for writing, pdFALSE to lock for reading.
+ *
+ * @return 0 on success, ETIMEDOUT if abstime passed before the lock could be
+ * taken, or EINVAL or EDEADLK.
+ */
+static int prvTimedLock( pthread_rwlock_internal_t * pxRwlock,
+                         const struct timespec * abstime,
+                         BaseType_t xIsWriter );
+
+/*-----------------------------------------------------------*/
+
+static void prvInitializeStaticRwlock( pthread_rwlock_internal_t * pxRwlock )
+{
+    /* Check if the read-write lock needs to be initialized. */
+    if( pxRwlock->xIsInitialized == pdFALSE )
+    {
+        /* Initialization must be in a critical section to prevent two threads
+         * from initializing it at the same time. */
+        taskENTER_CRITICAL();
+
+        /* Check again that the lock is still uninitialized, i.e. it wasn't
+         * initialized while this function was waiting to enter the critical
+         * section. */
+        if( pxRwlock->xIsInitialized == pdFALSE )
+        {
+            /* The lock is created in memory inside the object, so this cannot
+             * fail. */
+            ( void ) xRwLockCreateStatic( &pxRwlock->xRwLock );
+            pxRwlock->xIsInitialized = pdTRUE;
+        }
+
+        /* Exit the critical section. */
+        taskEXIT_CRITICAL();
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static int prvTimedLock( pthread_rwlock_internal_t * pxRwlock,
+                         const struct timespec * abstime,
+                         BaseType_t xIsWriter )
+{
+    int iStatus = 0;
+    RwLockHandle_t xRwLock = ( RwLockHandle_t ) &pxRwlock->xRwLock;
+    TickType_t xDelay = portMAX_DELAY;
+    BaseType_t xLockStatus = pdFALSE;
+
+    /* If the lock is uninitialized, perform initialization. */
+    prvInitializeStaticRwlock( pxRwlock );
+
+    /* Convert abstime to a delay in TickType_t if provided. */
+    if( abstime != NULL )
+    {
+        struct timespec xCurrentTime = { 0 };
+
+        /* Get current time */
+        if( clock_gettime( CLOCK_REALTIME, &xCurrentTime ) != 0 )
+        {
+            iStatus = EINVAL;
+        }
+        else
+        {
+            iStatus = UTILS_AbsoluteTimespecToDeltaTicks( abstime, &xCurrentTime, &xDelay );
+        }
+
+        /* If abstime was in the past, still attempt to take the lock without
+         * blocking, per POSIX spec. */
+        if( iStatus == ETIMEDOUT )
+        {
+            xDelay = 0;
+            iStatus = 0;
+        }
+    }
+
+    /* A thread that holds the write lock would wait for itself. */
+    if( ( iStatus == 0 ) && ( xRwLockGetWriter( xRwLock ) == xTaskGetCurrentTaskHandle() ) )
+    {
+        iStatus = EDEADLK;
+    }
+
+    if( iStatus == 0 )
+    {
+        if( xIsWriter == pdTRUE )
+        {
+            xLockStatus = xRwLockWriteLock( xRwLock, xDelay );
+        }
+        else
+        {
+            xLockStatus = xRwLockReadLock( xRwLock, xDelay );
+        }
+
+        if( xLockStatus != pdPASS )
+        {
+            iStatus = ETIMEDOUT;
+        }
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_destroy( pthread_rwlock_t * rwlock )
+{
+    int iStatus = 0;
+    pthread_rwlock_internal_t * pxRwlock = ( pthread_rwlock_internal_t * ) ( rwlock );
+    RwLockStats_t xStats;
+
+    /* A lock that was never used by a PTHREAD_RWLOCK_INITIALIZER object has
+     * nothing to free. */
+    if( pxRwlock->xIsInitialized == pdTRUE )
+    {
+        vRwLockGetStats( ( RwLockHandle_t ) &pxRwlock->xRwLock, &xStats );
+
+        /* Cannot destroy a lock that is held or being waited for. */
+        if( ( xStats.xWriter != NULL ) ||
+            ( xStats.uxReaders != 0 ) ||
+            ( xStats.uxWaitingReaders != 0 ) ||
+            ( xStats.uxWaitingWriters != 0 ) )
+        {
+            iStatus = EBUSY;
+        }
+        else
+        {
+            vRwLockDelete( ( RwLockHandle_t ) &pxRwlock->xRwLock );
+            pxRwlock->xIsInitialized = pdFALSE;
+        }
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_init( pthread_rwlock_t * rwlock,
+                         const pthread_rwlockattr_t * attr )
+{
+    int iStatus = 0;
+    pthread_rwlock_internal_t * pxRwlock = ( pthread_rwlock_internal_t * ) ( rwlock );
+
+    /* Silence warnings about unused parameters. */
+    ( void ) attr;
+
+    if( pxRwlock == NULL )
+    {
+        iStatus = EINVAL;
+    }
+
+    if( iStatus == 0 )
+    {
+        *pxRwlock = FREERTOS_POSIX_RWLOCK_INITIALIZER;
+
+        /* The lock is created in memory inside the object, so this cannot
+         * fail. */
+        ( void ) xRwLockCreateStatic( &pxRwlock->xRwLock );
+        pxRwlock->xIsInitialized = pdTRUE;
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_rdlock( pthread_rwlock_t * rwlock )
+{
+    return prvTimedLock( ( pthread_rwlock_internal_t * ) ( rwlock ), NULL, pdFALSE );
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_timedrdlock( pthread_rwlock_t * rwlock,
+                                const struct timespec * abstime )
+{
+    return prvTimedLock( ( pthread_rwlock_internal_t * ) ( rwlock ), abstime, pdFALSE );
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_timedwrlock( pthread_rwlock_t * rwlock,
+                                const struct timespec * abstime )
+{
+    return prvTimedLock( ( pthread_rwlock_internal_t * ) ( rwlock ), abstime, pdTRUE );
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_tryrdlock( pthread_rwlock_t * rwlock )
+{
+    int iStatus = 0;
+    pthread_rwlock_internal_t * pxRwlock = ( pthread_rwlock_internal_t * ) ( rwlock );
+
+    /* If the lock is uninitialized, perform initialization. */
+    prvInitializeStaticRwlock( pxRwlock );
+
+    if( xRwLockReadLock( ( RwLockHandle_t ) &pxRwlock->xRwLock, 0 ) != pdPASS )
+    {
+        iStatus = EBUSY;
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_trywrlock( pthread_rwlock_t * rwlock )
+{
+    int iStatus = 0;
+    pthread_rwlock_internal_t * pxRwlock = ( pthread_rwlock_internal_t * ) ( rwlock );
+
+    /* If the lock is uninitialized, perform initialization. */
+    prvInitializeStaticRwlock( pxRwlock );
+
+    /* Only a thread that does not hold the write lock can try to take it;
+     * xRwLockWriteLock() asserts otherwise. */
+    if( xRwLockGetWriter( ( RwLockHandle_t ) &pxRwlock->xRwLock ) == xTaskGetCurrentTaskHandle() )
+    {
+        iStatus = EBUSY;
+    }
+    else if( xRwLockWriteLock( ( RwLockHandle_t ) &pxRwlock->xRwLock, 0 ) != pdPASS )
+    {
+        iStatus = EBUSY;
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_unlock( pthread_rwlock_t * rwlock )
+{
+    int iStatus = 0;
+    pthread_rwlock_internal_t * pxRwlock = ( pthread_rwlock_internal_t * ) ( rwlock );
+    RwLockHandle_t xRwLock = ( RwLockHandle_t ) &pxRwlock->xRwLock;
+    RwLockStats_t xStats;
+
+    /* If the lock is uninitialized, perform initialization. */
+    prvInitializeStaticRwlock( pxRwlock );
+
+    /* The writer can only change to or from the calling thread if the calling
+     * thread takes or releases the lock, so it can be tested without holding
+     * the lock. */
+    if( xRwLockGetWriter( xRwLock ) == xTaskGetCurrentTaskHandle() )
+    {
+        vRwLockWriteUnlock( xRwLock );
+    }
+    else
+    {
+        /* Otherwise the calling thread must hold a read lock. */
+        vRwLockGetStats( xRwLock, &xStats );
+
+        if( xStats.uxReaders == 0 )
+        {
+            iStatus = EPERM;
+        }
+        else
+        {
+            vRwLockReadUnlock( xRwLock );
+        }
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_wrlock( pthread_rwlock_t * rwlock )
+{
+    return prvTimedLock( ( pthread_rwlock_internal_t * ) ( rwlock ), NULL, pdTRUE );
+}
+
+/*-----------------------------------------------------------*/
@@ -301,6 +301,42 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#define ipconfigEVENT_QUEUE_LENGTH		( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS + 5 )
 #endif
 
+/* When ipconfigUSE_NETWORK_POLL is set to 1, a network interface can mask its
+receive interrupt and have the IP task poll it for frames instead, in the way
+NAPI works in Linux.  The IP task takes at most ipconfigNETWORK_POLL_BUDGET
+frames in each poll before it handles its other events, and the interface
+unmasks its interrupt once a poll finds fewer frames than that. */
+#ifndef ipconfigUSE_NETWORK_POLL
+	#define ipconfigUSE_NETWORK_POLL			0
+#endif
+
+#ifndef ipconfigNETWORK_POLL_BUDGET
+	#define ipconfigNETWORK_POLL_BUDGET			64
+#endif
+
+/* The interface is asked to delay its receive interrupt by a coalescing time
+that adapts to the traffic.  The time is doubled, from
+ipconfigNETWORK_POLL_COALESCE_MIN_US up to ipconfigNETWORK_POLL_COALESCE_MAX_US,
+each time the polls started by one interrupt take at least
+ipconfigNETWORK_POLL_COALESCE_HIGH frames, and halved, down to zero, each time
+they take no more than ipconfigNETWORK_POLL_COALESCE_LOW frames.  Busy
+interfaces are therefore interrupted less often, and quiet ones immediately. */
+#ifndef ipconfigNETWORK_POLL_COALESCE_MIN_US
+	#define ipconfigNETWORK_POLL_COALESCE_MIN_US	25
+#endif
+
+#ifndef ipconfigNETWORK_POLL_COALESCE_MAX_US
+	#define ipconfigNETWORK_POLL_COALESCE_MAX_US	250
+#endif
+
+#ifndef ipconfigNETWORK_POLL_COALESCE_HIGH
+	#define ipconfigNETWORK_POLL_COALESCE_HIGH	ipconfigNETWORK_POLL_BUDGET
+#endif
+
+#ifndef ipconfigNETWORK_POLL_COALESCE_LOW
+	#define ipconfigNETWORK_POLL_COALESCE_LOW	( ipconfigNETWORK_POLL_BUDGET / 8 )
+#endif
+
 #ifndef ipconfigALLOW_SOCKET_SEND_WITHOUT_BIND
 	#define ipconfigALLOW_SOCKET_SEND_WITHOUT_BIND 1
 #endif
@@ -538,6 +574,56 @@ connections, hang protection can help reduce the impact of SYN floods. */
 	#define ipconfigTCP_HANG_PROTECTION_TIME 30
 #endif
 
+/* When set to 1, a listening socket keeps its half-open connections in a small
+table, one entry per connection, and only creates the child socket when the
+peer's final ACK arrives.  Without it, every SYN received creates a socket.
+Sockets that use FREERTOS_SO_REUSE_LISTEN_SOCKET are not affected. */
+#ifndef ipconfigTCP_SYN_TABLE
+	#define ipconfigTCP_SYN_TABLE 0
+#endif
+
+/* Milliseconds a half-open connection is kept in the table of a listening
+socket.  The SYN+ACK is not repeated: a peer that did not receive it will send
+its SYN again, which is answered as long as the entry exists. */
+#ifndef ipconfigTCP_SYN_TABLE_TIMEOUT_MS
+	#define ipconfigTCP_SYN_TABLE_TIMEOUT_MS 10000
+#endif
+
+/* When set to 1, a listening socket whose backlog is full answers a SYN with
+a SYN cookie: the SYN+ACK's sequence number encodes the connection, so that
+nothing is stored until the final ACK arrives.  Such connections do not use
+window scaling.  Can be switched off for each socket with the socket option
+FREERTOS_SO_SYN_COOKIES. */
+#ifndef ipconfigTCP_SYN_COOKIES
+	#define ipconfigTCP_SYN_COOKIES 0
+#endif
+
+#if( ipconfigTCP_SYN_COOKIES == 1 ) && ( ipconfigTCP_SYN_TABLE == 0 )
+	#error ipconfigTCP_SYN_COOKIES requires ipconfigTCP_SYN_TABLE
+#endif
+
+/* When set to 1, a connection that this side closed first is remembered in a
+small table once the FIN exchange completes: its addresses, ports and final
+sequence numbers, for ipconfigTCP_TIME_WAIT_MS.  A FIN that the peer repeats is
+acknowledged from the table, and other late segments are dropped, whether or
+not the socket has been closed yet.  The window segments of the socket are
+released as soon as the exchange completes. */
+#ifndef ipconfigTCP_TIME_WAIT_TABLE
+	#define ipconfigTCP_TIME_WAIT_TABLE 0
+#endif
+
+/* The number of connections the TIME_WAIT table holds.  When it is full, the
+connection closest to expiry is forgotten first. */
+#ifndef ipconfigTCP_TIME_WAIT_ENTRIES
+	#define ipconfigTCP_TIME_WAIT_ENTRIES 16
+#endif
+
+/* Milliseconds a connection is kept in the TIME_WAIT table, restarted when the
+peer repeats its FIN. */
+#ifndef ipconfigTCP_TIME_WAIT_MS
+	#define ipconfigTCP_TIME_WAIT_MS 60000
+#endif
+
 #ifndef ipconfigTCP_IP_SANITY
 	#define ipconfigTCP_IP_SANITY 0
 #endif
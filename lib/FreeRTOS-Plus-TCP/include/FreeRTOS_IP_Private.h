@@ -254,6 +254,7 @@ typedef enum
 	eSocketCloseEvent,		/* 9: Send a message to the IP-task to close a socket. */
 	eSocketSelectEvent,		/*10: Send a message to the IP-task for select(). */
 	eSocketSignalEvent,		/*11: A socket must be signalled. */
+	eNetworkPollEvent,		/*12: The network interface has masked its receive interrupt and must be polled. */
 } eIPEvent_t;
 
 typedef struct IP_TASK_COMMANDS
@@ -418,6 +419,30 @@ BaseType_t FreeRTOS_ReleaseFreeNetworkBufferFromISR( void );
 void FreeRTOS_NetworkDown( void );
 BaseType_t FreeRTOS_NetworkDownFromISR( void );
 
+#if( ipconfigUSE_NETWORK_POLL != 0 )
+	/*
+	 * Called by a network interface that has masked its receive interrupt, to
+	 * have the IP task call xNetworkInterfacePoll() until the interface has no
+	 * more frames.  Returns pdFAIL if the event queue is full, in which case the
+	 * interface must unmask its interrupt again.  Only use the FromISR()
+	 * version from an interrupt service routine, and perform a context switch
+	 * before the interrupt is exited if it sets *pxHigherPriorityTaskWoken.
+	 */
+	BaseType_t xNetworkPollSchedule( void );
+	BaseType_t xNetworkPollScheduleFromISR( BaseType_t *pxHigherPriorityTaskWoken );
+
+	/*
+	 * Called by the IP task when it receives an eNetworkPollEvent.
+	 */
+	void vNetworkPollProcess( void );
+
+	/*
+	 * Called by xNetworkInterfacePoll(), on the IP task, to process a frame now
+	 * rather than send it to the IP task in an event.
+	 */
+	void vNetworkPollReceive( NetworkBufferDescriptor_t * const pxNetworkBuffer );
+#endif /* ipconfigUSE_NETWORK_POLL */
+
 /*
  * Processes incoming ARP packets.
  */
@@ -531,6 +556,9 @@ BaseType_t xIPIsNetworkTaskReady( void );
 				bFinLast : 1,		/* The last ACK (after FIN and FIN+ACK) has been sent or will be sent by the peer */
 				bRxStopped : 1,		/* Application asked to temporarily stop reception */
 				bMallocError : 1,	/* There was an error allocating a stream */
+				#if( ipconfigTCP_SYN_COOKIES == 1 )
+					bSynCookies : 1,	/* Listening socket: answer SYNs with SYN cookies once the backlog is full */
+				#endif /* ipconfigTCP_SYN_COOKIES */
 				bWinScaling : 1;	/* A TCP-Window Scaling option was offered and accepted in the SYN phase. */
 		} bits;
 		uint32_t ulHighestRxAllowed;
@@ -540,6 +568,9 @@ BaseType_t xIPIsNetworkTaskReady( void );
 		uint16_t usInitMSS;		/* Initial maximum segment Size */
 		uint16_t usChildCount;	/* In case of a listening socket: number of connections on this port number */
 		uint16_t usBacklog;		/* In case of a listening socket: maximum number of concurrent connections on this port number */
+		#if( ipconfigTCP_SYN_TABLE == 1 )
+			struct xSYN_TABLE_ENTRY *pxSynTable;	/* In case of a listening socket: its half-open connections, 'usBacklog' entries */
+		#endif /* ipconfigTCP_SYN_TABLE */
 		uint8_t ucRepCount;		/* Send repeat count, for retransmissions
 								 * This counter is separate from the xmitCount in the
 								 * TCP win segments */
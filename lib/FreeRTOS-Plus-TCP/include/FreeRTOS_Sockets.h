@@ -130,6 +130,10 @@ FreeRTOS_setsockopt(). */
 	#define FREERTOS_SO_WAKEUP_CALLBACK	( 17 )
 #endif
 
+#if( ipconfigTCP_SYN_COOKIES == 1 )
+	#define FREERTOS_SO_SYN_COOKIES		( 18 )		/* Answer SYNs with SYN cookies once the backlog of a listening socket is full (the default) */
+#endif
+
 
 #define FREERTOS_NOT_LAST_IN_FRAGMENTED_PACKET 	( 0x80 )  /* For internal use only, but also part of an 8-bit bitwise value. */
 #define FREERTOS_FRAGMENTED_PACKET				( 0x40 )  /* For internal use only, but also part of an 8-bit bitwise value. */
@@ -205,6 +209,20 @@ struct freertos_sockaddr
 
 #endif /* ipconfigBYTE_ORDER */
 
+/* One datagram passed to FreeRTOS_recvmmsg() or FreeRTOS_sendmmsg().  When
+receiving, xLength is the size of pvBuffer and is set to the length of the
+datagram copied into it, or with FREERTOS_ZERO_COPY pvBuffer is set to point to
+the datagram in the network buffer, which must be returned with
+FreeRTOS_ReleaseUDPPayloadBuffer().  When sending, pvBuffer holds xLength bytes,
+and with FREERTOS_ZERO_COPY it is a buffer obtained from
+FreeRTOS_GetUDPPayloadBuffer(). */
+struct freertos_mmsghdr
+{
+	void *pvBuffer;
+	size_t xLength;
+	struct freertos_sockaddr xAddress;	/* The source or destination address. */
+};
+
 /* The socket type itself. */
 typedef void *Socket_t;
 
@@ -222,6 +240,12 @@ int32_t FreeRTOS_recvfrom( Socket_t xSocket, void *pvBuffer, size_t xBufferLengt
 int32_t FreeRTOS_sendto( Socket_t xSocket, const void *pvBuffer, size_t xTotalDataLength, BaseType_t xFlags, const struct freertos_sockaddr *pxDestinationAddress, socklen_t xDestinationAddressLength );
 BaseType_t FreeRTOS_bind( Socket_t xSocket, struct freertos_sockaddr *pxAddress, socklen_t xAddressLength );
 
+/* Receive or send up to uxMessageCount datagrams in one call.  Both return the
+number of datagrams received or sent, and FreeRTOS_recvmmsg() blocks, as
+FreeRTOS_recvfrom() does, only until the first datagram arrives. */
+int32_t FreeRTOS_recvmmsg( Socket_t xSocket, struct freertos_mmsghdr *pxMessages, size_t uxMessageCount, BaseType_t xFlags );
+int32_t FreeRTOS_sendmmsg( Socket_t xSocket, const struct freertos_mmsghdr *pxMessages, size_t uxMessageCount, BaseType_t xFlags );
+
 /* function to get the local address and IP port */
 size_t FreeRTOS_GetLocalAddress( Socket_t xSocket, struct freertos_sockaddr *pxAddress );
 
@@ -36,6 +36,19 @@ BaseType_t xNetworkInterfaceOutput( NetworkBufferDescriptor_t * const pxNetworkB
 void vNetworkInterfaceAllocateRAMToBuffers( NetworkBufferDescriptor_t pxNetworkBuffers[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ] );
 BaseType_t xGetPhyLinkStatus( void );
 
+#if( ipconfigUSE_NETWORK_POLL != 0 )
+	/* Called on the IP task after the interface has called
+	xNetworkPollScheduleFromISR().  Passes up to xBudget received frames to
+	vNetworkPollReceive() and returns the number of frames taken. */
+	BaseType_t xNetworkInterfacePoll( BaseType_t xBudget );
+
+	/* Called on the IP task once a poll has taken fewer frames than its budget.
+	The interface unmasks its receive interrupt and, if it is able to, does not
+	raise it again until ulCoalesceTimeUs microseconds have passed, so frames
+	that arrive in that time are taken together. */
+	void vNetworkInterfacePollComplete( uint32_t ulCoalesceTimeUs );
+#endif /* ipconfigUSE_NETWORK_POLL */
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -232,6 +232,13 @@ static TickType_t prvCalculateSleepTime( void );
  */
 static void prvHandleEthernetPacket( NetworkBufferDescriptor_t *pxBuffer );
 
+/*
+ * The sockets API has generated a packet to send.  In the case that it is part
+ * of a linked packet chain, sent by FreeRTOS_sendmmsg(), walk through it to
+ * send every packet.
+ */
+static void prvHandleGeneratedUDPPacket( NetworkBufferDescriptor_t *pxBuffer );
+
 /*
  * Utility functions for the light weight IP timers.
  */
@@ -394,6 +401,16 @@ struct freertos_sockaddr xAddress;
 				prvHandleEthernetPacket( ( NetworkBufferDescriptor_t * ) ( xReceivedEvent.pvData ) );
 				break;
 
+			case eNetworkPollEvent:
+				#if( ipconfigUSE_NETWORK_POLL != 0 )
+				{
+					/* The network hardware driver has masked its receive
+					interrupt, and its frames are taken by polling it. */
+					vNetworkPollProcess();
+				}
+				#endif /* ipconfigUSE_NETWORK_POLL */
+				break;
+
 			case eARPTimerEvent :
 				/* The ARP timer has expired, process the ARP cache. */
 				vARPAgeCache();
@@ -430,7 +447,7 @@ struct freertos_sockaddr xAddress;
 				/* The network stack has generated a packet to send.  A
 				pointer to the generated buffer is located in the pvData
 				member of the received event structure. */
-				vProcessGeneratedUDPPacket( ( NetworkBufferDescriptor_t * ) ( xReceivedEvent.pvData ) );
+				prvHandleGeneratedUDPPacket( ( NetworkBufferDescriptor_t * ) ( xReceivedEvent.pvData ) );
 				break;
 
 			case eDHCPEvent:
@@ -532,6 +549,26 @@ BaseType_t xReturn;
 }
 /*-----------------------------------------------------------*/
 
+#if( ipconfigUSE_NETWORK_POLL != 0 )
+
+	void vNetworkPollReceive( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+	{
+		/* Only the network interface's poll function, which is called from
+		the IP task, may pass frames to the stack this way. */
+		configASSERT( xIsCallingFromIPTask() == pdTRUE );
+
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		{
+			pxNetworkBuffer->pxNextBuffer = NULL;
+		}
+		#endif
+
+		prvProcessEthernetPacket( pxNetworkBuffer );
+	}
+
+#endif /* ipconfigUSE_NETWORK_POLL */
+/*-----------------------------------------------------------*/
+
 static void prvHandleEthernetPacket( NetworkBufferDescriptor_t *pxBuffer )
 {
 	#if( ipconfigUSE_LINKED_RX_MESSAGES == 0 )
@@ -569,6 +606,33 @@ static void prvHandleEthernetPacket( NetworkBufferDescriptor_t *pxBuffer )
 }
 /*-----------------------------------------------------------*/
 
+static void prvHandleGeneratedUDPPacket( NetworkBufferDescriptor_t *pxBuffer )
+{
+	#if( ipconfigUSE_LINKED_RX_MESSAGES == 0 )
+	{
+		vProcessGeneratedUDPPacket( pxBuffer );
+	}
+	#else /* ipconfigUSE_LINKED_RX_MESSAGES */
+	{
+	NetworkBufferDescriptor_t *pxNextBuffer;
+
+		/* FreeRTOS_sendmmsg() chains the packets it sends using the
+		pxNextBuffer member, as network interfaces do with the packets they
+		receive.  Other packets are passed in on their own, with pxNextBuffer
+		set to NULL. */
+		do
+		{
+			pxNextBuffer = pxBuffer->pxNextBuffer;
+			pxBuffer->pxNextBuffer = NULL;
+
+			vProcessGeneratedUDPPacket( pxBuffer );
+			pxBuffer = pxNextBuffer;
+		} while( pxBuffer != NULL );
+	}
+	#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+}
+/*-----------------------------------------------------------*/
+
 static TickType_t prvCalculateSleepTime( void )
 {
 TickType_t xMaximumSleepTime;
@@ -1119,7 +1183,7 @@ void FreeRTOS_SetAddressConfiguration( const uint32_t *pulIPAddress, const uint3
 				if( xSendEventStructToIPTask( &xStackTxEvent, xBlockTimeTicks) != pdPASS )
 				{
 					vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
-					iptraceSTACK_TX_EVENT_LOST( ipSTACK_TX_EVENT );
+					iptraceSTACK_TX_EVENT_LOST( eStackTxEvent );
 				}
 				else
 				{
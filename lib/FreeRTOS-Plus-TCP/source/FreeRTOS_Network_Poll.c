@@ -0,0 +1,211 @@
+/*
+ * FreeRTOS+TCP V2.0.10
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Polled reception for network interfaces, set ipconfigUSE_NETWORK_POLL to 1 in
+ * FreeRTOSIPConfig.h to use it.
+ *
+ * A network interface that posts an eNetworkRxEvent for each receive interrupt
+ * wakes the IP task once per frame when small frames arrive in a burst.
+ * Instead, the interface's receive interrupt masks itself and calls
+ * xNetworkPollScheduleFromISR().  The IP task then calls the interface's
+ * xNetworkInterfacePoll(), which passes up to ipconfigNETWORK_POLL_BUDGET
+ * frames straight to the stack.  While polls use their whole budget the IP task
+ * polls again, after any events that are already queued, and the first poll to
+ * take fewer frames calls vNetworkInterfacePollComplete() to have the interface
+ * unmask its interrupt.
+ *
+ * The number of frames taken between an interrupt and the poll that completes
+ * sets the coalescing time passed to vNetworkInterfacePollComplete(), which an
+ * interface that is able to delays its next interrupt by.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkInterface.h"
+
+#if( ipconfigUSE_NETWORK_POLL != 0 )
+
+#if( ipconfigNETWORK_POLL_BUDGET < 1 )
+	#error ipconfigNETWORK_POLL_BUDGET must be at least 1
+#endif
+
+#if( ipconfigNETWORK_POLL_COALESCE_MIN_US > ipconfigNETWORK_POLL_COALESCE_MAX_US )
+	#error ipconfigNETWORK_POLL_COALESCE_MIN_US must not be more than ipconfigNETWORK_POLL_COALESCE_MAX_US
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Update ulCoalesceTimeUs from the number of frames taken since the interface
+ * last masked its interrupt.
+ */
+static void prvUpdateCoalesceTime( UBaseType_t uxFrames );
+
+/*-----------------------------------------------------------*/
+
+/* The event that has the IP task call vNetworkPollProcess(). */
+static const IPStackEvent_t xPollEvent = { eNetworkPollEvent, NULL };
+
+/* Set from when the interface is first scheduled to be polled until it is
+asked to unmask its interrupt again. */
+static volatile BaseType_t xPollScheduled = pdFALSE;
+
+/* The frames taken since the interface masked its interrupt, and the
+coalescing time to pass to the interface when it unmasks it.  Only accessed by
+the IP task. */
+static UBaseType_t uxFramesSinceInterrupt = 0;
+static uint32_t ulCoalesceTimeUs = 0;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xNetworkPollSchedule( void )
+{
+BaseType_t xWasScheduled, xReturn = pdPASS;
+
+	taskENTER_CRITICAL();
+	{
+		xWasScheduled = xPollScheduled;
+		xPollScheduled = pdTRUE;
+	}
+	taskEXIT_CRITICAL();
+
+	if( xWasScheduled == pdFALSE )
+	{
+		if( xSendEventStructToIPTask( &xPollEvent, ( TickType_t ) 0 ) != pdPASS )
+		{
+			xPollScheduled = pdFALSE;
+			xReturn = pdFAIL;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xNetworkPollScheduleFromISR( BaseType_t *pxHigherPriorityTaskWoken )
+{
+extern QueueHandle_t xNetworkEventQueue;
+UBaseType_t uxSavedInterruptStatus;
+BaseType_t xWasScheduled, xReturn = pdPASS;
+
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+	{
+		xWasScheduled = xPollScheduled;
+		xPollScheduled = pdTRUE;
+	}
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+	if( xWasScheduled == pdFALSE )
+	{
+		if( xQueueSendToBackFromISR( xNetworkEventQueue, &xPollEvent, pxHigherPriorityTaskWoken ) != pdPASS )
+		{
+			xPollScheduled = pdFALSE;
+			xReturn = pdFAIL;
+			iptraceETHERNET_RX_EVENT_LOST();
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vNetworkPollProcess( void )
+{
+BaseType_t xFrames;
+
+	xFrames = xNetworkInterfacePoll( ( BaseType_t ) ipconfigNETWORK_POLL_BUDGET );
+	uxFramesSinceInterrupt += ( UBaseType_t ) xFrames;
+
+	if( xFrames >= ( BaseType_t ) ipconfigNETWORK_POLL_BUDGET )
+	{
+		/* More frames may be waiting.  Poll again once the events already in
+		the queue have been processed, so a flood of frames cannot keep the
+		IP task from its sockets and timers. */
+		if( xSendEventStructToIPTask( &xPollEvent, ( TickType_t ) 0 ) == pdPASS )
+		{
+			return;
+		}
+
+		/* The queue is full.  Unmask the interrupt, which the interface raises
+		again for the frames that are left. */
+	}
+
+	prvUpdateCoalesceTime( uxFramesSinceInterrupt );
+	uxFramesSinceInterrupt = 0;
+
+	/* Must be cleared before the interrupt is unmasked, or an interrupt that
+	follows straight away would not schedule a poll. */
+	xPollScheduled = pdFALSE;
+	vNetworkInterfacePollComplete( ulCoalesceTimeUs );
+}
+/*-----------------------------------------------------------*/
+
+static void prvUpdateCoalesceTime( UBaseType_t uxFrames )
+{
+	if( uxFrames >= ( UBaseType_t ) ipconfigNETWORK_POLL_COALESCE_HIGH )
+	{
+		/* The traffic is heavy, so let more frames gather between
+		interrupts. */
+		if( ulCoalesceTimeUs < ( uint32_t ) ipconfigNETWORK_POLL_COALESCE_MIN_US )
+		{
+			ulCoalesceTimeUs = ( uint32_t ) ipconfigNETWORK_POLL_COALESCE_MIN_US;
+		}
+		else if( ulCoalesceTimeUs < ( ( uint32_t ) ipconfigNETWORK_POLL_COALESCE_MAX_US / 2UL ) )
+		{
+			ulCoalesceTimeUs *= 2UL;
+		}
+		else
+		{
+			ulCoalesceTimeUs = ( uint32_t ) ipconfigNETWORK_POLL_COALESCE_MAX_US;
+		}
+	}
+	else if( uxFrames <= ( UBaseType_t ) ipconfigNETWORK_POLL_COALESCE_LOW )
+	{
+		/* The traffic is light, so do not delay the frames that arrive. */
+		ulCoalesceTimeUs /= 2UL;
+
+		if( ulCoalesceTimeUs < ( uint32_t ) ipconfigNETWORK_POLL_COALESCE_MIN_US )
+		{
+			ulCoalesceTimeUs = 0UL;
+		}
+	}
+	else
+	{
+		/* Keep the current coalescing time. */
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_NETWORK_POLL */
@@ -111,6 +111,14 @@ static const ListItem_t * pxListFindListItemWithValue( const List_t *pxList, Tic
  */
 static BaseType_t prvValidSocket( FreeRTOS_Socket_t *pxSocket, BaseType_t xProtocol, BaseType_t xIsBound );
 
+/*
+ * Called from FreeRTOS_recvfrom() and FreeRTOS_recvmmsg(): wait, for as long
+ * as the socket's receive block time allows, for a datagram to arrive.  Returns
+ * the number of datagrams waiting, and sets *pxEventBits to the socket events
+ * that ended the wait.
+ */
+static BaseType_t prvUDPWaitForPackets( FreeRTOS_Socket_t *pxSocket, BaseType_t xFlags, EventBits_t *pxEventBits );
+
 /*
  * Before creating a socket, check the validity of the parameters used
  * and find the size of the socket space, which is different for UDP and TCP
@@ -342,6 +350,11 @@ Socket_t xReturn;
 						pxSocket->u.xTCP.uxTxWinSize  = 1u;
 					}
 					#endif
+					#if( ipconfigTCP_SYN_COOKIES == 1 )
+					{
+						pxSocket->u.xTCP.bits.bSynCookies = pdTRUE_UNSIGNED;
+					}
+					#endif
 					/* The above values are just defaults, and can be overridden by
 					calling FreeRTOS_setsockopt().  No buffers will be allocated until a
 					socket is connected and data is exchanged. */
@@ -584,33 +597,16 @@ Socket_t xReturn;
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
 /*-----------------------------------------------------------*/
 
-/*
- * FreeRTOS_recvfrom: receive data from a bound socket
- * In this library, the function can only be used with connectionsless sockets
- * (UDP)
- */
-int32_t FreeRTOS_recvfrom( Socket_t xSocket, void *pvBuffer, size_t xBufferLength, BaseType_t xFlags, struct freertos_sockaddr *pxSourceAddress, socklen_t *pxSourceAddressLength )
+static BaseType_t prvUDPWaitForPackets( FreeRTOS_Socket_t *pxSocket, BaseType_t xFlags, EventBits_t *pxEventBits )
 {
-BaseType_t lPacketCount = 0;
-NetworkBufferDescriptor_t *pxNetworkBuffer;
-FreeRTOS_Socket_t *pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+BaseType_t lPacketCount;
 TickType_t xRemainingTime = ( TickType_t ) 0; /* Obsolete assignment, but some compilers output a warning if its not done. */
 BaseType_t xTimed = pdFALSE;
 TimeOut_t xTimeOut;
-int32_t lReturn;
 EventBits_t xEventBits = ( EventBits_t ) 0;
 
-	if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_UDP, pdTRUE ) == pdFALSE )
-	{
-		return -pdFREERTOS_ERRNO_EINVAL;
-	}
-
 	lPacketCount = ( BaseType_t ) listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) );
 
-	/* The function prototype is designed to maintain the expected Berkeley
-	sockets standard, but this implementation does not use all the parameters. */
-	( void ) pxSourceAddressLength;
-
 	while( lPacketCount == 0 )
 	{
 		if( xTimed == pdFALSE )
@@ -661,10 +657,6 @@ EventBits_t xEventBits = ( EventBits_t ) 0;
 				break;
 			}
 		}
-		#else
-		{
-			( void ) xEventBits;
-		}
 		#endif /* ipconfigSUPPORT_SIGNALS */
 
 		lPacketCount = ( BaseType_t ) listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) );
@@ -681,6 +673,36 @@ EventBits_t xEventBits = ( EventBits_t ) 0;
 		}
 	} /* while( lPacketCount == 0 ) */
 
+	*pxEventBits = xEventBits;
+
+	return lPacketCount;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * FreeRTOS_recvfrom: receive data from a bound socket
+ * In this library, the function can only be used with connectionsless sockets
+ * (UDP)
+ */
+int32_t FreeRTOS_recvfrom( Socket_t xSocket, void *pvBuffer, size_t xBufferLength, BaseType_t xFlags, struct freertos_sockaddr *pxSourceAddress, socklen_t *pxSourceAddressLength )
+{
+BaseType_t lPacketCount = 0;
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+FreeRTOS_Socket_t *pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+int32_t lReturn;
+EventBits_t xEventBits = ( EventBits_t ) 0;
+
+	if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_UDP, pdTRUE ) == pdFALSE )
+	{
+		return -pdFREERTOS_ERRNO_EINVAL;
+	}
+
+	/* The function prototype is designed to maintain the expected Berkeley
+	sockets standard, but this implementation does not use all the parameters. */
+	( void ) pxSourceAddressLength;
+
+	lPacketCount = prvUDPWaitForPackets( pxSocket, xFlags, &xEventBits );
+
 	if( lPacketCount != 0 )
 	{
 		taskENTER_CRITICAL();
@@ -753,6 +775,103 @@ EventBits_t xEventBits = ( EventBits_t ) 0;
 }
 /*-----------------------------------------------------------*/
 
+/*
+ * FreeRTOS_recvmmsg: receive up to uxMessageCount datagrams from a bound UDP
+ * socket, taking them from the socket in a single critical section
+ */
+int32_t FreeRTOS_recvmmsg( Socket_t xSocket, struct freertos_mmsghdr *pxMessages, size_t uxMessageCount, BaseType_t xFlags )
+{
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+FreeRTOS_Socket_t *pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+struct freertos_mmsghdr *pxMessage;
+List_t xReceivedList;
+size_t uxReceived = 0u, uxMessage;
+int32_t lReturn;
+EventBits_t xEventBits = ( EventBits_t ) 0;
+
+	/* Datagrams cannot be peeked at in batches. */
+	if( ( prvValidSocket( pxSocket, FREERTOS_IPPROTO_UDP, pdTRUE ) == pdFALSE ) ||
+		( ( xFlags & FREERTOS_MSG_PEEK ) != 0 ) ||
+		( uxMessageCount == 0u ) )
+	{
+		return -pdFREERTOS_ERRNO_EINVAL;
+	}
+
+	configASSERT( pxMessages );
+
+	if( prvUDPWaitForPackets( pxSocket, xFlags, &xEventBits ) != 0 )
+	{
+		vListInitialise( &xReceivedList );
+
+		/* Move as many of the waiting network buffers as there are messages
+		to a list of our own, so the IP-task is only locked out once. */
+		taskENTER_CRITICAL();
+		{
+			while( ( uxReceived < uxMessageCount ) &&
+				   ( listLIST_IS_EMPTY( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) == pdFALSE ) )
+			{
+				pxNetworkBuffer = ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxSocket->u.xUDP.xWaitingPacketsList ) );
+				uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+				vListInsertEnd( &xReceivedList, &( pxNetworkBuffer->xBufferListItem ) );
+				uxReceived++;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		for( uxMessage = 0u; uxMessage < uxReceived; uxMessage++ )
+		{
+			pxMessage = &( pxMessages[ uxMessage ] );
+			pxNetworkBuffer = ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &xReceivedList );
+			uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+
+			pxMessage->xAddress.sin_port = pxNetworkBuffer->usPort;
+			pxMessage->xAddress.sin_addr = pxNetworkBuffer->ulIPAddress;
+
+			if( ( xFlags & FREERTOS_ZERO_COPY ) == 0 )
+			{
+				/* As in FreeRTOS_recvfrom(), truncate the datagram if it won't
+				fit in the provided buffer. */
+				if( pxNetworkBuffer->xDataLength > pxMessage->xLength )
+				{
+					iptraceRECVFROM_DISCARDING_BYTES( ( pxNetworkBuffer->xDataLength - pxMessage->xLength ) );
+				}
+				else
+				{
+					pxMessage->xLength = pxNetworkBuffer->xDataLength;
+				}
+
+				memcpy( pxMessage->pvBuffer, ( void * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] ), pxMessage->xLength );
+				vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+			}
+			else
+			{
+				/* The message is set to point to the data in the network
+				buffer, which the caller returns with
+				FreeRTOS_ReleaseUDPPayloadBuffer(). */
+				pxMessage->pvBuffer = ( void * ) ( &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] ) );
+				pxMessage->xLength = pxNetworkBuffer->xDataLength;
+			}
+		}
+
+		lReturn = ( int32_t ) uxReceived;
+	}
+#if( ipconfigSUPPORT_SIGNALS != 0 )
+	else if( ( xEventBits & eSOCKET_INTR ) != 0 )
+	{
+		lReturn = -pdFREERTOS_ERRNO_EINTR;
+		iptraceRECVFROM_INTERRUPTED();
+	}
+#endif /* ipconfigSUPPORT_SIGNALS */
+	else
+	{
+		lReturn = -pdFREERTOS_ERRNO_EWOULDBLOCK;
+		iptraceRECVFROM_TIMEOUT();
+	}
+
+	return lReturn;
+}
+/*-----------------------------------------------------------*/
+
 int32_t FreeRTOS_sendto( Socket_t xSocket, const void *pvBuffer, size_t xTotalDataLength, BaseType_t xFlags, const struct freertos_sockaddr *pxDestinationAddress, socklen_t xDestinationAddressLength )
 {
 NetworkBufferDescriptor_t *pxNetworkBuffer;
@@ -862,7 +981,7 @@ FreeRTOS_Socket_t *pxSocket;
 					{
 						vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
 					}
-					iptraceSTACK_TX_EVENT_LOST( ipSTACK_TX_EVENT );
+					iptraceSTACK_TX_EVENT_LOST( eStackTxEvent );
 				}
 			}
 			else
@@ -889,6 +1008,175 @@ FreeRTOS_Socket_t *pxSocket;
 } /* Tested */
 /*-----------------------------------------------------------*/
 
+/*
+ * FreeRTOS_sendmmsg: send up to uxMessageCount datagrams from a UDP socket.
+ * When ipconfigUSE_LINKED_RX_MESSAGES is set the datagrams are chained through
+ * pxNextBuffer and passed to the IP-task in a single event, otherwise each is
+ * passed in its own event as FreeRTOS_sendto() does.  Sending stops at the
+ * first datagram that is too long or for which no network buffer can be
+ * obtained, and the number of datagrams sent is returned.  When
+ * FREERTOS_ZERO_COPY is used the buffers of the datagrams that were not sent
+ * still belong to the caller.
+ */
+int32_t FreeRTOS_sendmmsg( Socket_t xSocket, const struct freertos_mmsghdr *pxMessages, size_t uxMessageCount, BaseType_t xFlags )
+{
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+IPStackEvent_t xStackTxEvent = { eStackTxEvent, NULL };
+const struct freertos_mmsghdr *pxMessage;
+TimeOut_t xTimeOut;
+TickType_t xTicksToWait;
+size_t uxSent = 0u;
+FreeRTOS_Socket_t *pxSocket;
+#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+	NetworkBufferDescriptor_t *pxFirstBuffer = NULL, *pxLastBuffer = NULL;
+#endif
+
+	pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+	configASSERT( pxMessages );
+
+	/* If the socket is not already bound to an address, bind it now. */
+	if( ( socketSOCKET_IS_BOUND( pxSocket ) == pdFALSE ) &&
+		( FreeRTOS_bind( xSocket, NULL, 0u ) != 0 ) )
+	{
+		iptraceSENDTO_SOCKET_NOT_BOUND();
+		return 0;
+	}
+
+	xTicksToWait = pxSocket->xSendBlockTime;
+
+	#if( ipconfigUSE_CALLBACKS != 0 )
+	{
+		if( xIsCallingFromIPTask() != pdFALSE )
+		{
+			/* As in FreeRTOS_sendto(), a call-back handler may not block. */
+			xTicksToWait = ( TickType_t )0;
+		}
+	}
+	#endif /* ipconfigUSE_CALLBACKS */
+
+	if( ( xFlags & FREERTOS_MSG_DONTWAIT ) != 0 )
+	{
+		xTicksToWait = ( TickType_t ) 0;
+	}
+
+	vTaskSetTimeOutState( &xTimeOut );
+
+	for( pxMessage = pxMessages; pxMessage < &( pxMessages[ uxMessageCount ] ); pxMessage++ )
+	{
+		if( pxMessage->xLength > ( size_t ) ipMAX_UDP_PAYLOAD_LENGTH )
+		{
+			iptraceSENDTO_DATA_TOO_LONG();
+			break;
+		}
+
+		if( ( xFlags & FREERTOS_ZERO_COPY ) == 0 )
+		{
+			/* The block time is shared by all the buffers obtained. */
+			pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( pxMessage->xLength + sizeof( UDPPacket_t ), xTicksToWait );
+
+			if( pxNetworkBuffer == NULL )
+			{
+				iptraceNO_BUFFER_FOR_SENDTO();
+				break;
+			}
+
+			memcpy( ( void * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipUDP_PAYLOAD_OFFSET_IPv4 ] ), pxMessage->pvBuffer, pxMessage->xLength );
+
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdTRUE )
+			{
+				xTicksToWait = ( TickType_t ) 0;
+			}
+		}
+		else
+		{
+			pxNetworkBuffer = pxUDPPayloadBuffer_to_NetworkBuffer( pxMessage->pvBuffer );
+		}
+
+		pxNetworkBuffer->xDataLength = pxMessage->xLength;
+		pxNetworkBuffer->usPort = pxMessage->xAddress.sin_port;
+		pxNetworkBuffer->usBoundPort = ( uint16_t ) socketGET_SOCKET_PORT( pxSocket );
+		pxNetworkBuffer->ulIPAddress = pxMessage->xAddress.sin_addr;
+		pxNetworkBuffer->pucEthernetBuffer[ ipSOCKET_OPTIONS_OFFSET ] = pxSocket->ucSocketOptions;
+
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		{
+			/* Chain the packet to those to be sent below. */
+			pxNetworkBuffer->pxNextBuffer = NULL;
+
+			if( pxFirstBuffer == NULL )
+			{
+				pxFirstBuffer = pxNetworkBuffer;
+			}
+			else
+			{
+				pxLastBuffer->pxNextBuffer = pxNetworkBuffer;
+			}
+
+			pxLastBuffer = pxNetworkBuffer;
+		}
+		#else
+		{
+			xStackTxEvent.pvData = pxNetworkBuffer;
+
+			if( xSendEventStructToIPTask( &xStackTxEvent, xTicksToWait ) != pdPASS )
+			{
+				if( ( xFlags & FREERTOS_ZERO_COPY ) == 0 )
+				{
+					vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+				}
+
+				iptraceSTACK_TX_EVENT_LOST( eStackTxEvent );
+				break;
+			}
+		}
+		#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+
+		uxSent++;
+	}
+
+	#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+	{
+		if( pxFirstBuffer != NULL )
+		{
+			/* Ask the IP-task to send all the packets. */
+			xStackTxEvent.pvData = pxFirstBuffer;
+
+			if( xSendEventStructToIPTask( &xStackTxEvent, xTicksToWait ) != pdPASS )
+			{
+				for( pxNetworkBuffer = pxFirstBuffer; pxNetworkBuffer != NULL; pxNetworkBuffer = pxLastBuffer )
+				{
+					pxLastBuffer = pxNetworkBuffer->pxNextBuffer;
+					pxNetworkBuffer->pxNextBuffer = NULL;
+
+					if( ( xFlags & FREERTOS_ZERO_COPY ) == 0 )
+					{
+						vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+					}
+				}
+
+				uxSent = 0u;
+				iptraceSTACK_TX_EVENT_LOST( eStackTxEvent );
+			}
+		}
+	}
+	#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+
+	#if( ipconfigUSE_CALLBACKS == 1 )
+	{
+		if( ipconfigIS_VALID_PROG_ADDRESS( pxSocket->u.xUDP.pxHandleSent ) )
+		{
+			for( pxMessage = pxMessages; pxMessage < &( pxMessages[ uxSent ] ); pxMessage++ )
+			{
+				pxSocket->u.xUDP.pxHandleSent( (Socket_t *)pxSocket, pxMessage->xLength );
+			}
+		}
+	}
+	#endif /* ipconfigUSE_CALLBACKS */
+
+	return ( int32_t ) uxSent;
+}
+/*-----------------------------------------------------------*/
+
 /*
  * FreeRTOS_bind() : binds a sockt to a local port number.  If port 0 is
  * provided, a system provided port number will be assigned.  This function can
@@ -1154,6 +1442,16 @@ NetworkBufferDescriptor_t *pxNetworkBuffer;
 			}
 			#endif /* ipconfigUSE_TCP_WIN */
 
+			#if( ipconfigTCP_SYN_TABLE == 1 )
+			{
+				/* A listening socket may own a table of half-open connections. */
+				if( pxSocket->u.xTCP.pxSynTable != NULL )
+				{
+					vPortFree( pxSocket->u.xTCP.pxSynTable );
+				}
+			}
+			#endif /* ipconfigTCP_SYN_TABLE */
+
 			/* Free the input and output streams */
 			if( pxSocket->u.xTCP.rxStream != NULL )
 			{
@@ -1525,6 +1823,26 @@ FreeRTOS_Socket_t *pxSocket;
 				xReturn = 0;
 				break;
 
+			#if( ipconfigTCP_SYN_COOKIES == 1 )
+				case FREERTOS_SO_SYN_COOKIES:	/* Answer SYNs with SYN cookies once the backlog is full */
+					{
+						if( pxSocket->ucProtocol != ( uint8_t ) FREERTOS_IPPROTO_TCP )
+						{
+							break;	/* will return -pdFREERTOS_ERRNO_EINVAL */
+						}
+						if( *( ( BaseType_t * ) pvOptionValue ) != 0 )
+						{
+							pxSocket->u.xTCP.bits.bSynCookies = pdTRUE_UNSIGNED;
+						}
+						else
+						{
+							pxSocket->u.xTCP.bits.bSynCookies = pdFALSE_UNSIGNED;
+						}
+					}
+					xReturn = 0;
+					break;
+			#endif /* ipconfigTCP_SYN_COOKIES */
+
 			case FREERTOS_SO_CLOSE_AFTER_SEND:		/* As soon as the last byte has been transmitted, finalise the connection */
 				{
 					if( pxSocket->ucProtocol != ( uint8_t ) FREERTOS_IPPROTO_TCP )
@@ -227,6 +227,12 @@ static BaseType_t prvTCPPrepareConnect( FreeRTOS_Socket_t *pxSocket );
  */
 static void prvCheckOptions( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer );
 
+/*
+ * Reduce the MSS of a socket to the MSS announced by the peer, if that is
+ * smaller.
+ */
+static void prvAdoptPeerMSS( FreeRTOS_Socket_t *pxSocket, UBaseType_t uxNewMSS );
+
 /*
  * Set the initial properties in the options fields, like the preferred
  * value of MSS and whether SACK allowed.  Will be transmitted in the state
@@ -234,6 +240,12 @@ static void prvCheckOptions( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescripto
  */
 static UBaseType_t prvSetSynAckOptions( FreeRTOS_Socket_t *pxSocket, TCPPacket_t * pxTCPPacket );
 
+/*
+ * Write the options of a SYN or SYN+ACK: the MSS and, when xWinScaling is true,
+ * the window scale factor and SACK-permitted.  Returns their length in bytes.
+ */
+static UBaseType_t prvWriteSynOptions( TCPHeader_t *pxTCPHeader, uint16_t usMSS, BaseType_t xWinScaling, uint8_t ucWinScaleFactor );
+
 /*
  * For anti-hang protection and TCP keep-alive messages.  Called in two places:
  * after receiving a packet and after a state change.  The socket's alive timer
@@ -317,6 +329,12 @@ static BaseType_t prvTCPSendReset( NetworkBufferDescriptor_t *pxNetworkBuffer );
  */
 static void prvSocketSetMSS( FreeRTOS_Socket_t *pxSocket );
 
+/*
+ * Return the MSS to use for a peer, of which the IP address is given in network
+ * byte order.
+ */
+static uint32_t prvMSSForAddress( uint32_t ulIPAddress );
+
 /*
  * Return either a newly created socket, or the current socket in a connected
  * state (depends on the 'bReuseSocket' flag).
@@ -329,6 +347,46 @@ static FreeRTOS_Socket_t *prvHandleListen( FreeRTOS_Socket_t *pxSocket, NetworkB
  */
 static BaseType_t prvTCPSocketCopy( FreeRTOS_Socket_t *pxNewSocket, FreeRTOS_Socket_t *pxSocket );
 
+#if( ipconfigTCP_SYN_TABLE == 1 )
+	/*
+	 * Answer a SYN received by a listening socket from the socket's table of
+	 * half-open connections, or with a SYN cookie, without creating a socket.
+	 * Returns pdFALSE if the table can not be allocated, in which case the
+	 * SYN must be handled as usual.
+	 */
+	static BaseType_t prvSynTableHandleSyn( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer,
+		uint32_t ulInitialSequenceNumber );
+
+	/*
+	 * An ACK received by a listening socket may complete a handshake answered
+	 * by prvSynTableHandleSyn().  If so, the child socket is created and
+	 * returned in the eSYN_RECEIVED state, otherwise NULL is returned.
+	 */
+	static FreeRTOS_Socket_t *prvSynTableHandleAck( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer );
+
+	/*
+	 * Forget the half-open connection a RST received by a listening socket
+	 * refers to.
+	 */
+	static void prvSynTableHandleReset( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer );
+#endif /* ipconfigTCP_SYN_TABLE */
+
+#if( ipconfigTCP_TIME_WAIT_TABLE == 1 )
+	/*
+	 * Called when the FIN exchange of a socket has completed: remember the
+	 * connection in the TIME_WAIT table if this side closed it first, and
+	 * release the window segments the socket no longer needs.
+	 */
+	static void prvTimeWaitEnter( FreeRTOS_Socket_t *pxSocket );
+
+	/*
+	 * Handle a segment of a connection in the TIME_WAIT table.  Returns pdFALSE
+	 * if the segment does not belong to one, or is a SYN that starts a new
+	 * connection, in which case it must be handled as usual.
+	 */
+	static BaseType_t prvTimeWaitHandle( NetworkBufferDescriptor_t *pxNetworkBuffer );
+#endif /* ipconfigTCP_TIME_WAIT_TABLE */
+
 /*
  * prvTCPStatusAgeCheck() will see if the socket has been in a non-connected
  * state for too long.  If so, the socket will be closed, and -1 will be
@@ -346,7 +404,7 @@ static NetworkBufferDescriptor_t *prvTCPBufferResize( FreeRTOS_Socket_t *pxSocke
 #endif
 
 #if( ipconfigUSE_TCP_WIN != 0 )
-	static uint8_t prvWinScaleFactor( FreeRTOS_Socket_t *pxSocket );
+	static uint8_t prvWinScaleFactor( size_t uxRxWinSize, uint16_t usMSS );
 #endif
 
 /*
@@ -1139,7 +1197,6 @@ TCPPacket_t * pxTCPPacket;
 TCPHeader_t * pxTCPHeader;
 const unsigned char *pucPtr;
 const unsigned char *pucLast;
-TCPWindow_t *pxTCPWindow;
 UBaseType_t uxNewMSS;
 
 	pxTCPPacket = ( TCPPacket_t * ) ( pxNetworkBuffer->pucEthernetBuffer );
@@ -1148,7 +1205,6 @@ UBaseType_t uxNewMSS;
 	/* A character pointer to iterate through the option data */
 	pucPtr = pxTCPHeader->ucOptdata;
 	pucLast = pucPtr + (((pxTCPHeader->ucTCPOffset >> 4) - 5) << 2);
-	pxTCPWindow = &pxSocket->u.xTCP.xTCPWindow;
 
 	/* Validate options size calculation. */
 	if( pucLast > ( pxNetworkBuffer->pucEthernetBuffer + pxNetworkBuffer->xDataLength ) )
@@ -1218,23 +1274,7 @@ UBaseType_t uxNewMSS;
 				FreeRTOS_debug_printf( ( "MSS change %u -> %lu\n", pxSocket->u.xTCP.usInitMSS, uxNewMSS ) );
 			}
 
-			if( pxSocket->u.xTCP.usInitMSS > uxNewMSS )
-			{
-				/* our MSS was bigger than the MSS of the other party: adapt it. */
-				pxSocket->u.xTCP.bits.bMssChange = pdTRUE_UNSIGNED;
-				if( ( pxTCPWindow != NULL ) && ( pxSocket->u.xTCP.usCurMSS > uxNewMSS ) )
-				{
-					/* The peer advertises a smaller MSS than this socket was
-					using.  Use that as well. */
-					FreeRTOS_debug_printf( ( "Change mss %d => %lu\n", pxSocket->u.xTCP.usCurMSS, uxNewMSS ) );
-					pxSocket->u.xTCP.usCurMSS = ( uint16_t ) uxNewMSS;
-				}
-				pxTCPWindow->xSize.ulRxWindowLength = ( ( uint32_t ) uxNewMSS ) * ( pxTCPWindow->xSize.ulRxWindowLength / ( ( uint32_t ) uxNewMSS ) );
-				pxTCPWindow->usMSSInit = ( uint16_t ) uxNewMSS;
-				pxTCPWindow->usMSS = ( uint16_t ) uxNewMSS;
-				pxSocket->u.xTCP.usInitMSS = ( uint16_t ) uxNewMSS;
-				pxSocket->u.xTCP.usCurMSS = ( uint16_t ) uxNewMSS;
-			}
+			prvAdoptPeerMSS( pxSocket, uxNewMSS );
 
 			#if( ipconfigUSE_TCP_WIN != 1 )
 				/* Without scaled windows, MSS is the only interesting option. */
@@ -1316,15 +1356,39 @@ UBaseType_t uxNewMSS;
 }
 /*-----------------------------------------------------------*/
 
+static void prvAdoptPeerMSS( FreeRTOS_Socket_t *pxSocket, UBaseType_t uxNewMSS )
+{
+TCPWindow_t *pxTCPWindow = &pxSocket->u.xTCP.xTCPWindow;
+
+	if( pxSocket->u.xTCP.usInitMSS > uxNewMSS )
+	{
+		/* our MSS was bigger than the MSS of the other party: adapt it. */
+		pxSocket->u.xTCP.bits.bMssChange = pdTRUE_UNSIGNED;
+		if( ( pxTCPWindow != NULL ) && ( pxSocket->u.xTCP.usCurMSS > uxNewMSS ) )
+		{
+			/* The peer advertises a smaller MSS than this socket was
+			using.  Use that as well. */
+			FreeRTOS_debug_printf( ( "Change mss %d => %lu\n", pxSocket->u.xTCP.usCurMSS, uxNewMSS ) );
+			pxSocket->u.xTCP.usCurMSS = ( uint16_t ) uxNewMSS;
+		}
+		pxTCPWindow->xSize.ulRxWindowLength = ( ( uint32_t ) uxNewMSS ) * ( pxTCPWindow->xSize.ulRxWindowLength / ( ( uint32_t ) uxNewMSS ) );
+		pxTCPWindow->usMSSInit = ( uint16_t ) uxNewMSS;
+		pxTCPWindow->usMSS = ( uint16_t ) uxNewMSS;
+		pxSocket->u.xTCP.usInitMSS = ( uint16_t ) uxNewMSS;
+		pxSocket->u.xTCP.usCurMSS = ( uint16_t ) uxNewMSS;
+	}
+}
+/*-----------------------------------------------------------*/
+
 #if( ipconfigUSE_TCP_WIN != 0 )
 
-	static uint8_t prvWinScaleFactor( FreeRTOS_Socket_t *pxSocket )
+	static uint8_t prvWinScaleFactor( size_t uxRxWinSize, uint16_t usMSS )
 	{
 	size_t uxWinSize;
 	uint8_t ucFactor;
 
-		/* 'xTCP.uxRxWinSize' is the size of the reception window in units of MSS. */
-		uxWinSize = pxSocket->u.xTCP.uxRxWinSize * ( size_t ) pxSocket->u.xTCP.usInitMSS;
+		/* 'uxRxWinSize' is the size of the reception window in units of MSS. */
+		uxWinSize = uxRxWinSize * ( size_t ) usMSS;
 		ucFactor = 0u;
 		while( uxWinSize > 0xfffful )
 		{
@@ -1334,8 +1398,8 @@ UBaseType_t uxNewMSS;
 		}
 
 		FreeRTOS_debug_printf( ( "prvWinScaleFactor: uxRxWinSize %lu MSS %lu Factor %u\n",
-			pxSocket->u.xTCP.uxRxWinSize,
-			pxSocket->u.xTCP.usInitMSS,
+			uxRxWinSize,
+			usMSS,
 			ucFactor ) );
 
 		return ucFactor;
@@ -1351,8 +1415,22 @@ UBaseType_t uxNewMSS;
 */
 static UBaseType_t prvSetSynAckOptions( FreeRTOS_Socket_t *pxSocket, TCPPacket_t * pxTCPPacket )
 {
-TCPHeader_t *pxTCPHeader = &pxTCPPacket->xTCPHeader;
-uint16_t usMSS = pxSocket->u.xTCP.usInitMSS;
+	#if( ipconfigUSE_TCP_WIN != 0 )
+	{
+		pxSocket->u.xTCP.ucMyWinScaleFactor = prvWinScaleFactor( pxSocket->u.xTCP.uxRxWinSize, pxSocket->u.xTCP.usInitMSS );
+
+		return prvWriteSynOptions( &pxTCPPacket->xTCPHeader, pxSocket->u.xTCP.usInitMSS, pdTRUE, pxSocket->u.xTCP.ucMyWinScaleFactor );
+	}
+	#else
+	{
+		return prvWriteSynOptions( &pxTCPPacket->xTCPHeader, pxSocket->u.xTCP.usInitMSS, pdFALSE, 0u );
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvWriteSynOptions( TCPHeader_t *pxTCPHeader, uint16_t usMSS, BaseType_t xWinScaling, uint8_t ucWinScaleFactor )
+{
 UBaseType_t uxOptionsLength;
 
 	/* We send out the TCP Maximum Segment Size option with our SYN[+ACK]. */
@@ -1361,38 +1439,32 @@ UBaseType_t uxOptionsLength;
 	pxTCPHeader->ucOptdata[ 1 ] = ( uint8_t ) TCP_OPT_MSS_LEN;
 	pxTCPHeader->ucOptdata[ 2 ] = ( uint8_t ) ( usMSS >> 8 );
 	pxTCPHeader->ucOptdata[ 3 ] = ( uint8_t ) ( usMSS & 0xffu );
+	uxOptionsLength = 4u;
 
 	#if( ipconfigUSE_TCP_WIN != 0 )
 	{
-		pxSocket->u.xTCP.ucMyWinScaleFactor = prvWinScaleFactor( pxSocket );
-
-		pxTCPHeader->ucOptdata[ 4 ] = TCP_OPT_NOOP;
-		pxTCPHeader->ucOptdata[ 5 ] = ( uint8_t ) ( TCP_OPT_WSOPT );
-		pxTCPHeader->ucOptdata[ 6 ] = ( uint8_t ) ( TCP_OPT_WSOPT_LEN );
-		pxTCPHeader->ucOptdata[ 7 ] = ( uint8_t ) pxSocket->u.xTCP.ucMyWinScaleFactor;
-		uxOptionsLength = 8u;
+		if( xWinScaling != pdFALSE )
+		{
+			pxTCPHeader->ucOptdata[ 4 ] = TCP_OPT_NOOP;
+			pxTCPHeader->ucOptdata[ 5 ] = ( uint8_t ) ( TCP_OPT_WSOPT );
+			pxTCPHeader->ucOptdata[ 6 ] = ( uint8_t ) ( TCP_OPT_WSOPT_LEN );
+			pxTCPHeader->ucOptdata[ 7 ] = ucWinScaleFactor;
+
+			pxTCPHeader->ucOptdata[ 8 ] = TCP_OPT_NOOP;
+			pxTCPHeader->ucOptdata[ 9 ] = TCP_OPT_NOOP;
+			pxTCPHeader->ucOptdata[ 10 ] = TCP_OPT_SACK_P;	/* 4: Sack-Permitted Option. */
+			pxTCPHeader->ucOptdata[ 11 ] = 2;	/* 2: length of this option. */
+			uxOptionsLength = 12u;
+		}
 	}
 	#else
 	{
-		uxOptionsLength = 4u;
+		( void ) xWinScaling;
+		( void ) ucWinScaleFactor;
 	}
-	#endif
-
-	#if( ipconfigUSE_TCP_WIN == 0 )
-	{
-		return uxOptionsLength;
-	}
-	#else
-	{
-		pxTCPHeader->ucOptdata[ uxOptionsLength + 0 ] = TCP_OPT_NOOP;
-		pxTCPHeader->ucOptdata[ uxOptionsLength + 1 ] = TCP_OPT_NOOP;
-		pxTCPHeader->ucOptdata[ uxOptionsLength + 2 ] = TCP_OPT_SACK_P;	/* 4: Sack-Permitted Option. */
-		pxTCPHeader->ucOptdata[ uxOptionsLength + 3 ] = 2;	/* 2: length of this option. */
-		uxOptionsLength += 4u;
+	#endif	/* ipconfigUSE_TCP_WIN */
 
-		return uxOptionsLength; /* bytes, not words. */
-	}
-	#endif	/* ipconfigUSE_TCP_WIN == 0 */
+	return uxOptionsLength; /* bytes, not words. */
 }
 
 /*
@@ -2023,6 +2095,12 @@ uint32_t ulAckNr = FreeRTOS_ntohl( pxTCPHeader->ulAckNr );
 
 			/* And wait for the user to close this socket. */
 			vTCPStateChange( pxSocket, eCLOSE_WAIT );
+
+			#if( ipconfigTCP_TIME_WAIT_TABLE == 1 )
+			{
+				prvTimeWaitEnter( pxSocket );
+			}
+			#endif /* ipconfigTCP_TIME_WAIT_TABLE */
 		}
 	}
 
@@ -2862,17 +2940,25 @@ static BaseType_t prvTCPSendReset( NetworkBufferDescriptor_t *pxNetworkBuffer )
 }
 /*-----------------------------------------------------------*/
 
-static void prvSocketSetMSS( FreeRTOS_Socket_t *pxSocket )
+static uint32_t prvMSSForAddress( uint32_t ulIPAddress )
 {
 uint32_t ulMSS = ipconfigTCP_MSS;
 
-	if( ( ( FreeRTOS_ntohl( pxSocket->u.xTCP.ulRemoteIP ) ^ *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) != 0ul )
+	if( ( ( ulIPAddress ^ *ipLOCAL_IP_ADDRESS_POINTER ) & xNetworkAddressing.ulNetMask ) != 0ul )
 	{
 		/* Data for this peer will pass through a router, and maybe through
 		the internet.  Limit the MSS to 1400 bytes or less. */
 		ulMSS = FreeRTOS_min_uint32( ( uint32_t ) REDUCED_MSS_THROUGH_INTERNET, ulMSS );
 	}
 
+	return ulMSS;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSocketSetMSS( FreeRTOS_Socket_t *pxSocket )
+{
+uint32_t ulMSS = prvMSSForAddress( FreeRTOS_ntohl( pxSocket->u.xTCP.ulRemoteIP ) );
+
 	FreeRTOS_debug_printf( ( "prvSocketSetMSS: %lu bytes for %lxip:%u\n", ulMSS, pxSocket->u.xTCP.ulRemoteIP, pxSocket->u.xTCP.usRemotePort ) );
 
 	pxSocket->u.xTCP.usInitMSS = pxSocket->u.xTCP.usCurMSS = ( uint16_t ) ulMSS;
@@ -2900,6 +2986,7 @@ uint16_t xLocalPort;
 uint32_t ulRemoteIP;
 uint16_t xRemotePort;
 BaseType_t xResult = pdPASS;
+BaseType_t xTimeWait = pdFALSE;
 
 	/* Check for a minimum packet size. */
 	if( pxNetworkBuffer->xDataLength >= ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER ) )
@@ -2919,7 +3006,26 @@ BaseType_t xResult = pdPASS;
 		return pdFAIL;
 	}
 
-	if( ( pxSocket == NULL ) || ( prvTCPSocketIsActive( ( UBaseType_t ) pxSocket->u.xTCP.ucTCPState ) == pdFALSE ) )
+	#if( ipconfigTCP_TIME_WAIT_TABLE == 1 )
+	{
+		/* A connection in TIME_WAIT has either no socket anymore, in which
+		case a listening socket may be found, or a socket in eCLOSE_WAIT. */
+		if( ( pxSocket == NULL ) ||
+			( pxSocket->u.xTCP.ucTCPState == eTCP_LISTEN ) ||
+			( prvTCPSocketIsActive( ( UBaseType_t ) pxSocket->u.xTCP.ucTCPState ) == pdFALSE ) )
+		{
+			xTimeWait = prvTimeWaitHandle( pxNetworkBuffer );
+		}
+	}
+	#endif /* ipconfigTCP_TIME_WAIT_TABLE */
+
+	if( xTimeWait != pdFALSE )
+	{
+		/* The packet has been answered or dropped, and will be released by
+		the caller. */
+		xResult = pdFAIL;
+	}
+	else if( ( pxSocket == NULL ) || ( prvTCPSocketIsActive( ( UBaseType_t ) pxSocket->u.xTCP.ucTCPState ) == pdFALSE ) )
 	{
 		/* A TCP messages is received but either there is no socket with the
 		given port number or the there is a socket, but it is in one of these
@@ -2953,21 +3059,47 @@ BaseType_t xResult = pdPASS;
 			has set the SYN flag. */
 			if( ( ucTCPFlags & ipTCP_FLAG_CTRL ) != ipTCP_FLAG_SYN )
 			{
-				/* What happens: maybe after a reboot, a client doesn't know the
-				connection had gone.  Send a RST in order to get a new connect
-				request. */
-				#if( ipconfigHAS_DEBUG_PRINTF == 1 )
+			FreeRTOS_Socket_t *pxChildSocket = NULL;
+
+				#if( ipconfigTCP_SYN_TABLE == 1 )
 				{
-				FreeRTOS_debug_printf( ( "TCP: Server can't handle flags: %s from %lxip:%u to port %u\n",
-					prvTCPFlagMeaning( ( UBaseType_t ) ucTCPFlags ), ulRemoteIP, xRemotePort, xLocalPort ) );
+					/* The peer may be completing, or giving up on, a handshake
+					that has no socket yet. */
+					if( ( ucTCPFlags & ipTCP_FLAG_RST ) != 0u )
+					{
+						prvSynTableHandleReset( pxSocket, pxNetworkBuffer );
+					}
+					else
+					{
+						pxChildSocket = prvSynTableHandleAck( pxSocket, pxNetworkBuffer );
+					}
 				}
-				#endif /* ipconfigHAS_DEBUG_PRINTF */
+				#endif /* ipconfigTCP_SYN_TABLE */
 
-				if( ( ucTCPFlags & ipTCP_FLAG_RST ) == 0u )
+				if( pxChildSocket != NULL )
 				{
-					prvTCPSendReset( pxNetworkBuffer );
+					/* The ACK is handled by the new socket, which it will
+					connect. */
+					pxSocket = pxChildSocket;
+				}
+				else
+				{
+					/* What happens: maybe after a reboot, a client doesn't know the
+					connection had gone.  Send a RST in order to get a new connect
+					request. */
+					#if( ipconfigHAS_DEBUG_PRINTF == 1 )
+					{
+					FreeRTOS_debug_printf( ( "TCP: Server can't handle flags: %s from %lxip:%u to port %u\n",
+						prvTCPFlagMeaning( ( UBaseType_t ) ucTCPFlags ), ulRemoteIP, xRemotePort, xLocalPort ) );
+					}
+					#endif /* ipconfigHAS_DEBUG_PRINTF */
+
+					if( ( ucTCPFlags & ipTCP_FLAG_RST ) == 0u )
+					{
+						prvTCPSendReset( pxNetworkBuffer );
+					}
+					xResult = pdFAIL;
 				}
-				xResult = pdFAIL;
 			}
 			else
 			{
@@ -3080,6 +3212,7 @@ static FreeRTOS_Socket_t *prvHandleListen( FreeRTOS_Socket_t *pxSocket, NetworkB
 TCPPacket_t * pxTCPPacket = ( TCPPacket_t * ) ( pxNetworkBuffer->pucEthernetBuffer );
 FreeRTOS_Socket_t *pxReturn = NULL;
 uint32_t ulInitialSequenceNumber;
+BaseType_t xAnswered = pdFALSE;
 
 	/* Assume that a new Initial Sequence Number will be required. Request
 	it now in order to fail out if necessary. */
@@ -3106,7 +3239,19 @@ uint32_t ulInitialSequenceNumber;
 			new socket when a connection comes in. */
 			pxReturn = NULL;
 
-			if( pxSocket->u.xTCP.usChildCount >= pxSocket->u.xTCP.usBacklog )
+			#if( ipconfigTCP_SYN_TABLE == 1 )
+			{
+				/* Answer without creating the socket yet, it will be created
+				when the handshake completes. */
+				xAnswered = prvSynTableHandleSyn( pxSocket, pxNetworkBuffer, ulInitialSequenceNumber );
+			}
+			#endif /* ipconfigTCP_SYN_TABLE */
+
+			if( xAnswered != pdFALSE )
+			{
+				/* The packet will be released by the caller. */
+			}
+			else if( pxSocket->u.xTCP.usChildCount >= pxSocket->u.xTCP.usBacklog )
 			{
 				FreeRTOS_printf( ( "Check: Socket %u already has %u / %u child%s\n",
 					pxSocket->usLocalPort,
@@ -3253,6 +3398,776 @@ struct freertos_sockaddr xAddress;
 }
 /*-----------------------------------------------------------*/
 
+#if( ipconfigTCP_SYN_TABLE == 1 )
+
+	/* An entry of the table of half-open connections of a listening socket: a
+	SYN that has been answered with a SYN+ACK, of which the final ACK has not
+	arrived yet.  This is all that is kept of the connection until then, in
+	stead of a complete socket. */
+	typedef struct xSYN_TABLE_ENTRY
+	{
+		uint32_t ulRemoteIP;			/* The peer's IP address, in network byte order. */
+		uint32_t ulOurSequenceNumber;	/* The ISN sent in the SYN+ACK. */
+		uint32_t ulPeerSequenceNumber;	/* The ISN received in the SYN. */
+		TickType_t xReceiveTime;		/* The time at which the SYN was received. */
+		uint16_t usRemotePort;			/* The peer's port number, in network byte order. */
+		uint16_t usPeerMSS;				/* The MSS option of the SYN, or zero if it had none. */
+		uint8_t ucPeerWinScaleFactor;	/* The window scale option of the SYN. */
+		uint8_t ucMyWinScaleFactor;		/* The window scale option of the SYN+ACK. */
+		uint8_t ucFlags;				/* A combination of the tcpSYN_ENTRY_ flags. */
+	} SynTableEntry_t;
+
+	#define tcpSYN_ENTRY_IN_USE				( 0x01u )	/* The entry holds a half-open connection. */
+	#define tcpSYN_ENTRY_WIN_SCALING		( 0x02u )	/* The SYN had a window scale option. */
+
+	#define tcpSYN_TABLE_TIMEOUT_TICKS		( ( TickType_t ) pdMS_TO_TICKS( ipconfigTCP_SYN_TABLE_TIMEOUT_MS ) )
+
+	#if( ipconfigTCP_SYN_COOKIES == 1 )
+
+		/* A SYN cookie is the ISN sent in the SYN+ACK: the 5 lowest bits of the
+		time slot it was made in, the index of the peer's MSS in
+		usSynCookieMSS[], and the lowest 24 bits of a SipHash-2-4 of the
+		connection, the peer's ISN, the time slot and the index.  A time slot
+		lasts ipconfigTCP_SYN_TABLE_TIMEOUT_MS, and a cookie made in the current
+		or the previous slot is accepted. */
+		#define tcpSYN_COOKIE_SLOT_SHIFT	( 27u )
+		#define tcpSYN_COOKIE_SLOT_MASK		( 0x1fUL )
+		#define tcpSYN_COOKIE_MSS_SHIFT		( 24u )
+		#define tcpSYN_COOKIE_MSS_MASK		( 0x07UL )
+		#define tcpSYN_COOKIE_HASH_MASK		( 0x00ffffffUL )
+
+		#define tcpROTATE_LEFT_64( ullValue, uxBits )	( ( ( ullValue ) << ( uxBits ) ) | ( ( ullValue ) >> ( 64u - ( uxBits ) ) ) )
+
+		/* The MSS values a SYN cookie can encode. */
+		static const uint16_t usSynCookieMSS[ tcpSYN_COOKIE_MSS_MASK + 1u ] = { 216u, 536u, 1024u, 1200u, 1300u, 1360u, 1440u, 1460u };
+
+		/* The secret key of the SYN cookies, chosen when the first one is made. */
+		static uint64_t ullSynCookieKey[ 2 ];
+		static BaseType_t xSynCookieKeySet = pdFALSE;
+
+	#endif /* ipconfigTCP_SYN_COOKIES */
+
+	/*-----------------------------------------------------------*/
+
+	/*
+	 * Read the MSS and window scale options of a SYN, as prvCheckOptions() would
+	 * for a socket.
+	 */
+	static void prvSynTableReadOptions( const NetworkBufferDescriptor_t *pxNetworkBuffer, SynTableEntry_t *pxEntry )
+	{
+	const TCPHeader_t *pxTCPHeader = &( ( const TCPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer )->xTCPHeader;
+	const uint8_t *pucPtr = pxTCPHeader->ucOptdata;
+	const uint8_t *pucLast = pucPtr + ( ( ( pxTCPHeader->ucTCPOffset >> 4 ) - 5 ) << 2 );
+	UBaseType_t uxRemaining, uxLength;
+
+		if( pucLast > ( pxNetworkBuffer->pucEthernetBuffer + pxNetworkBuffer->xDataLength ) )
+		{
+			/* The options don't fit in the packet, ignore them. */
+			pucLast = pucPtr;
+		}
+
+		while( pucPtr < pucLast )
+		{
+			uxRemaining = ( UBaseType_t ) ( pucLast - pucPtr );
+
+			if( pucPtr[ 0 ] == TCP_OPT_END )
+			{
+				break;
+			}
+
+			if( pucPtr[ 0 ] == TCP_OPT_NOOP )
+			{
+				pucPtr++;
+				continue;
+			}
+
+			/* All other options have a length field. */
+			uxLength = ( uxRemaining >= 2u ) ? pucPtr[ 1 ] : 0u;
+			if( ( uxLength < 2u ) || ( uxLength > uxRemaining ) )
+			{
+				break;
+			}
+
+			if( ( pucPtr[ 0 ] == TCP_OPT_MSS ) && ( uxLength == TCP_OPT_MSS_LEN ) )
+			{
+				pxEntry->usPeerMSS = usChar2u16( pucPtr + 2 );
+			}
+			else if( ( pucPtr[ 0 ] == TCP_OPT_WSOPT ) && ( uxLength == TCP_OPT_WSOPT_LEN ) )
+			{
+				pxEntry->ucPeerWinScaleFactor = pucPtr[ 2 ];
+				pxEntry->ucFlags |= tcpSYN_ENTRY_WIN_SCALING;
+			}
+
+			pucPtr += uxLength;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	/*
+	 * The MSS a child socket for the peer would use, given the MSS option of the
+	 * peer's SYN.
+	 */
+	static uint16_t prvSynTableMSS( const TCPPacket_t *pxTCPPacket, uint16_t usPeerMSS )
+	{
+	uint32_t ulMSS = prvMSSForAddress( pxTCPPacket->xIPHeader.ulSourceIPAddress );
+
+		if( usPeerMSS != 0u )
+		{
+			ulMSS = FreeRTOS_min_uint32( ulMSS, ( uint32_t ) usPeerMSS );
+		}
+
+		return ( uint16_t ) ulMSS;
+	}
+	/*-----------------------------------------------------------*/
+
+	/*
+	 * Answer a SYN with a SYN+ACK, built in the network buffer of the SYN if it
+	 * is large enough.  The window is the one a child socket would advertise,
+	 * but not scaled, as it must not be in a SYN segment.
+	 */
+	static void prvSynTableSendSynAck( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer,
+		uint32_t ulOurSequenceNumber, uint16_t usMSS, BaseType_t xWinScaling, uint8_t ucWinScaleFactor )
+	{
+	NetworkBufferDescriptor_t *pxReplyBuffer = pxNetworkBuffer;
+	TCPPacket_t *pxTCPPacket;
+	uint32_t ulPeerSequenceNumber, ulWindow;
+	UBaseType_t uxOptionsLength;
+	BaseType_t xReleaseAfterSend = pdFALSE;
+	const size_t uxHeaderLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER;
+	size_t uxNeeded = uxHeaderLength + 4u;
+
+		#if( ipconfigUSE_TCP_WIN != 0 )
+		{
+			if( xWinScaling != pdFALSE )
+			{
+				uxNeeded = uxHeaderLength + 12u;
+			}
+		}
+		#endif
+
+		if( ( xBufferAllocFixedSize == pdFALSE ) && ( pxNetworkBuffer->xDataLength < uxNeeded ) )
+		{
+			/* The SYN had fewer options than the SYN+ACK will have. */
+			pxReplyBuffer = pxGetNetworkBufferWithDescriptor( uxNeeded, 0u );
+
+			if( pxReplyBuffer != NULL )
+			{
+				memcpy( pxReplyBuffer->pucEthernetBuffer, pxNetworkBuffer->pucEthernetBuffer, uxHeaderLength );
+				xReleaseAfterSend = pdTRUE;
+			}
+		}
+
+		if( pxReplyBuffer != NULL )
+		{
+			pxTCPPacket = ( TCPPacket_t * ) pxReplyBuffer->pucEthernetBuffer;
+			ulPeerSequenceNumber = FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulSequenceNumber );
+
+			/* As prvTCPCreateWindow() and prvSendData() would calculate it. */
+			ulWindow = ( ( ( uint32_t ) ( ipconfigTCP_MSS * pxSocket->u.xTCP.uxRxWinSize ) ) / usMSS ) * usMSS;
+			ulWindow = FreeRTOS_min_uint32( ulWindow, ( uint32_t ) pxSocket->u.xTCP.uxRxStreamSize );
+			ulWindow = FreeRTOS_min_uint32( ulWindow, 0xfffcUL );
+
+			uxOptionsLength = prvWriteSynOptions( &pxTCPPacket->xTCPHeader, usMSS, xWinScaling, ucWinScaleFactor );
+			pxTCPPacket->xTCPHeader.ucTCPFlags = ( uint8_t ) ( ipTCP_FLAG_SYN | ipTCP_FLAG_ACK );
+			pxTCPPacket->xTCPHeader.ucTCPOffset = ( uint8_t ) ( ( ipSIZE_OF_TCP_HEADER + uxOptionsLength ) << 2 );
+			pxTCPPacket->xTCPHeader.usWindow = FreeRTOS_htons( ( uint16_t ) ulWindow );
+			pxTCPPacket->xTCPHeader.usUrgent = 0u;
+
+			/* Without a socket, prvTCPReturnPacket() swaps the sequence and
+			the acknowledgement number. */
+			pxTCPPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( ulPeerSequenceNumber + 1u );
+			pxTCPPacket->xTCPHeader.ulAckNr = FreeRTOS_htonl( ulOurSequenceNumber );
+
+			pxReplyBuffer->xDataLength = uxHeaderLength + uxOptionsLength;
+			prvTCPReturnPacket( NULL, pxReplyBuffer, ( uint32_t ) ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER + uxOptionsLength ), xReleaseAfterSend );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	#if( ipconfigTCP_SYN_COOKIES == 1 )
+
+		static void prvSipRounds( uint64_t *pullState, BaseType_t xRounds )
+		{
+			while( xRounds-- > 0 )
+			{
+				pullState[ 0 ] += pullState[ 1 ];
+				pullState[ 1 ] = tcpROTATE_LEFT_64( pullState[ 1 ], 13u ) ^ pullState[ 0 ];
+				pullState[ 0 ] = tcpROTATE_LEFT_64( pullState[ 0 ], 32u );
+				pullState[ 2 ] += pullState[ 3 ];
+				pullState[ 3 ] = tcpROTATE_LEFT_64( pullState[ 3 ], 16u ) ^ pullState[ 2 ];
+				pullState[ 0 ] += pullState[ 3 ];
+				pullState[ 3 ] = tcpROTATE_LEFT_64( pullState[ 3 ], 21u ) ^ pullState[ 0 ];
+				pullState[ 2 ] += pullState[ 1 ];
+				pullState[ 1 ] = tcpROTATE_LEFT_64( pullState[ 1 ], 17u ) ^ pullState[ 2 ];
+				pullState[ 2 ] = tcpROTATE_LEFT_64( pullState[ 2 ], 32u );
+			}
+		}
+		/*-----------------------------------------------------------*/
+
+		/*
+		 * Make the SYN cookie for the connection of a SYN or of its final ACK,
+		 * both as received.
+		 */
+		static uint32_t prvSynCookie( const TCPPacket_t *pxTCPPacket, uint32_t ulPeerSequenceNumber, uint32_t ulSlot, uint32_t ulMSSIndex )
+		{
+		uint64_t ullMessage[ 3 ];
+		uint64_t ullState[ 4 ];
+		uint64_t ullLast;
+		BaseType_t xIndex;
+
+			/* SipHash-2-4 of a 24-byte message. */
+			ullMessage[ 0 ] = ( ( ( uint64_t ) pxTCPPacket->xIPHeader.ulSourceIPAddress ) << 32 ) | pxTCPPacket->xIPHeader.ulDestinationIPAddress;
+			ullMessage[ 1 ] = ( ( ( uint64_t ) pxTCPPacket->xTCPHeader.usSourcePort ) << 48 ) |
+							  ( ( ( uint64_t ) pxTCPPacket->xTCPHeader.usDestinationPort ) << 32 ) | ulPeerSequenceNumber;
+			ullMessage[ 2 ] = ( ( ( uint64_t ) ulSlot ) << 8 ) | ulMSSIndex;
+			ullLast = ( ( uint64_t ) sizeof( ullMessage ) ) << 56;
+
+			ullState[ 0 ] = ullSynCookieKey[ 0 ] ^ 0x736f6d6570736575ULL;
+			ullState[ 1 ] = ullSynCookieKey[ 1 ] ^ 0x646f72616e646f6dULL;
+			ullState[ 2 ] = ullSynCookieKey[ 0 ] ^ 0x6c7967656e657261ULL;
+			ullState[ 3 ] = ullSynCookieKey[ 1 ] ^ 0x7465646279746573ULL;
+
+			for( xIndex = 0; xIndex < ( BaseType_t ) ARRAY_SIZE( ullMessage ); xIndex++ )
+			{
+				ullState[ 3 ] ^= ullMessage[ xIndex ];
+				prvSipRounds( ullState, 2 );
+				ullState[ 0 ] ^= ullMessage[ xIndex ];
+			}
+
+			ullState[ 3 ] ^= ullLast;
+			prvSipRounds( ullState, 2 );
+			ullState[ 0 ] ^= ullLast;
+			ullState[ 2 ] ^= 0xffu;
+			prvSipRounds( ullState, 4 );
+
+			return ( ( ulSlot & tcpSYN_COOKIE_SLOT_MASK ) << tcpSYN_COOKIE_SLOT_SHIFT ) |
+				   ( ulMSSIndex << tcpSYN_COOKIE_MSS_SHIFT ) |
+				   ( ( uint32_t ) ( ullState[ 0 ] ^ ullState[ 1 ] ^ ullState[ 2 ] ^ ullState[ 3 ] ) & tcpSYN_COOKIE_HASH_MASK );
+		}
+		/*-----------------------------------------------------------*/
+
+		static uint32_t prvSynCookieSlot( void )
+		{
+			return ( uint32_t ) ( xTaskGetTickCount() / tcpSYN_TABLE_TIMEOUT_TICKS );
+		}
+		/*-----------------------------------------------------------*/
+
+		/*
+		 * Answer a SYN with a SYN cookie.  The connection does not use window
+		 * scaling, as the cookie has no room for the peer's factor.
+		 */
+		static void prvSynCookieSendSynAck( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer, uint16_t usPeerMSS )
+		{
+		const TCPPacket_t *pxTCPPacket = ( const TCPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer;
+		uint32_t ulMSSIndex = tcpSYN_COOKIE_MSS_MASK;
+		uint32_t ulCookie;
+
+			if( xSynCookieKeySet == pdFALSE )
+			{
+				ullSynCookieKey[ 0 ] = ( ( ( uint64_t ) ipconfigRAND32() ) << 32 ) | ipconfigRAND32();
+				ullSynCookieKey[ 1 ] = ( ( ( uint64_t ) ipconfigRAND32() ) << 32 ) | ipconfigRAND32();
+				xSynCookieKeySet = pdTRUE;
+			}
+
+			if( usPeerMSS == 0u )
+			{
+				/* Without the option, the peer's MSS is 536 bytes. */
+				usPeerMSS = 536u;
+			}
+
+			/* The largest MSS the cookie can encode that does not exceed the
+			peer's.  The caller makes sure the peer's MSS is at least
+			usSynCookieMSS[ 0 ]. */
+			configASSERT( usPeerMSS >= usSynCookieMSS[ 0 ] );
+			while( ( ulMSSIndex > 0u ) && ( usSynCookieMSS[ ulMSSIndex ] > usPeerMSS ) )
+			{
+				ulMSSIndex--;
+			}
+
+			ulCookie = prvSynCookie( pxTCPPacket, FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulSequenceNumber ), prvSynCookieSlot(), ulMSSIndex );
+			prvSynTableSendSynAck( pxSocket, pxNetworkBuffer, ulCookie, prvSynTableMSS( pxTCPPacket, usSynCookieMSS[ ulMSSIndex ] ), pdFALSE, 0u );
+		}
+		/*-----------------------------------------------------------*/
+
+		/*
+		 * Check if the final ACK of a handshake carries a valid SYN cookie, and if
+		 * so fill in pxEntry.
+		 */
+		static BaseType_t prvSynCookieCheck( const TCPPacket_t *pxTCPPacket, SynTableEntry_t *pxEntry )
+		{
+		uint32_t ulCookie = FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulAckNr ) - 1u;
+		uint32_t ulPeerSequenceNumber = FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulSequenceNumber ) - 1u;
+		uint32_t ulMSSIndex = ( ulCookie >> tcpSYN_COOKIE_MSS_SHIFT ) & tcpSYN_COOKIE_MSS_MASK;
+		uint32_t ulSlot = prvSynCookieSlot();
+		BaseType_t xReturn = pdFALSE;
+
+			if( ( ulSlot & tcpSYN_COOKIE_SLOT_MASK ) != ( ulCookie >> tcpSYN_COOKIE_SLOT_SHIFT ) )
+			{
+				/* It may have been made in the previous slot. */
+				ulSlot--;
+			}
+
+			if( ( xSynCookieKeySet != pdFALSE ) &&
+				( ( ulSlot & tcpSYN_COOKIE_SLOT_MASK ) == ( ulCookie >> tcpSYN_COOKIE_SLOT_SHIFT ) ) &&
+				( prvSynCookie( pxTCPPacket, ulPeerSequenceNumber, ulSlot, ulMSSIndex ) == ulCookie ) )
+			{
+				memset( pxEntry, '\0', sizeof( *pxEntry ) );
+				pxEntry->ulOurSequenceNumber = ulCookie;
+				pxEntry->ulPeerSequenceNumber = ulPeerSequenceNumber;
+				pxEntry->usPeerMSS = usSynCookieMSS[ ulMSSIndex ];
+				xReturn = pdTRUE;
+			}
+
+			return xReturn;
+		}
+
+	#endif /* ipconfigTCP_SYN_COOKIES */
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvSynTableHandleSyn( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer,
+		uint32_t ulInitialSequenceNumber )
+	{
+	const TCPPacket_t *pxTCPPacket = ( const TCPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer;
+	SynTableEntry_t *pxEntry, *pxFree = NULL, *pxFound = NULL;
+	SynTableEntry_t xSyn;
+	const TickType_t xNow = xTaskGetTickCount();
+	UBaseType_t uxIndex, uxHalfOpen = 0u;
+	uint16_t usMSS;
+	BaseType_t xReturn = pdTRUE;
+
+		if( ( pxSocket->u.xTCP.pxSynTable == NULL ) && ( pxSocket->u.xTCP.usBacklog != 0u ) )
+		{
+			/* The table is created when the first SYN arrives, so that only the
+			IP-task accesses it.  It is freed by vSocketClose(). */
+			pxSocket->u.xTCP.pxSynTable = ( SynTableEntry_t * ) pvPortMalloc( pxSocket->u.xTCP.usBacklog * sizeof( SynTableEntry_t ) );
+
+			if( pxSocket->u.xTCP.pxSynTable != NULL )
+			{
+				memset( pxSocket->u.xTCP.pxSynTable, '\0', pxSocket->u.xTCP.usBacklog * sizeof( SynTableEntry_t ) );
+			}
+		}
+
+		if( pxSocket->u.xTCP.pxSynTable == NULL )
+		{
+			xReturn = pdFALSE;
+		}
+		else
+		{
+			memset( &xSyn, '\0', sizeof( xSyn ) );
+			xSyn.ulRemoteIP = pxTCPPacket->xIPHeader.ulSourceIPAddress;
+			xSyn.usRemotePort = pxTCPPacket->xTCPHeader.usSourcePort;
+			xSyn.ulPeerSequenceNumber = FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulSequenceNumber );
+			prvSynTableReadOptions( pxNetworkBuffer, &xSyn );
+
+			/* Forget the connections that were not completed in time, count the
+			others, and see if the peer has sent a SYN before. */
+			for( uxIndex = 0u; uxIndex < pxSocket->u.xTCP.usBacklog; uxIndex++ )
+			{
+				pxEntry = &( pxSocket->u.xTCP.pxSynTable[ uxIndex ] );
+
+				if( ( ( pxEntry->ucFlags & tcpSYN_ENTRY_IN_USE ) != 0u ) && ( ( xNow - pxEntry->xReceiveTime ) > tcpSYN_TABLE_TIMEOUT_TICKS ) )
+				{
+					pxEntry->ucFlags = 0u;
+				}
+
+				if( ( pxEntry->ucFlags & tcpSYN_ENTRY_IN_USE ) == 0u )
+				{
+					if( pxFree == NULL )
+					{
+						pxFree = pxEntry;
+					}
+				}
+				else if( ( pxEntry->ulRemoteIP == xSyn.ulRemoteIP ) && ( pxEntry->usRemotePort == xSyn.usRemotePort ) )
+				{
+					pxFound = pxEntry;
+				}
+				else
+				{
+					uxHalfOpen++;
+				}
+			}
+
+			if( ( pxFound != NULL ) && ( pxFound->ulPeerSequenceNumber == xSyn.ulPeerSequenceNumber ) )
+			{
+				/* The peer repeats its SYN, probably because the SYN+ACK was
+				lost.  Send the same SYN+ACK again. */
+				prvSynTableSendSynAck( pxSocket, pxNetworkBuffer, pxFound->ulOurSequenceNumber,
+					prvSynTableMSS( pxTCPPacket, pxFound->usPeerMSS ), pdTRUE, pxFound->ucMyWinScaleFactor );
+			}
+			else
+			{
+				if( pxFound != NULL )
+				{
+					/* A new connection from the same port replaces the old one. */
+					pxFree = pxFound;
+				}
+
+				if( ( pxFree != NULL ) && ( ( uxHalfOpen + pxSocket->u.xTCP.usChildCount ) < pxSocket->u.xTCP.usBacklog ) )
+				{
+					usMSS = prvSynTableMSS( pxTCPPacket, xSyn.usPeerMSS );
+
+					xSyn.ulOurSequenceNumber = ulInitialSequenceNumber;
+					xSyn.xReceiveTime = xNow;
+					xSyn.ucFlags |= tcpSYN_ENTRY_IN_USE;
+					#if( ipconfigUSE_TCP_WIN != 0 )
+					{
+						xSyn.ucMyWinScaleFactor = prvWinScaleFactor( pxSocket->u.xTCP.uxRxWinSize, usMSS );
+					}
+					#endif
+					*pxFree = xSyn;
+
+					prvSynTableSendSynAck( pxSocket, pxNetworkBuffer, xSyn.ulOurSequenceNumber, usMSS, pdTRUE, xSyn.ucMyWinScaleFactor );
+				}
+				#if( ipconfigTCP_SYN_COOKIES == 1 )
+				/* A peer that advertises an MSS below the smallest one a cookie
+				can encode is refused like any other SYN when the backlog is
+				full, rather than sent larger segments than it asked for. */
+				else if( ( pxSocket->u.xTCP.bits.bSynCookies != pdFALSE_UNSIGNED ) &&
+						 ( ( xSyn.usPeerMSS == 0u ) || ( xSyn.usPeerMSS >= usSynCookieMSS[ 0 ] ) ) )
+				{
+					prvSynCookieSendSynAck( pxSocket, pxNetworkBuffer, xSyn.usPeerMSS );
+				}
+				#endif /* ipconfigTCP_SYN_COOKIES */
+				else
+				{
+					/* Not logged with FreeRTOS_printf() as under a SYN flood
+					this happens for nearly every packet. */
+					FreeRTOS_debug_printf( ( "Check: Socket %u already has %u / %u child%s and %u half-open\n",
+						pxSocket->usLocalPort,
+						pxSocket->u.xTCP.usChildCount,
+						pxSocket->u.xTCP.usBacklog,
+						pxSocket->u.xTCP.usChildCount == 1 ? "" : "ren",
+						( unsigned ) uxHalfOpen ) );
+					prvTCPSendReset( pxNetworkBuffer );
+				}
+			}
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	/*
+	 * Find the entry of the half-open connection a segment received by a
+	 * listening socket belongs to, or NULL.
+	 */
+	static SynTableEntry_t *prvSynTableFind( FreeRTOS_Socket_t *pxSocket, const TCPPacket_t *pxTCPPacket )
+	{
+	SynTableEntry_t *pxEntry, *pxReturn = NULL;
+	UBaseType_t uxIndex;
+
+		if( pxSocket->u.xTCP.pxSynTable != NULL )
+		{
+			for( uxIndex = 0u; uxIndex < pxSocket->u.xTCP.usBacklog; uxIndex++ )
+			{
+				pxEntry = &( pxSocket->u.xTCP.pxSynTable[ uxIndex ] );
+
+				if( ( ( pxEntry->ucFlags & tcpSYN_ENTRY_IN_USE ) != 0u ) &&
+					( pxEntry->ulRemoteIP == pxTCPPacket->xIPHeader.ulSourceIPAddress ) &&
+					( pxEntry->usRemotePort == pxTCPPacket->xTCPHeader.usSourcePort ) &&
+					( ( xTaskGetTickCount() - pxEntry->xReceiveTime ) <= tcpSYN_TABLE_TIMEOUT_TICKS ) &&
+					( FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulSequenceNumber ) == ( pxEntry->ulPeerSequenceNumber + 1u ) ) )
+				{
+					pxReturn = pxEntry;
+					break;
+				}
+			}
+		}
+
+		return pxReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static FreeRTOS_Socket_t *prvSynTableHandleAck( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer )
+	{
+	const TCPPacket_t *pxTCPPacket = ( const TCPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer;
+	TCPWindow_t *pxTCPWindow;
+	FreeRTOS_Socket_t *pxNewSocket, *pxReturn = NULL;
+	SynTableEntry_t *pxFound;
+	SynTableEntry_t xEntry;
+	BaseType_t xFound = pdFALSE;
+
+		/* Only a plain ACK is expected, as in prvHandleSynReceived(). */
+		if( ( pxSocket->u.xTCP.bits.bReuseSocket == pdFALSE_UNSIGNED ) &&
+			( ( pxTCPPacket->xTCPHeader.ucTCPFlags & 0x17u ) == ipTCP_FLAG_ACK ) )
+		{
+			pxFound = prvSynTableFind( pxSocket, pxTCPPacket );
+
+			if( ( pxFound != NULL ) && ( FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulAckNr ) == ( pxFound->ulOurSequenceNumber + 1u ) ) )
+			{
+				xEntry = *pxFound;
+				pxFound->ucFlags = 0u;
+				xFound = pdTRUE;
+			}
+			#if( ipconfigTCP_SYN_COOKIES == 1 )
+			else if( pxSocket->u.xTCP.bits.bSynCookies != pdFALSE_UNSIGNED )
+			{
+				xFound = prvSynCookieCheck( pxTCPPacket, &xEntry );
+			}
+			#endif /* ipconfigTCP_SYN_COOKIES */
+		}
+
+		if( xFound == pdFALSE )
+		{
+			/* Not a handshake this socket knows of. */
+		}
+		else if( pxSocket->u.xTCP.usChildCount >= pxSocket->u.xTCP.usBacklog )
+		{
+			FreeRTOS_debug_printf( ( "Check: Socket %u already has %u / %u child%s\n",
+				pxSocket->usLocalPort,
+				pxSocket->u.xTCP.usChildCount,
+				pxSocket->u.xTCP.usBacklog,
+				pxSocket->u.xTCP.usChildCount == 1 ? "" : "ren" ) );
+		}
+		else
+		{
+			pxNewSocket = ( FreeRTOS_Socket_t * ) FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+
+			if( ( pxNewSocket == NULL ) || ( pxNewSocket == FREERTOS_INVALID_SOCKET ) )
+			{
+				FreeRTOS_debug_printf( ( "TCP: Listen: new socket failed\n" ) );
+			}
+			else if( prvTCPSocketCopy( pxNewSocket, pxSocket ) != pdFALSE )
+			{
+				pxReturn = pxNewSocket;
+				pxTCPWindow = &( pxReturn->u.xTCP.xTCPWindow );
+
+				/* Set up the socket as prvHandleListen() and prvCheckOptions()
+				would have when the SYN arrived... */
+				pxReturn->u.xTCP.usRemotePort = FreeRTOS_htons( pxTCPPacket->xTCPHeader.usSourcePort );
+				pxReturn->u.xTCP.ulRemoteIP = FreeRTOS_htonl( pxTCPPacket->xIPHeader.ulSourceIPAddress );
+				pxTCPWindow->ulOurSequenceNumber = xEntry.ulOurSequenceNumber;
+				pxTCPWindow->rx.ulCurrentSequenceNumber = xEntry.ulPeerSequenceNumber;
+				prvSocketSetMSS( pxReturn );
+				prvTCPCreateWindow( pxReturn );
+
+				if( xEntry.usPeerMSS != 0u )
+				{
+					prvAdoptPeerMSS( pxReturn, xEntry.usPeerMSS );
+				}
+
+				#if( ipconfigUSE_TCP_WIN != 0 )
+				{
+					if( ( xEntry.ucFlags & tcpSYN_ENTRY_WIN_SCALING ) != 0u )
+					{
+						pxReturn->u.xTCP.ucPeerWinScaleFactor = xEntry.ucPeerWinScaleFactor;
+						pxReturn->u.xTCP.bits.bWinScaling = pdTRUE_UNSIGNED;
+					}
+					pxReturn->u.xTCP.ucMyWinScaleFactor = xEntry.ucMyWinScaleFactor;
+				}
+				#endif /* ipconfigUSE_TCP_WIN */
+
+				/* ...and as it would be after sending the SYN+ACK in the
+				eSYN_FIRST state.  The ACK itself is handled by
+				prvHandleSynReceived(). */
+				vTCPStateChange( pxReturn, eSYN_RECEIVED );
+				pxTCPWindow->rx.ulCurrentSequenceNumber = pxTCPWindow->rx.ulHighestSequenceNumber = xEntry.ulPeerSequenceNumber + 1u;
+				pxTCPWindow->tx.ulCurrentSequenceNumber = pxTCPWindow->ulNextTxSequenceNumber = pxTCPWindow->tx.ulFirstSequenceNumber + 1u;
+				pxReturn->u.xTCP.ulRxCurWinSize = FreeRTOS_min_uint32( pxTCPWindow->xSize.ulRxWindowLength, ( uint32_t ) pxReturn->u.xTCP.uxRxStreamSize );
+				pxReturn->u.xTCP.ulHighestRxAllowed = pxTCPWindow->rx.ulCurrentSequenceNumber + pxReturn->u.xTCP.ulRxCurWinSize;
+
+				/* Make a copy of the header up to the TCP header.  It is needed
+				later on, whenever data must be sent to the peer. */
+				memcpy( pxReturn->u.xTCP.xPacket.u.ucLastPacket, pxNetworkBuffer->pucEthernetBuffer, sizeof( pxReturn->u.xTCP.xPacket.u.ucLastPacket ) );
+			}
+		}
+
+		return pxReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvSynTableHandleReset( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer )
+	{
+	SynTableEntry_t *pxFound = prvSynTableFind( pxSocket, ( const TCPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer );
+
+		/* The peer did not ask for the connection, or gave up on it. */
+		if( pxFound != NULL )
+		{
+			pxFound->ucFlags = 0u;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* ipconfigTCP_SYN_TABLE */
+
+#if( ipconfigTCP_TIME_WAIT_TABLE == 1 )
+
+	/* A connection in TIME_WAIT: this side sent the first FIN, and both FINs
+	have been acknowledged.  This is all that is kept of it once the socket has
+	been closed. */
+	typedef struct xTIME_WAIT_ENTRY
+	{
+		uint32_t ulRemoteIP;		/* The peer's IP address, in network byte order. */
+		uint32_t ulSendNext;		/* The sequence number following our FIN. */
+		uint32_t ulReceiveNext;		/* The sequence number following the peer's FIN. */
+		TickType_t xEntryTime;		/* The time the exchange completed, or the peer last repeated its FIN. */
+		uint16_t usLocalPort;		/* Our port number, in network byte order, or zero when the entry is free. */
+		uint16_t usRemotePort;		/* The peer's port number, in network byte order. */
+	} TimeWaitEntry_t;
+
+	#define tcpTIME_WAIT_TICKS		( ( TickType_t ) pdMS_TO_TICKS( ipconfigTCP_TIME_WAIT_MS ) )
+
+	/* A connection is stored in one of this many entries, starting at the
+	one selected by the hash of its addresses and ports. */
+	#define tcpTIME_WAIT_PROBES		( ( ipconfigTCP_TIME_WAIT_ENTRIES < 4 ) ? ipconfigTCP_TIME_WAIT_ENTRIES : 4 )
+
+	/* Only accessed by the IP-task. */
+	static TimeWaitEntry_t xTimeWaitTable[ ipconfigTCP_TIME_WAIT_ENTRIES ];
+
+	/*-----------------------------------------------------------*/
+
+	static UBaseType_t prvTimeWaitHash( uint32_t ulRemoteIP, uint16_t usLocalPort, uint16_t usRemotePort )
+	{
+	uint32_t ulHash;
+
+		/* Fibonacci hashing: the multiplication mixes all bits into the
+		upper half. */
+		ulHash = ulRemoteIP ^ ( ( ( uint32_t ) usRemotePort << 16 ) | usLocalPort );
+		ulHash *= 0x9E3779B1UL;
+
+		return ( UBaseType_t ) ( ( ulHash >> 16 ) % ( uint32_t ) ipconfigTCP_TIME_WAIT_ENTRIES );
+	}
+	/*-----------------------------------------------------------*/
+
+	/*
+	 * Find the entry of a connection, all values in network byte order.
+	 * Entries that expired are freed on the way.
+	 */
+	static TimeWaitEntry_t *prvTimeWaitFind( uint32_t ulRemoteIP, uint16_t usLocalPort, uint16_t usRemotePort )
+	{
+	TimeWaitEntry_t *pxEntry, *pxReturn = NULL;
+	const TickType_t xNow = xTaskGetTickCount();
+	UBaseType_t uxIndex = prvTimeWaitHash( ulRemoteIP, usLocalPort, usRemotePort );
+	UBaseType_t uxProbe;
+
+		for( uxProbe = 0u; uxProbe < ( UBaseType_t ) tcpTIME_WAIT_PROBES; uxProbe++ )
+		{
+			pxEntry = &( xTimeWaitTable[ ( uxIndex + uxProbe ) % ( UBaseType_t ) ipconfigTCP_TIME_WAIT_ENTRIES ] );
+
+			if( ( pxEntry->usLocalPort != 0u ) && ( ( xNow - pxEntry->xEntryTime ) > tcpTIME_WAIT_TICKS ) )
+			{
+				pxEntry->usLocalPort = 0u;
+			}
+
+			if( ( pxEntry->usLocalPort == usLocalPort ) &&
+				( pxEntry->usRemotePort == usRemotePort ) &&
+				( pxEntry->ulRemoteIP == ulRemoteIP ) )
+			{
+				pxReturn = pxEntry;
+				break;
+			}
+		}
+
+		return pxReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvTimeWaitEnter( FreeRTOS_Socket_t *pxSocket )
+	{
+	TCPWindow_t *pxTCPWindow = &( pxSocket->u.xTCP.xTCPWindow );
+	TimeWaitEntry_t *pxEntry, *pxFound = NULL;
+	const uint32_t ulRemoteIP = FreeRTOS_htonl( pxSocket->u.xTCP.ulRemoteIP );
+	const uint16_t usLocalPort = FreeRTOS_htons( pxSocket->usLocalPort );
+	const uint16_t usRemotePort = FreeRTOS_htons( pxSocket->u.xTCP.usRemotePort );
+	const TickType_t xNow = xTaskGetTickCount();
+	UBaseType_t uxIndex = prvTimeWaitHash( ulRemoteIP, usLocalPort, usRemotePort );
+	UBaseType_t uxProbe;
+
+		/* Only the side that sent the first FIN waits, the peer has already
+		received the last ACK it will send. */
+		if( pxSocket->u.xTCP.bits.bFinLast == pdFALSE_UNSIGNED )
+		{
+			for( uxProbe = 0u; uxProbe < ( UBaseType_t ) tcpTIME_WAIT_PROBES; uxProbe++ )
+			{
+				pxEntry = &( xTimeWaitTable[ ( uxIndex + uxProbe ) % ( UBaseType_t ) ipconfigTCP_TIME_WAIT_ENTRIES ] );
+
+				if( ( pxEntry->usLocalPort == 0u ) ||
+					( ( xNow - pxEntry->xEntryTime ) > tcpTIME_WAIT_TICKS ) ||
+					( ( pxEntry->usLocalPort == usLocalPort ) && ( pxEntry->usRemotePort == usRemotePort ) && ( pxEntry->ulRemoteIP == ulRemoteIP ) ) )
+				{
+					pxFound = pxEntry;
+					break;
+				}
+
+				/* When all entries are in use, the oldest is replaced. */
+				if( ( pxFound == NULL ) || ( ( xNow - pxEntry->xEntryTime ) > ( xNow - pxFound->xEntryTime ) ) )
+				{
+					pxFound = pxEntry;
+				}
+			}
+
+			pxFound->ulRemoteIP = ulRemoteIP;
+			pxFound->usLocalPort = usLocalPort;
+			pxFound->usRemotePort = usRemotePort;
+			pxFound->ulSendNext = pxTCPWindow->tx.ulFINSequenceNumber + 1u;
+			pxFound->ulReceiveNext = pxTCPWindow->rx.ulFINSequenceNumber + 1u;
+			pxFound->xEntryTime = xNow;
+		}
+
+		#if( ipconfigUSE_TCP_WIN == 1 )
+		{
+			/* Nothing will be sent or received anymore: the segments can be
+			used by other connections. */
+			vTCPWindowDestroy( pxTCPWindow );
+		}
+		#endif /* ipconfigUSE_TCP_WIN */
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvTimeWaitHandle( NetworkBufferDescriptor_t *pxNetworkBuffer )
+	{
+	TCPPacket_t *pxTCPPacket = ( TCPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer;
+	const uint8_t ucTCPFlags = pxTCPPacket->xTCPHeader.ucTCPFlags;
+	TimeWaitEntry_t *pxEntry;
+	BaseType_t xReturn = pdTRUE;
+
+		pxEntry = prvTimeWaitFind( pxTCPPacket->xIPHeader.ulSourceIPAddress, pxTCPPacket->xTCPHeader.usDestinationPort, pxTCPPacket->xTCPHeader.usSourcePort );
+
+		if( pxEntry == NULL )
+		{
+			xReturn = pdFALSE;
+		}
+		else if( ( ucTCPFlags & ipTCP_FLAG_SYN ) != 0u )
+		{
+			/* The peer starts a new connection using the same ports. */
+			pxEntry->usLocalPort = 0u;
+			xReturn = pdFALSE;
+		}
+		else if( ( ucTCPFlags & ipTCP_FLAG_RST ) != 0u )
+		{
+			pxEntry->usLocalPort = 0u;
+		}
+		else if( ( ucTCPFlags & ipTCP_FLAG_FIN ) != 0u )
+		{
+			/* The peer did not receive the last ACK, send it again, and wait
+			as long again. */
+			FreeRTOS_debug_printf( ( "TCP: TIME_WAIT: ACK repeated FIN from %lxip:%u\n",
+				FreeRTOS_ntohl( pxEntry->ulRemoteIP ), FreeRTOS_ntohs( pxEntry->usRemotePort ) ) );
+
+			pxTCPPacket->xTCPHeader.ucTCPFlags = ipTCP_FLAG_ACK;
+			pxTCPPacket->xTCPHeader.ucTCPOffset = ( ipSIZE_OF_TCP_HEADER + 0u ) << 2;
+
+			/* Without a socket, prvTCPReturnPacket() swaps the sequence and
+			the acknowledgement number. */
+			pxTCPPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( pxEntry->ulReceiveNext );
+			pxTCPPacket->xTCPHeader.ulAckNr = FreeRTOS_htonl( pxEntry->ulSendNext );
+
+			pxNetworkBuffer->xDataLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER;
+			prvTCPReturnPacket( NULL, pxNetworkBuffer, ( uint32_t ) ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER ), pdFALSE );
+			pxEntry->xEntryTime = xTaskGetTickCount();
+		}
+		else
+		{
+			/* Any other late segment is dropped, in stead of being answered
+			with a RST. */
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* ipconfigTCP_TIME_WAIT_TABLE */
+
 #if( ( ipconfigHAS_DEBUG_PRINTF != 0 ) || ( ipconfigHAS_PRINTF != 0 ) )
 
 	const char *FreeRTOS_GetTCPStateName( UBaseType_t ulState )
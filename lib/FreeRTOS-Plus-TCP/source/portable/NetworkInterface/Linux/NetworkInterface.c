@@ -0,0 +1,986 @@
+/*
+FreeRTOS+TCP V2.0.10
+Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ http://aws.amazon.com/freertos
+ http://www.FreeRTOS.org
+*/
+
+/*
+ * Network interface for the Linux (POSIX) simulator.
+ *
+ * By default the interface is a packet socket bound to the host network
+ * interface named by configNETWORK_INTERFACE_NAME, with memory mapped
+ * TPACKET_V3 receive and transmit rings shared with the host kernel:
+ *
+ * + The kernel fills the receive ring a block of frames at a time.  A host
+ *   thread waits for a block to be filled then raises a simulated interrupt,
+ *   and the deferred interrupt handler task copies every waiting frame into a
+ *   network buffer and passes them to the IP task in one event, chained through
+ *   pxNextBuffer when ipconfigUSE_LINKED_RX_MESSAGES is 1.
+ *
+ * + xNetworkInterfaceOutput() copies each frame into the next free slot of the
+ *   transmit ring.  A host thread is woken to hand the ring to the kernel only
+ *   if it is not already doing so, so frames queued while the kernel sends
+ *   earlier ones go out together in one system call.
+ *
+ * The host interface must be up.  The interface is opened in promiscuous mode,
+ * as the MAC address of the simulated device is not that of the host.  When
+ * ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES is 1 a socket filter has the
+ * kernel drop frames not addressed to the simulated device before they reach
+ * the receive ring, as the WinPCap network interface's capture filter does.
+ * Opening a packet socket needs the CAP_NET_RAW capability.
+ *
+ * When ipconfigUSE_NETWORK_POLL is set to 1 there is no deferred handler task.
+ * The simulated interrupt is masked, by the receive thread waiting until it is
+ * unmasked again, and schedules the IP task to poll the interface, which takes
+ * frames straight from the receive ring until it is empty.  The receive thread
+ * then waits for the coalescing time the IP task asks for before it raises the
+ * interrupt again.
+ *
+ * Setting niUSE_TAP_INTERFACE to 1 instead creates (or attaches to) the TAP
+ * interface named by configNETWORK_INTERFACE_NAME, which the host sees as a
+ * network interface connected to the simulated device.  TAP interfaces have no
+ * shared rings, so each frame is read and written with its own system call,
+ * but received frames are still passed to the IP task in batches.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <linux/filter.h>
+#include <linux/if_tun.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkInterface.h"
+#include "NetworkBufferManagement.h"
+
+/* The host network interface to use, or the TAP interface to create. */
+#ifndef configNETWORK_INTERFACE_NAME
+	#define configNETWORK_INTERFACE_NAME		"eth0"
+#endif
+
+/* The priority of the task that passes received frames to the IP task. */
+#ifndef configMAC_ISR_SIMULATOR_PRIORITY
+	#define configMAC_ISR_SIMULATOR_PRIORITY	( configMAX_PRIORITIES - 1 )
+#endif
+
+/* Set to 1 to use a TAP interface rather than a packet socket. */
+#ifndef niUSE_TAP_INTERFACE
+	#define niUSE_TAP_INTERFACE					0
+#endif
+
+/* The receive ring.  The kernel passes a block to the driver when it is full,
+or when niRX_BLOCK_TIMEOUT_MS has passed since its first frame arrived, which
+is therefore the longest a frame waits in the ring while traffic is light. */
+#ifndef niRX_BLOCK_SIZE
+	#define niRX_BLOCK_SIZE						( 1UL << 16 )
+#endif
+
+#ifndef niRX_BLOCK_COUNT
+	#define niRX_BLOCK_COUNT					( 16UL )
+#endif
+
+#ifndef niRX_BLOCK_TIMEOUT_MS
+	#define niRX_BLOCK_TIMEOUT_MS				( 1UL )
+#endif
+
+/* The transmit ring holds niTX_BLOCK_COUNT blocks of fixed size frames. */
+#ifndef niTX_BLOCK_COUNT
+	#define niTX_BLOCK_COUNT					( 4UL )
+#endif
+
+#define niTX_BLOCK_SIZE							( 1UL << 16 )
+#define niFRAME_SIZE							( 2048UL )
+#define niTX_FRAME_COUNT						( niTX_BLOCK_COUNT * ( niTX_BLOCK_SIZE / niFRAME_SIZE ) )
+
+/* The kernel expects each transmitted frame to follow its header. */
+#define niTX_DATA_OFFSET						( TPACKET3_HDRLEN - sizeof( struct sockaddr_ll ) )
+
+/* The most frames passed to the IP task in one event. */
+#ifndef niMAX_RX_BATCH
+	#define niMAX_RX_BATCH						( 32UL )
+#endif
+
+/* Passed as the budget when the frames are not taken by polling. */
+#define niNO_BUDGET								( ( BaseType_t ) 0x7fffffff )
+
+/* The simulated interrupt raised by the receive thread.  Numbers 0 and 1 are
+used by the kernel. */
+#define niRX_INTERRUPT							( 2UL )
+
+/* If ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES is set to 1, then the Ethernet
+driver will filter incoming packets and only pass the stack those packets it
+considers need processing. */
+#if( ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES == 0 )
+	#define ipCONSIDER_FRAME_FOR_PROCESSING( pucEthernetBuffer ) eProcessBuffer
+#else
+	#define ipCONSIDER_FRAME_FOR_PROCESSING( pucEthernetBuffer ) eConsiderFrameForProcessing( ( pucEthernetBuffer ) )
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Frames received during one interrupt that have not yet been passed to the
+IP task. */
+typedef struct xRX_BATCH
+{
+	NetworkBufferDescriptor_t *pxHead;
+	NetworkBufferDescriptor_t *pxTail;
+	UBaseType_t uxCount;
+} RxBatch_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Open the packet socket or TAP interface, and map the rings of the packet
+ * socket.
+ */
+static BaseType_t prvOpenInterface( void );
+
+#if( ( niUSE_TAP_INTERFACE == 0 ) && ( ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES != 0 ) )
+	/*
+	 * Attach a socket filter that passes only the frames addressed to the
+	 * simulated device's MAC address or to a group address.  Returns 0 on
+	 * success, as setsockopt() does.
+	 */
+	static int prvAttachFilter( int iSocket );
+#endif
+
+/*
+ * Host threads that are outside of the control of the FreeRTOS simulator.  The
+ * receive thread waits for received frames and raises niRX_INTERRUPT, then
+ * waits for the deferred handler or the IP task to process them.  The transmit thread waits
+ * to be woken by xNetworkInterfaceOutput() then hands the transmit ring to the
+ * kernel.
+ */
+static void *prvRxThread( void *pvParameters );
+
+#if( niUSE_TAP_INTERFACE == 0 )
+	static void *prvTxThread( void *pvParameters );
+#endif
+
+/*
+ * The simulated interrupt handler, which wakes the deferred handler task, or
+ * schedules the IP task to poll the interface.
+ */
+static uint32_t prvRxInterruptHandler( void );
+
+/*
+ * The deferred interrupt handler task, which passes received frames to the IP
+ * task.
+ */
+#if( ipconfigUSE_NETWORK_POLL == 0 )
+	static void prvRxHandlerTask( void *pvParameters );
+#endif
+
+/*
+ * Pass up to xBudget frames received in the ring, or read from the TAP
+ * interface, to the IP task, and return the number taken.
+ */
+#if( niUSE_TAP_INTERFACE == 0 )
+	static BaseType_t prvProcessRxRing( BaseType_t xBudget );
+#else
+	static BaseType_t prvProcessTapFrames( BaseType_t xBudget );
+#endif
+
+/*
+ * Copy a received frame into a network buffer and add it to pxBatch, passing
+ * the batch to the IP task when it is full.
+ */
+static void prvReceiveFrame( RxBatch_t *pxBatch, const uint8_t *pucFrame, size_t xLength );
+
+/*
+ * Pass the frames in pxBatch to the IP task, in one event if they are chained,
+ * or to the stack directly when the IP task is polling the interface.
+ */
+static void prvSendBatchToIPTask( RxBatch_t *pxBatch );
+
+/*
+ * Return the frame after pxNetworkBuffer in its batch.
+ */
+static NetworkBufferDescriptor_t *prvNextInBatch( NetworkBufferDescriptor_t *pxNetworkBuffer );
+
+/*
+ * Wake the transmit thread if it is not already awake.
+ */
+#if( niUSE_TAP_INTERFACE == 0 )
+	static void prvWakeTxThread( void );
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The packet socket or TAP file descriptor. */
+static int iInterfaceDescriptor = -1;
+
+#if( niUSE_TAP_INTERFACE == 0 )
+	/* The rings shared with the kernel, the receive ring first. */
+	static uint8_t *pucRxRing = NULL;
+	static uint8_t *pucTxRing = NULL;
+
+	/* The next receive block to be passed to the driver, and the next transmit
+	frame to fill. */
+	static UBaseType_t uxNextRxBlock = 0;
+	static UBaseType_t uxNextTxFrame = 0;
+
+	/* A poll can stop part way through a receive block, in which case these
+	hold the next frame to take and the number of frames left in the block. */
+	static struct tpacket3_hdr *pxNextRxFrame = NULL;
+	static uint32_t ulRxFramesLeft = 0;
+#endif /* niUSE_TAP_INTERFACE */
+
+/* The time the receive thread waits before it raises the interrupt again, as
+asked for by the IP task when it finished polling. */
+#if( ipconfigUSE_NETWORK_POLL != 0 )
+	static volatile uint32_t ulRxCoalesceTimeUs = 0;
+#endif
+
+/* Written by the deferred handler, or by the IP task when it has finished
+polling, to let the receive thread wait for more frames, and by
+xNetworkInterfaceOutput() to wake the transmit thread. */
+static int iRxDoneEvent = -1;
+static int iTxEvent = -1;
+
+/* Set while the transmit thread has been woken but has not yet started
+sending. */
+static volatile uint32_t ulTxWakePending = 0;
+
+/* True if the host interface is a loopback interface. */
+#if( niUSE_TAP_INTERFACE == 0 )
+	static BaseType_t xIsLoopback = pdFALSE;
+#endif
+
+/* The deferred interrupt handler task. */
+#if( ipconfigUSE_NETWORK_POLL == 0 )
+	static TaskHandle_t xRxHandlerTask = NULL;
+#endif
+
+/* Logs frames dropped because no network buffer or transmit slot was free, for
+viewing in the debugger only. */
+static volatile uint32_t ulRxFramesDropped = 0;
+static volatile uint32_t ulTxFramesDropped = 0;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xNetworkInterfaceInitialise( void )
+{
+BaseType_t xReturn = pdPASS;
+pthread_t xThread;
+
+	/* The IP task calls this again each time the network goes down, but the
+	interface stays open. */
+	if( iInterfaceDescriptor < 0 )
+	{
+		/* The C library must only be called with interrupts masked when using
+		the POSIX port, see the notes at the top of port.c. */
+		taskENTER_CRITICAL();
+		{
+			xReturn = prvOpenInterface();
+		}
+		taskEXIT_CRITICAL();
+
+		if( xReturn == pdPASS )
+		{
+			#if( ipconfigUSE_NETWORK_POLL == 0 )
+			{
+				xTaskCreate( prvRxHandlerTask, "MAC_ISR", configMINIMAL_STACK_SIZE * 2, NULL, configMAC_ISR_SIMULATOR_PRIORITY, &xRxHandlerTask );
+				configASSERT( xRxHandlerTask != NULL );
+			}
+			#endif
+
+			vPortSetInterruptHandler( niRX_INTERRUPT, prvRxInterruptHandler );
+
+			taskENTER_CRITICAL();
+			{
+				iRxDoneEvent = eventfd( 0, 0 );
+				iTxEvent = eventfd( 0, 0 );
+				configASSERT( ( iRxDoneEvent >= 0 ) && ( iTxEvent >= 0 ) );
+
+				pthread_create( &xThread, NULL, prvRxThread, NULL );
+				pthread_detach( xThread );
+
+				#if( niUSE_TAP_INTERFACE == 0 )
+				{
+					pthread_create( &xThread, NULL, prvTxThread, NULL );
+					pthread_detach( xThread );
+				}
+				#endif
+			}
+			taskEXIT_CRITICAL();
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if( niUSE_TAP_INTERFACE == 0 )
+
+	static BaseType_t prvOpenInterface( void )
+	{
+	struct tpacket_req3 xRxRing, xTxRing;
+	struct sockaddr_ll xAddress;
+	struct packet_mreq xMembership;
+	struct ifreq xRequest;
+	int iVersion = TPACKET_V3, iDiscard = 1;
+	unsigned int uxInterfaceIndex;
+	void *pvRings;
+	int iSocket;
+
+		uxInterfaceIndex = if_nametoindex( configNETWORK_INTERFACE_NAME );
+		iSocket = socket( AF_PACKET, SOCK_RAW, htons( ETH_P_ALL ) );
+
+		if( ( uxInterfaceIndex == 0U ) || ( iSocket < 0 ) )
+		{
+			FreeRTOS_printf( ( "Cannot open a packet socket on %s: %s\n", configNETWORK_INTERFACE_NAME, strerror( errno ) ) );
+
+			if( iSocket >= 0 )
+			{
+				close( iSocket );
+			}
+
+			return pdFAIL;
+		}
+
+		memset( &xRxRing, '\0', sizeof( xRxRing ) );
+		xRxRing.tp_block_size = niRX_BLOCK_SIZE;
+		xRxRing.tp_block_nr = niRX_BLOCK_COUNT;
+		xRxRing.tp_frame_size = niFRAME_SIZE;
+		xRxRing.tp_frame_nr = ( niRX_BLOCK_SIZE / niFRAME_SIZE ) * niRX_BLOCK_COUNT;
+		xRxRing.tp_retire_blk_tov = niRX_BLOCK_TIMEOUT_MS;
+
+		memset( &xTxRing, '\0', sizeof( xTxRing ) );
+		xTxRing.tp_block_size = niTX_BLOCK_SIZE;
+		xTxRing.tp_block_nr = niTX_BLOCK_COUNT;
+		xTxRing.tp_frame_size = niFRAME_SIZE;
+		xTxRing.tp_frame_nr = niTX_FRAME_COUNT;
+
+		memset( &xAddress, '\0', sizeof( xAddress ) );
+		xAddress.sll_family = AF_PACKET;
+		xAddress.sll_protocol = htons( ETH_P_ALL );
+		xAddress.sll_ifindex = ( int ) uxInterfaceIndex;
+
+		/* Open in promiscuous mode as the MAC address is going to be
+		"simulated", and not be the real MAC address of the host. */
+		memset( &xMembership, '\0', sizeof( xMembership ) );
+		xMembership.mr_ifindex = ( int ) uxInterfaceIndex;
+		xMembership.mr_type = PACKET_MR_PROMISC;
+
+		/* PACKET_LOSS has the kernel skip, rather than stop at, a transmit
+		frame it cannot send. */
+		if( ( setsockopt( iSocket, SOL_PACKET, PACKET_VERSION, &iVersion, sizeof( iVersion ) ) != 0 ) ||
+			( setsockopt( iSocket, SOL_PACKET, PACKET_LOSS, &iDiscard, sizeof( iDiscard ) ) != 0 ) ||
+			( setsockopt( iSocket, SOL_PACKET, PACKET_RX_RING, &xRxRing, sizeof( xRxRing ) ) != 0 ) ||
+			( setsockopt( iSocket, SOL_PACKET, PACKET_TX_RING, &xTxRing, sizeof( xTxRing ) ) != 0 ) ||
+			( setsockopt( iSocket, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &xMembership, sizeof( xMembership ) ) != 0 ) ||
+			#if( ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES != 0 )
+				( prvAttachFilter( iSocket ) != 0 ) ||
+			#endif
+			( bind( iSocket, ( struct sockaddr * ) &xAddress, sizeof( xAddress ) ) != 0 ) )
+		{
+			FreeRTOS_printf( ( "Cannot set up the rings on %s: %s\n", configNETWORK_INTERFACE_NAME, strerror( errno ) ) );
+			close( iSocket );
+			return pdFAIL;
+		}
+
+		pvRings = mmap( NULL, ( niRX_BLOCK_SIZE * niRX_BLOCK_COUNT ) + ( niTX_BLOCK_SIZE * niTX_BLOCK_COUNT ),
+						PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, iSocket, 0 );
+
+		if( pvRings == MAP_FAILED )
+		{
+			FreeRTOS_printf( ( "Cannot map the rings on %s: %s\n", configNETWORK_INTERFACE_NAME, strerror( errno ) ) );
+			close( iSocket );
+			return pdFAIL;
+		}
+
+		memset( &xRequest, '\0', sizeof( xRequest ) );
+		strncpy( xRequest.ifr_name, configNETWORK_INTERFACE_NAME, sizeof( xRequest.ifr_name ) - 1U );
+
+		if( ( ioctl( iSocket, SIOCGIFFLAGS, &xRequest ) == 0 ) && ( ( xRequest.ifr_flags & IFF_LOOPBACK ) != 0 ) )
+		{
+			xIsLoopback = pdTRUE;
+		}
+
+		pucRxRing = ( uint8_t * ) pvRings;
+		pucTxRing = pucRxRing + ( niRX_BLOCK_SIZE * niRX_BLOCK_COUNT );
+		iInterfaceDescriptor = iSocket;
+
+		return pdPASS;
+	}
+
+	#if( ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES != 0 )
+
+		static int prvAttachFilter( int iSocket )
+		{
+		const uint8_t *pucMAC = ipLOCAL_MAC_ADDRESS;
+		const uint32_t ulMACHigh = ( ( uint32_t ) pucMAC[ 0 ] << 8 ) | ( uint32_t ) pucMAC[ 1 ];
+		const uint32_t ulMACLow = ( ( uint32_t ) pucMAC[ 2 ] << 24 ) | ( ( uint32_t ) pucMAC[ 3 ] << 16 ) |
+								  ( ( uint32_t ) pucMAC[ 4 ] << 8 ) | ( uint32_t ) pucMAC[ 5 ];
+		struct sock_filter xCode[] =
+		{
+			/* Pass frames sent to a group address, which includes the
+			broadcast address, as the stack checks those itself. */
+			BPF_STMT( BPF_LD | BPF_B | BPF_ABS, 0 ),
+			BPF_JUMP( BPF_JMP | BPF_JSET | BPF_K, 0x01, 4, 0 ),
+
+			/* Otherwise pass only frames sent to this device. */
+			BPF_STMT( BPF_LD | BPF_W | BPF_ABS, 2 ),
+			BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, ulMACLow, 0, 3 ),
+			BPF_STMT( BPF_LD | BPF_H | BPF_ABS, 0 ),
+			BPF_JUMP( BPF_JMP | BPF_JEQ | BPF_K, ulMACHigh, 0, 1 ),
+
+			/* Pass the whole frame, or none of it. */
+			BPF_STMT( BPF_RET | BPF_K, 0xffffffffUL ),
+			BPF_STMT( BPF_RET | BPF_K, 0 )
+		};
+		struct sock_fprog xProgram;
+
+			xProgram.len = ( unsigned short ) ( sizeof( xCode ) / sizeof( xCode[ 0 ] ) );
+			xProgram.filter = xCode;
+
+			return setsockopt( iSocket, SOL_SOCKET, SO_ATTACH_FILTER, &xProgram, sizeof( xProgram ) );
+		}
+
+	#endif /* ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES */
+
+#else /* niUSE_TAP_INTERFACE */
+
+	static BaseType_t prvOpenInterface( void )
+	{
+	struct ifreq xRequest;
+	int iTap, iSocket;
+
+		memset( &xRequest, '\0', sizeof( xRequest ) );
+		xRequest.ifr_flags = IFF_TAP | IFF_NO_PI;
+		strncpy( xRequest.ifr_name, configNETWORK_INTERFACE_NAME, sizeof( xRequest.ifr_name ) - 1U );
+
+		iTap = open( "/dev/net/tun", O_RDWR | O_NONBLOCK );
+
+		if( ( iTap < 0 ) || ( ioctl( iTap, TUNSETIFF, &xRequest ) != 0 ) )
+		{
+			FreeRTOS_printf( ( "Cannot open TAP interface %s: %s\n", configNETWORK_INTERFACE_NAME, strerror( errno ) ) );
+
+			if( iTap >= 0 )
+			{
+				close( iTap );
+			}
+
+			return pdFAIL;
+		}
+
+		/* Bring the host side of the interface up, which fails harmlessly if
+		the simulator is not allowed to. */
+		iSocket = socket( AF_INET, SOCK_DGRAM, 0 );
+
+		if( iSocket >= 0 )
+		{
+			if( ioctl( iSocket, SIOCGIFFLAGS, &xRequest ) == 0 )
+			{
+				xRequest.ifr_flags |= IFF_UP;
+				( void ) ioctl( iSocket, SIOCSIFFLAGS, &xRequest );
+			}
+
+			close( iSocket );
+		}
+
+		iInterfaceDescriptor = iTap;
+
+		return pdPASS;
+	}
+
+#endif /* niUSE_TAP_INTERFACE */
+/*-----------------------------------------------------------*/
+
+BaseType_t xNetworkInterfaceOutput( NetworkBufferDescriptor_t * const pxNetworkBuffer, BaseType_t bReleaseAfterSend )
+{
+	iptraceNETWORK_INTERFACE_TRANSMIT();
+	configASSERT( xIsCallingFromIPTask() == pdTRUE );
+
+	if( pxNetworkBuffer->xDataLength <= ( ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ) )
+	{
+		#if( niUSE_TAP_INTERFACE == 0 )
+		{
+		struct tpacket3_hdr *pxFrame = ( struct tpacket3_hdr * ) ( pucTxRing + ( uxNextTxFrame * niFRAME_SIZE ) );
+
+			if( __atomic_load_n( &( pxFrame->tp_status ), __ATOMIC_ACQUIRE ) != TP_STATUS_AVAILABLE )
+			{
+				/* The ring is full.  Send it from this task rather than wait
+				for the transmit thread to be scheduled.  send() takes no C
+				library locks, and returns once the kernel has finished with
+				every frame. */
+				( void ) send( iInterfaceDescriptor, NULL, 0, 0 );
+			}
+
+			if( __atomic_load_n( &( pxFrame->tp_status ), __ATOMIC_ACQUIRE ) == TP_STATUS_AVAILABLE )
+			{
+				memcpy( ( uint8_t * ) pxFrame + niTX_DATA_OFFSET, pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength );
+				pxFrame->tp_len = ( uint32_t ) pxNetworkBuffer->xDataLength;
+				pxFrame->tp_next_offset = 0;
+
+				/* The frame must be complete before the kernel can see it. */
+				__atomic_store_n( &( pxFrame->tp_status ), TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE );
+				uxNextTxFrame = ( uxNextTxFrame + 1U ) % niTX_FRAME_COUNT;
+
+				prvWakeTxThread();
+			}
+			else
+			{
+				ulTxFramesDropped++;
+			}
+		}
+		#else /* niUSE_TAP_INTERFACE */
+		{
+			/* write() on a file descriptor takes no C library locks, so does
+			not need interrupts to be masked. */
+			if( write( iInterfaceDescriptor, pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength ) < 0 )
+			{
+				ulTxFramesDropped++;
+			}
+		}
+		#endif /* niUSE_TAP_INTERFACE */
+	}
+
+	/* The buffer has been sent so can be released. */
+	if( bReleaseAfterSend != pdFALSE )
+	{
+		vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+	}
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+#if( niUSE_TAP_INTERFACE == 0 )
+
+	static void prvWakeTxThread( void )
+	{
+	const uint64_t ullOne = 1ULL;
+
+		/* Only the first frame queued since the transmit thread last started
+		sending needs to wake it, the rest are sent with it. */
+		if( __atomic_exchange_n( &ulTxWakePending, 1UL, __ATOMIC_SEQ_CST ) == 0UL )
+		{
+			( void ) write( iTxEvent, &ullOne, sizeof( ullOne ) );
+		}
+	}
+
+#endif /* niUSE_TAP_INTERFACE */
+/*-----------------------------------------------------------*/
+
+static void *prvRxThread( void *pvParameters )
+{
+struct pollfd xPoll;
+sigset_t xSignals;
+uint64_t ullCount;
+
+	/* THIS IS A HOST THREAD - DO NOT ATTEMPT ANY FREERTOS CALLS OTHER THAN
+	vPortGenerateSimulatedInterrupt() HERE. */
+	( void ) pvParameters;
+
+	sigfillset( &xSignals );
+	pthread_sigmask( SIG_BLOCK, &xSignals, NULL );
+
+	xPoll.fd = iInterfaceDescriptor;
+	xPoll.events = POLLIN;
+
+	for( ;; )
+	{
+		/* A packet socket with a receive ring is readable when a block has
+		been passed to the driver, and a TAP interface when a frame has been
+		received. */
+		if( poll( &xPoll, 1, -1 ) > 0 )
+		{
+			vPortGenerateSimulatedInterrupt( niRX_INTERRUPT );
+
+			/* Wait for the deferred handler or the IP task to take the
+			frames, so the interface does not poll as readable again until
+			there are new ones. */
+			( void ) read( iRxDoneEvent, &ullCount, sizeof( ullCount ) );
+
+			#if( ipconfigUSE_NETWORK_POLL != 0 )
+			{
+				/* Let frames gather before interrupting again. */
+				if( ulRxCoalesceTimeUs != 0UL )
+				{
+					( void ) usleep( ulRxCoalesceTimeUs );
+				}
+			}
+			#endif
+		}
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+#if( niUSE_TAP_INTERFACE == 0 )
+
+	static void *prvTxThread( void *pvParameters )
+	{
+	sigset_t xSignals;
+	uint64_t ullCount;
+
+		/* THIS IS A HOST THREAD - DO NOT ATTEMPT ANY FREERTOS CALLS HERE. */
+		( void ) pvParameters;
+
+		sigfillset( &xSignals );
+		pthread_sigmask( SIG_BLOCK, &xSignals, NULL );
+
+		for( ;; )
+		{
+			( void ) read( iTxEvent, &ullCount, sizeof( ullCount ) );
+
+			/* Clear the flag before sending, so a frame queued while this thread
+			is sending wakes it again. */
+			__atomic_store_n( &ulTxWakePending, 0UL, __ATOMIC_SEQ_CST );
+
+			/* Sends every frame marked TP_STATUS_SEND_REQUEST, and returns when
+			the kernel has finished with them all. */
+			( void ) send( iInterfaceDescriptor, NULL, 0, 0 );
+		}
+
+		return NULL;
+	}
+
+#endif /* niUSE_TAP_INTERFACE */
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRxInterruptHandler( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	#if( ipconfigUSE_NETWORK_POLL != 0 )
+	{
+	const uint64_t ullOne = 1ULL;
+
+		/* The interrupt stays masked until the IP task has finished polling.
+		If the poll cannot be scheduled, unmask it again after the longest
+		coalescing time, as the frames are still waiting. */
+		if( xNetworkPollScheduleFromISR( &xHigherPriorityTaskWoken ) != pdPASS )
+		{
+			ulRxCoalesceTimeUs = ipconfigNETWORK_POLL_COALESCE_MAX_US;
+			( void ) write( iRxDoneEvent, &ullOne, sizeof( ullOne ) );
+		}
+	}
+	#else
+	{
+		vTaskNotifyGiveFromISR( xRxHandlerTask, &xHigherPriorityTaskWoken );
+	}
+	#endif /* ipconfigUSE_NETWORK_POLL */
+
+	return ( uint32_t ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_NETWORK_POLL == 0 )
+
+	static void prvRxHandlerTask( void *pvParameters )
+	{
+	const uint64_t ullOne = 1ULL;
+
+		/* Remove compiler warnings about unused parameters. */
+		( void ) pvParameters;
+
+		for( ;; )
+		{
+			ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+			#if( niUSE_TAP_INTERFACE == 0 )
+			{
+				( void ) prvProcessRxRing( niNO_BUDGET );
+			}
+			#else
+			{
+				( void ) prvProcessTapFrames( niMAX_RX_BATCH );
+			}
+			#endif
+
+			/* Let the receive thread wait for more frames. */
+			( void ) write( iRxDoneEvent, &ullOne, sizeof( ullOne ) );
+		}
+	}
+
+#else /* ipconfigUSE_NETWORK_POLL */
+
+	BaseType_t xNetworkInterfacePoll( BaseType_t xBudget )
+	{
+		#if( niUSE_TAP_INTERFACE == 0 )
+		{
+			return prvProcessRxRing( xBudget );
+		}
+		#else
+		{
+			return prvProcessTapFrames( xBudget );
+		}
+		#endif
+	}
+	/*-----------------------------------------------------------*/
+
+	void vNetworkInterfacePollComplete( uint32_t ulCoalesceTimeUs )
+	{
+	const uint64_t ullOne = 1ULL;
+
+		/* Unmask the interrupt by letting the receive thread wait for more
+		frames. */
+		ulRxCoalesceTimeUs = ulCoalesceTimeUs;
+		( void ) write( iRxDoneEvent, &ullOne, sizeof( ullOne ) );
+	}
+
+#endif /* ipconfigUSE_NETWORK_POLL */
+/*-----------------------------------------------------------*/
+
+#if( niUSE_TAP_INTERFACE == 0 )
+
+	static BaseType_t prvProcessRxRing( BaseType_t xBudget )
+	{
+	struct tpacket_block_desc *pxBlock;
+	struct tpacket3_hdr *pxFrame;
+	struct sockaddr_ll *pxAddress;
+	RxBatch_t xBatch = { NULL, NULL, 0 };
+	UBaseType_t uxBlocks = 0;
+	BaseType_t xFrames = 0;
+
+		/* Take at most one pass around the ring, so a flood of frames cannot
+		keep this task from ever returning, and at most xBudget frames. */
+		while( ( uxBlocks < niRX_BLOCK_COUNT ) && ( xFrames < xBudget ) )
+		{
+			pxBlock = ( struct tpacket_block_desc * ) ( pucRxRing + ( uxNextRxBlock * niRX_BLOCK_SIZE ) );
+
+			if( pxNextRxFrame == NULL )
+			{
+				/* The frames must not be read before the status that says the
+				kernel has finished writing them. */
+				if( ( __atomic_load_n( &( pxBlock->hdr.bh1.block_status ), __ATOMIC_ACQUIRE ) & TP_STATUS_USER ) == 0U )
+				{
+					break;
+				}
+
+				pxNextRxFrame = ( struct tpacket3_hdr * ) ( ( uint8_t * ) pxBlock + pxBlock->hdr.bh1.offset_to_first_pkt );
+				ulRxFramesLeft = pxBlock->hdr.bh1.num_pkts;
+			}
+
+			while( ( ulRxFramesLeft > 0U ) && ( xFrames < xBudget ) )
+			{
+				pxFrame = pxNextRxFrame;
+				pxAddress = ( struct sockaddr_ll * ) ( ( uint8_t * ) pxFrame + TPACKET_ALIGN( sizeof( struct tpacket3_hdr ) ) );
+
+				/* Frames larger than the ring's snapshot length are
+				truncated, and dropped here.  A loopback interface passes
+				each frame to packet sockets both as it is sent and as it is
+				received, so as libpcap does, only the received copy is
+				taken. */
+				if( ( pxFrame->tp_snaplen == pxFrame->tp_len ) &&
+					( ( xIsLoopback == pdFALSE ) || ( pxAddress->sll_pkttype != PACKET_OUTGOING ) ) )
+				{
+					prvReceiveFrame( &xBatch, ( uint8_t * ) pxFrame + pxFrame->tp_mac, pxFrame->tp_snaplen );
+				}
+
+				pxNextRxFrame = ( struct tpacket3_hdr * ) ( ( uint8_t * ) pxFrame + pxFrame->tp_next_offset );
+				ulRxFramesLeft--;
+				xFrames++;
+			}
+
+			if( ulRxFramesLeft == 0U )
+			{
+				/* Return the block to the kernel once its frames are copied. */
+				__atomic_store_n( &( pxBlock->hdr.bh1.block_status ), TP_STATUS_KERNEL, __ATOMIC_RELEASE );
+				uxNextRxBlock = ( uxNextRxBlock + 1U ) % niRX_BLOCK_COUNT;
+				pxNextRxFrame = NULL;
+				uxBlocks++;
+			}
+		}
+
+		prvSendBatchToIPTask( &xBatch );
+
+		return xFrames;
+	}
+
+#else /* niUSE_TAP_INTERFACE */
+
+	static BaseType_t prvProcessTapFrames( BaseType_t xBudget )
+	{
+	static uint8_t ucFrame[ ipTOTAL_ETHERNET_FRAME_SIZE ];
+	RxBatch_t xBatch = { NULL, NULL, 0 };
+	BaseType_t xFrames;
+	ssize_t xLength;
+
+		/* Each read() returns one frame.  Read at most xBudget frames, the
+		receive thread raises the interrupt again if more are waiting. */
+		for( xFrames = 0; xFrames < xBudget; xFrames++ )
+		{
+			xLength = read( iInterfaceDescriptor, ucFrame, sizeof( ucFrame ) );
+
+			if( xLength <= 0 )
+			{
+				break;
+			}
+
+			prvReceiveFrame( &xBatch, ucFrame, ( size_t ) xLength );
+		}
+
+		prvSendBatchToIPTask( &xBatch );
+
+		return xFrames;
+	}
+
+#endif /* niUSE_TAP_INTERFACE */
+/*-----------------------------------------------------------*/
+
+static void prvReceiveFrame( RxBatch_t *pxBatch, const uint8_t *pucFrame, size_t xLength )
+{
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+
+	/* Check for minimal size, and that the frame will fit into a network
+	buffer. */
+	if( ( xLength < sizeof( EthernetHeader_t ) ) || ( xLength > ipTOTAL_ETHERNET_FRAME_SIZE ) )
+	{
+		return;
+	}
+
+	if( ipCONSIDER_FRAME_FOR_PROCESSING( pucFrame ) != eProcessBuffer )
+	{
+		return;
+	}
+
+	pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( xLength, 0 );
+
+	if( pxNetworkBuffer == NULL )
+	{
+		ulRxFramesDropped++;
+		iptraceETHERNET_RX_EVENT_LOST();
+		return;
+	}
+
+	iptraceNETWORK_INTERFACE_RECEIVE();
+
+	memcpy( pxNetworkBuffer->pucEthernetBuffer, pucFrame, xLength );
+	pxNetworkBuffer->xDataLength = xLength;
+
+	#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+	{
+		pxNetworkBuffer->pxNextBuffer = NULL;
+
+		if( pxBatch->pxHead == NULL )
+		{
+			pxBatch->pxHead = pxNetworkBuffer;
+		}
+		else
+		{
+			pxBatch->pxTail->pxNextBuffer = pxNetworkBuffer;
+		}
+
+		pxBatch->pxTail = pxNetworkBuffer;
+		pxBatch->uxCount++;
+
+		if( pxBatch->uxCount >= niMAX_RX_BATCH )
+		{
+			prvSendBatchToIPTask( pxBatch );
+		}
+	}
+	#else
+	{
+		/* Without linked messages each frame is its own event. */
+		pxBatch->pxHead = pxNetworkBuffer;
+		pxBatch->uxCount = 1;
+		prvSendBatchToIPTask( pxBatch );
+	}
+	#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+}
+/*-----------------------------------------------------------*/
+
+static void prvSendBatchToIPTask( RxBatch_t *pxBatch )
+{
+NetworkBufferDescriptor_t *pxNetworkBuffer, *pxNextBuffer;
+
+	if( pxBatch->pxHead != NULL )
+	{
+		#if( ipconfigUSE_NETWORK_POLL != 0 )
+		{
+			/* Called from the IP task's poll, so the frames are processed
+			now. */
+			for( pxNetworkBuffer = pxBatch->pxHead; pxNetworkBuffer != NULL; pxNetworkBuffer = pxNextBuffer )
+			{
+				pxNextBuffer = prvNextInBatch( pxNetworkBuffer );
+				vNetworkPollReceive( pxNetworkBuffer );
+			}
+		}
+		#else
+		{
+		IPStackEvent_t xRxEvent = { eNetworkRxEvent, NULL };
+
+			xRxEvent.pvData = ( void * ) pxBatch->pxHead;
+
+			if( xSendEventStructToIPTask( &xRxEvent, ( TickType_t ) 0 ) == pdFAIL )
+			{
+				/* The frames could not be sent to the stack so must be
+				released again. */
+				for( pxNetworkBuffer = pxBatch->pxHead; pxNetworkBuffer != NULL; pxNetworkBuffer = pxNextBuffer )
+				{
+					pxNextBuffer = prvNextInBatch( pxNetworkBuffer );
+					vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+					ulRxFramesDropped++;
+				}
+
+				iptraceETHERNET_RX_EVENT_LOST();
+			}
+		}
+		#endif /* ipconfigUSE_NETWORK_POLL */
+
+		pxBatch->pxHead = NULL;
+		pxBatch->pxTail = NULL;
+		pxBatch->uxCount = 0;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static NetworkBufferDescriptor_t *prvNextInBatch( NetworkBufferDescriptor_t *pxNetworkBuffer )
+{
+	#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+	{
+		return pxNetworkBuffer->pxNextBuffer;
+	}
+	#else
+	{
+		/* Without linked messages a batch holds one frame. */
+		( void ) pxNetworkBuffer;
+		return NULL;
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
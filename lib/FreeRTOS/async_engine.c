@@ -0,0 +1,915 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "async_engine.h"
+
+/* Lint e961, e9021 and e750 are suppressed as a MISRA exception justified
+because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+for the header files above, but not in this file, in order to generate the
+correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/* This entire source file will be skipped if the application is not configured
+to include async engines.  This #if is closed at the very bottom of this file. */
+#if ( configUSE_ASYNC_ENGINE == 1 )
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION != 1 )
+	#error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to use async engines
+#endif
+
+/*
+ * All the engine state other than the pending list is only accessed by the
+ * host task, so needs no critical sections.  Tasks and interrupts that start
+ * or notify an async task add it to the pending list, inside a critical
+ * section, then give the wake semaphore, which is a member of the engine's
+ * queue set, so the host task wakes to move the async task to the ready list.
+ *
+ * The queue set holds one entry for each item sent to each queue or semaphore
+ * added to the engine.  Each entry read from the set gives the object one
+ * credit, and an async task can only read an object when it takes a credit, so
+ * every read from an object is matched by an entry read from the set and the
+ * set cannot overflow.  When an entry is read the first async task waiting for
+ * the object, if any, is made ready - but any async task that awaits the object
+ * before it runs can take the credit first, in which case the woken task waits
+ * again.
+ *
+ * Async tasks awaiting with a timeout are also held in one of two delayed
+ * lists, ordered by the tick count at which they time out.  As with the timer
+ * lists in timers.c, one list holds tasks that time out before the tick count
+ * next overflows, and the other tasks that time out after it overflows.  A task
+ * whose timeout expires is made ready, and the await it resumes checks the
+ * timeout with xTaskCheckForTimeOut() before giving up.
+ */
+
+/* Values of the ucBlockedOn field of an async task. */
+#define asyncBLOCKED_NOTHING		( ( uint8_t ) 0 ) /* Running, or ended. */
+#define asyncBLOCKED_READY			( ( uint8_t ) 1 ) /* In the ready list. */
+#define asyncBLOCKED_START			( ( uint8_t ) 2 ) /* Started but not yet in the ready list. */
+#define asyncBLOCKED_DELAY			( ( uint8_t ) 3 )
+#define asyncBLOCKED_OBJECT			( ( uint8_t ) 4 ) /* Waiting for a queue or semaphore. */
+#define asyncBLOCKED_NOTIFICATION	( ( uint8_t ) 5 )
+#define asyncBLOCKED_SPACE			( ( uint8_t ) 6 ) /* Polling for space in a queue. */
+
+/*-----------------------------------------------------------*/
+
+/* A queue or semaphore added to an engine. */
+typedef struct AsyncObject
+{
+	QueueSetMemberHandle_t xObject;
+	List_t xWaitingTasks;				/* Async tasks awaiting the object, in the order they started waiting. */
+	UBaseType_t uxCredits;				/* The number of entries read from the queue set for the object, less the number of reads from the object. */
+	struct AsyncObject *pxNext;
+} AsyncObject_t;
+
+/* Structure that hold state information on the engine. */
+typedef struct AsyncEngineDef_t /*lint !e9058 Style convention uses tag. */
+{
+	AsyncTask_t *pxReadyHead;			/* Async tasks ready to run, in the order they became ready. */
+	AsyncTask_t *pxReadyTail;
+	AsyncTask_t *pxPendingHead;			/* Async tasks started or notified by other tasks or interrupts. */
+	AsyncTask_t *pxPendingTail;
+	List_t xDelayedList1;				/* Async tasks awaiting with a timeout. */
+	List_t xDelayedList2;				/* Async tasks awaiting with a timeout that expires after the tick count overflows. */
+	List_t *pxDelayedList;				/* Points to whichever delayed list holds tasks that time out before the tick count overflows. */
+	List_t *pxOverflowDelayedList;		/* Points to the other delayed list. */
+	TickType_t xLastTickCount;			/* The tick count when the delayed lists were last checked, used to detect the tick count overflowing. */
+	AsyncObject_t *pxObjects;			/* The objects added to the engine. */
+	QueueSetHandle_t xQueueSet;
+	SemaphoreHandle_t xWakeSemaphore;	/* Given when an async task is added to the pending list. */
+	TaskHandle_t xHostTask;				/* The task that called vAsyncEngineRun(), or NULL if it has not been called. */
+} AsyncEngine_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Adds an async task to the end of the ready list, removing it from any list
+ * it is waiting in.
+ */
+static void prvMakeReady( AsyncEngine_t * const pxEngine, AsyncTask_t * const pxTask ) PRIVILEGED_FUNCTION;
+
+/*
+ * Makes ready every async task whose timeout has expired.  Called with the
+ * current tick count.
+ */
+static void prvProcessDelayedTasks( AsyncEngine_t * const pxEngine, const TickType_t xTickCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Adds an async task to the delayed list, to be made ready after xTicksToWait
+ * ticks.
+ */
+static void prvAddToDelayedList( AsyncEngine_t * const pxEngine, AsyncTask_t * const pxTask, const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Adds an async task to the pending list.  Must be called from a critical
+ * section.  Returns pdTRUE if the pending list was empty, in which case the
+ * caller must give the wake semaphore.
+ */
+static BaseType_t prvAddToPendingList( AsyncEngine_t * const pxEngine, AsyncTask_t * const pxTask ) PRIVILEGED_FUNCTION;
+
+/*
+ * Makes ready every async task in the pending list that has been started or
+ * is awaiting a notification.
+ */
+static void prvProcessPendingTasks( AsyncEngine_t * const pxEngine ) PRIVILEGED_FUNCTION;
+
+/*
+ * Makes an async task ready if it has been started or is awaiting a
+ * notification.  Called by the host task.
+ */
+static void prvWakePendingTask( AsyncEngine_t * const pxEngine, AsyncTask_t * const pxTask ) PRIVILEGED_FUNCTION;
+
+/*
+ * Sets bits in an async task's notification value, and wakes it if it is
+ * awaiting a notification or has just been started.  Called from tasks.
+ */
+static void prvNotify( AsyncTask_t * const pxTask, const uint32_t ulBits ) PRIVILEGED_FUNCTION;
+
+/*
+ * Finds the record of an object added to the engine.
+ */
+static AsyncObject_t *prvFindObject( const AsyncEngine_t * const pxEngine, const QueueSetMemberHandle_t xObject ) PRIVILEGED_FUNCTION;
+
+/*
+ * Gives an object a credit for an entry read from the queue set, and makes
+ * the first async task waiting for it ready.
+ */
+static void prvProcessEvent( AsyncEngine_t * const pxEngine, const QueueSetMemberHandle_t xMember ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns how long the host task can wait for an event before an async task
+ * needs to run.
+ */
+static TickType_t prvGetTicksToWait( const AsyncEngine_t * const pxEngine ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called when an await cannot complete.  Returns pdFAIL if the await has timed
+ * out, otherwise records what the task is waiting for and returns
+ * asyncWOULD_BLOCK.
+ */
+static BaseType_t prvBlock( AsyncTask_t * const pxTask, AsyncObject_t * const pxObject, const uint8_t ucBlockedOn ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+AsyncEngineHandle_t xAsyncEngineCreate( UBaseType_t uxEventQueueLength )
+{
+AsyncEngine_t *pxEngine;
+
+	pxEngine = ( AsyncEngine_t * ) pvPortMalloc( sizeof( AsyncEngine_t ) ); /*lint !e9087 !e9079 malloc() only returns void*. */
+
+	if( pxEngine != NULL )
+	{
+		( void ) memset( ( void * ) pxEngine, 0x00, sizeof( AsyncEngine_t ) ); /*lint !e9087 memset() requires void *. */
+
+		vListInitialise( &( pxEngine->xDelayedList1 ) );
+		vListInitialise( &( pxEngine->xDelayedList2 ) );
+		pxEngine->pxDelayedList = &( pxEngine->xDelayedList1 );
+		pxEngine->pxOverflowDelayedList = &( pxEngine->xDelayedList2 );
+		pxEngine->xLastTickCount = xTaskGetTickCount();
+
+		/* The set has one more entry than the objects need, for the wake
+		semaphore. */
+		pxEngine->xWakeSemaphore = xSemaphoreCreateBinary();
+		pxEngine->xQueueSet = xQueueCreateSet( uxEventQueueLength + ( UBaseType_t ) 1 );
+
+		if( ( pxEngine->xWakeSemaphore != NULL ) &&
+			( pxEngine->xQueueSet != NULL ) &&
+			( xQueueAddToSet( ( QueueSetMemberHandle_t ) pxEngine->xWakeSemaphore, pxEngine->xQueueSet ) == pdPASS ) )
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+		else
+		{
+			if( pxEngine->xWakeSemaphore != NULL )
+			{
+				vSemaphoreDelete( pxEngine->xWakeSemaphore );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( pxEngine->xQueueSet != NULL )
+			{
+				vQueueDelete( pxEngine->xQueueSet );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			vPortFree( ( void * ) pxEngine );
+			pxEngine = NULL;
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pxEngine;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAsyncEngineAddObject( AsyncEngineHandle_t xEngine, QueueSetMemberHandle_t xObject )
+{
+AsyncEngine_t * const pxEngine = xEngine;
+AsyncObject_t *pxObject;
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( pxEngine );
+	configASSERT( xObject );
+	configASSERT( prvFindObject( pxEngine, xObject ) == NULL );
+
+	pxObject = ( AsyncObject_t * ) pvPortMalloc( sizeof( AsyncObject_t ) ); /*lint !e9087 !e9079 malloc() only returns void*. */
+
+	if( pxObject != NULL )
+	{
+		if( xQueueAddToSet( xObject, pxEngine->xQueueSet ) == pdPASS )
+		{
+			pxObject->xObject = xObject;
+			vListInitialise( &( pxObject->xWaitingTasks ) );
+			pxObject->uxCredits = ( UBaseType_t ) 0;
+			pxObject->pxNext = pxEngine->pxObjects;
+			pxEngine->pxObjects = pxObject;
+			xReturn = pdPASS;
+		}
+		else
+		{
+			vPortFree( ( void * ) pxObject );
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vAsyncEngineRun( AsyncEngineHandle_t xEngine )
+{
+AsyncEngine_t * const pxEngine = xEngine;
+AsyncTask_t *pxTask, *pxNextTask;
+QueueSetMemberHandle_t xMember;
+
+	configASSERT( pxEngine );
+	configASSERT( pxEngine->xHostTask == NULL );
+
+	pxEngine->xHostTask = xTaskGetCurrentTaskHandle();
+
+	for( ;; )
+	{
+		prvProcessPendingTasks( pxEngine );
+		prvProcessDelayedTasks( pxEngine, xTaskGetTickCount() );
+
+		/* Run the tasks that are ready now.  Tasks made ready while they run,
+		including tasks that yield, wait for the next pass, so events are still
+		collected while tasks repeatedly yield. */
+		pxTask = pxEngine->pxReadyHead;
+		pxEngine->pxReadyHead = NULL;
+		pxEngine->pxReadyTail = NULL;
+
+		while( pxTask != NULL )
+		{
+			pxNextTask = pxTask->pxNextReady;
+			pxTask->pxNextReady = NULL;
+			pxTask->ucBlockedOn = asyncBLOCKED_NOTHING;
+
+			pxTask->pxFunction( pxTask, pxTask->pvParameters );
+
+			pxTask = pxNextTask;
+		}
+
+		/* Wait for an event, then read every other event already in the
+		set. */
+		xMember = xQueueSelectFromSet( pxEngine->xQueueSet, prvGetTicksToWait( pxEngine ) );
+
+		while( xMember != NULL )
+		{
+			prvProcessEvent( pxEngine, xMember );
+			xMember = xQueueSelectFromSet( pxEngine->xQueueSet, ( TickType_t ) 0 );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vAsyncTaskStart( AsyncEngineHandle_t xEngine, AsyncTask_t *pxTask, AsyncTaskFunction_t pxFunction, void *pvParameters )
+{
+	configASSERT( xEngine );
+	configASSERT( pxTask );
+	configASSERT( pxFunction );
+
+	pxTask->uxState = ( UBaseType_t ) 0;
+	pxTask->pxFunction = pxFunction;
+	pxTask->pvParameters = pvParameters;
+	vListInitialiseItem( &( pxTask->xStateListItem ) );
+	listSET_LIST_ITEM_OWNER( &( pxTask->xStateListItem ), pxTask );
+	vListInitialiseItem( &( pxTask->xEventListItem ) );
+	listSET_LIST_ITEM_OWNER( &( pxTask->xEventListItem ), pxTask );
+	pxTask->xTicksToWait = ( TickType_t ) 0;
+	pxTask->ulNotifiedValue = 0UL;
+	pxTask->pxNextReady = NULL;
+	pxTask->pxNextPending = NULL;
+	pxTask->pxEngine = xEngine;
+	pxTask->ucBlockedOn = asyncBLOCKED_START;
+	pxTask->ucTimeOutSet = pdFALSE;
+	pxTask->ucPending = pdFALSE;
+
+	prvNotify( pxTask, 0UL );
+}
+/*-----------------------------------------------------------*/
+
+void vAsyncTaskNotify( AsyncTask_t *pxTask, uint32_t ulBits )
+{
+	configASSERT( pxTask );
+
+	prvNotify( pxTask, ulBits );
+}
+/*-----------------------------------------------------------*/
+
+void vAsyncTaskNotifyFromISR( AsyncTask_t *pxTask, uint32_t ulBits, BaseType_t *pxHigherPriorityTaskWoken )
+{
+AsyncEngine_t *pxEngine;
+UBaseType_t uxSavedInterruptStatus;
+BaseType_t xGiveWakeSemaphore;
+
+	configASSERT( pxTask );
+
+	pxEngine = pxTask->pxEngine;
+
+	uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+	{
+		pxTask->ulNotifiedValue |= ulBits;
+		xGiveWakeSemaphore = prvAddToPendingList( pxEngine, pxTask );
+	}
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+	if( xGiveWakeSemaphore != pdFALSE )
+	{
+		( void ) xSemaphoreGiveFromISR( pxEngine->xWakeSemaphore, pxHigherPriorityTaskWoken );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vAsyncTaskBeginWait( AsyncTask_t *pxTask, TickType_t xTicksToWait )
+{
+	/* The timeout only starts if the await cannot complete straight away. */
+	pxTask->xTicksToWait = xTicksToWait;
+	pxTask->ucTimeOutSet = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vAsyncTaskDelay( AsyncTask_t *pxTask, TickType_t xTicksToDelay )
+{
+	if( xTicksToDelay > ( TickType_t ) 0 )
+	{
+		pxTask->ucBlockedOn = asyncBLOCKED_DELAY;
+		prvAddToDelayedList( pxTask->pxEngine, pxTask, xTicksToDelay );
+	}
+	else
+	{
+		prvMakeReady( pxTask->pxEngine, pxTask );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vAsyncTaskYield( AsyncTask_t *pxTask )
+{
+	prvMakeReady( pxTask->pxEngine, pxTask );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAsyncTaskQueueReceive( AsyncTask_t *pxTask, QueueHandle_t xQueue, void *pvBuffer )
+{
+AsyncObject_t * const pxObject = prvFindObject( pxTask->pxEngine, ( QueueSetMemberHandle_t ) xQueue );
+BaseType_t xReturn;
+
+	/* The queue must have been added to the engine. */
+	configASSERT( pxObject );
+
+	if( pxObject->uxCredits > ( UBaseType_t ) 0 )
+	{
+		( pxObject->uxCredits )--;
+		xReturn = xQueueReceive( xQueue, pvBuffer, ( TickType_t ) 0 );
+
+		/* Fails if the queue is read by something other than the engine. */
+		configASSERT( xReturn == pdPASS );
+	}
+	else
+	{
+		xReturn = prvBlock( pxTask, pxObject, asyncBLOCKED_OBJECT );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAsyncTaskQueueSend( AsyncTask_t *pxTask, QueueHandle_t xQueue, const void *pvItem )
+{
+BaseType_t xReturn;
+
+	xReturn = xQueueSendToBack( xQueue, pvItem, ( TickType_t ) 0 );
+
+	if( xReturn != pdPASS )
+	{
+		xReturn = prvBlock( pxTask, NULL, asyncBLOCKED_SPACE );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAsyncTaskSemaphoreTake( AsyncTask_t *pxTask, QueueHandle_t xSemaphore )
+{
+AsyncObject_t * const pxObject = prvFindObject( pxTask->pxEngine, ( QueueSetMemberHandle_t ) xSemaphore );
+BaseType_t xReturn;
+
+	/* The semaphore must have been added to the engine. */
+	configASSERT( pxObject );
+
+	if( pxObject->uxCredits > ( UBaseType_t ) 0 )
+	{
+		( pxObject->uxCredits )--;
+		xReturn = xSemaphoreTake( xSemaphore, ( TickType_t ) 0 );
+
+		/* Fails if the semaphore is taken by something other than the engine. */
+		configASSERT( xReturn == pdPASS );
+	}
+	else
+	{
+		xReturn = prvBlock( pxTask, pxObject, asyncBLOCKED_OBJECT );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xAsyncTaskNotifyWait( AsyncTask_t *pxTask, uint32_t *pulValue )
+{
+uint32_t ulValue;
+BaseType_t xReturn;
+
+	taskENTER_CRITICAL();
+	{
+		ulValue = pxTask->ulNotifiedValue;
+		pxTask->ulNotifiedValue = 0UL;
+	}
+	taskEXIT_CRITICAL();
+
+	if( ulValue != 0UL )
+	{
+		if( pulValue != NULL )
+		{
+			*pulValue = ulValue;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xReturn = pdPASS;
+	}
+	else
+	{
+		xReturn = prvBlock( pxTask, NULL, asyncBLOCKED_NOTIFICATION );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvBlock( AsyncTask_t * const pxTask, AsyncObject_t * const pxObject, const uint8_t ucBlockedOn )
+{
+BaseType_t xReturn = asyncWOULD_BLOCK;
+
+	if( pxTask->xTicksToWait == ( TickType_t ) 0 )
+	{
+		xReturn = pdFAIL;
+	}
+	else if( pxTask->xTicksToWait == portMAX_DELAY )
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+	else if( pxTask->ucTimeOutSet == pdFALSE )
+	{
+		vTaskSetTimeOutState( &( pxTask->xTimeOut ) );
+		pxTask->ucTimeOutSet = pdTRUE;
+	}
+	else if( xTaskCheckForTimeOut( &( pxTask->xTimeOut ), &( pxTask->xTicksToWait ) ) != pdFALSE )
+	{
+		xReturn = pdFAIL;
+	}
+	else
+	{
+		/* Woken before the timeout expired.  xTicksToWait now holds the time
+		remaining. */
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xReturn == asyncWOULD_BLOCK )
+	{
+		pxTask->ucBlockedOn = ucBlockedOn;
+
+		if( pxObject != NULL )
+		{
+			vListInsertEnd( &( pxObject->xWaitingTasks ), &( pxTask->xEventListItem ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( ucBlockedOn == asyncBLOCKED_SPACE )
+		{
+			/* Queues only signal the set when data arrives, so space is
+			polled for once a tick. */
+			prvAddToDelayedList( pxTask->pxEngine, pxTask, ( TickType_t ) 1 );
+		}
+		else if( pxTask->xTicksToWait != portMAX_DELAY )
+		{
+			prvAddToDelayedList( pxTask->pxEngine, pxTask, pxTask->xTicksToWait );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMakeReady( AsyncEngine_t * const pxEngine, AsyncTask_t * const pxTask )
+{
+	if( pxTask->ucBlockedOn != asyncBLOCKED_READY )
+	{
+		if( listLIST_ITEM_CONTAINER( &( pxTask->xStateListItem ) ) != NULL )
+		{
+			( void ) uxListRemove( &( pxTask->xStateListItem ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( listLIST_ITEM_CONTAINER( &( pxTask->xEventListItem ) ) != NULL )
+		{
+			( void ) uxListRemove( &( pxTask->xEventListItem ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxTask->ucBlockedOn = asyncBLOCKED_READY;
+		pxTask->pxNextReady = NULL;
+
+		if( pxEngine->pxReadyTail != NULL )
+		{
+			pxEngine->pxReadyTail->pxNextReady = pxTask;
+		}
+		else
+		{
+			pxEngine->pxReadyHead = pxTask;
+		}
+
+		pxEngine->pxReadyTail = pxTask;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessDelayedTasks( AsyncEngine_t * const pxEngine, const TickType_t xTickCount )
+{
+AsyncTask_t *pxTask;
+List_t *pxTemp;
+
+	if( xTickCount < pxEngine->xLastTickCount )
+	{
+		/* The tick count has overflowed, so every task in the current delayed
+		list has timed out.  The overflow list becomes the current list. */
+		while( listLIST_IS_EMPTY( pxEngine->pxDelayedList ) == pdFALSE )
+		{
+			pxTask = ( AsyncTask_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxEngine->pxDelayedList ); /*lint !e9087 !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+			prvMakeReady( pxEngine, pxTask );
+		}
+
+		pxTemp = pxEngine->pxDelayedList;
+		pxEngine->pxDelayedList = pxEngine->pxOverflowDelayedList;
+		pxEngine->pxOverflowDelayedList = pxTemp;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxEngine->xLastTickCount = xTickCount;
+
+	while( ( listLIST_IS_EMPTY( pxEngine->pxDelayedList ) == pdFALSE ) &&
+		   ( listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxEngine->pxDelayedList ) <= xTickCount ) )
+	{
+		pxTask = ( AsyncTask_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxEngine->pxDelayedList ); /*lint !e9087 !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+		prvMakeReady( pxEngine, pxTask );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddToDelayedList( AsyncEngine_t * const pxEngine, AsyncTask_t * const pxTask, const TickType_t xTicksToWait )
+{
+TickType_t xTimeToWake;
+
+	/* Bring the delayed lists up to date first, so the tick count the wake
+	time is calculated from is the current tick count, and is in the same
+	overflow period as the current delayed list.  Any tasks that time out are
+	run on the next pass. */
+	prvProcessDelayedTasks( pxEngine, xTaskGetTickCount() );
+
+	xTimeToWake = pxEngine->xLastTickCount + xTicksToWait;
+	listSET_LIST_ITEM_VALUE( &( pxTask->xStateListItem ), xTimeToWake );
+
+	if( xTimeToWake < pxEngine->xLastTickCount )
+	{
+		vListInsert( pxEngine->pxOverflowDelayedList, &( pxTask->xStateListItem ) );
+	}
+	else
+	{
+		vListInsert( pxEngine->pxDelayedList, &( pxTask->xStateListItem ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvAddToPendingList( AsyncEngine_t * const pxEngine, AsyncTask_t * const pxTask )
+{
+BaseType_t xWasEmpty = pdFALSE;
+
+	if( pxTask->ucPending == pdFALSE )
+	{
+		pxTask->ucPending = pdTRUE;
+		pxTask->pxNextPending = NULL;
+
+		if( pxEngine->pxPendingTail != NULL )
+		{
+			pxEngine->pxPendingTail->pxNextPending = pxTask;
+		}
+		else
+		{
+			pxEngine->pxPendingHead = pxTask;
+			xWasEmpty = pdTRUE;
+		}
+
+		pxEngine->pxPendingTail = pxTask;
+	}
+	else
+	{
+		/* Already pending.  The notification bits have been set, so the host
+		task sees them when it processes the pending list. */
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xWasEmpty;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessPendingTasks( AsyncEngine_t * const pxEngine )
+{
+AsyncTask_t *pxTask;
+
+	/* Tasks are removed one at a time, so the critical section stays short
+	however many tasks are pending. */
+	for( ;; )
+	{
+		taskENTER_CRITICAL();
+		{
+			pxTask = pxEngine->pxPendingHead;
+
+			if( pxTask != NULL )
+			{
+				pxEngine->pxPendingHead = pxTask->pxNextPending;
+
+				if( pxEngine->pxPendingHead == NULL )
+				{
+					pxEngine->pxPendingTail = NULL;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxTask->ucPending = pdFALSE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( pxTask == NULL )
+		{
+			break;
+		}
+
+		prvWakePendingTask( pxEngine, pxTask );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWakePendingTask( AsyncEngine_t * const pxEngine, AsyncTask_t * const pxTask )
+{
+	if( ( pxTask->ucBlockedOn == asyncBLOCKED_START ) || ( pxTask->ucBlockedOn == asyncBLOCKED_NOTIFICATION ) )
+	{
+		prvMakeReady( pxEngine, pxTask );
+	}
+	else
+	{
+		/* The task is not awaiting a notification, so keeps the bits until it
+		next awaits one. */
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvNotify( AsyncTask_t * const pxTask, const uint32_t ulBits )
+{
+AsyncEngine_t * const pxEngine = pxTask->pxEngine;
+BaseType_t xGiveWakeSemaphore = pdFALSE;
+
+	if( xTaskGetCurrentTaskHandle() == pxEngine->xHostTask )
+	{
+		/* Called from one of the engine's async tasks, or before the scheduler
+		has started, so the engine state can be updated directly.  The critical
+		section only protects the notification value from interrupts. */
+		taskENTER_CRITICAL();
+		{
+			pxTask->ulNotifiedValue |= ulBits;
+		}
+		taskEXIT_CRITICAL();
+
+		prvWakePendingTask( pxEngine, pxTask );
+	}
+	else
+	{
+		taskENTER_CRITICAL();
+		{
+			pxTask->ulNotifiedValue |= ulBits;
+			xGiveWakeSemaphore = prvAddToPendingList( pxEngine, pxTask );
+		}
+		taskEXIT_CRITICAL();
+	}
+
+	if( xGiveWakeSemaphore != pdFALSE )
+	{
+		( void ) xSemaphoreGive( pxEngine->xWakeSemaphore );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static AsyncObject_t *prvFindObject( const AsyncEngine_t * const pxEngine, const QueueSetMemberHandle_t xObject )
+{
+AsyncObject_t *pxObject;
+
+	for( pxObject = pxEngine->pxObjects; pxObject != NULL; pxObject = pxObject->pxNext )
+	{
+		if( pxObject->xObject == xObject )
+		{
+			break;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return pxObject;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessEvent( AsyncEngine_t * const pxEngine, const QueueSetMemberHandle_t xMember )
+{
+AsyncObject_t *pxObject;
+AsyncTask_t *pxTask;
+
+	if( xMember == ( QueueSetMemberHandle_t ) pxEngine->xWakeSemaphore )
+	{
+		/* The pending list is processed at the start of the next pass. */
+		( void ) xSemaphoreTake( pxEngine->xWakeSemaphore, ( TickType_t ) 0 );
+	}
+	else
+	{
+		pxObject = prvFindObject( pxEngine, xMember );
+		configASSERT( pxObject );
+
+		( pxObject->uxCredits )++;
+
+		if( listLIST_IS_EMPTY( &( pxObject->xWaitingTasks ) ) == pdFALSE )
+		{
+			pxTask = ( AsyncTask_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxObject->xWaitingTasks ) ); /*lint !e9087 !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+			prvMakeReady( pxEngine, pxTask );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static TickType_t prvGetTicksToWait( const AsyncEngine_t * const pxEngine )
+{
+TickType_t xTicksToWait, xTickCount;
+
+	xTickCount = xTaskGetTickCount();
+
+	if( ( pxEngine->pxReadyHead != NULL ) || ( xTickCount < pxEngine->xLastTickCount ) )
+	{
+		/* Tasks are ready, or the tick count has overflowed since the delayed
+		lists were checked. */
+		xTicksToWait = ( TickType_t ) 0;
+	}
+	else if( listLIST_IS_EMPTY( pxEngine->pxDelayedList ) == pdFALSE )
+	{
+		xTicksToWait = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxEngine->pxDelayedList );
+
+		if( xTicksToWait > xTickCount )
+		{
+			xTicksToWait -= xTickCount;
+		}
+		else
+		{
+			xTicksToWait = ( TickType_t ) 0;
+		}
+	}
+	else if( listLIST_IS_EMPTY( pxEngine->pxOverflowDelayedList ) == pdFALSE )
+	{
+		/* Wait until the tick count overflows. */
+		xTicksToWait = ( portMAX_DELAY - xTickCount ) + ( TickType_t ) 1;
+	}
+	else
+	{
+		xTicksToWait = portMAX_DELAY;
+	}
+
+	return xTicksToWait;
+}
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+to include async engines.  This #if is closed at the very bottom of this file. */
+#endif /* configUSE_ASYNC_ENGINE == 1 */
@@ -0,0 +1,629 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes.  FreeRTOS.h includes heap_profiler.h when the heap
+profiler is used. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+to include the heap profiler.  This #if is closed at the very bottom of this
+file. */
+#if ( configUSE_HEAP_PROFILER == 1 )
+
+/* Masks a hash to an index into the allocation table. */
+#define hpTABLE_INDEX_MASK		( ( UBaseType_t ) ( configHEAP_PROFILER_ALLOCATIONS - 1 ) )
+
+/* Blocks are not recorded once the table is three quarters full, so searches
+for a free entry stay short. */
+#define hpMAX_ALLOCATIONS		( ( ( UBaseType_t ) configHEAP_PROFILER_ALLOCATIONS / 4U ) * 3U )
+
+/* The length of the longest line written by vHeapProfilerDump(). */
+#define hpMAX_LINE_LENGTH		( 128 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the index of the allocation table entry at which the search for the
+ * block at pvAddress starts.
+ */
+static UBaseType_t prvHash( const void *pvAddress ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the index of the allocation table entry that holds the block at
+ * pvAddress, or configHEAP_PROFILER_ALLOCATIONS if the block is not recorded.
+ * Must be called from a critical section.
+ */
+static UBaseType_t prvFindAllocation( const void *pvAddress ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes the allocation table entry at uxIndex, moving any following entries
+ * that would otherwise no longer be found back into the gap.  Must be called
+ * from a critical section.
+ */
+static void prvRemoveAllocation( UBaseType_t uxIndex ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the index of the calling task in the task table, adding the task if
+ * it is not already in the table, or hpNO_TASK if the scheduler has not been
+ * started or the table is full.  Must be called from a critical section.
+ */
+static uint8_t prvGetTaskIndex( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Add xSize bytes to, or remove xSize bytes from, the totals in *pxStats.
+ */
+static void prvAddBytes( HeapProfilerStats_t *pxStats, size_t xSize ) PRIVILEGED_FUNCTION;
+static void prvRemoveBytes( HeapProfilerStats_t *pxStats, size_t xSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Format a line into pcLine and pass it to pxWrite.
+ */
+static void prvWriteLine( HeapProfilerWriteFunction_t pxWrite, void *pvContext, char *pcLine, const char *pcFormat, ... ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+/* The blocks that are allocated.  An entry with a NULL pvAddress is unused. */
+PRIVILEGED_DATA static HeapProfilerAllocation_t xAllocations[ configHEAP_PROFILER_ALLOCATIONS ];
+
+/* The tasks that have allocated memory, and the totals for each tag. */
+PRIVILEGED_DATA static HeapProfilerTask_t xTasks[ configHEAP_PROFILER_TASKS ];
+PRIVILEGED_DATA static HeapProfilerStats_t xTags[ configHEAP_PROFILER_TAGS ];
+PRIVILEGED_DATA static const char *pcTagNames[ configHEAP_PROFILER_TAGS ];
+
+PRIVILEGED_DATA static UBaseType_t uxAllocationCount = 0U;
+PRIVILEGED_DATA static uint32_t ulNextSequence = 0UL;
+PRIVILEGED_DATA static uint32_t ulUntracked = 0UL;
+
+/* The task table index returned by the last call to prvGetTaskIndex(), which
+is checked first as tasks tend to make several allocations in a row. */
+PRIVILEGED_DATA static UBaseType_t uxLastTaskIndex = 0U;
+
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvHash( const void *pvAddress )
+{
+uint32_t ulHash;
+
+	/* The low bits of a block's address are always the same, as blocks are
+	aligned, so mix the higher bits down before masking. */
+	ulHash = ( uint32_t ) ( ( ( size_t ) pvAddress ) / ( size_t ) portBYTE_ALIGNMENT );
+	ulHash ^= ulHash >> 16;
+	ulHash *= 0x45d9f3bUL;
+	ulHash ^= ulHash >> 16;
+
+	return ( UBaseType_t ) ulHash & hpTABLE_INDEX_MASK;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvFindAllocation( const void *pvAddress )
+{
+UBaseType_t uxIndex;
+
+	uxIndex = prvHash( pvAddress );
+
+	/* The table is never full, so the search always ends at an unused entry if
+	the block is not found. */
+	while( xAllocations[ uxIndex ].pvAddress != NULL )
+	{
+		if( xAllocations[ uxIndex ].pvAddress == pvAddress )
+		{
+			return uxIndex;
+		}
+
+		uxIndex = ( uxIndex + 1U ) & hpTABLE_INDEX_MASK;
+	}
+
+	return ( UBaseType_t ) configHEAP_PROFILER_ALLOCATIONS;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveAllocation( UBaseType_t uxIndex )
+{
+UBaseType_t uxNext, uxHome;
+
+	uxNext = ( uxIndex + 1U ) & hpTABLE_INDEX_MASK;
+
+	while( xAllocations[ uxNext ].pvAddress != NULL )
+	{
+		/* An entry can move into the gap if the gap is between the entry's
+		home position and the entry, otherwise a search for the entry would
+		stop at the gap. */
+		uxHome = prvHash( xAllocations[ uxNext ].pvAddress );
+
+		if( ( ( uxNext - uxHome ) & hpTABLE_INDEX_MASK ) >= ( ( uxNext - uxIndex ) & hpTABLE_INDEX_MASK ) )
+		{
+			xAllocations[ uxIndex ] = xAllocations[ uxNext ];
+			uxIndex = uxNext;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		uxNext = ( uxNext + 1U ) & hpTABLE_INDEX_MASK;
+	}
+
+	xAllocations[ uxIndex ].pvAddress = NULL;
+	uxAllocationCount--;
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t prvGetTaskIndex( void )
+{
+void *pvTask;
+UBaseType_t uxIndex, uxFree = ( UBaseType_t ) configHEAP_PROFILER_TASKS;
+
+	if( xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED )
+	{
+		return ( uint8_t ) hpNO_TASK;
+	}
+
+	pvTask = ( void * ) xTaskGetCurrentTaskHandle();
+
+	if( xTasks[ uxLastTaskIndex ].pvTask == pvTask )
+	{
+		return ( uint8_t ) uxLastTaskIndex;
+	}
+
+	for( uxIndex = 0U; uxIndex < ( UBaseType_t ) configHEAP_PROFILER_TASKS; uxIndex++ )
+	{
+		if( xTasks[ uxIndex ].pvTask == pvTask )
+		{
+			uxLastTaskIndex = uxIndex;
+			return ( uint8_t ) uxIndex;
+		}
+		else if( ( xTasks[ uxIndex ].pvTask == NULL ) && ( xTasks[ uxIndex ].xStats.xCurrentBytes == 0U ) && ( uxFree == ( UBaseType_t ) configHEAP_PROFILER_TASKS ) )
+		{
+			/* The entry is unused, or belonged to a deleted task that freed
+			all its memory, so can be reused. */
+			uxFree = uxIndex;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	if( uxFree == ( UBaseType_t ) configHEAP_PROFILER_TASKS )
+	{
+		return ( uint8_t ) hpNO_TASK;
+	}
+
+	( void ) memset( &( xTasks[ uxFree ] ), 0x00, sizeof( xTasks[ uxFree ] ) );
+	xTasks[ uxFree ].pvTask = pvTask;
+	( void ) strncpy( xTasks[ uxFree ].cName, pcTaskGetName( NULL ), sizeof( xTasks[ uxFree ].cName ) - 1U );
+	uxLastTaskIndex = uxFree;
+
+	return ( uint8_t ) uxFree;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddBytes( HeapProfilerStats_t *pxStats, size_t xSize )
+{
+	pxStats->xCurrentBytes += xSize;
+	pxStats->ulAllocations++;
+
+	if( pxStats->xCurrentBytes > pxStats->xPeakBytes )
+	{
+		pxStats->xPeakBytes = pxStats->xCurrentBytes;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveBytes( HeapProfilerStats_t *pxStats, size_t xSize )
+{
+	pxStats->xCurrentBytes -= xSize;
+	pxStats->ulFrees++;
+}
+/*-----------------------------------------------------------*/
+
+void vHeapProfilerMalloc( void *pvAddress, size_t xSize, const void *pvCallSite )
+{
+UBaseType_t uxTag, uxIndex;
+uint8_t ucTask;
+
+	/* Called from within pvPortMalloc(), so always from a task, or before the
+	scheduler has started. */
+	taskENTER_CRITICAL();
+	{
+		ucTask = prvGetTaskIndex();
+
+		if( ucTask != ( uint8_t ) hpNO_TASK )
+		{
+			uxTag = uxTaskGetHeapTag( NULL );
+			configASSERT( uxTag < ( UBaseType_t ) configHEAP_PROFILER_TAGS );
+
+			if( uxTag >= ( UBaseType_t ) configHEAP_PROFILER_TAGS )
+			{
+				uxTag = hpTAG_NONE;
+			}
+		}
+		else
+		{
+			uxTag = hpTAG_NONE;
+		}
+
+		if( pvAddress == NULL )
+		{
+			xTags[ uxTag ].ulFailures++;
+
+			if( ucTask != ( uint8_t ) hpNO_TASK )
+			{
+				xTasks[ ucTask ].xStats.ulFailures++;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else if( uxAllocationCount >= hpMAX_ALLOCATIONS )
+		{
+			ulUntracked++;
+		}
+		else
+		{
+			/* Find the first unused entry from the block's home position. */
+			uxIndex = prvHash( pvAddress );
+
+			while( xAllocations[ uxIndex ].pvAddress != NULL )
+			{
+				uxIndex = ( uxIndex + 1U ) & hpTABLE_INDEX_MASK;
+			}
+
+			xAllocations[ uxIndex ].pvAddress = pvAddress;
+			xAllocations[ uxIndex ].pvCallSite = pvCallSite;
+			xAllocations[ uxIndex ].ulSize = ( uint32_t ) xSize;
+			xAllocations[ uxIndex ].ulSequence = ulNextSequence;
+			xAllocations[ uxIndex ].ucTag = ( uint8_t ) uxTag;
+			xAllocations[ uxIndex ].ucTask = ucTask;
+			uxAllocationCount++;
+
+			prvAddBytes( &( xTags[ uxTag ] ), xSize );
+
+			if( ucTask != ( uint8_t ) hpNO_TASK )
+			{
+				prvAddBytes( &( xTasks[ ucTask ].xStats ), xSize );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		ulNextSequence++;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vHeapProfilerFree( void *pvAddress )
+{
+UBaseType_t uxIndex;
+HeapProfilerAllocation_t *pxAllocation;
+
+	taskENTER_CRITICAL();
+	{
+		uxIndex = prvFindAllocation( pvAddress );
+
+		if( uxIndex != ( UBaseType_t ) configHEAP_PROFILER_ALLOCATIONS )
+		{
+			pxAllocation = &( xAllocations[ uxIndex ] );
+			prvRemoveBytes( &( xTags[ pxAllocation->ucTag ] ), ( size_t ) pxAllocation->ulSize );
+
+			if( pxAllocation->ucTask != ( uint8_t ) hpNO_TASK )
+			{
+				prvRemoveBytes( &( xTasks[ pxAllocation->ucTask ].xStats ), ( size_t ) pxAllocation->ulSize );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			prvRemoveAllocation( uxIndex );
+		}
+		else
+		{
+			/* The block was allocated while the table was full. */
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* A task's handle is the address of its TCB, so if the TCB is being
+		freed the task has been deleted, and a new task could be given the same
+		handle. */
+		for( uxIndex = 0U; uxIndex < ( UBaseType_t ) configHEAP_PROFILER_TASKS; uxIndex++ )
+		{
+			if( xTasks[ uxIndex ].pvTask == pvAddress )
+			{
+				xTasks[ uxIndex ].pvTask = NULL;
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vHeapProfilerSetTagName( UBaseType_t uxTag, const char *pcName )
+{
+	configASSERT( uxTag < ( UBaseType_t ) configHEAP_PROFILER_TAGS );
+
+	if( uxTag < ( UBaseType_t ) configHEAP_PROFILER_TAGS )
+	{
+		pcTagNames[ uxTag ] = pcName;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vHeapProfilerGetSnapshot( HeapProfilerSnapshot_t *pxSnapshot )
+{
+	configASSERT( pxSnapshot );
+
+	/* Read the free block statistics first, as vPortGetHeapStats() suspends the
+	scheduler. */
+	#if( configHEAP_PROFILER_HEAP_STATS == 1 )
+	{
+		vPortGetHeapStats( &( pxSnapshot->xHeapStats ) );
+	}
+	#endif
+
+	taskENTER_CRITICAL();
+	{
+		pxSnapshot->ulSequence = ulNextSequence;
+		pxSnapshot->ulUntracked = ulUntracked;
+		pxSnapshot->uxAllocations = uxAllocationCount;
+		( void ) memcpy( pxSnapshot->xTags, xTags, sizeof( xTags ) );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxHeapProfilerGetTasks( HeapProfilerTask_t *pxTasks, UBaseType_t uxMaxTasks )
+{
+UBaseType_t uxIndex;
+
+	configASSERT( pxTasks );
+
+	taskENTER_CRITICAL();
+	{
+		for( uxIndex = 0U; ( uxIndex < uxMaxTasks ) && ( uxIndex < ( UBaseType_t ) configHEAP_PROFILER_TASKS ); uxIndex++ )
+		{
+			pxTasks[ uxIndex ] = xTasks[ uxIndex ];
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return uxIndex;
+}
+/*-----------------------------------------------------------*/
+
+void vHeapProfilerResetPeaks( void )
+{
+UBaseType_t uxIndex;
+
+	taskENTER_CRITICAL();
+	{
+		for( uxIndex = 0U; uxIndex < ( UBaseType_t ) configHEAP_PROFILER_TAGS; uxIndex++ )
+		{
+			xTags[ uxIndex ].xPeakBytes = xTags[ uxIndex ].xCurrentBytes;
+		}
+
+		for( uxIndex = 0U; uxIndex < ( UBaseType_t ) configHEAP_PROFILER_TASKS; uxIndex++ )
+		{
+			xTasks[ uxIndex ].xStats.xPeakBytes = xTasks[ uxIndex ].xStats.xCurrentBytes;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxHeapProfilerGetAllocations( const HeapProfilerSnapshot_t *pxSince, HeapProfilerAllocation_t *pxAllocations, UBaseType_t uxMaxAllocations )
+{
+UBaseType_t uxIndex, uxCount = 0U;
+uint32_t ulSince;
+
+	configASSERT( pxAllocations );
+
+	ulSince = ( pxSince != NULL ) ? pxSince->ulSequence : 0UL;
+
+	taskENTER_CRITICAL();
+	{
+		for( uxIndex = 0U; ( uxIndex < ( UBaseType_t ) configHEAP_PROFILER_ALLOCATIONS ) && ( uxCount < uxMaxAllocations ); uxIndex++ )
+		{
+			/* Comparing the difference allows for the sequence number
+			wrapping. */
+			if( ( xAllocations[ uxIndex ].pvAddress != NULL ) &&
+				( ( xAllocations[ uxIndex ].ulSequence - ulSince ) < ( ulNextSequence - ulSince ) ) )
+			{
+				pxAllocations[ uxCount ] = xAllocations[ uxIndex ];
+				uxCount++;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteLine( HeapProfilerWriteFunction_t pxWrite, void *pvContext, char *pcLine, const char *pcFormat, ... )
+{
+va_list xArgs;
+
+	va_start( xArgs, pcFormat );
+	( void ) vsnprintf( pcLine, hpMAX_LINE_LENGTH, pcFormat, xArgs );
+	va_end( xArgs );
+
+	pxWrite( pcLine, pvContext );
+}
+/*-----------------------------------------------------------*/
+
+void vHeapProfilerDump( const HeapProfilerSnapshot_t *pxSince, HeapProfilerWriteFunction_t pxWrite, void *pvContext )
+{
+HeapProfilerSnapshot_t xNow;
+HeapProfilerTask_t xTask;
+HeapProfilerAllocation_t xAllocation;
+UBaseType_t uxIndex;
+uint32_t ulSince, ulWritten = 0UL;
+BaseType_t xFound;
+char cLine[ hpMAX_LINE_LENGTH ];
+
+	configASSERT( pxWrite );
+
+	vHeapProfilerGetSnapshot( &xNow );
+	ulSince = ( pxSince != NULL ) ? pxSince->ulSequence : 0UL;
+
+	/* The format of each line is described in tools/heap_profiler/heap_report.py. */
+	prvWriteLine( pxWrite, pvContext, cLine, "heapprof version %u %lu %lu %lu %lu",
+				  ( unsigned ) hpDUMP_VERSION,
+				  ( unsigned long ) xNow.ulSequence,
+				  ( unsigned long ) ulSince,
+				  ( unsigned long ) xNow.uxAllocations,
+				  ( unsigned long ) xNow.ulUntracked );
+
+	#if( configHEAP_PROFILER_HEAP_STATS == 1 )
+	{
+		prvWriteLine( pxWrite, pvContext, cLine, "heapprof heap %lu %lu %lu %lu %lu %lu %lu",
+					  ( unsigned long ) xNow.xHeapStats.xAvailableHeapSpaceInBytes,
+					  ( unsigned long ) xNow.xHeapStats.xMinimumEverFreeBytesRemaining,
+					  ( unsigned long ) xNow.xHeapStats.xSizeOfLargestFreeBlockInBytes,
+					  ( unsigned long ) xNow.xHeapStats.xSizeOfSmallestFreeBlockInBytes,
+					  ( unsigned long ) xNow.xHeapStats.xNumberOfFreeBlocks,
+					  ( unsigned long ) xNow.xHeapStats.xNumberOfSuccessfulAllocations,
+					  ( unsigned long ) xNow.xHeapStats.xNumberOfSuccessfulFrees );
+	}
+	#endif
+
+	for( uxIndex = 0U; uxIndex < ( UBaseType_t ) configHEAP_PROFILER_TAGS; uxIndex++ )
+	{
+		if( ( xNow.xTags[ uxIndex ].ulAllocations != 0UL ) || ( xNow.xTags[ uxIndex ].ulFailures != 0UL ) || ( pcTagNames[ uxIndex ] != NULL ) )
+		{
+			prvWriteLine( pxWrite, pvContext, cLine, "heapprof tag %u %lu %lu %lu %lu %lu %s",
+						  ( unsigned ) uxIndex,
+						  ( unsigned long ) xNow.xTags[ uxIndex ].xCurrentBytes,
+						  ( unsigned long ) xNow.xTags[ uxIndex ].xPeakBytes,
+						  ( unsigned long ) xNow.xTags[ uxIndex ].ulAllocations,
+						  ( unsigned long ) xNow.xTags[ uxIndex ].ulFrees,
+						  ( unsigned long ) xNow.xTags[ uxIndex ].ulFailures,
+						  ( pcTagNames[ uxIndex ] != NULL ) ? pcTagNames[ uxIndex ] : "" );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	for( uxIndex = 0U; uxIndex < ( UBaseType_t ) configHEAP_PROFILER_TASKS; uxIndex++ )
+	{
+		taskENTER_CRITICAL();
+		{
+			xTask = xTasks[ uxIndex ];
+		}
+		taskEXIT_CRITICAL();
+
+		if( ( xTask.pvTask != NULL ) || ( xTask.xStats.ulAllocations != 0UL ) )
+		{
+			prvWriteLine( pxWrite, pvContext, cLine, "heapprof task %u %lu %lu %lu %lu %lu %d %s",
+						  ( unsigned ) uxIndex,
+						  ( unsigned long ) xTask.xStats.xCurrentBytes,
+						  ( unsigned long ) xTask.xStats.xPeakBytes,
+						  ( unsigned long ) xTask.xStats.ulAllocations,
+						  ( unsigned long ) xTask.xStats.ulFrees,
+						  ( unsigned long ) xTask.xStats.ulFailures,
+						  ( xTask.pvTask == NULL ) ? 1 : 0,
+						  xTask.cName );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	for( uxIndex = 0U; uxIndex < ( UBaseType_t ) configHEAP_PROFILER_ALLOCATIONS; uxIndex++ )
+	{
+		taskENTER_CRITICAL();
+		{
+			xAllocation = xAllocations[ uxIndex ];
+		}
+		taskEXIT_CRITICAL();
+
+		xFound = ( xAllocation.pvAddress != NULL ) &&
+				 ( ( xAllocation.ulSequence - ulSince ) < ( xNow.ulSequence - ulSince ) );
+
+		if( xFound != pdFALSE )
+		{
+			prvWriteLine( pxWrite, pvContext, cLine, "heapprof alloc 0x%lx %lu %u %u 0x%lx %lu",
+						  ( unsigned long ) ( portPOINTER_SIZE_TYPE ) xAllocation.pvAddress,
+						  ( unsigned long ) xAllocation.ulSize,
+						  ( unsigned ) xAllocation.ucTag,
+						  ( unsigned ) xAllocation.ucTask,
+						  ( unsigned long ) ( portPOINTER_SIZE_TYPE ) xAllocation.pvCallSite,
+						  ( unsigned long ) xAllocation.ulSequence );
+			ulWritten++;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	prvWriteLine( pxWrite, pvContext, cLine, "heapprof end %lu", ( unsigned long ) ulWritten );
+}
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+to include the heap profiler.  This #if is closed at the very bottom of this
+file. */
+#endif /* configUSE_HEAP_PROFILER == 1 */
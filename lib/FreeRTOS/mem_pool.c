@@ -0,0 +1,839 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "mem_pool.h"
+
+#if( configUSE_COUNTING_SEMAPHORES != 1 )
+	#error configUSE_COUNTING_SEMAPHORES must be set to 1 to build mem_pool.c
+#endif
+
+/* Lint e961, e9021 and e750 are suppressed as a MISRA exception justified
+because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+for the header files above, but not in this file, in order to generate the
+correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/*
+ * The free blocks are held in a singly linked list, the link to the next free
+ * block being stored in the first bytes of each free block, so the pool needs
+ * no memory other than the blocks themselves.  A block is allocated by removing
+ * it from the front of the list, and freed by adding it back to the front, both
+ * inside a short critical section whose length does not depend on the number of
+ * blocks.
+ *
+ * A task that finds the pool empty blocks on a counting semaphore, so waiting
+ * tasks are queued in priority order and unblocked one at a time, in the same
+ * way as tasks waiting for any other semaphore.  The semaphore is only used
+ * when a task has to wait - when a block is freed while tasks are waiting the
+ * block is reserved for the waiting tasks, so cannot be allocated by a task or
+ * interrupt that did not wait, and the semaphore is given.  The task that takes
+ * the semaphore then removes a reserved block from the list.  A task that stops
+ * waiting because its block time expired withdraws from the waiting tasks, or,
+ * if a block has already been reserved for it, takes the semaphore.
+ *
+ * When configUSE_MEM_POOL_GUARDS is 1 each block is laid out as:
+ *
+ * [ header tag ][ block as seen by the application ][ tail guard ]
+ *
+ * The header tag says whether the block is free or allocated, so a block freed
+ * twice is detected.  The tail guard is written once when the pool is created,
+ * so a write that runs off the end of a block is detected when the block is
+ * freed.  Freed blocks are filled with mpFREE_FILL_BYTE, so a write to a block
+ * after it has been freed is detected when the block is next allocated.
+ */
+
+/* Bits stored in the ucFlags field of the memory pool. */
+#define mpFLAGS_IS_STATICALLY_ALLOCATED	( ( uint8_t ) 1 ) /* Set if the memory pool was created using statically allocated memory. */
+
+#if( configUSE_MEM_POOL_GUARDS == 1 )
+	/* Values written to the header tag and tail guard of each block.  Only the
+	least significant bits are used if UBaseType_t is less than 32 bits. */
+	#define mpHEADER_TAG_FREE			( ( UBaseType_t ) 0x5AFEF4EEUL )
+	#define mpHEADER_TAG_ALLOCATED		( ( UBaseType_t ) 0xA110CA7EUL )
+	#define mpTAIL_GUARD				( ( UBaseType_t ) 0x7A11C0DEUL )
+
+	/* The value written to every byte of a free block. */
+	#define mpFREE_FILL_BYTE			( ( uint8_t ) 0xa5U )
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Structure that hold state information on the memory pool. */
+typedef struct MemPoolDef_t /*lint !e9058 Style convention uses tag. */
+{
+	void *pvFreeList;								/* The first free block, or NULL if no blocks are free. */
+	uint8_t *pucBlocks;								/* Points to the storage area that holds the blocks. */
+	size_t xBlockSize;								/* The block size requested when the pool was created. */
+	size_t xBlockStride;							/* The number of bytes between the start of one block and the start of the next. */
+	UBaseType_t uxBlockCount;						/* The number of blocks in the pool. */
+	UBaseType_t uxBlocksFree;						/* The number of blocks in the free list, including reserved blocks. */
+	UBaseType_t uxReservedBlocks;					/* The number of blocks in the free list reserved for tasks that waited for a block. */
+	UBaseType_t uxWaitingTasks;						/* The number of tasks waiting for a block that do not yet have a block reserved. */
+	UBaseType_t uxMinimumEverBlocksFree;			/* The least number of blocks that have been in the free list. */
+	UBaseType_t uxAllocations;						/* The number of blocks allocated since the pool was created. */
+	UBaseType_t uxFailedAllocations;				/* The number of allocations that failed because the pool was empty. */
+	SemaphoreHandle_t xBlockReserved;				/* Counting semaphore given each time a block is reserved for a waiting task. */
+
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+		StaticSemaphore_t xBlockReservedBuffer;		/* Holds xBlockReserved, so creating a pool never needs more than one allocation. */
+	#endif
+
+	uint8_t ucFlags;
+
+	#if ( configUSE_TRACE_FACILITY == 1 )
+		UBaseType_t uxMemPoolNumber;				/* Used for tracing purposes. */
+	#endif
+} MemPool_t;
+
+#if( configUSE_MEM_POOL_GUARDS == 1 )
+	/*
+	 * The header tag in front of a block, and the tail guard after it, where
+	 * pucBlock is the block as seen by the application.
+	 */
+	#define mpHEADER_TAG( pucBlock ) ( *( ( volatile UBaseType_t * ) ( ( pucBlock ) - mpGUARD_SIZE_BYTES ) ) ) /*lint !e9087 !e826 Blocks are aligned to hold a UBaseType_t. */
+	#define mpTAIL_GUARD_OF( pxMemPool, pucBlock ) ( *( ( volatile UBaseType_t * ) ( ( pucBlock ) + ( pxMemPool )->xBlockStride - ( ( size_t ) 2 * mpGUARD_SIZE_BYTES ) ) ) ) /*lint !e9087 !e826 Blocks are aligned to hold a UBaseType_t. */
+#endif
+
+/*
+ * Removes the first block from the free list and updates the statistics.  Must
+ * be called from within a critical section, and only when the list holds a
+ * block that can be removed.
+ */
+static uint8_t *prvPopBlock( MemPool_t * const pxMemPool ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes a block from the free list if there is one that is not reserved.  If
+ * there is not, and xWaitIfEmpty is pdTRUE, then the calling task is counted
+ * as waiting for a block.  Returns the block, or NULL if there was no block.
+ */
+static uint8_t *prvRemoveBlock( MemPool_t * const pxMemPool,
+								BaseType_t xWaitIfEmpty,
+								BaseType_t xFromISR ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes a block reserved for the calling task, which has just taken the
+ * semaphore.
+ */
+static uint8_t *prvRemoveReservedBlock( MemPool_t * const pxMemPool ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called when the block time of a task waiting for a block expires.  Returns
+ * pdTRUE if the task stopped waiting, or pdFALSE if a block has already been
+ * reserved for it, in which case it must take the semaphore.
+ */
+static BaseType_t prvStopWaiting( MemPool_t * const pxMemPool ) PRIVILEGED_FUNCTION;
+
+/*
+ * Adds pucBlock to the front of the free list, reserving it if tasks are
+ * waiting for a block.  Returns pdTRUE if the block was reserved, in which case
+ * the semaphore must be given.
+ */
+static BaseType_t prvAddBlock( MemPool_t * const pxMemPool,
+							   uint8_t * const pucBlock,
+							   BaseType_t xFromISR ) PRIVILEGED_FUNCTION;
+
+#if( configASSERT_DEFINED == 1 )
+	/*
+	 * Returns pdTRUE if pvBlock is the start of one of the pool's blocks.  Used
+	 * to catch pointers freed to the wrong pool, or not allocated from a pool at
+	 * all.
+	 */
+	static BaseType_t prvIsBlockInPool( const MemPool_t * const pxMemPool,
+										const void * const pvBlock ) PRIVILEGED_FUNCTION;
+#endif
+
+#if( configUSE_MEM_POOL_GUARDS == 1 )
+	/*
+	 * Asserts if a block that has just been allocated was written to while it
+	 * was free, then fills the whole block with mpFREE_FILL_BYTE so the bytes
+	 * after the requested block size can be checked when the block is freed.
+	 */
+	static void prvCheckAllocatedBlock( const MemPool_t * const pxMemPool,
+										uint8_t * const pucBlock ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Asserts if a block being freed is not allocated, or if the application
+	 * wrote beyond the end of the block, then fills the block with
+	 * mpFREE_FILL_BYTE.
+	 */
+	static void prvCheckFreedBlock( const MemPool_t * const pxMemPool,
+									uint8_t * const pucBlock ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Called by both xMemPoolCreate() and xMemPoolCreateStatic() to initialise the
+ * members of the newly created memory pool structure.  Returns pdFAIL if the
+ * counting semaphore could not be created.
+ */
+static BaseType_t prvInitialiseNewMemPool( MemPool_t * const pxMemPool,
+										   uint8_t * const pucStorage,
+										   UBaseType_t uxBlockCount,
+										   size_t xBlockSize,
+										   uint8_t ucFlags ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	MemPoolHandle_t xMemPoolCreate( UBaseType_t uxBlockCount, size_t xBlockSize )
+	{
+	uint8_t *pucAllocatedMemory;
+	const size_t xHeaderSize = mpROUND_UP_TO_ALIGNMENT( sizeof( MemPool_t ) );
+
+		configASSERT( uxBlockCount > ( UBaseType_t ) 0 );
+		configASSERT( xBlockSize > ( size_t ) 0 );
+
+		/* Check for multiplication overflow. */
+		configASSERT( ( ( size_t ) uxBlockCount ) == ( mpSTORAGE_SIZE_BYTES( uxBlockCount, xBlockSize ) / mpBLOCK_SIZE_BYTES( xBlockSize ) ) );
+
+		/* The structure and the blocks are allocated in one go.  The space taken
+		by the structure is rounded up to portBYTE_ALIGNMENT so the blocks that
+		follow it are as aligned as memory returned by pvPortMalloc(). */
+		pucAllocatedMemory = ( uint8_t * ) pvPortMalloc( xHeaderSize + mpSTORAGE_SIZE_BYTES( uxBlockCount, xBlockSize ) ); /*lint !e9079 malloc() only returns void*. */
+
+		if( pucAllocatedMemory != NULL )
+		{
+			if( prvInitialiseNewMemPool( ( MemPool_t * ) pucAllocatedMemory, /* Structure at the start of the allocated memory. */ /*lint !e9087 Safe cast as allocated memory is aligned. */ /*lint !e826 Area is not too small and alignment is guaranteed provided malloc() behaves as expected and returns aligned buffer. */
+										 pucAllocatedMemory + xHeaderSize,  /* Storage area follows. */ /*lint !e9016 Indexing past structure valid for uint8_t pointer into storage area. */
+										 uxBlockCount,
+										 xBlockSize,
+										 0 ) != pdFAIL )
+			{
+				traceMEM_POOL_CREATE( ( ( MemPool_t * ) pucAllocatedMemory ) );
+			}
+			else
+			{
+				vPortFree( ( void * ) pucAllocatedMemory );
+				pucAllocatedMemory = NULL;
+				traceMEM_POOL_CREATE_FAILED();
+			}
+		}
+		else
+		{
+			traceMEM_POOL_CREATE_FAILED();
+		}
+
+		return ( MemPoolHandle_t ) pucAllocatedMemory; /*lint !e9087 !e826 Safe cast as allocated memory is aligned. */
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	MemPoolHandle_t xMemPoolCreateStatic( UBaseType_t uxBlockCount,
+										  size_t xBlockSize,
+										  uint8_t * const pucPoolStorageArea,
+										  StaticMemPool_t * const pxStaticMemPool )
+	{
+	MemPool_t * const pxMemPool = ( MemPool_t * ) pxStaticMemPool; /*lint !e740 !e9087 Safe cast as StaticMemPool_t is opaque MemPool_t. */
+	MemPoolHandle_t xReturn;
+
+		configASSERT( pucPoolStorageArea );
+		configASSERT( pxStaticMemPool );
+		configASSERT( uxBlockCount > ( UBaseType_t ) 0 );
+		configASSERT( xBlockSize > ( size_t ) 0 );
+
+		/* Blocks are handed to the application as aligned memory, so the storage
+		area must be aligned too. */
+		configASSERT( ( ( ( size_t ) pucPoolStorageArea ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == ( size_t ) 0 );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticMemPool_t equals the size of the real memory
+			pool structure. */
+			volatile size_t xSize = sizeof( StaticMemPool_t );
+			configASSERT( xSize == sizeof( MemPool_t ) );
+		} /*lint !e529 xSize is referenced is configASSERT() is defined. */
+		#endif /* configASSERT_DEFINED */
+
+		if( ( pucPoolStorageArea != NULL ) && ( pxStaticMemPool != NULL ) )
+		{
+			/* The semaphore is created in memory inside the structure, so
+			cannot fail. */
+			( void ) prvInitialiseNewMemPool( pxMemPool,
+											  pucPoolStorageArea,
+											  uxBlockCount,
+											  xBlockSize,
+											  mpFLAGS_IS_STATICALLY_ALLOCATED );
+
+			traceMEM_POOL_CREATE( pxMemPool );
+
+			xReturn = ( MemPoolHandle_t ) pxStaticMemPool; /*lint !e9087 Data hiding requires cast to opaque type. */
+		}
+		else
+		{
+			xReturn = NULL;
+			traceMEM_POOL_CREATE_FAILED();
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+void vMemPoolDelete( MemPoolHandle_t xMemPool )
+{
+MemPool_t * pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+
+	/* Blocks cannot be in use, and tasks cannot be waiting, when the pool is
+	deleted. */
+	configASSERT( pxMemPool->uxBlocksFree == pxMemPool->uxBlockCount );
+	configASSERT( pxMemPool->uxWaitingTasks == ( UBaseType_t ) 0 );
+
+	traceMEM_POOL_DELETE( xMemPool );
+
+	vSemaphoreDelete( pxMemPool->xBlockReserved );
+
+	if( ( pxMemPool->ucFlags & mpFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
+	{
+		#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+		{
+			/* Both the structure and the blocks were allocated using a single
+			call to pvPortMalloc(), hence only one call to vPortFree() is
+			required. */
+			vPortFree( ( void * ) pxMemPool ); /*lint !e9087 Standard free() semantics require void *, plus pxMemPool was allocated by pvPortMalloc(). */
+		}
+		#else
+		{
+			/* Should not be possible to get here, ucFlags must be corrupt.
+			Force an assert. */
+			configASSERT( xMemPool == ( MemPoolHandle_t ) ~0 );
+		}
+		#endif
+	}
+	else
+	{
+		/* The structure and blocks were not allocated dynamically and cannot be
+		freed - just scrub the structure so future use will assert. */
+		( void ) memset( pxMemPool, 0x00, sizeof( MemPool_t ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void *pvMemPoolAlloc( MemPoolHandle_t xMemPool, TickType_t xTicksToWait )
+{
+MemPool_t * const pxMemPool = xMemPool;
+uint8_t *pucBlock;
+
+	configASSERT( pxMemPool );
+
+	/* Cannot block if the scheduler is suspended. */
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	pucBlock = prvRemoveBlock( pxMemPool, ( xTicksToWait != ( TickType_t ) 0 ) ? pdTRUE : pdFALSE, pdFALSE );
+
+	if( ( pucBlock == NULL ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+	{
+		if( xSemaphoreTake( pxMemPool->xBlockReserved, xTicksToWait ) != pdFALSE )
+		{
+			pucBlock = prvRemoveReservedBlock( pxMemPool );
+		}
+		else if( prvStopWaiting( pxMemPool ) == pdFALSE )
+		{
+			/* A block was reserved after the block time expired but before
+			the task stopped waiting.  The semaphore is given as soon as the
+			block is reserved, so this does not wait for long. */
+			while( xSemaphoreTake( pxMemPool->xBlockReserved, portMAX_DELAY ) == pdFALSE )
+			{
+			}
+
+			pucBlock = prvRemoveReservedBlock( pxMemPool );
+		}
+		else
+		{
+			traceMEM_POOL_ALLOC_FAILED( xMemPool );
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	#if( configUSE_MEM_POOL_GUARDS == 1 )
+	{
+		if( pucBlock != NULL )
+		{
+			prvCheckAllocatedBlock( pxMemPool, pucBlock );
+		}
+	}
+	#endif
+
+	return ( void * ) pucBlock;
+}
+/*-----------------------------------------------------------*/
+
+void *pvMemPoolAllocFromISR( MemPoolHandle_t xMemPool )
+{
+MemPool_t * const pxMemPool = xMemPool;
+uint8_t *pucBlock;
+
+	configASSERT( pxMemPool );
+
+	pucBlock = prvRemoveBlock( pxMemPool, pdFALSE, pdTRUE );
+
+	#if( configUSE_MEM_POOL_GUARDS == 1 )
+	{
+		if( pucBlock != NULL )
+		{
+			prvCheckAllocatedBlock( pxMemPool, pucBlock );
+		}
+	}
+	#endif
+
+	return ( void * ) pucBlock;
+}
+/*-----------------------------------------------------------*/
+
+void vMemPoolFree( MemPoolHandle_t xMemPool, void *pvBlock )
+{
+MemPool_t * const pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+	configASSERT( prvIsBlockInPool( pxMemPool, pvBlock ) != pdFALSE );
+
+	#if( configUSE_MEM_POOL_GUARDS == 1 )
+	{
+		prvCheckFreedBlock( pxMemPool, ( uint8_t * ) pvBlock );
+	}
+	#endif
+
+	if( prvAddBlock( pxMemPool, ( uint8_t * ) pvBlock, pdFALSE ) != pdFALSE )
+	{
+		( void ) xSemaphoreGive( pxMemPool->xBlockReserved );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vMemPoolFreeFromISR( MemPoolHandle_t xMemPool,
+						  void *pvBlock,
+						  BaseType_t * const pxHigherPriorityTaskWoken )
+{
+MemPool_t * const pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+	configASSERT( prvIsBlockInPool( pxMemPool, pvBlock ) != pdFALSE );
+
+	#if( configUSE_MEM_POOL_GUARDS == 1 )
+	{
+		prvCheckFreedBlock( pxMemPool, ( uint8_t * ) pvBlock );
+	}
+	#endif
+
+	if( prvAddBlock( pxMemPool, ( uint8_t * ) pvBlock, pdTRUE ) != pdFALSE )
+	{
+		( void ) xSemaphoreGiveFromISR( pxMemPool->xBlockReserved, pxHigherPriorityTaskWoken );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vMemPoolGetStats( MemPoolHandle_t xMemPool, MemPoolStats_t *pxMemPoolStats )
+{
+const MemPool_t * const pxMemPool = xMemPool;
+
+	configASSERT( pxMemPool );
+	configASSERT( pxMemPoolStats );
+
+	taskENTER_CRITICAL();
+	{
+		pxMemPoolStats->xBlockSize = pxMemPool->xBlockSize;
+		pxMemPoolStats->uxBlockCount = pxMemPool->uxBlockCount;
+		pxMemPoolStats->uxBlocksFree = pxMemPool->uxBlocksFree;
+		pxMemPoolStats->uxMinimumEverBlocksFree = pxMemPool->uxMinimumEverBlocksFree;
+		pxMemPoolStats->uxAllocations = pxMemPool->uxAllocations;
+		pxMemPoolStats->uxFailedAllocations = pxMemPool->uxFailedAllocations;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t *prvPopBlock( MemPool_t * const pxMemPool )
+{
+uint8_t * const pucBlock = ( uint8_t * ) pxMemPool->pvFreeList;
+
+	configASSERT( pucBlock );
+
+	#if( configUSE_MEM_POOL_GUARDS == 1 )
+	{
+		/* A block in the free list that is not tagged as free means the list
+		has been corrupted. */
+		configASSERT( mpHEADER_TAG( pucBlock ) == mpHEADER_TAG_FREE );
+		mpHEADER_TAG( pucBlock ) = mpHEADER_TAG_ALLOCATED;
+	}
+	#endif
+
+	pxMemPool->pvFreeList = *( ( void ** ) pucBlock ); /*lint !e9087 !e826 Free blocks are aligned to hold a pointer. */
+	pxMemPool->uxBlocksFree--;
+	pxMemPool->uxAllocations++;
+
+	if( pxMemPool->uxBlocksFree < pxMemPool->uxMinimumEverBlocksFree )
+	{
+		pxMemPool->uxMinimumEverBlocksFree = pxMemPool->uxBlocksFree;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return pucBlock;
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t *prvRemoveBlock( MemPool_t * const pxMemPool,
+								BaseType_t xWaitIfEmpty,
+								BaseType_t xFromISR )
+{
+UBaseType_t uxSavedInterruptStatus = 0;
+uint8_t *pucBlock = NULL;
+
+	if( xFromISR != pdFALSE )
+	{
+		uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+	}
+	else
+	{
+		taskENTER_CRITICAL();
+	}
+
+	{
+		/* Reserved blocks belong to tasks that are already waiting, so are
+		not available even if the list is not empty. */
+		if( pxMemPool->uxBlocksFree > pxMemPool->uxReservedBlocks )
+		{
+			pucBlock = prvPopBlock( pxMemPool );
+		}
+		else if( xWaitIfEmpty != pdFALSE )
+		{
+			pxMemPool->uxWaitingTasks++;
+		}
+		else
+		{
+			pxMemPool->uxFailedAllocations++;
+			traceMEM_POOL_ALLOC_FAILED( pxMemPool );
+		}
+	}
+
+	if( xFromISR != pdFALSE )
+	{
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+	}
+	else
+	{
+		taskEXIT_CRITICAL();
+	}
+
+	return pucBlock;
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t *prvRemoveReservedBlock( MemPool_t * const pxMemPool )
+{
+uint8_t *pucBlock;
+
+	taskENTER_CRITICAL();
+	{
+		/* Any block in the list will do, as the list holds at least as many
+		blocks as are reserved. */
+		configASSERT( pxMemPool->uxReservedBlocks > ( UBaseType_t ) 0 );
+		pxMemPool->uxReservedBlocks--;
+		pucBlock = prvPopBlock( pxMemPool );
+	}
+	taskEXIT_CRITICAL();
+
+	return pucBlock;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvStopWaiting( MemPool_t * const pxMemPool )
+{
+BaseType_t xReturn;
+
+	taskENTER_CRITICAL();
+	{
+		/* All the waiting tasks are equivalent, so if the count of tasks that
+		do not have a block reserved is zero then one of the semaphore gives
+		still to be taken belongs to this task. */
+		if( pxMemPool->uxWaitingTasks > ( UBaseType_t ) 0 )
+		{
+			pxMemPool->uxWaitingTasks--;
+			pxMemPool->uxFailedAllocations++;
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			xReturn = pdFALSE;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvAddBlock( MemPool_t * const pxMemPool,
+							   uint8_t * const pucBlock,
+							   BaseType_t xFromISR )
+{
+UBaseType_t uxSavedInterruptStatus = 0;
+BaseType_t xReturn = pdFALSE;
+
+	if( xFromISR != pdFALSE )
+	{
+		uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+	}
+	else
+	{
+		taskENTER_CRITICAL();
+	}
+
+	{
+		#if( configUSE_MEM_POOL_GUARDS == 1 )
+		{
+			/* Checked again now no other task or interrupt can free the same
+			block. */
+			configASSERT( mpHEADER_TAG( pucBlock ) == mpHEADER_TAG_ALLOCATED );
+			mpHEADER_TAG( pucBlock ) = mpHEADER_TAG_FREE;
+		}
+		#endif
+
+		*( ( void ** ) pucBlock ) = pxMemPool->pvFreeList; /*lint !e9087 !e826 Free blocks are aligned to hold a pointer. */
+		pxMemPool->pvFreeList = ( void * ) pucBlock;
+		pxMemPool->uxBlocksFree++;
+
+		if( pxMemPool->uxWaitingTasks > ( UBaseType_t ) 0 )
+		{
+			pxMemPool->uxWaitingTasks--;
+			pxMemPool->uxReservedBlocks++;
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	if( xFromISR != pdFALSE )
+	{
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+	}
+	else
+	{
+		taskEXIT_CRITICAL();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if( configASSERT_DEFINED == 1 )
+
+	static BaseType_t prvIsBlockInPool( const MemPool_t * const pxMemPool,
+										const void * const pvBlock )
+	{
+	const uint8_t * const pucFirstBlock = pxMemPool->pucBlocks + mpGUARD_SIZE_BYTES;
+	const uint8_t * const pucBlock = ( const uint8_t * ) pvBlock;
+	size_t xOffset;
+	BaseType_t xReturn = pdFALSE;
+
+		if( ( pucBlock >= pucFirstBlock ) && ( pucBlock < ( pucFirstBlock + ( ( size_t ) pxMemPool->uxBlockCount * pxMemPool->xBlockStride ) ) ) )
+		{
+			xOffset = ( size_t ) ( pucBlock - pucFirstBlock );
+
+			if( ( xOffset % pxMemPool->xBlockStride ) == ( size_t ) 0 )
+			{
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configASSERT_DEFINED */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_MEM_POOL_GUARDS == 1 )
+
+	static void prvCheckAllocatedBlock( const MemPool_t * const pxMemPool,
+										uint8_t * const pucBlock )
+	{
+	const size_t xUsableSize = pxMemPool->xBlockStride - ( ( size_t ) 2 * mpGUARD_SIZE_BYTES );
+	size_t x;
+
+		/* The link to the next free block occupies the first bytes, everything
+		after it should still hold the fill pattern. */
+		for( x = sizeof( void * ); x < xUsableSize; x++ )
+		{
+			configASSERT( pucBlock[ x ] == mpFREE_FILL_BYTE );
+		}
+
+		( void ) memset( ( void * ) pucBlock, ( int ) mpFREE_FILL_BYTE, sizeof( void * ) );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvCheckFreedBlock( const MemPool_t * const pxMemPool,
+									uint8_t * const pucBlock )
+	{
+	const size_t xUsableSize = pxMemPool->xBlockStride - ( ( size_t ) 2 * mpGUARD_SIZE_BYTES );
+	size_t x;
+
+		/* Catches most double frees before the fill below overwrites the link
+		held in a block that is already free.  The tag is checked again inside
+		the critical section in prvAddBlock(). */
+		configASSERT( mpHEADER_TAG( pucBlock ) == mpHEADER_TAG_ALLOCATED );
+
+		/* Writes that ran past the requested block size land first in the
+		padding up to the tail guard, then in the tail guard itself. */
+		for( x = pxMemPool->xBlockSize; x < xUsableSize; x++ )
+		{
+			configASSERT( pucBlock[ x ] == mpFREE_FILL_BYTE );
+		}
+
+		configASSERT( mpTAIL_GUARD_OF( pxMemPool, pucBlock ) == mpTAIL_GUARD );
+
+		( void ) memset( ( void * ) pucBlock, ( int ) mpFREE_FILL_BYTE, xUsableSize );
+	}
+
+#endif /* configUSE_MEM_POOL_GUARDS */
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvInitialiseNewMemPool( MemPool_t * const pxMemPool,
+										   uint8_t * const pucStorage,
+										   UBaseType_t uxBlockCount,
+										   size_t xBlockSize,
+										   uint8_t ucFlags )
+{
+UBaseType_t uxBlock;
+uint8_t *pucBlock;
+BaseType_t xReturn = pdPASS;
+
+	( void ) memset( ( void * ) pxMemPool, 0x00, sizeof( MemPool_t ) ); /*lint !e9087 memset() requires void *. */
+	pxMemPool->pucBlocks = pucStorage;
+	pxMemPool->xBlockSize = xBlockSize;
+	pxMemPool->xBlockStride = mpBLOCK_SIZE_BYTES( xBlockSize );
+	pxMemPool->uxBlockCount = uxBlockCount;
+	pxMemPool->uxBlocksFree = uxBlockCount;
+	pxMemPool->uxMinimumEverBlocksFree = uxBlockCount;
+	pxMemPool->ucFlags = ucFlags;
+
+	/* The semaphore is only given when a block is reserved, so it starts
+	empty, and cannot be given more times than there are blocks. */
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	{
+		pxMemPool->xBlockReserved = xSemaphoreCreateCountingStatic( uxBlockCount, ( UBaseType_t ) 0, &( pxMemPool->xBlockReservedBuffer ) );
+	}
+	#else
+	{
+		pxMemPool->xBlockReserved = xSemaphoreCreateCounting( uxBlockCount, ( UBaseType_t ) 0 );
+	}
+	#endif
+
+	if( pxMemPool->xBlockReserved != NULL )
+	{
+		/* Link the blocks in address order, so the first blocks allocated are
+		at the start of the storage area.  Working backwards means each block
+		can be pushed onto the front of the list. */
+		for( uxBlock = uxBlockCount; uxBlock > ( UBaseType_t ) 0; uxBlock-- )
+		{
+			pucBlock = pucStorage + ( ( size_t ) ( uxBlock - ( UBaseType_t ) 1 ) * pxMemPool->xBlockStride ) + mpGUARD_SIZE_BYTES;
+
+			#if( configUSE_MEM_POOL_GUARDS == 1 )
+			{
+				( void ) memset( ( void * ) pucBlock, ( int ) mpFREE_FILL_BYTE, pxMemPool->xBlockStride - ( ( size_t ) 2 * mpGUARD_SIZE_BYTES ) );
+				mpHEADER_TAG( pucBlock ) = mpHEADER_TAG_FREE;
+				mpTAIL_GUARD_OF( pxMemPool, pucBlock ) = mpTAIL_GUARD;
+			}
+			#endif
+
+			*( ( void ** ) pucBlock ) = pxMemPool->pvFreeList; /*lint !e9087 !e826 Free blocks are aligned to hold a pointer. */
+			pxMemPool->pvFreeList = ( void * ) pucBlock;
+		}
+	}
+	else
+	{
+		xReturn = pdFAIL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	UBaseType_t uxMemPoolGetMemPoolNumber( MemPoolHandle_t xMemPool )
+	{
+		return xMemPool->uxMemPoolNumber;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	void vMemPoolSetMemPoolNumber( MemPoolHandle_t xMemPool, UBaseType_t uxMemPoolNumber )
+	{
+		xMemPool->uxMemPoolNumber = uxMemPoolNumber;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
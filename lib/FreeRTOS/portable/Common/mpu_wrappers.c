@@ -42,6 +42,13 @@ task.h is included from an application file. */
 #include "timers.h"
 #include "event_groups.h"
 #include "stream_buffer.h"
+#include "ring_buffer.h"
+#include "mem_pool.h"
+#include "rw_lock.h"
+#include "work_queue.h"
+#if( configUSE_ASYNC_ENGINE == 1 )
+	#include "async_engine.h"
+#endif
 #include "mpu_prototypes.h"
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
@@ -162,6 +169,17 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 #endif
 /*-----------------------------------------------------------*/
 
+#if ( INCLUDE_vTaskDelay == 1 )
+	void MPU_vTaskDelayUntilHighResolutionTime( const uint64_t ullWakeTime )
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vTaskDelayUntilHighResolutionTime( ullWakeTime );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_uxTaskPriorityGet == 1 )
 	UBaseType_t MPU_uxTaskPriorityGet( const TaskHandle_t pxTask )
 	{
@@ -276,6 +294,17 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 }
 /*-----------------------------------------------------------*/
 
+uint64_t MPU_ullTaskGetHighResolutionTime( void )
+{
+uint64_t ullReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	ullReturn = ullTaskGetHighResolutionTime();
+	vPortResetPrivilege( xRunningPrivileged );
+	return ullReturn;
+}
+/*-----------------------------------------------------------*/
+
 UBaseType_t MPU_uxTaskGetNumberOfTasks( void )
 {
 UBaseType_t uxReturn;
@@ -357,6 +386,32 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 #endif
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_HEAP_PROFILER == 1 )
+	UBaseType_t MPU_uxTaskSetHeapTag( UBaseType_t uxTag )
+	{
+	UBaseType_t uxReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		uxReturn = uxTaskSetHeapTag( uxTag );
+		vPortResetPrivilege( xRunningPrivileged );
+		return uxReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_HEAP_PROFILER == 1 )
+	UBaseType_t MPU_uxTaskGetHeapTag( TaskHandle_t xTask )
+	{
+	UBaseType_t uxReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		uxReturn = uxTaskGetHeapTag( xTask );
+		vPortResetPrivilege( xRunningPrivileged );
+		return uxReturn;
+	}
+#endif
+/*-----------------------------------------------------------*/
+
 #if ( configNUM_THREAD_LOCAL_STORAGE_POINTERS != 0 )
 	void MPU_vTaskSetThreadLocalStoragePointer( TaskHandle_t xTaskToSet, BaseType_t xIndex, void *pvValue )
 	{
@@ -1172,6 +1227,102 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 }
 /*-----------------------------------------------------------*/
 
+size_t MPU_xStreamBufferSendReserve( StreamBufferHandle_t xStreamBuffer, void **ppvTxData, size_t xDataLengthBytes, TickType_t xTicksToWait )
+{
+size_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xStreamBufferSendReserve( xStreamBuffer, ppvTxData, xDataLengthBytes, xTicksToWait );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t MPU_xStreamBufferSendReserveFromISR( StreamBufferHandle_t xStreamBuffer, void **ppvTxData, size_t xDataLengthBytes )
+{
+size_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xStreamBufferSendReserveFromISR( xStreamBuffer, ppvTxData, xDataLengthBytes );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t MPU_xStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes )
+{
+size_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xStreamBufferSendCommit( xStreamBuffer, xDataLengthBytes );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t MPU_xStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+size_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xStreamBufferSendCommitFromISR( xStreamBuffer, xDataLengthBytes, pxHigherPriorityTaskWoken );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t MPU_xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer, void **ppvRxData, TickType_t xTicksToWait )
+{
+size_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xStreamBufferReceiveAcquire( xStreamBuffer, ppvRxData, xTicksToWait );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t MPU_xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer, void **ppvRxData )
+{
+size_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xStreamBufferReceiveAcquireFromISR( xStreamBuffer, ppvRxData );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t MPU_xStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes )
+{
+size_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xStreamBufferReceiveRelease( xStreamBuffer, xDataLengthBytes );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t MPU_xStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+size_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xStreamBufferReceiveReleaseFromISR( xStreamBuffer, xDataLengthBytes, pxHigherPriorityTaskWoken );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
 void MPU_vStreamBufferDelete( StreamBufferHandle_t xStreamBuffer )
 {
 BaseType_t xRunningPrivileged = xPortRaisePrivilege();
@@ -1281,6 +1432,579 @@ BaseType_t xRunningPrivileged = xPortRaisePrivilege();
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 /*-----------------------------------------------------------*/
 
+BaseType_t MPU_xRingBufferSend( RingBufferHandle_t xRingBuffer, const void *pvItem, TickType_t xTicksToWait )
+{
+BaseType_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xRingBufferSend( xRingBuffer, pvItem, xTicksToWait );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t MPU_xRingBufferSendFromISR( RingBufferHandle_t xRingBuffer, const void *pvItem, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+BaseType_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xRingBufferSendFromISR( xRingBuffer, pvItem, pxHigherPriorityTaskWoken );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t MPU_xRingBufferReceive( RingBufferHandle_t xRingBuffer, void *pvBuffer, TickType_t xTicksToWait )
+{
+BaseType_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xRingBufferReceive( xRingBuffer, pvBuffer, xTicksToWait );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t MPU_xRingBufferReceiveFromISR( RingBufferHandle_t xRingBuffer, void *pvBuffer, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+BaseType_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xRingBufferReceiveFromISR( xRingBuffer, pvBuffer, pxHigherPriorityTaskWoken );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t MPU_uxRingBufferItemsWaiting( RingBufferHandle_t xRingBuffer )
+{
+UBaseType_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = uxRingBufferItemsWaiting( xRingBuffer );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void MPU_vRingBufferDelete( RingBufferHandle_t xRingBuffer )
+{
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	vRingBufferDelete( xRingBuffer );
+	vPortResetPrivilege( xRunningPrivileged );
+}
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	RingBufferHandle_t MPU_xRingBufferCreate( UBaseType_t uxSlotCount, size_t xItemSize )
+	{
+	RingBufferHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xRingBufferCreate( uxSlotCount, xItemSize );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	RingBufferHandle_t MPU_xRingBufferCreateStatic( UBaseType_t uxSlotCount, size_t xItemSize, uint8_t * const pucRingBufferStorageArea, StaticRingBuffer_t * const pxStaticRingBuffer )
+	{
+	RingBufferHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xRingBufferCreateStatic( uxSlotCount, xItemSize, pucRingBufferStorageArea, pxStaticRingBuffer );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+void *MPU_pvMemPoolAlloc( MemPoolHandle_t xMemPool, TickType_t xTicksToWait )
+{
+void *pvReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	pvReturn = pvMemPoolAlloc( xMemPool, xTicksToWait );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void *MPU_pvMemPoolAllocFromISR( MemPoolHandle_t xMemPool )
+{
+void *pvReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	pvReturn = pvMemPoolAllocFromISR( xMemPool );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void MPU_vMemPoolFree( MemPoolHandle_t xMemPool, void *pvBlock )
+{
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	vMemPoolFree( xMemPool, pvBlock );
+	vPortResetPrivilege( xRunningPrivileged );
+}
+/*-----------------------------------------------------------*/
+
+void MPU_vMemPoolFreeFromISR( MemPoolHandle_t xMemPool, void *pvBlock, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	vMemPoolFreeFromISR( xMemPool, pvBlock, pxHigherPriorityTaskWoken );
+	vPortResetPrivilege( xRunningPrivileged );
+}
+/*-----------------------------------------------------------*/
+
+void MPU_vMemPoolGetStats( MemPoolHandle_t xMemPool, MemPoolStats_t *pxMemPoolStats )
+{
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	vMemPoolGetStats( xMemPool, pxMemPoolStats );
+	vPortResetPrivilege( xRunningPrivileged );
+}
+/*-----------------------------------------------------------*/
+
+void MPU_vMemPoolDelete( MemPoolHandle_t xMemPool )
+{
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	vMemPoolDelete( xMemPool );
+	vPortResetPrivilege( xRunningPrivileged );
+}
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	MemPoolHandle_t MPU_xMemPoolCreate( UBaseType_t uxBlockCount, size_t xBlockSize )
+	{
+	MemPoolHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xMemPoolCreate( uxBlockCount, xBlockSize );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	MemPoolHandle_t MPU_xMemPoolCreateStatic( UBaseType_t uxBlockCount, size_t xBlockSize, uint8_t * const pucPoolStorageArea, StaticMemPool_t * const pxStaticMemPool )
+	{
+	MemPoolHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xMemPoolCreateStatic( uxBlockCount, xBlockSize, pucPoolStorageArea, pxStaticMemPool );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+BaseType_t MPU_xRwLockReadLock( RwLockHandle_t xRwLock, TickType_t xTicksToWait )
+{
+BaseType_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xRwLockReadLock( xRwLock, xTicksToWait );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t MPU_xRwLockReadLockFromISR( RwLockHandle_t xRwLock )
+{
+BaseType_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xRwLockReadLockFromISR( xRwLock );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void MPU_vRwLockReadUnlock( RwLockHandle_t xRwLock )
+{
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	vRwLockReadUnlock( xRwLock );
+	vPortResetPrivilege( xRunningPrivileged );
+}
+/*-----------------------------------------------------------*/
+
+void MPU_vRwLockReadUnlockFromISR( RwLockHandle_t xRwLock, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	vRwLockReadUnlockFromISR( xRwLock, pxHigherPriorityTaskWoken );
+	vPortResetPrivilege( xRunningPrivileged );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t MPU_xRwLockWriteLock( RwLockHandle_t xRwLock, TickType_t xTicksToWait )
+{
+BaseType_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xRwLockWriteLock( xRwLock, xTicksToWait );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void MPU_vRwLockWriteUnlock( RwLockHandle_t xRwLock )
+{
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	vRwLockWriteUnlock( xRwLock );
+	vPortResetPrivilege( xRunningPrivileged );
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t MPU_xRwLockGetWriter( RwLockHandle_t xRwLock )
+{
+TaskHandle_t xReturn;
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	xReturn = xRwLockGetWriter( xRwLock );
+	vPortResetPrivilege( xRunningPrivileged );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void MPU_vRwLockGetStats( RwLockHandle_t xRwLock, RwLockStats_t *pxRwLockStats )
+{
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	vRwLockGetStats( xRwLock, pxRwLockStats );
+	vPortResetPrivilege( xRunningPrivileged );
+}
+/*-----------------------------------------------------------*/
+
+void MPU_vRwLockDelete( RwLockHandle_t xRwLock )
+{
+BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+	vRwLockDelete( xRwLock );
+	vPortResetPrivilege( xRunningPrivileged );
+}
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	RwLockHandle_t MPU_xRwLockCreate( void )
+	{
+	RwLockHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xRwLockCreate();
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	RwLockHandle_t MPU_xRwLockCreateStatic( StaticRwLock_t * const pxStaticRwLock )
+	{
+	RwLockHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xRwLockCreateStatic( pxStaticRwLock );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_WORK_QUEUES == 1 )
+	WorkQueueHandle_t MPU_xWorkQueueCreate( const char * const pcName, UBaseType_t uxWorkerCount, UBaseType_t uxWorkerPriority, const configSTACK_DEPTH_TYPE usStackDepth )
+	{
+	WorkQueueHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xWorkQueueCreate( pcName, uxWorkerCount, uxWorkerPriority, usStackDepth );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configUSE_WORK_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_WORK_QUEUES == 1 )
+	void MPU_vWorkItemInit( WorkItem_t *pxWorkItem, WorkFunction_t pxFunction, void *pvParameter1, uint32_t ulParameter2 )
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vWorkItemInit( pxWorkItem, pxFunction, pvParameter1, ulParameter2 );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif /* configUSE_WORK_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_WORK_QUEUES == 1 )
+	BaseType_t MPU_xWorkQueueSubmit( WorkQueueHandle_t xWorkQueue, WorkItem_t *pxWorkItem, UBaseType_t uxPriority )
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xWorkQueueSubmit( xWorkQueue, pxWorkItem, uxPriority );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configUSE_WORK_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_WORK_QUEUES == 1 )
+	BaseType_t MPU_xWorkQueueSubmitDelayed( WorkQueueHandle_t xWorkQueue, WorkItem_t *pxWorkItem, UBaseType_t uxPriority, TickType_t xDelay )
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xWorkQueueSubmitDelayed( xWorkQueue, pxWorkItem, uxPriority, xDelay );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configUSE_WORK_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_WORK_QUEUES == 1 )
+	BaseType_t MPU_xWorkItemCancel( WorkItem_t *pxWorkItem )
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xWorkItemCancel( pxWorkItem );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configUSE_WORK_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_WORK_QUEUES == 1 )
+	BaseType_t MPU_xWorkItemIsBusy( WorkItem_t *pxWorkItem )
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xWorkItemIsBusy( pxWorkItem );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configUSE_WORK_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_WORK_QUEUES == 1 )
+	BaseType_t MPU_xWorkQueuePendFunctionCall( WorkQueueHandle_t xWorkQueue, WorkFunction_t xFunctionToPend, void *pvParameter1, uint32_t ulParameter2, UBaseType_t uxPriority, TickType_t xTicksToWait )
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xWorkQueuePendFunctionCall( xWorkQueue, xFunctionToPend, pvParameter1, ulParameter2, uxPriority, xTicksToWait );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configUSE_WORK_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_WORK_QUEUES == 1 )
+	void MPU_vWorkQueueGetStats( WorkQueueHandle_t xWorkQueue, WorkQueueStats_t *pxWorkQueueStats )
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vWorkQueueGetStats( xWorkQueue, pxWorkQueueStats );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif /* configUSE_WORK_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_WORK_QUEUES == 1 )
+	void MPU_vWorkQueueResetStats( WorkQueueHandle_t xWorkQueue )
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vWorkQueueResetStats( xWorkQueue );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif /* configUSE_WORK_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ASYNC_ENGINE == 1 )
+	AsyncEngineHandle_t MPU_xAsyncEngineCreate( UBaseType_t uxEventQueueLength )
+	{
+	AsyncEngineHandle_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xAsyncEngineCreate( uxEventQueueLength );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configUSE_ASYNC_ENGINE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ASYNC_ENGINE == 1 )
+	BaseType_t MPU_xAsyncEngineAddObject( AsyncEngineHandle_t xEngine, QueueSetMemberHandle_t xObject )
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xAsyncEngineAddObject( xEngine, xObject );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configUSE_ASYNC_ENGINE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ASYNC_ENGINE == 1 )
+	void MPU_vAsyncEngineRun( AsyncEngineHandle_t xEngine )
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vAsyncEngineRun( xEngine );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif /* configUSE_ASYNC_ENGINE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ASYNC_ENGINE == 1 )
+	void MPU_vAsyncTaskStart( AsyncEngineHandle_t xEngine, AsyncTask_t *pxTask, AsyncTaskFunction_t pxFunction, void *pvParameters )
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vAsyncTaskStart( xEngine, pxTask, pxFunction, pvParameters );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif /* configUSE_ASYNC_ENGINE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ASYNC_ENGINE == 1 )
+	void MPU_vAsyncTaskNotify( AsyncTask_t *pxTask, uint32_t ulBits )
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vAsyncTaskNotify( pxTask, ulBits );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif /* configUSE_ASYNC_ENGINE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ASYNC_ENGINE == 1 )
+	void MPU_vAsyncTaskBeginWait( AsyncTask_t *pxTask, TickType_t xTicksToWait )
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vAsyncTaskBeginWait( pxTask, xTicksToWait );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif /* configUSE_ASYNC_ENGINE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ASYNC_ENGINE == 1 )
+	void MPU_vAsyncTaskDelay( AsyncTask_t *pxTask, TickType_t xTicksToDelay )
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vAsyncTaskDelay( pxTask, xTicksToDelay );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif /* configUSE_ASYNC_ENGINE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ASYNC_ENGINE == 1 )
+	void MPU_vAsyncTaskYield( AsyncTask_t *pxTask )
+	{
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		vAsyncTaskYield( pxTask );
+		vPortResetPrivilege( xRunningPrivileged );
+	}
+#endif /* configUSE_ASYNC_ENGINE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ASYNC_ENGINE == 1 )
+	BaseType_t MPU_xAsyncTaskQueueReceive( AsyncTask_t *pxTask, QueueHandle_t xQueue, void *pvBuffer )
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xAsyncTaskQueueReceive( pxTask, xQueue, pvBuffer );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configUSE_ASYNC_ENGINE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ASYNC_ENGINE == 1 )
+	BaseType_t MPU_xAsyncTaskQueueSend( AsyncTask_t *pxTask, QueueHandle_t xQueue, const void *pvItem )
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xAsyncTaskQueueSend( pxTask, xQueue, pvItem );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configUSE_ASYNC_ENGINE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ASYNC_ENGINE == 1 )
+	BaseType_t MPU_xAsyncTaskSemaphoreTake( AsyncTask_t *pxTask, QueueHandle_t xSemaphore )
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xAsyncTaskSemaphoreTake( pxTask, xSemaphore );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configUSE_ASYNC_ENGINE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_ASYNC_ENGINE == 1 )
+	BaseType_t MPU_xAsyncTaskNotifyWait( AsyncTask_t *pxTask, uint32_t *pulValue )
+	{
+	BaseType_t xReturn;
+	BaseType_t xRunningPrivileged = xPortRaisePrivilege();
+
+		xReturn = xAsyncTaskNotifyWait( pxTask, pulValue );
+		vPortResetPrivilege( xRunningPrivileged );
+
+		return xReturn;
+	}
+#endif /* configUSE_ASYNC_ENGINE */
+/*-----------------------------------------------------------*/
+
 
 /* Functions that the application writer wants to execute in privileged mode
 can be defined in application_defined_privileged_functions.h.  The functions
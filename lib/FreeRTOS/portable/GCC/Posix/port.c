@@ -0,0 +1,731 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * POSIX (Linux) simulator port.
+ *
+ * Each task runs in its own pthread.  A simulated core is whichever one of
+ * those threads is currently unblocked on its behalf, so with configNUM_CORES
+ * set above 1 the tasks selected for each core genuinely execute in parallel on
+ * a multicore host.  Context switches are performed by the thread being
+ * switched out, which wakes the thread of the task selected to run in its place
+ * on the same core and then blocks until it is selected again.
+ *
+ * Interrupts are simulated with SIGUSR1 sent to the thread running on the
+ * target core.  Each thread has its own interrupt mask, a thread local variable
+ * rather than the host signal mask, so masking is as cheap as on real hardware.
+ * An interrupt that arrives while the mask is set is left pending in the core's
+ * pending bit mask and serviced when the mask is cleared.
+ *
+ * A thread is only ever switched out when its interrupt mask is clear, which
+ * can be in the middle of a host C library call.  C library functions that take
+ * internal locks (printf(), malloc(), etc.) must therefore only be called with
+ * interrupts masked, for example from inside a critical section, otherwise a
+ * thread switched out while holding such a lock will stop every other thread
+ * that later needs it.  Use a FreeRTOS heap implementation other than heap_3.c
+ * for the same reason.
+ */
+
+/* Standard includes. */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <sched.h>
+#include <time.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define portMAX_INTERRUPTS				( ( uint32_t ) sizeof( uint32_t ) * 8UL ) /* The number of bits in an uint32_t. */
+#define portINTERRUPT_SIGNAL			SIGUSR1
+#define portNO_CORE						( ( BaseType_t ) -1 )
+
+/*
+ * Created as a separate thread, this function uses the host clock to simulate
+ * a tick interrupt being generated on core 0 of an embedded target.
+ */
+static void *prvSimulatedPeripheralTimer( void *pvParameters );
+
+/*
+ * The entry point of every task thread.  The thread blocks until the task is
+ * first selected to run.
+ */
+static void *prvTaskThreadEntry( void *pvParameters );
+
+/*
+ * Mark an interrupt as pending on a core, and interrupt the thread running on
+ * that core so it is serviced.
+ */
+static void prvPendInterrupt( BaseType_t xCoreID, uint32_t ulInterruptNumber );
+
+/*
+ * Process all the simulated interrupts pending on the calling thread's core -
+ * each represented by a bit in the ulPendingInterrupts[] entry for the core.
+ * Called with the calling thread's interrupt mask clear.
+ */
+static void prvProcessSimulatedInterrupts( void );
+
+/*
+ * Select the next task to run on the calling thread's core and, if it is not
+ * the task that was already running, hand the core to its thread.
+ */
+static void prvSwitchThread( void );
+
+/*
+ * Interrupt handlers used by the kernel itself.  These are executed on the
+ * thread of the task that was interrupted.
+ */
+static uint32_t prvProcessYieldInterrupt( void );
+static uint32_t prvProcessTickInterrupt( void );
+
+/*
+ * The SIGUSR1 handler through which simulated interrupts are delivered.
+ */
+static void prvInterruptSignalHandler( int iSignal );
+
+/*-----------------------------------------------------------*/
+
+/* The simulator runs each task in a thread.  The context switching is managed
+by the threads, so the task stack does not have to be managed directly, although
+the task stack is still used to hold an xThreadState structure this is the only
+thing it will ever hold.  The structure indirectly maps the task handle to a
+thread. */
+typedef struct
+{
+	/* The thread that executes the task. */
+	pthread_t xThread;
+
+	/* Posted to let the thread run, and waited on by the thread when its task
+	is switched out. */
+	sem_t xWakeSemaphore;
+
+	/* The core the task runs on next, written only by the thread that wakes
+	this one. */
+	volatile BaseType_t xCoreID;
+
+	/* Set when the task has been deleted, so the thread exits the next time it
+	is woken. */
+	volatile BaseType_t xExitRequested;
+
+	/* The task function and its parameter. */
+	TaskFunction_t pxCode;
+	void *pvParameters;
+
+} xThreadState;
+
+/* A spinlock that the core holding it can take again. */
+typedef struct
+{
+	volatile BaseType_t xOwnerCore;
+	volatile UBaseType_t uxRecursionCount;
+
+} xCoreLock;
+
+/* Simulated interrupts waiting to be processed, per core.  This is a bit mask
+where each bit represents one interrupt, so a maximum of 32 interrupts can be
+simulated. */
+static volatile uint32_t ulPendingInterrupts[ configNUM_CORES ] = { 0UL };
+
+/* The thread running on each core.  Updated before that thread is woken. */
+static xThreadState * volatile pxCoreThreads[ configNUM_CORES ] = { NULL };
+
+/* Handlers for all the simulated software interrupts.  The first two positions
+are used for the Yield and Tick interrupts so are handled slightly differently,
+all the other interrupts can be user defined. */
+static uint32_t (*ulIsrHandler[ portMAX_INTERRUPTS ])( void ) = { 0 };
+
+/* The state of the task thread the calling host thread is, or NULL for the
+thread that started the scheduler and the timer thread. */
+static __thread xThreadState *pxThisThread = NULL;
+
+/* The simulated interrupt mask of the calling thread.  Threads start with
+interrupts masked, as they do on hardware before the scheduler is started. */
+static __thread volatile sig_atomic_t xInterruptsMasked = pdTRUE;
+
+#if( configNUM_CORES > 1 )
+	/* The locks used by the kernel to serialise access between cores. */
+	static xCoreLock xTaskLock = { portNO_CORE, 0U };
+	static xCoreLock xISRLock = { portNO_CORE, 0U };
+#endif /* configNUM_CORES */
+
+#if( configNUM_CORES == 1 )
+	/* Pointer to the TCB of the currently executing task. */
+	extern void * volatile pxCurrentTCB;
+#endif
+
+/* Used to ensure nothing is processed during the startup sequence. */
+static volatile BaseType_t xPortRunning = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+static xThreadState *prvGetThreadStateForCore( BaseType_t xCoreID )
+{
+void *pvTCB;
+
+	#if( configNUM_CORES == 1 )
+	{
+		( void ) xCoreID;
+		pvTCB = pxCurrentTCB;
+	}
+	#else
+	{
+		pvTCB = xTaskGetCurrentTaskHandleForCore( xCoreID );
+	}
+	#endif
+
+	/* The first member of the TCB is the top of stack, which is where the
+	thread state is held. */
+	return ( xThreadState * ) *( ( size_t * ) pvTCB );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaitToRun( xThreadState *pxThreadState )
+{
+	while( sem_wait( &( pxThreadState->xWakeSemaphore ) ) != 0 )
+	{
+		/* Interrupted by a simulated interrupt signal, which will remain
+		pending until this thread runs again. */
+	}
+
+	if( pxThreadState->xExitRequested != pdFALSE )
+	{
+		pthread_exit( NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void *prvSimulatedPeripheralTimer( void *pvParameters )
+{
+struct timespec xPeriod;
+
+	/* Just to prevent compiler warnings. */
+	( void ) pvParameters;
+
+	xPeriod.tv_sec = ( time_t ) ( portTICK_PERIOD_MS / 1000UL );
+	xPeriod.tv_nsec = ( long ) ( portTICK_PERIOD_MS % 1000UL ) * 1000000L;
+
+	for( ;; )
+	{
+		/* *NOTE* this is not a 'real time' way of generating tick events as
+		the next wake time should be relative to the previous wake time, not
+		the time that nanosleep() is called.  It is done this way to prevent
+		overruns in this very non real time simulated/emulated environment. */
+		nanosleep( &xPeriod, NULL );
+
+		configASSERT( xPortRunning );
+
+		/* The timer has expired, generate the simulated tick event. */
+		prvPendInterrupt( 0, portINTERRUPT_TICK );
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTaskThreadEntry( void *pvParameters )
+{
+xThreadState *pxThreadState = ( xThreadState * ) pvParameters;
+sigset_t xSignals;
+
+	pxThisThread = pxThreadState;
+	xInterruptsMasked = pdTRUE;
+
+	/* The thread might have been created by a thread that blocks the interrupt
+	signal. */
+	sigemptyset( &xSignals );
+	sigaddset( &xSignals, portINTERRUPT_SIGNAL );
+	pthread_sigmask( SIG_UNBLOCK, &xSignals, NULL );
+
+	prvWaitToRun( pxThreadState );
+
+	/* Start the task with interrupts enabled, servicing anything that became
+	pending before it ran. */
+	vPortClearInterruptMask( pdFALSE );
+
+	pxThreadState->pxCode( pxThreadState->pvParameters );
+
+	/* Tasks must not return from their implementing function. */
+	configASSERT( pdFALSE );
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+xThreadState *pxThreadState = NULL;
+int8_t *pcTopOfStack = ( int8_t * ) pxTopOfStack;
+UBaseType_t uxSavedInterruptStatus;
+int iResult;
+
+	/* In this simulated case a stack is not initialised, but instead a thread
+	is created that will execute the task being created.  The thread handles
+	the context switching itself.  The xThreadState object is placed onto
+	the stack that was created for the task - so the stack buffer is still
+	used, just not in the conventional way.  It will not be used for anything
+	other than holding this structure. */
+	pxThreadState = ( xThreadState * ) ( pcTopOfStack - sizeof( xThreadState ) );
+	pxThreadState->xCoreID = 0;
+	pxThreadState->xExitRequested = pdFALSE;
+	pxThreadState->pxCode = pxCode;
+	pxThreadState->pvParameters = pvParameters;
+
+	/* Creating the thread calls into the C library. */
+	uxSavedInterruptStatus = uxPortSetInterruptMask();
+	{
+		iResult = sem_init( &( pxThreadState->xWakeSemaphore ), 0, 0 );
+		configASSERT( iResult == 0 );
+
+		iResult = pthread_create( &( pxThreadState->xThread ), NULL, prvTaskThreadEntry, pxThreadState );
+		configASSERT( iResult == 0 );
+	}
+	vPortClearInterruptMask( uxSavedInterruptStatus );
+
+	/* Remove compiler warnings if configASSERT() is not defined. */
+	( void ) iResult;
+
+	return ( StackType_t * ) pxThreadState;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+struct sigaction xAction;
+sigset_t xSignals;
+pthread_t xTimerThread;
+BaseType_t xCoreID;
+
+	/* Install the interrupt handlers used by the scheduler itself. */
+	vPortSetInterruptHandler( portINTERRUPT_YIELD, prvProcessYieldInterrupt );
+	vPortSetInterruptHandler( portINTERRUPT_TICK, prvProcessTickInterrupt );
+
+	/* Deliver simulated interrupts.  The signal is blocked while the handler
+	runs, so a thread never takes a nested one. */
+	xAction.sa_handler = prvInterruptSignalHandler;
+	xAction.sa_flags = 0;
+	sigemptyset( &( xAction.sa_mask ) );
+	sigaddset( &( xAction.sa_mask ), portINTERRUPT_SIGNAL );
+
+	if( sigaction( portINTERRUPT_SIGNAL, &xAction, NULL ) != 0 )
+	{
+		return pdFAIL;
+	}
+
+	/* Neither this thread nor the timer thread, which inherits its signal
+	mask, ever runs a task. */
+	sigemptyset( &xSignals );
+	sigaddset( &xSignals, portINTERRUPT_SIGNAL );
+	pthread_sigmask( SIG_BLOCK, &xSignals, NULL );
+
+	/* The kernel has already selected the task that runs first on each core. */
+	for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUM_CORES; xCoreID++ )
+	{
+		pxCoreThreads[ xCoreID ] = prvGetThreadStateForCore( xCoreID );
+		pxCoreThreads[ xCoreID ]->xCoreID = xCoreID;
+	}
+
+	xPortRunning = pdTRUE;
+
+	/* Start the thread that simulates the timer peripheral to generate
+	tick interrupts. */
+	if( pthread_create( &xTimerThread, NULL, prvSimulatedPeripheralTimer, NULL ) != 0 )
+	{
+		return pdFAIL;
+	}
+
+	/* Start the first task on each core. */
+	for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUM_CORES; xCoreID++ )
+	{
+		sem_post( &( pxCoreThreads[ xCoreID ]->xWakeSemaphore ) );
+	}
+
+	/* The tasks run in their own threads from here on, until
+	vPortEndScheduler() exits the process. */
+	for( ;; )
+	{
+		pause();
+	}
+
+	/* Should not get here. */
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvProcessYieldInterrupt( void )
+{
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvProcessTickInterrupt( void )
+{
+uint32_t ulSwitchRequired;
+
+	/* Process the tick itself. */
+	configASSERT( xPortRunning );
+	ulSwitchRequired = ( uint32_t ) xTaskIncrementTick();
+
+	return ulSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptSignalHandler( int iSignal )
+{
+int iSavedErrno = errno;
+
+	( void ) iSignal;
+
+	/* A thread with interrupts masked leaves the interrupt pending, and only
+	threads running on a core ever have interrupts enabled. */
+	if( ( pxThisThread != NULL ) && ( xInterruptsMasked == pdFALSE ) )
+	{
+		prvProcessSimulatedInterrupts();
+	}
+
+	errno = iSavedErrno;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPendInterrupt( BaseType_t xCoreID, uint32_t ulInterruptNumber )
+{
+xThreadState *pxThreadState;
+
+	__atomic_fetch_or( &( ulPendingInterrupts[ xCoreID ] ), ( 1UL << ulInterruptNumber ), __ATOMIC_SEQ_CST );
+
+	/* If the thread read here has just been switched out then the thread
+	switched in is already woken, and as it was recorded as running on the core
+	after the interrupt was marked pending it will see the interrupt. */
+	pxThreadState = __atomic_load_n( &( pxCoreThreads[ xCoreID ] ), __ATOMIC_SEQ_CST );
+
+	if( pxThreadState == pxThisThread )
+	{
+		/* Interrupting the calling thread, which services the interrupt when
+		it next clears its interrupt mask. */
+		if( xInterruptsMasked == pdFALSE )
+		{
+			prvProcessSimulatedInterrupts();
+		}
+	}
+	else
+	{
+		pthread_kill( pxThreadState->xThread, portINTERRUPT_SIGNAL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessSimulatedInterrupts( void )
+{
+uint32_t ulPending, ulSwitchRequired, i;
+
+	do
+	{
+		xInterruptsMasked = pdTRUE;
+
+		/* The core is read on each iteration as the thread can resume on a
+		different core after switching. */
+		while( ( ulPending = __atomic_exchange_n( &( ulPendingInterrupts[ portGET_CORE_ID() ] ), 0UL, __ATOMIC_SEQ_CST ) ) != 0UL )
+		{
+			/* Used to indicate whether the simulated interrupt processing has
+			necessitated a context switch to another task/thread. */
+			ulSwitchRequired = pdFALSE;
+
+			/* For each interrupt we are interested in processing, each of
+			which is represented by a bit in the 32bit pending mask. */
+			for( i = 0; i < portMAX_INTERRUPTS; i++ )
+			{
+				/* Is the simulated interrupt pending, and is a handler
+				installed? */
+				if( ( ( ulPending & ( 1UL << i ) ) != 0UL ) && ( ulIsrHandler[ i ] != NULL ) )
+				{
+					/* Run the actual handler. */
+					traceISR_ENTER( i );
+
+					if( ulIsrHandler[ i ]() != pdFALSE )
+					{
+						ulSwitchRequired = pdTRUE;
+					}
+
+					traceISR_EXIT( i );
+				}
+			}
+
+			if( ulSwitchRequired != pdFALSE )
+			{
+				prvSwitchThread();
+			}
+		}
+
+		xInterruptsMasked = pdFALSE;
+
+		/* An interrupt that arrived after the pending mask was read but before
+		interrupts were unmasked would otherwise be left pending. */
+	} while( __atomic_load_n( &( ulPendingInterrupts[ portGET_CORE_ID() ] ), __ATOMIC_SEQ_CST ) != 0UL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchThread( void )
+{
+const BaseType_t xCoreID = portGET_CORE_ID();
+xThreadState *pxOldThreadState = pxThisThread;
+xThreadState *pxNewThreadState;
+
+	/* Select the next task to run. */
+	vTaskSwitchContext();
+
+	/* From here on the old task can be selected by another core, which updates
+	its core ID, so only xCoreID identifies the core being switched. */
+	pxNewThreadState = prvGetThreadStateForCore( xCoreID );
+
+	/* If the task selected to enter the running state is not the task that is
+	already in the running state. */
+	if( pxNewThreadState != pxOldThreadState )
+	{
+		pxNewThreadState->xCoreID = xCoreID;
+		__atomic_store_n( &( pxCoreThreads[ xCoreID ] ), pxNewThreadState, __ATOMIC_SEQ_CST );
+
+		/* Wake the new thread, and wait until this thread is selected again.
+		The new thread might still be completing its own switch on another
+		core, in which case it runs as soon as that is done. */
+		sem_post( &( pxNewThreadState->xWakeSemaphore ) );
+		prvWaitToRun( pxOldThreadState );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortDeleteThread( void *pvTaskToDelete )
+{
+xThreadState *pxThreadState;
+UBaseType_t uxSavedInterruptStatus;
+
+	/* Find the thread being deleted. */
+	pxThreadState = ( xThreadState * ) ( *( size_t *) pvTaskToDelete );
+
+	/* The task is not running on any core, so its thread is blocked, or about
+	to block, waiting to be selected.  Let it exit, and wait for it to do so
+	before the memory holding its state is freed. */
+	uxSavedInterruptStatus = uxPortSetInterruptMask();
+	{
+		pxThreadState->xExitRequested = pdTRUE;
+		sem_post( &( pxThreadState->xWakeSemaphore ) );
+		pthread_join( pxThreadState->xThread, NULL );
+		sem_destroy( &( pxThreadState->xWakeSemaphore ) );
+	}
+	vPortClearInterruptMask( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+	exit( 0 );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+UBaseType_t uxSavedInterruptStatus;
+
+	/* The yield is serviced as the interrupt mask is cleared, or when the
+	critical section the caller is in is exited. */
+	uxSavedInterruptStatus = uxPortSetInterruptMask();
+	{
+		__atomic_fetch_or( &( ulPendingInterrupts[ portGET_CORE_ID() ] ), ( 1UL << portINTERRUPT_YIELD ), __ATOMIC_SEQ_CST );
+	}
+	vPortClearInterruptMask( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPortSetInterruptMask( void )
+{
+UBaseType_t uxSavedInterruptStatus = ( UBaseType_t ) xInterruptsMasked;
+
+	xInterruptsMasked = pdTRUE;
+	__atomic_signal_fence( __ATOMIC_SEQ_CST );
+
+	return uxSavedInterruptStatus;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask( UBaseType_t uxNewMaskValue )
+{
+	__atomic_signal_fence( __ATOMIC_SEQ_CST );
+	xInterruptsMasked = ( sig_atomic_t ) uxNewMaskValue;
+
+	/* Were any interrupts set to pending while interrupts were (simulated)
+	disabled? */
+	if( ( uxNewMaskValue == pdFALSE ) && ( pxThisThread != NULL ) && ( xPortRunning != pdFALSE ) )
+	{
+		if( __atomic_load_n( &( ulPendingInterrupts[ portGET_CORE_ID() ] ), __ATOMIC_SEQ_CST ) != 0UL )
+		{
+			prvProcessSimulatedInterrupts();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber )
+{
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( xPortRunning );
+
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		uxSavedInterruptStatus = uxPortSetInterruptMask();
+		{
+			prvPendInterrupt( 0, ulInterruptNumber );
+		}
+		vPortClearInterruptMask( uxSavedInterruptStatus );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) )
+{
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		ulIsrHandler[ ulInterruptNumber ] = pvHandler;
+	}
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortGetHighResolutionCount( void )
+{
+struct timespec xNow;
+
+	/* The host's monotonic clock in nanoseconds, truncated to 32 bits.  It
+	wraps every 4.29 seconds, which is far longer than a tick period. */
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+	return ( uint32_t ) ( ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec );
+}
+/*-----------------------------------------------------------*/
+
+#if( configNUM_CORES > 1 )
+
+	BaseType_t xPortGetCoreID( void )
+	{
+	BaseType_t xReturn;
+
+		/* The thread that started the scheduler acts as core 0. */
+		if( pxThisThread != NULL )
+		{
+			xReturn = pxThisThread->xCoreID;
+		}
+		else
+		{
+			xReturn = 0;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortYieldCore( BaseType_t xCoreID )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+
+		configASSERT( ( xCoreID >= 0 ) && ( xCoreID < ( BaseType_t ) configNUM_CORES ) );
+
+		uxSavedInterruptStatus = uxPortSetInterruptMask();
+		{
+			prvPendInterrupt( xCoreID, portINTERRUPT_YIELD );
+		}
+		vPortClearInterruptMask( uxSavedInterruptStatus );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvGetLock( xCoreLock *pxLock )
+	{
+	const BaseType_t xCoreID = portGET_CORE_ID();
+	BaseType_t xExpected;
+
+		if( __atomic_load_n( &( pxLock->xOwnerCore ), __ATOMIC_ACQUIRE ) != xCoreID )
+		{
+			for( ;; )
+			{
+				xExpected = portNO_CORE;
+
+				if( __atomic_compare_exchange_n( &( pxLock->xOwnerCore ), &xExpected, xCoreID, pdFALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) != pdFALSE )
+				{
+					break;
+				}
+
+				/* The core holding the lock is another host thread, give it
+				the chance to run in case the host has fewer CPUs than there
+				are simulated cores. */
+				sched_yield();
+			}
+		}
+
+		( pxLock->uxRecursionCount )++;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvReleaseLock( xCoreLock *pxLock )
+	{
+		configASSERT( pxLock->xOwnerCore == portGET_CORE_ID() );
+		configASSERT( pxLock->uxRecursionCount > 0U );
+
+		( pxLock->uxRecursionCount )--;
+
+		if( pxLock->uxRecursionCount == 0U )
+		{
+			__atomic_store_n( &( pxLock->xOwnerCore ), portNO_CORE, __ATOMIC_RELEASE );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortGetTaskLock( void )
+	{
+		prvGetLock( &xTaskLock );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortReleaseTaskLock( void )
+	{
+		prvReleaseLock( &xTaskLock );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortGetISRLock( void )
+	{
+		prvGetLock( &xISRLock );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortReleaseISRLock( void )
+	{
+		prvReleaseLock( &xISRLock );
+	}
+
+#endif /* configNUM_CORES */
+/*-----------------------------------------------------------*/
@@ -0,0 +1,199 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+	Defines
+******************************************************************************/
+/* Type definitions. */
+#define portCHAR		char
+#define portFLOAT		float
+#define portDOUBLE		double
+#define portLONG		long
+#define portSHORT		short
+#define portSTACK_TYPE	size_t
+#define portBASE_TYPE	long
+#define portPOINTER_SIZE_TYPE size_t
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+
+#if( configUSE_16_BIT_TICKS == 1 )
+	typedef uint16_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffff
+#else
+	typedef uint32_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+
+	/* 32-bit tick type on a 32/64-bit architecture, so reads of the tick count
+	do not need to be guarded with a critical section. */
+	#define portTICK_TYPE_IS_ATOMIC 1
+#endif
+
+/* Hardware specifics. */
+#define portSTACK_GROWTH			( -1 )
+#define portTICK_PERIOD_MS			( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portINLINE					__inline
+#define portBYTE_ALIGNMENT			8
+
+#ifndef configNUM_CORES
+	#define configNUM_CORES			1
+#endif
+
+/* The simulated interrupts, see vPortGenerateSimulatedInterrupt(). */
+#define portINTERRUPT_YIELD				( 0UL )
+#define portINTERRUPT_TICK				( 1UL )
+
+void vPortYield( void );
+#define portYIELD()					vPortYield()
+
+/* Simulated interrupts return pdFALSE if no context switch should be performed,
+or a non-zero number if a context switch should be performed. */
+#define portYIELD_FROM_ISR( x )		do { if( ( x ) != pdFALSE ) { vPortYield(); } } while( 0 )
+#define portEND_SWITCHING_ISR( x )	portYIELD_FROM_ISR( ( x ) )
+
+/* Each task runs in its own pthread, which must be stopped and joined before
+the memory holding its state is freed. */
+void vPortDeleteThread( void *pvTaskToDelete );
+#define portCLEAN_UP_TCB( pxTCB )	vPortDeleteThread( pxTCB )
+
+/* Interrupts are simulated by signals, which are held pending by a per thread
+mask rather than by the host's own signal mask so masking them is cheap. */
+UBaseType_t uxPortSetInterruptMask( void );
+void vPortClearInterruptMask( UBaseType_t uxNewMaskValue );
+
+#define portDISABLE_INTERRUPTS()					( void ) uxPortSetInterruptMask()
+#define portENABLE_INTERRUPTS()						vPortClearInterruptMask( 0 )
+#define portSET_INTERRUPT_MASK_FROM_ISR()			uxPortSetInterruptMask()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )		vPortClearInterruptMask( ( x ) )
+
+/* Critical section handling.  The nesting count is held by the kernel, in the
+TCB of the running task when there is one core and in a per core array when
+there is more than one. */
+extern void vTaskEnterCritical( void );
+extern void vTaskExitCritical( void );
+
+#define portENTER_CRITICAL()		vTaskEnterCritical()
+#define portEXIT_CRITICAL()			vTaskExitCritical()
+
+#if( configNUM_CORES == 1 )
+	#define portCRITICAL_NESTING_IN_TCB		1
+#else
+	/* Each simulated core is the set of task threads that have run on it, only
+	one of which is ever unblocked.  The core a thread is running on only
+	changes while the thread is blocked. */
+	BaseType_t xPortGetCoreID( void );
+	void vPortYieldCore( BaseType_t xCoreID );
+
+	#define portGET_CORE_ID()				xPortGetCoreID()
+	#define portYIELD_CORE( xCoreID )		vPortYieldCore( ( xCoreID ) )
+
+	/* Spinlocks that can be taken recursively by the core that holds them. */
+	void vPortGetTaskLock( void );
+	void vPortReleaseTaskLock( void );
+	void vPortGetISRLock( void );
+	void vPortReleaseISRLock( void );
+
+	#define portGET_TASK_LOCK()				vPortGetTaskLock()
+	#define portRELEASE_TASK_LOCK()			vPortReleaseTaskLock()
+	#define portGET_ISR_LOCK()				vPortGetISRLock()
+	#define portRELEASE_ISR_LOCK()			vPortReleaseISRLock()
+#endif /* configNUM_CORES */
+
+/* Used by the lock-free ring buffer implementation.  Both are full barriers,
+and are safe to use from the simulated interrupt handlers. */
+#define portMEMORY_BARRIER()						__sync_synchronize()
+#define portCOMPARE_AND_SWAP( puxDestination, uxExpected, uxDesired )	\
+	( ( BaseType_t ) __sync_bool_compare_and_swap( ( puxDestination ), ( uxExpected ), ( uxDesired ) ) )
+
+/* The host's monotonic clock provides the high resolution count used by
+ullTaskGetHighResolutionTime(). */
+uint32_t ulPortGetHighResolutionCount( void );
+#define portGET_HIGH_RESOLUTION_COUNT()				ulPortGetHighResolutionCount()
+#define portHIGH_RESOLUTION_COUNT_HZ				( 1000000000UL )
+
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+	#if( configNUM_CORES == 1 )
+		#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+	#else
+		#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+	#endif
+#endif
+
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+
+	/* Check the configuration. */
+	#if( configMAX_PRIORITIES > 32 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 32.  It is very rare that a system requires more than 10 to 15 difference priorities as tasks that share a priority will time slice.
+	#endif
+
+	/* Store/clear the ready priorities in a bit map. */
+	#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+	#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+
+	/*-----------------------------------------------------------*/
+
+	#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = ( 31UL - ( uint32_t ) __builtin_clz( ( uint32_t ) ( uxReadyPriorities ) ) )
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void * pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void * pvParameters )
+
+/*
+ * Raise a simulated interrupt represented by the bit mask in ulInterruptMask.
+ * Each bit can be used to represent an individual interrupt - with the first
+ * two bits being used for the Yield and Tick interrupts respectively.  The
+ * interrupt is taken by the task running on core 0.
+ */
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber );
+
+/*
+ * Install an interrupt handler to be called by the simulated interrupt
+ * handler.  The interrupt number must be above any used by the kernel itself
+ * (at the time of writing the kernel was using interrupt numbers 0 and 1 as
+ * defined above).  The number must also be lower than 32.
+ *
+ * Interrupt handler functions must return a non-zero value if executing the
+ * handler resulted in a task switch being required.
+ *
+ * Handlers run on the thread of whichever task was interrupted, so like task
+ * code they must only call into the C library with interrupts masked - a thread
+ * that is switched out while it holds a C library lock would stop every other
+ * thread that needs that lock.
+ */
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) );
+
+#endif
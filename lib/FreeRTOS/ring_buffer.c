@@ -0,0 +1,992 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "ring_buffer.h"
+
+#if( configUSE_TASK_NOTIFICATIONS != 1 )
+	#error configUSE_TASK_NOTIFICATIONS must be set to 1 to build ring_buffer.c
+#endif
+
+/* Lint e961, e9021 and e750 are suppressed as a MISRA exception justified
+because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+for the header files above, but not in this file, in order to generate the
+correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/*
+ * Each slot holds a sequence number followed by an item.  A slot's sequence
+ * number says which position, of the ever increasing write and read positions,
+ * can next use the slot:
+ *
+ * + When the sequence number equals the write position, the slot is empty and
+ *   the producer that claims that write position can fill it.
+ *
+ * + When the sequence number is one more than the read position, the slot is
+ *   full and the consumer that claims that read position can empty it.
+ *
+ * A producer claims a write position by incrementing the write position, then
+ * copies its item into the slot, then sets the slot's sequence number so the
+ * slot is seen as full.  A consumer does the same with the read position, then
+ * sets the slot's sequence number to the write position that will next use the
+ * slot, which is one lap of the ring further on.  Producers therefore only
+ * contend with each other for the write position, and consumers with each
+ * other for the read position - the slot data itself is only ever accessed by
+ * the one task or interrupt that claimed it.
+ *
+ * When the port provides portCOMPARE_AND_SWAP() the positions are claimed with
+ * a compare-and-swap, so no critical sections are used.  Otherwise each item is
+ * added and removed inside a critical section.
+ *
+ * Producers that find the ring buffer full can block.  They wait in an event
+ * list, as tasks waiting to send to a queue do.  A consumer only enters a
+ * critical section to unblock a producer when the event list is not empty, or
+ * a producer is about to join it, so while no producer is blocked adding and
+ * removing items stays free of critical sections.
+ */
+
+/* Bits stored in the ucFlags field of the ring buffer. */
+#define rbFLAGS_IS_STATICALLY_ALLOCATED	( ( uint8_t ) 1 ) /* Set if the ring buffer was created using statically allocated memory. */
+
+#if( configUSE_PREEMPTION == 0 )
+	/* If the cooperative scheduler is being used then a yield should not be
+	performed just because a higher priority task has been woken. */
+	#define rbYIELD_IF_USING_PREEMPTION()
+#else
+	#define rbYIELD_IF_USING_PREEMPTION() portYIELD_WITHIN_API()
+#endif
+
+/*lint -save -e9026 Function like macros allowed and needed here so they can be overidden. */
+
+/* If the user has not provided an application specific notification macro,
+or #defined the notification macro away, then provide a default implementation
+that uses task notifications. */
+#ifndef rbITEM_ADDED
+	#define rbITEM_ADDED( pxRingBuffer )												\
+	{																					\
+	TaskHandle_t xTaskToNotify;															\
+																						\
+		vTaskSuspendAll();																\
+		{																				\
+			/* Read the handle once, then clear it before notifying the task so	\
+			items added before the task runs do not notify it again. */				\
+			xTaskToNotify = ( pxRingBuffer )->xTaskWaitingToReceive;					\
+																						\
+			if( xTaskToNotify != NULL )													\
+			{																			\
+				( pxRingBuffer )->xTaskWaitingToReceive = NULL;							\
+				( void ) xTaskNotify( xTaskToNotify, ( uint32_t ) 0, eNoAction );		\
+			}																			\
+		}																				\
+		( void ) xTaskResumeAll();														\
+	}
+#endif /* rbITEM_ADDED */
+
+#ifndef rbITEM_ADDED_FROM_ISR
+	#define rbITEM_ADDED_FROM_ISR( pxRingBuffer, pxHigherPriorityTaskWoken )			\
+	{																					\
+	UBaseType_t uxSavedInterruptStatus;													\
+	TaskHandle_t xTaskToNotify;															\
+																						\
+		uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();			\
+		{																				\
+			xTaskToNotify = ( pxRingBuffer )->xTaskWaitingToReceive;					\
+																						\
+			if( xTaskToNotify != NULL )													\
+			{																			\
+				( pxRingBuffer )->xTaskWaitingToReceive = NULL;							\
+				( void ) xTaskNotifyFromISR( xTaskToNotify,								\
+											 ( uint32_t ) 0,							\
+											 eNoAction,									\
+											 pxHigherPriorityTaskWoken );				\
+			}																			\
+		}																				\
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );							\
+	}
+#endif /* rbITEM_ADDED_FROM_ISR */
+/*lint -restore (9026) */
+
+/*-----------------------------------------------------------*/
+
+/* Structure that hold state information on the ring buffer. */
+typedef struct RingBufferDef_t /*lint !e9058 Style convention uses tag. */
+{
+	volatile UBaseType_t uxWritePosition;				/* The position the next producer will claim. */
+	volatile UBaseType_t uxReadPosition;				/* The position the next consumer will claim. */
+	UBaseType_t uxSlotMask;								/* The number of slots less one, the number of slots being a power of 2. */
+	size_t xItemSize;									/* The number of bytes in each item. */
+	size_t xSlotSize;									/* The number of bytes between the start of one slot and the start of the next. */
+	uint8_t *pucSlots;									/* Points to the storage area that holds the slots. */
+	volatile TaskHandle_t xTaskWaitingToReceive;		/* Holds the handle of a task waiting for an item, or NULL if no tasks are waiting. */
+	List_t xTasksWaitingToSend;							/* List of tasks that are blocked waiting for a free slot.  Stored in priority order. */
+	volatile UBaseType_t uxTasksJoiningSendList;		/* The number of tasks about to join xTasksWaitingToSend. */
+	uint8_t ucFlags;
+
+	#if ( configUSE_TRACE_FACILITY == 1 )
+		UBaseType_t uxRingBufferNumber;					/* Used for tracing purposes. */
+	#endif
+} RingBuffer_t;
+
+/*
+ * The address of the slot used by uxPosition.
+ */
+#define rbSLOT( pxRingBuffer, uxPosition ) ( &( ( pxRingBuffer )->pucSlots[ ( ( uxPosition ) & ( pxRingBuffer )->uxSlotMask ) * ( pxRingBuffer )->xSlotSize ] ) )
+
+/*
+ * The sequence number at the start of a slot.
+ */
+#define rbSEQUENCE( pucSlot ) ( *( ( volatile UBaseType_t * ) ( pucSlot ) ) ) /*lint !e9087 !e826 Slots are aligned to hold a UBaseType_t. */
+
+/*
+ * Claims the next write position, if its slot is empty, and copies pvItem into
+ * the slot.  Returns pdTRUE if the item was written, or pdFALSE if the ring
+ * buffer was full.  xFromISR selects the critical section used when the port
+ * does not provide portCOMPARE_AND_SWAP().
+ */
+static BaseType_t prvWriteItem( RingBuffer_t * const pxRingBuffer,
+								const void *pvItem,
+								BaseType_t xFromISR ) PRIVILEGED_FUNCTION;
+
+/*
+ * Claims the next read position, if its slot is full, and copies the item in
+ * the slot to pvBuffer.  Returns pdTRUE if an item was read, or pdFALSE if the
+ * ring buffer was empty.
+ */
+static BaseType_t prvReadItem( RingBuffer_t * const pxRingBuffer,
+							   void *pvBuffer,
+							   BaseType_t xFromISR ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns pdTRUE if a task is waiting for a free slot, or is about to wait for
+ * one, without entering a critical section.
+ */
+static BaseType_t prvSenderWaiting( const RingBuffer_t * const pxRingBuffer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblocks the highest priority task waiting for a free slot, if any, after an
+ * item has been removed.  From a task, a yield is performed if the unblocked
+ * task has a higher priority than the calling task.  From an interrupt,
+ * *pxHigherPriorityTaskWoken is set instead, if pxHigherPriorityTaskWoken is
+ * not NULL.
+ */
+static void prvUnblockSender( RingBuffer_t * const pxRingBuffer,
+							  BaseType_t xFromISR,
+							  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by both xRingBufferCreate() and xRingBufferCreateStatic() to
+ * initialise the members of the newly created ring buffer structure.
+ */
+static void prvInitialiseNewRingBuffer( RingBuffer_t * const pxRingBuffer,
+										uint8_t * const pucStorage,
+										UBaseType_t uxSlotCount,
+										size_t xItemSize,
+										uint8_t ucFlags ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	RingBufferHandle_t xRingBufferCreate( UBaseType_t uxSlotCount, size_t xItemSize )
+	{
+	uint8_t *pucAllocatedMemory;
+
+		/* The slot count must be a power of 2 so a position can be turned into
+		a slot index with a mask, and so the positions wrap cleanly. */
+		configASSERT( uxSlotCount > ( UBaseType_t ) 0 );
+		configASSERT( ( uxSlotCount & ( uxSlotCount - ( UBaseType_t ) 1 ) ) == ( UBaseType_t ) 0 );
+		configASSERT( xItemSize > ( size_t ) 0 );
+
+		/* Check for multiplication overflow. */
+		configASSERT( ( ( size_t ) uxSlotCount ) == ( rbSTORAGE_SIZE_BYTES( uxSlotCount, xItemSize ) / rbSLOT_SIZE_BYTES( xItemSize ) ) );
+
+		/* The structure and the slots are allocated in one go.  The size of the
+		structure is a multiple of the alignment of a UBaseType_t, so the slots
+		that follow it are aligned too. */
+		pucAllocatedMemory = ( uint8_t * ) pvPortMalloc( sizeof( RingBuffer_t ) + rbSTORAGE_SIZE_BYTES( uxSlotCount, xItemSize ) ); /*lint !e9079 malloc() only returns void*. */
+
+		if( pucAllocatedMemory != NULL )
+		{
+			prvInitialiseNewRingBuffer( ( RingBuffer_t * ) pucAllocatedMemory, /* Structure at the start of the allocated memory. */ /*lint !e9087 Safe cast as allocated memory is aligned. */ /*lint !e826 Area is not too small and alignment is guaranteed provided malloc() behaves as expected and returns aligned buffer. */
+										pucAllocatedMemory + sizeof( RingBuffer_t ),  /* Storage area follows. */ /*lint !e9016 Indexing past structure valid for uint8_t pointer into storage area. */
+										uxSlotCount,
+										xItemSize,
+										0 );
+
+			traceRING_BUFFER_CREATE( ( ( RingBuffer_t * ) pucAllocatedMemory ) );
+		}
+		else
+		{
+			traceRING_BUFFER_CREATE_FAILED();
+		}
+
+		return ( RingBufferHandle_t ) pucAllocatedMemory; /*lint !e9087 !e826 Safe cast as allocated memory is aligned. */
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	RingBufferHandle_t xRingBufferCreateStatic( UBaseType_t uxSlotCount,
+												size_t xItemSize,
+												uint8_t * const pucRingBufferStorageArea,
+												StaticRingBuffer_t * const pxStaticRingBuffer )
+	{
+	RingBuffer_t * const pxRingBuffer = ( RingBuffer_t * ) pxStaticRingBuffer; /*lint !e740 !e9087 Safe cast as StaticRingBuffer_t is opaque RingBuffer_t. */
+	RingBufferHandle_t xReturn;
+
+		configASSERT( pucRingBufferStorageArea );
+		configASSERT( pxStaticRingBuffer );
+		configASSERT( uxSlotCount > ( UBaseType_t ) 0 );
+		configASSERT( ( uxSlotCount & ( uxSlotCount - ( UBaseType_t ) 1 ) ) == ( UBaseType_t ) 0 );
+		configASSERT( xItemSize > ( size_t ) 0 );
+
+		/* The sequence numbers at the start of each slot are accessed as
+		UBaseType_t variables. */
+		configASSERT( ( ( ( size_t ) pucRingBufferStorageArea ) & ( sizeof( UBaseType_t ) - ( size_t ) 1 ) ) == ( size_t ) 0 );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticRingBuffer_t equals the size of the real ring
+			buffer structure. */
+			volatile size_t xSize = sizeof( StaticRingBuffer_t );
+			configASSERT( xSize == sizeof( RingBuffer_t ) );
+		} /*lint !e529 xSize is referenced is configASSERT() is defined. */
+		#endif /* configASSERT_DEFINED */
+
+		if( ( pucRingBufferStorageArea != NULL ) && ( pxStaticRingBuffer != NULL ) )
+		{
+			prvInitialiseNewRingBuffer( pxRingBuffer,
+										pucRingBufferStorageArea,
+										uxSlotCount,
+										xItemSize,
+										rbFLAGS_IS_STATICALLY_ALLOCATED );
+
+			traceRING_BUFFER_CREATE( pxRingBuffer );
+
+			xReturn = ( RingBufferHandle_t ) pxStaticRingBuffer; /*lint !e9087 Data hiding requires cast to opaque type. */
+		}
+		else
+		{
+			xReturn = NULL;
+			traceRING_BUFFER_CREATE_FAILED();
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+void vRingBufferDelete( RingBufferHandle_t xRingBuffer )
+{
+RingBuffer_t * pxRingBuffer = xRingBuffer;
+
+	configASSERT( pxRingBuffer );
+
+	traceRING_BUFFER_DELETE( xRingBuffer );
+
+	if( ( pxRingBuffer->ucFlags & rbFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
+	{
+		#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+		{
+			/* Both the structure and the slots were allocated using a single
+			call to pvPortMalloc(), hence only one call to vPortFree() is
+			required. */
+			vPortFree( ( void * ) pxRingBuffer ); /*lint !e9087 Standard free() semantics require void *, plus pxRingBuffer was allocated by pvPortMalloc(). */
+		}
+		#else
+		{
+			/* Should not be possible to get here, ucFlags must be corrupt.
+			Force an assert. */
+			configASSERT( xRingBuffer == ( RingBufferHandle_t ) ~0 );
+		}
+		#endif
+	}
+	else
+	{
+		/* The structure and slots were not allocated dynamically and cannot be
+		freed - just scrub the structure so future use will assert. */
+		( void ) memset( pxRingBuffer, 0x00, sizeof( RingBuffer_t ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRingBufferSend( RingBufferHandle_t xRingBuffer,
+							const void *pvItem,
+							TickType_t xTicksToWait )
+{
+RingBuffer_t * const pxRingBuffer = xRingBuffer;
+BaseType_t xReturn;
+TimeOut_t xTimeOut;
+
+	configASSERT( pxRingBuffer );
+	configASSERT( pvItem );
+
+	/* Cannot block if the scheduler is suspended. */
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	xReturn = prvWriteItem( pxRingBuffer, pvItem, pdFALSE );
+
+	if( ( xReturn == pdFALSE ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+	{
+		vTaskSetTimeOutState( &xTimeOut );
+
+		do
+		{
+			/* Count this task as joining the event list before checking for a
+			free slot again, so a consumer that frees a slot after the check
+			sees either the count or this task in the event list.  In both
+			cases the consumer enters a critical section to unblock a sender,
+			which it cannot do until this task is in the event list. */
+			taskENTER_CRITICAL();
+			{
+				( pxRingBuffer->uxTasksJoiningSendList )++;
+				portMEMORY_BARRIER();
+
+				xReturn = prvWriteItem( pxRingBuffer, pvItem, pdFALSE );
+
+				if( xReturn == pdFALSE )
+				{
+					traceBLOCKING_ON_RING_BUFFER_SEND( xRingBuffer );
+					vTaskPlaceOnEventList( &( pxRingBuffer->xTasksWaitingToSend ), xTicksToWait );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* The task must be seen in the event list before it is no
+				longer seen as joining it. */
+				portMEMORY_BARRIER();
+				( pxRingBuffer->uxTasksJoiningSendList )--;
+
+				if( xReturn == pdFALSE )
+				{
+					/* All ports are written to allow a yield in a critical
+					section (some will yield immediately, others wait until the
+					critical section exits) - but it is not something that
+					application code should ever do. */
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			/* Another producer might have taken the slot that caused this task
+			to be unblocked, in which case wait again for the remaining time. */
+		} while( ( xReturn == pdFALSE ) &&
+				 ( ( xReturn = prvWriteItem( pxRingBuffer, pvItem, pdFALSE ) ) == pdFALSE ) &&
+				 ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE ) );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xReturn != pdFALSE )
+	{
+		/* The slot must be seen as full before the waiting task is checked, as
+		the waiting task sets xTaskWaitingToReceive before it checks the slot
+		again.  One or the other is then guaranteed to see the other's write. */
+		portMEMORY_BARRIER();
+
+		if( pxRingBuffer->xTaskWaitingToReceive != NULL )
+		{
+			rbITEM_ADDED( pxRingBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xReturn = pdPASS;
+	}
+	else
+	{
+		traceRING_BUFFER_SEND_FAILED( xRingBuffer );
+		xReturn = errQUEUE_FULL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRingBufferSendFromISR( RingBufferHandle_t xRingBuffer,
+								   const void *pvItem,
+								   BaseType_t * const pxHigherPriorityTaskWoken )
+{
+RingBuffer_t * const pxRingBuffer = xRingBuffer;
+BaseType_t xReturn;
+
+	configASSERT( pxRingBuffer );
+	configASSERT( pvItem );
+
+	if( prvWriteItem( pxRingBuffer, pvItem, pdTRUE ) != pdFALSE )
+	{
+		portMEMORY_BARRIER();
+
+		if( pxRingBuffer->xTaskWaitingToReceive != NULL )
+		{
+			rbITEM_ADDED_FROM_ISR( pxRingBuffer, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xReturn = pdPASS;
+	}
+	else
+	{
+		traceRING_BUFFER_SEND_FAILED( xRingBuffer );
+		xReturn = errQUEUE_FULL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRingBufferReceive( RingBufferHandle_t xRingBuffer,
+							   void *pvBuffer,
+							   TickType_t xTicksToWait )
+{
+RingBuffer_t * const pxRingBuffer = xRingBuffer;
+BaseType_t xReturn;
+TimeOut_t xTimeOut;
+
+	configASSERT( pxRingBuffer );
+	configASSERT( pvBuffer );
+
+	xReturn = prvReadItem( pxRingBuffer, pvBuffer, pdFALSE );
+
+	if( ( xReturn == pdFALSE ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+	{
+		vTaskSetTimeOutState( &xTimeOut );
+
+		do
+		{
+			/* Clear notification state as going to wait for an item, then
+			register as the waiting task before checking for an item again, so
+			a producer that adds an item after the check is sure to see the
+			registration. */
+			( void ) xTaskNotifyStateClear( NULL );
+
+			/* Only one task can block on a ring buffer at a time. */
+			configASSERT( pxRingBuffer->xTaskWaitingToReceive == NULL );
+			pxRingBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+			portMEMORY_BARRIER();
+
+			xReturn = prvReadItem( pxRingBuffer, pvBuffer, pdFALSE );
+
+			if( xReturn == pdFALSE )
+			{
+				traceBLOCKING_ON_RING_BUFFER_RECEIVE( xRingBuffer );
+				( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxRingBuffer->xTaskWaitingToReceive = NULL;
+
+			/* Another consumer might have taken the item that caused the
+			notification, in which case wait again for the remaining time. */
+		} while( ( xReturn == pdFALSE ) &&
+				 ( ( xReturn = prvReadItem( pxRingBuffer, pvBuffer, pdFALSE ) ) == pdFALSE ) &&
+				 ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE ) );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xReturn != pdFALSE )
+	{
+		/* The slot must be seen as empty before the waiting senders are
+		checked, as a sender counts itself before it checks the slot again. */
+		portMEMORY_BARRIER();
+
+		if( prvSenderWaiting( pxRingBuffer ) != pdFALSE )
+		{
+			prvUnblockSender( pxRingBuffer, pdFALSE, NULL );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xReturn = pdPASS;
+	}
+	else
+	{
+		traceRING_BUFFER_RECEIVE_FAILED( xRingBuffer );
+		xReturn = errQUEUE_EMPTY;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRingBufferReceiveFromISR( RingBufferHandle_t xRingBuffer,
+									  void *pvBuffer,
+									  BaseType_t * const pxHigherPriorityTaskWoken )
+{
+RingBuffer_t * const pxRingBuffer = xRingBuffer;
+BaseType_t xReturn;
+
+	configASSERT( pxRingBuffer );
+	configASSERT( pvBuffer );
+
+	if( prvReadItem( pxRingBuffer, pvBuffer, pdTRUE ) != pdFALSE )
+	{
+		portMEMORY_BARRIER();
+
+		if( prvSenderWaiting( pxRingBuffer ) != pdFALSE )
+		{
+			prvUnblockSender( pxRingBuffer, pdTRUE, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xReturn = pdPASS;
+	}
+	else
+	{
+		traceRING_BUFFER_RECEIVE_FAILED( xRingBuffer );
+		xReturn = errQUEUE_EMPTY;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxRingBufferItemsWaiting( RingBufferHandle_t xRingBuffer )
+{
+const RingBuffer_t * const pxRingBuffer = xRingBuffer;
+UBaseType_t uxReadPosition, uxItems;
+
+	configASSERT( pxRingBuffer );
+
+	/* The read position is read first, so a producer and consumer that both
+	run between the two reads cannot make the result negative. */
+	uxReadPosition = pxRingBuffer->uxReadPosition;
+	uxItems = pxRingBuffer->uxWritePosition - uxReadPosition;
+
+	/* The write position can be a lap ahead of the read position read above if
+	enough items were added and removed between the two reads. */
+	if( uxItems > ( pxRingBuffer->uxSlotMask + ( UBaseType_t ) 1 ) )
+	{
+		uxItems = pxRingBuffer->uxSlotMask + ( UBaseType_t ) 1;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return uxItems;
+}
+/*-----------------------------------------------------------*/
+
+#ifdef portCOMPARE_AND_SWAP
+
+	static BaseType_t prvWriteItem( RingBuffer_t * const pxRingBuffer,
+									const void *pvItem,
+									BaseType_t xFromISR )
+	{
+	UBaseType_t uxPosition, uxSequence;
+	uint8_t *pucSlot;
+	BaseType_t xDifference, xReturn = pdFALSE;
+
+		( void ) xFromISR;
+
+		uxPosition = pxRingBuffer->uxWritePosition;
+
+		for( ;; )
+		{
+			pucSlot = rbSLOT( pxRingBuffer, uxPosition );
+			uxSequence = rbSEQUENCE( pucSlot );
+
+			/* The sequence number must be read before the slot is used.  The
+			slot is only used once it has been claimed, and the
+			compare-and-swap that claims it is a full barrier, so no other
+			barrier is needed. */
+			xDifference = ( BaseType_t ) ( uxSequence - uxPosition );
+
+			if( xDifference == ( BaseType_t ) 0 )
+			{
+				/* The slot is empty, so try to claim it.  If another producer
+				claimed it first then try again with the position it left. */
+				if( portCOMPARE_AND_SWAP( &( pxRingBuffer->uxWritePosition ), uxPosition, uxPosition + ( UBaseType_t ) 1 ) != pdFALSE )
+				{
+					xReturn = pdTRUE;
+					break;
+				}
+				else
+				{
+					uxPosition = pxRingBuffer->uxWritePosition;
+				}
+			}
+			else if( xDifference < ( BaseType_t ) 0 )
+			{
+				/* The slot still holds the item written one lap of the ring
+				ago, so the ring buffer is full. */
+				break;
+			}
+			else
+			{
+				/* Another producer claimed this position after it was read, so
+				read the position again. */
+				uxPosition = pxRingBuffer->uxWritePosition;
+			}
+		}
+
+		if( xReturn != pdFALSE )
+		{
+			( void ) memcpy( ( void * ) ( pucSlot + sizeof( UBaseType_t ) ), pvItem, pxRingBuffer->xItemSize ); /*lint !e9087 memcpy() requires void *. */
+
+			/* The item must be in the slot before the slot is seen as full. */
+			portMEMORY_BARRIER();
+			rbSEQUENCE( pucSlot ) = uxPosition + ( UBaseType_t ) 1;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvReadItem( RingBuffer_t * const pxRingBuffer,
+								   void *pvBuffer,
+								   BaseType_t xFromISR )
+	{
+	UBaseType_t uxPosition, uxSequence;
+	uint8_t *pucSlot;
+	BaseType_t xDifference, xReturn = pdFALSE;
+
+		( void ) xFromISR;
+
+		uxPosition = pxRingBuffer->uxReadPosition;
+
+		for( ;; )
+		{
+			pucSlot = rbSLOT( pxRingBuffer, uxPosition );
+			uxSequence = rbSEQUENCE( pucSlot );
+			xDifference = ( BaseType_t ) ( uxSequence - ( uxPosition + ( UBaseType_t ) 1 ) );
+
+			if( xDifference == ( BaseType_t ) 0 )
+			{
+				/* The slot is full, so try to claim it. */
+				if( portCOMPARE_AND_SWAP( &( pxRingBuffer->uxReadPosition ), uxPosition, uxPosition + ( UBaseType_t ) 1 ) != pdFALSE )
+				{
+					xReturn = pdTRUE;
+					break;
+				}
+				else
+				{
+					uxPosition = pxRingBuffer->uxReadPosition;
+				}
+			}
+			else if( xDifference < ( BaseType_t ) 0 )
+			{
+				/* The producer that claimed this position has not finished
+				writing to the slot yet, or no producer has claimed it, so
+				there is nothing to read. */
+				break;
+			}
+			else
+			{
+				/* Another consumer claimed this position after it was read. */
+				uxPosition = pxRingBuffer->uxReadPosition;
+			}
+		}
+
+		if( xReturn != pdFALSE )
+		{
+			( void ) memcpy( pvBuffer, ( const void * ) ( pucSlot + sizeof( UBaseType_t ) ), pxRingBuffer->xItemSize ); /*lint !e9087 memcpy() requires void *. */
+
+			/* The item must be copied out before the slot is seen as empty,
+			after which the producer one lap of the ring further on can write
+			to it. */
+			portMEMORY_BARRIER();
+			rbSEQUENCE( pucSlot ) = uxPosition + pxRingBuffer->uxSlotMask + ( UBaseType_t ) 1;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#else /* portCOMPARE_AND_SWAP */
+
+	static BaseType_t prvWriteItem( RingBuffer_t * const pxRingBuffer,
+									const void *pvItem,
+									BaseType_t xFromISR )
+	{
+	UBaseType_t uxSavedInterruptStatus = 0, uxPosition;
+	uint8_t *pucSlot;
+	BaseType_t xReturn = pdFALSE;
+
+		/* Without a compare-and-swap the whole update is made in a critical
+		section, which makes the update atomic with respect to every other
+		producer and consumer. */
+		if( xFromISR != pdFALSE )
+		{
+			uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+		}
+		else
+		{
+			taskENTER_CRITICAL();
+		}
+
+		{
+			uxPosition = pxRingBuffer->uxWritePosition;
+			pucSlot = rbSLOT( pxRingBuffer, uxPosition );
+
+			if( rbSEQUENCE( pucSlot ) == uxPosition )
+			{
+				( void ) memcpy( ( void * ) ( pucSlot + sizeof( UBaseType_t ) ), pvItem, pxRingBuffer->xItemSize ); /*lint !e9087 memcpy() requires void *. */
+				rbSEQUENCE( pucSlot ) = uxPosition + ( UBaseType_t ) 1;
+				pxRingBuffer->uxWritePosition = uxPosition + ( UBaseType_t ) 1;
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		if( xFromISR != pdFALSE )
+		{
+			taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+		}
+		else
+		{
+			taskEXIT_CRITICAL();
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvReadItem( RingBuffer_t * const pxRingBuffer,
+								   void *pvBuffer,
+								   BaseType_t xFromISR )
+	{
+	UBaseType_t uxSavedInterruptStatus = 0, uxPosition;
+	uint8_t *pucSlot;
+	BaseType_t xReturn = pdFALSE;
+
+		if( xFromISR != pdFALSE )
+		{
+			uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+		}
+		else
+		{
+			taskENTER_CRITICAL();
+		}
+
+		{
+			uxPosition = pxRingBuffer->uxReadPosition;
+			pucSlot = rbSLOT( pxRingBuffer, uxPosition );
+
+			if( rbSEQUENCE( pucSlot ) == ( uxPosition + ( UBaseType_t ) 1 ) )
+			{
+				( void ) memcpy( pvBuffer, ( const void * ) ( pucSlot + sizeof( UBaseType_t ) ), pxRingBuffer->xItemSize ); /*lint !e9087 memcpy() requires void *. */
+				rbSEQUENCE( pucSlot ) = uxPosition + pxRingBuffer->uxSlotMask + ( UBaseType_t ) 1;
+				pxRingBuffer->uxReadPosition = uxPosition + ( UBaseType_t ) 1;
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		if( xFromISR != pdFALSE )
+		{
+			taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+		}
+		else
+		{
+			taskEXIT_CRITICAL();
+		}
+
+		return xReturn;
+	}
+
+#endif /* portCOMPARE_AND_SWAP */
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSenderWaiting( const RingBuffer_t * const pxRingBuffer )
+{
+BaseType_t xReturn;
+
+	/* A sender stops counting itself as joining the event list only once it
+	is in the list, so the count is read first. */
+	if( pxRingBuffer->uxTasksJoiningSendList != ( UBaseType_t ) 0 )
+	{
+		xReturn = pdTRUE;
+	}
+	else
+	{
+		portMEMORY_BARRIER();
+		xReturn = ( listLIST_IS_EMPTY( &( pxRingBuffer->xTasksWaitingToSend ) ) == pdFALSE ) ? pdTRUE : pdFALSE;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnblockSender( RingBuffer_t * const pxRingBuffer,
+							  BaseType_t xFromISR,
+							  BaseType_t * const pxHigherPriorityTaskWoken )
+{
+UBaseType_t uxSavedInterruptStatus = 0;
+BaseType_t xYieldRequired = pdFALSE;
+
+	if( xFromISR != pdFALSE )
+	{
+		uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+	}
+	else
+	{
+		taskENTER_CRITICAL();
+	}
+
+	{
+		/* A sender that was counted as joining the list might have found a
+		free slot instead, so the list can be empty. */
+		if( listLIST_IS_EMPTY( &( pxRingBuffer->xTasksWaitingToSend ) ) == pdFALSE )
+		{
+			xYieldRequired = xTaskRemoveFromEventList( &( pxRingBuffer->xTasksWaitingToSend ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	if( xFromISR != pdFALSE )
+	{
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+		if( ( xYieldRequired != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+		{
+			*pxHigherPriorityTaskWoken = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		if( xYieldRequired != pdFALSE )
+		{
+			rbYIELD_IF_USING_PREEMPTION();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewRingBuffer( RingBuffer_t * const pxRingBuffer,
+										uint8_t * const pucStorage,
+										UBaseType_t uxSlotCount,
+										size_t xItemSize,
+										uint8_t ucFlags )
+{
+UBaseType_t uxSlot;
+
+	( void ) memset( ( void * ) pxRingBuffer, 0x00, sizeof( RingBuffer_t ) ); /*lint !e9087 memset() requires void *. */
+	pxRingBuffer->pucSlots = pucStorage;
+	pxRingBuffer->uxSlotMask = uxSlotCount - ( UBaseType_t ) 1;
+	pxRingBuffer->xItemSize = xItemSize;
+	pxRingBuffer->xSlotSize = rbSLOT_SIZE_BYTES( xItemSize );
+	pxRingBuffer->ucFlags = ucFlags;
+	vListInitialise( &( pxRingBuffer->xTasksWaitingToSend ) );
+
+	/* Each slot starts empty, ready for the first lap of write positions. */
+	for( uxSlot = ( UBaseType_t ) 0; uxSlot < uxSlotCount; uxSlot++ )
+	{
+		rbSEQUENCE( rbSLOT( pxRingBuffer, uxSlot ) ) = uxSlot;
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	UBaseType_t uxRingBufferGetRingBufferNumber( RingBufferHandle_t xRingBuffer )
+	{
+		return xRingBuffer->uxRingBufferNumber;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	void vRingBufferSetRingBufferNumber( RingBufferHandle_t xRingBuffer, UBaseType_t uxRingBufferNumber )
+	{
+		xRingBuffer->uxRingBufferNumber = uxRingBufferNumber;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
@@ -0,0 +1,910 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "rw_lock.h"
+
+#if( configUSE_COUNTING_SEMAPHORES != 1 )
+	#error configUSE_COUNTING_SEMAPHORES must be set to 1 to build rw_lock.c
+#endif
+
+#if( ( INCLUDE_xTaskGetCurrentTaskHandle != 1 ) && ( configUSE_MUTEXES != 1 ) )
+	#error INCLUDE_xTaskGetCurrentTaskHandle or configUSE_MUTEXES must be set to 1 to build rw_lock.c
+#endif
+
+/* Lint e961, e9021 and e750 are suppressed as a MISRA exception justified
+because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+for the header files above, but not in this file, in order to generate the
+correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/*
+ * The state of the lock - the number of read locks held, the writer, and the
+ * number of tasks waiting to read and to write - is only accessed inside short
+ * critical sections, so taking and releasing an uncontended lock never blocks.
+ *
+ * A task that has to wait blocks on one of two counting semaphores, one for
+ * readers and one for writers, so waiting tasks of each kind are queued in
+ * priority order in the same way as tasks waiting for any other semaphore.
+ * The semaphores are only used when a task has to wait.  When the lock is
+ * released to waiting tasks it is granted to them before the semaphore is
+ * given - the read lock count is increased by the number of waiting readers,
+ * or the lock is reserved for a waiting writer - so no other task or interrupt
+ * can take the lock in between.  A task that stops waiting because its block
+ * time expired withdraws from the waiting tasks, or, if the lock has already
+ * been granted to it, takes the semaphore.  As with memory pools all the
+ * waiting tasks of one kind are equivalent, so it does not matter which of
+ * them takes a given semaphore.
+ *
+ * The priority of the highest priority waiting reader and writer are recorded
+ * when the tasks start to wait, and are only cleared when no tasks of that
+ * kind are waiting.  They can therefore be higher than the priority of any
+ * task still waiting, which only makes the lock favour writers a little more
+ * than it otherwise would.
+ */
+
+/* Bits stored in the ucFlags field of the lock. */
+#define rwlFLAGS_IS_STATICALLY_ALLOCATED	( ( uint8_t ) 1 ) /* Set if the lock was created using statically allocated memory. */
+
+/* The number of times the reader semaphore can be given.  Read locks are only
+granted to waiting tasks, so the count can never get close to this. */
+#define rwlMAX_READ_GRANTS					( ( UBaseType_t ) ~( ( UBaseType_t ) 0 ) )
+
+/* The priority used to choose between readers and writers.  Without
+uxTaskPriorityGet() all tasks are treated as having the same priority, so
+waiting writers are always preferred. */
+#if( INCLUDE_uxTaskPriorityGet == 1 )
+	#define rwlCURRENT_PRIORITY()			uxTaskPriorityGet( NULL )
+#else
+	#define rwlCURRENT_PRIORITY()			( ( UBaseType_t ) tskIDLE_PRIORITY )
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Structure that hold state information on the reader-writer lock. */
+typedef struct RwLockDef_t /*lint !e9058 Style convention uses tag. */
+{
+	TaskHandle_t xWriter;							/* The task holding the lock for writing, or NULL. */
+	UBaseType_t uxReaders;							/* The number of read locks held, including those granted to tasks that have not yet taken their semaphore. */
+	UBaseType_t uxWaitingReaders;					/* The number of tasks waiting to read that have not been granted the lock. */
+	UBaseType_t uxWaitingWriters;					/* The number of tasks waiting to write that have not been granted the lock. */
+	UBaseType_t uxTopReaderPriority;				/* The highest priority of the tasks waiting to read. */
+	UBaseType_t uxTopWriterPriority;				/* The highest priority of the tasks waiting to write. */
+	UBaseType_t uxReadLocks;						/* The number of read locks taken since the lock was created. */
+	UBaseType_t uxWriteLocks;						/* The number of write locks taken since the lock was created. */
+	UBaseType_t uxContendedLocks;					/* The number of times a task had to wait to take the lock. */
+	UBaseType_t uxFailedLocks;						/* The number of attempts to take the lock that failed. */
+	SemaphoreHandle_t xReadGranted;					/* Counting semaphore given once for each waiting reader granted a read lock. */
+	SemaphoreHandle_t xWriteGranted;				/* Counting semaphore given when the lock is reserved for a waiting writer. */
+
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+		StaticSemaphore_t xReadGrantedBuffer;		/* Holds xReadGranted, so creating a lock never needs more than one allocation. */
+		StaticSemaphore_t xWriteGrantedBuffer;		/* Holds xWriteGranted. */
+	#endif
+
+	uint8_t ucWriteReserved;						/* pdTRUE if the lock has been granted to a waiting writer that has not yet taken its semaphore. */
+	uint8_t ucFlags;
+
+	#if ( configUSE_TRACE_FACILITY == 1 )
+		UBaseType_t uxRwLockNumber;					/* Used for tracing purposes. */
+	#endif
+} RwLock_t;
+
+/*
+ * Takes a read lock if one can be taken immediately.  If one cannot, and
+ * xWaitIfBusy is pdTRUE, then the calling task is counted as waiting to read.
+ * Returns pdPASS if the read lock was taken.
+ */
+static BaseType_t prvTryReadLock( RwLock_t * const pxRwLock,
+								  BaseType_t xWaitIfBusy,
+								  BaseType_t xFromISR ) PRIVILEGED_FUNCTION;
+
+/*
+ * Takes a write lock if one can be taken immediately.  If one cannot, and
+ * xWaitIfBusy is pdTRUE, then the calling task is counted as waiting to write.
+ * Returns pdPASS if the write lock was taken.
+ */
+static BaseType_t prvTryWriteLock( RwLock_t * const pxRwLock,
+								   BaseType_t xWaitIfBusy ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by a writer that has just taken the semaphore, to take the write lock
+ * that was reserved for it.
+ */
+static void prvTakeReservedWriteLock( RwLock_t * const pxRwLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called when the block time of a task waiting for the lock expires.  Returns
+ * pdTRUE if the task stopped waiting, or pdFALSE if the lock has already been
+ * granted to it, in which case it must take the semaphore.  A writer that
+ * stops waiting can let in readers that were waiting behind it.
+ */
+static BaseType_t prvStopWaiting( RwLock_t * const pxRwLock,
+								  BaseType_t xIsWriter ) PRIVILEGED_FUNCTION;
+
+/*
+ * Blocks the calling task, which has been counted as waiting, until the lock
+ * is granted to it or xTicksToWait expires.  Returns pdPASS if the lock was
+ * granted.
+ */
+static BaseType_t prvWaitForLock( RwLock_t * const pxRwLock,
+								  BaseType_t xIsWriter,
+								  TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Grants the lock to the waiting readers, or, if it is no longer held, to the
+ * highest priority waiting writer, if the waiting tasks can now take it.  Must
+ * be called from within a critical section.  Returns the number of semaphore
+ * gives needed to unblock the readers granted the lock, and sets *pxWakeWriter
+ * to pdTRUE if the lock was reserved for a writer.
+ */
+static UBaseType_t prvGrantLock( RwLock_t * const pxRwLock,
+								 BaseType_t * const pxWakeWriter ) PRIVILEGED_FUNCTION;
+
+/*
+ * Gives the semaphores for the tasks prvGrantLock() granted the lock to, from
+ * a task if pxHigherPriorityTaskWoken is NULL, otherwise from an interrupt.
+ */
+static void prvWakeGrantedTasks( RwLock_t * const pxRwLock,
+								 UBaseType_t uxReadersToWake,
+								 BaseType_t xWakeWriter,
+								 BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Releases a read lock, from a task if pxHigherPriorityTaskWoken is NULL,
+ * otherwise from an interrupt, and unblocks any tasks the lock is granted to.
+ */
+static void prvReadUnlock( RwLock_t * const pxRwLock,
+						   BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by both xRwLockCreate() and xRwLockCreateStatic() to initialise the
+ * members of the newly created lock structure.  Returns pdFAIL if the
+ * semaphores could not be created.
+ */
+static BaseType_t prvInitialiseNewRwLock( RwLock_t * const pxRwLock,
+										  uint8_t ucFlags ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	RwLockHandle_t xRwLockCreate( void )
+	{
+	RwLock_t *pxRwLock;
+
+		pxRwLock = ( RwLock_t * ) pvPortMalloc( sizeof( RwLock_t ) ); /*lint !e9079 malloc() only returns void*. */
+
+		if( pxRwLock != NULL )
+		{
+			if( prvInitialiseNewRwLock( pxRwLock, 0 ) != pdFAIL )
+			{
+				traceRW_LOCK_CREATE( pxRwLock );
+			}
+			else
+			{
+				vPortFree( ( void * ) pxRwLock );
+				pxRwLock = NULL;
+				traceRW_LOCK_CREATE_FAILED();
+			}
+		}
+		else
+		{
+			traceRW_LOCK_CREATE_FAILED();
+		}
+
+		return ( RwLockHandle_t ) pxRwLock;
+	}
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	RwLockHandle_t xRwLockCreateStatic( StaticRwLock_t * const pxStaticRwLock )
+	{
+	RwLock_t * const pxRwLock = ( RwLock_t * ) pxStaticRwLock; /*lint !e740 !e9087 Safe cast as StaticRwLock_t is opaque RwLock_t. */
+	RwLockHandle_t xReturn;
+
+		configASSERT( pxStaticRwLock );
+
+		#if( configASSERT_DEFINED == 1 )
+		{
+			/* Sanity check that the size of the structure used to declare a
+			variable of type StaticRwLock_t equals the size of the real lock
+			structure. */
+			volatile size_t xSize = sizeof( StaticRwLock_t );
+			configASSERT( xSize == sizeof( RwLock_t ) );
+		} /*lint !e529 xSize is referenced is configASSERT() is defined. */
+		#endif /* configASSERT_DEFINED */
+
+		if( pxStaticRwLock != NULL )
+		{
+			/* The semaphores are created in memory inside the structure, so
+			cannot fail. */
+			( void ) prvInitialiseNewRwLock( pxRwLock, rwlFLAGS_IS_STATICALLY_ALLOCATED );
+
+			traceRW_LOCK_CREATE( pxRwLock );
+
+			xReturn = ( RwLockHandle_t ) pxStaticRwLock; /*lint !e9087 Data hiding requires cast to opaque type. */
+		}
+		else
+		{
+			xReturn = NULL;
+			traceRW_LOCK_CREATE_FAILED();
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+void vRwLockDelete( RwLockHandle_t xRwLock )
+{
+RwLock_t * pxRwLock = xRwLock;
+
+	configASSERT( pxRwLock );
+
+	/* The lock cannot be held, and tasks cannot be waiting, when it is
+	deleted. */
+	configASSERT( pxRwLock->xWriter == NULL );
+	configASSERT( pxRwLock->uxReaders == ( UBaseType_t ) 0 );
+	configASSERT( pxRwLock->ucWriteReserved == ( uint8_t ) pdFALSE );
+	configASSERT( pxRwLock->uxWaitingReaders == ( UBaseType_t ) 0 );
+	configASSERT( pxRwLock->uxWaitingWriters == ( UBaseType_t ) 0 );
+
+	traceRW_LOCK_DELETE( xRwLock );
+
+	vSemaphoreDelete( pxRwLock->xReadGranted );
+	vSemaphoreDelete( pxRwLock->xWriteGranted );
+
+	if( ( pxRwLock->ucFlags & rwlFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
+	{
+		#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+		{
+			vPortFree( ( void * ) pxRwLock ); /*lint !e9087 Standard free() semantics require void *, plus pxRwLock was allocated by pvPortMalloc(). */
+		}
+		#else
+		{
+			/* Should not be possible to get here, ucFlags must be corrupt.
+			Force an assert. */
+			configASSERT( xRwLock == ( RwLockHandle_t ) ~0 );
+		}
+		#endif
+	}
+	else
+	{
+		/* The structure was not allocated dynamically and cannot be freed -
+		just scrub the structure so future use will assert. */
+		( void ) memset( pxRwLock, 0x00, sizeof( RwLock_t ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRwLockReadLock( RwLockHandle_t xRwLock, TickType_t xTicksToWait )
+{
+RwLock_t * const pxRwLock = xRwLock;
+BaseType_t xReturn;
+
+	configASSERT( pxRwLock );
+
+	/* Cannot block if the scheduler is suspended. */
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	xReturn = prvTryReadLock( pxRwLock, ( xTicksToWait != ( TickType_t ) 0 ) ? pdTRUE : pdFALSE, pdFALSE );
+
+	if( ( xReturn == pdFAIL ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+	{
+		/* The read lock count was increased when the lock was granted, so
+		there is nothing more to do once the semaphore has been taken. */
+		xReturn = prvWaitForLock( pxRwLock, pdFALSE, xTicksToWait );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRwLockReadLockFromISR( RwLockHandle_t xRwLock )
+{
+RwLock_t * const pxRwLock = xRwLock;
+
+	configASSERT( pxRwLock );
+
+	return prvTryReadLock( pxRwLock, pdFALSE, pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+void vRwLockReadUnlock( RwLockHandle_t xRwLock )
+{
+RwLock_t * const pxRwLock = xRwLock;
+
+	configASSERT( pxRwLock );
+
+	prvReadUnlock( pxRwLock, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vRwLockReadUnlockFromISR( RwLockHandle_t xRwLock,
+							   BaseType_t * const pxHigherPriorityTaskWoken )
+{
+RwLock_t * const pxRwLock = xRwLock;
+
+	configASSERT( pxRwLock );
+	configASSERT( pxHigherPriorityTaskWoken );
+
+	prvReadUnlock( pxRwLock, pxHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xRwLockWriteLock( RwLockHandle_t xRwLock, TickType_t xTicksToWait )
+{
+RwLock_t * const pxRwLock = xRwLock;
+BaseType_t xReturn;
+
+	configASSERT( pxRwLock );
+
+	/* Write locks are not recursive - a task that already holds the lock for
+	writing would wait for itself. */
+	configASSERT( pxRwLock->xWriter != xTaskGetCurrentTaskHandle() );
+
+	/* Cannot block if the scheduler is suspended. */
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	xReturn = prvTryWriteLock( pxRwLock, ( xTicksToWait != ( TickType_t ) 0 ) ? pdTRUE : pdFALSE );
+
+	if( ( xReturn == pdFAIL ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+	{
+		xReturn = prvWaitForLock( pxRwLock, pdTRUE, xTicksToWait );
+
+		if( xReturn != pdFAIL )
+		{
+			prvTakeReservedWriteLock( pxRwLock );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vRwLockWriteUnlock( RwLockHandle_t xRwLock )
+{
+RwLock_t * const pxRwLock = xRwLock;
+UBaseType_t uxReadersToWake;
+BaseType_t xWakeWriter;
+
+	configASSERT( pxRwLock );
+
+	taskENTER_CRITICAL();
+	{
+		/* Only the writer can release a write lock. */
+		configASSERT( pxRwLock->xWriter == xTaskGetCurrentTaskHandle() );
+		pxRwLock->xWriter = NULL;
+
+		uxReadersToWake = prvGrantLock( pxRwLock, &xWakeWriter );
+	}
+	taskEXIT_CRITICAL();
+
+	prvWakeGrantedTasks( pxRwLock, uxReadersToWake, xWakeWriter, NULL );
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xRwLockGetWriter( RwLockHandle_t xRwLock )
+{
+const RwLock_t * const pxRwLock = xRwLock;
+
+	configASSERT( pxRwLock );
+
+	/* A single read, so no critical section is needed. */
+	return pxRwLock->xWriter;
+}
+/*-----------------------------------------------------------*/
+
+void vRwLockGetStats( RwLockHandle_t xRwLock, RwLockStats_t *pxRwLockStats )
+{
+const RwLock_t * const pxRwLock = xRwLock;
+
+	configASSERT( pxRwLock );
+	configASSERT( pxRwLockStats );
+
+	taskENTER_CRITICAL();
+	{
+		pxRwLockStats->xWriter = pxRwLock->xWriter;
+		pxRwLockStats->uxReaders = pxRwLock->uxReaders;
+		pxRwLockStats->uxWaitingReaders = pxRwLock->uxWaitingReaders;
+		pxRwLockStats->uxWaitingWriters = pxRwLock->uxWaitingWriters;
+		pxRwLockStats->uxReadLocks = pxRwLock->uxReadLocks;
+		pxRwLockStats->uxWriteLocks = pxRwLock->uxWriteLocks;
+		pxRwLockStats->uxContendedLocks = pxRwLock->uxContendedLocks;
+		pxRwLockStats->uxFailedLocks = pxRwLock->uxFailedLocks;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTryReadLock( RwLock_t * const pxRwLock,
+								  BaseType_t xWaitIfBusy,
+								  BaseType_t xFromISR )
+{
+UBaseType_t uxSavedInterruptStatus = 0;
+UBaseType_t uxPriority = ( UBaseType_t ) tskIDLE_PRIORITY;
+BaseType_t xAdmit;
+BaseType_t xReturn = pdFAIL;
+
+	if( xFromISR != pdFALSE )
+	{
+		uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+	}
+	else
+	{
+		/* Read before entering the critical section as it enters one of its
+		own. */
+		uxPriority = rwlCURRENT_PRIORITY();
+		taskENTER_CRITICAL();
+	}
+
+	{
+		if( ( pxRwLock->xWriter != NULL ) || ( pxRwLock->ucWriteReserved != ( uint8_t ) pdFALSE ) )
+		{
+			xAdmit = pdFALSE;
+		}
+		else if( ( xFromISR != pdFALSE ) || ( pxRwLock->uxWaitingWriters == ( UBaseType_t ) 0 ) )
+		{
+			xAdmit = pdTRUE;
+		}
+		else
+		{
+			/* Writers are waiting, so only let in a reader that would
+			otherwise wait behind lower priority tasks. */
+			xAdmit = ( uxPriority > pxRwLock->uxTopWriterPriority ) ? pdTRUE : pdFALSE;
+		}
+
+		if( xAdmit != pdFALSE )
+		{
+			pxRwLock->uxReaders++;
+			pxRwLock->uxReadLocks++;
+			xReturn = pdPASS;
+		}
+		else if( xWaitIfBusy != pdFALSE )
+		{
+			pxRwLock->uxWaitingReaders++;
+			pxRwLock->uxContendedLocks++;
+
+			if( uxPriority > pxRwLock->uxTopReaderPriority )
+			{
+				pxRwLock->uxTopReaderPriority = uxPriority;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			pxRwLock->uxFailedLocks++;
+			traceRW_LOCK_READ_FAILED( pxRwLock );
+		}
+	}
+
+	if( xFromISR != pdFALSE )
+	{
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+	}
+	else
+	{
+		taskEXIT_CRITICAL();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTryWriteLock( RwLock_t * const pxRwLock,
+								   BaseType_t xWaitIfBusy )
+{
+const TaskHandle_t xCurrentTask = xTaskGetCurrentTaskHandle();
+const UBaseType_t uxPriority = rwlCURRENT_PRIORITY();
+BaseType_t xReturn = pdFAIL;
+
+	taskENTER_CRITICAL();
+	{
+		/* Tasks only wait while the lock is held, so the lock being free
+		means no tasks are waiting either. */
+		if( ( pxRwLock->xWriter == NULL ) && ( pxRwLock->ucWriteReserved == ( uint8_t ) pdFALSE ) && ( pxRwLock->uxReaders == ( UBaseType_t ) 0 ) )
+		{
+			pxRwLock->xWriter = xCurrentTask;
+			pxRwLock->uxWriteLocks++;
+			xReturn = pdPASS;
+		}
+		else if( xWaitIfBusy != pdFALSE )
+		{
+			pxRwLock->uxWaitingWriters++;
+			pxRwLock->uxContendedLocks++;
+
+			if( uxPriority > pxRwLock->uxTopWriterPriority )
+			{
+				pxRwLock->uxTopWriterPriority = uxPriority;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			pxRwLock->uxFailedLocks++;
+			traceRW_LOCK_WRITE_FAILED( pxRwLock );
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTakeReservedWriteLock( RwLock_t * const pxRwLock )
+{
+const TaskHandle_t xCurrentTask = xTaskGetCurrentTaskHandle();
+
+	taskENTER_CRITICAL();
+	{
+		configASSERT( pxRwLock->ucWriteReserved != ( uint8_t ) pdFALSE );
+		configASSERT( pxRwLock->xWriter == NULL );
+		pxRwLock->ucWriteReserved = ( uint8_t ) pdFALSE;
+		pxRwLock->xWriter = xCurrentTask;
+		pxRwLock->uxWriteLocks++;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvStopWaiting( RwLock_t * const pxRwLock,
+								  BaseType_t xIsWriter )
+{
+UBaseType_t * const puxWaiting = ( xIsWriter != pdFALSE ) ? &( pxRwLock->uxWaitingWriters ) : &( pxRwLock->uxWaitingReaders );
+UBaseType_t uxReadersToWake = 0;
+BaseType_t xWakeWriter = pdFALSE;
+BaseType_t xReturn;
+
+	taskENTER_CRITICAL();
+	{
+		/* All the waiting tasks of one kind are equivalent, so if the count
+		of tasks that have not been granted the lock is zero then one of the
+		semaphore gives still to be taken belongs to this task. */
+		if( *puxWaiting > ( UBaseType_t ) 0 )
+		{
+			( *puxWaiting )--;
+			pxRwLock->uxFailedLocks++;
+
+			if( *puxWaiting == ( UBaseType_t ) 0 )
+			{
+				if( xIsWriter != pdFALSE )
+				{
+					pxRwLock->uxTopWriterPriority = ( UBaseType_t ) tskIDLE_PRIORITY;
+				}
+				else
+				{
+					pxRwLock->uxTopReaderPriority = ( UBaseType_t ) tskIDLE_PRIORITY;
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Readers waiting only because this writer was waiting can now
+			share the lock with the readers that hold it. */
+			if( xIsWriter != pdFALSE )
+			{
+				uxReadersToWake = prvGrantLock( pxRwLock, &xWakeWriter );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			xReturn = pdFALSE;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	prvWakeGrantedTasks( pxRwLock, uxReadersToWake, xWakeWriter, NULL );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWaitForLock( RwLock_t * const pxRwLock,
+								  BaseType_t xIsWriter,
+								  TickType_t xTicksToWait )
+{
+const SemaphoreHandle_t xGranted = ( xIsWriter != pdFALSE ) ? pxRwLock->xWriteGranted : pxRwLock->xReadGranted;
+BaseType_t xReturn = pdPASS;
+
+	if( xSemaphoreTake( xGranted, xTicksToWait ) != pdFALSE )
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+	else if( prvStopWaiting( pxRwLock, xIsWriter ) == pdFALSE )
+	{
+		/* The lock was granted after the block time expired but before the
+		task stopped waiting.  The semaphore is given as soon as the lock is
+		granted, so this does not wait for long. */
+		while( xSemaphoreTake( xGranted, portMAX_DELAY ) == pdFALSE )
+		{
+		}
+	}
+	else
+	{
+		xReturn = pdFAIL;
+
+		if( xIsWriter != pdFALSE )
+		{
+			traceRW_LOCK_WRITE_FAILED( pxRwLock );
+		}
+		else
+		{
+			traceRW_LOCK_READ_FAILED( pxRwLock );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvGrantLock( RwLock_t * const pxRwLock,
+								 BaseType_t * const pxWakeWriter )
+{
+UBaseType_t uxReadersToWake = 0;
+
+	*pxWakeWriter = pdFALSE;
+
+	if( ( pxRwLock->xWriter != NULL ) || ( pxRwLock->ucWriteReserved != ( uint8_t ) pdFALSE ) )
+	{
+		/* Held or reserved for writing. */
+		mtCOVERAGE_TEST_MARKER();
+	}
+	else if( ( pxRwLock->uxWaitingReaders > ( UBaseType_t ) 0 ) &&
+			 ( ( pxRwLock->uxWaitingWriters == ( UBaseType_t ) 0 ) || ( pxRwLock->uxTopReaderPriority > pxRwLock->uxTopWriterPriority ) ) )
+	{
+		/* All the waiting readers are let in together, including any with a
+		lower priority than the waiting writers, as they do not exclude each
+		other. */
+		uxReadersToWake = pxRwLock->uxWaitingReaders;
+		pxRwLock->uxReaders += uxReadersToWake;
+		pxRwLock->uxReadLocks += uxReadersToWake;
+		pxRwLock->uxWaitingReaders = 0;
+		pxRwLock->uxTopReaderPriority = ( UBaseType_t ) tskIDLE_PRIORITY;
+	}
+	else if( ( pxRwLock->uxReaders == ( UBaseType_t ) 0 ) && ( pxRwLock->uxWaitingWriters > ( UBaseType_t ) 0 ) )
+	{
+		/* The semaphore unblocks the highest priority waiting writer. */
+		pxRwLock->uxWaitingWriters--;
+		pxRwLock->ucWriteReserved = ( uint8_t ) pdTRUE;
+
+		if( pxRwLock->uxWaitingWriters == ( UBaseType_t ) 0 )
+		{
+			pxRwLock->uxTopWriterPriority = ( UBaseType_t ) tskIDLE_PRIORITY;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		*pxWakeWriter = pdTRUE;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return uxReadersToWake;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWakeGrantedTasks( RwLock_t * const pxRwLock,
+								 UBaseType_t uxReadersToWake,
+								 BaseType_t xWakeWriter,
+								 BaseType_t * const pxHigherPriorityTaskWoken )
+{
+	if( xWakeWriter != pdFALSE )
+	{
+		if( pxHigherPriorityTaskWoken != NULL )
+		{
+			( void ) xSemaphoreGiveFromISR( pxRwLock->xWriteGranted, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			( void ) xSemaphoreGive( pxRwLock->xWriteGranted );
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	while( uxReadersToWake > ( UBaseType_t ) 0 )
+	{
+		if( pxHigherPriorityTaskWoken != NULL )
+		{
+			( void ) xSemaphoreGiveFromISR( pxRwLock->xReadGranted, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			( void ) xSemaphoreGive( pxRwLock->xReadGranted );
+		}
+
+		uxReadersToWake--;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvReadUnlock( RwLock_t * const pxRwLock,
+						   BaseType_t * const pxHigherPriorityTaskWoken )
+{
+UBaseType_t uxSavedInterruptStatus = 0;
+UBaseType_t uxReadersToWake;
+BaseType_t xWakeWriter;
+
+	if( pxHigherPriorityTaskWoken != NULL )
+	{
+		uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+	}
+	else
+	{
+		taskENTER_CRITICAL();
+	}
+
+	{
+		configASSERT( pxRwLock->uxReaders > ( UBaseType_t ) 0 );
+		pxRwLock->uxReaders--;
+		uxReadersToWake = prvGrantLock( pxRwLock, &xWakeWriter );
+	}
+
+	if( pxHigherPriorityTaskWoken != NULL )
+	{
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+	}
+	else
+	{
+		taskEXIT_CRITICAL();
+	}
+
+	prvWakeGrantedTasks( pxRwLock, uxReadersToWake, xWakeWriter, pxHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvInitialiseNewRwLock( RwLock_t * const pxRwLock,
+										  uint8_t ucFlags )
+{
+BaseType_t xReturn = pdPASS;
+
+	( void ) memset( ( void * ) pxRwLock, 0x00, sizeof( RwLock_t ) ); /*lint !e9087 memset() requires void *. */
+	pxRwLock->ucFlags = ucFlags;
+
+	/* The semaphores are only given when the lock is granted to a waiting
+	task, so start empty.  The lock is only ever reserved for one writer at a
+	time. */
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	{
+		pxRwLock->xReadGranted = xSemaphoreCreateCountingStatic( rwlMAX_READ_GRANTS, ( UBaseType_t ) 0, &( pxRwLock->xReadGrantedBuffer ) );
+		pxRwLock->xWriteGranted = xSemaphoreCreateCountingStatic( ( UBaseType_t ) 1, ( UBaseType_t ) 0, &( pxRwLock->xWriteGrantedBuffer ) );
+	}
+	#else
+	{
+		pxRwLock->xReadGranted = xSemaphoreCreateCounting( rwlMAX_READ_GRANTS, ( UBaseType_t ) 0 );
+		pxRwLock->xWriteGranted = xSemaphoreCreateCounting( ( UBaseType_t ) 1, ( UBaseType_t ) 0 );
+	}
+	#endif
+
+	if( ( pxRwLock->xReadGranted == NULL ) || ( pxRwLock->xWriteGranted == NULL ) )
+	{
+		/* Only possible when the semaphores are allocated dynamically. */
+		if( pxRwLock->xReadGranted != NULL )
+		{
+			vSemaphoreDelete( pxRwLock->xReadGranted );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( pxRwLock->xWriteGranted != NULL )
+		{
+			vSemaphoreDelete( pxRwLock->xWriteGranted );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xReturn = pdFAIL;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	UBaseType_t uxRwLockGetRwLockNumber( RwLockHandle_t xRwLock )
+	{
+		return xRwLock->uxRwLockNumber;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	void vRwLockSetRwLockNumber( RwLockHandle_t xRwLock, UBaseType_t uxRwLockNumber )
+	{
+		xRwLock->uxRwLockNumber = uxRwLockNumber;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
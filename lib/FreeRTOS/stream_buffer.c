@@ -74,7 +74,7 @@ that uses task notifications. */
 	{																					\
 	UBaseType_t uxSavedInterruptStatus;													\
 																						\
-		uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();		\
+		uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();			\
 		{																				\
 			if( ( pxStreamBuffer )->xTaskWaitingToSend != NULL )						\
 			{																			\
@@ -85,7 +85,7 @@ that uses task notifications. */
 				( pxStreamBuffer )->xTaskWaitingToSend = NULL;							\
 			}																			\
 		}																				\
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );					\
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );							\
 	}
 #endif /* sbRECEIVE_COMPLETED_FROM_ISR */
 
@@ -112,7 +112,7 @@ that uses task notifications. */
 	{																					\
 	UBaseType_t uxSavedInterruptStatus;													\
 																						\
-		uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();		\
+		uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();			\
 		{																				\
 			if( ( pxStreamBuffer )->xTaskWaitingToReceive != NULL )						\
 			{																			\
@@ -123,7 +123,7 @@ that uses task notifications. */
 				( pxStreamBuffer )->xTaskWaitingToReceive = NULL;						\
 			}																			\
 		}																				\
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );					\
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );							\
 	}
 #endif /* sbSEND_COMPLETE_FROM_ISR */
 /*lint -restore (9026) */
@@ -144,6 +144,10 @@ typedef struct StreamBufferDef_t /*lint !e9058 Style convention uses tag. */
 	volatile size_t xHead;				/* Index to the next item to write within the buffer. */
 	size_t xLength;						/* The length of the buffer pointed to by pucBuffer. */
 	size_t xTriggerLevelBytes;			/* The number of bytes that must be in the stream buffer before a task that is waiting for data is unblocked. */
+	volatile size_t xWatermark;			/* The end of the data when the data wraps around the end of the buffer - less than xLength if a reservation skipped the bytes at the end of the buffer.  Only written by the writer. */
+	size_t xReservedHead;				/* Index of the start of the writer's outstanding reservation. */
+	size_t xReservedLength;				/* The length of the writer's outstanding reservation, including the message length bytes of a message buffer, or 0 if there is none. */
+	size_t xAcquiredLength;				/* The length of the data the reader has acquired but not yet released, or 0 if there is none. */
 	volatile TaskHandle_t xTaskWaitingToReceive; /* Holds the handle of a task waiting for data, or NULL if no tasks are waiting. */
 	volatile TaskHandle_t xTaskWaitingToSend;	/* Holds the handle of a task waiting to send data to a message buffer that is full. */
 	uint8_t *pucBuffer;					/* Points to the buffer itself - that is - the RAM that stores the data passed through the buffer. */
@@ -194,13 +198,75 @@ static size_t prvWriteMessageToBuffer(  StreamBuffer_t * const pxStreamBuffer,
 										size_t xRequiredSpace ) PRIVILEGED_FUNCTION;
 
 /*
- * Read xMaxCount bytes from the pxStreamBuffer message buffer and write them
- * to pucData.
+ * Copy xCount bytes, starting at index xTail, out of the pxStreamBuffer
+ * buffer's data storage area into pucData.  Returns the index of the byte that
+ * follows the bytes read, which the caller stores as the new tail if the bytes
+ * are being removed from the buffer, or discards if they were only peeked.
  */
 static size_t prvReadBytesFromBuffer( StreamBuffer_t *pxStreamBuffer,
 									  uint8_t *pucData,
-									  size_t xMaxCount,
-									  size_t xBytesAvailable ) PRIVILEGED_FUNCTION;
+									  size_t xCount,
+									  size_t xTail ) PRIVILEGED_FUNCTION;
+
+/*
+ * The number of contiguous bytes that can be read starting at xTail.  The
+ * index of the first of those bytes is returned in *pxReadIndex, which is only
+ * different to xTail if the data wraps and xTail is at the watermark.
+ */
+static size_t prvContiguousBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer,
+										  size_t xTail,
+										  size_t *pxReadIndex ) PRIVILEGED_FUNCTION;
+
+/*
+ * Block the calling task for up to xTicksToWait ticks until more than
+ * xBytesToStoreMessageLength bytes are available to read.  Returns the number
+ * of bytes available.
+ */
+static size_t prvWaitForBytesToRead( StreamBuffer_t * const pxStreamBuffer,
+									 size_t xBytesToStoreMessageLength,
+									 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Find xRequiredSpace contiguous free bytes in the buffer, either at the head
+ * or, if there are not enough bytes between the head and the end of the buffer,
+ * at the start of the buffer.  Returns pdTRUE and sets *pxReservedHead to the
+ * index of the first byte if the bytes were found, otherwise returns pdFALSE.
+ */
+static BaseType_t prvFindContiguousSpace( const StreamBuffer_t * const pxStreamBuffer,
+										  size_t xRequiredSpace,
+										  size_t *pxReservedHead ) PRIVILEGED_FUNCTION;
+
+/*
+ * Record a reservation of xRequiredSpace bytes starting at xReservedHead, and
+ * return a pointer to the first byte the writer can fill.
+ */
+static void *prvReserve( StreamBuffer_t * const pxStreamBuffer,
+						 size_t xRequiredSpace,
+						 size_t xReservedHead ) PRIVILEGED_FUNCTION;
+
+/*
+ * Make the first xDataLengthBytes bytes of the writer's outstanding reservation
+ * available to the reader, and end the reservation.  Returns the number of data
+ * bytes committed.
+ */
+static size_t prvCommit( StreamBuffer_t * const pxStreamBuffer, size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
+/*
+ * Obtain a pointer to contiguous data that can be read in place, without
+ * removing the data from the buffer.  Returns the number of bytes that can be
+ * read from *ppvRxData, which is 0 if no data is available or if the next
+ * message in a message buffer wraps around the end of the buffer.
+ */
+static size_t prvAcquire( StreamBuffer_t * const pxStreamBuffer,
+						  void **ppvRxData,
+						  size_t xBytesAvailable,
+						  size_t xBytesToStoreMessageLength ) PRIVILEGED_FUNCTION;
+
+/*
+ * Remove data previously obtained by prvAcquire() from the buffer.  Returns
+ * the number of data bytes removed.
+ */
+static size_t prvRelease( StreamBuffer_t * const pxStreamBuffer, size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
 
 /*
  * Called by both pxStreamBufferCreate() and pxStreamBufferCreateStatic() to
@@ -710,6 +776,204 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 }
 /*-----------------------------------------------------------*/
 
+size_t xStreamBufferSendReserve( StreamBufferHandle_t xStreamBuffer,
+								 void **ppvTxData,
+								 size_t xDataLengthBytes,
+								 TickType_t xTicksToWait )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReturn = 0, xReservedHead = 0;
+size_t xRequiredSpace = xDataLengthBytes;
+BaseType_t xFound = pdFALSE;
+TimeOut_t xTimeOut;
+
+	configASSERT( ppvTxData );
+	configASSERT( pxStreamBuffer );
+	configASSERT( xDataLengthBytes > ( size_t ) 0 );
+
+	/* Only one reservation can be outstanding at a time. */
+	configASSERT( pxStreamBuffer->xReservedLength == ( size_t ) 0 );
+
+	/* If this is a message buffer then the reservation also holds the length
+	of the message, in front of the message itself. */
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+
+		/* Overflow? */
+		configASSERT( xRequiredSpace > xDataLengthBytes );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xTicksToWait != ( TickType_t ) 0 )
+	{
+		vTaskSetTimeOutState( &xTimeOut );
+
+		do
+		{
+			/* Wait until the required number of contiguous bytes are free in
+			the buffer. */
+			taskENTER_CRITICAL();
+			{
+				xFound = prvFindContiguousSpace( pxStreamBuffer, xRequiredSpace, &xReservedHead );
+
+				if( xFound == pdFALSE )
+				{
+					/* Clear notification state as going to wait for space. */
+					( void ) xTaskNotifyStateClear( NULL );
+
+					/* Should only be one writer. */
+					configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+					pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+				}
+				else
+				{
+					taskEXIT_CRITICAL();
+					break;
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
+			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToSend = NULL;
+
+		} while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xFound == pdFALSE )
+	{
+		xFound = prvFindContiguousSpace( pxStreamBuffer, xRequiredSpace, &xReservedHead );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xFound != pdFALSE )
+	{
+		*ppvTxData = prvReserve( pxStreamBuffer, xRequiredSpace, xReservedHead );
+		xReturn = xDataLengthBytes;
+	}
+	else
+	{
+		*ppvTxData = NULL;
+		traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSendReserveFromISR( StreamBufferHandle_t xStreamBuffer,
+										void **ppvTxData,
+										size_t xDataLengthBytes )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReturn = 0, xReservedHead = 0;
+size_t xRequiredSpace = xDataLengthBytes;
+
+	configASSERT( ppvTxData );
+	configASSERT( pxStreamBuffer );
+	configASSERT( xDataLengthBytes > ( size_t ) 0 );
+	configASSERT( pxStreamBuffer->xReservedLength == ( size_t ) 0 );
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( prvFindContiguousSpace( pxStreamBuffer, xRequiredSpace, &xReservedHead ) != pdFALSE )
+	{
+		*ppvTxData = prvReserve( pxStreamBuffer, xRequiredSpace, xReservedHead );
+		xReturn = xDataLengthBytes;
+	}
+	else
+	{
+		*ppvTxData = NULL;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReturn;
+
+	configASSERT( pxStreamBuffer );
+
+	xReturn = prvCommit( pxStreamBuffer, xDataLengthBytes );
+
+	if( xReturn > ( size_t ) 0 )
+	{
+		traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
+
+		/* Was a task waiting for the data? */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		{
+			sbSEND_COMPLETED( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+									   size_t xDataLengthBytes,
+									   BaseType_t * const pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReturn;
+
+	configASSERT( pxStreamBuffer );
+
+	xReturn = prvCommit( pxStreamBuffer, xDataLengthBytes );
+
+	if( xReturn > ( size_t ) 0 )
+	{
+		/* Was a task waiting for the data? */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		{
+			sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xReturn );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
 size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
 							 void *pvRxData,
 							 size_t xBufferLengthBytes,
@@ -735,6 +999,44 @@ size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
 		xBytesToStoreMessageLength = 0;
 	}
 
+	xBytesAvailable = prvWaitForBytesToRead( pxStreamBuffer, xBytesToStoreMessageLength, xTicksToWait );
+
+	/* Whether receiving a discrete message (where xBytesToStoreMessageLength
+	holds the number of bytes used to store the message length) or a stream of
+	bytes (where xBytesToStoreMessageLength is zero), the number of bytes
+	available must be greater than xBytesToStoreMessageLength to be able to
+	read bytes from the buffer. */
+	if( xBytesAvailable > xBytesToStoreMessageLength )
+	{
+		xReceivedLength = prvReadMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, xBytesAvailable, xBytesToStoreMessageLength );
+
+		/* Was a task waiting for space in the buffer? */
+		if( xReceivedLength != ( size_t ) 0 )
+		{
+			traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength );
+			sbRECEIVE_COMPLETED( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer );
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReceivedLength;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWaitForBytesToRead( StreamBuffer_t * const pxStreamBuffer,
+									 size_t xBytesToStoreMessageLength,
+									 TickType_t xTicksToWait )
+{
+size_t xBytesAvailable;
+
 	if( xTicksToWait != ( TickType_t ) 0 )
 	{
 		/* Checking if there is data and clearing the notification state must be
@@ -767,7 +1069,7 @@ size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
 		if( xBytesAvailable <= xBytesToStoreMessageLength )
 		{
 			/* Wait for data to be available. */
-			traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer );
+			traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( pxStreamBuffer );
 			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
 			pxStreamBuffer->xTaskWaitingToReceive = NULL;
 
@@ -784,40 +1086,14 @@ size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
 		xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
 	}
 
-	/* Whether receiving a discrete message (where xBytesToStoreMessageLength
-	holds the number of bytes used to store the message length) or a stream of
-	bytes (where xBytesToStoreMessageLength is zero), the number of bytes
-	available must be greater than xBytesToStoreMessageLength to be able to
-	read bytes from the buffer. */
-	if( xBytesAvailable > xBytesToStoreMessageLength )
-	{
-		xReceivedLength = prvReadMessageFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, xBytesAvailable, xBytesToStoreMessageLength );
-
-		/* Was a task waiting for space in the buffer? */
-		if( xReceivedLength != ( size_t ) 0 )
-		{
-			traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength );
-			sbRECEIVE_COMPLETED( pxStreamBuffer );
-		}
-		else
-		{
-			mtCOVERAGE_TEST_MARKER();
-		}
-	}
-	else
-	{
-		traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer );
-		mtCOVERAGE_TEST_MARKER();
-	}
-
-	return xReceivedLength;
+	return xBytesAvailable;
 }
 /*-----------------------------------------------------------*/
 
 size_t xStreamBufferNextMessageLengthBytes( StreamBufferHandle_t xStreamBuffer )
 {
 StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-size_t xReturn, xBytesAvailable, xOriginalTail;
+size_t xReturn, xBytesAvailable;
 configMESSAGE_BUFFER_LENGTH_TYPE xTempReturn;
 
 	configASSERT( pxStreamBuffer );
@@ -831,13 +1107,9 @@ configMESSAGE_BUFFER_LENGTH_TYPE xTempReturn;
 			/* The number of bytes available is greater than the number of bytes
 			required to hold the length of the next message, so another message
 			is available.  Return its length without removing the length bytes
-			from the buffer.  A copy of the tail is stored so the buffer can be
-			returned to its prior state as the message is not actually being
-			removed from the buffer. */
-			xOriginalTail = pxStreamBuffer->xTail;
-			( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempReturn, sbBYTES_TO_STORE_MESSAGE_LENGTH, xBytesAvailable );
+			from the buffer - the new tail is not stored. */
+			( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempReturn, sbBYTES_TO_STORE_MESSAGE_LENGTH, pxStreamBuffer->xTail );
 			xReturn = ( size_t ) xTempReturn;
-			pxStreamBuffer->xTail = xOriginalTail;
 		}
 		else
 		{
@@ -915,27 +1187,140 @@ size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
 }
 /*-----------------------------------------------------------*/
 
-static size_t prvReadMessageFromBuffer( StreamBuffer_t *pxStreamBuffer,
-										void *pvRxData,
-										size_t xBufferLengthBytes,
-										size_t xBytesAvailable,
-										size_t xBytesToStoreMessageLength )
+size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+									void **ppvRxData,
+									TickType_t xTicksToWait )
 {
-size_t xOriginalTail, xReceivedLength, xNextMessageLength;
-configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReceivedLength, xBytesAvailable, xBytesToStoreMessageLength;
 
-	if( xBytesToStoreMessageLength != ( size_t ) 0 )
-	{
-		/* A discrete message is being received.  First receive the length
-		of the message.  A copy of the tail is stored so the buffer can be
-		returned to its prior state if the length of the message is too
-		large for the provided buffer. */
-		xOriginalTail = pxStreamBuffer->xTail;
-		( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, xBytesToStoreMessageLength, xBytesAvailable );
-		xNextMessageLength = ( size_t ) xTempNextMessageLength;
+	configASSERT( ppvRxData );
+	configASSERT( pxStreamBuffer );
 
-		/* Reduce the number of bytes available by the number of bytes just
-		read out. */
+	/* Only one acquisition can be outstanding at a time. */
+	configASSERT( pxStreamBuffer->xAcquiredLength == ( size_t ) 0 );
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		xBytesToStoreMessageLength = 0;
+	}
+
+	xBytesAvailable = prvWaitForBytesToRead( pxStreamBuffer, xBytesToStoreMessageLength, xTicksToWait );
+	xReceivedLength = prvAcquire( pxStreamBuffer, ppvRxData, xBytesAvailable, xBytesToStoreMessageLength );
+
+	if( xReceivedLength == ( size_t ) 0 )
+	{
+		traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReceivedLength;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+										   void **ppvRxData )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xBytesToStoreMessageLength;
+
+	configASSERT( ppvRxData );
+	configASSERT( pxStreamBuffer );
+	configASSERT( pxStreamBuffer->xAcquiredLength == ( size_t ) 0 );
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		xBytesToStoreMessageLength = 0;
+	}
+
+	return prvAcquire( pxStreamBuffer, ppvRxData, prvBytesInBuffer( pxStreamBuffer ), xBytesToStoreMessageLength );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReceivedLength;
+
+	configASSERT( pxStreamBuffer );
+
+	xReceivedLength = prvRelease( pxStreamBuffer, xDataLengthBytes );
+
+	/* Was a task waiting for space in the buffer? */
+	if( xReceivedLength != ( size_t ) 0 )
+	{
+		traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength );
+		sbRECEIVE_COMPLETED( pxStreamBuffer );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReceivedLength;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+										   size_t xDataLengthBytes,
+										   BaseType_t * const pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xReceivedLength;
+
+	configASSERT( pxStreamBuffer );
+
+	xReceivedLength = prvRelease( pxStreamBuffer, xDataLengthBytes );
+
+	/* Was a task waiting for space in the buffer? */
+	if( xReceivedLength != ( size_t ) 0 )
+	{
+		sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength );
+
+	return xReceivedLength;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReadMessageFromBuffer( StreamBuffer_t *pxStreamBuffer,
+										void *pvRxData,
+										size_t xBufferLengthBytes,
+										size_t xBytesAvailable,
+										size_t xBytesToStoreMessageLength )
+{
+size_t xNextTail, xReceivedLength, xNextMessageLength;
+configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+
+	xNextTail = pxStreamBuffer->xTail;
+
+	if( xBytesToStoreMessageLength != ( size_t ) 0 )
+	{
+		/* A discrete message is being received.  First read the length of
+		the message.  The new tail is only stored once the message itself has
+		been read, so the length remains in the buffer if the message is too
+		large for the provided buffer. */
+		xNextTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, xBytesToStoreMessageLength, xNextTail );
+		xNextMessageLength = ( size_t ) xTempNextMessageLength;
+
+		/* Reduce the number of bytes available by the number of bytes just
+		read out. */
 		xBytesAvailable -= xBytesToStoreMessageLength;
 
 		/* Check there is enough space in the buffer provided by the
@@ -943,9 +1328,8 @@ configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
 		if( xNextMessageLength > xBufferLengthBytes )
 		{
 			/* The user has provided insufficient space to read the message
-			so return the buffer to its previous state (so the length of
-			the message is in the buffer again). */
-			pxStreamBuffer->xTail = xOriginalTail;
+			so leave the buffer in its previous state (so the length of the
+			message is in the buffer still). */
 			xNextMessageLength = 0;
 		}
 		else
@@ -960,8 +1344,19 @@ configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
 		xNextMessageLength = xBufferLengthBytes;
 	}
 
-	/* Read the actual data. */
-	xReceivedLength = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) pvRxData, xNextMessageLength, xBytesAvailable ); /*lint !e9079 Data storage area is implemented as uint8_t array for ease of sizing, indexing and alignment. */
+	/* Use the minimum of the wanted bytes and the available bytes. */
+	xReceivedLength = configMIN( xNextMessageLength, xBytesAvailable );
+
+	if( xReceivedLength != ( size_t ) 0 )
+	{
+		/* Read the actual data, then move the tail pointer to effectively
+		remove the data read from the buffer. */
+		pxStreamBuffer->xTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) pvRxData, xReceivedLength, xNextTail ); /*lint !e9079 Data storage area is implemented as uint8_t array for ease of sizing, indexing and alignment. */
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
 
 	return xReceivedLength;
 }
@@ -1033,7 +1428,7 @@ UBaseType_t uxSavedInterruptStatus;
 
 	configASSERT( pxStreamBuffer );
 
-	uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+	uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
 	{
 		if( ( pxStreamBuffer )->xTaskWaitingToReceive != NULL )
 		{
@@ -1049,7 +1444,7 @@ UBaseType_t uxSavedInterruptStatus;
 			xReturn = pdFALSE;
 		}
 	}
-	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
 	return xReturn;
 }
@@ -1063,7 +1458,7 @@ UBaseType_t uxSavedInterruptStatus;
 
 	configASSERT( pxStreamBuffer );
 
-	uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+	uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
 	{
 		if( ( pxStreamBuffer )->xTaskWaitingToSend != NULL )
 		{
@@ -1079,7 +1474,7 @@ UBaseType_t uxSavedInterruptStatus;
 			xReturn = pdFALSE;
 		}
 	}
-	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
 	return xReturn;
 }
@@ -1119,6 +1514,10 @@ size_t xNextHead, xFirstLength;
 	if( xNextHead >= pxStreamBuffer->xLength )
 	{
 		xNextHead -= pxStreamBuffer->xLength;
+
+		/* The data now wraps at the end of the buffer.  The watermark must be
+		valid before the reader can see the new head. */
+		pxStreamBuffer->xWatermark = pxStreamBuffer->xLength;
 	}
 	else
 	{
@@ -1131,78 +1530,398 @@ size_t xNextHead, xFirstLength;
 }
 /*-----------------------------------------------------------*/
 
-static size_t prvReadBytesFromBuffer( StreamBuffer_t *pxStreamBuffer, uint8_t *pucData, size_t xMaxCount, size_t xBytesAvailable )
+static size_t prvReadBytesFromBuffer( StreamBuffer_t *pxStreamBuffer, uint8_t *pucData, size_t xCount, size_t xTail )
 {
-size_t xCount, xFirstLength, xNextTail;
+size_t xFirstLength, xEnd;
 
-	/* Use the minimum of the wanted bytes and the available bytes. */
-	xCount = configMIN( xBytesAvailable, xMaxCount );
+	configASSERT( xCount > ( size_t ) 0 );
 
-	if( xCount > ( size_t ) 0 )
+	/* If the data wraps then it ends at the watermark, which the writer
+	updates before updating the head. */
+	if( pxStreamBuffer->xHead < xTail )
 	{
-		xNextTail = pxStreamBuffer->xTail;
+		xEnd = pxStreamBuffer->xWatermark;
+	}
+	else
+	{
+		xEnd = pxStreamBuffer->xLength;
+	}
 
-		/* Calculate the number of bytes that can be read - which may be
-		less than the number wanted if the data wraps around to the start of
-		the buffer. */
-		xFirstLength = configMIN( pxStreamBuffer->xLength - xNextTail, xCount );
+	/* Calculate the number of bytes that can be read - which may be
+	less than the number wanted if the data wraps around to the start of
+	the buffer. */
+	xFirstLength = configMIN( xEnd - xTail, xCount );
 
-		/* Obtain the number of bytes it is possible to obtain in the first
-		read.  Asserts check bounds of read and write. */
-		configASSERT( xFirstLength <= xMaxCount );
-		configASSERT( ( xNextTail + xFirstLength ) <= pxStreamBuffer->xLength );
-		( void ) memcpy( ( void * ) pucData, ( const void * ) &( pxStreamBuffer->pucBuffer[ xNextTail ] ), xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+	/* Obtain the number of bytes it is possible to obtain in the first
+	read.  Asserts check bounds of read and write. */
+	configASSERT( ( xTail + xFirstLength ) <= pxStreamBuffer->xLength );
+	( void ) memcpy( ( void * ) pucData, ( const void * ) &( pxStreamBuffer->pucBuffer[ xTail ] ), xFirstLength ); /*lint !e9087 memcpy() requires void *. */
 
-		/* If the total number of wanted bytes is greater than the number
-		that could be read in the first read... */
-		if( xCount > xFirstLength )
+	/* If the total number of wanted bytes is greater than the number
+	that could be read in the first read... */
+	if( xCount > xFirstLength )
+	{
+		/*...then read the remaining bytes from the start of the buffer. */
+		configASSERT( ( xCount - xFirstLength ) <= pxStreamBuffer->xLength );
+		( void ) memcpy( ( void * ) &( pucData[ xFirstLength ] ), ( void * ) ( pxStreamBuffer->pucBuffer ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* Move past the bytes read. */
+	xTail += xCount;
+
+	if( xTail >= xEnd )
+	{
+		xTail -= xEnd;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xTail;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer )
+{
+/* Returns the distance between xTail and xHead. */
+size_t xCount, xHead;
+
+	xHead = pxStreamBuffer->xHead;
+
+	if( xHead >= pxStreamBuffer->xTail )
+	{
+		xCount = xHead - pxStreamBuffer->xTail;
+	}
+	else
+	{
+		/* The data wraps, and ends at the watermark rather than the end of
+		the buffer if a reservation skipped the bytes at the end of the
+		buffer.  The writer updates the watermark before the head. */
+		xCount = pxStreamBuffer->xWatermark - pxStreamBuffer->xTail;
+		xCount += xHead;
+	}
+
+	return xCount;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvContiguousBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer,
+										  size_t xTail,
+										  size_t *pxReadIndex )
+{
+size_t xCount, xHead;
+
+	/* The head is only read once, as the writer can wrap it at any time. */
+	xHead = pxStreamBuffer->xHead;
+	*pxReadIndex = xTail;
+
+	if( xHead >= xTail )
+	{
+		xCount = xHead - xTail;
+	}
+	else if( xTail < pxStreamBuffer->xWatermark )
+	{
+		/* The data wraps, so only the bytes up to the watermark are
+		contiguous. */
+		xCount = pxStreamBuffer->xWatermark - xTail;
+	}
+	else
+	{
+		/* The tail is at the watermark, so the data continues from the start
+		of the buffer. */
+		*pxReadIndex = 0;
+		xCount = xHead;
+	}
+
+	return xCount;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvFindContiguousSpace( const StreamBuffer_t * const pxStreamBuffer,
+										  size_t xRequiredSpace,
+										  size_t *pxReservedHead )
+{
+size_t xHead, xTail, xSpace;
+BaseType_t xReturn = pdFALSE;
+
+	xHead = pxStreamBuffer->xHead;
+	xTail = pxStreamBuffer->xTail;
+
+	if( xHead < xTail )
+	{
+		/* The free space is between the head and the tail, less the byte that
+		is always left free so a full buffer can be distinguished from an empty
+		buffer. */
+		if( xRequiredSpace < ( xTail - xHead ) )
 		{
-			/*...then read the remaining bytes from the start of the buffer. */
-			configASSERT( xCount <= xMaxCount );
-			( void ) memcpy( ( void * ) &( pucData[ xFirstLength ] ), ( void * ) ( pxStreamBuffer->pucBuffer ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+			*pxReservedHead = xHead;
+			xReturn = pdTRUE;
 		}
 		else
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
+	}
+	else
+	{
+		/* The free space runs from the head to the end of the buffer, then
+		from the start of the buffer to the tail. */
+		xSpace = pxStreamBuffer->xLength - xHead;
 
-		/* Move the tail pointer to effectively remove the data read from
-		the buffer. */
-		xNextTail += xCount;
+		if( xTail == ( size_t ) 0 )
+		{
+			xSpace--;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
 
-		if( xNextTail >= pxStreamBuffer->xLength )
+		if( xRequiredSpace <= xSpace )
+		{
+			*pxReservedHead = xHead;
+			xReturn = pdTRUE;
+		}
+		else if( xRequiredSpace < xTail )
 		{
-			xNextTail -= pxStreamBuffer->xLength;
+			/* Too little space at the end of the buffer, so skip it and use
+			the space at the start.  The skipped bytes are unused until the
+			reader passes them. */
+			*pxReservedHead = 0;
+			xReturn = pdTRUE;
 		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvReserve( StreamBuffer_t * const pxStreamBuffer,
+						 size_t xRequiredSpace,
+						 size_t xReservedHead )
+{
+size_t xDataIndex = xReservedHead;
+
+	pxStreamBuffer->xReservedHead = xReservedHead;
+	pxStreamBuffer->xReservedLength = xRequiredSpace;
 
-		pxStreamBuffer->xTail = xNextTail;
+	/* The data of a message follows the message length, which is written
+	when the message is committed. */
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		xDataIndex += sbBYTES_TO_STORE_MESSAGE_LENGTH;
 	}
 	else
 	{
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	return xCount;
+	return ( void * ) &( pxStreamBuffer->pucBuffer[ xDataIndex ] );
 }
 /*-----------------------------------------------------------*/
 
-static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer )
+static size_t prvCommit( StreamBuffer_t * const pxStreamBuffer, size_t xDataLengthBytes )
 {
-/* Returns the distance between xTail and xHead. */
-size_t xCount;
+size_t xReturn = 0, xNextHead, xBytesToStoreMessageLength;
+configMESSAGE_BUFFER_LENGTH_TYPE xMessageLength;
 
-	xCount = pxStreamBuffer->xLength + pxStreamBuffer->xHead;
-	xCount -= pxStreamBuffer->xTail;
-	if ( xCount >= pxStreamBuffer->xLength )
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
 	{
-		xCount -= pxStreamBuffer->xLength;
+		xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+	}
+	else
+	{
+		xBytesToStoreMessageLength = 0;
+	}
+
+	/* A reservation must be outstanding, and cannot be committed beyond its
+	length. */
+	configASSERT( pxStreamBuffer->xReservedLength > xBytesToStoreMessageLength );
+	configASSERT( xDataLengthBytes <= ( pxStreamBuffer->xReservedLength - xBytesToStoreMessageLength ) );
+
+	/* Committing 0 bytes cancels the reservation. */
+	if( ( xDataLengthBytes > ( size_t ) 0 ) && ( ( xDataLengthBytes + xBytesToStoreMessageLength ) <= pxStreamBuffer->xReservedLength ) )
+	{
+		if( xBytesToStoreMessageLength != ( size_t ) 0 )
+		{
+			/* The reservation is contiguous, so the length is written directly
+			in front of the data. */
+			xMessageLength = ( configMESSAGE_BUFFER_LENGTH_TYPE ) xDataLengthBytes;
+			( void ) memcpy( ( void * ) &( pxStreamBuffer->pucBuffer[ pxStreamBuffer->xReservedHead ] ), ( const void * ) &xMessageLength, xBytesToStoreMessageLength ); /*lint !e9087 memcpy() requires void *. */
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xNextHead = pxStreamBuffer->xReservedHead + xBytesToStoreMessageLength + xDataLengthBytes;
+
+		if( pxStreamBuffer->xReservedHead != pxStreamBuffer->xHead )
+		{
+			/* The reservation skipped the bytes between the head and the end
+			of the buffer, so the data now wraps at the old head.  The
+			watermark must be valid before the reader can see the new head. */
+			pxStreamBuffer->xWatermark = pxStreamBuffer->xHead;
+		}
+		else if( xNextHead >= pxStreamBuffer->xLength )
+		{
+			/* The reservation ended at the end of the buffer. */
+			xNextHead = 0;
+			pxStreamBuffer->xWatermark = pxStreamBuffer->xLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxStreamBuffer->xHead = xNextHead;
+		xReturn = xDataLengthBytes;
 	}
 	else
 	{
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	return xCount;
+	pxStreamBuffer->xReservedLength = 0;
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvAcquire( StreamBuffer_t * const pxStreamBuffer,
+						  void **ppvRxData,
+						  size_t xBytesAvailable,
+						  size_t xBytesToStoreMessageLength )
+{
+size_t xTail, xReadIndex = 0, xReceivedLength = 0;
+configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+
+	*ppvRxData = NULL;
+
+	if( xBytesAvailable > xBytesToStoreMessageLength )
+	{
+		xTail = pxStreamBuffer->xTail;
+
+		if( xBytesToStoreMessageLength != ( size_t ) 0 )
+		{
+			/* Peek the length of the message - the tail is not moved until the
+			message is released. */
+			xTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, xBytesToStoreMessageLength, xTail );
+			xReceivedLength = ( size_t ) xTempNextMessageLength;
+
+			/* Messages written by xStreamBufferSendReserve() are always
+			contiguous, but messages written by xStreamBufferSend() can wrap
+			around the end of the buffer, in which case they cannot be read in
+			place. */
+			if( prvContiguousBytesInBuffer( pxStreamBuffer, xTail, &xReadIndex ) < xReceivedLength )
+			{
+				xReceivedLength = 0;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			xReceivedLength = prvContiguousBytesInBuffer( pxStreamBuffer, xTail, &xReadIndex );
+		}
+
+		if( xReceivedLength > ( size_t ) 0 )
+		{
+			*ppvRxData = ( void * ) &( pxStreamBuffer->pucBuffer[ xReadIndex ] );
+			pxStreamBuffer->xAcquiredLength = xReceivedLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReceivedLength;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvRelease( StreamBuffer_t * const pxStreamBuffer, size_t xDataLengthBytes )
+{
+size_t xTail, xReadIndex, xReturn = 0;
+configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+
+	/* Data must have been acquired, and cannot be released beyond the length
+	acquired. */
+	configASSERT( pxStreamBuffer->xAcquiredLength > ( size_t ) 0 );
+	configASSERT( xDataLengthBytes <= pxStreamBuffer->xAcquiredLength );
+
+	xTail = pxStreamBuffer->xTail;
+
+	if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+	{
+		/* A message is always released in its entirety, along with the length
+		in front of it. */
+		xDataLengthBytes = pxStreamBuffer->xAcquiredLength;
+
+		if( xDataLengthBytes > ( size_t ) 0 )
+		{
+			xTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xTail );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		xDataLengthBytes = configMIN( xDataLengthBytes, pxStreamBuffer->xAcquiredLength );
+	}
+
+	if( xDataLengthBytes > ( size_t ) 0 )
+	{
+		/* The data acquired starts at the same index it did when it was
+		acquired, as the head cannot move past the tail. */
+		( void ) prvContiguousBytesInBuffer( pxStreamBuffer, xTail, &xReadIndex );
+		xTail = xReadIndex + xDataLengthBytes;
+
+		if( xTail >= pxStreamBuffer->xLength )
+		{
+			xTail = 0;
+		}
+		else if( ( pxStreamBuffer->xHead < pxStreamBuffer->xTail ) && ( xTail >= pxStreamBuffer->xWatermark ) )
+		{
+			/* Released up to the watermark, so the next data is at the start
+			of the buffer. */
+			xTail = 0;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Move the tail pointer to effectively remove the data from the
+		buffer. */
+		pxStreamBuffer->xTail = xTail;
+		xReturn = xDataLengthBytes;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxStreamBuffer->xAcquiredLength = 0;
+
+	return xReturn;
 }
 /*-----------------------------------------------------------*/
 
@@ -1228,6 +1947,7 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 	( void ) memset( ( void * ) pxStreamBuffer, 0x00, sizeof( StreamBuffer_t ) ); /*lint !e9087 memset() requires void *. */
 	pxStreamBuffer->pucBuffer = pucBuffer;
 	pxStreamBuffer->xLength = xBufferSizeBytes;
+	pxStreamBuffer->xWatermark = xBufferSizeBytes;
 	pxStreamBuffer->xTriggerLevelBytes = xTriggerLevelBytes;
 	pxStreamBuffer->ucFlags = ucFlags;
 }
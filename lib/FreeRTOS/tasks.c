@@ -40,6 +40,10 @@ task.h is included from an application file. */
 #include "timers.h"
 #include "stack_macros.h"
 
+#if ( configUSE_WORK_QUEUES == 1 )
+	#include "work_queue.h"
+#endif
+
 /* Lint e9021, e961 and e750 are suppressed as a MISRA exception justified
 because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
 for the header files above, but not in this file, in order to generate the
@@ -247,6 +251,43 @@ count overflows. */
  */
 #define prvGetTCBFromHandle( pxHandle ) ( ( ( pxHandle ) == NULL ) ? pxCurrentTCB : ( pxHandle ) )
 
+#if ( configNUM_CORES == 1 )
+
+	/* Only one task can be running, and it is the task pointed to by
+	pxCurrentTCB. */
+	#define taskTASK_IS_RUNNING( pxTCB )	( ( pxTCB ) == pxCurrentTCB )
+
+	/* Evaluates to non-zero if pxTCB, which has just been placed in a ready
+	list, has a priority that means the calling task should yield.  If
+	xPreemptEqualPriority is pdTRUE then a task of equal priority to the
+	calling task also causes a yield. */
+	#define taskYIELD_REQUIRED_FOR_TASK( pxTCB, xPreemptEqualPriority )											\
+		( ( ( pxTCB )->uxPriority > pxCurrentTCB->uxPriority ) ||												\
+		  ( ( ( xPreemptEqualPriority ) != pdFALSE ) && ( ( pxTCB )->uxPriority == pxCurrentTCB->uxPriority ) ) )
+
+#else /* configNUM_CORES */
+
+	/* Value of xTaskRunState when a task is not running on any core. */
+	#define taskTASK_NOT_RUNNING			( ( BaseType_t ) -1 )
+
+	/* A task can be running on any core, in which case its xTaskRunState
+	member holds the ID of that core. */
+	#define taskTASK_IS_RUNNING( pxTCB )	( ( pxTCB )->xTaskRunState != taskTASK_NOT_RUNNING )
+
+	/* With more than one core a task that has just been readied may preempt
+	the task running on any core it is allowed to run on, not just the calling
+	core.  prvYieldForTask() interrupts whichever core should switch to the task
+	and returns pdTRUE only if that core is the calling core. */
+	#define taskYIELD_REQUIRED_FOR_TASK( pxTCB, xPreemptEqualPriority )	prvYieldForTask( ( pxTCB ), ( xPreemptEqualPriority ) )
+
+	#if ( configUSE_CORE_AFFINITY == 1 )
+		#define taskTASK_CAN_RUN_ON_CORE( pxTCB, xCoreID )	( ( ( pxTCB )->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) ( xCoreID ) ) ) != 0U )
+	#else
+		#define taskTASK_CAN_RUN_ON_CORE( pxTCB, xCoreID )	( pdTRUE )
+	#endif
+
+#endif /* configNUM_CORES */
+
 /* The item value of the event list item is normally used to hold the priority
 of the task to which it belongs (coded to allow it to be held in reverse
 priority order).  However, it is occasionally borrowed for other purposes.  It
@@ -340,6 +381,17 @@ typedef struct tskTaskControlBlock /* The old naming convention is used to preve
 		int iTaskErrno;
 	#endif
 
+	#if( configUSE_HEAP_PROFILER == 1 )
+		UBaseType_t		uxHeapTag;			/*< The tag the heap profiler records against memory allocated by the task. */
+	#endif
+
+	#if ( configNUM_CORES > 1 )
+		volatile BaseType_t xTaskRunState;	/*< The ID of the core the task is running on, or taskTASK_NOT_RUNNING.  Running tasks remain in their ready list. */
+		#if ( configUSE_CORE_AFFINITY == 1 )
+			UBaseType_t	uxCoreAffinityMask;	/*< Bit n is set if the task is allowed to run on core n. */
+		#endif
+	#endif
+
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -348,7 +400,17 @@ typedef tskTCB TCB_t;
 
 /*lint -save -e956 A manual analysis and inspection has been used to determine
 which static variables must be declared volatile. */
-PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
+#if ( configNUM_CORES == 1 )
+	PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
+#else
+	/* Each core has its own current task.  Kernel code reads the calling core's
+	current task through xTaskGetCurrentTaskHandle(), which masks interrupts so
+	the calling task cannot be moved to another core between obtaining the core
+	ID and indexing the array.  Code that already holds the scheduler locks
+	indexes pxCurrentTCBs[] directly. */
+	PRIVILEGED_DATA TCB_t * volatile pxCurrentTCBs[ configNUM_CORES ] = { NULL };
+	#define pxCurrentTCB xTaskGetCurrentTaskHandle()
+#endif
 
 /* Lists for ready and blocked tasks. --------------------
 xDelayedTaskList1 and xDelayedTaskList2 could be move to function scople but
@@ -386,11 +448,22 @@ PRIVILEGED_DATA static volatile TickType_t xTickCount 				= ( TickType_t ) confi
 PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority 		= tskIDLE_PRIORITY;
 PRIVILEGED_DATA static volatile BaseType_t xSchedulerRunning 		= pdFALSE;
 PRIVILEGED_DATA static volatile UBaseType_t uxPendedTicks 			= ( UBaseType_t ) 0U;
-PRIVILEGED_DATA static volatile BaseType_t xYieldPending 			= pdFALSE;
+#if ( configNUM_CORES == 1 )
+	PRIVILEGED_DATA static volatile BaseType_t xYieldPending 		= pdFALSE;
+#else
+	PRIVILEGED_DATA static volatile BaseType_t xYieldPendings[ configNUM_CORES ] = { pdFALSE };
+	#define xYieldPending xYieldPendings[ portGET_CORE_ID() ]
+#endif
 PRIVILEGED_DATA static volatile BaseType_t xNumOfOverflows 			= ( BaseType_t ) 0;
 PRIVILEGED_DATA static UBaseType_t uxTaskNumber 					= ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xNextTaskUnblockTime		= ( TickType_t ) 0U; /* Initialised to portMAX_DELAY before the scheduler starts. */
-PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandle					= NULL;			/*< Holds the handle of the idle task.  The idle task is created automatically when the scheduler is started. */
+#if ( configNUM_CORES == 1 )
+	PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandle				= NULL;			/*< Holds the handle of the idle task.  The idle task is created automatically when the scheduler is started. */
+#else
+	PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandles[ configNUM_CORES ] = { NULL };	/*< One idle task per core.  Element 0 is the idle task that runs the idle hook and frees deleted tasks. */
+	PRIVILEGED_DATA static volatile UBaseType_t uxCriticalNestings[ configNUM_CORES ] = { 0U };	/*< Critical section nesting depth of each core. */
+	#define xIdleTaskHandle xIdleTaskHandles[ 0 ]
+#endif
 
 /* Context switches are held pending while the scheduler is suspended.  Also,
 interrupts must not manipulate the xStateListItem of a TCB, or any of the
@@ -402,11 +475,31 @@ when the scheduler is unsuspended.  The pending ready list itself can only be
 accessed from a critical section. */
 PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended	= ( UBaseType_t ) pdFALSE;
 
+/* The high resolution time is held as two copies of a 64-bit count and the
+value of the port's high resolution count when the copy was written.  The tick
+writes the copy that is not in use then increments uxHighResolutionSequence,
+the low bit of which selects the copy in use.  Readers retry if the sequence
+changed while they read, so they never need a critical section, and a reader
+that interrupts the tick reads the copy that is not being written. */
+typedef struct xHIGH_RESOLUTION_TIME
+{
+	uint64_t ullCount;		/*< Counts of portHIGH_RESOLUTION_COUNT_HZ since the scheduler started, or ticks if the port has no high resolution count. */
+	uint32_t ulPortCount;	/*< The port's high resolution count when ullCount was written. */
+} HighResolutionTime_t;
+
+PRIVILEGED_DATA static volatile HighResolutionTime_t xHighResolutionTimes[ 2 ];
+PRIVILEGED_DATA static volatile UBaseType_t uxHighResolutionSequence = ( UBaseType_t ) 0U;
+
 #if ( configGENERATE_RUN_TIME_STATS == 1 )
 
 	/* Do not move these variables to function scope as doing so prevents the
 	code working with debuggers that need to remove the static qualifier. */
-	PRIVILEGED_DATA static uint32_t ulTaskSwitchedInTime = 0UL;	/*< Holds the value of a timer/counter the last time a task was switched in. */
+	#if ( configNUM_CORES == 1 )
+		PRIVILEGED_DATA static uint32_t ulTaskSwitchedInTime = 0UL;	/*< Holds the value of a timer/counter the last time a task was switched in. */
+	#else
+		PRIVILEGED_DATA static uint32_t ulTaskSwitchedInTimes[ configNUM_CORES ] = { 0UL };	/*< Holds the value of a timer/counter the last time a task was switched in on each core. */
+		#define ulTaskSwitchedInTime ulTaskSwitchedInTimes[ portGET_CORE_ID() ]
+	#endif
 	PRIVILEGED_DATA static uint32_t ulTotalRunTime = 0UL;		/*< Holds the total amount of execution time as defined by the run time counter clock. */
 
 #endif
@@ -432,6 +525,14 @@ PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended	= ( UBaseType_t
 
 	extern void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize ); /*lint !e526 Symbol not defined as it is an application callback. */
 
+	#if( configNUM_CORES > 1 )
+
+		/* Provides the memory for the idle task of each core other than core 0.
+		xPassiveIdleTaskIndex is 0 for core 1, 1 for core 2, etc. */
+		extern void vApplicationGetPassiveIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize, BaseType_t xPassiveIdleTaskIndex ); /*lint !e526 Symbol not defined as it is an application callback. */
+
+	#endif
+
 #endif
 
 /* File private functions. --------------------------------*/
@@ -466,6 +567,38 @@ static void prvInitialiseTaskLists( void ) PRIVILEGED_FUNCTION;
  */
 static portTASK_FUNCTION_PROTO( prvIdleTask, pvParameters );
 
+#if ( configNUM_CORES > 1 )
+
+	/*
+	 * The idle task created for each core other than core 0.  Passive idle
+	 * tasks do not call the idle hook or free deleted tasks, so neither has to
+	 * be re-entrant.
+	 */
+	static portTASK_FUNCTION_PROTO( prvPassiveIdleTask, pvParameters );
+
+	/*
+	 * Make core xCoreID run the highest priority ready task that is not already
+	 * running on another core and that is allowed to run on xCoreID.  Must be
+	 * called with both the task lock and the ISR lock held.
+	 */
+	static void prvSelectHighestPriorityTask( const BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Request a context switch on core xCoreID.  If xCoreID is the calling core
+	 * the request is just latched in xYieldPendings[] - it is up to the caller
+	 * to yield.  Must be called from a critical section.
+	 */
+	static void prvYieldCore( const BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called after pxTCB has been placed in a ready list.  Requests a context
+	 * switch on the core running the lowest priority task that pxTCB can
+	 * preempt, if any.  Returns pdTRUE if the calling core must yield.
+	 */
+	static BaseType_t prvYieldForTask( const TCB_t * const pxTCB, const BaseType_t xPreemptEqualPriority ) PRIVILEGED_FUNCTION;
+
+#endif /* configNUM_CORES */
+
 /*
  * Utility to free all memory allocated by the scheduler to hold a TCB,
  * including the stack pointed to by the TCB.
@@ -577,6 +710,13 @@ static void prvInitialiseNewTask( 	TaskFunction_t pxTaskCode,
  */
 static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 
+/*
+ * Called from the tick to advance the high resolution time by the elapsed
+ * high resolution count, or by xTicksElapsed if the port has no high
+ * resolution count.  Must be called at least once per wrap of the count.
+ */
+static void prvUpdateHighResolutionTime( const TickType_t xTicksElapsed ) PRIVILEGED_FUNCTION;
+
 /*
  * freertos_tasks_c_additions_init() should only be called if the user definable
  * macro FREERTOS_TASKS_C_ADDITIONS_INIT() is defined, as that is the only macro
@@ -962,12 +1102,30 @@ UBaseType_t x;
 	}
 	#endif /* portCRITICAL_NESTING_IN_TCB */
 
+	#if ( configNUM_CORES > 1 )
+	{
+		pxNewTCB->xTaskRunState = taskTASK_NOT_RUNNING;
+
+		#if ( configUSE_CORE_AFFINITY == 1 )
+		{
+			pxNewTCB->uxCoreAffinityMask = tskNO_AFFINITY;
+		}
+		#endif
+	}
+	#endif /* configNUM_CORES */
+
 	#if ( configUSE_APPLICATION_TASK_TAG == 1 )
 	{
 		pxNewTCB->pxTaskTag = NULL;
 	}
 	#endif /* configUSE_APPLICATION_TASK_TAG */
 
+	#if ( configUSE_HEAP_PROFILER == 1 )
+	{
+		pxNewTCB->uxHeapTag = 0;
+	}
+	#endif /* configUSE_HEAP_PROFILER */
+
 	#if ( configGENERATE_RUN_TIME_STATS == 1 )
 	{
 		pxNewTCB->ulRunTimeCounter = 0UL;
@@ -1048,45 +1206,64 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 	taskENTER_CRITICAL();
 	{
 		uxCurrentNumberOfTasks++;
-		if( pxCurrentTCB == NULL )
-		{
-			/* There are no other tasks, or all the other tasks are in
-			the suspended state - make this the current task. */
-			pxCurrentTCB = pxNewTCB;
 
-			if( uxCurrentNumberOfTasks == ( UBaseType_t ) 1 )
+		#if ( configNUM_CORES == 1 )
+		{
+			if( pxCurrentTCB == NULL )
 			{
-				/* This is the first task to be created so do the preliminary
-				initialisation required.  We will not recover if this call
-				fails, but we will report the failure. */
-				prvInitialiseTaskLists();
+				/* There are no other tasks, or all the other tasks are in
+				the suspended state - make this the current task. */
+				pxCurrentTCB = pxNewTCB;
+
+				if( uxCurrentNumberOfTasks == ( UBaseType_t ) 1 )
+				{
+					/* This is the first task to be created so do the preliminary
+					initialisation required.  We will not recover if this call
+					fails, but we will report the failure. */
+					prvInitialiseTaskLists();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
 			}
 			else
 			{
-				mtCOVERAGE_TEST_MARKER();
-			}
-		}
-		else
-		{
-			/* If the scheduler is not already running, make this task the
-			current task if it is the highest priority task to be created
-			so far. */
-			if( xSchedulerRunning == pdFALSE )
-			{
-				if( pxCurrentTCB->uxPriority <= pxNewTCB->uxPriority )
+				/* If the scheduler is not already running, make this task the
+				current task if it is the highest priority task to be created
+				so far. */
+				if( xSchedulerRunning == pdFALSE )
 				{
-					pxCurrentTCB = pxNewTCB;
+					if( pxCurrentTCB->uxPriority <= pxNewTCB->uxPriority )
+					{
+						pxCurrentTCB = pxNewTCB;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
 				}
 				else
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
 			}
+		}
+		#else /* configNUM_CORES */
+		{
+			/* Tasks are only given a core by prvSelectHighestPriorityTask(),
+			which is called for every core when the scheduler starts and then
+			each time a core switches context. */
+			if( uxCurrentNumberOfTasks == ( UBaseType_t ) 1 )
+			{
+				prvInitialiseTaskLists();
+			}
 			else
 			{
 				mtCOVERAGE_TEST_MARKER();
 			}
 		}
+		#endif /* configNUM_CORES */
 
 		uxTaskNumber++;
 
@@ -1108,7 +1285,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 	{
 		/* If the created task is of a higher priority than the current task
 		then it should run now. */
-		if( pxCurrentTCB->uxPriority < pxNewTCB->uxPriority )
+		if( taskYIELD_REQUIRED_FOR_TASK( pxNewTCB, pdFALSE ) != pdFALSE )
 		{
 			taskYIELD_IF_USING_PREEMPTION();
 		}
@@ -1162,7 +1339,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			not return. */
 			uxTaskNumber++;
 
-			if( pxTCB == pxCurrentTCB )
+			if( taskTASK_IS_RUNNING( pxTCB ) )
 			{
 				/* A task is deleting itself.  This cannot complete within the
 				task itself, as a context switch to another task is required.
@@ -1176,6 +1353,22 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				check the xTasksWaitingTermination list. */
 				++uxDeletedTasksWaitingCleanUp;
 
+				#if ( configNUM_CORES > 1 )
+				{
+					/* The task may be running on another core, in which case
+					that core must switch away from it before the idle task can
+					free it. */
+					if( pxTCB->xTaskRunState != portGET_CORE_ID() )
+					{
+						prvYieldCore( pxTCB->xTaskRunState );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configNUM_CORES */
+
 				/* The pre-delete hook is primarily for the Windows simulator,
 				in which Windows specific clean up operations are performed,
 				after which it is not possible to yield away from this task -
@@ -1342,6 +1535,49 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		}
 	}
 
+	void vTaskDelayUntilHighResolutionTime( const uint64_t ullWakeTime )
+	{
+	const uint64_t ullNanosecondsPerTick = 1000000000ULL / ( uint64_t ) configTICK_RATE_HZ;
+	uint64_t ullTimeNow = ullTaskGetHighResolutionTime();
+	uint64_t ullTicksRemaining;
+
+		while( ullTimeNow < ullWakeTime )
+		{
+			#ifdef portGET_HIGH_RESOLUTION_COUNT
+			{
+				/* A delay of n ticks ends on the nth tick interrupt, which is
+				between n - 1 and n tick periods away, and the tick can run
+				late.  So while more than two periods remain block until all
+				but one of them have passed, then block until the next tick,
+				then busy wait for what is left. */
+				ullTicksRemaining = ( ullWakeTime - ullTimeNow ) / ullNanosecondsPerTick;
+
+				if( ullTicksRemaining > 1ULL )
+				{
+					vTaskDelay( ( TickType_t ) configMIN( ullTicksRemaining - 1ULL, ( uint64_t ) ( portMAX_DELAY - 1U ) ) );
+				}
+				else if( ullTicksRemaining == 1ULL )
+				{
+					vTaskDelay( ( TickType_t ) 1 );
+				}
+				else
+				{
+					taskYIELD();
+				}
+			}
+			#else
+			{
+				/* The time only advances with the tick, so block until the
+				first tick at or after the wake time. */
+				ullTicksRemaining = ( ( ullWakeTime - ullTimeNow ) + ( ullNanosecondsPerTick - 1ULL ) ) / ullNanosecondsPerTick;
+				vTaskDelay( ( TickType_t ) configMIN( ullTicksRemaining, ( uint64_t ) ( portMAX_DELAY - 1U ) ) );
+			}
+			#endif
+
+			ullTimeNow = ullTaskGetHighResolutionTime();
+		}
+	}
+
 #endif /* INCLUDE_vTaskDelay */
 /*-----------------------------------------------------------*/
 
@@ -1355,9 +1591,11 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 
 		configASSERT( pxTCB );
 
-		if( pxTCB == pxCurrentTCB )
+		if( taskTASK_IS_RUNNING( pxTCB ) )
 		{
-			/* The task calling this function is querying its own state. */
+			/* The task calling this function is querying its own state, or,
+			when there is more than one core, the state of a task running on
+			another core. */
 			eReturn = eRunning;
 		}
 		else
@@ -1484,14 +1722,14 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		https://www.freertos.org/RTOS-Cortex-M3-M4.html */
 		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
-		uxSavedInterruptState = portSET_INTERRUPT_MASK_FROM_ISR();
+		uxSavedInterruptState = taskENTER_CRITICAL_FROM_ISR();
 		{
 			/* If null is passed in here then it is the priority of the calling
 			task that is being queried. */
 			pxTCB = prvGetTCBFromHandle( xTask );
 			uxReturn = pxTCB->uxPriority;
 		}
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptState );
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptState );
 
 		return uxReturn;
 	}
@@ -1539,44 +1777,48 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 
 			if( uxCurrentBasePriority != uxNewPriority )
 			{
-				/* The priority change may have readied a task of higher
-				priority than the calling task. */
-				if( uxNewPriority > uxCurrentBasePriority )
+				#if ( configNUM_CORES == 1 )
 				{
-					if( pxTCB != pxCurrentTCB )
+					/* The priority change may have readied a task of higher
+					priority than the calling task. */
+					if( uxNewPriority > uxCurrentBasePriority )
 					{
-						/* The priority of a task other than the currently
-						running task is being raised.  Is the priority being
-						raised above that of the running task? */
-						if( uxNewPriority >= pxCurrentTCB->uxPriority )
+						if( pxTCB != pxCurrentTCB )
 						{
-							xYieldRequired = pdTRUE;
+							/* The priority of a task other than the currently
+							running task is being raised.  Is the priority being
+							raised above that of the running task? */
+							if( uxNewPriority >= pxCurrentTCB->uxPriority )
+							{
+								xYieldRequired = pdTRUE;
+							}
+							else
+							{
+								mtCOVERAGE_TEST_MARKER();
+							}
 						}
 						else
 						{
-							mtCOVERAGE_TEST_MARKER();
+							/* The priority of the running task is being raised,
+							but the running task must already be the highest
+							priority task able to run so no yield is required. */
 						}
 					}
+					else if( pxTCB == pxCurrentTCB )
+					{
+						/* Setting the priority of the running task down means
+						there may now be another task of higher priority that
+						is ready to execute. */
+						xYieldRequired = pdTRUE;
+					}
 					else
 					{
-						/* The priority of the running task is being raised,
-						but the running task must already be the highest
-						priority task able to run so no yield is required. */
+						/* Setting the priority of any other task down does not
+						require a yield as the running task must be above the
+						new priority of the task being modified. */
 					}
 				}
-				else if( pxTCB == pxCurrentTCB )
-				{
-					/* Setting the priority of the running task down means
-					there may now be another task of higher priority that
-					is ready to execute. */
-					xYieldRequired = pdTRUE;
-				}
-				else
-				{
-					/* Setting the priority of any other task down does not
-					require a yield as the running task must be above the
-					new priority of the task being modified. */
-				}
+				#endif /* configNUM_CORES */
 
 				/* Remember the ready list the task might be referenced from
 				before its uxPriority member is changed so the
@@ -1643,6 +1885,36 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 					mtCOVERAGE_TEST_MARKER();
 				}
 
+				#if ( configNUM_CORES > 1 )
+				{
+					/* With more than one core the decision can only be made
+					once the task is in the ready list for its new priority. */
+					if( taskTASK_IS_RUNNING( pxTCB ) )
+					{
+						/* Lowering the priority of a running task means the core
+						running it may now have a higher priority task to run. */
+						if( uxNewPriority < uxCurrentBasePriority )
+						{
+							prvYieldCore( pxTCB->xTaskRunState );
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						xYieldRequired = xYieldPendings[ portGET_CORE_ID() ];
+					}
+					else if( uxNewPriority > uxCurrentBasePriority )
+					{
+						xYieldRequired = prvYieldForTask( pxTCB, pdTRUE );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configNUM_CORES */
+
 				if( xYieldRequired != pdFALSE )
 				{
 					taskYIELD_IF_USING_PREEMPTION();
@@ -1710,6 +1982,21 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				}
 			}
 			#endif
+
+			#if ( configNUM_CORES > 1 )
+			{
+				/* A task suspended while it is running on another core keeps
+				running until that core switches context. */
+				if( ( taskTASK_IS_RUNNING( pxTCB ) ) && ( pxTCB->xTaskRunState != portGET_CORE_ID() ) )
+				{
+					prvYieldCore( pxTCB->xTaskRunState );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configNUM_CORES */
 		}
 		taskEXIT_CRITICAL();
 
@@ -1738,21 +2025,30 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			}
 			else
 			{
-				/* The scheduler is not running, but the task that was pointed
-				to by pxCurrentTCB has just been suspended and pxCurrentTCB
-				must be adjusted to point to a different task. */
-				if( listCURRENT_LIST_LENGTH( &xSuspendedTaskList ) == uxCurrentNumberOfTasks ) /*lint !e931 Right has no side effect, just volatile. */
+				#if ( configNUM_CORES == 1 )
 				{
-					/* No other tasks are ready, so set pxCurrentTCB back to
-					NULL so when the next task is created pxCurrentTCB will
-					be set to point to it no matter what its relative priority
-					is. */
-					pxCurrentTCB = NULL;
+					/* The scheduler is not running, but the task that was pointed
+					to by pxCurrentTCB has just been suspended and pxCurrentTCB
+					must be adjusted to point to a different task. */
+					if( listCURRENT_LIST_LENGTH( &xSuspendedTaskList ) == uxCurrentNumberOfTasks ) /*lint !e931 Right has no side effect, just volatile. */
+					{
+						/* No other tasks are ready, so set pxCurrentTCB back to
+						NULL so when the next task is created pxCurrentTCB will
+						be set to point to it no matter what its relative priority
+						is. */
+						pxCurrentTCB = NULL;
+					}
+					else
+					{
+						vTaskSwitchContext();
+					}
 				}
-				else
+				#else
 				{
-					vTaskSwitchContext();
+					/* Cores are not given tasks until the scheduler starts. */
+					mtCOVERAGE_TEST_MARKER();
 				}
+				#endif /* configNUM_CORES */
 			}
 		}
 		else
@@ -1835,7 +2131,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 					prvAddTaskToReadyList( pxTCB );
 
 					/* A higher priority task may have just been resumed. */
-					if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+					if( taskYIELD_REQUIRED_FOR_TASK( pxTCB, pdTRUE ) != pdFALSE )
 					{
 						/* This yield may not cause the task just resumed to run,
 						but will leave the lists in the correct state for the
@@ -1892,7 +2188,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		https://www.freertos.org/RTOS-Cortex-M3-M4.html */
 		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
-		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 		{
 			if( prvTaskIsTaskSuspended( pxTCB ) != pdFALSE )
 			{
@@ -1903,7 +2199,10 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				{
 					/* Ready lists can be accessed so move the task from the
 					suspended list to the ready list directly. */
-					if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					prvAddTaskToReadyList( pxTCB );
+
+					if( taskYIELD_REQUIRED_FOR_TASK( pxTCB, pdTRUE ) != pdFALSE )
 					{
 						xYieldRequired = pdTRUE;
 					}
@@ -1911,9 +2210,6 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 					{
 						mtCOVERAGE_TEST_MARKER();
 					}
-
-					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-					prvAddTaskToReadyList( pxTCB );
 				}
 				else
 				{
@@ -1928,7 +2224,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				mtCOVERAGE_TEST_MARKER();
 			}
 		}
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
 		return xYieldRequired;
 	}
@@ -1979,6 +2275,52 @@ BaseType_t xReturn;
 	}
 	#endif /* configSUPPORT_STATIC_ALLOCATION */
 
+	#if ( configNUM_CORES > 1 )
+	{
+	BaseType_t xCoreID;
+
+		/* Every other core gets a passive idle task so there is always a task
+		available for each core to run. */
+		for( xCoreID = 1; ( xCoreID < ( BaseType_t ) configNUM_CORES ) && ( xReturn == pdPASS ); xCoreID++ )
+		{
+			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+			{
+				StaticTask_t *pxIdleTaskTCBBuffer = NULL;
+				StackType_t *pxIdleTaskStackBuffer = NULL;
+				uint32_t ulIdleTaskStackSize;
+
+				vApplicationGetPassiveIdleTaskMemory( &pxIdleTaskTCBBuffer, &pxIdleTaskStackBuffer, &ulIdleTaskStackSize, xCoreID - 1 );
+				xIdleTaskHandles[ xCoreID ] = xTaskCreateStatic(	prvPassiveIdleTask,
+																	configIDLE_TASK_NAME,
+																	ulIdleTaskStackSize,
+																	( void * ) NULL, /*lint !e961.  The cast is not redundant for all compilers. */
+																	portPRIVILEGE_BIT,
+																	pxIdleTaskStackBuffer,
+																	pxIdleTaskTCBBuffer ); /*lint !e961 MISRA exception, justified as it is not a redundant explicit cast to all supported compilers. */
+
+				if( xIdleTaskHandles[ xCoreID ] == NULL )
+				{
+					xReturn = pdFAIL;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#else
+			{
+				xReturn = xTaskCreate(	prvPassiveIdleTask,
+										configIDLE_TASK_NAME,
+										configMINIMAL_STACK_SIZE,
+										( void * ) NULL,
+										portPRIVILEGE_BIT,
+										&( xIdleTaskHandles[ xCoreID ] ) ); /*lint !e961 MISRA exception, justified as it is not a redundant explicit cast to all supported compilers. */
+			}
+			#endif /* configSUPPORT_STATIC_ALLOCATION */
+		}
+	}
+	#endif /* configNUM_CORES */
+
 	#if ( configUSE_TIMERS == 1 )
 	{
 		if( xReturn == pdPASS )
@@ -1992,6 +2334,19 @@ BaseType_t xReturn;
 	}
 	#endif /* configUSE_TIMERS */
 
+	#if ( configUSE_WORK_QUEUES == 1 )
+	{
+		if( xReturn == pdPASS )
+		{
+			xReturn = xWorkQueueCreateSystemWorkQueue();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_WORK_QUEUES */
+
 	if( xReturn == pdPASS )
 	{
 		/* freertos_tasks_c_additions_init() should only be called if the user
@@ -2022,6 +2377,19 @@ BaseType_t xReturn;
 		xSchedulerRunning = pdTRUE;
 		xTickCount = ( TickType_t ) configINITIAL_TICK_COUNT;
 
+		#if ( configNUM_CORES > 1 )
+		{
+		BaseType_t xCoreID;
+
+			/* Give each core the highest priority task it is able to run.  The
+			other cores are not running yet, so the locks are not required. */
+			for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUM_CORES; xCoreID++ )
+			{
+				prvSelectHighestPriorityTask( xCoreID );
+			}
+		}
+		#endif /* configNUM_CORES */
+
 		/* If configGENERATE_RUN_TIME_STATS is defined then the following
 		macro must be defined to configure the timer/counter used to generate
 		the run time counter time base.   NOTE:  If configGENERATE_RUN_TIME_STATS
@@ -2071,11 +2439,33 @@ void vTaskEndScheduler( void )
 
 void vTaskSuspendAll( void )
 {
-	/* A critical section is not required as the variable is of type
-	BaseType_t.  Please read Richard Barry's reply in the following link to a
-	post in the FreeRTOS support forum before reporting this as a bug! -
-	http://goo.gl/wu4acr */
-	++uxSchedulerSuspended;
+	#if ( configNUM_CORES == 1 )
+	{
+		/* A critical section is not required as the variable is of type
+		BaseType_t.  Please read Richard Barry's reply in the following link to a
+		post in the FreeRTOS support forum before reporting this as a bug! -
+		http://goo.gl/wu4acr */
+		++uxSchedulerSuspended;
+	}
+	#else
+	{
+	UBaseType_t uxSavedInterruptStatus;
+
+		/* With more than one core suspending the scheduler means holding the
+		task lock, which stops tasks on other cores entering the scheduler until
+		xTaskResumeAll() is called.  Interrupts are masked so the calling task
+		cannot move core while it takes the lock, and the count is updated under
+		the ISR lock as interrupts on other cores read it. */
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			portGET_TASK_LOCK();
+			portGET_ISR_LOCK();
+			++uxSchedulerSuspended;
+			portRELEASE_ISR_LOCK();
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	}
+	#endif /* configNUM_CORES */
 }
 /*----------------------------------------------------------*/
 
@@ -2160,6 +2550,14 @@ BaseType_t xAlreadyYielded = pdFALSE;
 	{
 		--uxSchedulerSuspended;
 
+		#if ( configNUM_CORES > 1 )
+		{
+			/* Release the task lock taken by vTaskSuspendAll().  The critical
+			section still holds it until taskEXIT_CRITICAL(). */
+			portRELEASE_TASK_LOCK();
+		}
+		#endif
+
 		if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 		{
 			if( uxCurrentNumberOfTasks > ( UBaseType_t ) 0U )
@@ -2175,7 +2573,7 @@ BaseType_t xAlreadyYielded = pdFALSE;
 
 					/* If the moved task has a priority higher than the current
 					task then a yield must be performed. */
-					if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+					if( taskYIELD_REQUIRED_FOR_TASK( pxTCB, pdTRUE ) != pdFALSE )
 					{
 						xYieldPending = pdTRUE;
 					}
@@ -2298,36 +2696,111 @@ UBaseType_t uxSavedInterruptStatus;
 }
 /*-----------------------------------------------------------*/
 
-UBaseType_t uxTaskGetNumberOfTasks( void )
+static void prvUpdateHighResolutionTime( const TickType_t xTicksElapsed )
 {
-	/* A critical section is not required because the variables are of type
-	BaseType_t. */
-	return uxCurrentNumberOfTasks;
-}
-/*-----------------------------------------------------------*/
+const UBaseType_t uxSequence = uxHighResolutionSequence;
+volatile const HighResolutionTime_t * const pxCurrent = &( xHighResolutionTimes[ uxSequence & ( UBaseType_t ) 1U ] );
+volatile HighResolutionTime_t * const pxNext = &( xHighResolutionTimes[ ( uxSequence + ( UBaseType_t ) 1U ) & ( UBaseType_t ) 1U ] );
 
-char *pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
-{
-TCB_t *pxTCB;
+	/* Only the tick writes the time, so the copy not in use can be written
+	without a critical section. */
+	#ifdef portGET_HIGH_RESOLUTION_COUNT
+	{
+	const uint32_t ulPortCount = portGET_HIGH_RESOLUTION_COUNT();
 
-	/* If null is passed in here then the name of the calling task is being
-	queried. */
-	pxTCB = prvGetTCBFromHandle( xTaskToQuery );
-	configASSERT( pxTCB );
-	return &( pxTCB->pcTaskName[ 0 ] );
+		( void ) xTicksElapsed;
+		pxNext->ullCount = pxCurrent->ullCount + ( uint64_t ) ( uint32_t ) ( ulPortCount - pxCurrent->ulPortCount );
+		pxNext->ulPortCount = ulPortCount;
+	}
+	#else
+	{
+		pxNext->ullCount = pxCurrent->ullCount + ( uint64_t ) xTicksElapsed;
+	}
+	#endif
+
+	/* Publish the new copy only after it has been written. */
+	portMEMORY_BARRIER();
+	uxHighResolutionSequence = uxSequence + ( UBaseType_t ) 1U;
 }
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_xTaskGetHandle == 1 )
+uint64_t ullTaskGetHighResolutionTime( void )
+{
+UBaseType_t uxSequence;
+uint64_t ullCount;
+const uint64_t ullCountsPerSecond = ( uint64_t ) portHIGH_RESOLUTION_COUNT_HZ;
+const uint64_t ullNanosecondsPerSecond = 1000000000ULL;
 
-	static TCB_t *prvSearchForNameWithinSingleList( List_t *pxList, const char pcNameToQuery[] )
+	do
 	{
-	TCB_t *pxNextTCB, *pxFirstTCB, *pxReturn = NULL;
-	UBaseType_t x;
-	char cNextChar;
-	BaseType_t xBreakLoop;
+		uxSequence = uxHighResolutionSequence;
+		portMEMORY_BARRIER();
 
-		/* This function is called with the scheduler suspended. */
+		ullCount = xHighResolutionTimes[ uxSequence & ( UBaseType_t ) 1U ].ullCount;
+
+		#ifdef portGET_HIGH_RESOLUTION_COUNT
+		{
+		const uint32_t ulPortCount = xHighResolutionTimes[ uxSequence & ( UBaseType_t ) 1U ].ulPortCount;
+
+			/* Read the port's count after the copy, so it cannot be older
+			than the count the copy was written at. */
+			portMEMORY_BARRIER();
+			ullCount += ( uint64_t ) ( uint32_t ) ( portGET_HIGH_RESOLUTION_COUNT() - ulPortCount );
+		}
+		#endif
+
+		/* If the tick published a new copy while the copy was being read
+		then the values read might be inconsistent, so read again. */
+		portMEMORY_BARRIER();
+	} while( uxSequence != uxHighResolutionSequence );
+
+	/* Convert to nanoseconds without overflowing.  The remainder is less than
+	ullCountsPerSecond, so multiplying it by a billion fits in 64 bits for any
+	count rate a 32-bit value can hold. */
+	if( ullCountsPerSecond != ullNanosecondsPerSecond )
+	{
+		ullCount = ( ( ullCount / ullCountsPerSecond ) * ullNanosecondsPerSecond ) +
+				   ( ( ( ullCount % ullCountsPerSecond ) * ullNanosecondsPerSecond ) / ullCountsPerSecond );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return ullCount;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTaskGetNumberOfTasks( void )
+{
+	/* A critical section is not required because the variables are of type
+	BaseType_t. */
+	return uxCurrentNumberOfTasks;
+}
+/*-----------------------------------------------------------*/
+
+char *pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+{
+TCB_t *pxTCB;
+
+	/* If null is passed in here then the name of the calling task is being
+	queried. */
+	pxTCB = prvGetTCBFromHandle( xTaskToQuery );
+	configASSERT( pxTCB );
+	return &( pxTCB->pcTaskName[ 0 ] );
+}
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_xTaskGetHandle == 1 )
+
+	static TCB_t *prvSearchForNameWithinSingleList( List_t *pxList, const char pcNameToQuery[] )
+	{
+	TCB_t *pxNextTCB, *pxFirstTCB, *pxReturn = NULL;
+	UBaseType_t x;
+	char cNextChar;
+	BaseType_t xBreakLoop;
+
+		/* This function is called with the scheduler suspended. */
 
 		if( listCURRENT_LIST_LENGTH( pxList ) > ( UBaseType_t ) 0 )
 		{
@@ -2534,6 +3007,25 @@ TCB_t *pxTCB;
 		configASSERT( ( xIdleTaskHandle != NULL ) );
 		return xIdleTaskHandle;
 	}
+/*-----------------------------------------------------------*/
+
+	TaskHandle_t xTaskGetIdleTaskHandleForCore( BaseType_t xCoreID )
+	{
+		configASSERT( ( xCoreID >= 0 ) && ( xCoreID < ( BaseType_t ) configNUM_CORES ) );
+
+		#if ( configNUM_CORES > 1 )
+		{
+			configASSERT( ( xIdleTaskHandles[ xCoreID ] != NULL ) );
+			return xIdleTaskHandles[ xCoreID ];
+		}
+		#else
+		{
+			( void ) xCoreID;
+			configASSERT( ( xIdleTaskHandle != NULL ) );
+			return xIdleTaskHandle;
+		}
+		#endif
+	}
 
 #endif /* INCLUDE_xTaskGetIdleTaskHandle */
 /*----------------------------------------------------------*/
@@ -2551,6 +3043,7 @@ implementations require configUSE_TICKLESS_IDLE to be set to a value other than
 		each stepped tick. */
 		configASSERT( ( xTickCount + xTicksToJump ) <= xNextTaskUnblockTime );
 		xTickCount += xTicksToJump;
+		prvUpdateHighResolutionTime( xTicksToJump );
 		traceINCREASE_TICK_COUNT( xTicksToJump );
 	}
 
@@ -2607,7 +3100,7 @@ implementations require configUSE_TICKLESS_IDLE to be set to a value other than
 					/* Preemption is on, but a context switch should only be
 					performed if the unblocked task has a priority that is
 					equal to or higher than the currently executing task. */
-					if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+					if( taskYIELD_REQUIRED_FOR_TASK( pxTCB, pdFALSE ) != pdFALSE )
 					{
 						/* Pend the yield to be performed when the scheduler
 						is unsuspended. */
@@ -2639,6 +3132,12 @@ TCB_t * pxTCB;
 TickType_t xItemValue;
 BaseType_t xSwitchRequired = pdFALSE;
 
+	#if ( configNUM_CORES > 1 )
+		/* The tick interrupt only occurs on one core, but the lists it updates
+		are shared with the other cores. */
+		UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+	#endif
+
 	/* Called by the portable layer each time a tick interrupt occurs.
 	Increments the tick then checks to see if the new tick value will cause any
 	tasks to be unblocked. */
@@ -2652,6 +3151,7 @@ BaseType_t xSwitchRequired = pdFALSE;
 		/* Increment the RTOS tick, switching the delayed and overflowed
 		delayed lists if it wraps to 0. */
 		xTickCount = xConstTickCount;
+		prvUpdateHighResolutionTime( ( TickType_t ) 1 );
 
 		if( xConstTickCount == ( TickType_t ) 0U ) /*lint !e774 'if' does not always evaluate to false as it is looking for an overflow. */
 		{
@@ -2730,7 +3230,7 @@ BaseType_t xSwitchRequired = pdFALSE;
 						only be performed if the unblocked task has a
 						priority that is equal to or higher than the
 						currently executing task. */
-						if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+						if( taskYIELD_REQUIRED_FOR_TASK( pxTCB, pdTRUE ) != pdFALSE )
 						{
 							xSwitchRequired = pdTRUE;
 						}
@@ -2747,7 +3247,7 @@ BaseType_t xSwitchRequired = pdFALSE;
 		/* Tasks of equal priority to the currently running task will share
 		processing time (time slice) if preemption is on, and the application
 		writer has not explicitly turned time slicing off. */
-		#if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+		#if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) && ( configNUM_CORES == 1 ) )
 		{
 			if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > ( UBaseType_t ) 1 )
 			{
@@ -2758,6 +3258,37 @@ BaseType_t xSwitchRequired = pdFALSE;
 				mtCOVERAGE_TEST_MARKER();
 			}
 		}
+		#elif ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+		{
+		BaseType_t xCoreID, xOtherCoreID;
+		UBaseType_t uxRunningAtPriority;
+
+			/* Each core is time sliced independently.  A core only needs to
+			switch if its ready list holds more tasks than there are cores
+			running tasks of that priority, otherwise there is no task waiting
+			for a time slice. */
+			for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUM_CORES; xCoreID++ )
+			{
+				uxRunningAtPriority = 0U;
+
+				for( xOtherCoreID = 0; xOtherCoreID < ( BaseType_t ) configNUM_CORES; xOtherCoreID++ )
+				{
+					if( pxCurrentTCBs[ xOtherCoreID ]->uxPriority == pxCurrentTCBs[ xCoreID ]->uxPriority )
+					{
+						uxRunningAtPriority++;
+					}
+				}
+
+				if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCBs[ xCoreID ]->uxPriority ] ) ) > uxRunningAtPriority )
+				{
+					prvYieldCore( xCoreID );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
 		#endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
 
 		#if ( configUSE_TICK_HOOK == 1 )
@@ -2801,6 +3332,10 @@ BaseType_t xSwitchRequired = pdFALSE;
 	}
 	#endif /* configUSE_PREEMPTION */
 
+	#if ( configNUM_CORES > 1 )
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+	#endif
+
 	return xSwitchRequired;
 }
 /*-----------------------------------------------------------*/
@@ -2865,6 +3400,43 @@ BaseType_t xSwitchRequired = pdFALSE;
 #endif /* configUSE_APPLICATION_TASK_TAG */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_HEAP_PROFILER == 1 )
+
+	UBaseType_t uxTaskSetHeapTag( UBaseType_t uxTag )
+	{
+	TCB_t *pxTCB;
+	UBaseType_t uxPreviousTag;
+
+		/* The tag can only be set by the task itself, and is only read by the
+		heap profiler when the task allocates memory, so no critical section is
+		required. */
+		pxTCB = prvGetTCBFromHandle( NULL );
+		configASSERT( pxTCB );
+		uxPreviousTag = pxTCB->uxHeapTag;
+		pxTCB->uxHeapTag = uxTag;
+
+		return uxPreviousTag;
+	}
+
+#endif /* configUSE_HEAP_PROFILER */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_HEAP_PROFILER == 1 )
+
+	UBaseType_t uxTaskGetHeapTag( TaskHandle_t xTask )
+	{
+	TCB_t *pxTCB;
+
+		/* If xTask is NULL then the calling task's tag is being queried. */
+		pxTCB = prvGetTCBFromHandle( xTask );
+		configASSERT( pxTCB );
+
+		return pxTCB->uxHeapTag;
+	}
+
+#endif /* configUSE_HEAP_PROFILER */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_APPLICATION_TASK_TAG == 1 )
 
 	BaseType_t xTaskCallApplicationTaskHook( TaskHandle_t xTask, void *pvParameter )
@@ -2899,6 +3471,17 @@ BaseType_t xSwitchRequired = pdFALSE;
 
 void vTaskSwitchContext( void )
 {
+	#if ( configNUM_CORES > 1 )
+	{
+		/* Called with interrupts masked from the context switch interrupt of
+		the calling core.  The task lock is taken first, as it is everywhere
+		else, so a core that has suspended the scheduler holds off context
+		switches on every core. */
+		portGET_TASK_LOCK();
+		portGET_ISR_LOCK();
+	}
+	#endif /* configNUM_CORES */
+
 	if( uxSchedulerSuspended != ( UBaseType_t ) pdFALSE )
 	{
 		/* The scheduler is currently suspended - do not allow a context
@@ -2949,7 +3532,15 @@ void vTaskSwitchContext( void )
 
 		/* Select a new task to run using either the generic C or port
 		optimised asm code. */
-		taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+		#if ( configNUM_CORES == 1 )
+		{
+			taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+		}
+		#else
+		{
+			prvSelectHighestPriorityTask( portGET_CORE_ID() );
+		}
+		#endif
 		traceTASK_SWITCHED_IN();
 
 		/* After the new task is switched in, update the global errno. */
@@ -2967,6 +3558,13 @@ void vTaskSwitchContext( void )
 		}
 		#endif /* configUSE_NEWLIB_REENTRANT */
 	}
+
+	#if ( configNUM_CORES > 1 )
+	{
+		portRELEASE_ISR_LOCK();
+		portRELEASE_TASK_LOCK();
+	}
+	#endif /* configNUM_CORES */
 }
 /*-----------------------------------------------------------*/
 
@@ -3078,7 +3676,7 @@ BaseType_t xReturn;
 		vListInsertEnd( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
 	}
 
-	if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	if( taskYIELD_REQUIRED_FOR_TASK( pxUnblockedTCB, pdFALSE ) != pdFALSE )
 	{
 		/* Return true if the task removed from the event list has a higher
 		priority than the calling task.  This allows the calling task to know if
@@ -3135,7 +3733,16 @@ TCB_t *pxUnblockedTCB;
 	( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
 	prvAddTaskToReadyList( pxUnblockedTCB );
 
-	if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	#if ( configNUM_CORES > 1 )
+	{
+		/* Other cores can still take interrupts that request context
+		switches, so the yield state is only updated from a critical
+		section. */
+		taskENTER_CRITICAL();
+	}
+	#endif
+
+	if( taskYIELD_REQUIRED_FOR_TASK( pxUnblockedTCB, pdFALSE ) != pdFALSE )
 	{
 		/* The unblocked task has a priority above that of the calling task, so
 		a context switch is required.  This function is called with the
@@ -3143,6 +3750,12 @@ TCB_t *pxUnblockedTCB;
 		occurs immediately that the scheduler is resumed (unsuspended). */
 		xYieldPending = pdTRUE;
 	}
+
+	#if ( configNUM_CORES > 1 )
+	{
+		taskEXIT_CRITICAL();
+	}
+	#endif
 }
 /*-----------------------------------------------------------*/
 
@@ -3321,10 +3934,11 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 			timeslice.
 
 			A critical region is not required here as we are just reading from
-			the list, and an occasional incorrect value will not matter.  If
-			the ready list at the idle priority contains more than one task
-			then a task other than the idle task is ready to execute. */
-			if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) 1 )
+			the list, and an occasional incorrect value will not matter.  There
+			is one idle task per core, so if the ready list at the idle priority
+			contains more tasks than there are cores then a task other than an
+			idle task is ready to execute. */
+			if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) configNUM_CORES )
 			{
 				taskYIELD();
 			}
@@ -3401,12 +4015,53 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configNUM_CORES > 1 )
+
+	static portTASK_FUNCTION( prvPassiveIdleTask, pvParameters )
+	{
+		/* Stop warnings. */
+		( void ) pvParameters;
+
+		/** THIS IS A PASSIVE IDLE TASK - ONE IS CREATED AUTOMATICALLY FOR EACH
+		CORE OTHER THAN CORE 0 WHEN THE SCHEDULER IS STARTED. **/
+
+		portTASK_CALLS_SECURE_FUNCTIONS();
+
+		for( ;; )
+		{
+			#if ( configUSE_PREEMPTION == 0 )
+			{
+				/* See the comments in prvIdleTask(). */
+				taskYIELD();
+			}
+			#endif /* configUSE_PREEMPTION */
+
+			#if ( ( configUSE_PREEMPTION == 1 ) && ( configIDLE_SHOULD_YIELD == 1 ) )
+			{
+				/* See the comments in prvIdleTask(). */
+				if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) configNUM_CORES )
+				{
+					taskYIELD();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configIDLE_SHOULD_YIELD == 1 ) ) */
+		}
+	}
+
+#endif /* configNUM_CORES */
+/*-----------------------------------------------------------*/
+
 #if( configUSE_TICKLESS_IDLE != 0 )
 
 	eSleepModeStatus eTaskConfirmSleepModeStatus( void )
 	{
-	/* The idle task exists in addition to the application tasks. */
-	const UBaseType_t uxNonApplicationTasks = 1;
+	/* The idle tasks, one per core, exist in addition to the application
+	tasks. */
+	const UBaseType_t uxNonApplicationTasks = ( UBaseType_t ) configNUM_CORES;
 	eSleepModeStatus eReturn = eStandardSleep;
 
 		if( listCURRENT_LIST_LENGTH( &xPendingReadyList ) != 0 )
@@ -3539,19 +4194,63 @@ static void prvCheckTasksWaitingTermination( void )
 
 		/* uxDeletedTasksWaitingCleanUp is used to prevent taskENTER_CRITICAL()
 		being called too often in the idle task. */
-		while( uxDeletedTasksWaitingCleanUp > ( UBaseType_t ) 0U )
+		#if ( configNUM_CORES == 1 )
 		{
-			taskENTER_CRITICAL();
+			while( uxDeletedTasksWaitingCleanUp > ( UBaseType_t ) 0U )
 			{
-				pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-				--uxCurrentNumberOfTasks;
-				--uxDeletedTasksWaitingCleanUp;
+				taskENTER_CRITICAL();
+				{
+					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					--uxCurrentNumberOfTasks;
+					--uxDeletedTasksWaitingCleanUp;
+				}
+				taskEXIT_CRITICAL();
+
+				prvDeleteTCB( pxTCB );
 			}
-			taskEXIT_CRITICAL();
+		}
+		#else /* configNUM_CORES */
+		{
+		const ListItem_t *pxIterator;
+		const ListItem_t *pxEndMarker = listGET_END_MARKER( &xTasksWaitingTermination );
+
+			while( uxDeletedTasksWaitingCleanUp > ( UBaseType_t ) 0U )
+			{
+				pxTCB = NULL;
 
-			prvDeleteTCB( pxTCB );
+				taskENTER_CRITICAL();
+				{
+					/* A task that was deleted while it was running stays on the
+					termination list until its core has switched to another
+					task, so only free tasks that are no longer running. */
+					for( pxIterator = listGET_HEAD_ENTRY( &xTasksWaitingTermination ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
+					{
+						if( taskTASK_IS_RUNNING( ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) ) == pdFALSE )
+						{
+							pxTCB = listGET_LIST_ITEM_OWNER( pxIterator ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+							( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+							--uxCurrentNumberOfTasks;
+							--uxDeletedTasksWaitingCleanUp;
+							break;
+						}
+					}
+				}
+				taskEXIT_CRITICAL();
+
+				if( pxTCB != NULL )
+				{
+					prvDeleteTCB( pxTCB );
+				}
+				else
+				{
+					/* The remaining deleted tasks are still running - try
+					again next time around the idle loop. */
+					break;
+				}
+			}
 		}
+		#endif /* configNUM_CORES */
 	}
 	#endif /* INCLUDE_vTaskDelete */
 }
@@ -3597,7 +4296,7 @@ static void prvCheckTasksWaitingTermination( void )
 		state is just set to whatever is passed in. */
 		if( eState != eInvalid )
 		{
-			if( pxTCB == pxCurrentTCB )
+			if( taskTASK_IS_RUNNING( pxTCB ) )
 			{
 				pxTaskStatus->eCurrentState = eRunning;
 			}
@@ -3814,21 +4513,55 @@ TCB_t *pxTCB;
 }
 /*-----------------------------------------------------------*/
 
-#if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) )
+#if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) || ( configNUM_CORES > 1 ) )
 
 	TaskHandle_t xTaskGetCurrentTaskHandle( void )
 	{
 	TaskHandle_t xReturn;
 
-		/* A critical section is not required as this is not called from
-		an interrupt and the current TCB will always be the same for any
-		individual execution thread. */
-		xReturn = pxCurrentTCB;
+		#if ( configNUM_CORES == 1 )
+		{
+			/* A critical section is not required as this is not called from
+			an interrupt and the current TCB will always be the same for any
+			individual execution thread. */
+			xReturn = pxCurrentTCB;
+		}
+		#else
+		{
+		UBaseType_t uxSavedInterruptStatus;
+
+			/* The calling task could be moved to another core between reading
+			the core ID and reading that core's current task, so interrupts
+			are masked. */
+			uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+			{
+				xReturn = pxCurrentTCBs[ portGET_CORE_ID() ];
+			}
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		}
+		#endif /* configNUM_CORES */
 
 		return xReturn;
 	}
+/*-----------------------------------------------------------*/
+
+	TaskHandle_t xTaskGetCurrentTaskHandleForCore( BaseType_t xCoreID )
+	{
+		configASSERT( ( xCoreID >= 0 ) && ( xCoreID < ( BaseType_t ) configNUM_CORES ) );
+
+		#if ( configNUM_CORES == 1 )
+		{
+			( void ) xCoreID;
+			return pxCurrentTCB;
+		}
+		#else
+		{
+			return pxCurrentTCBs[ xCoreID ];
+		}
+		#endif /* configNUM_CORES */
+	}
 
-#endif /* ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) ) */
+#endif /* ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) || ( configNUM_CORES > 1 ) ) */
 /*-----------------------------------------------------------*/
 
 #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
@@ -4108,6 +4841,26 @@ TCB_t *pxTCB;
 					{
 						mtCOVERAGE_TEST_MARKER();
 					}
+
+					#if ( configNUM_CORES > 1 )
+					{
+						/* The mutex holder may be running on another core at
+						the priority it has just lost, in which case that core
+						may now have a higher priority task to run. */
+						taskENTER_CRITICAL();
+						{
+							if( taskTASK_IS_RUNNING( pxTCB ) )
+							{
+								prvYieldCore( pxTCB->xTaskRunState );
+							}
+							else
+							{
+								mtCOVERAGE_TEST_MARKER();
+							}
+						}
+						taskEXIT_CRITICAL();
+					}
+					#endif /* configNUM_CORES */
 				}
 				else
 				{
@@ -4191,6 +4944,404 @@ TCB_t *pxTCB;
 #endif /* portCRITICAL_NESTING_IN_TCB */
 /*-----------------------------------------------------------*/
 
+#if ( configNUM_CORES > 1 )
+
+	void vTaskEnterCritical( void )
+	{
+		portDISABLE_INTERRUPTS();
+
+		if( xSchedulerRunning != pdFALSE )
+		{
+			/* Interrupts are disabled so the calling task cannot change core
+			from here on. */
+			const BaseType_t xCoreID = portGET_CORE_ID();
+
+			if( uxCriticalNestings[ xCoreID ] == 0U )
+			{
+				/* Always take the task lock before the ISR lock. */
+				portGET_TASK_LOCK();
+				portGET_ISR_LOCK();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			( uxCriticalNestings[ xCoreID ] )++;
+
+			/* This is not the interrupt safe version of the enter critical
+			function so	assert() if it is being called from an interrupt
+			context.  Only API functions that end in "FromISR" can be used in an
+			interrupt.  Only assert if the critical nesting count is 1 to
+			protect against recursive calls if the assert function also uses a
+			critical section. */
+			if( uxCriticalNestings[ xCoreID ] == 1U )
+			{
+				portASSERT_IF_IN_ISR();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+/*-----------------------------------------------------------*/
+
+	void vTaskExitCritical( void )
+	{
+		if( xSchedulerRunning != pdFALSE )
+		{
+			const BaseType_t xCoreID = portGET_CORE_ID();
+
+			if( uxCriticalNestings[ xCoreID ] > 0U )
+			{
+				( uxCriticalNestings[ xCoreID ] )--;
+
+				if( uxCriticalNestings[ xCoreID ] == 0U )
+				{
+					portRELEASE_ISR_LOCK();
+					portRELEASE_TASK_LOCK();
+					portENABLE_INTERRUPTS();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+/*-----------------------------------------------------------*/
+
+	UBaseType_t vTaskEnterCriticalFromISR( void )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+
+		if( xSchedulerRunning != pdFALSE )
+		{
+			const BaseType_t xCoreID = portGET_CORE_ID();
+
+			/* Interrupts only need to be serialised against each other and
+			against task level critical sections, both of which hold the ISR
+			lock. */
+			if( uxCriticalNestings[ xCoreID ] == 0U )
+			{
+				portGET_ISR_LOCK();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			( uxCriticalNestings[ xCoreID ] )++;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return uxSavedInterruptStatus;
+	}
+/*-----------------------------------------------------------*/
+
+	void vTaskExitCriticalFromISR( UBaseType_t uxSavedInterruptStatus )
+	{
+		if( xSchedulerRunning != pdFALSE )
+		{
+			const BaseType_t xCoreID = portGET_CORE_ID();
+
+			configASSERT( uxCriticalNestings[ xCoreID ] > 0U );
+
+			if( uxCriticalNestings[ xCoreID ] > 0U )
+			{
+				( uxCriticalNestings[ xCoreID ] )--;
+
+				if( uxCriticalNestings[ xCoreID ] == 0U )
+				{
+					portRELEASE_ISR_LOCK();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	}
+/*-----------------------------------------------------------*/
+
+	static void prvSelectHighestPriorityTask( const BaseType_t xCoreID )
+	{
+	UBaseType_t uxCurrentPriority = uxTopReadyPriority;
+	BaseType_t xTaskScheduled = pdFALSE, xTopPriorityFound = pdFALSE;
+	List_t *pxReadyList;
+	const ListItem_t *pxIterator, *pxEndMarker;
+	TCB_t *pxTCB;
+
+		/* The task this core was running, if any, can now be selected by
+		any core - including this one. */
+		if( pxCurrentTCBs[ xCoreID ] != NULL )
+		{
+			if( pxCurrentTCBs[ xCoreID ]->xTaskRunState == xCoreID )
+			{
+				pxCurrentTCBs[ xCoreID ]->xTaskRunState = taskTASK_NOT_RUNNING;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		while( xTaskScheduled == pdFALSE )
+		{
+			pxReadyList = &( pxReadyTasksLists[ uxCurrentPriority ] );
+
+			if( listLIST_IS_EMPTY( pxReadyList ) == pdFALSE )
+			{
+				/* Lists above this one are empty so uxTopReadyPriority can
+				be lowered to here, even if none of the tasks in this list
+				can run on this core. */
+				if( xTopPriorityFound == pdFALSE )
+				{
+					uxTopReadyPriority = uxCurrentPriority;
+					xTopPriorityFound = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Running tasks remain in their ready list, so search for the
+				first task that is not running elsewhere.  The list index is
+				not used to round robin, instead the selected task is moved to
+				the end of its list so the other tasks of equal priority are
+				found first next time.  The list index is never moved, so
+				vListInsertEnd() inserts at the true end of the list. */
+				pxEndMarker = listGET_END_MARKER( pxReadyList );
+
+				for( pxIterator = listGET_HEAD_ENTRY( pxReadyList ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
+				{
+					pxTCB = listGET_LIST_ITEM_OWNER( pxIterator ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+					if( ( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING ) && ( taskTASK_CAN_RUN_ON_CORE( pxTCB, xCoreID ) != pdFALSE ) )
+					{
+						pxTCB->xTaskRunState = xCoreID;
+						pxCurrentTCBs[ xCoreID ] = pxTCB;
+						xTaskScheduled = pdTRUE;
+
+						( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+						vListInsertEnd( pxReadyList, &( pxTCB->xStateListItem ) );
+						break;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( xTaskScheduled == pdFALSE )
+			{
+				/* There is one idle task per core, so a task must be found
+				before the idle priority has been passed. */
+				configASSERT( uxCurrentPriority > tskIDLE_PRIORITY );
+				--uxCurrentPriority;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+/*-----------------------------------------------------------*/
+
+	static void prvYieldCore( const BaseType_t xCoreID )
+	{
+		if( xCoreID == portGET_CORE_ID() )
+		{
+			xYieldPendings[ xCoreID ] = pdTRUE;
+		}
+		else if( xYieldPendings[ xCoreID ] == pdFALSE )
+		{
+			/* The request is latched so the same core is not interrupted
+			again before it has switched context. */
+			xYieldPendings[ xCoreID ] = pdTRUE;
+			portYIELD_CORE( xCoreID );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+/*-----------------------------------------------------------*/
+
+	static BaseType_t prvYieldForTask( const TCB_t * const pxTCB, const BaseType_t xPreemptEqualPriority )
+	{
+	UBaseType_t uxSavedInterruptStatus, uxPriorityToPreempt;
+	BaseType_t xReturn, xCount, xCoreID, xCoreToPreempt = taskTASK_NOT_RUNNING;
+
+		/* The ISR lock is enough to stop any core switching context, so this
+		can be called from both tasks and interrupts. */
+		uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+		{
+			const BaseType_t xThisCore = portGET_CORE_ID();
+
+			/* Only a ready task that is not already running can preempt
+			another task.  A task held in the pending ready list is considered
+			again when the scheduler is resumed. */
+			if( ( xSchedulerRunning != pdFALSE ) &&
+				( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING ) &&
+				( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE ) )
+			{
+				/* A core can be preempted if it is running a task of lower
+				priority (or of equal priority if xPreemptEqualPriority is
+				set).  Of those, preempt the core running the lowest priority
+				task.  The search starts at the calling core so it is preferred
+				when priorities are equal, as it does not need interrupting.
+				Cores that already have a yield pending are skipped as they
+				will select the highest priority ready task anyway. */
+				uxPriorityToPreempt = pxTCB->uxPriority;
+
+				if( xPreemptEqualPriority != pdFALSE )
+				{
+					uxPriorityToPreempt++;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				for( xCount = 0; xCount < ( BaseType_t ) configNUM_CORES; xCount++ )
+				{
+					xCoreID = ( xThisCore + xCount ) % ( BaseType_t ) configNUM_CORES;
+
+					if( ( xYieldPendings[ xCoreID ] == pdFALSE ) &&
+						( pxCurrentTCBs[ xCoreID ]->uxPriority < uxPriorityToPreempt ) &&
+						( taskTASK_CAN_RUN_ON_CORE( pxTCB, xCoreID ) != pdFALSE ) )
+					{
+						uxPriorityToPreempt = pxCurrentTCBs[ xCoreID ]->uxPriority;
+						xCoreToPreempt = xCoreID;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+
+				if( xCoreToPreempt != taskTASK_NOT_RUNNING )
+				{
+					prvYieldCore( xCoreToPreempt );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xReturn = xYieldPendings[ xThisCore ];
+		}
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+		return xReturn;
+	}
+/*-----------------------------------------------------------*/
+
+	#if ( configUSE_CORE_AFFINITY == 1 )
+
+		void vTaskCoreAffinitySet( const TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask )
+		{
+		TCB_t *pxTCB;
+
+			taskENTER_CRITICAL();
+			{
+				/* If null is passed in here then it is the affinity of the
+				calling task that is being changed. */
+				pxTCB = prvGetTCBFromHandle( xTask );
+				pxTCB->uxCoreAffinityMask = uxCoreAffinityMask;
+
+				if( taskTASK_IS_RUNNING( pxTCB ) )
+				{
+					/* The core running the task must switch away from it if
+					the task is no longer allowed to run there. */
+					if( taskTASK_CAN_RUN_ON_CORE( pxTCB, pxTCB->xTaskRunState ) == pdFALSE )
+					{
+						prvYieldCore( pxTCB->xTaskRunState );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					/* The task may now be able to preempt a task on a core it
+					was not previously allowed to run on. */
+					( void ) prvYieldForTask( pxTCB, pdFALSE );
+				}
+
+				if( xYieldPendings[ portGET_CORE_ID() ] != pdFALSE )
+				{
+					taskYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+		}
+/*-----------------------------------------------------------*/
+
+		UBaseType_t uxTaskCoreAffinityGet( const TaskHandle_t xTask )
+		{
+		const TCB_t *pxTCB;
+		UBaseType_t uxReturn;
+
+			taskENTER_CRITICAL();
+			{
+				pxTCB = prvGetTCBFromHandle( xTask );
+				uxReturn = pxTCB->uxCoreAffinityMask;
+			}
+			taskEXIT_CRITICAL();
+
+			return uxReturn;
+		}
+
+	#endif /* configUSE_CORE_AFFINITY */
+
+#endif /* configNUM_CORES */
+/*-----------------------------------------------------------*/
+
 #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
 
 	static char *prvWriteNameToBuffer( char *pcBuffer, const char *pcTaskName )
@@ -4712,7 +5863,7 @@ TickType_t uxReturn;
 				}
 				#endif
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskYIELD_REQUIRED_FOR_TASK( pxTCB, pdFALSE ) != pdFALSE )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
@@ -4767,7 +5918,7 @@ TickType_t uxReturn;
 
 		pxTCB = xTaskToNotify;
 
-		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 		{
 			if( pulPreviousNotificationValue != NULL )
 			{
@@ -4837,7 +5988,7 @@ TickType_t uxReturn;
 					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
 				}
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskYIELD_REQUIRED_FOR_TASK( pxTCB, pdFALSE ) != pdFALSE )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
@@ -4857,7 +6008,7 @@ TickType_t uxReturn;
 				}
 			}
 		}
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
 		return xReturn;
 	}
@@ -4895,7 +6046,7 @@ TickType_t uxReturn;
 
 		pxTCB = xTaskToNotify;
 
-		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
 		{
 			ucOriginalNotifyState = pxTCB->ucNotifyState;
 			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
@@ -4925,7 +6076,7 @@ TickType_t uxReturn;
 					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
 				}
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskYIELD_REQUIRED_FOR_TASK( pxTCB, pdFALSE ) != pdFALSE )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
@@ -4945,7 +6096,7 @@ TickType_t uxReturn;
 				}
 			}
 		}
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 	}
 
 #endif /* configUSE_TASK_NOTIFICATIONS */
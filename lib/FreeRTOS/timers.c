@@ -38,6 +38,10 @@ task.h is included from an application file. */
 #include "queue.h"
 #include "timers.h"
 
+#if( configPEND_FUNCTION_CALL_USE_WORK_QUEUE == 1 )
+	#include "work_queue.h"
+#endif
+
 #if ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 0 )
 	#error configUSE_TIMERS must be set to 1 to make the xTimerPendFunctionCall() function available.
 #endif
@@ -1005,7 +1009,7 @@ Timer_t * const pxTimer = xTimer;
 }
 /*-----------------------------------------------------------*/
 
-#if( INCLUDE_xTimerPendFunctionCall == 1 )
+#if( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configPEND_FUNCTION_CALL_USE_WORK_QUEUE == 0 ) )
 
 	BaseType_t xTimerPendFunctionCallFromISR( PendedFunction_t xFunctionToPend, void *pvParameter1, uint32_t ulParameter2, BaseType_t *pxHigherPriorityTaskWoken )
 	{
@@ -1029,7 +1033,7 @@ Timer_t * const pxTimer = xTimer;
 #endif /* INCLUDE_xTimerPendFunctionCall */
 /*-----------------------------------------------------------*/
 
-#if( INCLUDE_xTimerPendFunctionCall == 1 )
+#if( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configPEND_FUNCTION_CALL_USE_WORK_QUEUE == 0 ) )
 
 	BaseType_t xTimerPendFunctionCall( PendedFunction_t xFunctionToPend, void *pvParameter1, uint32_t ulParameter2, TickType_t xTicksToWait )
 	{
@@ -1058,6 +1062,38 @@ Timer_t * const pxTimer = xTimer;
 #endif /* INCLUDE_xTimerPendFunctionCall */
 /*-----------------------------------------------------------*/
 
+#if( ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configPEND_FUNCTION_CALL_USE_WORK_QUEUE == 1 ) )
+
+	/* Pended function calls are run by the system work queue, at its highest
+	priority level, instead of by the daemon task.  A slow pended function then
+	delays neither timer callbacks nor other pended functions while another
+	worker is free. */
+	BaseType_t xTimerPendFunctionCallFromISR( PendedFunction_t xFunctionToPend, void *pvParameter1, uint32_t ulParameter2, BaseType_t *pxHigherPriorityTaskWoken )
+	{
+	BaseType_t xReturn;
+
+		xReturn = xWorkQueuePendFunctionCallFromISR( NULL, xFunctionToPend, pvParameter1, ulParameter2, ( UBaseType_t ) ( configWORK_QUEUE_PRIORITY_LEVELS - 1 ), pxHigherPriorityTaskWoken );
+
+		tracePEND_FUNC_CALL_FROM_ISR( xFunctionToPend, pvParameter1, ulParameter2, xReturn );
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xTimerPendFunctionCall( PendedFunction_t xFunctionToPend, void *pvParameter1, uint32_t ulParameter2, TickType_t xTicksToWait )
+	{
+	BaseType_t xReturn;
+
+		xReturn = xWorkQueuePendFunctionCall( NULL, xFunctionToPend, pvParameter1, ulParameter2, ( UBaseType_t ) ( configWORK_QUEUE_PRIORITY_LEVELS - 1 ), xTicksToWait );
+
+		tracePEND_FUNC_CALL( xFunctionToPend, pvParameter1, ulParameter2, xReturn );
+
+		return xReturn;
+	}
+
+#endif /* INCLUDE_xTimerPendFunctionCall */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_TRACE_FACILITY == 1 )
 
 	UBaseType_t uxTimerGetTimerNumber( TimerHandle_t xTimer )
@@ -0,0 +1,211 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes.  FreeRTOS.h includes trace_ring.h when the trace ring is
+used. */
+#include "FreeRTOS.h"
+
+/* This entire source file will be skipped if the application is not configured
+to include the trace ring.  This #if is closed at the very bottom of this
+file. */
+#if ( configUSE_TRACE_RING == 1 )
+
+#if( ( configTRACE_RING_EVENTS & ( configTRACE_RING_EVENTS - 1 ) ) != 0 )
+	#error configTRACE_RING_EVENTS must be a power of 2
+#endif
+
+/* Masks the count of events recorded on a core to the index in the core's
+buffer of the next event. */
+#define trEVENT_INDEX_MASK		( ( uint32_t ) ( configTRACE_RING_EVENTS - 1 ) )
+
+/*-----------------------------------------------------------*/
+
+/* The events recorded on one core.  Event ulEventCount is the next to be
+written, so the buffer holds events ulEventCount - configTRACE_RING_EVENTS to
+ulEventCount - 1, or 0 to ulEventCount - 1 if fewer events have been recorded. */
+typedef struct xTRACE_RING_CORE
+{
+	volatile uint32_t ulEventCount;
+	uint32_t ulReserved;
+	TraceRingEvent_t xEvents[ configTRACE_RING_EVENTS ];
+} TraceRingCore_t;
+
+/* The trace data, in the layout read by tools/kernel_trace/trace_decode.py.
+Every member is a multiple of four bytes long, so there is no padding. */
+typedef struct xTRACE_RING_DATA
+{
+	uint32_t ulMagic;							/* trTRACE_RING_MAGIC. */
+	uint16_t usVersion;							/* trTRACE_RING_VERSION. */
+	uint16_t usEventSize;						/* sizeof( TraceRingEvent_t ). */
+	uint16_t usCoreCount;						/* configNUM_CORES. */
+	uint16_t usTaskNameLength;					/* trTASK_NAME_LENGTH. */
+	uint32_t ulEventsPerCore;					/* configTRACE_RING_EVENTS. */
+	uint32_t ulTimestampHz;						/* configTRACE_RING_TIMESTAMP_HZ. */
+	uint32_t ulStopTimestamp;					/* The timestamp when recording stopped, if ulRecording is 0. */
+	volatile uint32_t ulRecording;				/* 1 while events are being recorded, otherwise 0. */
+	uint32_t ulTaskNameSlots;					/* configTRACE_RING_TASK_NAMES. */
+	uint32_t ulTaskNamesRecorded;				/* The number of task names recorded.  Once the slots are full the oldest name is overwritten. */
+	TraceRingTaskName_t xTaskNames[ configTRACE_RING_TASK_NAMES ];
+	TraceRingCore_t xCores[ configNUM_CORES ];
+} TraceRingData_t;
+
+/*-----------------------------------------------------------*/
+
+/* The trace data.  The header fields are written when the data is read, so the
+whole structure can be zero initialised, and recording is enabled separately so
+events are recorded from the first. */
+PRIVILEGED_DATA static TraceRingData_t xTraceData;
+PRIVILEGED_DATA static volatile BaseType_t xRecording = pdTRUE;
+
+/*-----------------------------------------------------------*/
+
+void vTraceRingEvent( uint8_t ucEvent, uint32_t ulArg1, uint32_t ulArg2 )
+{
+UBaseType_t uxSavedInterruptStatus;
+TraceRingCore_t *pxCore;
+TraceRingEvent_t *pxEvent;
+
+	/* Only this core writes to its buffer, and with interrupts masked nothing
+	else can run on this core until the event is complete. */
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		if( xRecording != pdFALSE )
+		{
+			pxCore = &( xTraceData.xCores[ portGET_CORE_ID() ] );
+			pxEvent = &( pxCore->xEvents[ pxCore->ulEventCount & trEVENT_INDEX_MASK ] );
+
+			pxEvent->ulTimestamp = ( uint32_t ) configTRACE_RING_TIMESTAMP();
+			pxEvent->ucEvent = ucEvent;
+			pxEvent->ulArg1 = ulArg1;
+			pxEvent->ulArg2 = ulArg2;
+
+			pxCore->ulEventCount++;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+void vTraceRingTaskCreate( UBaseType_t uxTask, const char *pcName, UBaseType_t uxPriority )
+{
+TraceRingTaskName_t *pxTaskName;
+
+	/* Called from a critical section, so tasks created on different cores do
+	not use the same slot. */
+	pxTaskName = &( xTraceData.xTaskNames[ xTraceData.ulTaskNamesRecorded % ( uint32_t ) configTRACE_RING_TASK_NAMES ] );
+	pxTaskName->ulTask = ( uint32_t ) uxTask;
+	( void ) strncpy( pxTaskName->cName, pcName, sizeof( pxTaskName->cName ) );
+	xTraceData.ulTaskNamesRecorded++;
+
+	vTraceRingEvent( trEVENT_TASK_CREATE, ( uint32_t ) uxTask, ( uint32_t ) uxPriority );
+}
+/*-----------------------------------------------------------*/
+
+void vTraceRingUserEvent( uint32_t ulId, uint32_t ulValue )
+{
+	vTraceRingEvent( trEVENT_USER, ulId, ulValue );
+}
+/*-----------------------------------------------------------*/
+
+void vTraceRingStop( void )
+{
+UBaseType_t uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		xRecording = pdFALSE;
+		xTraceData.ulStopTimestamp = ( uint32_t ) configTRACE_RING_TIMESTAMP();
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+void vTraceRingStart( BaseType_t xClear )
+{
+BaseType_t xCore;
+
+	if( xClear != pdFALSE )
+	{
+		for( xCore = 0; xCore < ( BaseType_t ) configNUM_CORES; xCore++ )
+		{
+			xTraceData.xCores[ xCore ].ulEventCount = 0UL;
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	xRecording = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulTraceRingGetEventCount( void )
+{
+uint32_t ulCount = 0UL;
+BaseType_t xCore;
+
+	for( xCore = 0; xCore < ( BaseType_t ) configNUM_CORES; xCore++ )
+	{
+		ulCount += xTraceData.xCores[ xCore ].ulEventCount;
+	}
+
+	return ulCount;
+}
+/*-----------------------------------------------------------*/
+
+const void *pvTraceRingGetData( size_t *pxSize )
+{
+	configASSERT( pxSize );
+
+	xTraceData.ulMagic = trTRACE_RING_MAGIC;
+	xTraceData.usVersion = ( uint16_t ) trTRACE_RING_VERSION;
+	xTraceData.usEventSize = ( uint16_t ) sizeof( TraceRingEvent_t );
+	xTraceData.usCoreCount = ( uint16_t ) configNUM_CORES;
+	xTraceData.usTaskNameLength = ( uint16_t ) trTASK_NAME_LENGTH;
+	xTraceData.ulEventsPerCore = ( uint32_t ) configTRACE_RING_EVENTS;
+	xTraceData.ulTimestampHz = ( uint32_t ) configTRACE_RING_TIMESTAMP_HZ;
+	xTraceData.ulTaskNameSlots = ( uint32_t ) configTRACE_RING_TASK_NAMES;
+	xTraceData.ulRecording = ( xRecording != pdFALSE ) ? 1UL : 0UL;
+
+	*pxSize = sizeof( xTraceData );
+
+	return ( const void * ) &xTraceData;
+}
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+to include the trace ring.  This #if is closed at the very bottom of this
+file. */
+#endif /* configUSE_TRACE_RING == 1 */
@@ -0,0 +1,1041 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mem_pool.h"
+#include "work_queue.h"
+
+/* Lint e961, e9021 and e750 are suppressed as a MISRA exception justified
+because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+for the header files above, but not in this file, in order to generate the
+correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/* This entire source file will be skipped if the application is not configured
+to include work queues.  This #if is closed at the very bottom of this file. */
+#if ( configUSE_WORK_QUEUES == 1 )
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION != 1 )
+	#error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to use work queues
+#endif
+
+#if( configUSE_TASK_NOTIFICATIONS != 1 )
+	#error configUSE_TASK_NOTIFICATIONS must be set to 1 to use work queues
+#endif
+
+#if( configWORK_QUEUE_PRIORITY_LEVELS < 1 )
+	#error configWORK_QUEUE_PRIORITY_LEVELS must be at least 1
+#endif
+
+#if( ( configWORK_QUEUE_BATCH_SIZE < 1 ) || ( configWORK_QUEUE_HISTOGRAM_BUCKETS < 1 ) || ( configWORK_QUEUE_PEND_CALL_ITEMS < 1 ) )
+	#error configWORK_QUEUE_BATCH_SIZE, configWORK_QUEUE_HISTOGRAM_BUCKETS and configWORK_QUEUE_PEND_CALL_ITEMS must be at least 1
+#endif
+
+/*
+ * Each work queue holds a list of ready items for each priority level, and two
+ * lists of items waiting for their delay to expire, ordered by the tick count
+ * at which they expire.  As with the timer lists in timers.c, one delayed list
+ * holds items that expire before the tick count next overflows, and the other
+ * items that expire after it overflows.
+ *
+ * Idle workers are held on a stack, so the most recently active worker, whose
+ * stack is most likely to still be in cache, is the first to be woken.  At most
+ * one idle worker - the timekeeper - waits with a timeout, which expires when
+ * the first delayed item is due.  When a worker wakes it moves any expired
+ * delayed items to the ready lists, then takes a batch of ready items.  If
+ * ready items remain after it has taken its batch it wakes another idle worker
+ * to take them, so the workers wake one after another as needed rather than
+ * all at once.  All the work queue state is accessed inside critical sections,
+ * so items can be submitted from interrupts.
+ */
+
+/* Bits stored in the ucState field of a work item. */
+#define wqSTATE_RUNNING			( ( uint8_t ) 0x01 ) /* Set while a worker owns the item. */
+#define wqSTATE_RESUBMIT		( ( uint8_t ) 0x02 ) /* Set if the item was submitted while running. */
+#define wqSTATE_FROM_POOL		( ( uint8_t ) 0x04 ) /* Set if the item belongs to the pool used by xWorkQueuePendFunctionCall(). */
+
+/*-----------------------------------------------------------*/
+
+/* Structure that hold state information on the work queue. */
+typedef struct WorkQueueDef_t /*lint !e9058 Style convention uses tag. */
+{
+	List_t xReadyLists[ configWORK_QUEUE_PRIORITY_LEVELS ];	/* Items ready to run, one list per priority level. */
+	List_t xDelayedList1;									/* Items waiting for their delay to expire. */
+	List_t xDelayedList2;									/* Items waiting for their delay to expire, after the tick count overflows. */
+	List_t *pxDelayedList;									/* Points to whichever delayed list holds items that expire before the tick count overflows. */
+	List_t *pxOverflowDelayedList;							/* Points to the other delayed list. */
+	TickType_t xLastTickCount;								/* The tick count when the delayed lists were last checked, used to detect the tick count overflowing. */
+	UBaseType_t uxItemsReady;								/* The number of items in the ready lists. */
+	TaskHandle_t *pxIdleWorkers;							/* Stack of idle workers, uxWorkerCount entries long. */
+	UBaseType_t uxIdleWorkerCount;							/* The number of workers on the stack. */
+	UBaseType_t uxWorkerCount;								/* The number of workers. */
+	TaskHandle_t xTimekeeper;								/* The idle worker waiting for the first delayed item to expire, if any. */
+	BaseType_t xWakePending;								/* pdTRUE if a worker has been woken to take ready items but has not yet done so. */
+	MemPoolHandle_t xPendCallPool;							/* Work items used by xWorkQueuePendFunctionCall(). */
+	WorkQueueStats_t xStats;
+} WorkQueue_t;
+
+/* The work queue used when NULL is passed as a work queue handle. */
+PRIVILEGED_DATA static WorkQueue_t *pxSystemWorkQueue = NULL;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The function run by each worker task.
+ */
+static void prvWorkerTask( void *pvParameters ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the work queue referenced by xWorkQueue, which is the system work
+ * queue if xWorkQueue is NULL.
+ */
+static WorkQueue_t *prvGetWorkQueue( WorkQueueHandle_t xWorkQueue ) PRIVILEGED_FUNCTION;
+
+/*
+ * Common implementation of the submit functions.  Returns the idle worker to
+ * wake, if any, in *pxWorkerToWake.  xDelay is only non-zero when called from a
+ * task.
+ */
+static BaseType_t prvSubmit( WorkQueue_t * const pxWorkQueue,
+							 WorkItem_t * const pxWorkItem,
+							 UBaseType_t uxPriority,
+							 TickType_t xDelay,
+							 BaseType_t xFromISR,
+							 TaskHandle_t * const pxWorkerToWake ) PRIVILEGED_FUNCTION;
+
+/*
+ * Adds an item to the end of the ready list for its priority level.  Must be
+ * called from within a critical section.
+ */
+static void prvAddReadyItem( WorkQueue_t * const pxWorkQueue,
+							 WorkItem_t * const pxWorkItem,
+							 uint32_t ulReadyTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns an idle worker to wake to take ready items if there are ready items,
+ * an idle worker, and no worker already on its way to take them, otherwise
+ * NULL.  Must be called from within a critical section.
+ */
+static TaskHandle_t prvSelectWorkerToWake( WorkQueue_t * const pxWorkQueue ) PRIVILEGED_FUNCTION;
+
+/*
+ * Moves delayed items that have expired by xTickCount to the ready lists,
+ * switching the delayed lists if the tick count has overflowed.  Must be called
+ * from within a critical section.
+ */
+static void prvProcessDelayedItems( WorkQueue_t * const pxWorkQueue,
+									TickType_t xTickCount,
+									uint32_t ulReadyTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes up to configWORK_QUEUE_BATCH_SIZE items from the ready lists, highest
+ * priority level first, into pxBatch, and returns the number removed.  Must be
+ * called from within a critical section.
+ */
+static UBaseType_t prvTakeBatch( WorkQueue_t * const pxWorkQueue,
+								 WorkItem_t *pxBatch[] ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by a worker after running an item, with the time the item waited to
+ * start running.  Returns pdTRUE if the item must be returned to the pool used
+ * by xWorkQueuePendFunctionCall().
+ */
+static BaseType_t prvFinishItem( WorkQueue_t * const pxWorkQueue,
+								 WorkItem_t * const pxWorkItem,
+								 uint32_t ulLatency ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes xWorker from the idle stack if it is on it.  Must be called from
+ * within a critical section.
+ */
+static void prvRemoveIdleWorker( WorkQueue_t * const pxWorkQueue,
+								 TaskHandle_t xWorker ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkQueueCreateSystemWorkQueue( void )
+{
+BaseType_t xReturn = pdFAIL;
+
+	/* Called from vTaskStartScheduler(), before any other task can use the
+	system work queue. */
+	if( pxSystemWorkQueue == NULL )
+	{
+		pxSystemWorkQueue = xWorkQueueCreate( "WorkQ",
+											  configSYSTEM_WORK_QUEUE_WORKERS,
+											  configSYSTEM_WORK_QUEUE_PRIORITY,
+											  configSYSTEM_WORK_QUEUE_STACK_DEPTH );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxSystemWorkQueue != NULL )
+	{
+		xReturn = pdPASS;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	configASSERT( xReturn );
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+WorkQueueHandle_t xWorkQueueCreate( const char * const pcName,
+									UBaseType_t uxWorkerCount,
+									UBaseType_t uxWorkerPriority,
+									const configSTACK_DEPTH_TYPE usStackDepth )
+{
+WorkQueue_t *pxWorkQueue;
+UBaseType_t uxLevel, uxWorker;
+BaseType_t xResult = pdPASS;
+
+	configASSERT( uxWorkerCount > ( UBaseType_t ) 0 );
+	configASSERT( uxWorkerPriority < ( UBaseType_t ) configMAX_PRIORITIES );
+
+	/* The structure and the idle worker stack are allocated in one go.  The
+	size of the structure is a multiple of the alignment of a pointer, so the
+	stack that follows it is aligned too. */
+	pxWorkQueue = ( WorkQueue_t * ) pvPortMalloc( sizeof( WorkQueue_t ) + ( ( size_t ) uxWorkerCount * sizeof( TaskHandle_t ) ) ); /*lint !e9087 !e9079 malloc() only returns void*. */
+
+	if( pxWorkQueue != NULL )
+	{
+		( void ) memset( ( void * ) pxWorkQueue, 0x00, sizeof( WorkQueue_t ) ); /*lint !e9087 memset() requires void *. */
+
+		for( uxLevel = ( UBaseType_t ) 0; uxLevel < ( UBaseType_t ) configWORK_QUEUE_PRIORITY_LEVELS; uxLevel++ )
+		{
+			vListInitialise( &( pxWorkQueue->xReadyLists[ uxLevel ] ) );
+		}
+
+		vListInitialise( &( pxWorkQueue->xDelayedList1 ) );
+		vListInitialise( &( pxWorkQueue->xDelayedList2 ) );
+		pxWorkQueue->pxDelayedList = &( pxWorkQueue->xDelayedList1 );
+		pxWorkQueue->pxOverflowDelayedList = &( pxWorkQueue->xDelayedList2 );
+		pxWorkQueue->xLastTickCount = xTaskGetTickCount();
+		pxWorkQueue->pxIdleWorkers = ( TaskHandle_t * ) &( pxWorkQueue[ 1 ] ); /*lint !e9087 !e9016 Stack follows the structure. */
+		pxWorkQueue->uxWorkerCount = uxWorkerCount;
+
+		pxWorkQueue->xPendCallPool = xMemPoolCreate( configWORK_QUEUE_PEND_CALL_ITEMS, sizeof( WorkItem_t ) );
+
+		if( pxWorkQueue->xPendCallPool != NULL )
+		{
+			/* Prevent the workers running until they have all been created, so
+			they can be deleted again if there is not enough memory for all of
+			them.  Until then the idle stack holds the handles of the workers
+			created so far. */
+			vTaskSuspendAll();
+			{
+				for( uxWorker = ( UBaseType_t ) 0; uxWorker < uxWorkerCount; uxWorker++ )
+				{
+					xResult = xTaskCreate( prvWorkerTask,
+										   pcName,
+										   usStackDepth,
+										   ( void * ) pxWorkQueue,
+										   uxWorkerPriority,
+										   &( pxWorkQueue->pxIdleWorkers[ uxWorker ] ) );
+
+					if( xResult != pdPASS )
+					{
+						break;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+
+				if( xResult != pdPASS )
+				{
+					#if( INCLUDE_vTaskDelete == 1 )
+					{
+						while( uxWorker > ( UBaseType_t ) 0 )
+						{
+							uxWorker--;
+							vTaskDelete( pxWorkQueue->pxIdleWorkers[ uxWorker ] );
+						}
+
+						vMemPoolDelete( pxWorkQueue->xPendCallPool );
+						vPortFree( ( void * ) pxWorkQueue );
+					}
+					#else
+					{
+						/* The workers that were created cannot be deleted, and
+						will run once the scheduler is resumed, so the work
+						queue is left allocated for them to use. */
+						pxWorkQueue->uxWorkerCount = uxWorker;
+					}
+					#endif
+
+					pxWorkQueue = NULL;
+				}
+				else
+				{
+					/* The workers add themselves to the idle stack when they
+					first run. */
+					traceWORK_QUEUE_CREATE( pxWorkQueue );
+				}
+			}
+			( void ) xTaskResumeAll();
+		}
+		else
+		{
+			vPortFree( ( void * ) pxWorkQueue );
+			pxWorkQueue = NULL;
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( pxWorkQueue == NULL )
+	{
+		traceWORK_QUEUE_CREATE_FAILED();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return ( WorkQueueHandle_t ) pxWorkQueue;
+}
+/*-----------------------------------------------------------*/
+
+void vWorkItemInit( WorkItem_t *pxWorkItem,
+					WorkFunction_t pxFunction,
+					void *pvParameter1,
+					uint32_t ulParameter2 )
+{
+	configASSERT( pxWorkItem );
+	configASSERT( pxFunction );
+
+	vListInitialiseItem( &( pxWorkItem->xListItem ) );
+	listSET_LIST_ITEM_OWNER( &( pxWorkItem->xListItem ), pxWorkItem );
+	pxWorkItem->pxFunction = pxFunction;
+	pxWorkItem->pvParameter1 = pvParameter1;
+	pxWorkItem->ulParameter2 = ulParameter2;
+	pxWorkItem->pxWorkQueue = NULL;
+	pxWorkItem->ulReadyTime = 0UL;
+	pxWorkItem->uxPriority = ( UBaseType_t ) 0;
+	pxWorkItem->ucState = ( uint8_t ) 0;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkQueueSubmit( WorkQueueHandle_t xWorkQueue,
+							 WorkItem_t *pxWorkItem,
+							 UBaseType_t uxPriority )
+{
+TaskHandle_t xWorkerToWake = NULL;
+BaseType_t xReturn;
+
+	xReturn = prvSubmit( prvGetWorkQueue( xWorkQueue ), pxWorkItem, uxPriority, ( TickType_t ) 0, pdFALSE, &xWorkerToWake );
+
+	if( xWorkerToWake != NULL )
+	{
+		( void ) xTaskNotifyGive( xWorkerToWake );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkQueueSubmitFromISR( WorkQueueHandle_t xWorkQueue,
+									WorkItem_t *pxWorkItem,
+									UBaseType_t uxPriority,
+									BaseType_t * const pxHigherPriorityTaskWoken )
+{
+TaskHandle_t xWorkerToWake = NULL;
+BaseType_t xReturn;
+
+	xReturn = prvSubmit( prvGetWorkQueue( xWorkQueue ), pxWorkItem, uxPriority, ( TickType_t ) 0, pdTRUE, &xWorkerToWake );
+
+	if( xWorkerToWake != NULL )
+	{
+		vTaskNotifyGiveFromISR( xWorkerToWake, pxHigherPriorityTaskWoken );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkQueueSubmitDelayed( WorkQueueHandle_t xWorkQueue,
+									WorkItem_t *pxWorkItem,
+									UBaseType_t uxPriority,
+									TickType_t xDelay )
+{
+TaskHandle_t xWorkerToWake = NULL;
+BaseType_t xReturn;
+
+	configASSERT( xDelay < portMAX_DELAY );
+
+	xReturn = prvSubmit( prvGetWorkQueue( xWorkQueue ), pxWorkItem, uxPriority, xDelay, pdFALSE, &xWorkerToWake );
+
+	if( xWorkerToWake != NULL )
+	{
+		( void ) xTaskNotifyGive( xWorkerToWake );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkItemCancel( WorkItem_t *pxWorkItem )
+{
+WorkQueue_t *pxWorkQueue;
+List_t *pxContainer;
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( pxWorkItem );
+
+	taskENTER_CRITICAL();
+	{
+		pxWorkQueue = pxWorkItem->pxWorkQueue;
+		pxContainer = ( List_t * ) listLIST_ITEM_CONTAINER( &( pxWorkItem->xListItem ) );
+
+		if( ( pxWorkItem->ucState & wqSTATE_RUNNING ) != ( uint8_t ) 0 )
+		{
+			/* Too late to stop the item running, but it need not run again. */
+			pxWorkItem->ucState &= ( uint8_t ) ~wqSTATE_RESUBMIT;
+		}
+		else if( pxContainer != NULL )
+		{
+			( void ) uxListRemove( &( pxWorkItem->xListItem ) );
+
+			if( ( pxContainer != pxWorkQueue->pxDelayedList ) && ( pxContainer != pxWorkQueue->pxOverflowDelayedList ) )
+			{
+				pxWorkQueue->uxItemsReady--;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxWorkQueue->xStats.uxCancelled++;
+			xReturn = pdPASS;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkItemIsBusy( WorkItem_t *pxWorkItem )
+{
+BaseType_t xReturn;
+
+	configASSERT( pxWorkItem );
+
+	taskENTER_CRITICAL();
+	{
+		if( ( listLIST_ITEM_CONTAINER( &( pxWorkItem->xListItem ) ) != NULL ) ||
+			( ( pxWorkItem->ucState & wqSTATE_RUNNING ) != ( uint8_t ) 0 ) )
+		{
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			xReturn = pdFALSE;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkQueuePendFunctionCall( WorkQueueHandle_t xWorkQueue,
+									   WorkFunction_t xFunctionToPend,
+									   void *pvParameter1,
+									   uint32_t ulParameter2,
+									   UBaseType_t uxPriority,
+									   TickType_t xTicksToWait )
+{
+WorkQueue_t * const pxWorkQueue = prvGetWorkQueue( xWorkQueue );
+WorkItem_t *pxWorkItem;
+BaseType_t xReturn = pdFAIL;
+
+	pxWorkItem = ( WorkItem_t * ) pvMemPoolAlloc( pxWorkQueue->xPendCallPool, xTicksToWait ); /*lint !e9079 !e9087 Pool blocks are aligned to hold a WorkItem_t. */
+
+	if( pxWorkItem != NULL )
+	{
+		vWorkItemInit( pxWorkItem, xFunctionToPend, pvParameter1, ulParameter2 );
+		pxWorkItem->ucState = wqSTATE_FROM_POOL;
+		xReturn = xWorkQueueSubmit( ( WorkQueueHandle_t ) pxWorkQueue, pxWorkItem, uxPriority );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xWorkQueuePendFunctionCallFromISR( WorkQueueHandle_t xWorkQueue,
+											  WorkFunction_t xFunctionToPend,
+											  void *pvParameter1,
+											  uint32_t ulParameter2,
+											  UBaseType_t uxPriority,
+											  BaseType_t * const pxHigherPriorityTaskWoken )
+{
+WorkQueue_t * const pxWorkQueue = prvGetWorkQueue( xWorkQueue );
+WorkItem_t *pxWorkItem;
+BaseType_t xReturn = pdFAIL;
+
+	pxWorkItem = ( WorkItem_t * ) pvMemPoolAllocFromISR( pxWorkQueue->xPendCallPool ); /*lint !e9079 !e9087 Pool blocks are aligned to hold a WorkItem_t. */
+
+	if( pxWorkItem != NULL )
+	{
+		vWorkItemInit( pxWorkItem, xFunctionToPend, pvParameter1, ulParameter2 );
+		pxWorkItem->ucState = wqSTATE_FROM_POOL;
+		xReturn = xWorkQueueSubmitFromISR( ( WorkQueueHandle_t ) pxWorkQueue, pxWorkItem, uxPriority, pxHigherPriorityTaskWoken );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vWorkQueueGetStats( WorkQueueHandle_t xWorkQueue, WorkQueueStats_t *pxWorkQueueStats )
+{
+const WorkQueue_t * const pxWorkQueue = prvGetWorkQueue( xWorkQueue );
+
+	configASSERT( pxWorkQueueStats );
+
+	taskENTER_CRITICAL();
+	{
+		*pxWorkQueueStats = pxWorkQueue->xStats;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vWorkQueueResetStats( WorkQueueHandle_t xWorkQueue )
+{
+WorkQueue_t * const pxWorkQueue = prvGetWorkQueue( xWorkQueue );
+
+	taskENTER_CRITICAL();
+	{
+		( void ) memset( ( void * ) &( pxWorkQueue->xStats ), 0x00, sizeof( WorkQueueStats_t ) ); /*lint !e9087 memset() requires void *. */
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static WorkQueue_t *prvGetWorkQueue( WorkQueueHandle_t xWorkQueue )
+{
+WorkQueue_t *pxWorkQueue = xWorkQueue;
+
+	if( pxWorkQueue == NULL )
+	{
+		pxWorkQueue = pxSystemWorkQueue;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* The system work queue does not exist until the scheduler has started. */
+	configASSERT( pxWorkQueue );
+
+	return pxWorkQueue;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSubmit( WorkQueue_t * const pxWorkQueue,
+							 WorkItem_t * const pxWorkItem,
+							 UBaseType_t uxPriority,
+							 TickType_t xDelay,
+							 BaseType_t xFromISR,
+							 TaskHandle_t * const pxWorkerToWake )
+{
+UBaseType_t uxSavedInterruptStatus = 0;
+uint32_t ulReadyTime;
+TickType_t xTickCount, xExpiryTime;
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( pxWorkItem );
+	configASSERT( uxPriority < ( UBaseType_t ) configWORK_QUEUE_PRIORITY_LEVELS );
+
+	ulReadyTime = configWORK_QUEUE_TIMESTAMP();
+
+	if( xFromISR != pdFALSE )
+	{
+		uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+	}
+	else
+	{
+		taskENTER_CRITICAL();
+	}
+
+	{
+		if( ( pxWorkItem->ucState & wqSTATE_RUNNING ) != ( uint8_t ) 0 )
+		{
+			/* The worker running the item queues it again when it finishes,
+			unless that has already been requested. */
+			configASSERT( pxWorkItem->pxWorkQueue == pxWorkQueue );
+
+			if( ( pxWorkItem->ucState & wqSTATE_RESUBMIT ) == ( uint8_t ) 0 )
+			{
+				pxWorkItem->ucState |= wqSTATE_RESUBMIT;
+				pxWorkItem->uxPriority = uxPriority;
+				pxWorkQueue->xStats.uxSubmitted++;
+				xReturn = pdPASS;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else if( listLIST_ITEM_CONTAINER( &( pxWorkItem->xListItem ) ) == NULL )
+		{
+			traceWORK_ITEM_SUBMIT( pxWorkQueue, pxWorkItem );
+
+			pxWorkItem->pxWorkQueue = pxWorkQueue;
+			pxWorkItem->uxPriority = uxPriority;
+			pxWorkQueue->xStats.uxSubmitted++;
+			xReturn = pdPASS;
+
+			if( xDelay == ( TickType_t ) 0 )
+			{
+				prvAddReadyItem( pxWorkQueue, pxWorkItem, ulReadyTime );
+			}
+			else
+			{
+				/* The tick count is read inside the critical section so it is
+				never older than the tick count the delayed lists were last
+				checked against. */
+				xTickCount = xTaskGetTickCount();
+				prvProcessDelayedItems( pxWorkQueue, xTickCount, ulReadyTime );
+
+				xExpiryTime = xTickCount + xDelay;
+				listSET_LIST_ITEM_VALUE( &( pxWorkItem->xListItem ), xExpiryTime );
+
+				if( xExpiryTime < xTickCount )
+				{
+					vListInsert( pxWorkQueue->pxOverflowDelayedList, &( pxWorkItem->xListItem ) );
+				}
+				else
+				{
+					vListInsert( pxWorkQueue->pxDelayedList, &( pxWorkItem->xListItem ) );
+				}
+
+				/* If the item is now the first to expire then the timekeeper
+				must recalculate how long to wait. */
+				if( ( pxWorkQueue->xTimekeeper != NULL ) &&
+					( ( listGET_OWNER_OF_HEAD_ENTRY( pxWorkQueue->pxDelayedList ) == ( void * ) pxWorkItem ) ||
+					  ( ( listLIST_IS_EMPTY( pxWorkQueue->pxDelayedList ) != pdFALSE ) && ( listGET_OWNER_OF_HEAD_ENTRY( pxWorkQueue->pxOverflowDelayedList ) == ( void * ) pxWorkItem ) ) ) )
+				{
+					*pxWorkerToWake = pxWorkQueue->xTimekeeper;
+				}
+				else if( ( pxWorkQueue->xTimekeeper == NULL ) && ( pxWorkQueue->uxIdleWorkerCount > ( UBaseType_t ) 0 ) )
+				{
+					/* No idle worker is keeping time, so wake one to do so. */
+					pxWorkQueue->uxIdleWorkerCount--;
+					*pxWorkerToWake = pxWorkQueue->pxIdleWorkers[ pxWorkQueue->uxIdleWorkerCount ];
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+
+			if( *pxWorkerToWake == NULL )
+			{
+				*pxWorkerToWake = prvSelectWorkerToWake( pxWorkQueue );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			/* Already queued. */
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	if( xFromISR != pdFALSE )
+	{
+		taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+	}
+	else
+	{
+		taskEXIT_CRITICAL();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddReadyItem( WorkQueue_t * const pxWorkQueue,
+							 WorkItem_t * const pxWorkItem,
+							 uint32_t ulReadyTime )
+{
+	pxWorkItem->ulReadyTime = ulReadyTime;
+	vListInsertEnd( &( pxWorkQueue->xReadyLists[ pxWorkItem->uxPriority ] ), &( pxWorkItem->xListItem ) );
+	pxWorkQueue->uxItemsReady++;
+}
+/*-----------------------------------------------------------*/
+
+static TaskHandle_t prvSelectWorkerToWake( WorkQueue_t * const pxWorkQueue )
+{
+TaskHandle_t xWorkerToWake = NULL;
+
+	if( ( pxWorkQueue->uxItemsReady > ( UBaseType_t ) 0 ) &&
+		( pxWorkQueue->uxIdleWorkerCount > ( UBaseType_t ) 0 ) &&
+		( pxWorkQueue->xWakePending == pdFALSE ) )
+	{
+		pxWorkQueue->uxIdleWorkerCount--;
+		xWorkerToWake = pxWorkQueue->pxIdleWorkers[ pxWorkQueue->uxIdleWorkerCount ];
+		pxWorkQueue->xWakePending = pdTRUE;
+		pxWorkQueue->xStats.uxWorkerWakeups++;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xWorkerToWake;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessDelayedItems( WorkQueue_t * const pxWorkQueue,
+									TickType_t xTickCount,
+									uint32_t ulReadyTime )
+{
+WorkItem_t *pxWorkItem;
+List_t *pxTemp;
+
+	if( xTickCount < pxWorkQueue->xLastTickCount )
+	{
+		/* The tick count has overflowed, so every item in the current delayed
+		list has expired.  The overflow list becomes the current list. */
+		while( listLIST_IS_EMPTY( pxWorkQueue->pxDelayedList ) == pdFALSE )
+		{
+			pxWorkItem = ( WorkItem_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxWorkQueue->pxDelayedList ); /*lint !e9087 !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+			( void ) uxListRemove( &( pxWorkItem->xListItem ) );
+			prvAddReadyItem( pxWorkQueue, pxWorkItem, ulReadyTime );
+		}
+
+		pxTemp = pxWorkQueue->pxDelayedList;
+		pxWorkQueue->pxDelayedList = pxWorkQueue->pxOverflowDelayedList;
+		pxWorkQueue->pxOverflowDelayedList = pxTemp;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	pxWorkQueue->xLastTickCount = xTickCount;
+
+	while( ( listLIST_IS_EMPTY( pxWorkQueue->pxDelayedList ) == pdFALSE ) &&
+		   ( listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxWorkQueue->pxDelayedList ) <= xTickCount ) )
+	{
+		pxWorkItem = ( WorkItem_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxWorkQueue->pxDelayedList ); /*lint !e9087 !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+		( void ) uxListRemove( &( pxWorkItem->xListItem ) );
+		prvAddReadyItem( pxWorkQueue, pxWorkItem, ulReadyTime );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvTakeBatch( WorkQueue_t * const pxWorkQueue,
+								 WorkItem_t *pxBatch[] )
+{
+UBaseType_t uxLevel = ( UBaseType_t ) configWORK_QUEUE_PRIORITY_LEVELS, uxTaken = ( UBaseType_t ) 0;
+List_t *pxReadyList;
+WorkItem_t *pxWorkItem;
+
+	while( ( uxLevel > ( UBaseType_t ) 0 ) && ( uxTaken < ( UBaseType_t ) configWORK_QUEUE_BATCH_SIZE ) )
+	{
+		uxLevel--;
+		pxReadyList = &( pxWorkQueue->xReadyLists[ uxLevel ] );
+
+		while( ( listLIST_IS_EMPTY( pxReadyList ) == pdFALSE ) && ( uxTaken < ( UBaseType_t ) configWORK_QUEUE_BATCH_SIZE ) )
+		{
+			pxWorkItem = ( WorkItem_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxReadyList ); /*lint !e9087 !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+			( void ) uxListRemove( &( pxWorkItem->xListItem ) );
+			pxWorkItem->ucState |= wqSTATE_RUNNING;
+			pxBatch[ uxTaken ] = pxWorkItem;
+			uxTaken++;
+		}
+	}
+
+	pxWorkQueue->uxItemsReady -= uxTaken;
+
+	if( uxTaken > pxWorkQueue->xStats.uxMaximumBatch )
+	{
+		pxWorkQueue->xStats.uxMaximumBatch = uxTaken;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return uxTaken;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvFinishItem( WorkQueue_t * const pxWorkQueue,
+								 WorkItem_t * const pxWorkItem,
+								 uint32_t ulLatency )
+{
+UBaseType_t uxBucket = ( UBaseType_t ) 0;
+uint32_t ulRemaining = ulLatency;
+BaseType_t xReturnToPool = pdFALSE;
+
+	/* The bucket is one more than the index of the most significant bit set in
+	the latency, or 0 if the latency is 0. */
+	while( ( ulRemaining != 0UL ) && ( uxBucket < ( UBaseType_t ) ( configWORK_QUEUE_HISTOGRAM_BUCKETS - 1 ) ) )
+	{
+		ulRemaining >>= 1UL;
+		uxBucket++;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		pxWorkQueue->xStats.uxExecuted++;
+		pxWorkQueue->xStats.uxLatencyHistogram[ uxBucket ]++;
+
+		if( ulLatency > pxWorkQueue->xStats.ulMaximumLatency )
+		{
+			pxWorkQueue->xStats.ulMaximumLatency = ulLatency;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxWorkItem->ucState &= ( uint8_t ) ~wqSTATE_RUNNING;
+
+		if( ( pxWorkItem->ucState & wqSTATE_RESUBMIT ) != ( uint8_t ) 0 )
+		{
+			/* Submitted while running.  This worker will take the item again,
+			or wake another worker to do so, before it next waits. */
+			pxWorkItem->ucState &= ( uint8_t ) ~wqSTATE_RESUBMIT;
+			prvAddReadyItem( pxWorkQueue, pxWorkItem, configWORK_QUEUE_TIMESTAMP() );
+		}
+		else if( ( pxWorkItem->ucState & wqSTATE_FROM_POOL ) != ( uint8_t ) 0 )
+		{
+			xReturnToPool = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturnToPool;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveIdleWorker( WorkQueue_t * const pxWorkQueue,
+								 TaskHandle_t xWorker )
+{
+UBaseType_t uxIndex;
+
+	for( uxIndex = ( UBaseType_t ) 0; uxIndex < pxWorkQueue->uxIdleWorkerCount; uxIndex++ )
+	{
+		if( pxWorkQueue->pxIdleWorkers[ uxIndex ] == xWorker )
+		{
+			pxWorkQueue->uxIdleWorkerCount--;
+
+			/* Close the gap, keeping the order of the other workers. */
+			while( uxIndex < pxWorkQueue->uxIdleWorkerCount )
+			{
+				pxWorkQueue->pxIdleWorkers[ uxIndex ] = pxWorkQueue->pxIdleWorkers[ uxIndex + ( UBaseType_t ) 1 ];
+				uxIndex++;
+			}
+
+			break;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWorkerTask( void *pvParameters )
+{
+WorkQueue_t * const pxWorkQueue = ( WorkQueue_t * ) pvParameters;
+const TaskHandle_t xThisWorker = xTaskGetCurrentTaskHandle();
+WorkItem_t *pxBatch[ configWORK_QUEUE_BATCH_SIZE ];
+WorkItem_t *pxWorkItem;
+UBaseType_t uxTaken, uxItem;
+TickType_t xTickCount, xTicksToWait;
+TaskHandle_t xWorkerToWake;
+uint32_t ulNow, ulStartTime;
+
+	for( ;; )
+	{
+		ulNow = configWORK_QUEUE_TIMESTAMP();
+		xWorkerToWake = NULL;
+		xTicksToWait = portMAX_DELAY;
+
+		taskENTER_CRITICAL();
+		{
+			/* The worker is on the idle stack if its wait timed out, or it was
+			woken to keep time. */
+			prvRemoveIdleWorker( pxWorkQueue, xThisWorker );
+
+			if( pxWorkQueue->xTimekeeper == xThisWorker )
+			{
+				pxWorkQueue->xTimekeeper = NULL;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Whichever worker gets here first takes the items that caused
+			the wake. */
+			pxWorkQueue->xWakePending = pdFALSE;
+
+			xTickCount = xTaskGetTickCount();
+			prvProcessDelayedItems( pxWorkQueue, xTickCount, ulNow );
+
+			uxTaken = prvTakeBatch( pxWorkQueue, pxBatch );
+
+			if( uxTaken == ( UBaseType_t ) 0 )
+			{
+				/* Nothing to do, so go idle.  If no idle worker is keeping
+				time for the delayed items then this one does. */
+				configASSERT( pxWorkQueue->uxIdleWorkerCount < pxWorkQueue->uxWorkerCount );
+				pxWorkQueue->pxIdleWorkers[ pxWorkQueue->uxIdleWorkerCount ] = xThisWorker;
+				pxWorkQueue->uxIdleWorkerCount++;
+
+				if( pxWorkQueue->xTimekeeper == NULL )
+				{
+					if( listLIST_IS_EMPTY( pxWorkQueue->pxDelayedList ) == pdFALSE )
+					{
+						pxWorkQueue->xTimekeeper = xThisWorker;
+						xTicksToWait = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxWorkQueue->pxDelayedList ) - xTickCount;
+					}
+					else if( listLIST_IS_EMPTY( pxWorkQueue->pxOverflowDelayedList ) == pdFALSE )
+					{
+						/* The subtraction wraps to the time to the expiry. */
+						pxWorkQueue->xTimekeeper = xThisWorker;
+						xTicksToWait = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxWorkQueue->pxOverflowDelayedList ) - xTickCount;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				/* Share out the items this worker could not take. */
+				xWorkerToWake = prvSelectWorkerToWake( pxWorkQueue );
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( uxTaken == ( UBaseType_t ) 0 )
+		{
+			/* A submit made between leaving the critical section and waiting
+			leaves the notification pending, so is not missed. */
+			( void ) ulTaskNotifyTake( pdTRUE, xTicksToWait );
+		}
+		else
+		{
+			if( xWorkerToWake != NULL )
+			{
+				( void ) xTaskNotifyGive( xWorkerToWake );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			for( uxItem = ( UBaseType_t ) 0; uxItem < uxTaken; uxItem++ )
+			{
+				pxWorkItem = pxBatch[ uxItem ];
+				ulStartTime = configWORK_QUEUE_TIMESTAMP();
+
+				traceWORK_ITEM_EXECUTE( pxWorkQueue, pxWorkItem );
+				pxWorkItem->pxFunction( pxWorkItem->pvParameter1, pxWorkItem->ulParameter2 );
+
+				if( prvFinishItem( pxWorkQueue, pxWorkItem, ulStartTime - pxWorkItem->ulReadyTime ) != pdFALSE )
+				{
+					vMemPoolFree( pxWorkQueue->xPendCallPool, ( void * ) pxWorkItem );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+to include work queues.  This #if is closed at the very bottom of this file. */
+#endif /* configUSE_WORK_QUEUES == 1 */
@@ -0,0 +1,144 @@
+/*
+ * Amazon FreeRTOS Buffer Pool V1.0.0
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/**
+ * @file aws_bufferpool_mem_pool.c
+ * @brief A thread safe implementation of the BufferPool interface built on a
+ * FreeRTOS memory pool.
+ *
+ * This file can be built in place of aws_bufferpool_static_thread_safe.c.
+ * Getting and returning a buffer take the same time however many buffers are
+ * in use, where aws_bufferpool_static_thread_safe.c searches the pool for a
+ * free buffer.  The number of buffers in the pool and the size of each buffer
+ * is controlled via macros bufferpoolconfigNUM_BUFFERS and
+ * bufferpoolconfigBUFFER_SIZE which must be defined in BufferPoolConfig.h.
+ *
+ * configSUPPORT_STATIC_ALLOCATION and configUSE_COUNTING_SEMAPHORES must be
+ * set to 1 in FreeRTOSConfig.h to use this implementation.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mem_pool.h"
+
+/* BufferPool includes. */
+#include "aws_bufferpool.h"
+#include "aws_bufferpool_config.h"
+
+/* Make sure that proper config options are defined. */
+#ifndef bufferpoolconfigNUM_BUFFERS
+    #error bufferpoolconfigNUM_BUFFERS must be defined in BufferPoolConfig.h
+#endif
+
+#ifndef bufferpoolconfigBUFFER_SIZE
+    #error bufferpoolconfigBUFFER_SIZE must be defined in BufferPoolConfig.h
+#endif
+
+#if ( configSUPPORT_STATIC_ALLOCATION != 1 )
+    #error configSUPPORT_STATIC_ALLOCATION must be set to 1 to build aws_bufferpool_mem_pool.c
+#endif
+
+/**
+ * @brief Moves the given pointer ahead by the number of bytes required to
+ * properly align it as specified by portBYTE_ALIGNMENT.
+ *
+ * @param[in] pucPtr The given pointer to be aligned.
+ */
+#define bufferpoolmempoolALIGN_POINTER( pucPtr )    ( ( uint8_t * ) ( ( ( size_t ) ( pucPtr + ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) ) )
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The storage from which the buffers are allocated.
+ *
+ * The memory pool requires its storage to be aligned as specified by
+ * portBYTE_ALIGNMENT, so space is added to allow the start to be aligned.
+ */
+static uint8_t ucBufferPoolStorage[ mpSTORAGE_SIZE_BYTES( bufferpoolconfigNUM_BUFFERS, bufferpoolconfigBUFFER_SIZE ) + ( portBYTE_ALIGNMENT - 1 ) ];
+
+/**
+ * @brief The memory pool structure.
+ */
+static StaticMemPool_t xBufferPoolStructure;
+
+/**
+ * @brief The memory pool the buffers are allocated from.
+ */
+static MemPoolHandle_t xBufferPool = NULL;
+/*-----------------------------------------------------------*/
+
+BaseType_t BUFFERPOOL_Init( void )
+{
+    BaseType_t xResult = pdFAIL;
+
+    /* This function is supposed to be called exactly once
+     * and hence no thread safety is ensured. */
+    if( xBufferPool == NULL )
+    {
+        xBufferPool = xMemPoolCreateStatic( bufferpoolconfigNUM_BUFFERS,
+                                            bufferpoolconfigBUFFER_SIZE,
+                                            bufferpoolmempoolALIGN_POINTER( ucBufferPoolStorage ),
+                                            &xBufferPoolStructure );
+    }
+
+    if( xBufferPool != NULL )
+    {
+        xResult = pdPASS;
+    }
+
+    return xResult;
+}
+/*-----------------------------------------------------------*/
+
+uint8_t * BUFFERPOOL_GetFreeBuffer( uint32_t * pulBufferLength )
+{
+    uint8_t * pucFreeBuffer = NULL;
+
+    /* All the buffers in the pool are of size bufferpoolconfigBUFFER_SIZE,
+     * so we cannot provide any buffer larger than that. */
+    if( *pulBufferLength <= bufferpoolconfigBUFFER_SIZE )
+    {
+        /* Do not wait if all the buffers are in use, in line with the other
+         * implementations of this interface. */
+        pucFreeBuffer = ( uint8_t * ) pvMemPoolAlloc( xBufferPool, 0 );
+
+        if( pucFreeBuffer != NULL )
+        {
+            /* Return the actual buffer size (as configured by the
+             * bufferpoolconfigBUFFER_SIZE macro) to the user. */
+            *pulBufferLength = bufferpoolconfigBUFFER_SIZE;
+        }
+    }
+
+    return pucFreeBuffer;
+}
+/*-----------------------------------------------------------*/
+
+void BUFFERPOOL_ReturnBuffer( uint8_t * const pucBuffer )
+{
+    vMemPoolFree( xBufferPool, pucBuffer );
+}
+/*-----------------------------------------------------------*/
@@ -75,6 +75,25 @@
 
 #define ggJSON_CONVERTION_RADIX    10
 
+/**
+ * @brief Header sent with the discovery request to revalidate the cache.
+ */
+#define ggdHTTP_IF_NONE_MATCH_STRING    "If-None-Match: "
+
+/**
+ * @brief Parsing of the discovery response header.
+ *
+ * The header is read into a buffer of ggdHTTP_HEADER_LINE_SIZE one line at a
+ * time. Only the status line, the length and the entity tag are used, so the
+ * rest of a longer line is dropped.
+ */
+/** @{ */
+#define ggdHTTP_HEADER_LINE_SIZE        128
+#define ggdHTTP_ETAG_STRING             "etag:"
+#define ggdHTTP_STATUS_OK               200
+#define ggdHTTP_STATUS_NOT_MODIFIED     304
+/** @} */
+
 /**
  * @brief HTTP field to get the length of the JSON file.
  *
@@ -145,6 +164,71 @@ static BaseType_t prvIsIPvalid( const char * pcIP,
                                 uint32_t ulIPlength );
 /** @} */
 
+/**
+ * @brief Discovery request helpers.
+ *
+ * The same requests as GGD_JSONRequestStart() and GGD_JSONRequestGetSize(),
+ * but able to revalidate a cached response with its entity tag.
+ */
+/** @{ */
+static BaseType_t prvJSONRequestStart( Socket_t * pxSocket,
+                                       const char * pcIfNoneMatch ); /*lint !e971 can use char without signed/unsigned. */
+static BaseType_t prvJSONRequestGetHeader( Socket_t * pxSocket,
+                                           uint32_t * pulStatusCode,
+                                           uint32_t * pulJSONFileSize,
+                                           char * pcETag ); /*lint !e971 can use char without signed/unsigned. */
+static BaseType_t prvHeaderNameMatch( const char * pcLine,  /*lint !e971 can use char without signed/unsigned. */
+                                      const char * pcName ); /*lint !e971 can use char without signed/unsigned. */
+static BaseType_t prvDiscoverGGC( char * pcBuffer,          /*lint !e971 can use char without signed/unsigned. */
+                                  const uint32_t ulBufferSize,
+                                  GGD_HostAddressData_t * pxHostAddressData,
+                                  const char * pcIfNoneMatch, /*lint !e971 can use char without signed/unsigned. */
+                                  char * pcETag,              /*lint !e971 can use char without signed/unsigned. */
+                                  uint32_t * pulStatusCode );
+/** @} */
+
+#if ( ggdconfigENABLE_DISCOVERY_CACHE == 1 )
+
+/**
+ * @brief The core that GGD_GetGGCIPandCertificate() last connected to.
+ *
+ * The whole record is handed to ggdconfigDISCOVERY_CACHE_SAVE(), so it only
+ * holds no pointers and is cleared before it is filled to keep the padding fixed.
+ */
+    typedef struct
+    {
+        uint32_t ulChecksum;                                            /**< Checksum of the rest of the record and the thing name. */
+        uint32_t ulConfirmedTime;                                       /**< When discovery last returned this core, in seconds. */
+        uint32_t ulCertificateSize;                                     /**< Certificate size including the null terminator. */
+        uint16_t usPort;                                                /**< Port to connect to the core. */
+        char cHostAddress[ ggdconfigDISCOVERY_CACHE_HOST_SIZE ];        /**< Host address of the core. */
+        char cETag[ ggdconfigDISCOVERY_CACHE_ETAG_SIZE ];               /**< Entity tag of the discovery response, empty if none. */
+        char cCertificate[ ggdconfigDISCOVERY_CACHE_CERTIFICATE_SIZE ]; /**< Certificate of the group. */
+    } GGD_DiscoveryCache_t;
+
+    static GGD_DiscoveryCache_t xDiscoveryCache;
+    static BaseType_t xDiscoveryCacheLoaded = pdFALSE;
+
+/**
+ * @brief Discovery cache helper functions.
+ */
+/** @{ */
+    static uint32_t prvCacheChecksum( void );
+    static BaseType_t prvCacheIsValid( void );
+    static BaseType_t prvCacheIsFresh( void );
+    static void prvCacheSave( void );
+    static void prvCacheStore( const GGD_HostAddressData_t * pxHostAddressData,
+                               const char * pcETag ); /*lint !e971 can use char without signed/unsigned. */
+    static BaseType_t prvCacheConnect( char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                       const uint32_t ulBufferSize,
+                                       GGD_HostAddressData_t * pxHostAddressData );
+    static BaseType_t prvGetGGCWithCache( char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                          const uint32_t ulBufferSize,
+                                          GGD_HostAddressData_t * pxHostAddressData,
+                                          const char ** ppcHow ); /*lint !e971 can use char without signed/unsigned. */
+/** @} */
+#endif /* if ( ggdconfigENABLE_DISCOVERY_CACHE == 1 ) */
+
 /**
  * @brief Search for length field in server HTTP response
  *
@@ -160,71 +244,63 @@ BaseType_t GGD_GetGGCIPandCertificate( char * pcBuffer, /*lint !e971 can use cha
                                        const uint32_t ulBufferSize,
                                        GGD_HostAddressData_t * pxHostAddressData )
 {
-    Socket_t xSocket;
-    uint32_t ulJSONFileSize = 0;
-    BaseType_t xJSONFileRetrieveCompleted = pdFALSE;
-    uint32_t ulByteRead = 0;
+    const char * pcHow = "Discovered"; /*lint !e971 can use char without signed/unsigned. */
+    TickType_t xStartTime;
     BaseType_t xStatus;
 
+    #if ( ggdconfigENABLE_DISCOVERY_CACHE == 0 )
+        uint32_t ulStatusCode;
+    #endif
+
     configASSERT( pxHostAddressData != NULL );
     configASSERT( pcBuffer != NULL );
 
-    xStatus = GGD_JSONRequestStart( &xSocket );
+    xStartTime = xTaskGetTickCount();
 
-    if( xStatus == pdPASS )
-    {
-        xStatus = GGD_JSONRequestGetSize( &xSocket, &ulJSONFileSize );
-    }
-
-    if( xStatus == pdPASS )
-    {
-        /* Loop until the full JSON is retrieved. */
-        do {
-            xStatus = GGD_JSONRequestGetFile( &xSocket,
-                                              &pcBuffer[ulByteRead],
-                                              ulBufferSize - ulByteRead,
-                                              &ulByteRead,
-                                              &xJSONFileRetrieveCompleted,
-                                              ulJSONFileSize ); /*lint !e644 ulJSONFileSize has been initialized if code reaches here. */
-        } while ( ( xStatus == pdPASS ) && ( xJSONFileRetrieveCompleted != pdTRUE ) && ( ulBufferSize - ulByteRead ) > 0 );
-
-        /* If the JSON file was not completely received and there
-         * is no space left in the buffer, it means that the buffer
-         * is not large enough to hold the complete GreenGrass
-         * Discovery document. The user should increase the size of
-         * the buffer. */
-        if( ( xJSONFileRetrieveCompleted == pdFALSE ) && ( ( ulBufferSize - ulByteRead ) ==  0 ) )
-        {
-            ggdconfigPRINT( "[ERROR] The supplied buffer is not large enough to hold the GreenGrass discovery document. \r\n" );
-            ggdconfigPRINT( "[ERROR] Consider increasing the size of the supplied buffer. \r\n" );
-        }
-
-        if( xSocket != SOCKETS_INVALID_SOCKET )             /* Check connection is closed. */
-        {
-            GGD_JSONRequestAbort( &xSocket );
-            xStatus = pdFAIL;
-        }
-
-        if( xJSONFileRetrieveCompleted != pdTRUE )
-        {
-            xStatus = pdFAIL;
-        }
-    }
+    #if ( ggdconfigENABLE_DISCOVERY_CACHE == 1 )
+        xStatus = prvGetGGCWithCache( pcBuffer,
+                                      ulBufferSize,
+                                      pxHostAddressData,
+                                      &pcHow );
+    #else
+        xStatus = prvDiscoverGGC( pcBuffer,
+                                  ulBufferSize,
+                                  pxHostAddressData,
+                                  NULL,
+                                  NULL,
+                                  &ulStatusCode );
+    #endif
 
     if( xStatus == pdPASS )
     {
-        xStatus = GGD_GetIPandCertificateFromJSON( pcBuffer,
-                                                   ulJSONFileSize,
-                                                   NULL,
-                                                   pxHostAddressData,
-                                                   pdTRUE );
+        /* Reconnect latency, from the call to a core accepting a connection. */
+        ggdconfigPRINT( "GGD - %s Greengrass core in %ld ms\r\n",
+                        pcHow,
+                        ( uint32_t ) ( ( xTaskGetTickCount() - xStartTime ) * portTICK_PERIOD_MS ) );
     }
 
     return xStatus;
 }
 /*-----------------------------------------------------------*/
 
+void GGD_DiscoveryCacheInvalidate( void )
+{
+    #if ( ggdconfigENABLE_DISCOVERY_CACHE == 1 )
+        memset( &xDiscoveryCache, 0, sizeof( xDiscoveryCache ) );
+        xDiscoveryCacheLoaded = pdTRUE;
+        prvCacheSave();
+    #endif
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t GGD_JSONRequestStart( Socket_t * pxSocket )
+{
+    return prvJSONRequestStart( pxSocket, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvJSONRequestStart( Socket_t * pxSocket,
+                                       const char * pcIfNoneMatch ) /*lint !e971 can use char without signed/unsigned. */
 {
     GGD_HostAddressData_t xHostAddressData;
     BaseType_t xStatus;
@@ -245,9 +321,40 @@ BaseType_t GGD_JSONRequestStart( Socket_t * pxSocket )
     if( xStatus == pdPASS )
     {
         /* Send HTTP request over secure connection (HTTPS) to get the GGC JSON file. */
-        xStatus = GGD_SecureConnect_Send( ggdCLOUD_DISCOVERY_ADDRESS,
-                                          ( uint32_t ) sizeof( ggdCLOUD_DISCOVERY_ADDRESS ) - 1,
-                                          *pxSocket );
+        if( pcIfNoneMatch == NULL )
+        {
+            xStatus = GGD_SecureConnect_Send( ggdCLOUD_DISCOVERY_ADDRESS,
+                                              ( uint32_t ) sizeof( ggdCLOUD_DISCOVERY_ADDRESS ) - 1,
+                                              *pxSocket );
+        }
+        else
+        {
+            /* Same request line, followed by the entity tag of the cached response. */
+            xStatus = GGD_SecureConnect_Send( ggdCLOUD_DISCOVERY_ADDRESS,
+                                              ( uint32_t ) sizeof( ggdCLOUD_DISCOVERY_ADDRESS ) - 3,
+                                              *pxSocket );
+
+            if( xStatus == pdPASS )
+            {
+                xStatus = GGD_SecureConnect_Send( ggdHTTP_IF_NONE_MATCH_STRING,
+                                                  ( uint32_t ) sizeof( ggdHTTP_IF_NONE_MATCH_STRING ) - 1,
+                                                  *pxSocket );
+            }
+
+            if( xStatus == pdPASS )
+            {
+                xStatus = GGD_SecureConnect_Send( pcIfNoneMatch,
+                                                  ( uint32_t ) strlen( pcIfNoneMatch ),
+                                                  *pxSocket );
+            }
+
+            if( xStatus == pdPASS )
+            {
+                xStatus = GGD_SecureConnect_Send( "\r\n\r\n",
+                                                  ( uint32_t ) 4,
+                                                  *pxSocket );
+            }
+        }
 
         if( xStatus == pdFAIL )
         {
@@ -882,6 +989,444 @@ static BaseType_t prvCheckForContentLengthString( uint8_t * pucIndex,
     return xMatch;
 }
 /*-----------------------------------------------------------*/
+static BaseType_t prvJSONRequestGetHeader( Socket_t * pxSocket,
+                                           uint32_t * pulStatusCode,
+                                           uint32_t * pulJSONFileSize,
+                                           char * pcETag ) /*lint !e971 can use char without signed/unsigned. */
+{
+    char cLine[ ggdHTTP_HEADER_LINE_SIZE ]; /*lint !e971 can use char without signed/unsigned. */
+    char cReadChar;                         /*lint !e971 can use char without signed/unsigned. */
+    const char * pcValue;                   /*lint !e971 can use char without signed/unsigned. */
+    uint32_t ulLineLength = 0;
+    uint32_t ulReadSize;
+    uint32_t ulLineNumber = 0;
+    BaseType_t xReadStatus;
+    BaseType_t xStatus = pdFAIL;
+
+    configASSERT( pxSocket != NULL );
+    configASSERT( pulStatusCode != NULL );
+    configASSERT( pulJSONFileSize != NULL );
+
+    *pulStatusCode = 0;
+    *pulJSONFileSize = 0;
+
+    if( pcETag != NULL )
+    {
+        pcETag[ 0 ] = '\0';
+    }
+
+    do
+    {
+        xReadStatus = GGD_SecureConnect_Read( &cReadChar,
+                                              ( uint32_t ) 1,
+                                              *pxSocket,
+                                              &ulReadSize );
+
+        if( ( xReadStatus != pdPASS ) || ( ulReadSize != ( uint32_t ) 1 ) )
+        {
+            xReadStatus = pdFAIL;
+        }
+        else if( cReadChar != '\n' )
+        {
+            /* Keep the start of the line, dropping the '\r' and anything past the buffer. */
+            if( ( cReadChar != '\r' ) && ( ulLineLength < ( uint32_t ) ( sizeof( cLine ) - 1 ) ) )
+            {
+                cLine[ ulLineLength ] = cReadChar;
+                ulLineLength++;
+            }
+        }
+        else if( ulLineLength == ( uint32_t ) 0 )
+        {
+            /* An empty line ends the header. */
+            if( *pulStatusCode != ( uint32_t ) 0 )
+            {
+                xStatus = pdPASS;
+            }
+
+            break;
+        }
+        else
+        {
+            cLine[ ulLineLength ] = '\0';
+
+            if( ulLineNumber == ( uint32_t ) 0 )
+            {
+                /* Status line, "HTTP/1.1 200 OK". */
+                pcValue = strchr( cLine, ' ' );
+
+                if( pcValue != NULL )
+                {
+                    *pulStatusCode = ( uint32_t ) strtoul( pcValue, NULL, ggJSON_CONVERTION_RADIX );
+                }
+            }
+            else if( prvHeaderNameMatch( cLine, ggdHTTP_CONTENT_LENGTH_STRING ) == pdTRUE )
+            {
+                /* Add 1 because at the end of the JSON file the escape character '\0' will be added. */
+                *pulJSONFileSize =
+                    ( uint32_t ) strtoul( &cLine[ sizeof( ggdHTTP_CONTENT_LENGTH_STRING ) - 1 ], NULL, ggJSON_CONVERTION_RADIX )
+                    + ( uint32_t ) 1;
+            }
+            else if( ( pcETag != NULL ) && ( prvHeaderNameMatch( cLine, ggdHTTP_ETAG_STRING ) == pdTRUE ) )
+            {
+                pcValue = &cLine[ sizeof( ggdHTTP_ETAG_STRING ) - 1 ];
+
+                while( *pcValue == ' ' )
+                {
+                    pcValue++;
+                }
+
+                /* A truncated tag would never match, so keep none instead. */
+                if( ( strlen( pcValue ) < ( size_t ) ggdconfigDISCOVERY_CACHE_ETAG_SIZE ) &&
+                    ( ulLineLength < ( uint32_t ) ( sizeof( cLine ) - 1 ) ) )
+                {
+                    strcpy( pcETag, pcValue );
+                }
+            }
+            else
+            {
+                /* Not needed. */
+            }
+
+            ulLineNumber++;
+            ulLineLength = 0;
+        }
+    } while( xReadStatus == pdPASS );
+
+    if( xStatus == pdFAIL )
+    {
+        /* Don't forget to close the connection. */
+        GGD_SecureConnect_Disconnect( pxSocket );
+        ggdconfigPRINT( "JSON parsing failed\r\n" );
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvHeaderNameMatch( const char * pcLine,  /*lint !e971 can use char without signed/unsigned. */
+                                      const char * pcName ) /*lint !e971 can use char without signed/unsigned. */
+{
+    BaseType_t xMatch = pdTRUE;
+    uint32_t ulIndex;
+    char cChar; /*lint !e971 can use char without signed/unsigned. */
+
+    /* Header names are case insensitive, pcName is lower case. */
+    for( ulIndex = 0; pcName[ ulIndex ] != '\0'; ulIndex++ )
+    {
+        cChar = pcLine[ ulIndex ];
+
+        if( ( cChar >= 'A' ) && ( cChar <= 'Z' ) )
+        {
+            cChar = ( char ) ( cChar - 'A' + 'a' ); /*lint !e971 can use char without signed/unsigned. */
+        }
+
+        if( cChar != pcName[ ulIndex ] )
+        {
+            xMatch = pdFALSE;
+            break;
+        }
+    }
+
+    return xMatch;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvDiscoverGGC( char * pcBuffer,          /*lint !e971 can use char without signed/unsigned. */
+                                  const uint32_t ulBufferSize,
+                                  GGD_HostAddressData_t * pxHostAddressData,
+                                  const char * pcIfNoneMatch, /*lint !e971 can use char without signed/unsigned. */
+                                  char * pcETag,              /*lint !e971 can use char without signed/unsigned. */
+                                  uint32_t * pulStatusCode )
+{
+    Socket_t xSocket;
+    uint32_t ulJSONFileSize = 0;
+    BaseType_t xJSONFileRetrieveCompleted = pdFALSE;
+    uint32_t ulByteRead = 0;
+    BaseType_t xStatus;
+
+    *pulStatusCode = 0;
+
+    xStatus = prvJSONRequestStart( &xSocket, pcIfNoneMatch );
+
+    if( xStatus == pdPASS )
+    {
+        xStatus = prvJSONRequestGetHeader( &xSocket, pulStatusCode, &ulJSONFileSize, pcETag );
+    }
+
+    if( xStatus == pdPASS )
+    {
+        if( ( *pulStatusCode == ( uint32_t ) ggdHTTP_STATUS_NOT_MODIFIED ) && ( pcIfNoneMatch != NULL ) )
+        {
+            /* The cached core is still current, there is no body to read. */
+            GGD_JSONRequestAbort( &xSocket );
+        }
+        else if( ( *pulStatusCode != ( uint32_t ) ggdHTTP_STATUS_OK ) || ( ulJSONFileSize <= ( uint32_t ) 1 ) )
+        {
+            ggdconfigPRINT( "JSON request - Unexpected response %ld\r\n", *pulStatusCode );
+            GGD_JSONRequestAbort( &xSocket );
+            xStatus = pdFAIL;
+        }
+        else
+        {
+            /* Loop until the full JSON is retrieved. */
+            do {
+                xStatus = GGD_JSONRequestGetFile( &xSocket,
+                                                  &pcBuffer[ulByteRead],
+                                                  ulBufferSize - ulByteRead,
+                                                  &ulByteRead,
+                                                  &xJSONFileRetrieveCompleted,
+                                                  ulJSONFileSize );
+            } while ( ( xStatus == pdPASS ) && ( xJSONFileRetrieveCompleted != pdTRUE ) && ( ulBufferSize - ulByteRead ) > 0 );
+
+            /* If the JSON file was not completely received and there
+             * is no space left in the buffer, it means that the buffer
+             * is not large enough to hold the complete GreenGrass
+             * Discovery document. The user should increase the size of
+             * the buffer. */
+            if( ( xJSONFileRetrieveCompleted == pdFALSE ) && ( ( ulBufferSize - ulByteRead ) ==  0 ) )
+            {
+                ggdconfigPRINT( "[ERROR] The supplied buffer is not large enough to hold the GreenGrass discovery document. \r\n" );
+                ggdconfigPRINT( "[ERROR] Consider increasing the size of the supplied buffer. \r\n" );
+            }
+
+            if( xSocket != SOCKETS_INVALID_SOCKET )             /* Check connection is closed. */
+            {
+                GGD_JSONRequestAbort( &xSocket );
+                xStatus = pdFAIL;
+            }
+
+            if( xJSONFileRetrieveCompleted != pdTRUE )
+            {
+                xStatus = pdFAIL;
+            }
+
+            if( xStatus == pdPASS )
+            {
+                xStatus = GGD_GetIPandCertificateFromJSON( pcBuffer,
+                                                           ulJSONFileSize,
+                                                           NULL,
+                                                           pxHostAddressData,
+                                                           pdTRUE );
+            }
+        }
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+#if ( ggdconfigENABLE_DISCOVERY_CACHE == 1 )
+
+    static BaseType_t prvGetGGCWithCache( char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                          const uint32_t ulBufferSize,
+                                          GGD_HostAddressData_t * pxHostAddressData,
+                                          const char ** ppcHow ) /*lint !e971 can use char without signed/unsigned. */
+    {
+        char cETag[ ggdconfigDISCOVERY_CACHE_ETAG_SIZE ]; /*lint !e971 can use char without signed/unsigned. */
+        const char * pcIfNoneMatch = NULL;                /*lint !e971 can use char without signed/unsigned. */
+        uint32_t ulStatusCode = 0;
+        BaseType_t xStatus = pdFAIL;
+
+        if( prvCacheIsValid() == pdTRUE )
+        {
+            if( prvCacheIsFresh() == pdFALSE )
+            {
+                /* Ask discovery whether the cached core is still current. */
+                if( xDiscoveryCache.cETag[ 0 ] != '\0' )
+                {
+                    pcIfNoneMatch = xDiscoveryCache.cETag;
+                }
+
+                xStatus = prvDiscoverGGC( pcBuffer,
+                                          ulBufferSize,
+                                          pxHostAddressData,
+                                          pcIfNoneMatch,
+                                          cETag,
+                                          &ulStatusCode );
+
+                if( ulStatusCode == ( uint32_t ) ggdHTTP_STATUS_NOT_MODIFIED )
+                {
+                    xDiscoveryCache.ulConfirmedTime = ggdconfigDISCOVERY_CACHE_TIME_SECONDS();
+                    xDiscoveryCache.ulChecksum = prvCacheChecksum();
+                    prvCacheSave();
+                }
+            }
+
+            /* Unless discovery returned a new document, try the cached core.
+             * This includes discovery not being reachable at all. */
+            if( ulStatusCode != ( uint32_t ) ggdHTTP_STATUS_OK )
+            {
+                xStatus = prvCacheConnect( pcBuffer, ulBufferSize, pxHostAddressData );
+
+                if( xStatus == pdPASS )
+                {
+                    *ppcHow = ( ulStatusCode == ( uint32_t ) ggdHTTP_STATUS_NOT_MODIFIED ) ? "Revalidated" : "Reconnected to cached";
+                }
+            }
+        }
+
+        /* Fall back to a full discovery. */
+        if( ( xStatus == pdFAIL ) && ( ulStatusCode != ( uint32_t ) ggdHTTP_STATUS_OK ) )
+        {
+            xStatus = prvDiscoverGGC( pcBuffer,
+                                      ulBufferSize,
+                                      pxHostAddressData,
+                                      NULL,
+                                      cETag,
+                                      &ulStatusCode );
+        }
+
+        if( ( xStatus == pdPASS ) && ( ulStatusCode == ( uint32_t ) ggdHTTP_STATUS_OK ) )
+        {
+            prvCacheStore( pxHostAddressData, cETag );
+        }
+
+        return xStatus;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvCacheConnect( char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                       const uint32_t ulBufferSize,
+                                       GGD_HostAddressData_t * pxHostAddressData )
+    {
+        uint32_t ulHostAddressSize = ( uint32_t ) strlen( xDiscoveryCache.cHostAddress ) + ( uint32_t ) 1;
+        Socket_t xSocket;
+        BaseType_t xStatus = pdFAIL;
+
+        /* Return the core in the caller's buffer, as discovery does. */
+        if( ( xDiscoveryCache.ulCertificateSize + ulHostAddressSize ) <= ulBufferSize )
+        {
+            memcpy( pcBuffer, xDiscoveryCache.cCertificate, xDiscoveryCache.ulCertificateSize );
+            memcpy( &pcBuffer[ xDiscoveryCache.ulCertificateSize ], xDiscoveryCache.cHostAddress, ulHostAddressSize );
+
+            pxHostAddressData->pcCertificate = pcBuffer;
+            pxHostAddressData->ulCertificateSize = xDiscoveryCache.ulCertificateSize;
+            pxHostAddressData->pcHostAddress = &pcBuffer[ xDiscoveryCache.ulCertificateSize ];
+            pxHostAddressData->usPort = xDiscoveryCache.usPort;
+
+            if( GGD_SecureConnect_Connect( pxHostAddressData,
+                                           &xSocket,
+                                           ggdconfigTCP_RECEIVE_TIMEOUT_MS,
+                                           ggdconfigTCP_SEND_TIMEOUT_MS )
+                == pdPASS )
+            {
+                GGD_SecureConnect_Disconnect( &xSocket );
+                xStatus = pdPASS;
+            }
+            else
+            {
+                ggdconfigPRINT( "GGD - Can't connect to cached greengrass Core\r\n" );
+                GGD_DiscoveryCacheInvalidate();
+            }
+        }
+
+        return xStatus;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvCacheStore( const GGD_HostAddressData_t * pxHostAddressData,
+                               const char * pcETag ) /*lint !e971 can use char without signed/unsigned. */
+    {
+        uint32_t ulHostAddressSize = ( uint32_t ) strlen( pxHostAddressData->pcHostAddress ) + ( uint32_t ) 1;
+
+        memset( &xDiscoveryCache, 0, sizeof( xDiscoveryCache ) );
+        xDiscoveryCacheLoaded = pdTRUE;
+
+        if( ( ulHostAddressSize <= ( uint32_t ) ggdconfigDISCOVERY_CACHE_HOST_SIZE ) &&
+            ( pxHostAddressData->ulCertificateSize <= ( uint32_t ) ggdconfigDISCOVERY_CACHE_CERTIFICATE_SIZE ) )
+        {
+            xDiscoveryCache.ulConfirmedTime = ggdconfigDISCOVERY_CACHE_TIME_SECONDS();
+            xDiscoveryCache.ulCertificateSize = pxHostAddressData->ulCertificateSize;
+            xDiscoveryCache.usPort = pxHostAddressData->usPort;
+            memcpy( xDiscoveryCache.cHostAddress, pxHostAddressData->pcHostAddress, ulHostAddressSize );
+            memcpy( xDiscoveryCache.cCertificate, pxHostAddressData->pcCertificate, pxHostAddressData->ulCertificateSize );
+            strcpy( xDiscoveryCache.cETag, pcETag );
+            xDiscoveryCache.ulChecksum = prvCacheChecksum();
+        }
+        else
+        {
+            ggdconfigPRINT( "GGD - Greengrass core too large to cache\r\n" );
+        }
+
+        prvCacheSave();
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvCacheIsValid( void )
+    {
+        BaseType_t xValid = pdFALSE;
+
+        if( xDiscoveryCacheLoaded == pdFALSE )
+        {
+            xDiscoveryCacheLoaded = pdTRUE;
+
+            if( ggdconfigDISCOVERY_CACHE_LOAD( &xDiscoveryCache, sizeof( xDiscoveryCache ) ) != pdPASS )
+            {
+                memset( &xDiscoveryCache, 0, sizeof( xDiscoveryCache ) );
+            }
+        }
+
+        /* An empty record, or one left by another thing, does not match. */
+        if( ( xDiscoveryCache.ulCertificateSize != ( uint32_t ) 0 ) &&
+            ( xDiscoveryCache.ulCertificateSize <= ( uint32_t ) ggdconfigDISCOVERY_CACHE_CERTIFICATE_SIZE ) &&
+            ( xDiscoveryCache.ulChecksum == prvCacheChecksum() ) )
+        {
+            xValid = pdTRUE;
+        }
+
+        return xValid;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvCacheIsFresh( void )
+    {
+        uint32_t ulNow = ggdconfigDISCOVERY_CACHE_TIME_SECONDS();
+        BaseType_t xFresh = pdFALSE;
+
+        /* A record from before the clock was reset has an unknown age. */
+        if( ( ulNow >= xDiscoveryCache.ulConfirmedTime ) &&
+            ( ( ulNow - xDiscoveryCache.ulConfirmedTime ) < ( uint32_t ) ggdconfigDISCOVERY_CACHE_TTL_SECONDS ) )
+        {
+            xFresh = pdTRUE;
+        }
+
+        return xFresh;
+    }
+/*-----------------------------------------------------------*/
+
+    static uint32_t prvCacheChecksum( void )
+    {
+        const uint8_t * pucData = ( const uint8_t * ) &xDiscoveryCache;
+        const char * pcThingName = clientcredentialIOT_THING_NAME; /*lint !e971 can use char without signed/unsigned. */
+        uint32_t ulHash = 2166136261UL;
+        uint32_t ulIndex;
+
+        /* FNV-1a over the thing name and the record after the checksum. */
+        for( ulIndex = 0; pcThingName[ ulIndex ] != '\0'; ulIndex++ )
+        {
+            ulHash = ( ulHash ^ ( uint32_t ) ( uint8_t ) pcThingName[ ulIndex ] ) * 16777619UL;
+        }
+
+        for( ulIndex = ( uint32_t ) sizeof( xDiscoveryCache.ulChecksum ); ulIndex < ( uint32_t ) sizeof( xDiscoveryCache ); ulIndex++ )
+        {
+            ulHash = ( ulHash ^ ( uint32_t ) pucData[ ulIndex ] ) * 16777619UL;
+        }
+
+        return ulHash;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvCacheSave( void )
+    {
+        if( ggdconfigDISCOVERY_CACHE_SAVE( &xDiscoveryCache, sizeof( xDiscoveryCache ) ) != pdPASS )
+        {
+            ggdconfigPRINT( "GGD - Could not save the discovery cache\r\n" );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* if ( ggdconfigENABLE_DISCOVERY_CACHE == 1 ) */
+
 /* Provide access to private members for testing. */
 #ifdef AMAZON_FREERTOS_ENABLE_UNIT_TESTS
     #include "aws_greengrass_discovery_test_access_define.h"
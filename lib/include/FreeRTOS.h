@@ -206,6 +206,14 @@ extern "C" {
 	#define configUSE_TIMERS 0
 #endif
 
+#ifndef configUSE_WORK_QUEUES
+	#define configUSE_WORK_QUEUES 0
+#endif
+
+#ifndef configUSE_ASYNC_ENGINE
+	#define configUSE_ASYNC_ENGINE 0
+#endif
+
 #ifndef configUSE_COUNTING_SEMAPHORES
 	#define configUSE_COUNTING_SEMAPHORES 0
 #endif
@@ -254,6 +262,56 @@ extern "C" {
 
 #endif /* configUSE_TIMERS */
 
+#if configUSE_WORK_QUEUES == 1
+
+	#ifndef configSYSTEM_WORK_QUEUE_PRIORITY
+		#error If configUSE_WORK_QUEUES is set to 1 then configSYSTEM_WORK_QUEUE_PRIORITY must also be defined.
+	#endif /* configSYSTEM_WORK_QUEUE_PRIORITY */
+
+	#ifndef configSYSTEM_WORK_QUEUE_STACK_DEPTH
+		#error If configUSE_WORK_QUEUES is set to 1 then configSYSTEM_WORK_QUEUE_STACK_DEPTH must also be defined.
+	#endif /* configSYSTEM_WORK_QUEUE_STACK_DEPTH */
+
+#endif /* configUSE_WORK_QUEUES */
+
+#ifndef configSYSTEM_WORK_QUEUE_WORKERS
+	#define configSYSTEM_WORK_QUEUE_WORKERS 2
+#endif
+
+#ifndef configWORK_QUEUE_PRIORITY_LEVELS
+	#define configWORK_QUEUE_PRIORITY_LEVELS 3
+#endif
+
+#ifndef configWORK_QUEUE_BATCH_SIZE
+	#define configWORK_QUEUE_BATCH_SIZE 4
+#endif
+
+#ifndef configWORK_QUEUE_HISTOGRAM_BUCKETS
+	#define configWORK_QUEUE_HISTOGRAM_BUCKETS 12
+#endif
+
+#ifndef configWORK_QUEUE_PEND_CALL_ITEMS
+	#define configWORK_QUEUE_PEND_CALL_ITEMS 8
+#endif
+
+#ifndef configWORK_QUEUE_TIMESTAMP
+	/* The time source used to measure how long work items wait to run.  Must be
+	callable from tasks and interrupts, and must return a uint32_t. */
+	#define configWORK_QUEUE_TIMESTAMP() ( ( uint32_t ) xTaskGetTickCountFromISR() )
+#endif
+
+#ifndef configPEND_FUNCTION_CALL_USE_WORK_QUEUE
+	#define configPEND_FUNCTION_CALL_USE_WORK_QUEUE 0
+#endif
+
+#if( ( configUSE_ASYNC_ENGINE == 1 ) && ( configUSE_QUEUE_SETS != 1 ) )
+	#error configUSE_QUEUE_SETS must be set to 1 to set configUSE_ASYNC_ENGINE to 1
+#endif
+
+#if( ( configPEND_FUNCTION_CALL_USE_WORK_QUEUE == 1 ) && ( configUSE_WORK_QUEUES != 1 ) )
+	#error configUSE_WORK_QUEUES must be set to 1 to set configPEND_FUNCTION_CALL_USE_WORK_QUEUE to 1
+#endif
+
 #ifndef portSET_INTERRUPT_MASK_FROM_ISR
 	#define portSET_INTERRUPT_MASK_FROM_ISR() 0
 #endif
@@ -266,6 +324,39 @@ extern "C" {
 	#define portCLEAN_UP_TCB( pxTCB ) ( void ) pxTCB
 #endif
 
+#ifdef portCOMPARE_AND_SWAP
+	/* portCOMPARE_AND_SWAP( puxDestination, uxExpected, uxDesired ) atomically
+	writes uxDesired to the UBaseType_t pointed to by puxDestination if, and
+	only if, it holds uxExpected, and returns pdTRUE if the write was made.  It
+	must be safe to call from tasks and interrupts on every core, and must order
+	memory accesses as portMEMORY_BARRIER() does.  Ring buffers are lock-free
+	when the port defines it. */
+	#ifndef portMEMORY_BARRIER
+		#error portMEMORY_BARRIER() must be defined by the port when portCOMPARE_AND_SWAP() is defined
+	#endif
+#endif
+
+#ifndef portMEMORY_BARRIER
+	/* Orders the memory accesses before the barrier with those after it, as
+	seen by other cores and by interrupts. */
+	#define portMEMORY_BARRIER()
+#endif
+
+#ifdef portGET_HIGH_RESOLUTION_COUNT
+	/* portGET_HIGH_RESOLUTION_COUNT() returns a free running 32-bit count, such
+	as a cycle counter or a hardware timer, that increments
+	portHIGH_RESOLUTION_COUNT_HZ times a second.  The kernel extends it to 64
+	bits on each tick, so it must not wrap more than once per tick period, and
+	it must be the same count on every core.  It provides the sub-tick part of
+	ullTaskGetHighResolutionTime(). */
+	#ifndef portHIGH_RESOLUTION_COUNT_HZ
+		#error portHIGH_RESOLUTION_COUNT_HZ must be defined by the port when portGET_HIGH_RESOLUTION_COUNT() is defined
+	#endif
+#else
+	/* Without a high resolution count the time only advances with the tick. */
+	#define portHIGH_RESOLUTION_COUNT_HZ configTICK_RATE_HZ
+#endif
+
 #ifndef portPRE_TASK_DELETE_HOOK
 	#define portPRE_TASK_DELETE_HOOK( pvTaskToDelete, pxYieldPending )
 #endif
@@ -288,6 +379,67 @@ extern "C" {
 	#define portPOINTER_SIZE_TYPE uint32_t
 #endif
 
+#ifndef configUSE_TRACE_RING
+	#define configUSE_TRACE_RING 0
+#endif
+
+#if ( configUSE_TRACE_RING == 1 )
+
+	#ifndef configTRACE_RING_EVENTS
+		/* The number of events held for each core.  Must be a power of 2. */
+		#define configTRACE_RING_EVENTS 1024
+	#endif
+
+	#ifndef configTRACE_RING_TASK_NAMES
+		#define configTRACE_RING_TASK_NAMES 32
+	#endif
+
+	/* The trace ring defines the trace macros it records, so must be included
+	before the unused trace macros are removed below. */
+	#include "trace_ring.h"
+
+#endif /* configUSE_TRACE_RING */
+
+#ifndef configUSE_HEAP_PROFILER
+	#define configUSE_HEAP_PROFILER 0
+#endif
+
+#if ( configUSE_HEAP_PROFILER == 1 )
+
+	#ifndef configHEAP_PROFILER_ALLOCATIONS
+		/* The number of entries in the table of allocated blocks.  Must be a
+		power of 2.  Up to three quarters of the entries are used. */
+		#define configHEAP_PROFILER_ALLOCATIONS 512
+	#endif
+
+	#ifndef configHEAP_PROFILER_TAGS
+		#define configHEAP_PROFILER_TAGS 8
+	#endif
+
+	#ifndef configHEAP_PROFILER_TASKS
+		#define configHEAP_PROFILER_TASKS 16
+	#endif
+
+	#ifndef configHEAP_PROFILER_HEAP_STATS
+		/* Set to 0 if the heap implementation does not provide
+		vPortGetHeapStats(). */
+		#define configHEAP_PROFILER_HEAP_STATS 1
+	#endif
+
+	#ifndef configHEAP_PROFILER_CALL_SITE
+		#ifdef __GNUC__
+			#define configHEAP_PROFILER_CALL_SITE() __builtin_return_address( 0 )
+		#else
+			#define configHEAP_PROFILER_CALL_SITE() NULL
+		#endif
+	#endif
+
+	/* The heap profiler defines traceMALLOC() and traceFREE(), so must be
+	included before the unused trace macros are removed below. */
+	#include "heap_profiler.h"
+
+#endif /* configUSE_HEAP_PROFILER */
+
 /* Remove any unused trace macros. */
 #ifndef traceSTART
 	/* Used to perform any necessary initialisation - for example, open a file
@@ -323,6 +475,17 @@ extern "C" {
 	#define traceLOW_POWER_IDLE_END()
 #endif
 
+#ifndef traceISR_ENTER
+	/* Called by ports that support it when an interrupt handler starts.
+	uxISRNumber identifies the interrupt in a port specific way. */
+	#define traceISR_ENTER( uxISRNumber )
+#endif
+
+#ifndef traceISR_EXIT
+	/* Called by ports that support it when an interrupt handler returns. */
+	#define traceISR_EXIT( uxISRNumber )
+#endif
+
 #ifndef traceTASK_SWITCHED_OUT
 	/* Called before a task has been selected to run.  pxCurrentTCB holds a pointer
 	to the task control block of the task being switched out. */
@@ -688,6 +851,86 @@ extern "C" {
 	#define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength )
 #endif
 
+#ifndef traceRING_BUFFER_CREATE_FAILED
+	#define traceRING_BUFFER_CREATE_FAILED()
+#endif
+
+#ifndef traceRING_BUFFER_CREATE
+	#define traceRING_BUFFER_CREATE( pxRingBuffer )
+#endif
+
+#ifndef traceRING_BUFFER_DELETE
+	#define traceRING_BUFFER_DELETE( xRingBuffer )
+#endif
+
+#ifndef traceRING_BUFFER_SEND_FAILED
+	#define traceRING_BUFFER_SEND_FAILED( xRingBuffer )
+#endif
+
+#ifndef traceBLOCKING_ON_RING_BUFFER_SEND
+	#define traceBLOCKING_ON_RING_BUFFER_SEND( xRingBuffer )
+#endif
+
+#ifndef traceBLOCKING_ON_RING_BUFFER_RECEIVE
+	#define traceBLOCKING_ON_RING_BUFFER_RECEIVE( xRingBuffer )
+#endif
+
+#ifndef traceRING_BUFFER_RECEIVE_FAILED
+	#define traceRING_BUFFER_RECEIVE_FAILED( xRingBuffer )
+#endif
+
+#ifndef traceMEM_POOL_CREATE_FAILED
+	#define traceMEM_POOL_CREATE_FAILED()
+#endif
+
+#ifndef traceMEM_POOL_CREATE
+	#define traceMEM_POOL_CREATE( pxMemPool )
+#endif
+
+#ifndef traceMEM_POOL_DELETE
+	#define traceMEM_POOL_DELETE( xMemPool )
+#endif
+
+#ifndef traceMEM_POOL_ALLOC_FAILED
+	#define traceMEM_POOL_ALLOC_FAILED( xMemPool )
+#endif
+
+#ifndef traceRW_LOCK_CREATE_FAILED
+	#define traceRW_LOCK_CREATE_FAILED()
+#endif
+
+#ifndef traceRW_LOCK_CREATE
+	#define traceRW_LOCK_CREATE( pxRwLock )
+#endif
+
+#ifndef traceRW_LOCK_DELETE
+	#define traceRW_LOCK_DELETE( xRwLock )
+#endif
+
+#ifndef traceRW_LOCK_READ_FAILED
+	#define traceRW_LOCK_READ_FAILED( xRwLock )
+#endif
+
+#ifndef traceRW_LOCK_WRITE_FAILED
+	#define traceRW_LOCK_WRITE_FAILED( xRwLock )
+#endif
+
+#ifndef traceWORK_QUEUE_CREATE_FAILED
+	#define traceWORK_QUEUE_CREATE_FAILED()
+#endif
+
+#ifndef traceWORK_QUEUE_CREATE
+	#define traceWORK_QUEUE_CREATE( pxWorkQueue )
+#endif
+
+#ifndef traceWORK_ITEM_SUBMIT
+	#define traceWORK_ITEM_SUBMIT( pxWorkQueue, pxWorkItem )
+#endif
+
+#ifndef traceWORK_ITEM_EXECUTE
+	#define traceWORK_ITEM_EXECUTE( pxWorkQueue, pxWorkItem )
+#endif
+
 #ifndef configGENERATE_RUN_TIME_STATS
 	#define configGENERATE_RUN_TIME_STATS 0
 #endif
@@ -806,6 +1049,10 @@ extern "C" {
 	#define configUSE_TASK_NOTIFICATIONS 1
 #endif
 
+#ifndef configUSE_MEM_POOL_GUARDS
+	#define configUSE_MEM_POOL_GUARDS 0
+#endif
+
 #ifndef configUSE_POSIX_ERRNO
 	#define configUSE_POSIX_ERRNO 0
 #endif
@@ -837,6 +1084,23 @@ extern "C" {
 	#define configMESSAGE_BUFFER_LENGTH_TYPE size_t
 #endif
 
+#ifndef configNUM_CORES
+	/* Defaults to 1 for backward compatibility.  Set to a value greater than 1
+	to run the symmetric multiprocessing (SMP) scheduler, in which case the
+	port must provide the SMP port macros checked below. */
+	#define configNUM_CORES 1
+#endif
+
+#ifndef configUSE_CORE_AFFINITY
+	#define configUSE_CORE_AFFINITY 0
+#endif
+
+#if( configNUM_CORES == 1 )
+	#ifndef portGET_CORE_ID
+		#define portGET_CORE_ID() 0
+	#endif
+#endif
+
 /* Sanity check the configuration. */
 #if( configUSE_TICKLESS_IDLE != 0 )
 	#if( INCLUDE_vTaskSuspend != 1 )
@@ -852,6 +1116,53 @@ extern "C" {
 	#error configUSE_MUTEXES must be set to 1 to use recursive mutexes
 #endif
 
+#if( configNUM_CORES > 1 )
+	/* The SMP scheduler needs the port to identify the executing core, to
+	interrupt another core so it reschedules, and to provide two spinlocks that
+	can be taken recursively by the core that already holds them.  The task lock
+	serialises access to the scheduler between tasks, the ISR lock between
+	interrupts, and both are held inside a task level critical section.  The
+	port must also map portENTER_CRITICAL() and portEXIT_CRITICAL() onto
+	vTaskEnterCritical() and vTaskExitCritical(), and allow
+	portSET_INTERRUPT_MASK_FROM_ISR() to be called from tasks as well as from
+	interrupts. */
+	#ifndef portGET_CORE_ID
+		#error portGET_CORE_ID() must be defined by the port when configNUM_CORES is greater than 1
+	#endif
+
+	#ifndef portYIELD_CORE
+		#error portYIELD_CORE( xCoreID ) must be defined by the port when configNUM_CORES is greater than 1
+	#endif
+
+	#if( !defined( portGET_TASK_LOCK ) || !defined( portRELEASE_TASK_LOCK ) )
+		#error portGET_TASK_LOCK() and portRELEASE_TASK_LOCK() must be defined by the port when configNUM_CORES is greater than 1
+	#endif
+
+	#if( !defined( portGET_ISR_LOCK ) || !defined( portRELEASE_ISR_LOCK ) )
+		#error portGET_ISR_LOCK() and portRELEASE_ISR_LOCK() must be defined by the port when configNUM_CORES is greater than 1
+	#endif
+
+	#if( configUSE_PORT_OPTIMISED_TASK_SELECTION != 0 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION must be 0 when configNUM_CORES is greater than 1
+	#endif
+
+	#if( configUSE_TICKLESS_IDLE != 0 )
+		#error configUSE_TICKLESS_IDLE must be 0 when configNUM_CORES is greater than 1
+	#endif
+
+	#if( portCRITICAL_NESTING_IN_TCB == 1 )
+		#error portCRITICAL_NESTING_IN_TCB must be 0 when configNUM_CORES is greater than 1 as the kernel tracks the nesting per core
+	#endif
+
+	#if( ( configUSE_NEWLIB_REENTRANT != 0 ) || ( configUSE_POSIX_ERRNO != 0 ) )
+		#error configUSE_NEWLIB_REENTRANT and configUSE_POSIX_ERRNO switch a single global on each context switch so cannot be used when configNUM_CORES is greater than 1
+	#endif
+#else
+	#if( configUSE_CORE_AFFINITY != 0 )
+		#error configUSE_CORE_AFFINITY can only be set to 1 when configNUM_CORES is greater than 1
+	#endif
+#endif /* configNUM_CORES */
+
 #ifndef configINITIAL_TICK_COUNT
 	#define configINITIAL_TICK_COUNT 0
 #endif
@@ -1044,6 +1355,15 @@ typedef struct xSTATIC_TCB
 	#if ( configUSE_POSIX_ERRNO == 1 )
 		int				iDummy22;
 	#endif
+	#if ( configUSE_HEAP_PROFILER == 1 )
+		UBaseType_t		uxDummy25;
+	#endif
+	#if ( configNUM_CORES > 1 )
+		BaseType_t		xDummy23;
+		#if ( configUSE_CORE_AFFINITY == 1 )
+			UBaseType_t	uxDummy24;
+		#endif
+	#endif
 } StaticTask_t;
 
 /*
@@ -1167,7 +1487,7 @@ typedef struct xSTATIC_TIMER
 */
 typedef struct xSTATIC_STREAM_BUFFER
 {
-	size_t uxDummy1[ 4 ];
+	size_t uxDummy1[ 8 ];
 	void * pvDummy2[ 3 ];
 	uint8_t ucDummy3;
 	#if ( configUSE_TRACE_FACILITY == 1 )
@@ -1178,6 +1498,66 @@ typedef struct xSTATIC_STREAM_BUFFER
 /* Message buffers are built on stream buffers. */
 typedef StaticStreamBuffer_t StaticMessageBuffer_t;
 
+/*
+ * The StaticRingBuffer_t structure below is provided so the application writer
+ * can statically allocate the memory required to create a ring buffer.  As
+ * with the other static structures, its size and alignment requirements are
+ * guaranteed to match those of the genuine structure.
+ */
+typedef struct xSTATIC_RING_BUFFER
+{
+	UBaseType_t uxDummy1[ 3 ];
+	size_t xDummy2[ 2 ];
+	void * pvDummy3[ 2 ];
+	StaticList_t xDummy4;
+	UBaseType_t uxDummy5;
+	uint8_t ucDummy6;
+	#if ( configUSE_TRACE_FACILITY == 1 )
+		UBaseType_t uxDummy7;
+	#endif
+} StaticRingBuffer_t;
+
+/*
+ * The StaticMemPool_t structure below is provided so the application writer
+ * can statically allocate the memory required to create a memory pool.  Its
+ * size and alignment requirements are guaranteed to match those of the genuine
+ * structure.
+ */
+typedef struct xSTATIC_MEM_POOL
+{
+	void * pvDummy1[ 2 ];
+	size_t xDummy2[ 2 ];
+	UBaseType_t uxDummy3[ 7 ];
+	void * pvDummy4;
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+		StaticSemaphore_t xDummy5;
+	#endif
+	uint8_t ucDummy6;
+	#if ( configUSE_TRACE_FACILITY == 1 )
+		UBaseType_t uxDummy7;
+	#endif
+} StaticMemPool_t;
+
+/*
+ * The StaticRwLock_t structure below is provided so the application writer
+ * can statically allocate the memory required to create a reader-writer lock.
+ * Its size and alignment requirements are guaranteed to match those of the
+ * genuine structure.
+ */
+typedef struct xSTATIC_RW_LOCK
+{
+	void * pvDummy1;
+	UBaseType_t uxDummy2[ 9 ];
+	void * pvDummy3[ 2 ];
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+		StaticSemaphore_t xDummy4[ 2 ];
+	#endif
+	uint8_t ucDummy5[ 2 ];
+	#if ( configUSE_TRACE_FACILITY == 1 )
+		UBaseType_t uxDummy6;
+	#endif
+} StaticRwLock_t;
+
 #ifdef __cplusplus
 }
 #endif
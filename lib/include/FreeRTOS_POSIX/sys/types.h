@@ -114,6 +114,20 @@ typedef void                * pthread_barrierattr_t;
     typedef PthreadMutexAttrType_t  pthread_mutexattr_t;
 #endif
 
+/**
+ * @brief Used for read-write locks.
+ */
+#if !defined( posixconfigENABLE_PTHREAD_RWLOCK_T ) || ( posixconfigENABLE_PTHREAD_RWLOCK_T == 1 )
+    typedef PthreadRwlockType_t pthread_rwlock_t;
+#endif
+
+/**
+ * @brief Used to identify a read-write lock attributes object.
+ */
+#if !defined( posixconfigENABLE_PTHREAD_RWLOCK_T ) || ( posixconfigENABLE_PTHREAD_RWLOCK_T == 1 )
+    typedef void            * pthread_rwlockattr_t;
+#endif
+
 /**
  * @brief Used to identify a thread.
  */
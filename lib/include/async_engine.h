@@ -0,0 +1,333 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * An async engine runs many lightweight async tasks cooperatively inside a
+ * single FreeRTOS task, the engine's host task.  An async task is a function
+ * written as a state machine with the asyncSTART() and asyncEND() macros.  The
+ * await macros below save the point the function has reached and return to the
+ * engine, which calls the function again, resuming from that point, when the
+ * awaited event occurs.  As async tasks return to the engine instead of
+ * blocking, they share the host task's stack, and each only needs the memory
+ * for its AsyncTask_t structure and whatever state it keeps outside of its
+ * stack.
+ *
+ * Async tasks can await:
+ *  + Data in a queue, or a semaphore, that has been added to the engine with
+ *    xAsyncEngineAddObject().  FreeRTOS+TCP sockets can be awaited by giving
+ *    the socket a semaphore with the FREERTOS_SO_SET_SEMAPHORE socket option
+ *    and adding the semaphore to the engine.
+ *  + Space in any queue, which is polled once a tick.
+ *  + Notifications sent with vAsyncTaskNotify() from tasks, interrupts or other
+ *    async tasks.
+ *  + The end of a delay.
+ * Every await other than a delay can have a timeout, and a timeout of
+ * portMAX_DELAY waits indefinitely.
+ *
+ * The engine waits for events with xQueueSelectFromSet(), so
+ * configUSE_QUEUE_SETS must be set to 1 in FreeRTOSConfig.h, and each queue or
+ * semaphore added to the engine must be empty when it is added and must only
+ * be read by the engine's async tasks.  Async tasks run in the order they
+ * become ready, and each runs until it awaits, so an async task must never call
+ * an API function that blocks.
+ *
+ * As with co-routines, local variables of an async task function are not
+ * preserved across an await, so must be static or held in the structure passed
+ * as the task's parameter, and the await macros can only be used in the async
+ * task function itself, not in functions it calls, and not inside a switch
+ * statement.
+ *
+ * configUSE_ASYNC_ENGINE must be set to 1 in FreeRTOSConfig.h to use async
+ * engines.
+ *
+ * Example usage:
+   <pre>
+	static void prvEchoTask( AsyncTask_t *pxTask, void *pvParameters )
+	{
+	EchoContext_t *pxContext = ( EchoContext_t * ) pvParameters;
+
+		asyncSTART( pxTask );
+
+		for( ;; )
+		{
+			asyncQUEUE_RECEIVE( pxTask, pxContext->xQueue, &( pxContext->ulItem ), portMAX_DELAY, &( pxContext->xResult ) );
+			vAsyncTaskNotify( pxContext->pxReplyTask, pxContext->ulItem );
+		}
+
+		asyncEND( pxTask );
+	}
+   </pre>
+ */
+
+#ifndef ASYNC_ENGINE_H
+#define ASYNC_ENGINE_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include async_engine.h"
+#endif
+
+#include "list.h"
+#include "task.h"
+#include "queue.h"
+
+#if( configUSE_QUEUE_SETS != 1 )
+	#error configUSE_QUEUE_SETS must be set to 1 in FreeRTOSConfig.h to use async engines
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which async engines are referenced.  For example, a call to
+ * xAsyncEngineCreate() returns an AsyncEngineHandle_t variable that can then be
+ * used as a parameter to vAsyncTaskStart(), vAsyncEngineRun(), etc.
+ */
+struct AsyncEngineDef_t;
+typedef struct AsyncEngineDef_t * AsyncEngineHandle_t;
+
+struct xASYNC_TASK;
+
+/*
+ * Defines the prototype to which async task functions must conform.
+ */
+typedef void (*AsyncTaskFunction_t)( struct xASYNC_TASK *, void * );
+
+/*
+ * Describes one async task.  The application allocates the structure, which
+ * must remain valid until the task ends, and starts the task with
+ * vAsyncTaskStart().  Only uxState is used outside of the engine
+ * implementation, by the macros below.  The structure is the only memory the
+ * engine needs for each async task.
+ */
+typedef struct xASYNC_TASK
+{
+	UBaseType_t uxState;				/* The point the task function resumes from.  0 before the task first runs. */
+	AsyncTaskFunction_t pxFunction;
+	void *pvParameters;
+	ListItem_t xStateListItem;			/* Links the task into the engine's delayed list while an await can time out. */
+	ListItem_t xEventListItem;			/* Links the task into the list of tasks awaiting a queue or semaphore. */
+	TimeOut_t xTimeOut;					/* When the current await started. */
+	TickType_t xTicksToWait;			/* The timeout of the current await. */
+	volatile uint32_t ulNotifiedValue;
+	struct xASYNC_TASK *pxNextReady;	/* Links the task into the engine's ready list. */
+	struct xASYNC_TASK *pxNextPending;	/* Links the task into the engine's pending list. */
+	struct AsyncEngineDef_t *pxEngine;
+	uint8_t ucBlockedOn;				/* What the task is waiting for, if anything. */
+	uint8_t ucTimeOutSet;				/* pdTRUE once xTimeOut holds the start of the current await. */
+	volatile uint8_t ucPending;			/* pdTRUE while the task is in the engine's pending list. */
+} AsyncTask_t;
+
+/* The value of uxState once an async task has ended.  The await macros use the
+line number they appear on as the state, which can never be this large. */
+#define asyncSTATE_ENDED			( ( UBaseType_t ) 0xffffU )
+
+/* Returned by the functions the await macros call when the task must wait. */
+#define asyncWOULD_BLOCK			( ( BaseType_t ) 2 )
+
+/**
+ * async_engine.h
+ *
+<pre>
+AsyncEngineHandle_t xAsyncEngineCreate( UBaseType_t uxEventQueueLength );
+</pre>
+ *
+ * Creates an async engine.  The engine does not run until vAsyncEngineRun() is
+ * called from the task that will host it.  Engines cannot be deleted.
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xAsyncEngineCreate() to be available.
+ *
+ * @param uxEventQueueLength The sum of the lengths of every queue, and the
+ * maximum counts of every semaphore, that will be added to the engine with
+ * xAsyncEngineAddObject().  This is the length of the engine's queue set.
+ *
+ * @return The handle of the engine, or NULL if there was not enough heap to
+ * create it.
+ */
+AsyncEngineHandle_t xAsyncEngineCreate( UBaseType_t uxEventQueueLength ) PRIVILEGED_FUNCTION;
+
+/**
+ * async_engine.h
+ *
+<pre>
+BaseType_t xAsyncEngineAddObject( AsyncEngineHandle_t xEngine, QueueSetMemberHandle_t xObject );
+</pre>
+ *
+ * Adds a queue or semaphore to the engine, so the engine's async tasks can
+ * await it with asyncQUEUE_RECEIVE() or asyncSEMAPHORE_TAKE().  The object must
+ * be empty, must not already be in a queue set, and once added must only be
+ * read by the engine's async tasks.  Must be called before vAsyncEngineRun(),
+ * or from one of the engine's async tasks.  Objects cannot be removed.
+ *
+ * @return pdPASS if the object was added, otherwise pdFAIL.
+ */
+BaseType_t xAsyncEngineAddObject( AsyncEngineHandle_t xEngine, QueueSetMemberHandle_t xObject ) PRIVILEGED_FUNCTION;
+
+/**
+ * async_engine.h
+ *
+<pre>
+void vAsyncEngineRun( AsyncEngineHandle_t xEngine );
+</pre>
+ *
+ * Runs the engine's async tasks, blocking the calling task while none are
+ * ready to run.  Must only be called by one task, which becomes the engine's
+ * host task.  Never returns.
+ */
+void vAsyncEngineRun( AsyncEngineHandle_t xEngine ) PRIVILEGED_FUNCTION;
+
+/**
+ * async_engine.h
+ *
+<pre>
+void vAsyncTaskStart( AsyncEngineHandle_t xEngine, AsyncTask_t *pxTask, AsyncTaskFunction_t pxFunction, void *pvParameters );
+</pre>
+ *
+ * Starts an async task.  Can be called from any task, from an async task, or
+ * before the engine runs.  The task first runs the next time the engine looks
+ * for ready tasks.
+ *
+ * @param pxTask The structure that holds the async task's state, which must
+ * remain valid until the task ends.  The structure can be reused once the task
+ * has ended, provided nothing still holds a pointer to it that it could use to
+ * notify the task.
+ *
+ * @param pxFunction The async task function.
+ *
+ * @param pvParameters Passed into the function each time it is called.
+ */
+void vAsyncTaskStart( AsyncEngineHandle_t xEngine, AsyncTask_t *pxTask, AsyncTaskFunction_t pxFunction, void *pvParameters ) PRIVILEGED_FUNCTION;
+
+/**
+ * async_engine.h
+ *
+<pre>
+void vAsyncTaskNotify( AsyncTask_t *pxTask, uint32_t ulBits );
+void vAsyncTaskNotifyFromISR( AsyncTask_t *pxTask, uint32_t ulBits, BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Sets ulBits in the notification value of an async task, waking the task if
+ * it is awaiting a notification with asyncNOTIFY_WAIT().  vAsyncTaskNotify()
+ * can be called from tasks and async tasks, and vAsyncTaskNotifyFromISR() from
+ * interrupts.
+ */
+void vAsyncTaskNotify( AsyncTask_t *pxTask, uint32_t ulBits ) PRIVILEGED_FUNCTION;
+void vAsyncTaskNotifyFromISR( AsyncTask_t *pxTask, uint32_t ulBits, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * The functions used by the macros below.  They are not intended to be called
+ * directly.
+ */
+void vAsyncTaskBeginWait( AsyncTask_t *pxTask, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+void vAsyncTaskDelay( AsyncTask_t *pxTask, TickType_t xTicksToDelay ) PRIVILEGED_FUNCTION;
+void vAsyncTaskYield( AsyncTask_t *pxTask ) PRIVILEGED_FUNCTION;
+BaseType_t xAsyncTaskQueueReceive( AsyncTask_t *pxTask, QueueHandle_t xQueue, void *pvBuffer ) PRIVILEGED_FUNCTION;
+BaseType_t xAsyncTaskQueueSend( AsyncTask_t *pxTask, QueueHandle_t xQueue, const void *pvItem ) PRIVILEGED_FUNCTION;
+BaseType_t xAsyncTaskSemaphoreTake( AsyncTask_t *pxTask, QueueHandle_t xSemaphore ) PRIVILEGED_FUNCTION;
+BaseType_t xAsyncTaskNotifyWait( AsyncTask_t *pxTask, uint32_t *pulValue ) PRIVILEGED_FUNCTION;
+
+/*
+ * Resumes the point the task function last awaited at.  Must be the first
+ * statement of the async task function.
+ */
+#define asyncSTART( pxTask )		switch( ( pxTask )->uxState ) { case 0:
+
+/*
+ * Ends the async task function.  Must be the last statement of the async task
+ * function.  The engine forgets the task once the function reaches this point,
+ * after which its AsyncTask_t structure can be reused.
+ */
+#define asyncEND( pxTask )			default: break; } ( pxTask )->uxState = asyncSTATE_ENDED; return
+
+/*
+ * Saves the current line as the point to resume from and returns to the
+ * engine.  Used by the await macros.
+ */
+#define asyncAWAIT_POINT( pxTask )	( pxTask )->uxState = ( UBaseType_t ) __LINE__; return; case __LINE__:
+
+/*
+ * Lets other ready async tasks run before the calling async task continues.
+ */
+#define asyncYIELD( pxTask )		vAsyncTaskYield( ( pxTask ) ); asyncAWAIT_POINT( ( pxTask ) )
+
+/*
+ * Waits xTicksToDelay ticks.  As with vTaskDelay(), the delay is measured from
+ * the most recent tick, so can be up to one tick shorter than requested.
+ */
+#define asyncDELAY( pxTask, xTicksToDelay )		vAsyncTaskDelay( ( pxTask ), ( xTicksToDelay ) ); asyncAWAIT_POINT( ( pxTask ) )
+
+/*
+ * Waits up to xTicksToWait ticks for an item in xQueue, which must have been
+ * added to the engine, and copies it to pvBuffer.  *pxResult is set to pdPASS
+ * if an item was received, otherwise errQUEUE_EMPTY.
+ */
+#define asyncQUEUE_RECEIVE( pxTask, xQueue, pvBuffer, xTicksToWait, pxResult )								\
+	vAsyncTaskBeginWait( ( pxTask ), ( xTicksToWait ) );													\
+	( pxTask )->uxState = ( UBaseType_t ) __LINE__; case __LINE__:											\
+	*( pxResult ) = xAsyncTaskQueueReceive( ( pxTask ), ( xQueue ), ( pvBuffer ) );							\
+	if( *( pxResult ) == asyncWOULD_BLOCK ) { return; }
+
+/*
+ * Waits up to xTicksToWait ticks for space in xQueue, then copies pvItem to
+ * the back of the queue.  The queue need not have been added to the engine, as
+ * space is polled for once a tick.  *pxResult is set to pdPASS if the item was
+ * sent, otherwise errQUEUE_FULL.
+ */
+#define asyncQUEUE_SEND( pxTask, xQueue, pvItem, xTicksToWait, pxResult )									\
+	vAsyncTaskBeginWait( ( pxTask ), ( xTicksToWait ) );													\
+	( pxTask )->uxState = ( UBaseType_t ) __LINE__; case __LINE__:											\
+	*( pxResult ) = xAsyncTaskQueueSend( ( pxTask ), ( xQueue ), ( pvItem ) );								\
+	if( *( pxResult ) == asyncWOULD_BLOCK ) { return; }
+
+/*
+ * Waits up to xTicksToWait ticks to take xSemaphore, which must have been
+ * added to the engine.  *pxResult is set to pdPASS if the semaphore was taken,
+ * otherwise pdFAIL.
+ */
+#define asyncSEMAPHORE_TAKE( pxTask, xSemaphore, xTicksToWait, pxResult )									\
+	vAsyncTaskBeginWait( ( pxTask ), ( xTicksToWait ) );													\
+	( pxTask )->uxState = ( UBaseType_t ) __LINE__; case __LINE__:											\
+	*( pxResult ) = xAsyncTaskSemaphoreTake( ( pxTask ), ( xSemaphore ) );									\
+	if( *( pxResult ) == asyncWOULD_BLOCK ) { return; }
+
+/*
+ * Waits up to xTicksToWait ticks for the task's notification value to be
+ * non-zero, then copies the value to *pulValue and clears it.  *pxResult is set
+ * to pdPASS if a notification was received, otherwise pdFAIL.
+ */
+#define asyncNOTIFY_WAIT( pxTask, pulValue, xTicksToWait, pxResult )										\
+	vAsyncTaskBeginWait( ( pxTask ), ( xTicksToWait ) );													\
+	( pxTask )->uxState = ( UBaseType_t ) __LINE__; case __LINE__:											\
+	*( pxResult ) = xAsyncTaskNotifyWait( ( pxTask ), ( pulValue ) );										\
+	if( *( pxResult ) == asyncWOULD_BLOCK ) { return; }
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( ASYNC_ENGINE_H ) */
@@ -75,6 +75,10 @@ typedef struct
  * 4. GGD_ConnectToHost with auto slection parameters set to true.
  * The buffer size of pcBuffer need to be big enough to hold the complete
  * JSON file.
+ * If ggdconfigENABLE_DISCOVERY_CACHE is 1, the core found is remembered and
+ * the next call tries it first, revalidating it with discovery once
+ * ggdconfigDISCOVERY_CACHE_TTL_SECONDS have passed. The host address and
+ * certificate returned are then copied into pcBuffer.
  *
  * @param [in] pcBuffer: Memory buffer provided by the user.
  *
@@ -89,6 +93,14 @@ BaseType_t GGD_GetGGCIPandCertificate( char * pcBuffer,
                                        const uint32_t ulBufferSize,
                                        GGD_HostAddressData_t * pxHostAddressData );
 
+/*
+ * @brief Forget the core remembered by GGD_GetGGCIPandCertificate().
+ *
+ * The next call to GGD_GetGGCIPandCertificate() makes a full discovery
+ * request. Does nothing if ggdconfigENABLE_DISCOVERY_CACHE is 0.
+ */
+void GGD_DiscoveryCacheInvalidate( void );
+
 /*
  * @brief HTML request to get the JSON file from the could.
  *
@@ -144,7 +144,8 @@ typedef enum
     eMQTTDisconnectReasonMalformedPacket,         /**< The client was disconnected because a malformed packet was received. */
     eMQTTDisconnectReasonBrokerRefusedConnection, /**< The client was disconnected because broker refused the connection request. */
     eMQTTDisconnectReasonUserRequest,             /**< The client was disconnected on user request. */
-    eMQTTDisconnectReasonConnectTimeout           /**< The client was disconnected because an expected CONNACK was not received. */
+    eMQTTDisconnectReasonConnectTimeout,          /**< The client was disconnected because an expected CONNACK was not received. */
+    eMQTTDisconnectReasonRxTimeout                /**< The client was disconnected because the rest of a partially received packet did not arrive in time. */
 } MQTTDisconnectReason_t;
 
 /**
@@ -256,7 +257,7 @@ typedef struct MQTTPublishData
     uint16_t usTopicLength;     /**< Length of the topic. */
     const void * pvData;        /**< The received message. */
     uint32_t ulDataLength;      /**< Length of the message. */
-    MQTTBufferHandle_t xBuffer; /**< The buffer containing the whole MQTT message. Both pcTopic and pvData are pointers to the locations in this buffer. */
+    MQTTBufferHandle_t xBuffer; /**< The buffer containing the whole MQTT message. Both pcTopic and pvData are pointers to the locations in this buffer. NULL if the message was dispatched in place (see mqttconfigENABLE_IN_PLACE_PUBLISH_DISPATCH), in which case pcTopic and pvData point into the data passed to MQTT_ParseReceivedData and are only valid until the callback returns. */
 } MQTTPublishData_t;
 
 /**
@@ -462,6 +463,8 @@ typedef struct MQTTRxMessageState
     MQTTRxMessageAction_t xRxMessageAction; /**< Whether the current Rx message is being stored or dropped. Valid only after the fixed header has been received i.e. xRxNextByte is eMQTTRxNextByteMessage. @see MQTTRxMessageAction_t. */
     uint8_t ucRemaingingLengthFieldBytes;   /**< The number of bytes the "Remaining Length" field spans. Valid only after the fixed header has been received i.e. xRxNextByte is eMQTTRxNextByteMessage. */
     uint32_t ulTotalMessageLength;          /**< The total length of the message. Valid only after the fixed header has been received i.e. xRxNextByte is eMQTTRxNextByteMessage. */
+    uint64_t xLastReceivedTimestamp;        /**< The time-stamp when the last bytes of a partially received message arrived. Valid only if xRxNextByte is not eMQTTRxNextBytePacketType. */
+    uint32_t ulRemainingTimeoutTicks;       /**< The ticks left before a partially received message times out. Valid only if xRxNextByte is not eMQTTRxNextBytePacketType. */
 } MQTTRxMessageState_t;
 
 /**
@@ -154,6 +154,8 @@ typedef uint32_t OTA_Err_t;
 #define kOTA_Err_UserAbort               0x28000000UL     /*!< User aborted the active OTA. */
 #define kOTA_Err_ResetNotSupported       0x29000000UL     /*!< We tried to reset the device but the device doesn't support it. */
 #define kOTA_Err_TopicTooLarge           0x2a000000UL     /*!< Attempt to build a topic string larger than the supplied buffer. */
+#define kOTA_Err_DeltaUnsupported        0x2b000000UL     /*!< The file is a delta update patch but delta updates are not enabled. */
+#define kOTA_Err_DeltaBaseMismatch       0x2c000000UL     /*!< The delta update patch is against a version other than the running one. */
 
 /**
  * @brief OTA Job callback events.
@@ -237,6 +239,16 @@ typedef struct
     uint8_t * pucCertFilepath;    /*!< Pathname of the certificate file used to validate the receive file. */
     uint32_t ulUpdaterVersion;    /*!< Used by OTA self-test detection, the version of FW that did the update. */
     bool_t xIsInSelfTest;         /*!< True if the job is in self test mode. */
+
+    /* HTTP data plane. */
+    uint8_t * pucUpdateDataURL;                    /*!< The HTTPS URL to download the file from, or NULL to stream it over MQTT. */
+    struct OTA_HTTP_Connection * pxHTTPConnection; /*!< The connection the file is being downloaded over, if any. */
+    uint32_t ulHTTPNextBlock;                      /*!< The first block not yet asked for on the HTTP connection. */
+    uint8_t * pucHTTPBlock;                        /*!< The block being assembled from the HTTP response, so the PAL only sees whole blocks. */
+
+    /* Delta update. */
+    uint32_t ulDeltaBaseVersion;                   /*!< The application version the file is a patch against, or 0 if it's the whole image. */
+    struct OTA_DeltaPatch * pxDeltaPatch;          /*!< The patch being applied to the running image, if any. */
 } OTA_FileContext_t;
 
 
@@ -280,6 +280,44 @@ int32_t SOCKETS_Recv( Socket_t xSocket,
                       size_t xBufferLength,
                       uint32_t ulFlags );
 
+/**
+ * @brief Receive data from a TCP socket without copying it.
+ *
+ * The data is lent to the caller, decrypted in the socket's receive stream
+ * where possible when TLS is in use, and remains valid until it is released
+ * with SOCKETS_RecvRelease() or read with SOCKETS_Recv().  The next call
+ * returns the same data until then.
+ *
+ * Only implemented by the FreeRTOS+TCP port, and only called by the MQTT
+ * agent when mqttconfigENABLE_ZERO_COPY_RECEIVE is 1.
+ *
+ * @param[in] xSocket The handle of the socket from which data is being received.
+ * @param[out] ppucData Set to the first byte of the received data.
+ *
+ * @return
+ * * If the receive was successful then the number of bytes at *ppucData is
+ *   returned, which is at most one TLS record's worth when TLS is in use.
+ * * If a timeout occurred before data could be received then 0 is returned (timeout
+ *   is set using @ref SOCKETS_SO_RCVTIMEO).
+ * * If an error occurred, a negative value is returned. @ref SocketsErrors
+ */
+int32_t SOCKETS_RecvZeroCopy( Socket_t xSocket,
+                              const uint8_t ** ppucData );
+
+/**
+ * @brief Release data lent by SOCKETS_RecvZeroCopy().
+ *
+ * @param[in] xSocket The handle of the socket the data was received from.
+ * @param[in] xLength The number of bytes the caller has finished with, which
+ * may be fewer than were lent.
+ *
+ * @return
+ * * If the operation was successful, 0 is returned.
+ * * If an error occurred, a negative value is returned. @ref SocketsErrors
+ */
+int32_t SOCKETS_RecvRelease( Socket_t xSocket,
+                             size_t xLength );
+
 /**
  * @brief Transmit data to the remote socket.
  *
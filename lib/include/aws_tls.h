@@ -57,6 +57,32 @@ typedef BaseType_t ( * NetworkSend_t ) ( void * pvCallerContext,
                                          const unsigned char * pucData,
                                          size_t xDataLength );
 
+/**
+ * @brief Defines callback type for obtaining received bytes without copying
+ * them.
+ *
+ * The bytes stay in the network buffer until they are released by the
+ * NetworkRecvRelease_t callback, and the TLS library may modify them in place.
+ *
+ * @param[in] pvCallerContext Opaque context handle provided by caller.
+ * @param[out] ppucData Set to the first received byte.
+ *
+ * @return The number of bytes that follow *ppucData contiguously in memory,
+ * zero if no data was received, or a negative value on error.
+ */
+typedef BaseType_t ( * NetworkRecvZeroCopy_t ) ( void * pvCallerContext,
+                                                 unsigned char ** ppucData );
+
+/**
+ * @brief Defines callback type for releasing bytes obtained with the
+ * NetworkRecvZeroCopy_t callback.
+ *
+ * @param[in] pvCallerContext Opaque context handle provided by caller.
+ * @param[in] xLength Number of bytes to remove from the network buffer.
+ */
+typedef void ( * NetworkRecvRelease_t ) ( void * pvCallerContext,
+                                          size_t xLength );
+
 /**
  * @brief Defines parameter structure for initializing the TLS interface.
  *
@@ -69,6 +95,13 @@ typedef BaseType_t ( * NetworkSend_t ) ( void * pvCallerContext,
  * @param[in] pxNetworkSend Caller-defined network send function pointer.
  * @param[in] pvCallerContext Caller-defined context handle to be used with callback
  * functions.
+ * @param[in] pxNetworkRecvZeroCopy Optional caller-defined function pointer
+ * giving access to received bytes in the network buffer.  When it and
+ * pxNetworkRecvRelease are set, records that are held contiguously in the
+ * network buffer are decrypted where they are, rather than being copied into
+ * the TLS receive record buffer first.  May be NULL.
+ * @param[in] pxNetworkRecvRelease Caller-defined function pointer releasing
+ * bytes obtained with pxNetworkRecvZeroCopy.  May be NULL.
  */
 typedef struct xTLS_PARAMS
 {
@@ -82,8 +115,44 @@ typedef struct xTLS_PARAMS
     NetworkRecv_t pxNetworkRecv;
     NetworkSend_t pxNetworkSend;
     void * pvCallerContext;
+
+    NetworkRecvZeroCopy_t pxNetworkRecvZeroCopy;
+    NetworkRecvRelease_t pxNetworkRecvRelease;
 } TLSParams_t;
 
+/**
+ * @brief Defines the structure filled in by TLS_GetMemoryStats().
+ *
+ * The heap a connection holds while it is idle is xContextBytes plus
+ * xRecordBufferBytes, and its peak is xContextBytes plus
+ * xPeakRecordBufferBytes.  Memory that mbedTLS allocates and frees during the
+ * handshake, for certificates and key exchange, is not included.
+ *
+ * @param[out] xContextBytes Size in bytes of the TLS context.
+ * @param[out] xRecordBufferBytes Size in bytes of the record buffers currently
+ * allocated.
+ * @param[out] xPeakRecordBufferBytes Largest size in bytes of the record
+ * buffers allocated at one time since the connection was made.
+ * @param[out] xMaxFragmentLength Largest number of bytes of data sent in one
+ * record.
+ * @param[out] ulRecordBufferReleases Number of times the record buffers were
+ * freed while the connection was idle.
+ * @param[out] xBytesDecryptedInPlace Number of received bytes decrypted in the
+ * network buffer.
+ * @param[out] xBytesCopied Number of received bytes copied from the network
+ * into the receive record buffer.
+ */
+typedef struct xTLS_MEMORY_STATS
+{
+    size_t xContextBytes;
+    size_t xRecordBufferBytes;
+    size_t xPeakRecordBufferBytes;
+    size_t xMaxFragmentLength;
+    uint32_t ulRecordBufferReleases;
+    size_t xBytesDecryptedInPlace;
+    size_t xBytesCopied;
+} TLSMemoryStats_t;
+
 /**
  * @brief Initializes the TLS context.
  *
@@ -118,6 +187,36 @@ BaseType_t TLS_Recv( void * pvContext,
                      unsigned char * pucReadBuffer,
                      size_t xReadLength );
 
+/**
+ * @brief Decrypts the next received data and lends it to the caller.
+ *
+ * Unlike TLS_Recv(), the data is not copied into a caller buffer.  It remains
+ * valid until it is released by TLS_RecvRelease() or read by TLS_Recv(), and
+ * is returned again by the next call until then.  TLS_Send() may be called
+ * while data is lent.
+ *
+ * @param pvContext Opaque context handle for TLS library.
+ * @param ppucData Set to the first byte of decrypted data.
+ *
+ * @return Number of bytes of decrypted data at *ppucData, at most one record's
+ * worth, or zero if no data was received. Error return codes have the high
+ * bit set.
+ */
+BaseType_t TLS_RecvZeroCopy( void * pvContext,
+                             const unsigned char ** ppucData );
+
+/**
+ * @brief Releases data lent by TLS_RecvZeroCopy().
+ *
+ * @param pvContext Opaque context handle for TLS library.
+ * @param xLength Number of bytes the caller has finished with, which may be
+ * fewer than were lent.
+ *
+ * @return Zero on success. Error return codes have the high bit set.
+ */
+BaseType_t TLS_RecvRelease( void * pvContext,
+                            size_t xLength );
+
 /**
  * @brief Writes the requested number of bytes to the secure connection.
  *
@@ -131,6 +230,17 @@ BaseType_t TLS_Send( void * pvContext,
                      const unsigned char * pucMsg,
                      size_t xMsgLength );
 
+/**
+ * @brief Reports the heap held by a TLS connection.
+ *
+ * @param pvContext Opaque context handle for TLS library.
+ * @param pxStats Structure to fill in with the connection's memory use.
+ *
+ * @return Zero on success. Error return codes have the high bit set.
+ */
+BaseType_t TLS_GetMemoryStats( void * pvContext,
+                               TLSMemoryStats_t * pxStats );
+
 /**
  * @brief Frees resources consumed by the TLS context.
  *
@@ -0,0 +1,220 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * The heap profiler records every block allocated by pvPortMalloc() that has
+ * not yet been freed, with the size of the block, the address it was allocated
+ * from, the task that allocated it and a tag.  Tags identify the library or
+ * subsystem that owns the memory: a task sets its tag with uxTaskSetHeapTag()
+ * before calling into a library, and every block the task allocates is
+ * recorded against that tag until the tag is changed back.  The current and
+ * peak number of bytes allocated are kept for each tag and each task.
+ *
+ * Set configUSE_HEAP_PROFILER to 1 in FreeRTOSConfig.h to use the profiler.
+ * This header is then included by FreeRTOS.h, and defines the traceMALLOC()
+ * and traceFREE() macros, which the application must not define.  The profiler
+ * works with any of the heap implementations.  Sizes are the sizes passed to
+ * traceMALLOC(), which for heap_2.c, heap_4.c and heap_5.c include the block
+ * header and alignment padding, so the sum of the sizes matches the change in
+ * xPortGetFreeHeapSize().
+ *
+ * Blocks are recorded in a fixed size table of configHEAP_PROFILER_ALLOCATIONS
+ * entries, so the profiler never allocates memory itself.  Recording or
+ * removing a block takes a short critical section and a hash table lookup.
+ * If the table is full new blocks are counted as untracked and are not
+ * included in the tag and task totals.
+ *
+ * vHeapProfilerGetSnapshot() captures the totals at a point in time.  The
+ * blocks allocated after a snapshot that have not been freed, which are
+ * typically leaks, can then be read with uxHeapProfilerGetAllocations() or
+ * written with vHeapProfilerDump().  The dump is a line based text format that
+ * can be sent over the logging interface and analysed, and compared with other
+ * dumps, by tools/heap_profiler/heap_report.py.
+ */
+
+#ifndef HEAP_PROFILER_H
+#define HEAP_PROFILER_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include heap_profiler.h"
+#endif
+
+/* The profiler defines these macros, so they cannot also be defined by the
+application. */
+#if defined( traceMALLOC ) || defined( traceFREE )
+	#error traceMALLOC() and traceFREE() must not be defined in FreeRTOSConfig.h when the heap profiler is used
+#endif
+
+#if( INCLUDE_xTaskGetCurrentTaskHandle != 1 )
+	#error INCLUDE_xTaskGetCurrentTaskHandle must be set to 1 in FreeRTOSConfig.h to use the heap profiler
+#endif
+
+#if( ( INCLUDE_xTaskGetSchedulerState != 1 ) && ( configUSE_TIMERS != 1 ) )
+	#error INCLUDE_xTaskGetSchedulerState must be set to 1 in FreeRTOSConfig.h to use the heap profiler
+#endif
+
+#if( ( configHEAP_PROFILER_ALLOCATIONS & ( configHEAP_PROFILER_ALLOCATIONS - 1 ) ) != 0 )
+	#error configHEAP_PROFILER_ALLOCATIONS must be a power of 2
+#endif
+
+#if( ( configHEAP_PROFILER_TAGS < 1 ) || ( configHEAP_PROFILER_TAGS > 256 ) )
+	#error configHEAP_PROFILER_TAGS must be between 1 and 256
+#endif
+
+#if( configHEAP_PROFILER_TASKS > 255 )
+	#error configHEAP_PROFILER_TASKS must not be greater than 255
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/* The version of the dump format, which is checked by the analysis tool. */
+#define hpDUMP_VERSION					( 1U )
+
+/* The tag tasks start with, used for memory that is not allocated on behalf of
+a particular library. */
+#define hpTAG_NONE						( 0U )
+
+/* The task index recorded against blocks that were allocated before the
+scheduler started, or after the task table filled. */
+#define hpNO_TASK						( 0xffU )
+
+/* The totals kept for each tag and each task. */
+typedef struct xHEAP_PROFILER_STATS
+{
+	size_t xCurrentBytes;		/* Bytes allocated and not yet freed. */
+	size_t xPeakBytes;			/* The most bytes allocated at any one time since the peaks were last reset. */
+	uint32_t ulAllocations;		/* Blocks allocated. */
+	uint32_t ulFrees;			/* Blocks freed. */
+	uint32_t ulFailures;		/* Calls to pvPortMalloc() that returned NULL. */
+} HeapProfilerStats_t;
+
+/* A task that has allocated memory.  Tasks are added to the task table the
+first time they allocate memory, and the entry is kept after the task is
+deleted so memory it did not free is still attributed to it. */
+typedef struct xHEAP_PROFILER_TASK
+{
+	void *pvTask;				/* The task's handle, or NULL if the task has been deleted or the entry is unused. */
+	char cName[ configMAX_TASK_NAME_LEN ];
+	HeapProfilerStats_t xStats;
+} HeapProfilerTask_t;
+
+/* The totals at the time vHeapProfilerGetSnapshot() was called. */
+typedef struct xHEAP_PROFILER_SNAPSHOT
+{
+	uint32_t ulSequence;		/* The sequence number that will be given to the next block allocated. */
+	uint32_t ulUntracked;		/* Blocks not recorded because the allocation table was full. */
+	UBaseType_t uxAllocations;	/* Blocks recorded in the allocation table. */
+	#if( configHEAP_PROFILER_HEAP_STATS == 1 )
+		HeapStats_t xHeapStats;	/* The free block statistics from vPortGetHeapStats(). */
+	#endif
+	HeapProfilerStats_t xTags[ configHEAP_PROFILER_TAGS ];
+} HeapProfilerSnapshot_t;
+
+/* A block that has been allocated and not freed. */
+typedef struct xHEAP_PROFILER_ALLOCATION
+{
+	void *pvAddress;			/* The address returned by pvPortMalloc(). */
+	const void *pvCallSite;		/* The return address of the call to pvPortMalloc(), from configHEAP_PROFILER_CALL_SITE(). */
+	uint32_t ulSize;			/* The size passed to traceMALLOC(). */
+	uint32_t ulSequence;		/* Blocks are numbered in the order they are allocated. */
+	uint8_t ucTag;				/* The tag of the allocating task. */
+	uint8_t ucTask;				/* The index of the allocating task in the task table, or hpNO_TASK. */
+} HeapProfilerAllocation_t;
+
+/* The type of the function vHeapProfilerDump() writes each line to.  pcLine
+is nul terminated and does not include a line ending. */
+typedef void ( * HeapProfilerWriteFunction_t )( const char *pcLine, void *pvContext );
+
+/*
+ * Record a block being allocated and freed.  These functions are called by the
+ * trace macros below and are not intended to be called directly.
+ */
+void vHeapProfilerMalloc( void *pvAddress, size_t xSize, const void *pvCallSite ) PRIVILEGED_FUNCTION;
+void vHeapProfilerFree( void *pvAddress ) PRIVILEGED_FUNCTION;
+
+/*
+ * Sets the name written for uxTag by vHeapProfilerDump().  pcName is not
+ * copied so must remain valid.
+ */
+void vHeapProfilerSetTagName( UBaseType_t uxTag, const char *pcName ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copies the profiler's totals, and the heap's free block statistics if
+ * configHEAP_PROFILER_HEAP_STATS is 1, into *pxSnapshot.  The snapshot can be
+ * passed to uxHeapProfilerGetAllocations() or vHeapProfilerDump() later to
+ * find the blocks allocated since it was taken that have not been freed.
+ */
+void vHeapProfilerGetSnapshot( HeapProfilerSnapshot_t *pxSnapshot ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copies up to uxMaxTasks entries of the task table into pxTasks and returns
+ * the number of entries copied.  The index of an entry in the table is the
+ * ucTask value recorded against the blocks the task allocated.
+ */
+UBaseType_t uxHeapProfilerGetTasks( HeapProfilerTask_t *pxTasks, UBaseType_t uxMaxTasks ) PRIVILEGED_FUNCTION;
+
+/*
+ * Sets the peak number of bytes of every tag and task to the current number of
+ * bytes, so the peak reached during a particular phase of the application can
+ * be measured.
+ */
+void vHeapProfilerResetPeaks( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copies up to uxMaxAllocations of the blocks that were allocated after
+ * pxSince was taken and have not been freed into pxAllocations, and returns
+ * the number of blocks copied.  Pass pxSince as NULL to copy every block.
+ * Blocks are copied in table order, not allocation order.
+ */
+UBaseType_t uxHeapProfilerGetAllocations( const HeapProfilerSnapshot_t *pxSince, HeapProfilerAllocation_t *pxAllocations, UBaseType_t uxMaxAllocations ) PRIVILEGED_FUNCTION;
+
+/*
+ * Writes a dump of the profiler's state to pxWrite, one line at a time.  The
+ * dump contains the heap statistics, the totals for each tag and task, and the
+ * blocks allocated after pxSince was taken that have not been freed, or every
+ * block if pxSince is NULL.  Every line starts with "heapprof" so the dump can
+ * be picked out of other logging.
+ *
+ * The blocks are read one at a time, in short critical sections, and pxWrite
+ * is called outside of any critical section so it can block.  A block that is
+ * allocated or freed while the dump is being written may therefore be written
+ * twice or missed.
+ */
+void vHeapProfilerDump( const HeapProfilerSnapshot_t *pxSince, HeapProfilerWriteFunction_t pxWrite, void *pvContext ) PRIVILEGED_FUNCTION;
+
+/* Heap trace macros recorded by the profiler.  The call site is evaluated
+inside pvPortMalloc(), so is the address pvPortMalloc() returns to. */
+#define traceMALLOC( pvAddress, uiSize )			vHeapProfilerMalloc( ( pvAddress ), ( size_t ) ( uiSize ), configHEAP_PROFILER_CALL_SITE() )
+#define traceFREE( pvAddress, uiSize )				vHeapProfilerFree( ( pvAddress ) )
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( HEAP_PROFILER_H ) */
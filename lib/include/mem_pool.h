@@ -0,0 +1,345 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Memory pools allocate blocks of one fixed size from a fixed number of blocks.
+ * Allocating and freeing a block takes the same short time however many blocks
+ * are in the pool, can be done from tasks and interrupts, and cannot fragment
+ * the pool.  A task can block to wait for a block to be freed if the pool is
+ * empty.
+ *
+ * If configUSE_MEM_POOL_GUARDS is set to 1 in FreeRTOSConfig.h then each block
+ * is surrounded by guard words, and free blocks are filled with a known
+ * pattern.  configASSERT() is then called if a block is freed twice, a block
+ * that is not in the pool is freed, a write runs off the end of a block, or a
+ * block is written to after it has been freed.
+ */
+
+#ifndef MEM_POOL_H
+#define MEM_POOL_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include mem_pool.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which memory pools are referenced.  For example, a call to
+ * xMemPoolCreate() returns a MemPoolHandle_t variable that can then be used as
+ * a parameter to pvMemPoolAlloc(), vMemPoolFree(), etc.
+ */
+struct MemPoolDef_t;
+typedef struct MemPoolDef_t * MemPoolHandle_t;
+
+/**
+ * Used with vMemPoolGetStats() to obtain the statistics of a memory pool.
+ */
+typedef struct xMEM_POOL_STATS
+{
+	size_t xBlockSize;						/* The block size the pool was created with. */
+	UBaseType_t uxBlockCount;				/* The number of blocks in the pool. */
+	UBaseType_t uxBlocksFree;				/* The number of blocks not allocated. */
+	UBaseType_t uxMinimumEverBlocksFree;	/* The least number of blocks that have been free since the pool was created. */
+	UBaseType_t uxAllocations;				/* The number of blocks allocated since the pool was created. */
+	UBaseType_t uxFailedAllocations;		/* The number of allocations that failed because the pool was empty. */
+} MemPoolStats_t;
+
+/* The number of bytes in front of and after each block used to detect misuse
+of the pool when configUSE_MEM_POOL_GUARDS is 1.  Each is a multiple of
+portBYTE_ALIGNMENT so blocks stay aligned. */
+#define mpROUND_UP_TO_ALIGNMENT( x ) ( ( ( size_t ) ( x ) + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+#if( configUSE_MEM_POOL_GUARDS == 1 )
+	#define mpGUARD_SIZE_BYTES mpROUND_UP_TO_ALIGNMENT( sizeof( UBaseType_t ) )
+#else
+	#define mpGUARD_SIZE_BYTES ( ( size_t ) 0 )
+#endif
+
+/**
+ * mem_pool.h
+ *
+ * The number of bytes each block of a memory pool occupies in the storage
+ * area.  A free block holds a pointer to the next free block, so blocks are at
+ * least the size of a pointer.
+ */
+#define mpBLOCK_SIZE_BYTES( xBlockSize ) ( mpROUND_UP_TO_ALIGNMENT( ( ( size_t ) ( xBlockSize ) > sizeof( void * ) ) ? ( size_t ) ( xBlockSize ) : sizeof( void * ) ) + ( ( size_t ) 2 * mpGUARD_SIZE_BYTES ) )
+
+/**
+ * mem_pool.h
+ *
+ * The size of the storage area that must be passed to xMemPoolCreateStatic().
+ */
+#define mpSTORAGE_SIZE_BYTES( uxBlockCount, xBlockSize ) ( ( size_t ) ( uxBlockCount ) * mpBLOCK_SIZE_BYTES( xBlockSize ) )
+
+/**
+ * mem_pool.h
+ *
+<pre>
+MemPoolHandle_t xMemPoolCreate( UBaseType_t uxBlockCount, size_t xBlockSize );
+</pre>
+ *
+ * Creates a new memory pool using dynamically allocated memory.  The structure
+ * and all the blocks are allocated by a single call to pvPortMalloc().  See
+ * xMemPoolCreateStatic() for a version that uses statically allocated memory
+ * (memory that is allocated at compile time).
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xMemPoolCreate() to be available.
+ *
+ * @param uxBlockCount The number of blocks in the pool.
+ *
+ * @param xBlockSize The size, in bytes, of each block.  Blocks are aligned to
+ * portBYTE_ALIGNMENT.
+ *
+ * @return The handle of the created memory pool, or NULL if there was
+ * insufficient heap memory available to create the pool.
+ *
+ * Example use:
+<pre>
+void vAFunction( void )
+{
+MemPoolHandle_t xMemPool;
+uint8_t *pucFrame;
+
+    // Create a pool of 8 blocks, each large enough to hold a 1536 byte
+    // network frame.
+    xMemPool = xMemPoolCreate( 8, 1536 );
+
+    if( xMemPool != NULL )
+    {
+        // Allocate a frame, waiting up to 10ms for one to be freed if they
+        // are all in use.
+        pucFrame = ( uint8_t * ) pvMemPoolAlloc( xMemPool, pdMS_TO_TICKS( 10 ) );
+
+        if( pucFrame != NULL )
+        {
+            // Use the frame here, then return it to the pool.
+            vMemPoolFree( xMemPool, pucFrame );
+        }
+    }
+}
+</pre>
+ * \defgroup xMemPoolCreate xMemPoolCreate
+ * \ingroup MemPoolManagement
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	MemPoolHandle_t xMemPoolCreate( UBaseType_t uxBlockCount, size_t xBlockSize ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * mem_pool.h
+ *
+<pre>
+MemPoolHandle_t xMemPoolCreateStatic( UBaseType_t uxBlockCount,
+                                      size_t xBlockSize,
+                                      uint8_t *pucPoolStorageArea,
+                                      StaticMemPool_t *pxStaticMemPool );
+</pre>
+ *
+ * Creates a new memory pool using statically allocated memory.  See
+ * xMemPoolCreate() for a version that uses dynamically allocated memory.
+ *
+ * configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h for
+ * xMemPoolCreateStatic() to be available.
+ *
+ * @param uxBlockCount The number of blocks in the pool.
+ *
+ * @param xBlockSize The size, in bytes, of each block.
+ *
+ * @param pucPoolStorageArea Must point to a uint8_t array that is at least
+ * mpSTORAGE_SIZE_BYTES( uxBlockCount, xBlockSize ) bytes big, and is aligned to
+ * portBYTE_ALIGNMENT.  The blocks are allocated from this array.
+ *
+ * @param pxStaticMemPool Must point to a variable of type StaticMemPool_t,
+ * which will be used to hold the memory pool's data structure.
+ *
+ * @return The handle of the created memory pool, or NULL if either
+ * pucPoolStorageArea or pxStaticMemPool are NULL.
+ *
+ * \defgroup xMemPoolCreateStatic xMemPoolCreateStatic
+ * \ingroup MemPoolManagement
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	MemPoolHandle_t xMemPoolCreateStatic( UBaseType_t uxBlockCount,
+										  size_t xBlockSize,
+										  uint8_t * const pucPoolStorageArea,
+										  StaticMemPool_t * const pxStaticMemPool ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * mem_pool.h
+ *
+<pre>
+void *pvMemPoolAlloc( MemPoolHandle_t xMemPool, TickType_t xTicksToWait );
+</pre>
+ *
+ * Allocates a block from a memory pool.  If the pool is empty the calling task
+ * can block to wait for a block to be freed.  If more than one task is blocked
+ * on the same pool then the highest priority task is the first to receive a
+ * freed block.
+ *
+ * Use pvMemPoolAllocFromISR() to allocate a block from an interrupt service
+ * routine (ISR).
+ *
+ * @param xMemPool The handle of the memory pool from which the block is being
+ * allocated.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for a block if the pool is empty.
+ *
+ * @return A pointer to the allocated block, or NULL if no block could be
+ * allocated before the block time expired.
+ *
+ * \defgroup pvMemPoolAlloc pvMemPoolAlloc
+ * \ingroup MemPoolManagement
+ */
+void *pvMemPoolAlloc( MemPoolHandle_t xMemPool, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+void *pvMemPoolAllocFromISR( MemPoolHandle_t xMemPool );
+</pre>
+ *
+ * A version of pvMemPoolAlloc() that can be called from an interrupt service
+ * routine (ISR).
+ *
+ * @param xMemPool The handle of the memory pool from which the block is being
+ * allocated.
+ *
+ * @return A pointer to the allocated block, or NULL if the pool was empty.
+ *
+ * \defgroup pvMemPoolAllocFromISR pvMemPoolAllocFromISR
+ * \ingroup MemPoolManagement
+ */
+void *pvMemPoolAllocFromISR( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+void vMemPoolFree( MemPoolHandle_t xMemPool, void *pvBlock );
+</pre>
+ *
+ * Returns a block to the memory pool from which it was allocated, unblocking
+ * the highest priority task waiting for a block if there is one.
+ *
+ * Use vMemPoolFreeFromISR() to free a block from an interrupt service routine
+ * (ISR).
+ *
+ * @param xMemPool The handle of the memory pool from which the block was
+ * allocated.
+ *
+ * @param pvBlock The block to free, as returned by pvMemPoolAlloc() or
+ * pvMemPoolAllocFromISR().
+ *
+ * \defgroup vMemPoolFree vMemPoolFree
+ * \ingroup MemPoolManagement
+ */
+void vMemPoolFree( MemPoolHandle_t xMemPool, void *pvBlock ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+void vMemPoolFreeFromISR( MemPoolHandle_t xMemPool,
+                          void *pvBlock,
+                          BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * A version of vMemPoolFree() that can be called from an interrupt service
+ * routine (ISR).
+ *
+ * @param xMemPool The handle of the memory pool from which the block was
+ * allocated.
+ *
+ * @param pvBlock The block to free.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if freeing the block unblocked
+ * a task that has a priority above the priority of the currently executing
+ * task, in which case a context switch should be requested before the
+ * interrupt is exited.  *pxHigherPriorityTaskWoken must be initialised to
+ * pdFALSE before it is passed into the function.
+ *
+ * \defgroup vMemPoolFreeFromISR vMemPoolFreeFromISR
+ * \ingroup MemPoolManagement
+ */
+void vMemPoolFreeFromISR( MemPoolHandle_t xMemPool,
+						  void *pvBlock,
+						  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+void vMemPoolGetStats( MemPoolHandle_t xMemPool, MemPoolStats_t *pxMemPoolStats );
+</pre>
+ *
+ * Obtains a consistent snapshot of a memory pool's statistics.
+ *
+ * @param xMemPool The handle of the memory pool being queried.
+ *
+ * @param pxMemPoolStats The structure into which the statistics are written.
+ *
+ * \defgroup vMemPoolGetStats vMemPoolGetStats
+ * \ingroup MemPoolManagement
+ */
+void vMemPoolGetStats( MemPoolHandle_t xMemPool, MemPoolStats_t *pxMemPoolStats ) PRIVILEGED_FUNCTION;
+
+/**
+ * mem_pool.h
+ *
+<pre>
+void vMemPoolDelete( MemPoolHandle_t xMemPool );
+</pre>
+ *
+ * Deletes a memory pool that was previously created using a call to
+ * xMemPoolCreate() or xMemPoolCreateStatic().  If the pool was created using
+ * dynamic memory then the allocated memory is freed.  No blocks can be in use,
+ * and no tasks can be blocked on the pool, when it is deleted.
+ *
+ * @param xMemPool The handle of the memory pool to be deleted.
+ *
+ * \defgroup vMemPoolDelete vMemPoolDelete
+ * \ingroup MemPoolManagement
+ */
+void vMemPoolDelete( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+
+#if( configUSE_TRACE_FACILITY == 1 )
+	void vMemPoolSetMemPoolNumber( MemPoolHandle_t xMemPool, UBaseType_t uxMemPoolNumber ) PRIVILEGED_FUNCTION;
+	UBaseType_t uxMemPoolGetMemPoolNumber( MemPoolHandle_t xMemPool ) PRIVILEGED_FUNCTION;
+#endif
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( MEM_POOL_H ) */
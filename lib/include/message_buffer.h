@@ -595,6 +595,72 @@ BaseType_t xHigherPriorityTaskWoken = pdFALSE;  // Initialised to pdFALSE.
  */
 #define xMessageBufferReceiveFromISR( xMessageBuffer, pvRxData, xBufferLengthBytes, pxHigherPriorityTaskWoken ) xStreamBufferReceiveFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pvRxData, xBufferLengthBytes, pxHigherPriorityTaskWoken )
 
+/**
+ * message_buffer.h
+ *
+<pre>
+size_t xMessageBufferSendReserve( MessageBufferHandle_t xMessageBuffer,
+                                  void **ppvTxData,
+                                  size_t xDataLengthBytes,
+                                  TickType_t xTicksToWait );
+size_t xMessageBufferSendReserveFromISR( MessageBufferHandle_t xMessageBuffer,
+                                         void **ppvTxData,
+                                         size_t xDataLengthBytes );
+size_t xMessageBufferSendCommit( MessageBufferHandle_t xMessageBuffer,
+                                 size_t xDataLengthBytes );
+size_t xMessageBufferSendCommitFromISR( MessageBufferHandle_t xMessageBuffer,
+                                        size_t xDataLengthBytes,
+                                        BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Reserves contiguous space for a message of up to xDataLengthBytes bytes so
+ * the message can be written directly into the message buffer, then commits the
+ * message once it has been written.  The message length committed can be less
+ * than the length reserved, and committing a length of 0 cancels the
+ * reservation.  The space needed to hold the message length is reserved too, so
+ * the reservation needs xDataLengthBytes + sizeof( size_t ) bytes of free
+ * contiguous space.  See xStreamBufferSendReserve() and
+ * xStreamBufferSendCommit() for a full description.
+ *
+ * \defgroup xMessageBufferSendReserve xMessageBufferSendReserve
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferSendReserve( xMessageBuffer, ppvTxData, xDataLengthBytes, xTicksToWait ) xStreamBufferSendReserve( ( StreamBufferHandle_t ) xMessageBuffer, ppvTxData, xDataLengthBytes, xTicksToWait )
+#define xMessageBufferSendReserveFromISR( xMessageBuffer, ppvTxData, xDataLengthBytes ) xStreamBufferSendReserveFromISR( ( StreamBufferHandle_t ) xMessageBuffer, ppvTxData, xDataLengthBytes )
+#define xMessageBufferSendCommit( xMessageBuffer, xDataLengthBytes ) xStreamBufferSendCommit( ( StreamBufferHandle_t ) xMessageBuffer, xDataLengthBytes )
+#define xMessageBufferSendCommitFromISR( xMessageBuffer, xDataLengthBytes, pxHigherPriorityTaskWoken ) xStreamBufferSendCommitFromISR( ( StreamBufferHandle_t ) xMessageBuffer, xDataLengthBytes, pxHigherPriorityTaskWoken )
+
+/**
+ * message_buffer.h
+ *
+<pre>
+size_t xMessageBufferReceiveAcquire( MessageBufferHandle_t xMessageBuffer,
+                                     void **ppvRxData,
+                                     TickType_t xTicksToWait );
+size_t xMessageBufferReceiveAcquireFromISR( MessageBufferHandle_t xMessageBuffer,
+                                            void **ppvRxData );
+size_t xMessageBufferReceiveRelease( MessageBufferHandle_t xMessageBuffer );
+size_t xMessageBufferReceiveReleaseFromISR( MessageBufferHandle_t xMessageBuffer,
+                                            BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Obtains a pointer to the next message so the message can be processed in
+ * place, then removes the message from the message buffer once it has been
+ * processed.  Only messages that are stored contiguously can be acquired, which
+ * is always the case for messages written using xMessageBufferSendReserve().
+ * If the next message was written by xMessageBufferSend() and wraps around the
+ * end of the storage area then 0 is returned, and the message must be read
+ * using xMessageBufferReceive() instead.  See xStreamBufferReceiveAcquire() and
+ * xStreamBufferReceiveRelease() for a full description.
+ *
+ * \defgroup xMessageBufferReceiveAcquire xMessageBufferReceiveAcquire
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferReceiveAcquire( xMessageBuffer, ppvRxData, xTicksToWait ) xStreamBufferReceiveAcquire( ( StreamBufferHandle_t ) xMessageBuffer, ppvRxData, xTicksToWait )
+#define xMessageBufferReceiveAcquireFromISR( xMessageBuffer, ppvRxData ) xStreamBufferReceiveAcquireFromISR( ( StreamBufferHandle_t ) xMessageBuffer, ppvRxData )
+#define xMessageBufferReceiveRelease( xMessageBuffer ) xStreamBufferReceiveRelease( ( StreamBufferHandle_t ) xMessageBuffer, 0 )
+#define xMessageBufferReceiveReleaseFromISR( xMessageBuffer, pxHigherPriorityTaskWoken ) xStreamBufferReceiveReleaseFromISR( ( StreamBufferHandle_t ) xMessageBuffer, 0, pxHigherPriorityTaskWoken )
+
 /**
  * message_buffer.h
  *
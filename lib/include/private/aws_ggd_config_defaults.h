@@ -77,6 +77,80 @@
     #define ggdconfigJSON_MAX_TOKENS    ( 128 )        /* Size of the array used by jsmn to store the tokens. */
 #endif
 
+/**
+ * @brief Set to 1 to remember the core found by GGD_GetGGCIPandCertificate().
+ *
+ * The next call then connects to that core straight away instead of making a
+ * discovery request, and only goes back to discovery if the core cannot be
+ * reached.
+ *
+ * Disabled by default, as a cached core may then be used for up to
+ * ggdconfigDISCOVERY_CACHE_TTL_SECONDS without asking the cloud.
+ */
+#ifndef ggdconfigENABLE_DISCOVERY_CACHE
+    #define ggdconfigENABLE_DISCOVERY_CACHE    ( 0 )
+#endif
+
+/**
+ * @brief Seconds for which a cached core is used without asking discovery.
+ *
+ * Once this has passed, the next GGD_GetGGCIPandCertificate() call makes a
+ * conditional discovery request. If the response has not changed, only its
+ * header is received and the cached core is used again.
+ */
+#ifndef ggdconfigDISCOVERY_CACHE_TTL_SECONDS
+    #define ggdconfigDISCOVERY_CACHE_TTL_SECONDS    ( 86400UL )
+#endif
+
+/**
+ * @brief Sizes of the host address, entity tag and certificate kept in the
+ * discovery cache, including the null terminators. A core that does not fit
+ * is not cached.
+ */
+/** @{ */
+#ifndef ggdconfigDISCOVERY_CACHE_HOST_SIZE
+    #define ggdconfigDISCOVERY_CACHE_HOST_SIZE    ( 128 )
+#endif
+
+#ifndef ggdconfigDISCOVERY_CACHE_ETAG_SIZE
+    #define ggdconfigDISCOVERY_CACHE_ETAG_SIZE    ( 64 )
+#endif
+
+#ifndef ggdconfigDISCOVERY_CACHE_CERTIFICATE_SIZE
+    #define ggdconfigDISCOVERY_CACHE_CERTIFICATE_SIZE    ( 2048 )
+#endif
+/** @} */
+
+/**
+ * @brief Clock used to age the discovery cache, in seconds.
+ *
+ * A clock that keeps running across resets lets a cache loaded from
+ * non-volatile memory be used without a discovery request after a power
+ * cycle. With the default tick based clock, a loaded cache is usually older
+ * than the clock and is revalidated first.
+ */
+#ifndef ggdconfigDISCOVERY_CACHE_TIME_SECONDS
+    #define ggdconfigDISCOVERY_CACHE_TIME_SECONDS()    ( ( uint32_t ) ( xTaskGetTickCount() / configTICK_RATE_HZ ) )
+#endif
+
+/**
+ * @brief Keep the discovery cache in non-volatile memory.
+ *
+ * ggdconfigDISCOVERY_CACHE_SAVE( pvData, ulSize ) is called with the cache
+ * whenever it changes, and ggdconfigDISCOVERY_CACHE_LOAD( pvData, ulSize )
+ * once to read it back, returning pdPASS if it could. The record is checked
+ * before it is used. By default the cache is only kept in RAM.
+ */
+/** @{ */
+#ifndef ggdconfigDISCOVERY_CACHE_SAVE
+    #define ggdconfigDISCOVERY_CACHE_SAVE( pvData, ulSize )    ( ( void ) ( pvData ), ( void ) ( ulSize ), pdPASS )
+#endif
+
+#ifndef ggdconfigDISCOVERY_CACHE_LOAD
+    #define ggdconfigDISCOVERY_CACHE_LOAD( pvData, ulSize )    ( ( void ) ( pvData ), ( void ) ( ulSize ), pdFAIL )
+#endif
+/** @} */
+
 #ifndef ggdconfigPRINT
     #define ggdconfigPRINT    vLoggingPrintf
 #endif
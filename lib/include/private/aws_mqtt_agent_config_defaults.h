@@ -148,6 +148,19 @@
     #define mqttconfigRX_BUFFER_SIZE    ( 1024 )
 #endif
 
+/**
+ * @brief Parse received data where the secure sockets layer holds it.
+ *
+ * If mqttconfigENABLE_ZERO_COPY_RECEIVE is set to 1, received data is read
+ * with SOCKETS_RecvZeroCopy(), which decrypts TLS records in the socket's
+ * receive stream where it can, and is parsed there rather than first being
+ * copied into the receive buffer.  Only the FreeRTOS+TCP secure sockets port
+ * implements SOCKETS_RecvZeroCopy().
+ */
+#ifndef mqttconfigENABLE_ZERO_COPY_RECEIVE
+    #define mqttconfigENABLE_ZERO_COPY_RECEIVE    ( 0 )
+#endif
+
 /**
  * @defgroup BufferPoolInterface The functions used by the MQTT client to get and return buffers.
  *
@@ -73,6 +73,41 @@
     #define mqttconfigSUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS    ( 8 )
 #endif
 
+/**
+ * @brief Dispatch received publish messages straight from the data passed to
+ * MQTT_ParseReceivedData.
+ *
+ * When a publish message is received in a single call to
+ * MQTT_ParseReceivedData, it is normally still copied into a buffer from the
+ * user supplied buffer pool so that the publish callback can take ownership of
+ * it. Setting this macro to 1 skips the copy: the callback is invoked with
+ * pucTopic and pvData pointing into the received data and with xBuffer set to
+ * NULL, and the callback must copy anything it needs and return eMQTTFalse.
+ * Messages that arrive split over several calls are still copied into a buffer
+ * from the pool.
+ *
+ * Only enable this if no publish callback takes ownership of the buffer - note
+ * that the Shadow library, through the MQTT agent, does.
+ */
+#ifndef mqttconfigENABLE_IN_PLACE_PUBLISH_DISPATCH
+    #define mqttconfigENABLE_IN_PLACE_PUBLISH_DISPATCH          ( 0 )
+#endif
+
+/**
+ * @brief The time, in ticks, to wait for the rest of a partially received
+ * packet.
+ *
+ * If no more bytes of a partially received packet arrive within this many
+ * ticks of the last ones, MQTT_Periodic disconnects the client with the reason
+ * eMQTTDisconnectReasonRxTimeout, since the byte stream can no longer be
+ * trusted to be in step with the packet boundaries. The ticks are those
+ * returned by the user supplied get ticks function. Set this to 0 to wait
+ * forever.
+ */
+#ifndef mqttconfigRX_PARTIAL_MESSAGE_TIMEOUT_TICKS
+    #define mqttconfigRX_PARTIAL_MESSAGE_TIMEOUT_TICKS          ( 5000 )
+#endif
+
 /**
  * @brief Define mqttconfigASSERT to enable asserts.
  *
@@ -0,0 +1,111 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/**
+ * @file aws_ota_agent_config_defaults.h
+ * @brief OTA agent default config options.
+ *
+ * Ensures that the config options for the OTA agent are set to sensible
+ * default values if the user does not provide one.
+ */
+#ifndef _AWS_OTA_AGENT_CONFIG_DEFAULTS_H_
+#define _AWS_OTA_AGENT_CONFIG_DEFAULTS_H_
+
+/**
+ * @brief Allow a job document to have the file downloaded over HTTPS.
+ *
+ * When enabled, a job whose file entry includes an "update_data_url" is
+ * downloaded from that URL with HTTP range requests instead of through the
+ * MQTT stream.
+ *
+ * Disabled by default so that a port only downloads over HTTPS once it has been
+ * enabled and validated on that board.
+ */
+#ifndef otaconfigENABLE_HTTP_DATA_PLANE
+    #define otaconfigENABLE_HTTP_DATA_PLANE    0
+#endif
+
+/**
+ * @brief The number of HTTP range requests kept in flight on the connection.
+ */
+#ifndef otaconfigHTTP_PIPELINE_DEPTH
+    #define otaconfigHTTP_PIPELINE_DEPTH    4U
+#endif
+
+/**
+ * @brief The number of file blocks asked for by each HTTP range request.
+ */
+#ifndef otaconfigHTTP_BLOCKS_PER_REQUEST
+    #define otaconfigHTTP_BLOCKS_PER_REQUEST    8U
+#endif
+
+/**
+ * @brief The size of the buffer that HTTP responses are received into.
+ *
+ * The headers of a response must fit in this buffer. The body is passed on
+ * to the file in pieces of at most this size.
+ */
+#ifndef otaconfigHTTP_RX_BUFFER_SIZE
+    #define otaconfigHTTP_RX_BUFFER_SIZE    1024U
+#endif
+
+/**
+ * @brief Milliseconds to wait for the HTTP server before giving up on the
+ * connection.
+ */
+#ifndef otaconfigHTTP_TIMEOUT_MS
+    #define otaconfigHTTP_TIMEOUT_MS    10000U
+#endif
+
+/**
+ * @brief The PEM certificate to trust for the HTTP server, or NULL to use the
+ * default root certificates.
+ */
+#ifndef otaconfigHTTP_SERVER_CERTIFICATE_PEM
+    #define otaconfigHTTP_SERVER_CERTIFICATE_PEM    NULL
+#endif
+
+/**
+ * @brief Allow a job to deliver the file as a patch against the running image.
+ *
+ * When enabled, a job whose file entry includes a "delta_base_version" equal
+ * to the running application version is downloaded as a delta update patch
+ * and the new image is rebuilt from the running one as the patch arrives.
+ * The platform must implement prvPAL_ReadRunningImage().
+ */
+#ifndef otaconfigENABLE_DELTA_UPDATE
+    #define otaconfigENABLE_DELTA_UPDATE    0
+#endif
+
+/**
+ * @brief The size of the buffer the new image is rebuilt in before it is
+ * written, which is also the most written by each call to prvPAL_WriteBlock().
+ */
+#ifndef otaconfigDELTA_WINDOW_SIZE
+    #define otaconfigDELTA_WINDOW_SIZE    1024U
+#endif
+
+#endif /* _AWS_OTA_AGENT_CONFIG_DEFAULTS_H_ */
@@ -51,9 +51,11 @@ typedef enum
     eIngest_Result_BadData = -8,           /* The data block from the server was malformed. */
     eIngest_Result_WriteBlockFailed = -9,  /* The PAL layer failed to write the file block. */
     eIngest_Result_NullResultPointer = -10,/* The pointer to the close result pointer was null. */
+    eIngest_Result_DeltaPatchFailed = -11, /* The delta update patch could not be applied. */
     eIngest_Result_Uninitialized = -127,   /* Software BUG: We forgot to set the result code. */
     eIngest_Result_Accepted_Continue = 0,  /* The block was accepted and we're expecting more. */
     eIngest_Result_Duplicate_Continue = 1, /* The block was a duplicate but that's OK. Continue. */
+    eIngest_Result_Deferred_Continue = 2,  /* The block is ahead of the delta update patch so it will be requested again. */
 } IngestResult_t;
 
 /* Generic JSON document parser errors. */
@@ -77,7 +79,9 @@ typedef enum
     eDocParseErr_TooManyParams,         /* The document model has more parameters than we can handle. */
     eDocParseErr_ParamKeyNotInModel,    /* The document model doesn't include the specified parameter key. */
     eDocParseErr_InvalidModelParamType, /* The document model specified an invalid parameter type. */
-    eDocParseErr_InvalidToken           /* The Jasmine token was invalid, producing a NULL pointer. */
+    eDocParseErr_InvalidToken,          /* The Jasmine token was invalid, producing a NULL pointer. */
+    eDocParseErr_InvalidSyntax,         /* The JSON document is malformed or nested too deeply. */
+    eDocParseErr_NoPerfectHash          /* No seed of the key table's hash gives each model key its own slot. */
 } DocParseErr_t;
 
 /* Document model parameter types used by the JSON document parser. */
@@ -121,6 +125,27 @@ typedef struct
 } JSON_DocParam_t;
 
 
+/* The deepest nesting of JSON objects and arrays supported by the document
+ * parser, counting the document itself. */
+#define OTA_MAX_JSON_DEPTH        32U
+
+/* The number of slots in a document model's key table. It must be a power of
+ * two and is four times the largest number of model parameters, so a seed that
+ * gives each key its own slot is quickly found. */
+#define OTA_DOC_KEY_TABLE_SIZE    128UL
+
+/* A perfect hash table of the keys of a document model. Each key of the model
+ * hashes, with the table's seed, to its own slot, so a key in the JSON document
+ * is matched by hashing it and comparing it with the one model key in its
+ * slot, rather than with every key of the model. The table depends only on the
+ * model's keys, so it is built once for each model.
+ */
+typedef struct
+{
+    uint32_t ulSeed;                                /* The seed of the key hash, or 0 if the table is not built. */
+    uint8_t ucParamIndex[ OTA_DOC_KEY_TABLE_SIZE ]; /* One more than the index of the model parameter in each slot, or 0 if empty. */
+} JSON_DocKeyTable_t;
+
 /* The document model is currently limited to 32 parameters per the implementation,
  * although it may be easily expanded to more in the future by simply expanding
  * the parameter bitmap.
@@ -132,12 +157,13 @@ typedef struct
  */
 typedef struct
 {
-    uint32_t ulContextBase;            /* The base address of the destination OTA context structure. */
-    uint32_t ulContextSize;            /* The size, in bytes, of the destination context structure. */
-    const JSON_DocParam_t * pxBodyDef; /* Pointer to the document model body definition. */
-    uint16_t usNumModelParams;         /* The number of entries in the document model (limited to 32). */
-    uint32_t ulParamsReceivedBitmap;   /* Bitmap of the parameters received based on the model. */
-    uint32_t ulParamsRequiredBitmap;   /* Bitmap of the parameters required from the model. */
+    uint32_t ulContextBase;                /* The base address of the destination OTA context structure. */
+    uint32_t ulContextSize;                /* The size, in bytes, of the destination context structure. */
+    const JSON_DocParam_t * pxBodyDef;     /* Pointer to the document model body definition. */
+    uint16_t usNumModelParams;             /* The number of entries in the document model (limited to 32). */
+    uint32_t ulParamsReceivedBitmap;       /* Bitmap of the parameters received based on the model. */
+    uint32_t ulParamsRequiredBitmap;       /* Bitmap of the parameters required from the model. */
+    const JSON_DocKeyTable_t * pxKeyTable; /* The model's key table, or NULL to build one for each document. */
 } JSON_DocModel_t;
 
 #endif /* ifndef _AWS_OTA_AGENT_INTERAL_H_ */
@@ -0,0 +1,122 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef __AWS_OTADELTA__H__
+#define __AWS_OTADELTA__H__
+
+/**
+ * @brief Applies a delta update patch to the running image as the patch arrives.
+ *
+ * A patch rebuilds the new image from the base image it was made against.
+ * All numbers in it are little endian. It starts with a header:
+ *
+ *   uint32 magic ( OTA_DELTA_MAGIC ), uint32 base image size, uint32 new image size
+ *
+ * followed by commands that produce the new image from start to end:
+ *
+ *   COPY:   uint8 0, uint32 length, uint32 base offset
+ *           The next length bytes of the new image are the base image bytes at the offset.
+ *   INSERT: uint8 1, uint32 length, length bytes
+ *           The next length bytes of the new image are in the patch.
+ *
+ * The patch must be passed on in order. The new image is written in pieces of
+ * at most otaconfigDELTA_WINDOW_SIZE bytes, which is all the RAM it needs.
+ */
+#define OTA_DELTA_MAGIC    0x44524641UL /* "AFRD" */
+
+/**
+ * @brief The result of passing patch data on.
+ */
+typedef enum
+{
+    eDelta_Applied = 0,  /* The data was used. */
+    eDelta_OutOfOrder,   /* The data starts past where the patch has got to so it wasn't used. */
+    eDelta_BadPatch,     /* The patch is malformed or doesn't fit the base image. */
+    eDelta_ReadFailed,   /* The base image could not be read. */
+    eDelta_WriteFailed,  /* The new image could not be written. */
+    eDelta_Incomplete    /* The patch ended before the whole new image was produced. */
+} OTA_DeltaResult_t;
+
+/**
+ * @brief Reads ulLength bytes of the base image at ulOffset.
+ *
+ * @return The number of bytes read, or a negative value on error.
+ */
+typedef int32_t ( * OTA_DeltaRead_t )( void * pvContext,
+                                       uint32_t ulOffset,
+                                       uint8_t * pucData,
+                                       uint32_t ulLength );
+
+/**
+ * @brief Writes ulLength bytes of the new image at ulOffset.
+ *
+ * @return The number of bytes written, or a negative value on error.
+ */
+typedef int32_t ( * OTA_DeltaWrite_t )( void * pvContext,
+                                        uint32_t ulOffset,
+                                        uint8_t * pucData,
+                                        uint32_t ulLength );
+
+/**
+ * @brief The state of a patch being applied.
+ *
+ * The structure is private to aws_ota_delta.c.
+ */
+typedef struct OTA_DeltaPatch OTA_DeltaPatch_t;
+
+/**
+ * @brief Start applying a patch.
+ *
+ * @return The patch state, or NULL if out of memory.
+ */
+OTA_DeltaPatch_t * OTA_Delta_Create( OTA_DeltaRead_t xRead,
+                                     OTA_DeltaWrite_t xWrite,
+                                     void * pvContext );
+
+/**
+ * @brief Pass on the patch bytes at ulPatchOffset.
+ *
+ * Data past where the patch has got to is not used, so the caller can get it
+ * again later. Bytes that have already been used are skipped.
+ */
+OTA_DeltaResult_t OTA_Delta_Apply( OTA_DeltaPatch_t * pxPatch,
+                                   uint32_t ulPatchOffset,
+                                   const uint8_t * pucData,
+                                   uint32_t ulLength );
+
+/**
+ * @brief Write out the rest of the new image once the whole patch has been passed on.
+ *
+ * @param[out] pulImageSize The size of the new image.
+ */
+OTA_DeltaResult_t OTA_Delta_Finish( OTA_DeltaPatch_t * pxPatch,
+                                    uint32_t * pulImageSize );
+
+/**
+ * @brief Free the patch state.
+ */
+void OTA_Delta_Delete( OTA_DeltaPatch_t * pxPatch );
+
+#endif /* ifndef __AWS_OTADELTA__H__ */
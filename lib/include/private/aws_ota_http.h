@@ -0,0 +1,114 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef __AWS_OTAHTTP__H__
+#define __AWS_OTAHTTP__H__
+
+/**
+ * @brief An HTTPS connection that file ranges are downloaded over.
+ *
+ * The structure is private to aws_ota_http.c.
+ */
+typedef struct OTA_HTTP_Connection OTA_HTTP_Connection_t;
+
+/**
+ * @brief The fields of a response header that the download depends on.
+ *
+ * Only used inside aws_ota_http.c and by its tests.
+ */
+typedef struct
+{
+    uint32_t ulStatus;        /* The status code of the response. */
+    uint32_t ulRangeFirst;    /* The offset of the first byte of the range sent. */
+    uint32_t ulRangeLast;     /* The offset of the last byte of the range sent. */
+    uint32_t ulContentLength; /* The length of the body. */
+    bool_t xHasRange;         /* True if a valid Content-Range field was found. */
+    bool_t xHasLength;        /* True if a valid Content-Length field was found. */
+    bool_t xChunked;          /* True if the body has a transfer encoding we don't support. */
+    bool_t xClose;            /* True if the server will close the connection after the response. */
+} OTA_HTTP_Response_t;
+
+/**
+ * @brief Receives the body of a range response as it arrives.
+ *
+ * The body is passed on in order, in one or more pieces. ulOffset is the
+ * offset in the file of the first byte of the piece. Return pdFALSE to stop
+ * reading the response.
+ */
+typedef BaseType_t ( * OTA_HTTP_BodyCallback_t )( void * pvContext,
+                                                  uint32_t ulOffset,
+                                                  const uint8_t * pucData,
+                                                  uint32_t ulLength );
+
+/**
+ * @brief Open a connection to the server of an https:// URL.
+ *
+ * @return The connection, or NULL if the URL is not valid or the server could
+ * not be reached.
+ */
+OTA_HTTP_Connection_t * OTA_HTTP_Connect( const char * pcURL );
+
+/**
+ * @brief Close a connection and free its resources.
+ */
+void OTA_HTTP_Disconnect( OTA_HTTP_Connection_t * pxConnection );
+
+/**
+ * @brief Ask for a range of the file without waiting for the response.
+ *
+ * Up to otaconfigHTTP_PIPELINE_DEPTH requests may be in flight at once.
+ *
+ * @return pdPASS if the request was sent, otherwise pdFAIL. After a failure,
+ * no more requests can be sent but the responses to the requests already in
+ * flight may still be read.
+ */
+BaseType_t OTA_HTTP_RequestRange( OTA_HTTP_Connection_t * pxConnection,
+                                  uint32_t ulOffset,
+                                  uint32_t ulLength );
+
+/**
+ * @brief Read the response to the oldest request in flight, passing its body
+ * to xCallback.
+ *
+ * @return pdPASS if the whole range was received, otherwise pdFAIL. After a
+ * failure, the connection must be closed.
+ */
+BaseType_t OTA_HTTP_ReadResponse( OTA_HTTP_Connection_t * pxConnection,
+                                  OTA_HTTP_BodyCallback_t xCallback,
+                                  void * pvContext );
+
+/**
+ * @brief Get the number of requests that are waiting for a response.
+ */
+uint32_t OTA_HTTP_RequestsInFlight( const OTA_HTTP_Connection_t * pxConnection );
+
+/**
+ * @brief Check whether more requests can be sent on the connection.
+ *
+ * @return pdFALSE once the server has said it will close the connection.
+ */
+BaseType_t OTA_HTTP_IsOpen( const OTA_HTTP_Connection_t * pxConnection );
+
+#endif /* ifndef __AWS_OTAHTTP__H__ */
@@ -129,6 +129,23 @@ OTA_Err_t prvPAL_CloseFile( OTA_FileContext_t * const C );
  */
 int16_t prvPAL_WriteBlock( OTA_FileContext_t * const C, uint32_t ulOffset, uint8_t * const pcData, uint32_t ulBlockSize );
 
+/**
+ * @brief Read a block of the image that is running now.
+ *
+ * A delta update rebuilds the new image from the running image, so this is only
+ * needed when otaconfigENABLE_DELTA_UPDATE is 1. The blocks are read while the
+ * new image is being written with prvPAL_WriteBlock(), so they must not share
+ * storage.
+ *
+ * @param[in] C OTA file context information.
+ * @param[in] ulOffset Byte offset to read from the beginning of the running image.
+ * @param[out] pcData Pointer to the byte array to read into.
+ * @param[in] ulBlockSize The number of bytes to read. It is at most otaconfigDELTA_WINDOW_SIZE.
+ *
+ * @return The number of bytes read on a success, or a negative error code from the platform abstraction layer.
+ */
+int16_t prvPAL_ReadRunningImage( OTA_FileContext_t * const C, uint32_t ulOffset, uint8_t * const pcData, uint32_t ulBlockSize );
+
 /** 
  * @brief Activate the newest MCU image received via OTA.
  * 
@@ -0,0 +1,80 @@
+/*
+ * Amazon FreeRTOS TLS V1.1.3
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_tls_config_defaults.h
+ * @brief Sets the optional TLS configuration options to sane values if the
+ * user does not supply them.
+ *
+ * The options can be set in FreeRTOSConfig.h.
+ */
+
+#ifndef AWS_INC_TLS_CONFIG_DEFAULTS_H_
+#define AWS_INC_TLS_CONFIG_DEFAULTS_H_
+
+/**
+ * @brief The maximum fragment length requested from the server, in bytes.
+ *
+ * Valid values are 512, 1024, 2048 and 4096, or 0 to not send the
+ * max_fragment_length extension.  Records sent to the server never carry more
+ * than this many bytes of data, so the send record buffer is sized to it once
+ * the handshake completes.  Servers that accept the extension also limit the
+ * records they send, but servers are free to ignore it, so the receive record
+ * buffer keeps the MBEDTLS_SSL_IN_CONTENT_LEN size set in the mbedTLS
+ * configuration.  Only lower that when every endpoint the device connects to
+ * is known to accept the extension.
+ */
+#ifndef tlsconfigMAX_FRAGMENT_LENGTH
+    #define tlsconfigMAX_FRAGMENT_LENGTH    ( 4096 )
+#endif
+
+/**
+ * @brief Set to 1 to free the record buffers while a connection is idle.
+ *
+ * The buffers are freed once a TLS_Recv() or TLS_Send() call leaves no data
+ * waiting to be read or sent, and allocated again by the next call that has
+ * data to process.  An idle connection then holds no record buffers, at the
+ * cost of an allocation and free for each call that moves data.  Set to 0 to
+ * keep the buffers for the life of the connection.
+ */
+#ifndef tlsconfigRELEASE_IDLE_RECORD_BUFFERS
+    #define tlsconfigRELEASE_IDLE_RECORD_BUFFERS    ( 1 )
+#endif
+
+/*
+ * tlsconfigCIPHERSUITES: the ciphersuites offered to the server, in order of
+ * preference.  It has no default, and when it is not defined mbedTLS's own
+ * preference order is used.  Define it as a comma separated list of
+ * MBEDTLS_TLS_* identifiers from mbedtls/ssl_ciphersuites.h to offer first the
+ * suites the target encrypts fastest, for example the AES-128 suites on a core
+ * with no AES hardware, where they take four fewer rounds per block than
+ * AES-256:
+ *
+ * #define tlsconfigCIPHERSUITES \
+ *     MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256, \
+ *     MBEDTLS_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256
+ */
+
+#endif /* AWS_INC_TLS_CONFIG_DEFAULTS_H_ */
@@ -46,6 +46,7 @@ void MPU_vTaskAllocateMPURegions( TaskHandle_t xTask, const MemoryRegion_t * con
 void MPU_vTaskDelete( TaskHandle_t xTaskToDelete );
 void MPU_vTaskDelay( const TickType_t xTicksToDelay );
 void MPU_vTaskDelayUntil( TickType_t * const pxPreviousWakeTime, const TickType_t xTimeIncrement );
+void MPU_vTaskDelayUntilHighResolutionTime( const uint64_t ullWakeTime );
 BaseType_t MPU_xTaskAbortDelay( TaskHandle_t xTask );
 UBaseType_t MPU_uxTaskPriorityGet( const TaskHandle_t xTask );
 eTaskState MPU_eTaskGetState( TaskHandle_t xTask );
@@ -57,12 +58,15 @@ void MPU_vTaskStartScheduler( void );
 void MPU_vTaskSuspendAll( void );
 BaseType_t MPU_xTaskResumeAll( void );
 TickType_t MPU_xTaskGetTickCount( void );
+uint64_t MPU_ullTaskGetHighResolutionTime( void );
 UBaseType_t MPU_uxTaskGetNumberOfTasks( void );
 char * MPU_pcTaskGetName( TaskHandle_t xTaskToQuery );
 TaskHandle_t MPU_xTaskGetHandle( const char *pcNameToQuery );
 UBaseType_t MPU_uxTaskGetStackHighWaterMark( TaskHandle_t xTask );
 void MPU_vTaskSetApplicationTaskTag( TaskHandle_t xTask, TaskHookFunction_t pxHookFunction );
 TaskHookFunction_t MPU_xTaskGetApplicationTaskTag( TaskHandle_t xTask );
+UBaseType_t MPU_uxTaskSetHeapTag( UBaseType_t uxTag );
+UBaseType_t MPU_uxTaskGetHeapTag( TaskHandle_t xTask );
 void MPU_vTaskSetThreadLocalStoragePointer( TaskHandle_t xTaskToSet, BaseType_t xIndex, void *pvValue );
 void * MPU_pvTaskGetThreadLocalStoragePointer( TaskHandle_t xTaskToQuery, BaseType_t xIndex );
 BaseType_t MPU_xTaskCallApplicationTaskHook( TaskHandle_t xTask, void *pvParameter );
@@ -140,6 +144,14 @@ size_t MPU_xStreamBufferSendFromISR( StreamBufferHandle_t xStreamBuffer, const v
 size_t MPU_xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes, TickType_t xTicksToWait );
 size_t MPU_xStreamBufferNextMessageLengthBytes( StreamBufferHandle_t xStreamBuffer );
 size_t MPU_xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes, BaseType_t * const pxHigherPriorityTaskWoken );
+size_t MPU_xStreamBufferSendReserve( StreamBufferHandle_t xStreamBuffer, void **ppvTxData, size_t xDataLengthBytes, TickType_t xTicksToWait );
+size_t MPU_xStreamBufferSendReserveFromISR( StreamBufferHandle_t xStreamBuffer, void **ppvTxData, size_t xDataLengthBytes );
+size_t MPU_xStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes );
+size_t MPU_xStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes, BaseType_t * const pxHigherPriorityTaskWoken );
+size_t MPU_xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer, void **ppvRxData, TickType_t xTicksToWait );
+size_t MPU_xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer, void **ppvRxData );
+size_t MPU_xStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes );
+size_t MPU_xStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer, size_t xDataLengthBytes, BaseType_t * const pxHigherPriorityTaskWoken );
 void MPU_vStreamBufferDelete( StreamBufferHandle_t xStreamBuffer );
 BaseType_t MPU_xStreamBufferIsFull( StreamBufferHandle_t xStreamBuffer );
 BaseType_t MPU_xStreamBufferIsEmpty( StreamBufferHandle_t xStreamBuffer );
@@ -150,6 +162,66 @@ BaseType_t MPU_xStreamBufferSetTriggerLevel( StreamBufferHandle_t xStreamBuffer,
 StreamBufferHandle_t MPU_xStreamBufferGenericCreate( size_t xBufferSizeBytes, size_t xTriggerLevelBytes, BaseType_t xIsMessageBuffer );
 StreamBufferHandle_t MPU_xStreamBufferGenericCreateStatic( size_t xBufferSizeBytes, size_t xTriggerLevelBytes, BaseType_t xIsMessageBuffer, uint8_t * const pucStreamBufferStorageArea, StaticStreamBuffer_t * const pxStaticStreamBuffer );
 
+/* MPU versions of ring_buffer.h API functions. */
+BaseType_t MPU_xRingBufferSend( RingBufferHandle_t xRingBuffer, const void *pvItem, TickType_t xTicksToWait );
+BaseType_t MPU_xRingBufferSendFromISR( RingBufferHandle_t xRingBuffer, const void *pvItem, BaseType_t * const pxHigherPriorityTaskWoken );
+BaseType_t MPU_xRingBufferReceive( RingBufferHandle_t xRingBuffer, void *pvBuffer, TickType_t xTicksToWait );
+BaseType_t MPU_xRingBufferReceiveFromISR( RingBufferHandle_t xRingBuffer, void *pvBuffer, BaseType_t * const pxHigherPriorityTaskWoken );
+UBaseType_t MPU_uxRingBufferItemsWaiting( RingBufferHandle_t xRingBuffer );
+void MPU_vRingBufferDelete( RingBufferHandle_t xRingBuffer );
+RingBufferHandle_t MPU_xRingBufferCreate( UBaseType_t uxSlotCount, size_t xItemSize );
+RingBufferHandle_t MPU_xRingBufferCreateStatic( UBaseType_t uxSlotCount, size_t xItemSize, uint8_t * const pucRingBufferStorageArea, StaticRingBuffer_t * const pxStaticRingBuffer );
+
+/* MPU versions of mem_pool.h API functions. */
+void *MPU_pvMemPoolAlloc( MemPoolHandle_t xMemPool, TickType_t xTicksToWait );
+void *MPU_pvMemPoolAllocFromISR( MemPoolHandle_t xMemPool );
+void MPU_vMemPoolFree( MemPoolHandle_t xMemPool, void *pvBlock );
+void MPU_vMemPoolFreeFromISR( MemPoolHandle_t xMemPool, void *pvBlock, BaseType_t * const pxHigherPriorityTaskWoken );
+void MPU_vMemPoolGetStats( MemPoolHandle_t xMemPool, MemPoolStats_t *pxMemPoolStats );
+void MPU_vMemPoolDelete( MemPoolHandle_t xMemPool );
+MemPoolHandle_t MPU_xMemPoolCreate( UBaseType_t uxBlockCount, size_t xBlockSize );
+MemPoolHandle_t MPU_xMemPoolCreateStatic( UBaseType_t uxBlockCount, size_t xBlockSize, uint8_t * const pucPoolStorageArea, StaticMemPool_t * const pxStaticMemPool );
+
+/* MPU versions of rw_lock.h API functions. */
+BaseType_t MPU_xRwLockReadLock( RwLockHandle_t xRwLock, TickType_t xTicksToWait );
+BaseType_t MPU_xRwLockReadLockFromISR( RwLockHandle_t xRwLock );
+void MPU_vRwLockReadUnlock( RwLockHandle_t xRwLock );
+void MPU_vRwLockReadUnlockFromISR( RwLockHandle_t xRwLock, BaseType_t * const pxHigherPriorityTaskWoken );
+BaseType_t MPU_xRwLockWriteLock( RwLockHandle_t xRwLock, TickType_t xTicksToWait );
+void MPU_vRwLockWriteUnlock( RwLockHandle_t xRwLock );
+TaskHandle_t MPU_xRwLockGetWriter( RwLockHandle_t xRwLock );
+void MPU_vRwLockGetStats( RwLockHandle_t xRwLock, RwLockStats_t *pxRwLockStats );
+void MPU_vRwLockDelete( RwLockHandle_t xRwLock );
+RwLockHandle_t MPU_xRwLockCreate( void );
+RwLockHandle_t MPU_xRwLockCreateStatic( StaticRwLock_t * const pxStaticRwLock );
+
+/* MPU versions of work_queue.h API functions. */
+WorkQueueHandle_t MPU_xWorkQueueCreate( const char * const pcName, UBaseType_t uxWorkerCount, UBaseType_t uxWorkerPriority, const configSTACK_DEPTH_TYPE usStackDepth );
+void MPU_vWorkItemInit( WorkItem_t *pxWorkItem, WorkFunction_t pxFunction, void *pvParameter1, uint32_t ulParameter2 );
+BaseType_t MPU_xWorkQueueSubmit( WorkQueueHandle_t xWorkQueue, WorkItem_t *pxWorkItem, UBaseType_t uxPriority );
+BaseType_t MPU_xWorkQueueSubmitDelayed( WorkQueueHandle_t xWorkQueue, WorkItem_t *pxWorkItem, UBaseType_t uxPriority, TickType_t xDelay );
+BaseType_t MPU_xWorkItemCancel( WorkItem_t *pxWorkItem );
+BaseType_t MPU_xWorkItemIsBusy( WorkItem_t *pxWorkItem );
+BaseType_t MPU_xWorkQueuePendFunctionCall( WorkQueueHandle_t xWorkQueue, WorkFunction_t xFunctionToPend, void *pvParameter1, uint32_t ulParameter2, UBaseType_t uxPriority, TickType_t xTicksToWait );
+void MPU_vWorkQueueGetStats( WorkQueueHandle_t xWorkQueue, WorkQueueStats_t *pxWorkQueueStats );
+void MPU_vWorkQueueResetStats( WorkQueueHandle_t xWorkQueue );
+
+/* MPU versions of async_engine.h API functions. */
+#if( configUSE_ASYNC_ENGINE == 1 )
+	AsyncEngineHandle_t MPU_xAsyncEngineCreate( UBaseType_t uxEventQueueLength );
+	BaseType_t MPU_xAsyncEngineAddObject( AsyncEngineHandle_t xEngine, QueueSetMemberHandle_t xObject );
+	void MPU_vAsyncEngineRun( AsyncEngineHandle_t xEngine );
+	void MPU_vAsyncTaskStart( AsyncEngineHandle_t xEngine, AsyncTask_t *pxTask, AsyncTaskFunction_t pxFunction, void *pvParameters );
+	void MPU_vAsyncTaskNotify( AsyncTask_t *pxTask, uint32_t ulBits );
+	void MPU_vAsyncTaskBeginWait( AsyncTask_t *pxTask, TickType_t xTicksToWait );
+	void MPU_vAsyncTaskDelay( AsyncTask_t *pxTask, TickType_t xTicksToDelay );
+	void MPU_vAsyncTaskYield( AsyncTask_t *pxTask );
+	BaseType_t MPU_xAsyncTaskQueueReceive( AsyncTask_t *pxTask, QueueHandle_t xQueue, void *pvBuffer );
+	BaseType_t MPU_xAsyncTaskQueueSend( AsyncTask_t *pxTask, QueueHandle_t xQueue, const void *pvItem );
+	BaseType_t MPU_xAsyncTaskSemaphoreTake( AsyncTask_t *pxTask, QueueHandle_t xSemaphore );
+	BaseType_t MPU_xAsyncTaskNotifyWait( AsyncTask_t *pxTask, uint32_t *pulValue );
+#endif /* configUSE_ASYNC_ENGINE */
+
 
 
 #endif /* MPU_PROTOTYPES_H */
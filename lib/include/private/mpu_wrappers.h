@@ -53,6 +53,7 @@ only for ports that are using the MPU. */
 		#define vTaskDelete								MPU_vTaskDelete
 		#define vTaskDelay								MPU_vTaskDelay
 		#define vTaskDelayUntil							MPU_vTaskDelayUntil
+		#define vTaskDelayUntilHighResolutionTime		MPU_vTaskDelayUntilHighResolutionTime
 		#define xTaskAbortDelay							MPU_xTaskAbortDelay
 		#define uxTaskPriorityGet						MPU_uxTaskPriorityGet
 		#define eTaskGetState							MPU_eTaskGetState
@@ -63,12 +64,15 @@ only for ports that are using the MPU. */
 		#define vTaskSuspendAll							MPU_vTaskSuspendAll
 		#define xTaskResumeAll							MPU_xTaskResumeAll
 		#define xTaskGetTickCount						MPU_xTaskGetTickCount
+		#define ullTaskGetHighResolutionTime			MPU_ullTaskGetHighResolutionTime
 		#define uxTaskGetNumberOfTasks					MPU_uxTaskGetNumberOfTasks
 		#define pcTaskGetName							MPU_pcTaskGetName
 		#define xTaskGetHandle							MPU_xTaskGetHandle
 		#define uxTaskGetStackHighWaterMark				MPU_uxTaskGetStackHighWaterMark
 		#define vTaskSetApplicationTaskTag				MPU_vTaskSetApplicationTaskTag
 		#define xTaskGetApplicationTaskTag				MPU_xTaskGetApplicationTaskTag
+		#define uxTaskSetHeapTag						MPU_uxTaskSetHeapTag
+		#define uxTaskGetHeapTag						MPU_uxTaskGetHeapTag
 		#define vTaskSetThreadLocalStoragePointer		MPU_vTaskSetThreadLocalStoragePointer
 		#define pvTaskGetThreadLocalStoragePointer		MPU_pvTaskGetThreadLocalStoragePointer
 		#define xTaskCallApplicationTaskHook			MPU_xTaskCallApplicationTaskHook
@@ -144,6 +148,14 @@ only for ports that are using the MPU. */
 		#define xStreamBufferReceive					MPU_xStreamBufferReceive
 		#define xStreamBufferNextMessageLengthBytes		MPU_xStreamBufferNextMessageLengthBytes
 		#define xStreamBufferReceiveFromISR				MPU_xStreamBufferReceiveFromISR
+		#define xStreamBufferSendReserve				MPU_xStreamBufferSendReserve
+		#define xStreamBufferSendReserveFromISR			MPU_xStreamBufferSendReserveFromISR
+		#define xStreamBufferSendCommit					MPU_xStreamBufferSendCommit
+		#define xStreamBufferSendCommitFromISR			MPU_xStreamBufferSendCommitFromISR
+		#define xStreamBufferReceiveAcquire				MPU_xStreamBufferReceiveAcquire
+		#define xStreamBufferReceiveAcquireFromISR		MPU_xStreamBufferReceiveAcquireFromISR
+		#define xStreamBufferReceiveRelease				MPU_xStreamBufferReceiveRelease
+		#define xStreamBufferReceiveReleaseFromISR		MPU_xStreamBufferReceiveReleaseFromISR
 		#define vStreamBufferDelete						MPU_vStreamBufferDelete
 		#define xStreamBufferIsFull						MPU_xStreamBufferIsFull
 		#define xStreamBufferIsEmpty					MPU_xStreamBufferIsEmpty
@@ -154,6 +166,64 @@ only for ports that are using the MPU. */
 		#define xStreamBufferGenericCreate				MPU_xStreamBufferGenericCreate
 		#define xStreamBufferGenericCreateStatic		MPU_xStreamBufferGenericCreateStatic
 
+		/* Map standard ring_buffer.h API functions to the MPU equivalents. */
+		#define xRingBufferSend							MPU_xRingBufferSend
+		#define xRingBufferSendFromISR					MPU_xRingBufferSendFromISR
+		#define xRingBufferReceive						MPU_xRingBufferReceive
+		#define xRingBufferReceiveFromISR				MPU_xRingBufferReceiveFromISR
+		#define uxRingBufferItemsWaiting				MPU_uxRingBufferItemsWaiting
+		#define vRingBufferDelete						MPU_vRingBufferDelete
+		#define xRingBufferCreate						MPU_xRingBufferCreate
+		#define xRingBufferCreateStatic					MPU_xRingBufferCreateStatic
+
+		/* Map standard mem_pool.h API functions to the MPU equivalents. */
+		#define pvMemPoolAlloc							MPU_pvMemPoolAlloc
+		#define pvMemPoolAllocFromISR					MPU_pvMemPoolAllocFromISR
+		#define vMemPoolFree							MPU_vMemPoolFree
+		#define vMemPoolFreeFromISR						MPU_vMemPoolFreeFromISR
+		#define vMemPoolGetStats						MPU_vMemPoolGetStats
+		#define vMemPoolDelete							MPU_vMemPoolDelete
+		#define xMemPoolCreate							MPU_xMemPoolCreate
+		#define xMemPoolCreateStatic					MPU_xMemPoolCreateStatic
+
+		/* Map standard rw_lock.h API functions to the MPU equivalents. */
+		#define xRwLockReadLock							MPU_xRwLockReadLock
+		#define xRwLockReadLockFromISR					MPU_xRwLockReadLockFromISR
+		#define vRwLockReadUnlock						MPU_vRwLockReadUnlock
+		#define vRwLockReadUnlockFromISR				MPU_vRwLockReadUnlockFromISR
+		#define xRwLockWriteLock						MPU_xRwLockWriteLock
+		#define vRwLockWriteUnlock						MPU_vRwLockWriteUnlock
+		#define xRwLockGetWriter						MPU_xRwLockGetWriter
+		#define vRwLockGetStats							MPU_vRwLockGetStats
+		#define vRwLockDelete							MPU_vRwLockDelete
+		#define xRwLockCreate							MPU_xRwLockCreate
+		#define xRwLockCreateStatic						MPU_xRwLockCreateStatic
+
+		/* Map standard work_queue.h API functions to the MPU equivalents. */
+		#define xWorkQueueCreate						MPU_xWorkQueueCreate
+		#define vWorkItemInit							MPU_vWorkItemInit
+		#define xWorkQueueSubmit						MPU_xWorkQueueSubmit
+		#define xWorkQueueSubmitDelayed					MPU_xWorkQueueSubmitDelayed
+		#define xWorkItemCancel							MPU_xWorkItemCancel
+		#define xWorkItemIsBusy							MPU_xWorkItemIsBusy
+		#define xWorkQueuePendFunctionCall				MPU_xWorkQueuePendFunctionCall
+		#define vWorkQueueGetStats						MPU_vWorkQueueGetStats
+		#define vWorkQueueResetStats					MPU_vWorkQueueResetStats
+
+		/* Map standard async_engine.h API functions to the MPU equivalents. */
+		#define xAsyncEngineCreate						MPU_xAsyncEngineCreate
+		#define xAsyncEngineAddObject					MPU_xAsyncEngineAddObject
+		#define vAsyncEngineRun							MPU_vAsyncEngineRun
+		#define vAsyncTaskStart							MPU_vAsyncTaskStart
+		#define vAsyncTaskNotify						MPU_vAsyncTaskNotify
+		#define vAsyncTaskBeginWait						MPU_vAsyncTaskBeginWait
+		#define vAsyncTaskDelay							MPU_vAsyncTaskDelay
+		#define vAsyncTaskYield							MPU_vAsyncTaskYield
+		#define xAsyncTaskQueueReceive					MPU_xAsyncTaskQueueReceive
+		#define xAsyncTaskQueueSend						MPU_xAsyncTaskQueueSend
+		#define xAsyncTaskSemaphoreTake					MPU_xAsyncTaskSemaphoreTake
+		#define xAsyncTaskNotifyWait					MPU_xAsyncTaskNotifyWait
+
 
 		/* Remove the privileged function macro, but keep the PRIVILEGED_DATA
 		macro so applications can place data in privileged access sections
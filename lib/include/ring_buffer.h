@@ -0,0 +1,427 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Ring buffers pass fixed size items from any number of tasks and interrupts
+ * (the producers) to a task (the consumer).  Unlike queues, adding an item to
+ * or removing an item from a ring buffer does not enter a critical section
+ * when the port provides portCOMPARE_AND_SWAP() - producers claim a slot with
+ * a compare-and-swap on the ring buffer's write position, copy their item into
+ * the slot, then mark the slot as full.  Ports that do not provide
+ * portCOMPARE_AND_SWAP() fall back to a short critical section per item.
+ *
+ * Any number of producer tasks can block on a full ring buffer to wait for a
+ * free slot.  More than one task or interrupt can remove items, but only one
+ * task at a time can block on a ring buffer to wait for an item to arrive, and
+ * that task is unblocked using its direct to task notification.
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include ring_buffer.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which ring buffers are referenced.  For example, a call to
+ * xRingBufferCreate() returns a RingBufferHandle_t variable that can then be
+ * used as a parameter to xRingBufferSend(), xRingBufferReceive(), etc.
+ */
+struct RingBufferDef_t;
+typedef struct RingBufferDef_t * RingBufferHandle_t;
+
+/**
+ * ring_buffer.h
+ *
+ * The number of bytes each slot of a ring buffer occupies in the storage area,
+ * which holds the item and the slot's sequence number.
+ */
+#define rbSLOT_SIZE_BYTES( xItemSize ) ( sizeof( UBaseType_t ) + ( ( ( size_t ) ( xItemSize ) + sizeof( UBaseType_t ) - ( size_t ) 1 ) & ~( sizeof( UBaseType_t ) - ( size_t ) 1 ) ) )
+
+/**
+ * ring_buffer.h
+ *
+ * The size of the storage area that must be passed to xRingBufferCreateStatic().
+ */
+#define rbSTORAGE_SIZE_BYTES( uxSlotCount, xItemSize ) ( ( size_t ) ( uxSlotCount ) * rbSLOT_SIZE_BYTES( xItemSize ) )
+
+/**
+ * ring_buffer.h
+ *
+<pre>
+RingBufferHandle_t xRingBufferCreate( UBaseType_t uxSlotCount, size_t xItemSize );
+</pre>
+ *
+ * Creates a new ring buffer using dynamically allocated memory.  See
+ * xRingBufferCreateStatic() for a version that uses statically allocated
+ * memory (memory that is allocated at compile time).
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xRingBufferCreate() to be available.
+ *
+ * @param uxSlotCount The maximum number of items the ring buffer can hold at
+ * any one time.  Must be a power of 2.
+ *
+ * @param xItemSize The size, in bytes, of each item.
+ *
+ * @return The handle of the created ring buffer, or NULL if there was
+ * insufficient heap memory available to create the ring buffer.
+ *
+ * Example use:
+<pre>
+typedef struct SensorReading
+{
+    uint8_t ucSensor;
+    int32_t lValue;
+} SensorReading_t;
+
+void vAFunction( void )
+{
+RingBufferHandle_t xRingBuffer;
+
+    // Create a ring buffer that can hold 32 sensor readings.
+    xRingBuffer = xRingBufferCreate( 32, sizeof( SensorReading_t ) );
+
+    if( xRingBuffer == NULL )
+    {
+        // There was not enough heap memory space available to create the
+        // ring buffer.
+    }
+}
+</pre>
+ * \defgroup xRingBufferCreate xRingBufferCreate
+ * \ingroup RingBufferManagement
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	RingBufferHandle_t xRingBufferCreate( UBaseType_t uxSlotCount, size_t xItemSize ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * ring_buffer.h
+ *
+<pre>
+RingBufferHandle_t xRingBufferCreateStatic( UBaseType_t uxSlotCount,
+                                            size_t xItemSize,
+                                            uint8_t *pucRingBufferStorageArea,
+                                            StaticRingBuffer_t *pxStaticRingBuffer );
+</pre>
+ *
+ * Creates a new ring buffer using statically allocated memory.  See
+ * xRingBufferCreate() for a version that uses dynamically allocated memory.
+ *
+ * configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h for
+ * xRingBufferCreateStatic() to be available.
+ *
+ * @param uxSlotCount The maximum number of items the ring buffer can hold at
+ * any one time.  Must be a power of 2.
+ *
+ * @param xItemSize The size, in bytes, of each item.
+ *
+ * @param pucRingBufferStorageArea Must point to a uint8_t array that is at
+ * least rbSTORAGE_SIZE_BYTES( uxSlotCount, xItemSize ) bytes big, and is
+ * aligned to hold a UBaseType_t.  This is the array into which items are
+ * copied.
+ *
+ * @param pxStaticRingBuffer Must point to a variable of type
+ * StaticRingBuffer_t, which will be used to hold the ring buffer's data
+ * structure.
+ *
+ * @return The handle of the created ring buffer, or NULL if either
+ * pucRingBufferStorageArea or pxStaticRingBuffer are NULL.
+ *
+ * Example use:
+<pre>
+#define SLOT_COUNT 32
+
+// Used to hold the ring buffer's items.
+static UBaseType_t uxStorage[ rbSTORAGE_SIZE_BYTES( SLOT_COUNT, sizeof( SensorReading_t ) ) / sizeof( UBaseType_t ) ];
+
+// The variable used to hold the ring buffer structure.
+StaticRingBuffer_t xRingBufferStruct;
+
+void MyFunction( void )
+{
+RingBufferHandle_t xRingBuffer;
+
+    xRingBuffer = xRingBufferCreateStatic( SLOT_COUNT,
+                                           sizeof( SensorReading_t ),
+                                           ( uint8_t * ) uxStorage,
+                                           &xRingBufferStruct );
+
+    // As neither the pucRingBufferStorageArea or pxStaticRingBuffer
+    // parameters were NULL, xRingBuffer will not be NULL, and can be used to
+    // reference the created ring buffer in other ring buffer API calls.
+}
+</pre>
+ * \defgroup xRingBufferCreateStatic xRingBufferCreateStatic
+ * \ingroup RingBufferManagement
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	RingBufferHandle_t xRingBufferCreateStatic( UBaseType_t uxSlotCount,
+												size_t xItemSize,
+												uint8_t * const pucRingBufferStorageArea,
+												StaticRingBuffer_t * const pxStaticRingBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * ring_buffer.h
+ *
+<pre>
+BaseType_t xRingBufferSend( RingBufferHandle_t xRingBuffer,
+                            const void *pvItem,
+                            TickType_t xTicksToWait );
+</pre>
+ *
+ * Copies an item into a ring buffer.  Any number of tasks can add items to the
+ * same ring buffer at the same time.  If the ring buffer is full the calling
+ * task can block to wait for a consumer to remove an item.  Blocked tasks are
+ * unblocked in priority order, one for each item removed.
+ *
+ * Use xRingBufferSendFromISR() to add an item from an interrupt service
+ * routine (ISR).
+ *
+ * @param xRingBuffer The handle of the ring buffer to which the item is being
+ * added.
+ *
+ * @param pvItem A pointer to the item to be copied into the ring buffer.
+ * xItemSize bytes are copied, where xItemSize is the item size the ring buffer
+ * was created with.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for a free slot if the ring buffer is full.  Set to 0
+ * to return immediately.
+ *
+ * @return pdPASS if the item was added, or errQUEUE_FULL if the ring buffer was
+ * still full when the block time expired.
+ *
+ * Example use:
+<pre>
+void vASensorTask( void *pvParameters )
+{
+SensorReading_t xReading;
+
+    for( ;; )
+    {
+        prvReadSensor( &xReading );
+
+        if( xRingBufferSend( xRingBuffer, &xReading, 0 ) != pdPASS )
+        {
+            // The consumer is not keeping up, so the reading was dropped
+            // rather than delaying the next one.
+        }
+
+        vTaskDelay( pdMS_TO_TICKS( 10 ) );
+    }
+}
+</pre>
+ * \defgroup xRingBufferSend xRingBufferSend
+ * \ingroup RingBufferManagement
+ */
+BaseType_t xRingBufferSend( RingBufferHandle_t xRingBuffer,
+							const void *pvItem,
+							TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * ring_buffer.h
+ *
+<pre>
+BaseType_t xRingBufferSendFromISR( RingBufferHandle_t xRingBuffer,
+                                   const void *pvItem,
+                                   BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * A version of xRingBufferSend() that can be called from an interrupt service
+ * routine (ISR).
+ *
+ * @param xRingBuffer The handle of the ring buffer to which the item is being
+ * added.
+ *
+ * @param pvItem A pointer to the item to be copied into the ring buffer.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if adding the item unblocked
+ * a task that has a priority above the priority of the currently executing
+ * task, in which case a context switch should be requested before the
+ * interrupt is exited.  *pxHigherPriorityTaskWoken must be initialised to
+ * pdFALSE before it is passed into the function.
+ *
+ * @return pdPASS if the item was added, or errQUEUE_FULL if the ring buffer was
+ * full.
+ *
+ * \defgroup xRingBufferSendFromISR xRingBufferSendFromISR
+ * \ingroup RingBufferManagement
+ */
+BaseType_t xRingBufferSendFromISR( RingBufferHandle_t xRingBuffer,
+								   const void *pvItem,
+								   BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * ring_buffer.h
+ *
+<pre>
+BaseType_t xRingBufferReceive( RingBufferHandle_t xRingBuffer,
+                               void *pvBuffer,
+                               TickType_t xTicksToWait );
+</pre>
+ *
+ * Removes the oldest item from a ring buffer.  More than one task can remove
+ * items from the same ring buffer, but only one task at a time can block to
+ * wait for an item.
+ *
+ * Items are removed in the order in which producers claimed their slots.  If a
+ * producer that claimed a slot has not finished copying its item into the slot
+ * then the ring buffer appears empty until it does, even if producers that
+ * claimed later slots have finished - the waiting consumer is unblocked when
+ * the first producer finishes.
+ *
+ * The calling task's direct to task notification is used to unblock the task
+ * when an item is added, so the notification value must not be relied upon by
+ * other code while the task is blocked on a ring buffer.
+ *
+ * Use xRingBufferReceiveFromISR() to remove an item from an interrupt service
+ * routine (ISR).
+ *
+ * @param xRingBuffer The handle of the ring buffer from which an item is being
+ * removed.
+ *
+ * @param pvBuffer A pointer to the buffer into which the item will be copied.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for an item if the ring buffer is empty.
+ *
+ * @return pdPASS if an item was removed, otherwise errQUEUE_EMPTY.
+ *
+ * Example use:
+<pre>
+void vAnUplinkTask( void *pvParameters )
+{
+SensorReading_t xReading;
+
+    for( ;; )
+    {
+        if( xRingBufferReceive( xRingBuffer, &xReading, portMAX_DELAY ) == pdPASS )
+        {
+            prvSendReading( &xReading );
+        }
+    }
+}
+</pre>
+ * \defgroup xRingBufferReceive xRingBufferReceive
+ * \ingroup RingBufferManagement
+ */
+BaseType_t xRingBufferReceive( RingBufferHandle_t xRingBuffer,
+							   void *pvBuffer,
+							   TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * ring_buffer.h
+ *
+<pre>
+BaseType_t xRingBufferReceiveFromISR( RingBufferHandle_t xRingBuffer,
+                                      void *pvBuffer,
+                                      BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * A version of xRingBufferReceive() that can be called from an interrupt
+ * service routine (ISR).
+ *
+ * @param xRingBuffer The handle of the ring buffer from which an item is being
+ * removed.
+ *
+ * @param pvBuffer A pointer to the buffer into which the item will be copied.
+ *
+ * @param pxHigherPriorityTaskWoken Removing an item can unblock a task that
+ * was waiting for a free slot.  *pxHigherPriorityTaskWoken is set to pdTRUE if
+ * that task has a priority above the priority of the currently executing task,
+ * in which case a context switch should be requested before the interrupt is
+ * exited.  *pxHigherPriorityTaskWoken must be initialised to pdFALSE before it
+ * is passed into the function.
+ *
+ * @return pdPASS if an item was removed, otherwise errQUEUE_EMPTY.
+ *
+ * \defgroup xRingBufferReceiveFromISR xRingBufferReceiveFromISR
+ * \ingroup RingBufferManagement
+ */
+BaseType_t xRingBufferReceiveFromISR( RingBufferHandle_t xRingBuffer,
+									  void *pvBuffer,
+									  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * ring_buffer.h
+ *
+<pre>
+UBaseType_t uxRingBufferItemsWaiting( RingBufferHandle_t xRingBuffer );
+</pre>
+ *
+ * Queries the number of slots that have been claimed by producers and not yet
+ * claimed by consumers.  The value is only a snapshot, as producers and
+ * consumers can be adding and removing items at the same time.
+ *
+ * @param xRingBuffer The handle of the ring buffer being queried.
+ *
+ * @return The number of items in the ring buffer.
+ *
+ * \defgroup uxRingBufferItemsWaiting uxRingBufferItemsWaiting
+ * \ingroup RingBufferManagement
+ */
+UBaseType_t uxRingBufferItemsWaiting( RingBufferHandle_t xRingBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * ring_buffer.h
+ *
+<pre>
+void vRingBufferDelete( RingBufferHandle_t xRingBuffer );
+</pre>
+ *
+ * Deletes a ring buffer that was previously created using a call to
+ * xRingBufferCreate() or xRingBufferCreateStatic().  If the ring buffer was
+ * created using dynamic memory then the allocated memory is freed.
+ *
+ * A ring buffer handle must not be used after the ring buffer has been
+ * deleted.
+ *
+ * @param xRingBuffer The handle of the ring buffer to be deleted.
+ *
+ * \defgroup vRingBufferDelete vRingBufferDelete
+ * \ingroup RingBufferManagement
+ */
+void vRingBufferDelete( RingBufferHandle_t xRingBuffer ) PRIVILEGED_FUNCTION;
+
+#if( configUSE_TRACE_FACILITY == 1 )
+	void vRingBufferSetRingBufferNumber( RingBufferHandle_t xRingBuffer, UBaseType_t uxRingBufferNumber ) PRIVILEGED_FUNCTION;
+	UBaseType_t uxRingBufferGetRingBufferNumber( RingBufferHandle_t xRingBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( RING_BUFFER_H ) */
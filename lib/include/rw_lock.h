@@ -0,0 +1,362 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Reader-writer locks let any number of tasks hold a lock for reading at the
+ * same time, or one task hold it for writing, so data that is read far more
+ * often than it is written can be read in parallel instead of one task at a
+ * time.  Tasks can block, with a timeout, to wait for a lock, and interrupts
+ * can try to take and release read locks.
+ *
+ * Waiting writers are preferred over tasks that arrive to read, so a steady
+ * stream of readers cannot stop a writer from ever taking the lock, unless the
+ * arriving reader has a higher priority than every waiting writer.  When a
+ * writer releases the lock, all the waiting readers are allowed in together if
+ * the highest priority waiting reader has a higher priority than every waiting
+ * writer, otherwise the next writer takes the lock.  Waiting tasks of each kind
+ * take the lock in priority order.
+ *
+ * Reader-writer locks do not use priority inheritance, so, as with semaphores,
+ * a low priority task holding a lock can delay a higher priority task waiting
+ * for it.
+ */
+
+#ifndef RW_LOCK_H
+#define RW_LOCK_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include rw_lock.h"
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which reader-writer locks are referenced.  For example, a call to
+ * xRwLockCreate() returns a RwLockHandle_t variable that can then be used as a
+ * parameter to xRwLockReadLock(), xRwLockWriteLock(), etc.
+ */
+struct RwLockDef_t;
+typedef struct RwLockDef_t * RwLockHandle_t;
+
+/**
+ * Used with vRwLockGetStats() to obtain the state and statistics of a
+ * reader-writer lock.
+ */
+typedef struct xRW_LOCK_STATS
+{
+	TaskHandle_t xWriter;				/* The task holding the lock for writing, or NULL if the lock is not held for writing. */
+	UBaseType_t uxReaders;				/* The number of read locks held. */
+	UBaseType_t uxWaitingReaders;		/* The number of tasks waiting to take the lock for reading. */
+	UBaseType_t uxWaitingWriters;		/* The number of tasks waiting to take the lock for writing. */
+	UBaseType_t uxReadLocks;			/* The number of read locks taken since the lock was created. */
+	UBaseType_t uxWriteLocks;			/* The number of write locks taken since the lock was created. */
+	UBaseType_t uxContendedLocks;		/* The number of times a task had to wait to take the lock. */
+	UBaseType_t uxFailedLocks;			/* The number of attempts to take the lock that failed or timed out. */
+} RwLockStats_t;
+
+/**
+ * rw_lock.h
+ *
+<pre>
+RwLockHandle_t xRwLockCreate( void );
+</pre>
+ *
+ * Creates a new reader-writer lock using dynamically allocated memory.  See
+ * xRwLockCreateStatic() for a version that uses statically allocated memory
+ * (memory that is allocated at compile time).
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xRwLockCreate() to be available.
+ *
+ * @return The handle of the created lock, or NULL if there was insufficient
+ * heap memory available to create the lock.
+ *
+ * Example use:
+<pre>
+RwLockHandle_t xRouteLock;
+
+void vLookUpRoute( uint32_t ulAddress )
+{
+    // Any number of tasks can search the table at the same time.
+    if( xRwLockReadLock( xRouteLock, pdMS_TO_TICKS( 10 ) ) == pdPASS )
+    {
+        // Search the routing table here.
+        vRwLockReadUnlock( xRouteLock );
+    }
+}
+
+void vAddRoute( uint32_t ulAddress )
+{
+    // Only one task can change the table, and not while it is being searched.
+    if( xRwLockWriteLock( xRouteLock, portMAX_DELAY ) == pdPASS )
+    {
+        // Update the routing table here.
+        vRwLockWriteUnlock( xRouteLock );
+    }
+}
+
+void vAFunction( void )
+{
+    xRouteLock = xRwLockCreate();
+    configASSERT( xRouteLock );
+}
+</pre>
+ * \defgroup xRwLockCreate xRwLockCreate
+ * \ingroup RwLockManagement
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	RwLockHandle_t xRwLockCreate( void ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * rw_lock.h
+ *
+<pre>
+RwLockHandle_t xRwLockCreateStatic( StaticRwLock_t *pxStaticRwLock );
+</pre>
+ *
+ * Creates a new reader-writer lock using statically allocated memory.  See
+ * xRwLockCreate() for a version that uses dynamically allocated memory.
+ *
+ * configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h for
+ * xRwLockCreateStatic() to be available.
+ *
+ * @param pxStaticRwLock Must point to a variable of type StaticRwLock_t, which
+ * will be used to hold the lock's data structure.
+ *
+ * @return The handle of the created lock, or NULL if pxStaticRwLock is NULL.
+ *
+ * \defgroup xRwLockCreateStatic xRwLockCreateStatic
+ * \ingroup RwLockManagement
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	RwLockHandle_t xRwLockCreateStatic( StaticRwLock_t * const pxStaticRwLock ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * rw_lock.h
+ *
+<pre>
+BaseType_t xRwLockReadLock( RwLockHandle_t xRwLock, TickType_t xTicksToWait );
+</pre>
+ *
+ * Takes a reader-writer lock for reading.  The lock can be taken for reading
+ * while other tasks hold it for reading, but not while a task holds it for
+ * writing.  It is also not taken while a task is waiting to write, unless the
+ * calling task has a higher priority than every waiting writer.
+ *
+ * A task must not take a read lock it already holds if a writer could be
+ * waiting for the lock, as the second read lock would wait for the writer,
+ * which is waiting for the first read lock to be released.
+ *
+ * @param xRwLock The handle of the lock being taken.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for the lock if it cannot be taken immediately.
+ *
+ * @return pdPASS if the lock was taken for reading, or pdFAIL if the block
+ * time expired first.
+ *
+ * \defgroup xRwLockReadLock xRwLockReadLock
+ * \ingroup RwLockManagement
+ */
+BaseType_t xRwLockReadLock( RwLockHandle_t xRwLock, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *
+<pre>
+BaseType_t xRwLockReadLockFromISR( RwLockHandle_t xRwLock );
+</pre>
+ *
+ * A version of xRwLockReadLock() that can be called from an interrupt service
+ * routine (ISR).  The lock is taken if no task holds it for writing, even if
+ * tasks are waiting to write, as an interrupt runs ahead of every task and
+ * holds the lock only briefly.
+ *
+ * @param xRwLock The handle of the lock being taken.
+ *
+ * @return pdPASS if the lock was taken for reading, otherwise pdFAIL.
+ *
+ * \defgroup xRwLockReadLockFromISR xRwLockReadLockFromISR
+ * \ingroup RwLockManagement
+ */
+BaseType_t xRwLockReadLockFromISR( RwLockHandle_t xRwLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *
+<pre>
+void vRwLockReadUnlock( RwLockHandle_t xRwLock );
+</pre>
+ *
+ * Releases a read lock taken by xRwLockReadLock() or xRwLockReadLockFromISR().
+ * Releasing the last read lock lets the highest priority waiting writer take
+ * the lock.
+ *
+ * @param xRwLock The handle of the lock being released.
+ *
+ * \defgroup vRwLockReadUnlock vRwLockReadUnlock
+ * \ingroup RwLockManagement
+ */
+void vRwLockReadUnlock( RwLockHandle_t xRwLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *
+<pre>
+void vRwLockReadUnlockFromISR( RwLockHandle_t xRwLock,
+                               BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * A version of vRwLockReadUnlock() that can be called from an interrupt
+ * service routine (ISR).
+ *
+ * @param xRwLock The handle of the lock being released.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if releasing the lock
+ * unblocked a task that has a priority above the priority of the currently
+ * executing task, in which case a context switch should be requested before
+ * the interrupt is exited.  *pxHigherPriorityTaskWoken must be initialised to
+ * pdFALSE before it is passed into the function.
+ *
+ * \defgroup vRwLockReadUnlockFromISR vRwLockReadUnlockFromISR
+ * \ingroup RwLockManagement
+ */
+void vRwLockReadUnlockFromISR( RwLockHandle_t xRwLock,
+							   BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *
+<pre>
+BaseType_t xRwLockWriteLock( RwLockHandle_t xRwLock, TickType_t xTicksToWait );
+</pre>
+ *
+ * Takes a reader-writer lock for writing.  The lock can only be taken for
+ * writing when no task holds it for reading or writing.  Write locks cannot
+ * be taken recursively.
+ *
+ * @param xRwLock The handle of the lock being taken.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for the lock if it cannot be taken immediately.
+ *
+ * @return pdPASS if the lock was taken for writing, or pdFAIL if the block
+ * time expired first.
+ *
+ * \defgroup xRwLockWriteLock xRwLockWriteLock
+ * \ingroup RwLockManagement
+ */
+BaseType_t xRwLockWriteLock( RwLockHandle_t xRwLock, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *
+<pre>
+void vRwLockWriteUnlock( RwLockHandle_t xRwLock );
+</pre>
+ *
+ * Releases a write lock.  Only the task that took the write lock can release
+ * it.
+ *
+ * @param xRwLock The handle of the lock being released.
+ *
+ * \defgroup vRwLockWriteUnlock vRwLockWriteUnlock
+ * \ingroup RwLockManagement
+ */
+void vRwLockWriteUnlock( RwLockHandle_t xRwLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *
+<pre>
+TaskHandle_t xRwLockGetWriter( RwLockHandle_t xRwLock );
+</pre>
+ *
+ * Returns the handle of the task holding the lock for writing, or NULL if no
+ * task holds the lock for writing.  A task can use this to find out whether it
+ * holds a write lock, as the result can only change to or from its own handle
+ * if it takes or releases the lock itself.
+ *
+ * @param xRwLock The handle of the lock being queried.
+ *
+ * \defgroup xRwLockGetWriter xRwLockGetWriter
+ * \ingroup RwLockManagement
+ */
+TaskHandle_t xRwLockGetWriter( RwLockHandle_t xRwLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *
+<pre>
+void vRwLockGetStats( RwLockHandle_t xRwLock, RwLockStats_t *pxRwLockStats );
+</pre>
+ *
+ * Obtains a consistent snapshot of a reader-writer lock's state and
+ * statistics.
+ *
+ * @param xRwLock The handle of the lock being queried.
+ *
+ * @param pxRwLockStats The structure into which the statistics are written.
+ *
+ * \defgroup vRwLockGetStats vRwLockGetStats
+ * \ingroup RwLockManagement
+ */
+void vRwLockGetStats( RwLockHandle_t xRwLock, RwLockStats_t *pxRwLockStats ) PRIVILEGED_FUNCTION;
+
+/**
+ * rw_lock.h
+ *
+<pre>
+void vRwLockDelete( RwLockHandle_t xRwLock );
+</pre>
+ *
+ * Deletes a reader-writer lock that was previously created using a call to
+ * xRwLockCreate() or xRwLockCreateStatic().  If the lock was created using
+ * dynamic memory then the allocated memory is freed.  The lock cannot be held,
+ * and no tasks can be waiting for it, when it is deleted.
+ *
+ * @param xRwLock The handle of the lock to be deleted.
+ *
+ * \defgroup vRwLockDelete vRwLockDelete
+ * \ingroup RwLockManagement
+ */
+void vRwLockDelete( RwLockHandle_t xRwLock ) PRIVILEGED_FUNCTION;
+
+#if( configUSE_TRACE_FACILITY == 1 )
+	void vRwLockSetRwLockNumber( RwLockHandle_t xRwLock, UBaseType_t uxRwLockNumber ) PRIVILEGED_FUNCTION;
+	UBaseType_t uxRwLockGetRwLockNumber( RwLockHandle_t xRwLock ) PRIVILEGED_FUNCTION;
+#endif
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( RW_LOCK_H ) */
@@ -586,6 +586,317 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
 									size_t xBufferLengthBytes,
 									BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferSendReserve( StreamBufferHandle_t xStreamBuffer,
+                                 void **ppvTxData,
+                                 size_t xDataLengthBytes,
+                                 TickType_t xTicksToWait );
+</pre>
+ *
+ * Reserves xDataLengthBytes of contiguous space in a stream buffer so the data
+ * can be written directly into the buffer's storage area, rather than being
+ * copied in from a separate buffer by xStreamBufferSend().  The data is not
+ * visible to the reader until it is committed by a call to
+ * xStreamBufferSendCommit().  Only one reservation can be outstanding at a
+ * time, and xStreamBufferSend() must not be called while a reservation is
+ * outstanding.
+ *
+ * The space must be contiguous, so if there is not enough space between the
+ * head of the buffer and the end of the storage area the reservation is made at
+ * the start of the storage area instead, and the bytes skipped are unused until
+ * the reader passes them.  A reservation of up to half the buffer's size is
+ * always eventually satisfied, larger reservations might never be.
+ *
+ * If the buffer is a message buffer then the reservation also holds the length
+ * of the message, which is written when the message is committed.
+ *
+ * Use xStreamBufferSendReserveFromISR() to reserve space from an interrupt
+ * service routine (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer in which space is being
+ * reserved.
+ *
+ * @param ppvTxData Set to point to the reserved space, or to NULL if the space
+ * could not be reserved.
+ *
+ * @param xDataLengthBytes The number of bytes to reserve.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for enough contiguous space to become available in the
+ * stream buffer.
+ *
+ * @return xDataLengthBytes if the space was reserved, otherwise 0.
+ *
+ * Example use:
+<pre>
+void vAFunction( StreamBufferHandle_t xStreamBuffer )
+{
+uint8_t *pucData;
+
+    // Reserve space for a 10 byte frame, blocking for up to 100ms.
+    if( xStreamBufferSendReserve( xStreamBuffer, ( void ** ) &pucData, 10, pdMS_TO_TICKS( 100 ) ) != 0 )
+    {
+        // Build the frame in place, then make it available to the reader.
+        prvBuildFrame( pucData );
+        xStreamBufferSendCommit( xStreamBuffer, 10 );
+    }
+}
+</pre>
+ * \defgroup xStreamBufferSendReserve xStreamBufferSendReserve
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendReserve( StreamBufferHandle_t xStreamBuffer,
+								 void **ppvTxData,
+								 size_t xDataLengthBytes,
+								 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferSendReserveFromISR( StreamBufferHandle_t xStreamBuffer,
+                                        void **ppvTxData,
+                                        size_t xDataLengthBytes );
+</pre>
+ *
+ * A version of xStreamBufferSendReserve() that can be called from an interrupt
+ * service routine (ISR).  The reservation is committed by
+ * xStreamBufferSendCommitFromISR().
+ *
+ * @param xStreamBuffer The handle of the stream buffer in which space is being
+ * reserved.
+ *
+ * @param ppvTxData Set to point to the reserved space, or to NULL if the space
+ * could not be reserved.
+ *
+ * @param xDataLengthBytes The number of bytes to reserve.
+ *
+ * @return xDataLengthBytes if the space was reserved, otherwise 0.
+ *
+ * \defgroup xStreamBufferSendReserveFromISR xStreamBufferSendReserveFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendReserveFromISR( StreamBufferHandle_t xStreamBuffer,
+										void **ppvTxData,
+										size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+                                size_t xDataLengthBytes );
+</pre>
+ *
+ * Makes the first xDataLengthBytes of the space reserved by
+ * xStreamBufferSendReserve() available to the reader, and unblocks the reader
+ * if the trigger level is reached.  Fewer bytes than were reserved can be
+ * committed, and committing 0 bytes cancels the reservation.  Either way the
+ * reservation is no longer outstanding once this function returns.
+ *
+ * Use xStreamBufferSendCommitFromISR() to commit from an interrupt service
+ * routine (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer in which the space was
+ * reserved.
+ *
+ * @param xDataLengthBytes The number of bytes written to the reserved space.
+ *
+ * @return The number of bytes committed.
+ *
+ * \defgroup xStreamBufferSendCommit xStreamBufferSendCommit
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+								size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                       size_t xDataLengthBytes,
+                                       BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * A version of xStreamBufferSendCommit() that can be called from an interrupt
+ * service routine (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer in which the space was
+ * reserved.
+ *
+ * @param xDataLengthBytes The number of bytes written to the reserved space.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if committing the data
+ * unblocked a task that has a priority above the priority of the currently
+ * executing task, in which case a context switch should be requested before
+ * the interrupt is exited.  See xStreamBufferSendFromISR().
+ *
+ * @return The number of bytes committed.
+ *
+ * \defgroup xStreamBufferSendCommitFromISR xStreamBufferSendCommitFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+									   size_t xDataLengthBytes,
+									   BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+                                    void **ppvRxData,
+                                    TickType_t xTicksToWait );
+</pre>
+ *
+ * Obtains a pointer to the data at the front of a stream buffer so the data
+ * can be processed in place, rather than being copied out to a separate buffer
+ * by xStreamBufferReceive().  The data stays in the buffer until it is released
+ * by a call to xStreamBufferReceiveRelease().  Only one acquisition can be
+ * outstanding at a time, and xStreamBufferReceive() must not be called while
+ * an acquisition is outstanding.
+ *
+ * Only contiguous data is returned, so if the data wraps around the end of the
+ * storage area the bytes up to the end of the storage area are returned, and
+ * the remaining bytes are returned by the next acquisition.
+ *
+ * If the buffer is a message buffer then a whole message is returned.  Messages
+ * written by xStreamBufferSendReserve() are always contiguous, but messages
+ * written by xMessageBufferSend() can wrap around the end of the storage area,
+ * in which case 0 is returned and the message must be read with
+ * xMessageBufferReceive() instead.
+ *
+ * Use xStreamBufferReceiveAcquireFromISR() to acquire data from an interrupt
+ * service routine (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer from which data is being
+ * acquired.
+ *
+ * @param ppvRxData Set to point to the data, or to NULL if no data was
+ * acquired.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for data to become available if the stream buffer is
+ * empty.
+ *
+ * @return The number of bytes that can be read from *ppvRxData.
+ *
+ * Example use:
+<pre>
+void vAFunction( StreamBufferHandle_t xStreamBuffer )
+{
+uint8_t *pucData;
+size_t xReceivedBytes;
+
+    xReceivedBytes = xStreamBufferReceiveAcquire( xStreamBuffer, ( void ** ) &pucData, pdMS_TO_TICKS( 20 ) );
+
+    if( xReceivedBytes > 0 )
+    {
+        // Process the data in place, then free the space it occupied.
+        prvProcessBytes( pucData, xReceivedBytes );
+        xStreamBufferReceiveRelease( xStreamBuffer, xReceivedBytes );
+    }
+}
+</pre>
+ * \defgroup xStreamBufferReceiveAcquire xStreamBufferReceiveAcquire
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+									void **ppvRxData,
+									TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+                                           void **ppvRxData );
+</pre>
+ *
+ * A version of xStreamBufferReceiveAcquire() that can be called from an
+ * interrupt service routine (ISR).  The data is released by
+ * xStreamBufferReceiveReleaseFromISR().
+ *
+ * @param xStreamBuffer The handle of the stream buffer from which data is being
+ * acquired.
+ *
+ * @param ppvRxData Set to point to the data, or to NULL if no data was
+ * acquired.
+ *
+ * @return The number of bytes that can be read from *ppvRxData.
+ *
+ * \defgroup xStreamBufferReceiveAcquireFromISR xStreamBufferReceiveAcquireFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+										   void **ppvRxData ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer,
+                                    size_t xDataLengthBytes );
+</pre>
+ *
+ * Removes the first xDataLengthBytes of the data obtained by
+ * xStreamBufferReceiveAcquire() from the stream buffer, and unblocks the writer
+ * if it was waiting for space.  Fewer bytes than were acquired can be released
+ * from a stream buffer, but a message is always released in its entirety.
+ * Either way the acquisition is no longer outstanding once this function
+ * returns, and any data that was not released must be acquired again.
+ *
+ * Use xStreamBufferReceiveReleaseFromISR() to release data from an interrupt
+ * service routine (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer from which the data was
+ * acquired.
+ *
+ * @param xDataLengthBytes The number of bytes to remove from the stream buffer.
+ *
+ * @return The number of bytes removed from the stream buffer.
+ *
+ * \defgroup xStreamBufferReceiveRelease xStreamBufferReceiveRelease
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer,
+									size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+                                           size_t xDataLengthBytes,
+                                           BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * A version of xStreamBufferReceiveRelease() that can be called from an
+ * interrupt service routine (ISR).
+ *
+ * @param xStreamBuffer The handle of the stream buffer from which the data was
+ * acquired.
+ *
+ * @param xDataLengthBytes The number of bytes to remove from the stream buffer.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if releasing the data
+ * unblocked a task that has a priority above the priority of the currently
+ * executing task, in which case a context switch should be requested before
+ * the interrupt is exited.  See xStreamBufferReceiveFromISR().
+ *
+ * @return The number of bytes removed from the stream buffer.
+ *
+ * \defgroup xStreamBufferReceiveReleaseFromISR xStreamBufferReceiveReleaseFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+										   size_t xDataLengthBytes,
+										   BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /**
  * stream_buffer.h
  *
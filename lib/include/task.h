@@ -154,6 +154,17 @@ typedef enum
  */
 #define tskIDLE_PRIORITY			( ( UBaseType_t ) 0U )
 
+/**
+ * task. h
+ *
+ * Core affinity mask that allows a task to run on any core.  Only meaningful
+ * when configNUM_CORES is greater than 1 and configUSE_CORE_AFFINITY is 1.
+ *
+ * \defgroup tskNO_AFFINITY tskNO_AFFINITY
+ * \ingroup TaskUtils
+ */
+#define tskNO_AFFINITY				( ( UBaseType_t ) -1 )
+
 /**
  * task. h
  *
@@ -177,7 +188,11 @@ typedef enum
  * \ingroup SchedulerControl
  */
 #define taskENTER_CRITICAL()		portENTER_CRITICAL()
-#define taskENTER_CRITICAL_FROM_ISR() portSET_INTERRUPT_MASK_FROM_ISR()
+#if( configNUM_CORES > 1 )
+	#define taskENTER_CRITICAL_FROM_ISR() vTaskEnterCriticalFromISR()
+#else
+	#define taskENTER_CRITICAL_FROM_ISR() portSET_INTERRUPT_MASK_FROM_ISR()
+#endif
 
 /**
  * task. h
@@ -192,7 +207,11 @@ typedef enum
  * \ingroup SchedulerControl
  */
 #define taskEXIT_CRITICAL()			portEXIT_CRITICAL()
-#define taskEXIT_CRITICAL_FROM_ISR( x ) portCLEAR_INTERRUPT_MASK_FROM_ISR( x )
+#if( configNUM_CORES > 1 )
+	#define taskEXIT_CRITICAL_FROM_ISR( x ) vTaskExitCriticalFromISR( x )
+#else
+	#define taskEXIT_CRITICAL_FROM_ISR( x ) portCLEAR_INTERRUPT_MASK_FROM_ISR( x )
+#endif
 /**
  * task. h
  *
@@ -808,6 +827,47 @@ void vTaskDelay( const TickType_t xTicksToDelay ) PRIVILEGED_FUNCTION;
  */
 void vTaskDelayUntil( TickType_t * const pxPreviousWakeTime, const TickType_t xTimeIncrement ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * <pre>void vTaskDelayUntilHighResolutionTime( const uint64_t ullWakeTime );</pre>
+ *
+ * INCLUDE_vTaskDelay must be defined as 1 for this function to be available.
+ *
+ * Delay a task until ullTaskGetHighResolutionTime() reaches ullWakeTime, which
+ * can be between ticks.  The task blocks for as many whole tick periods as it
+ * can without passing the wake time, then busy waits, yielding to tasks of
+ * equal priority, for the remainder.  The busy wait is at most about one tick
+ * period, during which tasks of lower priority do not run.
+ *
+ * If the port does not define portGET_HIGH_RESOLUTION_COUNT() the time only
+ * advances with the tick, so the task simply blocks until the first tick at or
+ * after the wake time.
+ *
+ * The function returns immediately if the wake time has already passed.
+ *
+ * @param ullWakeTime The time, in nanoseconds on the ullTaskGetHighResolutionTime()
+ * clock, at which the calling task should continue.
+ *
+ * Example usage:
+   <pre>
+ // Send a packet every 250 microseconds.
+ void vTaskFunction( void * pvParameters )
+ {
+ uint64_t ullWakeTime = ullTaskGetHighResolutionTime();
+
+	 for( ;; )
+	 {
+		 ullWakeTime += 250000ULL;
+		 vTaskDelayUntilHighResolutionTime( ullWakeTime );
+		 vSendPacket();
+	 }
+ }
+   </pre>
+ * \defgroup vTaskDelayUntilHighResolutionTime vTaskDelayUntilHighResolutionTime
+ * \ingroup TaskCtrl
+ */
+void vTaskDelayUntilHighResolutionTime( const uint64_t ullWakeTime ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * <pre>BaseType_t xTaskAbortDelay( TaskHandle_t xTask );</pre>
@@ -1358,6 +1418,26 @@ TickType_t xTaskGetTickCount( void ) PRIVILEGED_FUNCTION;
  */
 TickType_t xTaskGetTickCountFromISR( void ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * <PRE>uint64_t ullTaskGetHighResolutionTime( void );</PRE>
+ *
+ * @return A monotonic time in nanoseconds.
+ *
+ * The time is the 64-bit extension of the count returned by the port's
+ * portGET_HIGH_RESOLUTION_COUNT(), so it has the resolution of that count
+ * rather than of the tick.  If the port does not define
+ * portGET_HIGH_RESOLUTION_COUNT() the time is the number of ticks since the
+ * scheduler was started converted to nanoseconds.
+ *
+ * The function does not enter a critical section, so it can be called from
+ * tasks and interrupts on any core, and it cannot block.
+ *
+ * \defgroup ullTaskGetHighResolutionTime ullTaskGetHighResolutionTime
+ * \ingroup TaskUtils
+ */
+uint64_t ullTaskGetHighResolutionTime( void ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * <PRE>uint16_t uxTaskGetNumberOfTasks( void );</PRE>
@@ -1450,6 +1530,40 @@ constant. */
 	#endif /* configUSE_APPLICATION_TASK_TAG ==1 */
 #endif /* ifdef configUSE_APPLICATION_TASK_TAG */
 
+#if( configUSE_HEAP_PROFILER == 1 )
+
+	/**
+	 * task.h
+	 * <pre>UBaseType_t uxTaskSetHeapTag( UBaseType_t uxTag );</pre>
+	 *
+	 * Sets the tag the heap profiler records against memory subsequently
+	 * allocated by the calling task, and returns the tag that was set before,
+	 * so a library can tag the memory it allocates then restore the caller's
+	 * tag.  See heap_profiler.h.  configUSE_HEAP_PROFILER must be set to 1 in
+	 * FreeRTOSConfig.h for this function to be available.
+	 *
+	 * Example usage:
+	   <pre>
+	UBaseType_t uxPreviousTag;
+
+		uxPreviousTag = uxTaskSetHeapTag( mainTLS_HEAP_TAG );
+		xResult = xTLSConnect( &xContext );
+		( void ) uxTaskSetHeapTag( uxPreviousTag );
+	   </pre>
+	 */
+	UBaseType_t uxTaskSetHeapTag( UBaseType_t uxTag ) PRIVILEGED_FUNCTION;
+
+	/**
+	 * task.h
+	 * <pre>UBaseType_t uxTaskGetHeapTag( TaskHandle_t xTask );</pre>
+	 *
+	 * Returns the heap profiler tag set by the task xTask.  Passing xTask as
+	 * NULL returns the calling task's tag.
+	 */
+	UBaseType_t uxTaskGetHeapTag( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_HEAP_PROFILER */
+
 #if( configNUM_THREAD_LOCAL_STORAGE_POINTERS > 0 )
 
 	/* Each task contains an array of pointers that is dimensioned by the
@@ -1484,6 +1598,56 @@ BaseType_t xTaskCallApplicationTaskHook( TaskHandle_t xTask, void *pvParameter )
  */
 TaskHandle_t xTaskGetIdleTaskHandle( void ) PRIVILEGED_FUNCTION;
 
+/**
+ * xTaskGetIdleTaskHandleForCore() is only available if
+ * INCLUDE_xTaskGetIdleTaskHandle is set to 1 in FreeRTOSConfig.h.
+ *
+ * Returns the handle of the idle task that runs on core xCoreID.  When
+ * configNUM_CORES is greater than 1 there is one idle task per core, and
+ * xTaskGetIdleTaskHandle() returns the idle task of core 0.
+ */
+TaskHandle_t xTaskGetIdleTaskHandleForCore( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>void vTaskCoreAffinitySet( const TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask );</pre>
+ *
+ * Only available when configNUM_CORES is greater than 1 and
+ * configUSE_CORE_AFFINITY is set to 1 in FreeRTOSConfig.h.
+ *
+ * Sets the set of cores on which a task may run.  Bit n of uxCoreAffinityMask
+ * is set to allow the task to run on core n.  Pass tskNO_AFFINITY to allow the
+ * task to run on any core.  If the task is running on a core it is no longer
+ * allowed to use then that core is made to yield.
+ *
+ * @param xTask The handle of the task to update.  Passing NULL sets the
+ * affinity of the calling task.
+ *
+ * @param uxCoreAffinityMask A bitwise value that indicates the cores on which
+ * the task can run.
+ *
+ * \defgroup vTaskCoreAffinitySet vTaskCoreAffinitySet
+ * \ingroup TaskCtrl
+ */
+void vTaskCoreAffinitySet( const TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>UBaseType_t uxTaskCoreAffinityGet( const TaskHandle_t xTask );</pre>
+ *
+ * Only available when configNUM_CORES is greater than 1 and
+ * configUSE_CORE_AFFINITY is set to 1 in FreeRTOSConfig.h.
+ *
+ * @param xTask The handle of the task to query.  Passing NULL queries the
+ * calling task.
+ *
+ * @return The core affinity mask of the task, as set by vTaskCoreAffinitySet().
+ *
+ * \defgroup uxTaskCoreAffinityGet uxTaskCoreAffinityGet
+ * \ingroup TaskCtrl
+ */
+UBaseType_t uxTaskCoreAffinityGet( const TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
 /**
  * configUSE_TRACE_FACILITY must be defined as 1 in FreeRTOSConfig.h for
  * uxTaskGetSystemState() to be available.
@@ -2235,6 +2399,13 @@ TickType_t uxTaskResetEventItemValue( void ) PRIVILEGED_FUNCTION;
  */
 TaskHandle_t xTaskGetCurrentTaskHandle( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Return the handle of the task running on core xCoreID.  Only meaningful
+ * when configNUM_CORES is greater than 1, otherwise the same as
+ * xTaskGetCurrentTaskHandle().
+ */
+TaskHandle_t xTaskGetCurrentTaskHandleForCore( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
 /*
  * Capture the current time status for future reference.
  */
@@ -2329,6 +2500,21 @@ TaskHandle_t pvTaskIncrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
  */
 void vTaskInternalSetTimeOutState( TimeOut_t * const pxTimeOut ) PRIVILEGED_FUNCTION;
 
+/*
+ * THESE FUNCTIONS MUST NOT BE USED FROM APPLICATION CODE.  They are only
+ * available when configNUM_CORES is greater than 1, in which case the port
+ * maps portENTER_CRITICAL() and portEXIT_CRITICAL() onto vTaskEnterCritical()
+ * and vTaskExitCritical(), and task.h maps taskENTER_CRITICAL_FROM_ISR() and
+ * taskEXIT_CRITICAL_FROM_ISR() onto the FromISR versions below.  A task level
+ * critical section masks interrupts on the calling core and holds both the
+ * task lock and the ISR lock.  An ISR level critical section masks interrupts
+ * and holds only the ISR lock.
+ */
+void vTaskEnterCritical( void ) PRIVILEGED_FUNCTION;
+void vTaskExitCritical( void ) PRIVILEGED_FUNCTION;
+UBaseType_t vTaskEnterCriticalFromISR( void ) PRIVILEGED_FUNCTION;
+void vTaskExitCriticalFromISR( UBaseType_t uxSavedInterruptStatus ) PRIVILEGED_FUNCTION;
+
 
 #ifdef __cplusplus
 }
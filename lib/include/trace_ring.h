@@ -0,0 +1,223 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * The trace ring records kernel events into a fixed size binary buffer for
+ * each core, so the events leading up to a point of interest can be decoded on
+ * the host by tools/kernel_trace/trace_decode.py.  Each core only writes to its
+ * own buffer, with interrupts masked on that core for the few instructions it
+ * takes to write an event, so no core ever waits for another.  When a buffer is
+ * full the oldest events are overwritten.
+ *
+ * Set configUSE_TRACE_RING to 1 in FreeRTOSConfig.h to record task switches,
+ * tasks becoming ready, tasks blocking, queue and semaphore operations,
+ * interrupt entry and exit, and FreeRTOS+TCP network events.  This header is
+ * then included by FreeRTOS.h, and defines the trace macros it records.
+ * configUSE_TRACE_FACILITY must also be set to 1, and
+ * configTRACE_RING_TIMESTAMP() must be defined to return a free running 32-bit
+ * counter that increments configTRACE_RING_TIMESTAMP_HZ times a second, such as
+ * a cycle counter.  Recording starts as soon as the first event occurs.
+ *
+ * The application must not define the trace macros defined by this header.
+ */
+
+#ifndef TRACE_RING_H
+#define TRACE_RING_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include trace_ring.h"
+#endif
+
+/* The trace macros read TCB and queue members that only exist when
+configUSE_TRACE_FACILITY is 1. */
+#if( configUSE_TRACE_FACILITY != 1 )
+	#error configUSE_TRACE_FACILITY must be set to 1 in FreeRTOSConfig.h to use the trace ring
+#endif
+
+#ifndef configTRACE_RING_TIMESTAMP
+	#error configTRACE_RING_TIMESTAMP() must be defined in FreeRTOSConfig.h to use the trace ring
+#endif
+
+#ifndef configTRACE_RING_TIMESTAMP_HZ
+	#error configTRACE_RING_TIMESTAMP_HZ must be defined in FreeRTOSConfig.h to use the trace ring
+#endif
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/* The version of the layout of the trace data, which is checked by the
+decoder. */
+#define trTRACE_RING_VERSION			( 1U )
+
+/* The value of the first word of the trace data, used by the decoder to find
+the byte order of the trace. */
+#define trTRACE_RING_MAGIC				( 0x52545246UL ) /* "FRTR" in little endian byte order. */
+
+/* Event identifiers, stored in the ucEvent field of each event.  The meaning of
+ulArg1 and ulArg2 is given after each identifier.  Task and object identifiers
+are described below. */
+#define trEVENT_TASK_CREATE				( 1U )	/* Task, priority. */
+#define trEVENT_TASK_DELETE				( 2U )	/* Task, 0. */
+#define trEVENT_TASK_SWITCHED_IN		( 3U )	/* Task, priority. */
+#define trEVENT_TASK_READY				( 4U )	/* Task, 0. */
+#define trEVENT_TASK_BLOCK				( 5U )	/* Object, one of the trBLOCK_ reasons below. */
+#define trEVENT_QUEUE_SEND				( 6U )	/* Queue, queue type as defined in queue.h. */
+#define trEVENT_QUEUE_RECEIVE			( 7U )	/* Queue, queue type as defined in queue.h. */
+#define trEVENT_ISR_ENTER				( 8U )	/* Interrupt number, 0. */
+#define trEVENT_ISR_EXIT				( 9U )	/* Interrupt number, 0. */
+#define trEVENT_IP						( 10U )	/* One of the trIP_ events below, event specific value. */
+#define trEVENT_USER					( 11U )	/* Values passed to vTraceRingUserEvent(). */
+
+/* Reasons a task blocked, stored in ulArg2 of trEVENT_TASK_BLOCK events. */
+#define trBLOCK_QUEUE_SEND				( 1U )
+#define trBLOCK_QUEUE_RECEIVE			( 2U )
+#define trBLOCK_DELAY					( 3U )
+#define trBLOCK_NOTIFY					( 4U )
+#define trBLOCK_EVENT_GROUP				( 5U )
+#define trBLOCK_STREAM_BUFFER_SEND		( 6U )
+#define trBLOCK_STREAM_BUFFER_RECEIVE	( 7U )
+
+/* FreeRTOS+TCP events, stored in ulArg1 of trEVENT_IP events. */
+#define trIP_NETWORK_INTERFACE_RECEIVE	( 1U )	/* 0. */
+#define trIP_NETWORK_INTERFACE_TRANSMIT	( 2U )	/* 0. */
+#define trIP_NETWORK_EVENT_RECEIVED		( 3U )	/* The eIPEvent_t received by the IP task. */
+#define trIP_SENDING_UDP_PACKET			( 4U )	/* Destination IP address. */
+#define trIP_NETWORK_BUFFER_OBTAIN_FAILED	( 5U )	/* 0. */
+#define trIP_RX_EVENT_LOST				( 6U )	/* 0. */
+#define trIP_TX_EVENT_LOST				( 7U )	/* The eIPEvent_t that was lost. */
+
+/* Tasks are identified by the number the kernel gives each task when it is
+created, which is never reused.  Queues, semaphores and other objects are
+identified by the least significant 32 bits of their address.  Events that
+relate to the running task, such as a task blocking, do not identify the task,
+as the decoder knows which task is running on each core. */
+#define trOBJECT_ID( pvObject )			( ( uint32_t ) ( portPOINTER_SIZE_TYPE ) ( pvObject ) )
+
+/* The number of bytes of each task name stored in the trace data, which is the
+task name length rounded up to a multiple of four. */
+#define trTASK_NAME_LENGTH				( ( ( configMAX_TASK_NAME_LEN ) + 3 ) & ~3 )
+
+/* One recorded event. */
+typedef struct xTRACE_RING_EVENT
+{
+	uint32_t ulTimestamp;		/* configTRACE_RING_TIMESTAMP() when the event occurred. */
+	uint8_t ucEvent;			/* One of the trEVENT_ identifiers. */
+	uint8_t ucReserved;
+	uint16_t usReserved;
+	uint32_t ulArg1;
+	uint32_t ulArg2;
+} TraceRingEvent_t;
+
+/* The name of a task, recorded when the task is created.  Names are held apart
+from the events so they are not overwritten by later events. */
+typedef struct xTRACE_RING_TASK_NAME
+{
+	uint32_t ulTask;
+	char cName[ trTASK_NAME_LENGTH ];
+} TraceRingTaskName_t;
+
+/*
+ * Record a task being created, and any other event.  These functions are
+ * called by the trace macros below and are not intended to be called directly.
+ */
+void vTraceRingTaskCreate( UBaseType_t uxTask, const char *pcName, UBaseType_t uxPriority );
+void vTraceRingEvent( uint8_t ucEvent, uint32_t ulArg1, uint32_t ulArg2 );
+
+/*
+ * Records an application defined event.  Can be called from tasks and
+ * interrupts.  The decoder shows ulId and ulValue.
+ */
+void vTraceRingUserEvent( uint32_t ulId, uint32_t ulValue );
+
+/*
+ * Stops recording, so the recorded events are not overwritten while they are
+ * read.
+ */
+void vTraceRingStop( void );
+
+/*
+ * Restarts recording after vTraceRingStop().  If xClear is pdTRUE then the
+ * events already recorded are discarded.  Task names are kept.
+ */
+void vTraceRingStart( BaseType_t xClear );
+
+/*
+ * Returns the number of events recorded on all cores since recording last
+ * started, including events that have since been overwritten.
+ */
+uint32_t ulTraceRingGetEventCount( void );
+
+/*
+ * Completes the header of the trace data, then returns the start of the trace
+ * data and its size in *pxSize.  The trace data is a single block of memory
+ * that can be saved to a file by the application, or by a debugger once this
+ * function has been called, and decoded with tools/kernel_trace/trace_decode.py.
+ * Call vTraceRingStop() first so the events are not overwritten as they are
+ * saved.
+ */
+const void *pvTraceRingGetData( size_t *pxSize );
+
+/* Kernel trace macros recorded by the trace ring.  pxCurrentTCB, pxQueue and
+the other names used here are in scope where the kernel uses each macro. */
+#define traceTASK_CREATE( pxNewTCB )									vTraceRingTaskCreate( ( pxNewTCB )->uxTCBNumber, ( pxNewTCB )->pcTaskName, ( pxNewTCB )->uxPriority )
+#define traceTASK_DELETE( pxTaskToDelete )								vTraceRingEvent( trEVENT_TASK_DELETE, ( uint32_t ) ( pxTaskToDelete )->uxTCBNumber, 0UL )
+#define traceTASK_SWITCHED_IN()											vTraceRingEvent( trEVENT_TASK_SWITCHED_IN, ( uint32_t ) pxCurrentTCB->uxTCBNumber, ( uint32_t ) pxCurrentTCB->uxPriority )
+#define traceMOVED_TASK_TO_READY_STATE( pxTCB )							vTraceRingEvent( trEVENT_TASK_READY, ( uint32_t ) ( pxTCB )->uxTCBNumber, 0UL )
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )						vTraceRingEvent( trEVENT_TASK_BLOCK, trOBJECT_ID( pxQueue ), trBLOCK_QUEUE_RECEIVE )
+#define traceBLOCKING_ON_QUEUE_PEEK( pxQueue )							vTraceRingEvent( trEVENT_TASK_BLOCK, trOBJECT_ID( pxQueue ), trBLOCK_QUEUE_RECEIVE )
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )							vTraceRingEvent( trEVENT_TASK_BLOCK, trOBJECT_ID( pxQueue ), trBLOCK_QUEUE_SEND )
+#define traceTASK_DELAY()												vTraceRingEvent( trEVENT_TASK_BLOCK, 0UL, trBLOCK_DELAY )
+#define traceTASK_DELAY_UNTIL( xTimeToWake )							vTraceRingEvent( trEVENT_TASK_BLOCK, 0UL, trBLOCK_DELAY )
+#define traceTASK_NOTIFY_TAKE_BLOCK()									vTraceRingEvent( trEVENT_TASK_BLOCK, 0UL, trBLOCK_NOTIFY )
+#define traceTASK_NOTIFY_WAIT_BLOCK()									vTraceRingEvent( trEVENT_TASK_BLOCK, 0UL, trBLOCK_NOTIFY )
+#define traceEVENT_GROUP_SYNC_BLOCK( xEventGroup, uxBitsToSet, uxBitsToWaitFor )	vTraceRingEvent( trEVENT_TASK_BLOCK, trOBJECT_ID( xEventGroup ), trBLOCK_EVENT_GROUP )
+#define traceEVENT_GROUP_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor )	vTraceRingEvent( trEVENT_TASK_BLOCK, trOBJECT_ID( xEventGroup ), trBLOCK_EVENT_GROUP )
+#define traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer )			vTraceRingEvent( trEVENT_TASK_BLOCK, trOBJECT_ID( xStreamBuffer ), trBLOCK_STREAM_BUFFER_SEND )
+#define traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer )			vTraceRingEvent( trEVENT_TASK_BLOCK, trOBJECT_ID( xStreamBuffer ), trBLOCK_STREAM_BUFFER_RECEIVE )
+#define traceQUEUE_SEND( pxQueue )										vTraceRingEvent( trEVENT_QUEUE_SEND, trOBJECT_ID( pxQueue ), ( uint32_t ) ( pxQueue )->ucQueueType )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )								vTraceRingEvent( trEVENT_QUEUE_SEND, trOBJECT_ID( pxQueue ), ( uint32_t ) ( pxQueue )->ucQueueType )
+#define traceQUEUE_RECEIVE( pxQueue )									vTraceRingEvent( trEVENT_QUEUE_RECEIVE, trOBJECT_ID( pxQueue ), ( uint32_t ) ( pxQueue )->ucQueueType )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )							vTraceRingEvent( trEVENT_QUEUE_RECEIVE, trOBJECT_ID( pxQueue ), ( uint32_t ) ( pxQueue )->ucQueueType )
+#define traceISR_ENTER( uxISRNumber )									vTraceRingEvent( trEVENT_ISR_ENTER, ( uint32_t ) ( uxISRNumber ), 0UL )
+#define traceISR_EXIT( uxISRNumber )									vTraceRingEvent( trEVENT_ISR_EXIT, ( uint32_t ) ( uxISRNumber ), 0UL )
+
+/* FreeRTOS+TCP trace macros recorded by the trace ring. */
+#define iptraceNETWORK_INTERFACE_RECEIVE()								vTraceRingEvent( trEVENT_IP, trIP_NETWORK_INTERFACE_RECEIVE, 0UL )
+#define iptraceNETWORK_INTERFACE_TRANSMIT()								vTraceRingEvent( trEVENT_IP, trIP_NETWORK_INTERFACE_TRANSMIT, 0UL )
+#define iptraceNETWORK_EVENT_RECEIVED( eEvent )							vTraceRingEvent( trEVENT_IP, trIP_NETWORK_EVENT_RECEIVED, ( uint32_t ) ( eEvent ) )
+#define iptraceSENDING_UDP_PACKET( ulIPAddress )						vTraceRingEvent( trEVENT_IP, trIP_SENDING_UDP_PACKET, ( uint32_t ) ( ulIPAddress ) )
+#define iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER()						vTraceRingEvent( trEVENT_IP, trIP_NETWORK_BUFFER_OBTAIN_FAILED, 0UL )
+#define iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER_FROM_ISR()				vTraceRingEvent( trEVENT_IP, trIP_NETWORK_BUFFER_OBTAIN_FAILED, 0UL )
+#define iptraceETHERNET_RX_EVENT_LOST()									vTraceRingEvent( trEVENT_IP, trIP_RX_EVENT_LOST, 0UL )
+#define iptraceSTACK_TX_EVENT_LOST( xEvent )							vTraceRingEvent( trEVENT_IP, trIP_TX_EVENT_LOST, ( uint32_t ) ( xEvent ) )
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( TRACE_RING_H ) */
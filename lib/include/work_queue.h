@@ -0,0 +1,469 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Work queues run functions on behalf of interrupts, libraries and other tasks
+ * in the context of a pool of worker tasks.  Unlike functions pended to the
+ * timer service task with xTimerPendFunctionCall(), functions submitted to a
+ * work queue can run in parallel with each other and do not delay timer
+ * expiries, so a slow function only holds up the worker running it.
+ *
+ * Each function is described by a work item, which the application allocates
+ * and initialises with vWorkItemInit().  A work item is submitted at one of
+ * configWORK_QUEUE_PRIORITY_LEVELS priority levels - workers always run items
+ * at higher levels first, and items at the same level in the order they were
+ * submitted.  Items can be submitted to run after a delay, and can be cancelled
+ * until they start running.  A worker takes up to configWORK_QUEUE_BATCH_SIZE
+ * items each time it accesses the queue, and a submitted item only wakes a
+ * worker if no worker is already on its way to take items, so bursts of work
+ * cost few context switches.
+ *
+ * The time each item spends queued is recorded in a histogram that can be read
+ * with vWorkQueueGetStats().
+ *
+ * configUSE_WORK_QUEUES must be set to 1 in FreeRTOSConfig.h to use work queues,
+ * in which case the system work queue is created when the scheduler starts.
+ * Passing NULL as the work queue handle to any of the functions below selects
+ * the system work queue.
+ */
+
+#ifndef WORK_QUEUE_H
+#define WORK_QUEUE_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include work_queue.h"
+#endif
+
+#include "list.h"
+
+#if defined( __cplusplus )
+extern "C" {
+#endif
+
+/**
+ * Type by which work queues are referenced.  For example, a call to
+ * xWorkQueueCreate() returns a WorkQueueHandle_t variable that can then be used
+ * as a parameter to xWorkQueueSubmit(), vWorkQueueGetStats(), etc.
+ */
+struct WorkQueueDef_t;
+typedef struct WorkQueueDef_t * WorkQueueHandle_t;
+
+/*
+ * Defines the prototype to which work functions must conform.  It matches the
+ * prototype of functions pended with xTimerPendFunctionCall(), so such
+ * functions can be submitted to a work queue unchanged.
+ */
+typedef void (*WorkFunction_t)( void *, uint32_t );
+
+/*
+ * Describes one function to run on a work queue.  The application allocates
+ * the work item, which must remain valid while the item is queued or running,
+ * and initialises it with vWorkItemInit().  The members are private to the work
+ * queue implementation and must not be accessed directly.
+ */
+typedef struct xWORK_ITEM
+{
+	ListItem_t xListItem;
+	WorkFunction_t pxFunction;
+	void *pvParameter1;
+	uint32_t ulParameter2;
+	struct WorkQueueDef_t *pxWorkQueue;
+	uint32_t ulReadyTime;
+	UBaseType_t uxPriority;
+	uint8_t ucState;
+} WorkItem_t;
+
+/**
+ * Used with vWorkQueueGetStats() to obtain the statistics of a work queue.
+ *
+ * uxLatencyHistogram[ 0 ] counts items that started running in the same
+ * configWORK_QUEUE_TIMESTAMP() period in which they became ready to run, and
+ * uxLatencyHistogram[ n ] counts items that waited from 2^(n-1) up to 2^n - 1
+ * periods.  The last entry also counts every item that waited longer.  An item
+ * becomes ready to run when it is submitted, or, if it was submitted with a
+ * delay, when a worker finds its delay has expired.
+ */
+typedef struct xWORK_QUEUE_STATS
+{
+	UBaseType_t uxSubmitted;			/* The number of items submitted. */
+	UBaseType_t uxExecuted;				/* The number of items that have finished running. */
+	UBaseType_t uxCancelled;			/* The number of items cancelled before they ran. */
+	UBaseType_t uxWorkerWakeups;		/* The number of times an idle worker was woken to run items. */
+	UBaseType_t uxMaximumBatch;			/* The most items a worker has taken at once. */
+	uint32_t ulMaximumLatency;			/* The longest time an item has waited to start running. */
+	UBaseType_t uxLatencyHistogram[ configWORK_QUEUE_HISTOGRAM_BUCKETS ];
+} WorkQueueStats_t;
+
+/**
+ * work_queue.h
+ *
+<pre>
+WorkQueueHandle_t xWorkQueueCreate( const char * const pcName,
+                                    UBaseType_t uxWorkerCount,
+                                    UBaseType_t uxWorkerPriority,
+                                    const configSTACK_DEPTH_TYPE usStackDepth );
+</pre>
+ *
+ * Creates a work queue and its worker tasks.  Work queues, like the timer
+ * service task, exist for the lifetime of the application, so cannot be
+ * deleted.
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xWorkQueueCreate() to be available.
+ *
+ * @param pcName The name given to each worker task.
+ *
+ * @param uxWorkerCount The number of worker tasks, which is the most items
+ * from the queue that can run at once.
+ *
+ * @param uxWorkerPriority The priority at which the worker tasks run.
+ *
+ * @param usStackDepth The size of each worker task's stack, in words.  Must be
+ * large enough for the deepest work function.
+ *
+ * @return The handle of the created work queue, or NULL if there was
+ * insufficient heap memory available to create the queue and its workers.
+ *
+ * \defgroup xWorkQueueCreate xWorkQueueCreate
+ * \ingroup WorkQueueManagement
+ */
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	WorkQueueHandle_t xWorkQueueCreate( const char * const pcName,
+										UBaseType_t uxWorkerCount,
+										UBaseType_t uxWorkerPriority,
+										const configSTACK_DEPTH_TYPE usStackDepth ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * work_queue.h
+ *
+<pre>
+void vWorkItemInit( WorkItem_t *pxWorkItem,
+                    WorkFunction_t pxFunction,
+                    void *pvParameter1,
+                    uint32_t ulParameter2 );
+</pre>
+ *
+ * Initialises a work item so it can be submitted to a work queue.  Must not be
+ * called while the item is queued or running.
+ *
+ * @param pxWorkItem The work item to initialise.
+ *
+ * @param pxFunction The function the item runs.
+ *
+ * @param pvParameter1 The value passed into the function as its first
+ * parameter.
+ *
+ * @param ulParameter2 The value passed into the function as its second
+ * parameter.
+ *
+ * \defgroup vWorkItemInit vWorkItemInit
+ * \ingroup WorkQueueManagement
+ */
+void vWorkItemInit( WorkItem_t *pxWorkItem,
+					WorkFunction_t pxFunction,
+					void *pvParameter1,
+					uint32_t ulParameter2 ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+BaseType_t xWorkQueueSubmit( WorkQueueHandle_t xWorkQueue,
+                             WorkItem_t *pxWorkItem,
+                             UBaseType_t uxPriority );
+</pre>
+ *
+ * Queues a work item to run as soon as a worker is available.
+ *
+ * An item is never queued twice and never runs on two workers at once.  If the
+ * item is already queued then this function does nothing and returns pdFAIL.
+ * If the item is running then it is queued again when it finishes, so an event
+ * that happens while the item runs is not missed.
+ *
+ * Use xWorkQueueSubmitFromISR() to submit an item from an interrupt service
+ * routine (ISR).
+ *
+ * @param xWorkQueue The handle of the work queue, or NULL for the system work
+ * queue.
+ *
+ * @param pxWorkItem The work item to queue.
+ *
+ * @param uxPriority The priority level of the item, from 0 (the lowest) to
+ * configWORK_QUEUE_PRIORITY_LEVELS - 1.
+ *
+ * @return pdPASS if the item was queued, otherwise pdFAIL.
+ *
+ * Example use:
+<pre>
+static WorkItem_t xRxWork;
+
+// Processes the packets an interrupt has received.
+static void prvProcessRx( void *pvInterface, uint32_t ulUnused )
+{
+    ...
+}
+
+void vSetupRxProcessing( void *pvInterface )
+{
+    vWorkItemInit( &xRxWork, prvProcessRx, pvInterface, 0 );
+}
+
+void vRxInterruptHandler( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    // Clear the interrupt, then defer the processing.  If the work item is
+    // already queued, one run processes all the packets received so far.
+    ( void ) xWorkQueueSubmitFromISR( NULL, &xRxWork, 1, &xHigherPriorityTaskWoken );
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+</pre>
+ * \defgroup xWorkQueueSubmit xWorkQueueSubmit
+ * \ingroup WorkQueueManagement
+ */
+BaseType_t xWorkQueueSubmit( WorkQueueHandle_t xWorkQueue,
+							 WorkItem_t *pxWorkItem,
+							 UBaseType_t uxPriority ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+BaseType_t xWorkQueueSubmitFromISR( WorkQueueHandle_t xWorkQueue,
+                                    WorkItem_t *pxWorkItem,
+                                    UBaseType_t uxPriority,
+                                    BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * A version of xWorkQueueSubmit() that can be called from an interrupt service
+ * routine (ISR).
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if a worker task that has a
+ * priority above the priority of the currently executing task was woken, in
+ * which case a context switch should be requested before the interrupt is
+ * exited.  *pxHigherPriorityTaskWoken must be initialised to pdFALSE before it
+ * is passed into the function.
+ *
+ * \defgroup xWorkQueueSubmitFromISR xWorkQueueSubmitFromISR
+ * \ingroup WorkQueueManagement
+ */
+BaseType_t xWorkQueueSubmitFromISR( WorkQueueHandle_t xWorkQueue,
+									WorkItem_t *pxWorkItem,
+									UBaseType_t uxPriority,
+									BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+BaseType_t xWorkQueueSubmitDelayed( WorkQueueHandle_t xWorkQueue,
+                                    WorkItem_t *pxWorkItem,
+                                    UBaseType_t uxPriority,
+                                    TickType_t xDelay );
+</pre>
+ *
+ * Queues a work item to run once xDelay ticks have passed.  Otherwise behaves
+ * as xWorkQueueSubmit(), except that an item that is running when it is
+ * submitted is queued again without the delay when it finishes.
+ *
+ * @param xDelay The number of ticks to wait before the item becomes ready to
+ * run.  Must be less than portMAX_DELAY.
+ *
+ * \defgroup xWorkQueueSubmitDelayed xWorkQueueSubmitDelayed
+ * \ingroup WorkQueueManagement
+ */
+BaseType_t xWorkQueueSubmitDelayed( WorkQueueHandle_t xWorkQueue,
+									WorkItem_t *pxWorkItem,
+									UBaseType_t uxPriority,
+									TickType_t xDelay ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+BaseType_t xWorkItemCancel( WorkItem_t *pxWorkItem );
+</pre>
+ *
+ * Removes a work item from the work queue it was submitted to, so it does not
+ * run.  An item that has already started running cannot be cancelled, but if
+ * it was submitted again while running then it is not queued again when it
+ * finishes.
+ *
+ * @param pxWorkItem The work item to cancel.
+ *
+ * @return pdPASS if the item was removed from the queue before it ran, or
+ * pdFAIL if the item was not queued or had already started running.
+ *
+ * \defgroup xWorkItemCancel xWorkItemCancel
+ * \ingroup WorkQueueManagement
+ */
+BaseType_t xWorkItemCancel( WorkItem_t *pxWorkItem ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+BaseType_t xWorkItemIsBusy( WorkItem_t *pxWorkItem );
+</pre>
+ *
+ * Queries whether a work item is queued or running.
+ *
+ * @param pxWorkItem The work item being queried.
+ *
+ * @return pdTRUE if the item is queued, waiting for its delay to expire, or
+ * running, otherwise pdFALSE.
+ *
+ * \defgroup xWorkItemIsBusy xWorkItemIsBusy
+ * \ingroup WorkQueueManagement
+ */
+BaseType_t xWorkItemIsBusy( WorkItem_t *pxWorkItem ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+BaseType_t xWorkQueuePendFunctionCall( WorkQueueHandle_t xWorkQueue,
+                                       WorkFunction_t xFunctionToPend,
+                                       void *pvParameter1,
+                                       uint32_t ulParameter2,
+                                       UBaseType_t uxPriority,
+                                       TickType_t xTicksToWait );
+</pre>
+ *
+ * Runs a function on a work queue without the caller providing a work item,
+ * for code moving from xTimerPendFunctionCall().  The work item is taken from a
+ * pool of configWORK_QUEUE_PEND_CALL_ITEMS items held by each work queue, and
+ * returned to the pool once the function has run.  Setting
+ * configPEND_FUNCTION_CALL_USE_WORK_QUEUE to 1 in FreeRTOSConfig.h makes
+ * xTimerPendFunctionCall() and xTimerPendFunctionCallFromISR() use this
+ * function to run pended functions on the system work queue, which moves every
+ * existing user, including xEventGroupSetBitsFromISR(), off the timer service
+ * task.
+ *
+ * @param xFunctionToPend The function to run.
+ *
+ * @param pvParameter1 The value passed into the function as its first
+ * parameter.
+ *
+ * @param ulParameter2 The value passed into the function as its second
+ * parameter.
+ *
+ * @param uxPriority The priority level at which the function runs.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should
+ * remain in the Blocked state to wait for a work item to become available in
+ * the pool.
+ *
+ * @return pdPASS if the function was queued, or pdFAIL if no work item became
+ * available before the block time expired.
+ *
+ * \defgroup xWorkQueuePendFunctionCall xWorkQueuePendFunctionCall
+ * \ingroup WorkQueueManagement
+ */
+BaseType_t xWorkQueuePendFunctionCall( WorkQueueHandle_t xWorkQueue,
+									   WorkFunction_t xFunctionToPend,
+									   void *pvParameter1,
+									   uint32_t ulParameter2,
+									   UBaseType_t uxPriority,
+									   TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+BaseType_t xWorkQueuePendFunctionCallFromISR( WorkQueueHandle_t xWorkQueue,
+                                              WorkFunction_t xFunctionToPend,
+                                              void *pvParameter1,
+                                              uint32_t ulParameter2,
+                                              UBaseType_t uxPriority,
+                                              BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * A version of xWorkQueuePendFunctionCall() that can be called from an
+ * interrupt service routine (ISR).
+ *
+ * @return pdPASS if the function was queued, or pdFAIL if the pool of work
+ * items was empty.
+ *
+ * \defgroup xWorkQueuePendFunctionCallFromISR xWorkQueuePendFunctionCallFromISR
+ * \ingroup WorkQueueManagement
+ */
+BaseType_t xWorkQueuePendFunctionCallFromISR( WorkQueueHandle_t xWorkQueue,
+											  WorkFunction_t xFunctionToPend,
+											  void *pvParameter1,
+											  uint32_t ulParameter2,
+											  UBaseType_t uxPriority,
+											  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+void vWorkQueueGetStats( WorkQueueHandle_t xWorkQueue, WorkQueueStats_t *pxWorkQueueStats );
+</pre>
+ *
+ * Obtains a consistent snapshot of a work queue's statistics.
+ *
+ * @param xWorkQueue The handle of the work queue, or NULL for the system work
+ * queue.
+ *
+ * @param pxWorkQueueStats The structure into which the statistics are written.
+ *
+ * \defgroup vWorkQueueGetStats vWorkQueueGetStats
+ * \ingroup WorkQueueManagement
+ */
+void vWorkQueueGetStats( WorkQueueHandle_t xWorkQueue, WorkQueueStats_t *pxWorkQueueStats ) PRIVILEGED_FUNCTION;
+
+/**
+ * work_queue.h
+ *
+<pre>
+void vWorkQueueResetStats( WorkQueueHandle_t xWorkQueue );
+</pre>
+ *
+ * Sets all of a work queue's statistics back to zero.
+ *
+ * @param xWorkQueue The handle of the work queue, or NULL for the system work
+ * queue.
+ *
+ * \defgroup vWorkQueueResetStats vWorkQueueResetStats
+ * \ingroup WorkQueueManagement
+ */
+void vWorkQueueResetStats( WorkQueueHandle_t xWorkQueue ) PRIVILEGED_FUNCTION;
+
+/*
+ * Functions beyond this part are not part of the public API and are intended
+ * for use by the kernel only.
+ */
+BaseType_t xWorkQueueCreateSystemWorkQueue( void ) PRIVILEGED_FUNCTION;
+
+#if defined( __cplusplus )
+}
+#endif
+
+#endif	/* !defined( WORK_QUEUE_H ) */
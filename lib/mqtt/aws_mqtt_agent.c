@@ -1272,6 +1272,10 @@ static TickType_t prvManageConnections( void )
     TickType_t xNextMQTTPeriodicInvokeTicks, xNextTimeoutTicks = portMAX_DELAY;
     uint64_t xTickCount = 0;
 
+    #if ( mqttconfigENABLE_ZERO_COPY_RECEIVE == 1 )
+        const uint8_t * pucReceived = NULL;
+    #endif
+
     /* For each broker the MQTT task might be connected to. */
     for( uxBrokerNumber = 0; uxBrokerNumber < ( UBaseType_t ) mqttconfigMAX_BROKERS; uxBrokerNumber++ )
     {
@@ -1280,13 +1284,30 @@ static TickType_t prvManageConnections( void )
         /* Process only the connected clients. */
         if( pxConnection->xSocket != SOCKETS_INVALID_SOCKET )
         {
-            /* Read data from the socket. */
-            lBytesReceived = SOCKETS_Recv( pxConnection->xSocket, pxConnection->ucRxBuffer, mqttconfigRX_BUFFER_SIZE, 0 );
+            #if ( mqttconfigENABLE_ZERO_COPY_RECEIVE == 1 )
+                /* Borrow the received data from the socket. */
+                lBytesReceived = SOCKETS_RecvZeroCopy( pxConnection->xSocket, &pucReceived );
+            #else
+                /* Read data from the socket. */
+                lBytesReceived = SOCKETS_Recv( pxConnection->xSocket, pxConnection->ucRxBuffer, mqttconfigRX_BUFFER_SIZE, 0 );
+            #endif
 
             /* If data was read, pass it to the MQTT Core library. */
             if( lBytesReceived > 0 )
             {
-                ( void ) MQTT_ParseReceivedData( &( pxConnection->xMQTTContext ), pxConnection->ucRxBuffer, ( size_t ) lBytesReceived );
+                #if ( mqttconfigENABLE_ZERO_COPY_RECEIVE == 1 )
+                    /* The MQTT Core library copies anything it keeps, so the
+                     * data is handed back once it is parsed, unless parsing it
+                     * disconnected and closed the socket. */
+                    ( void ) MQTT_ParseReceivedData( &( pxConnection->xMQTTContext ), pucReceived, ( size_t ) lBytesReceived );
+
+                    if( pxConnection->xSocket != SOCKETS_INVALID_SOCKET )
+                    {
+                        ( void ) SOCKETS_RecvRelease( pxConnection->xSocket, ( size_t ) lBytesReceived );
+                    }
+                #else
+                    ( void ) MQTT_ParseReceivedData( &( pxConnection->xMQTTContext ), pxConnection->ucRxBuffer, ( size_t ) lBytesReceived );
+                #endif
 
                 /* Some data was received on this socket and we do not
                  * know if there is more data available. Therefore we
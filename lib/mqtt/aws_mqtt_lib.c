@@ -515,11 +515,41 @@ static void prvProcessReceivedFixedHeaderOnlyMQTTPacket( MQTTContext_t * pxMQTTC
  *
  * This is invoked whenever a complete MQTT message is received. Depending on
  * the received message it may invoke the user supplied callback to inform
- * about the received message. The message is contained in pxMQTTContext->xRxBuffer.
+ * about the received message. The message is either in pxMQTTContext->xRxBuffer
+ * or, if it arrived in a single call to MQTT_ParseReceivedData, still in the
+ * received data, in which case pxMQTTContext->xRxBuffer is NULL. Its length is
+ * pxMQTTContext->xRxMessageState.ulTotalMessageLength.
  *
  * @param[in] pxMQTTContext The MQTT context for which the message was received.
+ * @param[in] pucPacket The received message.
  */
-static void prvProcessReceivedMQTTPacket( MQTTContext_t * pxMQTTContext );
+static void prvProcessReceivedMQTTPacket( MQTTContext_t * pxMQTTContext,
+                                          const uint8_t * pucPacket );
+
+/**
+ * @brief Processes the MQTT message at the start of the received data if all
+ * of it has been received.
+ *
+ * This is the fast path of MQTT_ParseReceivedData, used when it is looking for
+ * the start of a new message. The fixed header is decoded straight from the
+ * received data rather than a byte at a time and, if the whole message is
+ * present, the message is processed where it is. Only publish messages, whose
+ * buffer the user may take ownership of, are copied into a buffer from the
+ * free buffer pool first, and not even those if
+ * mqttconfigENABLE_IN_PLACE_PUBLISH_DISPATCH is 1. Messages that are not all
+ * present are left to the copying reassembly in MQTT_ParseReceivedData.
+ *
+ * @param[in] pxMQTTContext The MQTT context for which the data was received.
+ * @param[in] pucReceivedData The received data, starting at the first byte of
+ * a message.
+ * @param[in] xReceivedDataLength The length of the received data.
+ *
+ * @return The length of the message processed, or zero if the received data
+ * does not contain all of the message.
+ */
+static size_t prvProcessReceivedCompleteMQTTPacket( MQTTContext_t * pxMQTTContext,
+                                                    const uint8_t * pucReceivedData,
+                                                    size_t xReceivedDataLength );
 
 /**
  * @brief Decodes and processes the received CONNACK message.
@@ -529,8 +559,10 @@ static void prvProcessReceivedMQTTPacket( MQTTContext_t * pxMQTTContext );
  * callback to inform about the received message.
  *
  * @param[in] pxMQTTContext The MQTT context for which the message was received.
+ * @param[in] pucPacket The received message.
  */
-static void prvProcessReceivedCONNACK( MQTTContext_t * pxMQTTContext );
+static void prvProcessReceivedCONNACK( MQTTContext_t * pxMQTTContext,
+                                       const uint8_t * pucPacket );
 
 /**
  * @brief Decodes and processes the received SUBACK message.
@@ -540,8 +572,10 @@ static void prvProcessReceivedCONNACK( MQTTContext_t * pxMQTTContext );
  * callback to inform about the received message.
  *
  * @param[in] pxMQTTContext The MQTT context for which the message was received.
+ * @param[in] pucPacket The received message.
  */
-static void prvProcessReceivedSUBACK( MQTTContext_t * pxMQTTContext );
+static void prvProcessReceivedSUBACK( MQTTContext_t * pxMQTTContext,
+                                      const uint8_t * pucPacket );
 
 /**
  * @brief Decodes and processes the received UNSUBACK message.
@@ -551,8 +585,10 @@ static void prvProcessReceivedSUBACK( MQTTContext_t * pxMQTTContext );
  * callback to inform about the received message.
  *
  * @param[in] pxMQTTContext The MQTT context for which the message was received.
+ * @param[in] pucPacket The received message.
  */
-static void prvProcessReceivedUNSUBACK( MQTTContext_t * pxMQTTContext );
+static void prvProcessReceivedUNSUBACK( MQTTContext_t * pxMQTTContext,
+                                        const uint8_t * pucPacket );
 
 /**
  * @brief Decodes and processes the received PUBACK message.
@@ -562,8 +598,10 @@ static void prvProcessReceivedUNSUBACK( MQTTContext_t * pxMQTTContext );
  * callback to inform about the received message.
  *
  * @param[in] pxMQTTContext The MQTT context for which the message was received.
+ * @param[in] pucPacket The received message.
  */
-static void prvProcessReceivedPUBACK( MQTTContext_t * pxMQTTContext );
+static void prvProcessReceivedPUBACK( MQTTContext_t * pxMQTTContext,
+                                      const uint8_t * pucPacket );
 
 /**
  * @brief Decodes and processes the received PINGRESP message.
@@ -583,11 +621,14 @@ static void prvProcessReceivedPINGRESP( MQTTContext_t * pxMQTTContext );
  * MQTTPublishData_t). The user can choose to own the buffer afterwards by
  * returning eMQTTTrue from the callback in which case the user should
  * free the buffer whenever done or supply it back for re-use by calling
- * MQTT_GiveBuffer.
+ * MQTT_GiveBuffer. If the message is dispatched in place there is no buffer,
+ * xBuffer is NULL and the user cannot take ownership.
  *
  * @param[in] pxMQTTContext The MQTT context for which the message was received.
+ * @param[in] pucPacket The received message.
  */
-static void prvProcessReceivedPublish( MQTTContext_t * pxMQTTContext );
+static void prvProcessReceivedPublish( MQTTContext_t * pxMQTTContext,
+                                       const uint8_t * pucPacket );
 
 /**
  * @brief Invokes the user supplied callback.
@@ -996,6 +1037,8 @@ static void prvResetRxMessageState( MQTTContext_t * pxMQTTContext )
     pxMQTTContext->xRxMessageState.ulTotalMessageLength = 0;
     pxMQTTContext->xRxMessageState.xRxMessageAction = eMQTTRxMessageStore;
     pxMQTTContext->xRxMessageState.xRxNextByte = eMQTTRxNextBytePacketType;
+    pxMQTTContext->xRxMessageState.xLastReceivedTimestamp = 0;
+    pxMQTTContext->xRxMessageState.ulRemainingTimeoutTicks = 0;
     pxMQTTContext->ulRxMessageReceivedLength = 0;
     pxMQTTContext->xRxBuffer = NULL;
 }
@@ -1144,34 +1187,35 @@ static void prvProcessReceivedFixedHeaderOnlyMQTTPacket( MQTTContext_t * pxMQTTC
 }
 /*-----------------------------------------------------------*/
 
-static void prvProcessReceivedMQTTPacket( MQTTContext_t * pxMQTTContext )
+static void prvProcessReceivedMQTTPacket( MQTTContext_t * pxMQTTContext,
+                                          const uint8_t * pucPacket )
 {
     MQTTEventCallbackParams_t xEventCallbackParams;
 
     /* Is this a publish message from broker? */
-    if( ( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttFIXED_HEADER_CONTROL_BYTE_OFFSET ] & mqttTOP_NIBBLE_MASK ) == mqttCONTROL_PUBLISH )
+    if( ( pucPacket[ mqttFIXED_HEADER_CONTROL_BYTE_OFFSET ] & mqttTOP_NIBBLE_MASK ) == mqttCONTROL_PUBLISH )
     {
-        prvProcessReceivedPublish( pxMQTTContext );
+        prvProcessReceivedPublish( pxMQTTContext, pucPacket );
     }
     /* Is this a CONNACK? */
-    else if( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttFIXED_HEADER_CONTROL_BYTE_OFFSET ] == ( uint8_t ) ( mqttCONTROL_CONNACK | mqttFLAGS_CONNACK ) )
+    else if( pucPacket[ mqttFIXED_HEADER_CONTROL_BYTE_OFFSET ] == ( uint8_t ) ( mqttCONTROL_CONNACK | mqttFLAGS_CONNACK ) )
     {
-        prvProcessReceivedCONNACK( pxMQTTContext );
+        prvProcessReceivedCONNACK( pxMQTTContext, pucPacket );
     }
     /* Is this a PUBACK? */
-    else if( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttFIXED_HEADER_CONTROL_BYTE_OFFSET ] == ( uint8_t ) ( mqttCONTROL_PUBACK | mqttFLAGS_PUBACK ) )
+    else if( pucPacket[ mqttFIXED_HEADER_CONTROL_BYTE_OFFSET ] == ( uint8_t ) ( mqttCONTROL_PUBACK | mqttFLAGS_PUBACK ) )
     {
-        prvProcessReceivedPUBACK( pxMQTTContext );
+        prvProcessReceivedPUBACK( pxMQTTContext, pucPacket );
     }
     /* Is this a SUBACK? */
-    else if( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttFIXED_HEADER_CONTROL_BYTE_OFFSET ] == ( uint8_t ) ( mqttCONTROL_SUBACK | mqttFLAGS_SUBACK ) )
+    else if( pucPacket[ mqttFIXED_HEADER_CONTROL_BYTE_OFFSET ] == ( uint8_t ) ( mqttCONTROL_SUBACK | mqttFLAGS_SUBACK ) )
     {
-        prvProcessReceivedSUBACK( pxMQTTContext );
+        prvProcessReceivedSUBACK( pxMQTTContext, pucPacket );
     }
     /* Is this an UNSUBACK? */
-    else if( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttFIXED_HEADER_CONTROL_BYTE_OFFSET ] == ( uint8_t ) ( mqttCONTROL_UNSUBACK | mqttFLAGS_UNSUBACK ) )
+    else if( pucPacket[ mqttFIXED_HEADER_CONTROL_BYTE_OFFSET ] == ( uint8_t ) ( mqttCONTROL_UNSUBACK | mqttFLAGS_UNSUBACK ) )
     {
-        prvProcessReceivedUNSUBACK( pxMQTTContext );
+        prvProcessReceivedUNSUBACK( pxMQTTContext, pucPacket );
     }
     /* Any other packet is considered malformed. */
     else
@@ -1187,7 +1231,89 @@ static void prvProcessReceivedMQTTPacket( MQTTContext_t * pxMQTTContext )
 }
 /*-----------------------------------------------------------*/
 
-static void prvProcessReceivedCONNACK( MQTTContext_t * pxMQTTContext )
+static size_t prvProcessReceivedCompleteMQTTPacket( MQTTContext_t * pxMQTTContext,
+                                                    const uint8_t * pucReceivedData,
+                                                    size_t xReceivedDataLength )
+{
+    MQTTEventCallbackParams_t xEventCallbackParams;
+    MQTTBool_t xDispatchInPlace;
+    size_t xPacketLength = 0, xFixedHeaderLength = 0, x;
+    uint32_t ulRemainingLength = 0;
+
+    /* Decode the "Remaining Length" from as many of its bytes as have been
+     * received. If the field is incomplete or malformed, it is left to the
+     * byte at a time decoding in MQTT_ParseReceivedData. */
+    for( x = 0; ( x < ( size_t ) mqttREMAINING_LENGTH_MAX_BYTES ) && ( ( x + ( size_t ) mqttFIXED_HEADER_REMAINING_LENGTH_OFFSET ) < xReceivedDataLength ); x++ )
+    {
+        ulRemainingLength |= ( uint32_t ) ( pucReceivedData[ x + ( size_t ) mqttFIXED_HEADER_REMAINING_LENGTH_OFFSET ] & mqttLENGTH_BITMASK_REMAINING_LENGTH ) << ( x * ( size_t ) mqttLENGTH_BITS_REMAINING_LENGTH );
+
+        if( ( pucReceivedData[ x + ( size_t ) mqttFIXED_HEADER_REMAINING_LENGTH_OFFSET ] & mqttREMAINING_LENGTH_CONTINUATION_BITMASK ) == ( uint8_t ) 0 )
+        {
+            xFixedHeaderLength = x + ( size_t ) mqttFIXED_HEADER_REMAINING_LENGTH_OFFSET + ( size_t ) 1;
+            break;
+        }
+    }
+
+    /* Has the whole message been received? */
+    if( ( xFixedHeaderLength != ( size_t ) 0 ) && ( ( size_t ) ulRemainingLength <= ( xReceivedDataLength - xFixedHeaderLength ) ) )
+    {
+        xPacketLength = xFixedHeaderLength + ( size_t ) ulRemainingLength;
+
+        /* Set up the Rx message state as the byte at a time path would have
+         * done on receiving the fixed header. */
+        memcpy( pxMQTTContext->ucRxFixedHeaderBuffer, pucReceivedData, xFixedHeaderLength );
+        pxMQTTContext->ulRxMessageReceivedLength = ( uint32_t ) xFixedHeaderLength;
+        pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes = ( uint8_t ) ( xFixedHeaderLength - ( size_t ) mqttFIXED_HEADER_REMAINING_LENGTH_OFFSET );
+        pxMQTTContext->xRxMessageState.ulTotalMessageLength = ( uint32_t ) xPacketLength;
+
+        #if ( mqttconfigENABLE_IN_PLACE_PUBLISH_DISPATCH == 1 )
+            xDispatchInPlace = eMQTTTrue;
+        #else
+            xDispatchInPlace = ( ( pucReceivedData[ mqttFIXED_HEADER_CONTROL_BYTE_OFFSET ] & mqttTOP_NIBBLE_MASK ) != mqttCONTROL_PUBLISH ) ? eMQTTTrue : eMQTTFalse;
+        #endif
+
+        if( ulRemainingLength == ( uint32_t ) 0 )
+        {
+            prvProcessReceivedFixedHeaderOnlyMQTTPacket( pxMQTTContext );
+        }
+        else if( xDispatchInPlace == eMQTTTrue )
+        {
+            /* Decode the message where it is. Acknowledgements are never
+             * passed to the user, and publishes only are if
+             * mqttconfigENABLE_IN_PLACE_PUBLISH_DISPATCH is 1. */
+            prvProcessReceivedMQTTPacket( pxMQTTContext, pucReceivedData );
+        }
+        else
+        {
+            /* Copy the message into a buffer the user can take ownership of. */
+            pxMQTTContext->xRxBuffer = prvGetFreeBuffer( pxMQTTContext, pxMQTTContext->xRxMessageState.ulTotalMessageLength );
+
+            if( pxMQTTContext->xRxBuffer != NULL )
+            {
+                memcpy( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer ), pucReceivedData, xPacketLength );
+                mqttbufferGET_DATA_LENGTH( pxMQTTContext->xRxBuffer ) = ( uint32_t ) xPacketLength;
+
+                prvProcessReceivedMQTTPacket( pxMQTTContext, mqttbufferGET_DATA( pxMQTTContext->xRxBuffer ) );
+            }
+            else
+            {
+                /* No buffer is available - drop the message. */
+                xEventCallbackParams.xEventType = eMQTTPacketDropped;
+                ( void ) prvInvokeCallback( pxMQTTContext, &xEventCallbackParams );
+            }
+        }
+
+        /* Complete message processed, start looking for the start of the
+         * next. */
+        prvResetRxMessageState( pxMQTTContext );
+    }
+
+    return xPacketLength;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessReceivedCONNACK( MQTTContext_t * pxMQTTContext,
+                                       const uint8_t * pucPacket )
 {
     MQTTBufferHandle_t xConnectTxBuffer;
     MQTTEventCallbackParams_t xEventCallbackParams;
@@ -1216,12 +1342,12 @@ static void prvProcessReceivedCONNACK( MQTTContext_t * pxMQTTContext )
     }
     else
     {
-        if( mqttbufferGET_DATA_LENGTH( pxMQTTContext->xRxBuffer ) >= sizeof( ucDefaultCONNACKParameters ) )
+        if( pxMQTTContext->xRxMessageState.ulTotalMessageLength >= sizeof( ucDefaultCONNACKParameters ) )
         {
             /* Received enough data for a CONNACK - does the received fixed header match
              * the expected one for the CONNACK message (Fixed header is of 2 bytes for CONNACK
              * message because Remaining Length is 2 which takes only one byte)? */
-            if( memcmp( ucDefaultCONNACKParameters, mqttbufferGET_DATA( pxMQTTContext->xRxBuffer ), mqttFIXED_HEADER_MIN_SIZE ) == 0 )
+            if( memcmp( ucDefaultCONNACKParameters, pucPacket, mqttFIXED_HEADER_MIN_SIZE ) == 0 )
             {
                 mqttconfigDEBUG_LOG( ( "CONNACK received.\r\n" ) );
 
@@ -1229,7 +1355,7 @@ static void prvProcessReceivedCONNACK( MQTTContext_t * pxMQTTContext )
 
                 /* Since AWS IoT only supports CleanSession 1, SP bit will
                  * always be zero. */
-                ucReturnCode = mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttCONNACK_RETURN_CODE_OFFSET ];
+                ucReturnCode = pucPacket[ mqttCONNACK_RETURN_CODE_OFFSET ];
 
                 if( ucReturnCode == ( uint8_t ) 0 ) /* Connection Accepted. */
                 {
@@ -1284,10 +1410,10 @@ static void prvProcessReceivedCONNACK( MQTTContext_t * pxMQTTContext )
             else
             {
                 mqttconfigDEBUG_LOG( ( "Unknown messages %x %x %x %x, expected CONNACK, disconnecting socket.\r\n",
-                                       mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ 0 ],
-                                       mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ 1 ],
-                                       mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ 2 ],
-                                       mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ 3 ] ) );
+                                       pucPacket[ 0 ],
+                                       pucPacket[ 1 ],
+                                       pucPacket[ 2 ],
+                                       pucPacket[ 3 ] ) );
 
                 /* Malformed packet - Fixed header does not match. */
                 xMalformedPacket = eMQTTTrue;
@@ -1343,7 +1469,8 @@ static void prvProcessReceivedCONNACK( MQTTContext_t * pxMQTTContext )
 }
 /*-----------------------------------------------------------*/
 
-static void prvProcessReceivedSUBACK( MQTTContext_t * pxMQTTContext )
+static void prvProcessReceivedSUBACK( MQTTContext_t * pxMQTTContext,
+                                      const uint8_t * pucPacket )
 {
     MQTTBufferHandle_t xSubscribeTxBuffer;
     MQTTEventCallbackParams_t xEventCallbackParams;
@@ -1352,16 +1479,16 @@ static void prvProcessReceivedSUBACK( MQTTContext_t * pxMQTTContext )
     uint16_t usPacketIdentifier;
 
     /* Must have enough bytes to at least read out one return code. */
-    if( mqttbufferGET_DATA_LENGTH( pxMQTTContext->xRxBuffer ) > ( uint32_t ) mqttADJUST_OFFSET( mqttSUBACK_RETURN_CODE_OFFSET,
-                                                                                                pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) )
+    if( pxMQTTContext->xRxMessageState.ulTotalMessageLength > ( uint32_t ) mqttADJUST_OFFSET( mqttSUBACK_RETURN_CODE_OFFSET,
+                                                                                              pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) )
     {
         /* Extract the packet identifier and see if there is a subscribe
          * packet waiting for ACK. */
-        usPacketIdentifier = ( uint16_t ) ( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttADJUST_OFFSET( mqttSUBACK_PACKET_ID_MSB_OFFSET,
-                                                                                                               pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ] );
+        usPacketIdentifier = ( uint16_t ) ( pucPacket[ mqttADJUST_OFFSET( mqttSUBACK_PACKET_ID_MSB_OFFSET,
+                                                                          pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ] );
         usPacketIdentifier <<= mqttBITS_PER_BYTE;
-        usPacketIdentifier |= ( uint8_t ) ( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttADJUST_OFFSET( mqttSUBACK_PACKET_ID_LSB_OFFSET,
-                                                                                                               pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ] );
+        usPacketIdentifier |= ( uint8_t ) ( pucPacket[ mqttADJUST_OFFSET( mqttSUBACK_PACKET_ID_LSB_OFFSET,
+                                                                          pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ] );
 
         xSubscribeTxBuffer = prvPacketTypeFlagsIdentifierGetTxBuffer( pxMQTTContext, mqttCONTROL_SUBSCRIBE, mqttFLAGS_SUBSCRIBE, usPacketIdentifier );
 
@@ -1376,8 +1503,8 @@ static void prvProcessReceivedSUBACK( MQTTContext_t * pxMQTTContext )
         else
         {
             /* Extract the return code from the packet. */
-            ucReturnCode = mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttADJUST_OFFSET( mqttSUBACK_RETURN_CODE_OFFSET,
-                                                                                              pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ];
+            ucReturnCode = pucPacket[ mqttADJUST_OFFSET( mqttSUBACK_RETURN_CODE_OFFSET,
+                                                         pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ];
 
             /* Return code must be valid. Note that QoS2 is not supported. */
             if( ( ucReturnCode <= ( uint8_t ) 1 ) || ( ucReturnCode == ( uint8_t ) 128 ) )
@@ -1447,7 +1574,8 @@ static void prvProcessReceivedSUBACK( MQTTContext_t * pxMQTTContext )
 }
 /*-----------------------------------------------------------*/
 
-static void prvProcessReceivedUNSUBACK( MQTTContext_t * pxMQTTContext )
+static void prvProcessReceivedUNSUBACK( MQTTContext_t * pxMQTTContext,
+                                        const uint8_t * pucPacket )
 {
     MQTTBufferHandle_t xUnsubscribeTxBuffer;
     MQTTEventCallbackParams_t xEventCallbackParams;
@@ -1462,20 +1590,20 @@ static void prvProcessReceivedUNSUBACK( MQTTContext_t * pxMQTTContext )
     /* Must have enough bytes to form a complete UNSUBACK packet
      * which contains 2 byte packet identifier other than the fixed
      * header. */
-    if( mqttbufferGET_DATA_LENGTH( pxMQTTContext->xRxBuffer ) >= ( sizeof( ucUNSUBACKFixedHeader ) + ( uint32_t ) mqttUNSUBACK_PACKET_IDENTIFER_LENGTH ) )
+    if( pxMQTTContext->xRxMessageState.ulTotalMessageLength >= ( sizeof( ucUNSUBACKFixedHeader ) + ( uint32_t ) mqttUNSUBACK_PACKET_IDENTIFER_LENGTH ) )
     {
         /* Received enough data for an UNSUBACK - does the received fixed header match
          * the expected one for the UNSUBACK message (Fixed header is of 2 bytes for UNSUBACK
          * message because Remaining Length is 2 which takes only one byte)? */
-        if( memcmp( ucUNSUBACKFixedHeader, mqttbufferGET_DATA( pxMQTTContext->xRxBuffer ), sizeof( ucUNSUBACKFixedHeader ) ) == 0 )
+        if( memcmp( ucUNSUBACKFixedHeader, pucPacket, sizeof( ucUNSUBACKFixedHeader ) ) == 0 )
         {
             /* Extract the packet identifier and see if there is an unsubscribe
              * packet waiting for ACK. */
-            usPacketIdentifier = ( uint8_t ) ( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttADJUST_OFFSET( mqttUNSUBACK_PACKET_ID_MSB_OFFSET,
-                                                                                                                  pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ] );
+            usPacketIdentifier = ( uint8_t ) ( pucPacket[ mqttADJUST_OFFSET( mqttUNSUBACK_PACKET_ID_MSB_OFFSET,
+                                                                             pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ] );
             usPacketIdentifier <<= mqttBITS_PER_BYTE;
-            usPacketIdentifier |= ( uint8_t ) ( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttADJUST_OFFSET( mqttUNSUBACK_PACKET_ID_LSB_OFFSET,
-                                                                                                                   pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ] );
+            usPacketIdentifier |= ( uint8_t ) ( pucPacket[ mqttADJUST_OFFSET( mqttUNSUBACK_PACKET_ID_LSB_OFFSET,
+                                                                              pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ] );
 
             xUnsubscribeTxBuffer = prvPacketTypeFlagsIdentifierGetTxBuffer( pxMQTTContext, mqttCONTROL_UNSUBSCRIBE, mqttFLAGS_UNSUBSCRIBE, usPacketIdentifier );
 
@@ -1535,7 +1663,8 @@ static void prvProcessReceivedUNSUBACK( MQTTContext_t * pxMQTTContext )
 }
 /*-----------------------------------------------------------*/
 
-static void prvProcessReceivedPUBACK( MQTTContext_t * pxMQTTContext )
+static void prvProcessReceivedPUBACK( MQTTContext_t * pxMQTTContext,
+                                      const uint8_t * pucPacket )
 {
     MQTTBufferHandle_t xPublishTxBuffer;
     MQTTEventCallbackParams_t xEventCallbackParams;
@@ -1550,20 +1679,20 @@ static void prvProcessReceivedPUBACK( MQTTContext_t * pxMQTTContext )
     /* Must have enough bytes to form a complete PUBACK packet
      * which contains 2 byte packet identifier other than the fixed
      * header. */
-    if( mqttbufferGET_DATA_LENGTH( pxMQTTContext->xRxBuffer ) >= ( sizeof( ucPUBACKFixedHeader ) + ( uint32_t ) mqttPUBACK_PACKET_IDENTIFER_LENGTH ) )
+    if( pxMQTTContext->xRxMessageState.ulTotalMessageLength >= ( sizeof( ucPUBACKFixedHeader ) + ( uint32_t ) mqttPUBACK_PACKET_IDENTIFER_LENGTH ) )
     {
         /* Received enough data for a PUBACK - does the received fixed header match
          * the expected one for the PUBACK message (Fixed header is of 2 bytes for PUBACK
          * message because Remaining Length is 2 which takes only one byte)? */
-        if( memcmp( ucPUBACKFixedHeader, mqttbufferGET_DATA( pxMQTTContext->xRxBuffer ), sizeof( ucPUBACKFixedHeader ) ) == 0 )
+        if( memcmp( ucPUBACKFixedHeader, pucPacket, sizeof( ucPUBACKFixedHeader ) ) == 0 )
         {
             /* Extract the packet identifier and see if there is a publish
              * packet waiting for ACK. */
-            usPacketIdentifier = ( uint8_t ) ( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttADJUST_OFFSET( mqttPUBACK_PACKET_ID_MSB_OFFSET,
-                                                                                                                  pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ] );
+            usPacketIdentifier = ( uint8_t ) ( pucPacket[ mqttADJUST_OFFSET( mqttPUBACK_PACKET_ID_MSB_OFFSET,
+                                                                             pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ] );
             usPacketIdentifier <<= mqttBITS_PER_BYTE;
-            usPacketIdentifier |= ( uint8_t ) ( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttADJUST_OFFSET( mqttPUBACK_PACKET_ID_LSB_OFFSET,
-                                                                                                                   pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ] );
+            usPacketIdentifier |= ( uint8_t ) ( pucPacket[ mqttADJUST_OFFSET( mqttPUBACK_PACKET_ID_LSB_OFFSET,
+                                                                              pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ] );
 
             xPublishTxBuffer = prvPacketTypeIdentifierGetTxBuffer( pxMQTTContext, mqttCONTROL_PUBLISH, usPacketIdentifier );
 
@@ -1669,11 +1798,13 @@ static void prvProcessReceivedPINGRESP( MQTTContext_t * pxMQTTContext )
 }
 /*-----------------------------------------------------------*/
 
-static void prvProcessReceivedPublish( MQTTContext_t * pxMQTTContext )
+static void prvProcessReceivedPublish( MQTTContext_t * pxMQTTContext,
+                                       const uint8_t * pucPacket )
 {
     MQTTEventCallbackParams_t xEventCallbackParams;
     uint8_t ucPacketIdentiferLength; /* Length in bytes taken by the packet identifier field in the received publish packet. */
     uint8_t ucQos;
+    uint32_t ulTopicOffset, ulDataOffset = UINT32_MAX;
     static uint8_t ucPUBACKPacket[] =
     {
         mqttCONTROL_PUBACK | mqttFLAGS_PUBACK, /* Fixed header control packet type. */
@@ -1687,7 +1818,7 @@ static void prvProcessReceivedPublish( MQTTContext_t * pxMQTTContext )
     xEventCallbackParams.xEventType = eMQTTPublish;
 
     /*_TODO_ Do we want to expose DUP and RETAIN? */
-    ucQos = mqttPUBLISH_QoS_BITS( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttFIXED_HEADER_CONTROL_BYTE_OFFSET ] );
+    ucQos = mqttPUBLISH_QoS_BITS( pucPacket[ mqttFIXED_HEADER_CONTROL_BYTE_OFFSET ] );
 
     /* QoS2 is not supported. */
     if( ( ucQos == ( uint8_t ) 0 /* QoS0. */ ) || ( ucQos == ( uint8_t ) 1 /* QoS1. */ ) )
@@ -1703,59 +1834,76 @@ static void prvProcessReceivedPublish( MQTTContext_t * pxMQTTContext )
             ucPacketIdentiferLength = mqttPUBLISH_QOS1_PACKET_IDENTIFER_LENGTH;
         }
 
-        /* Extract Topic Length. */
-        xEventCallbackParams.u.xPublishData.usTopicLength = ( uint16_t ) mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttADJUST_OFFSET( mqttPUBLISH_TOPIC_LENGTH_MSB,
-                                                                                                                                            pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ];
-        xEventCallbackParams.u.xPublishData.usTopicLength <<= mqttBITS_PER_BYTE;
-        xEventCallbackParams.u.xPublishData.usTopicLength |= ( uint16_t ) mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttADJUST_OFFSET( mqttPUBLISH_TOPIC_LENGTH_LSB,
-                                                                                                                                             pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ];
-
-        /* Extract Topic. */
-        xEventCallbackParams.u.xPublishData.pucTopic = &( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttADJUST_OFFSET( mqttPUBLISH_TOPIC_STRING_OFFSET,
-                                                                                                                             pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ] );
-
-        /* Extract Published Data. */
-        xEventCallbackParams.u.xPublishData.pvData = ( void * ) &( mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttADJUST_OFFSET( mqttPUBLISH_TOPIC_STRING_OFFSET,
-                                                                                                                                      pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) +
-                                                                                                                   xEventCallbackParams.u.xPublishData.usTopicLength +
-                                                                                                                   ucPacketIdentiferLength ] ); /*lint !e9087 Publish data is provided as void* to the user. */
-
-        /* Topic string is followed by packet identifier which is
-         * followed by actual data. NOte that QoS0 publishes do not
-         * have packet identifier. */
-        xEventCallbackParams.u.xPublishData.ulDataLength = pxMQTTContext->xRxMessageState.ulTotalMessageLength - ( mqttADJUST_OFFSET( mqttPUBLISH_TOPIC_STRING_OFFSET,
-                                                                                                                                      pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) +
-                                                                                                                   xEventCallbackParams.u.xPublishData.usTopicLength +
-                                                                                                                   ucPacketIdentiferLength );
-
-        /* Pass the handle of the buffer containing the whole MQTT message. */
-        xEventCallbackParams.u.xPublishData.xBuffer = pxMQTTContext->xRxBuffer;
-
-        /* If this is a QoS1 publish, send the PUBACK before invoking the
-         * callback. */
-        if( xEventCallbackParams.u.xPublishData.xQos == eMQTTQoS1 )
+        ulTopicOffset = mqttADJUST_OFFSET( mqttPUBLISH_TOPIC_STRING_OFFSET, pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes );
+
+        /* The packet must be long enough to contain the topic length. */
+        if( pxMQTTContext->xRxMessageState.ulTotalMessageLength >= ulTopicOffset )
         {
-            /* Extract the packet identifier from the publish message
-             * to set the same in PUBACK message. */
-            ucPUBACKPacket[ mqttPUBACK_PACKET_ID_MSB_OFFSET ] = mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttADJUST_OFFSET( mqttPUBLISH_TOPIC_STRING_OFFSET,
-                                                                                                                                   pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) +
-                                                                                                                xEventCallbackParams.u.xPublishData.usTopicLength ];
-            ucPUBACKPacket[ mqttPUBACK_PACKET_ID_LSB_OFFSET ] = mqttbufferGET_DATA( pxMQTTContext->xRxBuffer )[ mqttADJUST_OFFSET( mqttPUBLISH_TOPIC_STRING_OFFSET,
-                                                                                                                                   pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) +
-                                                                                                                xEventCallbackParams.u.xPublishData.usTopicLength +
-                                                                                                                ( uint16_t ) 1 /* Packet ID LSB follows MSB. */ ];
-
-            /* Send a PUBACK to the broker confirming the receipt
-             * of the publish message. If we fail to send the PUBACK,
-             * we will receive the same publish message again. */
-            ( void ) prvSendData( pxMQTTContext, ucPUBACKPacket, ( uint32_t ) sizeof( ucPUBACKPacket ) );
+            /* Extract Topic Length. */
+            xEventCallbackParams.u.xPublishData.usTopicLength = ( uint16_t ) pucPacket[ mqttADJUST_OFFSET( mqttPUBLISH_TOPIC_LENGTH_MSB,
+                                                                                                           pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ];
+            xEventCallbackParams.u.xPublishData.usTopicLength <<= mqttBITS_PER_BYTE;
+            xEventCallbackParams.u.xPublishData.usTopicLength |= ( uint16_t ) pucPacket[ mqttADJUST_OFFSET( mqttPUBLISH_TOPIC_LENGTH_LSB,
+                                                                                                            pxMQTTContext->xRxMessageState.ucRemaingingLengthFieldBytes ) ];
+
+            /* Topic string is followed by packet identifier which is
+             * followed by actual data. Note that QoS0 publishes do not
+             * have packet identifier. */
+            ulDataOffset = ulTopicOffset + ( uint32_t ) xEventCallbackParams.u.xPublishData.usTopicLength + ( uint32_t ) ucPacketIdentiferLength;
         }
 
-        /* If the user chooses not to take the ownership of the buffer,
-         * return it back to the free buffer pool. */
-        if( prvInvokeCallback( pxMQTTContext, &xEventCallbackParams ) == eMQTTFalse )
+        /* A topic and packet identifier running past the end of the packet
+         * make it malformed. */
+        if( ulDataOffset <= pxMQTTContext->xRxMessageState.ulTotalMessageLength )
         {
-            prvReturnBuffer( pxMQTTContext, pxMQTTContext->xRxBuffer );
+            /* Extract Topic. */
+            xEventCallbackParams.u.xPublishData.pucTopic = &( pucPacket[ ulTopicOffset ] );
+
+            /* Extract Published Data. */
+            xEventCallbackParams.u.xPublishData.pvData = ( const void * ) &( pucPacket[ ulDataOffset ] );
+            xEventCallbackParams.u.xPublishData.ulDataLength = pxMQTTContext->xRxMessageState.ulTotalMessageLength - ulDataOffset;
+
+            /* Pass the handle of the buffer containing the whole MQTT message,
+             * which is NULL if the message is being dispatched in place. */
+            xEventCallbackParams.u.xPublishData.xBuffer = pxMQTTContext->xRxBuffer;
+
+            /* If this is a QoS1 publish, send the PUBACK before invoking the
+             * callback. */
+            if( xEventCallbackParams.u.xPublishData.xQos == eMQTTQoS1 )
+            {
+                /* Extract the packet identifier from the publish message
+                 * to set the same in PUBACK message. */
+                ucPUBACKPacket[ mqttPUBACK_PACKET_ID_MSB_OFFSET ] = pucPacket[ ulDataOffset - ( uint32_t ) mqttPUBLISH_QOS1_PACKET_IDENTIFER_LENGTH ];
+                ucPUBACKPacket[ mqttPUBACK_PACKET_ID_LSB_OFFSET ] = pucPacket[ ulDataOffset - ( uint32_t ) 1 /* Packet ID LSB follows MSB. */ ];
+
+                /* Send a PUBACK to the broker confirming the receipt
+                 * of the publish message. If we fail to send the PUBACK,
+                 * we will receive the same publish message again. */
+                ( void ) prvSendData( pxMQTTContext, ucPUBACKPacket, ( uint32_t ) sizeof( ucPUBACKPacket ) );
+            }
+
+            /* If the user chooses not to take the ownership of the buffer,
+             * return it back to the free buffer pool. */
+            if( prvInvokeCallback( pxMQTTContext, &xEventCallbackParams ) == eMQTTFalse )
+            {
+                prvReturnBuffer( pxMQTTContext, pxMQTTContext->xRxBuffer );
+            }
+            else
+            {
+                /* A message dispatched in place has no buffer whose
+                 * ownership can be taken. */
+                mqttconfigASSERT( xEventCallbackParams.u.xPublishData.xBuffer != NULL );
+            }
+        }
+        else
+        {
+            /* A malformed packet has been received - disconnect. */
+            prvResetMQTTContext( pxMQTTContext );
+
+            /* Inform user about the malformed packet received. */
+            xEventCallbackParams.xEventType = eMQTTClientDisconnected;
+            xEventCallbackParams.u.xDisconnectData.xDisconnectReason = eMQTTDisconnectReasonMalformedPacket;
+            ( void ) prvInvokeCallback( pxMQTTContext, &xEventCallbackParams );
         }
     }
     else
@@ -3099,7 +3247,7 @@ MQTTReturnCode_t MQTT_ParseReceivedData( MQTTContext_t * pxMQTTContext,
 {
     MQTTReturnCode_t xReturnCode = eMQTTSuccess;
     MQTTEventCallbackParams_t xEventCallbackParams;
-    size_t xProcessedBytes = 0, xExpectedBytes, xUnprocessedBytes;
+    size_t xProcessedBytes = 0, xExpectedBytes, xUnprocessedBytes, xPacketLength;
 
     /* These are checked here once and are later used without
      * NULL checks. */
@@ -3131,6 +3279,18 @@ MQTTReturnCode_t MQTT_ParseReceivedData( MQTTContext_t * pxMQTTContext,
             mqttconfigASSERT( pxMQTTContext->ulRxMessageReceivedLength == 0 );
             mqttconfigASSERT( pxMQTTContext->xRxBuffer == NULL );
 
+            /* If the whole message has been received, it is processed where it
+             * is. */
+            xPacketLength = prvProcessReceivedCompleteMQTTPacket( pxMQTTContext, &( pucReceivedData[ xProcessedBytes ] ), xReceivedDataLength - xProcessedBytes );
+
+            if( xPacketLength != ( size_t ) 0 )
+            {
+                xProcessedBytes += xPacketLength;
+
+                /* Look for the start of the next message. */
+                continue;
+            }
+
             /* We always write the packet type and "Remaining Length" in the fixed
              * header buffer so that we can decode the packet length even if no user
              * supplied buffer is available. This enables us to drop a packet if no
@@ -3206,7 +3366,7 @@ MQTTReturnCode_t MQTT_ParseReceivedData( MQTTContext_t * pxMQTTContext,
                         mqttbufferGET_DATA_LENGTH( pxMQTTContext->xRxBuffer ) = pxMQTTContext->ulRxMessageReceivedLength;
 
                         pxMQTTContext->xRxMessageState.xRxNextByte = eMQTTRxNextByteMessage;
-                        pxMQTTContext->xRxMessageState.xRxMessageAction = eMQTTRxMessageStore; /*_TODO_ This needs a timeout in case the rest of the message never comes. */
+                        pxMQTTContext->xRxMessageState.xRxMessageAction = eMQTTRxMessageStore;
                     }
                     else
                     {
@@ -3240,7 +3400,7 @@ MQTTReturnCode_t MQTT_ParseReceivedData( MQTTContext_t * pxMQTTContext,
                 mqttCOPY_BYTES( pucReceivedData, xProcessedBytes, mqttbufferGET_DATA( pxMQTTContext->xRxBuffer ), mqttbufferGET_DATA_LENGTH( pxMQTTContext->xRxBuffer ), xExpectedBytes );
 
                 /* Process the received packet. */
-                prvProcessReceivedMQTTPacket( pxMQTTContext );
+                prvProcessReceivedMQTTPacket( pxMQTTContext, mqttbufferGET_DATA( pxMQTTContext->xRxBuffer ) );
 
                 /* Reset Rx state to receive next packet. */
                 prvResetRxMessageState( pxMQTTContext );
@@ -3278,6 +3438,15 @@ MQTTReturnCode_t MQTT_ParseReceivedData( MQTTContext_t * pxMQTTContext,
         }
     }
 
+    /* If the data ended part way through a message, give the rest of the
+     * message until mqttconfigRX_PARTIAL_MESSAGE_TIMEOUT_TICKS from now to
+     * arrive. The timeout is checked in MQTT_Periodic. */
+    if( ( pxMQTTContext->xRxMessageState.xRxNextByte != eMQTTRxNextBytePacketType ) && ( xProcessedBytes > ( size_t ) 0 ) )
+    {
+        pxMQTTContext->xRxMessageState.xLastReceivedTimestamp = prvGetCurrentTickCount( pxMQTTContext );
+        pxMQTTContext->xRxMessageState.ulRemainingTimeoutTicks = ( uint32_t ) mqttconfigRX_PARTIAL_MESSAGE_TIMEOUT_TICKS;
+    }
+
     return xReturnCode;
 }
 /*-----------------------------------------------------------*/
@@ -3374,6 +3543,32 @@ uint32_t MQTT_Periodic( MQTTContext_t * pxMQTTContext,
         }
     }
 
+    #if ( mqttconfigRX_PARTIAL_MESSAGE_TIMEOUT_TICKS != 0 )
+
+        /* Check if the rest of a partially received message is overdue. */
+        if( ( pxMQTTContext->xConnectionState != eMQTTNotConnected ) && ( pxMQTTContext->xRxMessageState.xRxNextByte != eMQTTRxNextBytePacketType ) )
+        {
+            if( prvIsTimeElapsed( &( pxMQTTContext->xRxMessageState.xLastReceivedTimestamp ), xCurrentTickCount, &( pxMQTTContext->xRxMessageState.ulRemainingTimeoutTicks ) ) == eMQTTTrue )
+            {
+                mqttconfigDEBUG_LOG( ( "Timed out waiting for the rest of a packet, disconnecting.\r\n" ) );
+
+                /* The received bytes can no longer be matched to packet
+                 * boundaries - disconnect. */
+                prvResetMQTTContext( pxMQTTContext );
+
+                /* Inform the user about disconnect. */
+                xEventCallbackParams.xEventType = eMQTTClientDisconnected;
+                xEventCallbackParams.u.xDisconnectData.xDisconnectReason = eMQTTDisconnectReasonRxTimeout;
+                ( void ) prvInvokeCallback( pxMQTTContext, &xEventCallbackParams );
+            }
+            else
+            {
+                /* Update when the next earliest timeout will happen. */
+                ulNextTimeoutTicks = mqttMIN( ulNextTimeoutTicks, pxMQTTContext->xRxMessageState.ulRemainingTimeoutTicks );
+            }
+        }
+    #endif /* mqttconfigRX_PARTIAL_MESSAGE_TIMEOUT_TICKS */
+
     /* Check if the previously sent keep alive timed out,
      * or it is time to send a keep alive message. */
     if( pxMQTTContext->xConnectionState == eMQTTConnected )
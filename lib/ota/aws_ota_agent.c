@@ -37,10 +37,17 @@
 #include "aws_ota_cbor.h"
 #include "aws_application_version.h"
 #include "aws_ota_agent_config.h"
+#include "aws_ota_agent_config_defaults.h"
 
 /* Internal header file for shared definitions. */
 #include "aws_ota_agent_internal.h"
 
+/* HTTP data plane include. */
+#include "aws_ota_http.h"
+
+/* Delta update include. */
+#include "aws_ota_delta.h"
+
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"     /*lint !e537 intentional include of all interfaces used by this file. */
 #include "timers.h"       /*lint !e537 intentional include of all interfaces used by this file. */
@@ -79,7 +86,8 @@
 #define OTA_EVT_MASK_SHUTDOWN              0x00000002UL /* Event flag to request OTA shutdown. */
 #define OTA_EVT_MASK_REQ_TIMEOUT           0x00000004UL /* Event flag indicating the request timer has timed out. */
 #define OTA_EVT_MASK_USER_ABORT            0x00000008UL /* Event flag to indicate user initiated OTA abort. */
-#define OTA_EVT_MASK_ALL_EVENTS            ( OTA_EVT_MASK_MSG_READY | OTA_EVT_MASK_SHUTDOWN | OTA_EVT_MASK_REQ_TIMEOUT | OTA_EVT_MASK_USER_ABORT )
+#define OTA_EVT_MASK_HTTP_FETCH            0x00000010UL /* Event flag to fetch more of a file downloaded over HTTP. */
+#define OTA_EVT_MASK_ALL_EVENTS            ( OTA_EVT_MASK_MSG_READY | OTA_EVT_MASK_SHUTDOWN | OTA_EVT_MASK_REQ_TIMEOUT | OTA_EVT_MASK_USER_ABORT | OTA_EVT_MASK_HTTP_FETCH )
 
 /* Stream GET message constants. */
 
@@ -94,7 +102,6 @@
 
 /* Job document parser constants. */
 
-#define OTA_MAX_JSON_TOKENS    64U                      /* Number of JSON tokens supported in a single parser call. */
 #define OTA_MAX_TOPIC_LEN      256U                     /* Max length of a dynamically generated topic string (usually on the stack). */
 
 /* When subscribing to MQTT topics with a callback handler, we use the callback
@@ -124,7 +131,7 @@ typedef struct
  * size, attributes, etc. The following value specifies the number of parameters
  * that are included in the job document model although some may be optional. */
 
-#define OTA_NUM_JOB_PARAMS         ( 16 ) /* Number of parameters in the job document. */
+#define OTA_NUM_JOB_PARAMS         ( 18 ) /* Number of parameters in the job document. */
 /* We need the following string to match in a couple places in the code so use a #define. */
 #define OTA_JSON_UPDATED_BY_KEY    "updatedBy"
 
@@ -143,6 +150,17 @@ static const char cOTA_JSON_FileSizeKey[] = "filesize";
 static const char cOTA_JSON_FileIDKey[] = "fileid";
 static const char cOTA_JSON_FileAttributeKey[] = "attr";
 static const char cOTA_JSON_FileCertNameKey[] = "certfile";
+static const char cOTA_JSON_UpdateDataURLKey[] = "update_data_url";
+static const char cOTA_JSON_DeltaBaseKey[] = "delta_base_version";
+
+/* A file whose job gives an update data URL is downloaded from it over HTTPS.
+ * Without the HTTP data plane, the URL is ignored and the file is streamed
+ * over MQTT. */
+#if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 )
+    #define OTA_UPDATE_DATA_URL_DEST    OFFSET_OF( OTA_FileContext_t, pucUpdateDataURL )
+#else
+    #define OTA_UPDATE_DATA_URL_DEST    OTA_DONT_STORE_PARAM
+#endif
 
 enum
 {
@@ -196,6 +214,9 @@ static const char * pcOTA_JobStatus_Strings[ eNumJobStatusMappings ] =
 #define OTA_JOB_PARAM_REQUIRED      ( ( bool_t ) pdTRUE )  /* Used to denote a required document model parameter. */
 #define OTA_JOB_PARAM_OPTIONAL      ( ( bool_t ) pdFALSE ) /* Used to denote an optional document model parameter. */
 #define OTA_DONT_STORE_PARAM        0xffffffffUL           /* If ulDestOffset in the model is 0xffffffff, do not store the value. */
+#define OTA_DOC_KEY_HASH_BASIS      2166136261UL           /* The first seed tried for a model's key table, the FNV-1a offset basis. */
+#define OTA_DOC_KEY_HASH_PRIME      16777619UL             /* The FNV-1a prime. */
+#define OTA_DOC_KEY_TABLE_MAX_SEEDS 1000UL                 /* Seeds tried before giving up on a model's key table. */
 
 /* This union allows us to access document model parameter addresses as their
  * actual type without casting every time we access a parameter. */
@@ -212,6 +233,25 @@ typedef union MultiParmPtr
 } MultiParmPtr_t;
 
 
+/* The position of the JSON document parser within the document. */
+
+typedef struct
+{
+    const char * pcJSON; /* The JSON document. */
+    uint32_t ulLen;      /* The length of the document, which may also end at a zero. */
+    uint32_t ulIndex;    /* The offset of the next character to parse. */
+} JSON_Scanner_t;
+
+
+/* The file that the body of an HTTP range response is written to. */
+
+typedef struct
+{
+    OTA_FileContext_t * pxC; /* The file being downloaded. */
+    IngestResult_t eResult;  /* Set to an error if a write to the file fails. */
+} HTTP_BodyWriter_t;
+
+
 /* OTA job document parser error codes. */
 
 typedef enum
@@ -316,6 +356,76 @@ static IngestResult_t prvIngestDataBlock( OTA_FileContext_t * C,
                                           uint32_t ulMsgSize,
                                           OTA_Err_t * pxCloseResult );
 
+/* Called with a piece of the received file to write it, or to apply it if the file is a delta update patch. */
+
+static IngestResult_t prvWriteFileData( OTA_FileContext_t * C,
+                                        uint32_t ulOffset,
+                                        uint8_t * pucData,
+                                        uint32_t ulLength );
+
+/* Called when a job starts, to start applying the file to the running image if it's a delta update patch. */
+
+static OTA_Err_t prvStartDeltaPatch( OTA_FileContext_t * C );
+
+/* Called when the whole file has been received, to finish the new image if the file is a delta update patch. */
+
+static bool_t prvFinishDeltaPatch( OTA_FileContext_t * C );
+
+#if ( otaconfigENABLE_DELTA_UPDATE == 1 )
+
+/* Called by the delta update patch to read the running image and write the new one. */
+
+    static int32_t prvReadBaseImage( void * pvContext,
+                                     uint32_t ulOffset,
+                                     uint8_t * pucData,
+                                     uint32_t ulLength );
+
+    static int32_t prvWriteNewImage( void * pvContext,
+                                     uint32_t ulOffset,
+                                     uint8_t * pucData,
+                                     uint32_t ulLength );
+#endif
+
+/* Called when the last block of a file has been written. */
+
+static IngestResult_t prvCloseReceivedFile( OTA_FileContext_t * C,
+                                            OTA_Err_t * pxCloseResult );
+
+/* Called when a file transfer has completed or failed. */
+
+static void prvFinishTransfer( OTA_FileContext_t * C,
+                               IngestResult_t xResult,
+                               OTA_Err_t xCloseResult );
+
+#if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 )
+
+/* Find the next range of missing blocks to ask the HTTP server for. */
+
+    static bool_t prvNextHTTPRange( OTA_FileContext_t * C,
+                                    uint32_t * pulOffset,
+                                    uint32_t * pulLength );
+
+/* Close the HTTP connection, if any, and free its block buffer. */
+
+    static void prvCloseHTTPConnection( OTA_FileContext_t * C );
+
+/* Called with the body of an HTTP range response as it arrives. */
+
+    static BaseType_t prvWriteHTTPBody( void * pvContext,
+                                        uint32_t ulOffset,
+                                        const uint8_t * pucData,
+                                        uint32_t ulLength );
+
+/* Called when the OTA agent should fetch more of a file over HTTP. */
+
+    static IngestResult_t prvFetchFileBlocksHTTP( OTA_FileContext_t * C,
+                                                  OTA_Err_t * pxCloseResult );
+
+/* Called on request timeout while a file is downloaded over HTTP. */
+
+    static OTA_Err_t prvRetryHTTPTransfer( OTA_FileContext_t * C );
+#endif
+
 /* Called when the OTA agent receives an OTA version message. */
 
 static OTA_FileContext_t * prvProcessOTAJobMsg( const char * pcRawMsg,
@@ -376,11 +486,44 @@ static DocParseErr_t prvSearchModelForTokenKey( JSON_DocModel_t * pxDocModel,
                                                 uint32_t ulStrLen,
                                                 uint16_t * pusMatchingIndexResult );
 
+/* Hash a JSON key into a slot of a document model's key table. */
+
+static uint32_t prvHashModelKey( uint32_t ulSeed,
+                                 const char * pcKey,
+                                 uint32_t ulKeyLen );
+
+/* Build the perfect hash table of a document model's keys. */
+
+static DocParseErr_t prvBuildDocKeyTable( const JSON_DocParam_t * pxBodyDef,
+                                          uint16_t usNumParams,
+                                          JSON_DocKeyTable_t * pxKeyTable );
+
+/* Helpers for the single pass JSON document parser. */
+
+static char prvJSONPeek( JSON_Scanner_t * pxScan );
+
+static bool_t prvJSONScanScalar( JSON_Scanner_t * pxScan,
+                                 uint32_t * pulStart,
+                                 uint32_t * pulLen );
+
+/* Store the value of a document model parameter found in a JSON document. */
+
+static DocParseErr_t prvExtractParameter( JSON_DocModel_t * pxDocModel,
+                                          uint16_t usModelParamIndex,
+                                          const char * pcValue,
+                                          uint32_t ulValueLen );
+
+/* Parse a JSON document in a single pass, extracting the parameters of the document model. */
+
+static DocParseErr_t prvStreamJSONbyModel( JSON_Scanner_t * pxScan,
+                                           JSON_DocModel_t * pxDocModel );
+
 /* Prepare the document model for use by sanity checking the initialization parameters
  * and detecting all required parameters. */
 
 static DocParseErr_t prvInitDocModel( JSON_DocModel_t * pxDocModel,
                                       const JSON_DocParam_t * pxBodyDef,
+                                      JSON_DocKeyTable_t * pxKeyTable,
                                       uint32_t ulContextBaseAddr,
                                       uint32_t ulContextSize,
                                       uint16_t usNumJobParams );
@@ -1370,7 +1513,16 @@ static void prvOTAUpdateTask( void * pvUnused )
                 {
                     if( pxC->ulBlocksRemaining > 0U )
                     {
-                        xErr = prvPublishGetStreamMessage( pxC );
+                        #if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 )
+                            if( pxC->pucUpdateDataURL != NULL )
+                            {
+                                xErr = prvRetryHTTPTransfer( pxC );
+                            }
+                            else
+                        #endif
+                        {
+                            xErr = prvPublishGetStreamMessage( pxC );
+                        }
 
                         if( xErr != kOTA_Err_None )
                         {                                 /* Abort the current OTA. */
@@ -1387,6 +1539,24 @@ static void prvOTAUpdateTask( void * pvUnused )
                     }
                 }
 
+                #if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 )
+                    /* Fetch more of a file that is downloaded over HTTP. */
+                    if( ( ( xBits & OTA_EVT_MASK_HTTP_FETCH ) != 0U ) && ( pxC != NULL ) && ( xInSelfTest == false ) )
+                    {
+                        if( ( pxC->pucUpdateDataURL != NULL ) && ( pxC->ulBlocksRemaining > 0U ) )
+                        {
+                            OTA_Err_t xCloseResult;
+                            IngestResult_t xResult = prvFetchFileBlocksHTTP( pxC, &xCloseResult );
+
+                            if( xResult < eIngest_Result_Accepted_Continue )
+                            {
+                                prvFinishTransfer( pxC, xResult, xCloseResult );
+                                pxC = NULL;
+                            }
+                        }
+                    }
+                #endif /* if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 ) */
+
                 /* Check if a MQTT message is ready for us to process. */
                 if( ( xBits & OTA_EVT_MASK_MSG_READY ) != 0U )
                 {
@@ -1455,43 +1625,8 @@ static void prvOTAUpdateTask( void * pvUnused )
                                         /* Negative result codes mean we should stop the OTA process
                                          * because we are either done or in an unrecoverable error state.
                                          * We don't want to hang on to the resources. */
-
-                                        if( xResult == eIngest_Result_FileComplete )
-                                        {
-                                            /* File receive is complete and authenticated. Update the job status with the self_test ready identifier. */
-                                            prvUpdateJobStatus( pxC, eJobStatus_InProgress, ( int32_t ) eJobReason_SigCheckPassed, ( int32_t ) NULL );
-                                        }
-                                        else
-                                        {
-                                            OTA_LOG_L1( "[%s] Aborting due to IngestResult_t error %d\r\n", OTA_METHOD_NAME, ( int32_t ) xResult );
-                                            /* Call the platform specific code to reject the image. */
-                                            xErr = prvPAL_SetPlatformImageState( eOTA_ImageState_Rejected );
-
-                                            if( xErr != kOTA_Err_None )
-                                            {
-                                                OTA_LOG_L2( "[%s] Error trying to set platform image state (0x%08x)\r\n", OTA_METHOD_NAME, ( int32_t ) xErr );
-                                            }
-                                            else
-                                            {
-                                                /* Nothing special to do on success. */
-                                            }
-
-                                            prvUpdateJobStatus( pxC, eJobStatus_FailedWithVal, ( int32_t ) xCloseResult, ( int32_t ) xResult );
-                                        }
-
-                                        /* Release all remaining resources of the OTA file. */
-                                        ( void ) prvOTA_Close( pxC ); /* Ignore false result since we're setting the pointer to null on the next line. */
+                                        prvFinishTransfer( pxC, xResult, xCloseResult );
                                         pxC = NULL;
-
-                                        /* Let main application know of our result. */
-                                        xOTA_Agent.xOTAJobCompleteCallback( ( xResult == eIngest_Result_FileComplete ) ? eOTA_JobEvent_Activate : eOTA_JobEvent_Fail );
-
-                                        /* Free any remaining string memory holding the job name since this job is done. */
-                                        if( xOTA_Agent.pucOTA_Singleton_ActiveJobName != NULL )
-                                        {
-                                            vPortFree( xOTA_Agent.pucOTA_Singleton_ActiveJobName );
-                                            xOTA_Agent.pucOTA_Singleton_ActiveJobName = NULL;
-                                        }
                                     }
                                     else
                                     {   /* We're actively receiving a file so update the job status as needed. */
@@ -1553,6 +1688,55 @@ static void prvOTAUpdateTask( void * pvUnused )
 }
 
 
+/* The file transfer is over, either because the whole file was received or because of an
+ * unrecoverable error. Report the result, release the file context and let the application know.
+ */
+static void prvFinishTransfer( OTA_FileContext_t * C,
+                               IngestResult_t xResult,
+                               OTA_Err_t xCloseResult )
+{
+    DEFINE_OTA_METHOD_NAME( "prvFinishTransfer" );
+
+    OTA_Err_t xErr;
+
+    if( xResult == eIngest_Result_FileComplete )
+    {
+        /* File receive is complete and authenticated. Update the job status with the self_test ready identifier. */
+        prvUpdateJobStatus( C, eJobStatus_InProgress, ( int32_t ) eJobReason_SigCheckPassed, ( int32_t ) NULL );
+    }
+    else
+    {
+        OTA_LOG_L1( "[%s] Aborting due to IngestResult_t error %d\r\n", OTA_METHOD_NAME, ( int32_t ) xResult );
+        /* Call the platform specific code to reject the image. */
+        xErr = prvPAL_SetPlatformImageState( eOTA_ImageState_Rejected );
+
+        if( xErr != kOTA_Err_None )
+        {
+            OTA_LOG_L2( "[%s] Error trying to set platform image state (0x%08x)\r\n", OTA_METHOD_NAME, ( int32_t ) xErr );
+        }
+        else
+        {
+            /* Nothing special to do on success. */
+        }
+
+        prvUpdateJobStatus( C, eJobStatus_FailedWithVal, ( int32_t ) xCloseResult, ( int32_t ) xResult );
+    }
+
+    /* Release all remaining resources of the OTA file. */
+    ( void ) prvOTA_Close( C ); /* Ignore false result since the caller drops its pointer to the context. */
+
+    /* Let main application know of our result. */
+    xOTA_Agent.xOTAJobCompleteCallback( ( xResult == eIngest_Result_FileComplete ) ? eOTA_JobEvent_Activate : eOTA_JobEvent_Fail );
+
+    /* Free any remaining string memory holding the job name since this job is done. */
+    if( xOTA_Agent.pucOTA_Singleton_ActiveJobName != NULL )
+    {
+        vPortFree( xOTA_Agent.pucOTA_Singleton_ActiveJobName );
+        xOTA_Agent.pucOTA_Singleton_ActiveJobName = NULL;
+    }
+}
+
+
 /* If we're in self test mode, start the self test timer. The latest job should
  * also be in the self test state. We must complete the self test and either
  * accept or reject the image before the timer expires or we shall reset the
@@ -1721,11 +1905,33 @@ static bool_t prvOTA_Close( OTA_FileContext_t * const C )
 
         if( C->pucStreamName != NULL )
         {
-            ( void ) prvUnSubscribeFromDataStream( C ); /* Unsubscribe from the data stream if needed. */
-            vPortFree( C->pucStreamName );              /* Free any previously allocated stream name memory. */
+            if( C->pucUpdateDataURL == NULL )
+            {
+                ( void ) prvUnSubscribeFromDataStream( C ); /* Unsubscribe from the data stream if needed. */
+            }
+
+            vPortFree( C->pucStreamName ); /* Free any previously allocated stream name memory. */
             C->pucStreamName = NULL;
         }
 
+        #if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 )
+            prvCloseHTTPConnection( C ); /* Close the connection to the HTTP server. */
+        #endif
+
+        if( C->pucUpdateDataURL != NULL )
+        {
+            vPortFree( C->pucUpdateDataURL ); /* Free the update data URL string memory. */
+            C->pucUpdateDataURL = NULL;
+        }
+
+        #if ( otaconfigENABLE_DELTA_UPDATE == 1 )
+            if( C->pxDeltaPatch != NULL )
+            {
+                OTA_Delta_Delete( C->pxDeltaPatch ); /* Free the delta update patch state. */
+                C->pxDeltaPatch = NULL;
+            }
+        #endif
+
         if( C->pucJobName != NULL )
         {
             vPortFree( C->pucJobName ); /* Free the job name memory. */
@@ -1813,7 +2019,77 @@ bool_t JSON_IsCStringEqual( const char * pcJSONString,
 }
 
 
-/* Search our document model for a key match with the given token. */
+/* Hash a JSON key into a slot of a document model's key table. This is FNV-1a
+ * with the table's seed as the offset basis, folded so the high bits also
+ * select the slot. */
+
+static uint32_t prvHashModelKey( uint32_t ulSeed,
+                                 const char * pcKey,
+                                 uint32_t ulKeyLen )
+{
+    uint32_t ulHash = ulSeed;
+    uint32_t ulIndex;
+
+    for( ulIndex = 0U; ulIndex < ulKeyLen; ulIndex++ )
+    {
+        ulHash ^= ( uint32_t ) ( uint8_t ) pcKey[ ulIndex ];
+        ulHash *= OTA_DOC_KEY_HASH_PRIME;
+    }
+
+    ulHash ^= ulHash >> 15;
+
+    return ulHash & ( OTA_DOC_KEY_TABLE_SIZE - 1UL );
+}
+
+
+/* Find the seed that gives every key of the document model its own slot in the
+ * key table, so a key in the JSON document is matched with a single string
+ * compare. */
+
+static DocParseErr_t prvBuildDocKeyTable( const JSON_DocParam_t * pxBodyDef,
+                                          uint16_t usNumParams,
+                                          JSON_DocKeyTable_t * pxKeyTable )
+{
+    DEFINE_OTA_METHOD_NAME( "prvBuildDocKeyTable" );
+
+    DocParseErr_t eErr = eDocParseErr_NoPerfectHash;
+    uint32_t ulSeed, ulSlot;
+    uint16_t usParamIndex;
+
+    for( ulSeed = OTA_DOC_KEY_HASH_BASIS; ulSeed < ( OTA_DOC_KEY_HASH_BASIS + OTA_DOC_KEY_TABLE_MAX_SEEDS ); ulSeed++ )
+    {
+        memset( pxKeyTable->ucParamIndex, 0, sizeof( pxKeyTable->ucParamIndex ) );
+
+        for( usParamIndex = 0U; usParamIndex < usNumParams; usParamIndex++ )
+        {
+            ulSlot = prvHashModelKey( ulSeed, pxBodyDef[ usParamIndex ].pcSrcKey, ( uint32_t ) strlen( pxBodyDef[ usParamIndex ].pcSrcKey ) );
+
+            if( pxKeyTable->ucParamIndex[ ulSlot ] != 0U )
+            {
+                break; /* Two keys share a slot so try the next seed. */
+            }
+
+            pxKeyTable->ucParamIndex[ ulSlot ] = ( uint8_t ) ( usParamIndex + 1U );
+        }
+
+        if( usParamIndex == usNumParams )
+        {
+            pxKeyTable->ulSeed = ulSeed;
+            eErr = eDocParseErr_None;
+            break;
+        }
+    }
+
+    if( eErr != eDocParseErr_None )
+    {
+        OTA_LOG_L1( "[%s] No seed gives each model key its own slot.\r\n", OTA_METHOD_NAME );
+    }
+
+    return eErr;
+}
+
+
+/* Search our document model for a key match with the given JSON key. */
 
 static DocParseErr_t prvSearchModelForTokenKey( JSON_DocModel_t * pxDocModel,
                                                 const char * pcJSONString,
@@ -1821,10 +2097,17 @@ static DocParseErr_t prvSearchModelForTokenKey( JSON_DocModel_t * pxDocModel,
                                                 uint16_t * pusMatchingIndexResult )
 {
     DocParseErr_t eErr = eDocParseErr_ParamKeyNotInModel;
+    const JSON_DocKeyTable_t * pxKeyTable = pxDocModel->pxKeyTable;
+    uint32_t ulSlot;
     uint16_t usParamIndex;
 
-    for( usParamIndex = 0; usParamIndex < pxDocModel->usNumModelParams; usParamIndex++ )
+    ulSlot = prvHashModelKey( pxKeyTable->ulSeed, pcJSONString, ulStrLen );
+
+    /* The only model key that can match is the one in the key's slot, if any. */
+    if( pxKeyTable->ucParamIndex[ ulSlot ] != 0U )
     {
+        usParamIndex = ( uint16_t ) pxKeyTable->ucParamIndex[ ulSlot ] - 1U;
+
         if( JSON_IsCStringEqual( pcJSONString, ulStrLen,
                                  pxDocModel->pxBodyDef[ usParamIndex ].pcSrcKey ) == ( bool_t ) pdTRUE )
         {
@@ -1840,8 +2123,6 @@ static DocParseErr_t prvSearchModelForTokenKey( JSON_DocModel_t * pxDocModel,
                 *pusMatchingIndexResult = usParamIndex;                       /* Save result index for caller. */
                 eErr = eDocParseErr_None;                                     /* We found a matching key in the document model. */
             }
-
-            break; /* We found a key match so stop searching. */
         }
     }
 
@@ -1849,316 +2130,502 @@ static DocParseErr_t prvSearchModelForTokenKey( JSON_DocModel_t * pxDocModel,
 }
 
 
+/* Skip any whitespace and return the next character of the JSON document, or
+ * zero at the end of the document. */
 
-/* Extract the desired fields from the JSON document based on the specified document model. */
-
-static DocParseErr_t prvParseJSONbyModel( const char * pcJSON,
-                                          uint32_t ulMsgLen,
-                                          JSON_DocModel_t * pxDocModel )
+static char prvJSONPeek( JSON_Scanner_t * pxScan )
 {
-    DEFINE_OTA_METHOD_NAME( "prvParseJSONbyModel" );
-
-    const JSON_DocParam_t * pxModelParam;
-    jsmn_parser xParser;
-    jsmntok_t * pxTokens;
-    jsmntok_t * pxValTok;
-    uint32_t ulNumTokens, ulTokenLen;
-    MultiParmPtr_t xParamAddr; /*lint !e9018 We intentionally use this union to cast the parameter address to the proper type. */
-    uint32_t ulIndex;
-    uint16_t usModelParamIndex;
-    uint32_t ulScanIndex;
-    DocParseErr_t eErr = eDocParseErr_Unknown;
+    char cNext = '\0';
 
+    while( pxScan->ulIndex < pxScan->ulLen )
+    {
+        cNext = pxScan->pcJSON[ pxScan->ulIndex ];
 
-    /* Reset the Jasmine tokenizer. */
-    jsmn_init( &xParser );
+        if( ( cNext != ' ' ) && ( cNext != '\t' ) && ( cNext != '\r' ) && ( cNext != '\n' ) )
+        {
+            break;
+        }
 
-    /* Validate some initial parameters. */
-    if( pxDocModel == NULL )
-    {
-        OTA_LOG_L1( "[%s] The pointer to the document model is NULL.\r\n", OTA_METHOD_NAME );
-        eErr = eDocParseErr_NullModelPointer;
-    }
-    else if( pxDocModel->pxBodyDef == NULL )
-    {
-        OTA_LOG_L1( "[%s] Document model 0x%08x body pointer is NULL.\r\n", OTA_METHOD_NAME, pxDocModel );
-        eErr = eDocParseErr_NullBodyPointer;
-    }
-    else if( pxDocModel->usNumModelParams > OTA_DOC_MODEL_MAX_PARAMS )
-    {
-        OTA_LOG_L1( "[%s] Model has too many parameters (%u).\r\n", OTA_METHOD_NAME, pxDocModel->usNumModelParams );
-        eErr = eDocParseErr_TooManyParams;
+        cNext = '\0';
+        pxScan->ulIndex++;
     }
-    else if( pcJSON == NULL )
+
+    return cNext;
+}
+
+
+/* Scan the string or primitive value at the current position, returning the
+ * offset and length of its text, excluding the quotes of a string. Escape
+ * sequences are left as they are, as the strings of the model never use them. */
+
+static bool_t prvJSONScanScalar( JSON_Scanner_t * pxScan,
+                                 uint32_t * pulStart,
+                                 uint32_t * pulLen )
+{
+    bool_t xResult = ( bool_t ) pdFALSE;
+    uint32_t ulIndex = pxScan->ulIndex;
+    char cNext;
+
+    if( ( ulIndex < pxScan->ulLen ) && ( pxScan->pcJSON[ ulIndex ] == '"' ) )
     {
-        OTA_LOG_L1( "[%s] JSON document pointer is NULL!\r\n", OTA_METHOD_NAME );
-        eErr = eDocParseErr_NullDocPointer;
+        *pulStart = ++ulIndex;
+
+        for( ; ( ulIndex < pxScan->ulLen ) && ( pxScan->pcJSON[ ulIndex ] != '\0' ); ulIndex++ )
+        {
+            cNext = pxScan->pcJSON[ ulIndex ];
+
+            if( cNext == '\\' )
+            {
+                ulIndex++; /* Skip the escaped character. */
+            }
+            else if( cNext == '"' )
+            {
+                *pulLen = ulIndex - *pulStart;
+                pxScan->ulIndex = ulIndex + 1U;
+                xResult = ( bool_t ) pdTRUE;
+                break;
+            }
+            else
+            {
+                /* Part of the string. */
+            }
+        }
     }
     else
     {
-        pxModelParam = pxDocModel->pxBodyDef;
+        /* A number, true, false or null runs up to the next delimiter. */
+        *pulStart = ulIndex;
 
-        /* Count the total number of tokens in our JSON document. */
-        ulNumTokens = ( uint32_t ) jsmn_parse( &xParser, pcJSON, ( size_t ) ulMsgLen, NULL, 1UL );
-
-        if( ulNumTokens > 0U )
+        for( ; ulIndex < pxScan->ulLen; ulIndex++ )
         {
-            /* If the JSON document isn't too big for our token array... */
-            if( ulNumTokens <= OTA_MAX_JSON_TOKENS )
+            cNext = pxScan->pcJSON[ ulIndex ];
+
+            if( ( cNext == ',' ) || ( cNext == '}' ) || ( cNext == ']' ) || ( cNext == ' ' ) ||
+                ( cNext == '\t' ) || ( cNext == '\r' ) || ( cNext == '\n' ) || ( cNext == '\0' ) )
             {
-                /* Allocate space for the document JSON tokens. */
-                void * pvTokenArray = pvPortMalloc( ulNumTokens * sizeof( jsmntok_t ) ); /* Allocate space on heap for temporary token array. */
-                pxTokens = ( jsmntok_t * ) pvTokenArray;                                 /*lint !e9079 !e9087 heap allocations return void* so we allow casting to a pointer to the actual type. */
+                break;
+            }
+            else if( ( cNext == '"' ) || ( cNext == '{' ) || ( cNext == '[' ) || ( cNext == ':' ) )
+            {
+                ulIndex = *pulStart; /* Not a valid primitive. */
+                break;
+            }
+            else
+            {
+                /* Part of the primitive. */
+            }
+        }
 
-                if( pxTokens != NULL )
-                {
-                    /* Reset Jasmine again and tokenize the document for real. */
-                    jsmn_init( &xParser );
-                    ulIndex = ( uint32_t ) jsmn_parse( &xParser, pcJSON, ulMsgLen, pxTokens, ulNumTokens );
+        if( ulIndex > *pulStart )
+        {
+            *pulLen = ulIndex - *pulStart;
+            pxScan->ulIndex = ulIndex;
+            xResult = ( bool_t ) pdTRUE;
+        }
+    }
 
-                    if( ulIndex == ulNumTokens )
-                    {
-                        /* Start the parser in an error free state. */
-                        eErr = eDocParseErr_None;
+    return xResult;
+}
 
-                        /* Examine each JSON token, searching for job parameters based on our document model. */
-                        for( ulIndex = 0U; ( eErr == eDocParseErr_None ) && ( ulIndex < ulNumTokens ); ulIndex++ )
-                        {
-                            /* All parameter keys are JSON strings. */
-                            if( pxTokens[ ulIndex ].type == JSMN_STRING )
-                            {
-                                /* Search the document model to see if it matches the current key. */
-                                ulTokenLen = ( uint32_t ) pxTokens[ ulIndex ].end - ( uint32_t ) pxTokens[ ulIndex ].start;
-                                eErr = prvSearchModelForTokenKey( pxDocModel, &pcJSON[ pxTokens[ ulIndex ].start ], ulTokenLen, &usModelParamIndex );
 
-                                /* If we didn't find a match in the model, skip over it and its descendants. */
-                                if( eErr == eDocParseErr_ParamKeyNotInModel )
-                                {
-                                    int32_t lRoot = ( int32_t ) ulIndex; /* Create temp root from the unrecognized tokens index. Use signed int since the parent index is signed. */
-                                    ulIndex++;                           /* Skip the active key since it's the one we don't recognize. */
+/* Store the value of a parameter found in the JSON document where the document
+ * model says to. */
 
-                                    /* Skip tokens whose parents are equal to or deeper than the unrecognized temporary root token level. */
-                                    while( ( ulIndex < ulNumTokens ) && ( pxTokens[ ulIndex ].parent >= lRoot ) )
-                                    {
-                                        ulIndex++; /* Skip over all descendants of the unknown parent. */
-                                    }
+static DocParseErr_t prvExtractParameter( JSON_DocModel_t * pxDocModel,
+                                          uint16_t usModelParamIndex,
+                                          const char * pcValue,
+                                          uint32_t ulValueLen )
+{
+    DEFINE_OTA_METHOD_NAME( "prvExtractParameter" );
 
-                                    --ulIndex;                /* Adjust for outer for-loop increment. */
-                                    eErr = eDocParseErr_None; /* Unknown key structures are simply skipped so clear the error state to continue. */
-                                }
-                                else if( eErr == eDocParseErr_None )
-                                {
-                                    /* We found the parameter key in the document model. */
+    const JSON_DocParam_t * pxModelParam = pxDocModel->pxBodyDef;
+    MultiParmPtr_t xParamAddr; /*lint !e9018 We intentionally use this union to cast the parameter address to the proper type. */
+    DocParseErr_t eErr = eDocParseErr_None;
 
-                                    /* Get the value field (i.e. the following token) for the parameter. */
-                                    pxValTok = &pxTokens[ ulIndex + 1UL ];
+    /* Get destination offset to parameter storage location. */
 
-                                    /* Verify the field type is what we expect for this parameter. */
-                                    if( pxValTok->type != pxModelParam[ usModelParamIndex ].eJasmineType )
-                                    {
-                                        ulTokenLen = ( uint32_t ) ( pxValTok->end ) - ( uint32_t ) ( pxValTok->start );
-                                        OTA_LOG_L1( "[%s] parameter type mismatch [ %s : %.*s ] type %u, expected %u\r\n",
-                                                    OTA_METHOD_NAME, pxModelParam[ usModelParamIndex ].pcSrcKey, ulTokenLen,
-                                                    &pcJSON[ pxValTok->start ],
-                                                    pxValTok->type, pxModelParam[ usModelParamIndex ].eJasmineType );
-                                        eErr = eDocParseErr_FieldTypeMismatch;
-                                        /* break; */
-                                    }
-                                    else if( OTA_DONT_STORE_PARAM == pxModelParam[ usModelParamIndex ].ulDestOffset )
-                                    {
-                                        /* Nothing to do with this parameter since we're not storing it. */
-                                        continue;
-                                    }
-                                    else
-                                    {
-                                        /* Get destination offset to parameter storage location. */
+    /* If it's within the models context structure, add in the context instance base address. */
+    if( pxModelParam[ usModelParamIndex ].ulDestOffset < pxDocModel->ulContextSize )
+    {
+        xParamAddr.ulVal = pxDocModel->ulContextBase + pxModelParam[ usModelParamIndex ].ulDestOffset;
+    }
+    else
+    {
+        /* It's a raw pointer so keep it as is. */
+        xParamAddr.ulVal = pxModelParam[ usModelParamIndex ].ulDestOffset;
+    }
 
-                                        /* If it's within the models context structure, add in the context instance base address. */
-                                        if( pxModelParam[ usModelParamIndex ].ulDestOffset < pxDocModel->ulContextSize )
-                                        {
-                                            xParamAddr.ulVal = pxDocModel->ulContextBase + pxModelParam[ usModelParamIndex ].ulDestOffset;
-                                        }
-                                        else
-                                        {
-                                            /* It's a raw pointer so keep it as is. */
-                                            xParamAddr.ulVal = pxModelParam[ usModelParamIndex ].ulDestOffset;
-                                        }
+    if( eModelParamType_StringCopy == pxModelParam[ usModelParamIndex ].xModelParamType )
+    {
+        /* Malloc memory for a copy of the value string plus a zero terminator. */
+        void * pvStringCopy = pvPortMalloc( ulValueLen + 1U );
 
-                                        if( eModelParamType_StringCopy == pxModelParam[ usModelParamIndex ].xModelParamType )
-                                        {
-                                            /* Malloc memory for a copy of the value string plus a zero terminator. */
-                                            ulTokenLen = ( uint32_t ) ( pxValTok->end ) - ( uint32_t ) ( pxValTok->start );
-                                            void * pvStringCopy = pvPortMalloc( ulTokenLen + 1U );
-
-                                            if( pvStringCopy != NULL )
-                                            {
-                                                *xParamAddr.ppvPtr = pvStringCopy;
-                                                char * pcStringCopy = *xParamAddr.ppcPtr;
-                                                /* Copy parameter string into newly allocated memory. */
-                                                memcpy( pcStringCopy, &pcJSON[ pxValTok->start ], ulTokenLen );
-                                                /* Zero terminate the new string. */
-                                                pcStringCopy[ ulTokenLen ] = '\0';
-                                                OTA_LOG_L1( "[%s] Extracted parameter [ %s: %s ]\r\n",
-                                                            OTA_METHOD_NAME,
-                                                            pxModelParam[ usModelParamIndex ].pcSrcKey,
-                                                            pcStringCopy );
-                                            }
-                                            else
-                                            {   /* Stop processing on error. */
-                                                eErr = eDocParseErr_OutOfMemory;
-                                                /* break; */
-                                            }
-                                        }
-                                        else if( eModelParamType_StringInDoc == pxModelParam[ usModelParamIndex ].xModelParamType )
-                                        {
-                                            /* Copy pointer to source string instead of duplicating the string. */
-                                            const char * pcStringInDoc = &pcJSON[ pxValTok->start ];
-
-                                            if( pcStringInDoc != NULL ) /*lint !e774 This can result in NULL if offset rolls the address around. */
-                                            {
-                                                *xParamAddr.ppcConstPtr = pcStringInDoc;
-                                                ulTokenLen = ( uint32_t ) ( pxValTok->end ) - ( uint32_t ) ( pxValTok->start );
-                                                OTA_LOG_L1( "[%s] Extracted parameter [ %s: %.*s ]\r\n",
-                                                            OTA_METHOD_NAME,
-                                                            pxModelParam[ usModelParamIndex ].pcSrcKey,
-                                                            ulTokenLen, pcStringInDoc );
-                                            }
-                                            else
-                                            {
-                                                /* This should never happen unless there's a bug or memory is corrupted. */
-                                                OTA_LOG_L1( "[%s] Error! JSON token produced a null pointer for parameter [ %s ]\r\n",
-                                                            OTA_METHOD_NAME,
-                                                            pxModelParam[ usModelParamIndex ].pcSrcKey );
-                                                eErr = eDocParseErr_InvalidToken;
-                                            }
-                                        }
-                                        else if( eModelParamType_UInt32 == pxModelParam[ usModelParamIndex ].xModelParamType )
-                                        {
-                                            char * pcEnd;
-                                            const char * pcStart = &pcJSON[ pxValTok->start ];
-                                            *xParamAddr.pulPtr = strtoul( pcStart, &pcEnd, 0 );
-
-                                            if( pcEnd == &pcJSON[ pxValTok->end ] )
-                                            {
-                                                OTA_LOG_L1( "[%s] Extracted parameter [ %s: %u ]\r\n",
-                                                            OTA_METHOD_NAME,
-                                                            pxModelParam[ usModelParamIndex ].pcSrcKey,
-                                                            *xParamAddr.pulPtr );
-                                            }
-                                            else
-                                            {
-                                                eErr = eDocParseErr_InvalidNumChar;
-                                            }
-                                        }
-                                        else if( eModelParamType_SigBase64 == pxModelParam[ usModelParamIndex ].xModelParamType )
-                                        {
-                                            /* Allocate space for and decode the base64 signature. */
-                                            void * pvSignature = pvPortMalloc( sizeof( Sig256_t ) );
-
-                                            if( pvSignature != NULL )
-                                            {
-                                                size_t xActualLen;
-                                                *xParamAddr.ppvPtr = pvSignature;
-                                                Sig256_t * pxSig256 = *xParamAddr.ppxSig256Ptr;
-                                                ulTokenLen = ( uint32_t ) ( pxValTok->end ) - ( uint32_t ) ( pxValTok->start );
-
-                                                if( mbedtls_base64_decode( pxSig256->ucData, sizeof( pxSig256->ucData ), &xActualLen,
-                                                                           ( const uint8_t * ) &pcJSON[ pxValTok->start ], ulTokenLen ) != 0 )
-                                                {   /* Stop processing on error. */
-                                                    OTA_LOG_L1( "[%s] mbedtls_base64_decode failed.\r\n", OTA_METHOD_NAME );
-                                                    eErr = eDocParseErr_Base64Decode;
-                                                    /* break; */
-                                                }
-                                                else
-                                                {
-                                                    pxSig256->usSize = ( uint16_t ) xActualLen;
-                                                    OTA_LOG_L1( "[%s] Extracted parameter [ %s: %.32s... ]\r\n",
-                                                                OTA_METHOD_NAME,
-                                                                pxModelParam[ usModelParamIndex ].pcSrcKey,
-                                                                &pcJSON[ pxValTok->start ] );
-                                                }
-                                            }
-                                            else
-                                            {
-                                                /* We failed to allocate needed memory. Everything will be freed below upon failure. */
-                                                eErr = eDocParseErr_OutOfMemory;
-                                            }
-                                        }
-                                        else if( eModelParamType_Ident == pxModelParam[ usModelParamIndex ].xModelParamType )
-                                        {
-                                            OTA_LOG_L1( "[%s] Identified parameter [ %s ]\r\n",
-                                                        OTA_METHOD_NAME,
-                                                        pxModelParam[ usModelParamIndex ].pcSrcKey );
-                                            *xParamAddr.pxBoolPtr = pdTRUE;
-                                        }
-                                        else
-                                        {
-                                            /* Ignore invalid document model type. */
-                                        }
-                                    }
-                                }
-                                else
-                                {
-                                    /* Nothing special to do. The error will break us out of the loop. */
-                                }
-                            }
-                            else
-                            {
-                                /* Ignore tokens that are not strings and move on to the next. */
-                            }
-                        }
+        if( pvStringCopy != NULL )
+        {
+            *xParamAddr.ppvPtr = pvStringCopy;
+            char * pcStringCopy = *xParamAddr.ppcPtr;
+            /* Copy parameter string into newly allocated memory. */
+            memcpy( pcStringCopy, pcValue, ulValueLen );
+            /* Zero terminate the new string. */
+            pcStringCopy[ ulValueLen ] = '\0';
+            OTA_LOG_L1( "[%s] Extracted parameter [ %s: %s ]\r\n",
+                        OTA_METHOD_NAME,
+                        pxModelParam[ usModelParamIndex ].pcSrcKey,
+                        pcStringCopy );
+        }
+        else
+        {   /* Stop processing on error. */
+            eErr = eDocParseErr_OutOfMemory;
+        }
+    }
+    else if( eModelParamType_StringInDoc == pxModelParam[ usModelParamIndex ].xModelParamType )
+    {
+        /* Copy pointer to source string instead of duplicating the string. */
+        *xParamAddr.ppcConstPtr = pcValue;
+        OTA_LOG_L1( "[%s] Extracted parameter [ %s: %.*s ]\r\n",
+                    OTA_METHOD_NAME,
+                    pxModelParam[ usModelParamIndex ].pcSrcKey,
+                    ulValueLen, pcValue );
+    }
+    else if( eModelParamType_UInt32 == pxModelParam[ usModelParamIndex ].xModelParamType )
+    {
+        char * pcEnd;
+        *xParamAddr.pulPtr = strtoul( pcValue, &pcEnd, 0 );
 
-                        /* Free the token memory. */
-                        vPortFree( pxTokens ); /*lint !e850 ulIndex is intentionally modified within the loop to skip over unknown tags. */
+        if( pcEnd == &pcValue[ ulValueLen ] )
+        {
+            OTA_LOG_L1( "[%s] Extracted parameter [ %s: %u ]\r\n",
+                        OTA_METHOD_NAME,
+                        pxModelParam[ usModelParamIndex ].pcSrcKey,
+                        *xParamAddr.pulPtr );
+        }
+        else
+        {
+            eErr = eDocParseErr_InvalidNumChar;
+        }
+    }
+    else if( eModelParamType_SigBase64 == pxModelParam[ usModelParamIndex ].xModelParamType )
+    {
+        /* Allocate space for and decode the base64 signature. */
+        void * pvSignature = pvPortMalloc( sizeof( Sig256_t ) );
 
-                        if( eErr == eDocParseErr_None )
-                        {
-                            uint32_t ulMissingParams = ( pxDocModel->ulParamsReceivedBitmap & pxDocModel->ulParamsRequiredBitmap )
-                                                       ^ pxDocModel->ulParamsRequiredBitmap;
+        if( pvSignature != NULL )
+        {
+            size_t xActualLen;
+            *xParamAddr.ppvPtr = pvSignature;
+            Sig256_t * pxSig256 = *xParamAddr.ppxSig256Ptr;
+
+            if( mbedtls_base64_decode( pxSig256->ucData, sizeof( pxSig256->ucData ), &xActualLen,
+                                       ( const uint8_t * ) pcValue, ulValueLen ) != 0 )
+            {   /* Stop processing on error. */
+                OTA_LOG_L1( "[%s] mbedtls_base64_decode failed.\r\n", OTA_METHOD_NAME );
+                eErr = eDocParseErr_Base64Decode;
+            }
+            else
+            {
+                pxSig256->usSize = ( uint16_t ) xActualLen;
+                OTA_LOG_L1( "[%s] Extracted parameter [ %s: %.32s... ]\r\n",
+                            OTA_METHOD_NAME,
+                            pxModelParam[ usModelParamIndex ].pcSrcKey,
+                            pcValue );
+            }
+        }
+        else
+        {
+            /* We failed to allocate needed memory. Everything will be freed below upon failure. */
+            eErr = eDocParseErr_OutOfMemory;
+        }
+    }
+    else if( eModelParamType_Ident == pxModelParam[ usModelParamIndex ].xModelParamType )
+    {
+        OTA_LOG_L1( "[%s] Identified parameter [ %s ]\r\n",
+                    OTA_METHOD_NAME,
+                    pxModelParam[ usModelParamIndex ].pcSrcKey );
+        *xParamAddr.pxBoolPtr = pdTRUE;
+    }
+    else
+    {
+        /* Ignore invalid document model type. */
+    }
 
-                            if( ulMissingParams != 0U )
-                            {
-                                /* The job document did not have all required document model parameters. */
-                                for( ulScanIndex = 0UL; ulScanIndex < pxDocModel->usNumModelParams; ulScanIndex++ )
-                                {
-                                    if( ( ulMissingParams & ( 1UL << ulScanIndex ) ) != 0UL )
-                                    {
-                                        OTA_LOG_L1( "[%s] parameter not present: %s\r\n",
-                                                    OTA_METHOD_NAME,
-                                                    pxModelParam[ ulScanIndex ].pcSrcKey );
-                                    }
-                                }
+    return eErr;
+}
 
-                                eErr = eDocParseErr_MalformedDoc;
-                            }
-                        }
-                        else
-                        {
-                            OTA_LOG_L1( "[%s] Error (%d) parsing JSON document.\r\n", OTA_METHOD_NAME, ( int32_t ) eErr );
-                        }
-                    }
-                    else
-                    {
-                        OTA_LOG_L1( "[%s] jsmn_parse didn't match token count when parsing.\r\n", OTA_METHOD_NAME );
-                        eErr = eDocParseErr_JasmineCountMismatch;
-                    }
+
+/* Walk the JSON document once, looking up each key in the document model as it
+ * is reached and storing the values the model asks for. The values of keys
+ * that are not in the model are skipped, along with everything nested within
+ * them, but are still checked to be well formed. */
+
+static DocParseErr_t prvStreamJSONbyModel( JSON_Scanner_t * pxScan,
+                                           JSON_DocModel_t * pxDocModel )
+{
+    DEFINE_OTA_METHOD_NAME( "prvStreamJSONbyModel" );
+
+    const JSON_DocParam_t * pxModelParam = pxDocModel->pxBodyDef;
+    DocParseErr_t eErr = eDocParseErr_None;
+    uint32_t ulArrayBitmap = 0U; /* Bit n is set if the container at depth n is an array. */
+    uint32_t ulDepth = 0U;
+    uint32_t ulSkipDepth = 0U;   /* Depth of the outermost container being skipped, or zero. */
+    uint32_t ulStart, ulLen;
+    uint16_t usModelParamIndex;
+    bool_t xInArray, xHaveParam, xSkipValue;
+    bool_t xAfterValue = ( bool_t ) pdFALSE, xAfterComma = ( bool_t ) pdFALSE;
+    jsmntype_t eValueType;
+    char cNext;
+
+    cNext = prvJSONPeek( pxScan );
+
+    if( cNext == '\0' )
+    {
+        OTA_LOG_L1( "[%s] Invalid JSON document. No tokens parsed. \r\n", OTA_METHOD_NAME );
+        eErr = eDocParseErr_NoTokens;
+    }
+    else if( ( cNext != '{' ) && ( cNext != '[' ) )
+    {
+        eErr = eDocParseErr_InvalidSyntax;
+    }
+    else
+    {
+        /* The document is parsed as though it were the value of an array. */
+        ulArrayBitmap = 1U;
+        ulDepth = 1U;
+    }
+
+    while( ( eErr == eDocParseErr_None ) && ( ulDepth > 0U ) )
+    {
+        cNext = prvJSONPeek( pxScan );
+        xInArray = ( ( ulArrayBitmap & ( 1UL << ( ulDepth - 1U ) ) ) != 0U ) ? ( bool_t ) pdTRUE : ( bool_t ) pdFALSE;
+        xHaveParam = ( bool_t ) pdFALSE;
+        xSkipValue = ( ulSkipDepth != 0U ) ? ( bool_t ) pdTRUE : ( bool_t ) pdFALSE;
+
+        if( ( ulDepth > 1U ) && ( cNext == ( ( xInArray == ( bool_t ) pdTRUE ) ? ']' : '}' ) ) )
+        {
+            /* The end of the current object or array, which is the value just
+             * completed in the one that contains it. A comma must be followed
+             * by another value. */
+            if( xAfterComma == ( bool_t ) pdTRUE )
+            {
+                eErr = eDocParseErr_InvalidSyntax;
+                break;
+            }
+
+            pxScan->ulIndex++;
+
+            if( ulDepth == ulSkipDepth )
+            {
+                ulSkipDepth = 0U;
+            }
+
+            ulDepth--;
+            xAfterValue = ( bool_t ) pdTRUE;
+
+            if( ulDepth == 1U )
+            {
+                ulDepth = 0U; /* Anything after the document is ignored. */
+            }
+
+            continue;
+        }
+        else if( xAfterValue == ( bool_t ) pdTRUE )
+        {
+            if( cNext != ',' )
+            {
+                eErr = eDocParseErr_InvalidSyntax;
+                break;
+            }
+
+            pxScan->ulIndex++;
+            xAfterValue = ( bool_t ) pdFALSE;
+            xAfterComma = ( bool_t ) pdTRUE;
+            continue;
+        }
+        else if( xInArray == ( bool_t ) pdFALSE )
+        {
+            /* A key, which is looked up as soon as it has been scanned unless
+             * it is within a value being skipped. */
+            if( ( cNext != '"' ) || ( prvJSONScanScalar( pxScan, &ulStart, &ulLen ) == ( bool_t ) pdFALSE ) ||
+                ( prvJSONPeek( pxScan ) != ':' ) )
+            {
+                eErr = eDocParseErr_InvalidSyntax;
+                break;
+            }
+
+            pxScan->ulIndex++;
+
+            if( xSkipValue == ( bool_t ) pdFALSE )
+            {
+                eErr = prvSearchModelForTokenKey( pxDocModel, &pxScan->pcJSON[ ulStart ], ulLen, &usModelParamIndex );
+
+                if( eErr == eDocParseErr_ParamKeyNotInModel )
+                {
+                    /* Unknown key structures are simply skipped. */
+                    eErr = eDocParseErr_None;
+                    xSkipValue = ( bool_t ) pdTRUE;
+                }
+                else if( eErr != eDocParseErr_None )
+                {
+                    break;
                 }
                 else
                 {
-                    OTA_LOG_L1( "[%s] No memory for JSON tokens.\r\n", OTA_METHOD_NAME );
-                    eErr = eDocParseErr_OutOfMemory;
+                    xHaveParam = ( bool_t ) pdTRUE;
                 }
             }
+        }
+        else
+        {
+            /* An array element, which has no key. */
+        }
+
+        xAfterComma = ( bool_t ) pdFALSE;
+
+        cNext = prvJSONPeek( pxScan );
+        eValueType = ( cNext == '{' ) ? JSMN_OBJECT : ( cNext == '[' ) ? JSMN_ARRAY : ( cNext == '"' ) ? JSMN_STRING : JSMN_PRIMITIVE;
+
+        if( ( xHaveParam == ( bool_t ) pdTRUE ) && ( eValueType != pxModelParam[ usModelParamIndex ].eJasmineType ) )
+        {
+            /* Verify the field type is what we expect for this parameter. */
+            OTA_LOG_L1( "[%s] parameter type mismatch [ %s ] type %u, expected %u\r\n",
+                        OTA_METHOD_NAME, pxModelParam[ usModelParamIndex ].pcSrcKey,
+                        eValueType, pxModelParam[ usModelParamIndex ].eJasmineType );
+            eErr = eDocParseErr_FieldTypeMismatch;
+        }
+        else if( ( eValueType == JSMN_OBJECT ) || ( eValueType == JSMN_ARRAY ) )
+        {
+            /* Objects and arrays are entered, so the keys within them are found. */
+            if( ulDepth >= OTA_MAX_JSON_DEPTH )
+            {
+                OTA_LOG_L1( "[%s] Document is nested too deeply.\r\n", OTA_METHOD_NAME );
+                eErr = eDocParseErr_InvalidSyntax;
+            }
             else
             {
-                OTA_LOG_L1( "[%s] Document has too many keys.\r\n", OTA_METHOD_NAME );
-                eErr = eDocParseErr_TooManyTokens;
+                if( eValueType == JSMN_ARRAY )
+                {
+                    ulArrayBitmap |= ( 1UL << ulDepth );
+                }
+                else
+                {
+                    ulArrayBitmap &= ~( 1UL << ulDepth );
+                }
+
+                ulDepth++;
+                pxScan->ulIndex++;
+
+                if( ( xSkipValue == ( bool_t ) pdTRUE ) && ( ulSkipDepth == 0U ) )
+                {
+                    ulSkipDepth = ulDepth;
+                }
             }
         }
+        else if( prvJSONScanScalar( pxScan, &ulStart, &ulLen ) == ( bool_t ) pdFALSE )
+        {
+            eErr = eDocParseErr_InvalidSyntax;
+        }
         else
         {
-            OTA_LOG_L1( "[%s] Invalid JSON document. No tokens parsed. \r\n", OTA_METHOD_NAME );
-            eErr = eDocParseErr_NoTokens;
+            if( ( xHaveParam == ( bool_t ) pdTRUE ) && ( OTA_DONT_STORE_PARAM != pxModelParam[ usModelParamIndex ].ulDestOffset ) )
+            {
+                eErr = prvExtractParameter( pxDocModel, usModelParamIndex, &pxScan->pcJSON[ ulStart ], ulLen );
+            }
+
+            xAfterValue = ( bool_t ) pdTRUE;
+        }
+    }
+
+    if( eErr == eDocParseErr_InvalidSyntax )
+    {
+        OTA_LOG_L1( "[%s] Invalid JSON at offset %u.\r\n", OTA_METHOD_NAME, pxScan->ulIndex );
+    }
+
+    return eErr;
+}
+
+
+/* Extract the desired fields from the JSON document based on the specified document model. */
+
+static DocParseErr_t prvParseJSONbyModel( const char * pcJSON,
+                                          uint32_t ulMsgLen,
+                                          JSON_DocModel_t * pxDocModel )
+{
+    DEFINE_OTA_METHOD_NAME( "prvParseJSONbyModel" );
+
+    JSON_DocKeyTable_t xKeyTable;
+    JSON_Scanner_t xScan;
+    uint32_t ulScanIndex;
+    DocParseErr_t eErr = eDocParseErr_Unknown;
+
+    /* Validate some initial parameters. */
+    if( pxDocModel == NULL )
+    {
+        OTA_LOG_L1( "[%s] The pointer to the document model is NULL.\r\n", OTA_METHOD_NAME );
+        eErr = eDocParseErr_NullModelPointer;
+    }
+    else if( pxDocModel->pxBodyDef == NULL )
+    {
+        OTA_LOG_L1( "[%s] Document model 0x%08x body pointer is NULL.\r\n", OTA_METHOD_NAME, pxDocModel );
+        eErr = eDocParseErr_NullBodyPointer;
+    }
+    else if( pxDocModel->usNumModelParams > OTA_DOC_MODEL_MAX_PARAMS )
+    {
+        OTA_LOG_L1( "[%s] Model has too many parameters (%u).\r\n", OTA_METHOD_NAME, pxDocModel->usNumModelParams );
+        eErr = eDocParseErr_TooManyParams;
+    }
+    else if( pcJSON == NULL )
+    {
+        OTA_LOG_L1( "[%s] JSON document pointer is NULL!\r\n", OTA_METHOD_NAME );
+        eErr = eDocParseErr_NullDocPointer;
+    }
+    else
+    {
+        eErr = eDocParseErr_None;
+
+        /* A model that was not prepared by prvInitDocModel() gets a key table
+         * for this document only. */
+        if( pxDocModel->pxKeyTable == NULL )
+        {
+            eErr = prvBuildDocKeyTable( pxDocModel->pxBodyDef, pxDocModel->usNumModelParams, &xKeyTable );
+            pxDocModel->pxKeyTable = &xKeyTable;
+        }
+
+        if( eErr == eDocParseErr_None )
+        {
+            xScan.pcJSON = pcJSON;
+            xScan.ulLen = ulMsgLen;
+            xScan.ulIndex = 0U;
+            eErr = prvStreamJSONbyModel( &xScan, pxDocModel );
+        }
+
+        if( pxDocModel->pxKeyTable == &xKeyTable )
+        {
+            pxDocModel->pxKeyTable = NULL;
+        }
+
+        if( eErr == eDocParseErr_None )
+        {
+            uint32_t ulMissingParams = ( pxDocModel->ulParamsReceivedBitmap & pxDocModel->ulParamsRequiredBitmap )
+                                       ^ pxDocModel->ulParamsRequiredBitmap;
+
+            if( ulMissingParams != 0U )
+            {
+                /* The job document did not have all required document model parameters. */
+                for( ulScanIndex = 0UL; ulScanIndex < pxDocModel->usNumModelParams; ulScanIndex++ )
+                {
+                    if( ( ulMissingParams & ( 1UL << ulScanIndex ) ) != 0UL )
+                    {
+                        OTA_LOG_L1( "[%s] parameter not present: %s\r\n",
+                                    OTA_METHOD_NAME,
+                                    pxDocModel->pxBodyDef[ ulScanIndex ].pcSrcKey );
+                    }
+                }
+
+                eErr = eDocParseErr_MalformedDoc;
+            }
+        }
+        else
+        {
+            OTA_LOG_L1( "[%s] Error (%d) parsing JSON document.\r\n", OTA_METHOD_NAME, ( int32_t ) eErr );
         }
     }
 
@@ -2172,6 +2639,7 @@ static DocParseErr_t prvParseJSONbyModel( const char * pcJSON,
 
 static DocParseErr_t prvInitDocModel( JSON_DocModel_t * pxDocModel,
                                       const JSON_DocParam_t * pxBodyDef,
+                                      JSON_DocKeyTable_t * pxKeyTable,
                                       uint32_t ulContextBaseAddr,
                                       uint32_t ulContextSize,
                                       uint16_t usNumJobParams )
@@ -2189,9 +2657,9 @@ static DocParseErr_t prvInitDocModel( JSON_DocModel_t * pxDocModel,
         OTA_LOG_L1( "[%s] The pointer to the document model is NULL.\r\n", OTA_METHOD_NAME );
         eErr = eDocParseErr_NullModelPointer;
     }
-    else if( pxBodyDef == NULL )
+    else if( ( pxBodyDef == NULL ) || ( pxKeyTable == NULL ) )
     {
-        OTA_LOG_L1( "[%s] Document model 0x%08x body pointer is NULL.\r\n", OTA_METHOD_NAME, pxDocModel );
+        OTA_LOG_L1( "[%s] Document model 0x%08x body or key table pointer is NULL.\r\n", OTA_METHOD_NAME, pxDocModel );
         eErr = eDocParseErr_NullBodyPointer;
     }
     else if( usNumJobParams > OTA_DOC_MODEL_MAX_PARAMS )
@@ -2218,7 +2686,18 @@ static DocParseErr_t prvInitDocModel( JSON_DocModel_t * pxDocModel,
             }
         }
 
-        eErr = eDocParseErr_None;
+        /* The key table depends only on the model's keys, so it is built the
+         * first time the model is used and kept for later documents. */
+        if( pxKeyTable->ulSeed == 0U )
+        {
+            eErr = prvBuildDocKeyTable( pxBodyDef, usNumJobParams, pxKeyTable );
+        }
+        else
+        {
+            eErr = eDocParseErr_None;
+        }
+
+        pxDocModel->pxKeyTable = pxKeyTable;
     }
 
     return eErr;
@@ -2255,8 +2734,13 @@ static OTA_FileContext_t * prvParseJobDoc( const char * pcJSON,
         { cOTA_JSON_FileCertNameKey,  OTA_JOB_PARAM_REQUIRED, { OFFSET_OF( OTA_FileContext_t, pucCertFilepath )}, eModelParamType_StringCopy,  JSMN_STRING    },
         { cOTA_JSON_FileSignatureKey, OTA_JOB_PARAM_REQUIRED, { OFFSET_OF( OTA_FileContext_t, pxSignature )    }, eModelParamType_SigBase64,   JSMN_STRING    },
         { cOTA_JSON_FileAttributeKey, OTA_JOB_PARAM_OPTIONAL, { OFFSET_OF( OTA_FileContext_t, ulFileAttributes )}, eModelParamType_UInt32,      JSMN_PRIMITIVE },
+        { cOTA_JSON_UpdateDataURLKey, OTA_JOB_PARAM_OPTIONAL, { OTA_UPDATE_DATA_URL_DEST                       }, eModelParamType_StringCopy,  JSMN_STRING    },
+        { cOTA_JSON_DeltaBaseKey,     OTA_JOB_PARAM_OPTIONAL, { OFFSET_OF( OTA_FileContext_t, ulDeltaBaseVersion )}, eModelParamType_UInt32,      JSMN_STRING    },
     };
 
+    /* The perfect hash table of the model's keys, built on first use. */
+    static JSON_DocKeyTable_t xOTA_JobDocKeyTable;
+
     OTA_JobParseErr_t eErr = eOTA_JobParseErr_Unknown;
     OTA_FileContext_t * pxC;
     OTA_FileContext_t * pxFinalFile;
@@ -2275,6 +2759,7 @@ static OTA_FileContext_t * prvParseJobDoc( const char * pcJSON,
 
         if( prvInitDocModel( &xOTA_JobDocModel,
                              xOTA_JobDocModelParamStructure,
+                             &xOTA_JobDocKeyTable,
                              ( uint32_t ) pxC, /*lint !e9078 !e923 Intentionally casting context pointer to a value for prvInitDocModel. */
                              sizeof( OTA_FileContext_t ),
                              OTA_NUM_JOB_PARAMS ) != eDocParseErr_None )
@@ -2473,7 +2958,9 @@ static OTA_FileContext_t * prvProcessOTAJobMsg( const char * pcRawMsg,
 
         if( pxUpdateFile->pucRxBlockBitmap != NULL )
         {
-            if( ( BaseType_t ) ( prvSubscribeToDataStream( pxUpdateFile ) ) == pdTRUE )
+            /* A file downloaded over HTTP doesn't need the MQTT data stream. */
+            if( ( pxUpdateFile->pucUpdateDataURL != NULL ) ||
+                ( ( BaseType_t ) ( prvSubscribeToDataStream( pxUpdateFile ) ) == pdTRUE ) )
             {
                 /* Set all bits in the bitmap to the erased state (we use 1 for erased just like flash memory). */
                 memset( pxUpdateFile->pucRxBlockBitmap, ( int ) OTA_ERASED_BLOCKS_VAL, ulBitmapLen );
@@ -2497,8 +2984,14 @@ static OTA_FileContext_t * prvProcessOTAJobMsg( const char * pcRawMsg,
                 pxUpdateFile->ulBlocksRemaining = ulNumBlocks; /* Initialize our blocks remaining counter. */
                 prvStartRequestTimer( pxUpdateFile );
 
+                /* A delta update patch is applied to the running image as it arrives. */
+                xErr = prvStartDeltaPatch( pxUpdateFile );
+
                 /* Create/Open the OTA file on the file system. */
-                xErr = prvPAL_CreateFileForRx( pxUpdateFile );
+                if( xErr == kOTA_Err_None )
+                {
+                    xErr = prvPAL_CreateFileForRx( pxUpdateFile );
+                }
 
                 if( xErr != kOTA_Err_None )
                 {
@@ -2506,6 +2999,14 @@ static OTA_FileContext_t * prvProcessOTAJobMsg( const char * pcRawMsg,
                     ( void ) prvOTA_Close( pxUpdateFile ); /* Ignore false result since we're setting the pointer to null on the next line. */
                     pxUpdateFile = NULL;
                 }
+
+                #if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 )
+                    else if( pxUpdateFile->pucUpdateDataURL != NULL )
+                    {
+                        /* Start the download now rather than when the request timer expires. */
+                        ( void ) xEventGroupSetBits( xOTA_Agent.xOTA_EventFlags, OTA_EVT_MASK_HTTP_FETCH );
+                    }
+                #endif
             }
             else
             {
@@ -2604,20 +3105,22 @@ static IngestResult_t prvIngestDataBlock( OTA_FileContext_t * C,
                         {
                             if( C->pucFile != NULL )
                             {
-                                int32_t lBytesWritten = prvPAL_WriteBlock( C, ( ulBlockIndex * OTA_FILE_BLOCK_SIZE ), pucPayload, ( uint32_t ) ulBlockSize );
+                                eIngestResult = prvWriteFileData( C, ( ulBlockIndex * OTA_FILE_BLOCK_SIZE ), pucPayload, ( uint32_t ) ulBlockSize );
 
-                                if( lBytesWritten < 0 )
-                                {
-                                    OTA_LOG_L1( "[%s] Error (%d) writing file block\r\n", OTA_METHOD_NAME, lBytesWritten );
-                                    eIngestResult = eIngest_Result_WriteBlockFailed;
-                                }
-                                else
+                                if( eIngestResult == eIngest_Result_Accepted_Continue )
                                 {
                                     C->pucRxBlockBitmap[ ulByte ] &= ~ucBitMask; /* Mark this block as received in our bitmap. */
                                     C->ulBlocksRemaining--;
-                                    eIngestResult = eIngest_Result_Accepted_Continue;
                                     *pxCloseResult = kOTA_Err_None; /* This is a success path. */
                                 }
+                                else if( eIngestResult == eIngest_Result_Deferred_Continue )
+                                {
+                                    *pxCloseResult = kOTA_Err_None; /* The block stays missing so it's requested again. */
+                                }
+                                else
+                                {
+                                    /* The error has been logged. */
+                                }
                             }
                             else
                             {
@@ -2627,45 +3130,7 @@ static IngestResult_t prvIngestDataBlock( OTA_FileContext_t * C,
 
                             if( C->ulBlocksRemaining == 0U )
                             {
-                                OTA_LOG_L1( "[%s] Received final expected block of file.\r\n", OTA_METHOD_NAME );
-                                prvStopRequestTimer( C );         /* Don't request any more since we're done. */
-                                vPortFree( C->pucRxBlockBitmap ); /* Free the bitmap now that we're done with the download. */
-                                C->pucRxBlockBitmap = NULL;
-
-                                if( C->pucFile != NULL )
-                                {
-                                    *pxCloseResult = prvPAL_CloseFile( C );
-
-                                    if( *pxCloseResult == kOTA_Err_None )
-                                    {
-                                        OTA_LOG_L1( "[%s] File receive complete and signature is valid.\r\n", OTA_METHOD_NAME );
-                                        eIngestResult = eIngest_Result_FileComplete;
-                                    }
-                                    else
-                                    {
-                                        uint32_t ulCloseResult = ( uint32_t ) *pxCloseResult;
-                                        OTA_LOG_L1( "[%s] Error (%u:0x%06x) closing OTA file.\r\n",
-                                                    OTA_METHOD_NAME,
-                                                    ulCloseResult >> kOTA_MainErrShiftDownBits,
-                                                    ulCloseResult & ( uint32_t ) kOTA_PAL_ErrMask );
-
-                                        if( ( ulCloseResult & kOTA_Main_ErrMask ) == kOTA_Err_SignatureCheckFailed )
-                                        {
-                                            eIngestResult = eIngest_Result_SigCheckFail;
-                                        }
-                                        else
-                                        {
-                                            eIngestResult = eIngest_Result_FileCloseFail;
-                                        }
-                                    }
-
-                                    C->pucFile = NULL; /* File is now closed so clear the file handle in the context. */
-                                }
-                                else
-                                {
-                                    OTA_LOG_L1( "[%s] Error: File handle is NULL after last block received.\r\n", OTA_METHOD_NAME );
-                                    eIngestResult = eIngest_Result_BadFileHandle;
-                                }
+                                eIngestResult = prvCloseReceivedFile( C, pxCloseResult );
                             }
                             else
                             {
@@ -2704,6 +3169,549 @@ static IngestResult_t prvIngestDataBlock( OTA_FileContext_t * C,
 }
 
 
+/* prvWriteFileData
+ *
+ * Write a piece of the received file at its offset in the file. If the file is a delta update
+ * patch, apply the piece to the running image instead. The patch is applied in order, so a piece
+ * past where it has got to is deferred, to be received again once the pieces before it are in.
+ */
+static IngestResult_t prvWriteFileData( OTA_FileContext_t * C,
+                                        uint32_t ulOffset,
+                                        uint8_t * pucData,
+                                        uint32_t ulLength )
+{
+    DEFINE_OTA_METHOD_NAME( "prvWriteFileData" );
+
+    IngestResult_t eIngestResult = eIngest_Result_Accepted_Continue;
+    int32_t lBytesWritten;
+
+    #if ( otaconfigENABLE_DELTA_UPDATE == 1 )
+        if( C->pxDeltaPatch != NULL )
+        {
+            OTA_DeltaResult_t eDeltaResult = OTA_Delta_Apply( C->pxDeltaPatch, ulOffset, pucData, ulLength );
+
+            if( eDeltaResult == eDelta_OutOfOrder )
+            {
+                OTA_LOG_L1( "[%s] Deferring data at %u until the patch gets there.\r\n", OTA_METHOD_NAME, ulOffset );
+                eIngestResult = eIngest_Result_Deferred_Continue;
+            }
+            else if( eDeltaResult != eDelta_Applied )
+            {
+                OTA_LOG_L1( "[%s] Error (%d) applying delta update patch\r\n", OTA_METHOD_NAME, ( int32_t ) eDeltaResult );
+                eIngestResult = eIngest_Result_DeltaPatchFailed;
+            }
+            else
+            {
+                /* The new image has been written as far as the patch allows. */
+            }
+        }
+    #endif
+
+    if( C->pxDeltaPatch == NULL )
+    {
+        lBytesWritten = prvPAL_WriteBlock( C, ulOffset, pucData, ulLength );
+
+        if( lBytesWritten < 0 )
+        {
+            OTA_LOG_L1( "[%s] Error (%d) writing file block\r\n", OTA_METHOD_NAME, lBytesWritten );
+            eIngestResult = eIngest_Result_WriteBlockFailed;
+        }
+    }
+
+    return eIngestResult;
+}
+
+
+/* prvStartDeltaPatch
+ *
+ * If the job gives a base version for the file, the file is a delta update patch against that
+ * version of the application. Check that it's the version running now and start applying the
+ * patch. The new image is read from and written to the PAL through prvReadBaseImage and
+ * prvWriteNewImage.
+ */
+static OTA_Err_t prvStartDeltaPatch( OTA_FileContext_t * C )
+{
+    DEFINE_OTA_METHOD_NAME( "prvStartDeltaPatch" );
+
+    OTA_Err_t xErr = kOTA_Err_None;
+
+    if( C->ulDeltaBaseVersion != 0U )
+    {
+        #if ( otaconfigENABLE_DELTA_UPDATE == 1 )
+            if( C->ulDeltaBaseVersion != xAppFirmwareVersion.u.ulVersion32 )
+            {
+                OTA_LOG_L1( "[%s] Error: The file is a patch against version 0x%08x, not the running version.\r\n",
+                            OTA_METHOD_NAME,
+                            C->ulDeltaBaseVersion );
+                xErr = kOTA_Err_DeltaBaseMismatch;
+            }
+            else
+            {
+                C->pxDeltaPatch = OTA_Delta_Create( prvReadBaseImage, prvWriteNewImage, C );
+
+                if( C->pxDeltaPatch == NULL )
+                {
+                    xErr = kOTA_Err_OutOfMemory;
+                }
+            }
+        #else
+            OTA_LOG_L1( "[%s] Error: The file is a delta update patch but delta updates are disabled.\r\n", OTA_METHOD_NAME );
+            xErr = kOTA_Err_DeltaUnsupported;
+        #endif
+    }
+
+    return xErr;
+}
+
+
+/* prvFinishDeltaPatch
+ *
+ * Write out the end of the new image once the whole delta update patch has been received. The
+ * file size becomes the size of the new image. Returns false if the patch didn't produce it all.
+ */
+static bool_t prvFinishDeltaPatch( OTA_FileContext_t * C )
+{
+    bool_t xResult = true;
+
+    #if ( otaconfigENABLE_DELTA_UPDATE == 1 )
+        DEFINE_OTA_METHOD_NAME( "prvFinishDeltaPatch" );
+
+        if( C->pxDeltaPatch != NULL )
+        {
+            if( OTA_Delta_Finish( C->pxDeltaPatch, &C->ulFileSize ) != eDelta_Applied )
+            {
+                OTA_LOG_L1( "[%s] Error: The delta update patch did not produce the whole image.\r\n", OTA_METHOD_NAME );
+                xResult = false;
+            }
+            else
+            {
+                OTA_LOG_L1( "[%s] Rebuilt a %u byte image from the running image.\r\n", OTA_METHOD_NAME, C->ulFileSize );
+            }
+        }
+    #else
+        ( void ) C;
+    #endif
+
+    return xResult;
+}
+
+
+#if ( otaconfigENABLE_DELTA_UPDATE == 1 )
+
+/* prvReadBaseImage and prvWriteNewImage
+ *
+ * Give the delta update patch the running image and the file being received, which is where the
+ * new image goes.
+ */
+    static int32_t prvReadBaseImage( void * pvContext,
+                                     uint32_t ulOffset,
+                                     uint8_t * pucData,
+                                     uint32_t ulLength )
+    {
+        OTA_FileContext_t * C = ( OTA_FileContext_t * ) pvContext; /*lint !e9079 pointer to void is OK to cast to the real type. */
+
+        return ( int32_t ) prvPAL_ReadRunningImage( C, ulOffset, pucData, ulLength );
+    }
+
+    static int32_t prvWriteNewImage( void * pvContext,
+                                     uint32_t ulOffset,
+                                     uint8_t * pucData,
+                                     uint32_t ulLength )
+    {
+        OTA_FileContext_t * C = ( OTA_FileContext_t * ) pvContext; /*lint !e9079 pointer to void is OK to cast to the real type. */
+
+        return ( int32_t ) prvPAL_WriteBlock( C, ulOffset, pucData, ulLength );
+    }
+#endif /* if ( otaconfigENABLE_DELTA_UPDATE == 1 ) */
+
+
+/* prvCloseReceivedFile
+ *
+ * The last block of the file has been written. Close the file, which also checks its signature, and
+ * return the result of the transfer. For a delta update patch, the rest of the new image is written
+ * first and the file size becomes the size of the new image, so it's the new image that's checked.
+ */
+static IngestResult_t prvCloseReceivedFile( OTA_FileContext_t * C,
+                                            OTA_Err_t * pxCloseResult )
+{
+    DEFINE_OTA_METHOD_NAME( "prvCloseReceivedFile" );
+
+    IngestResult_t eIngestResult;
+
+    OTA_LOG_L1( "[%s] Received final expected block of file.\r\n", OTA_METHOD_NAME );
+    prvStopRequestTimer( C );         /* Don't request any more since we're done. */
+    vPortFree( C->pucRxBlockBitmap ); /* Free the bitmap now that we're done with the download. */
+    C->pucRxBlockBitmap = NULL;
+
+    if( C->pucFile != NULL )
+    {
+        if( prvFinishDeltaPatch( C ) == false )
+        {
+            *pxCloseResult = kOTA_Err_GenericIngestError;
+            eIngestResult = eIngest_Result_DeltaPatchFailed; /* The file is aborted when the context is closed. */
+        }
+        else
+        {
+            *pxCloseResult = prvPAL_CloseFile( C );
+
+            if( *pxCloseResult == kOTA_Err_None )
+            {
+                OTA_LOG_L1( "[%s] File receive complete and signature is valid.\r\n", OTA_METHOD_NAME );
+                eIngestResult = eIngest_Result_FileComplete;
+            }
+            else
+            {
+                uint32_t ulCloseResult = ( uint32_t ) *pxCloseResult;
+                OTA_LOG_L1( "[%s] Error (%u:0x%06x) closing OTA file.\r\n",
+                            OTA_METHOD_NAME,
+                            ulCloseResult >> kOTA_MainErrShiftDownBits,
+                            ulCloseResult & ( uint32_t ) kOTA_PAL_ErrMask );
+
+                if( ( ulCloseResult & kOTA_Main_ErrMask ) == kOTA_Err_SignatureCheckFailed )
+                {
+                    eIngestResult = eIngest_Result_SigCheckFail;
+                }
+                else
+                {
+                    eIngestResult = eIngest_Result_FileCloseFail;
+                }
+            }
+
+            C->pucFile = NULL; /* File is now closed so clear the file handle in the context. */
+        }
+    }
+    else
+    {
+        OTA_LOG_L1( "[%s] Error: File handle is NULL after last block received.\r\n", OTA_METHOD_NAME );
+        eIngestResult = eIngest_Result_BadFileHandle;
+    }
+
+    return eIngestResult;
+}
+
+
+#if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 )
+
+/* prvNextHTTPRange
+ *
+ * Find the next run of missing blocks at or after the HTTP request cursor, up to
+ * otaconfigHTTP_BLOCKS_PER_REQUEST blocks long, and move the cursor past it. Ranges
+ * always start on a block boundary so each block is written by a single response.
+ */
+    static bool_t prvNextHTTPRange( OTA_FileContext_t * C,
+                                    uint32_t * pulOffset,
+                                    uint32_t * pulLength )
+    {
+        uint32_t ulNumBlocks = ( C->ulFileSize + ( OTA_FILE_BLOCK_SIZE - 1U ) ) >> otaconfigLOG2_FILE_BLOCK_SIZE;
+        uint32_t ulBlock = C->ulHTTPNextBlock;
+        uint32_t ulCount = 0U;
+        uint32_t ulEnd;
+        bool_t xFound = false;
+
+        /* Skip the blocks we already have. A set bit is a block that is still missing. */
+        while( ( ulBlock < ulNumBlocks ) &&
+               ( ( C->pucRxBlockBitmap[ ulBlock >> LOG2_BITS_PER_BYTE ] & ( 1U << ( ulBlock % BITS_PER_BYTE ) ) ) == 0U ) )
+        {
+            ulBlock++;
+        }
+
+        while( ( ( ulBlock + ulCount ) < ulNumBlocks ) && ( ulCount < otaconfigHTTP_BLOCKS_PER_REQUEST ) &&
+               ( ( C->pucRxBlockBitmap[ ( ulBlock + ulCount ) >> LOG2_BITS_PER_BYTE ] & ( 1U << ( ( ulBlock + ulCount ) % BITS_PER_BYTE ) ) ) != 0U ) )
+        {
+            ulCount++;
+        }
+
+        C->ulHTTPNextBlock = ulBlock + ulCount;
+
+        if( ulCount > 0U )
+        {
+            ulEnd = ( ulBlock + ulCount ) * OTA_FILE_BLOCK_SIZE;
+
+            if( ulEnd > C->ulFileSize )
+            {
+                ulEnd = C->ulFileSize; /* The last block may be short. */
+            }
+
+            *pulOffset = ulBlock * OTA_FILE_BLOCK_SIZE;
+            *pulLength = ulEnd - *pulOffset;
+            xFound = true;
+        }
+
+        return xFound;
+    }
+
+
+/* prvCloseHTTPConnection
+ *
+ * Close the connection to the HTTP server, if there is one, and free the block buffer
+ * that goes with it.
+ */
+    static void prvCloseHTTPConnection( OTA_FileContext_t * C )
+    {
+        if( C->pxHTTPConnection != NULL )
+        {
+            OTA_HTTP_Disconnect( C->pxHTTPConnection );
+            C->pxHTTPConnection = NULL;
+        }
+
+        if( C->pucHTTPBlock != NULL )
+        {
+            vPortFree( C->pucHTTPBlock );
+            C->pucHTTPBlock = NULL;
+        }
+    }
+
+
+/* prvWriteHTTPBody
+ *
+ * Write a piece of an HTTP range response to the file. Pieces start and end anywhere, but
+ * the PAL is only ever given whole blocks, as from the data stream, since some PALs pad a
+ * short write out to the flash's programming unit. A block that arrives whole in one piece
+ * is written straight from it. Otherwise it is assembled in the block buffer first. Ranges
+ * start on a block boundary so each block is assembled from a single response. Each block
+ * written is marked as received just like a block from the data stream.
+ */
+    static BaseType_t prvWriteHTTPBody( void * pvContext,
+                                        uint32_t ulOffset,
+                                        const uint8_t * pucData,
+                                        uint32_t ulLength )
+    {
+        DEFINE_OTA_METHOD_NAME( "prvWriteHTTPBody" );
+
+        HTTP_BodyWriter_t * pxWriter = ( HTTP_BodyWriter_t * ) pvContext; /*lint !e9079 pointer to void is OK to cast to the real type. */
+        OTA_FileContext_t * C = pxWriter->pxC;
+        uint32_t ulBlock, ulBlockStart, ulBlockLen, ulInBlock, ulCount;
+        uint8_t * pucBlockData;
+        IngestResult_t eResult;
+        BaseType_t xStatus = pdPASS;
+
+        if( C->pucFile == NULL )
+        {
+            OTA_LOG_L1( "[%s] Error: Unable to write block, file handle is NULL.\r\n", OTA_METHOD_NAME );
+            pxWriter->eResult = eIngest_Result_BadFileHandle;
+            xStatus = pdFAIL;
+        }
+        else if( ( ulOffset >= C->ulFileSize ) || ( ulLength > ( C->ulFileSize - ulOffset ) ) )
+        {
+            OTA_LOG_L1( "[%s] Error: Response data at %u is outside the file.\r\n", OTA_METHOD_NAME, ulOffset );
+            xStatus = pdFAIL; /* Drop the connection. The blocks are asked for again on the next one. */
+        }
+        else
+        {
+            /* Write the blocks the piece completes below. */
+        }
+
+        while( ( xStatus == pdPASS ) && ( ulLength > 0U ) )
+        {
+            ulBlock = ulOffset >> otaconfigLOG2_FILE_BLOCK_SIZE;
+            ulBlockStart = ulBlock * OTA_FILE_BLOCK_SIZE;
+            ulBlockLen = C->ulFileSize - ulBlockStart;
+
+            if( ulBlockLen > OTA_FILE_BLOCK_SIZE )
+            {
+                ulBlockLen = OTA_FILE_BLOCK_SIZE; /* Only the last block may be short. */
+            }
+
+            ulInBlock = ulOffset - ulBlockStart;
+            ulCount = ulBlockLen - ulInBlock;
+
+            if( ulCount > ulLength )
+            {
+                ulCount = ulLength;
+            }
+
+            if( ( ulInBlock == 0U ) && ( ulCount == ulBlockLen ) )
+            {
+                pucBlockData = ( uint8_t * ) pucData; /*lint !e9005 The data isn't modified. */
+            }
+            else
+            {
+                memcpy( &C->pucHTTPBlock[ ulInBlock ], pucData, ulCount );
+                pucBlockData = C->pucHTTPBlock;
+            }
+
+            ulOffset += ulCount;
+            pucData += ulCount;
+            ulLength -= ulCount;
+
+            if( ( ulInBlock + ulCount ) == ulBlockLen )
+            {
+                eResult = prvWriteFileData( C, ulBlockStart, pucBlockData, ulBlockLen );
+
+                if( eResult == eIngest_Result_Deferred_Continue )
+                {
+                    xStatus = pdFAIL; /* Stop reading. The blocks are asked for again on the next connection. */
+                }
+                else if( eResult != eIngest_Result_Accepted_Continue )
+                {
+                    pxWriter->eResult = eResult;
+                    xStatus = pdFAIL;
+                }
+                else
+                {
+                    uint8_t ucBitMask = 1U << ( ulBlock % BITS_PER_BYTE ); /*lint !e9031 The composite expression will never be greater than BITS_PER_BYTE(8). */
+                    uint32_t ulByte = ulBlock >> LOG2_BITS_PER_BYTE;
+
+                    if( ( C->pucRxBlockBitmap[ ulByte ] & ucBitMask ) != 0U )
+                    {
+                        C->pucRxBlockBitmap[ ulByte ] &= ~ucBitMask; /* Mark this block as received in our bitmap. */
+                        C->ulBlocksRemaining--;
+                        prvUpdateJobStatus( C, eJobStatus_InProgress, ( int32_t ) eJobReason_Receiving, ( int32_t ) NULL );
+                    }
+                }
+            }
+        }
+
+        return xStatus;
+    }
+
+
+/* prvFetchFileBlocksHTTP
+ *
+ * Keep the HTTP connection's pipeline full of range requests for the missing blocks and
+ * read the oldest response into the file. Connect first if there is no connection. After
+ * progress, the fetch event is set again so the next response is read on the next pass
+ * of the agent's event loop, leaving room for other events in between. After a failure,
+ * the connection is dropped and the request timer retries.
+ */
+    static IngestResult_t prvFetchFileBlocksHTTP( OTA_FileContext_t * C,
+                                                  OTA_Err_t * pxCloseResult )
+    {
+        DEFINE_OTA_METHOD_NAME( "prvFetchFileBlocksHTTP" );
+
+        HTTP_BodyWriter_t xWriter;
+        IngestResult_t eIngestResult = eIngest_Result_Accepted_Continue;
+        BaseType_t xStatus = pdPASS;
+        uint32_t ulOffset = 0U;
+        uint32_t ulLength = 0U;
+
+        *pxCloseResult = kOTA_Err_GenericIngestError; /* Default to a generic ingest function error until we prove success. */
+        xWriter.pxC = C;
+        xWriter.eResult = eIngest_Result_Accepted_Continue;
+
+        if( C->pxHTTPConnection == NULL )
+        {
+            /* A new connection starts asking from the first missing block. */
+            C->ulHTTPNextBlock = 0U;
+            C->pucHTTPBlock = ( uint8_t * ) pvPortMalloc( OTA_FILE_BLOCK_SIZE ); /*lint !e9079 FreeRTOS malloc port returns void*. */
+
+            if( C->pucHTTPBlock == NULL )
+            {
+                OTA_LOG_L1( "[%s] Error: Failed to allocate the HTTP block buffer.\r\n", OTA_METHOD_NAME );
+                xStatus = pdFAIL;
+            }
+            else
+            {
+                C->pxHTTPConnection = OTA_HTTP_Connect( ( const char * ) C->pucUpdateDataURL );
+
+                if( C->pxHTTPConnection == NULL )
+                {
+                    OTA_LOG_L1( "[%s] Failed to connect to %s\r\n", OTA_METHOD_NAME, ( const char * ) C->pucUpdateDataURL );
+                    prvCloseHTTPConnection( C );
+                    xStatus = pdFAIL;
+                }
+            }
+        }
+
+        while( ( xStatus == pdPASS ) &&
+               ( OTA_HTTP_IsOpen( C->pxHTTPConnection ) == pdTRUE ) &&
+               ( OTA_HTTP_RequestsInFlight( C->pxHTTPConnection ) < otaconfigHTTP_PIPELINE_DEPTH ) &&
+               ( prvNextHTTPRange( C, &ulOffset, &ulLength ) == true ) )
+        {
+            /* A request that can't be sent closes the connection to new requests. Blocks
+             * skipped by the cursor are asked for again on the next connection. */
+            ( void ) OTA_HTTP_RequestRange( C->pxHTTPConnection, ulOffset, ulLength );
+        }
+
+        if( xStatus == pdPASS )
+        {
+            if( OTA_HTTP_RequestsInFlight( C->pxHTTPConnection ) > 0U )
+            {
+                xStatus = OTA_HTTP_ReadResponse( C->pxHTTPConnection, prvWriteHTTPBody, &xWriter );
+
+                if( xStatus == pdPASS )
+                {
+                    /* Reset the momentum counter and the request timer since the server answered. */
+                    C->ulRequestMomentum = 0U;
+                    prvStartRequestTimer( C );
+                    OTA_LOG_L1( "[%s] Remaining: %u\r\n", OTA_METHOD_NAME, C->ulBlocksRemaining );
+                }
+            }
+            else
+            {
+                /* Nothing could be asked for on this connection. */
+                xStatus = pdFAIL;
+            }
+        }
+
+        if( xWriter.eResult != eIngest_Result_Accepted_Continue )
+        {
+            eIngestResult = xWriter.eResult;
+        }
+        else if( C->ulBlocksRemaining == 0U )
+        {
+            prvCloseHTTPConnection( C );
+            eIngestResult = prvCloseReceivedFile( C, pxCloseResult );
+        }
+        else
+        {
+            *pxCloseResult = kOTA_Err_None;
+
+            if( ( xStatus != pdPASS ) || ( OTA_HTTP_IsOpen( C->pxHTTPConnection ) == pdFALSE ) )
+            {
+                prvCloseHTTPConnection( C );
+            }
+
+            if( xStatus == pdPASS )
+            {
+                /* Carry on, reconnecting right away if the server closed the connection. */
+                ( void ) xEventGroupSetBits( xOTA_Agent.xOTA_EventFlags, OTA_EVT_MASK_HTTP_FETCH );
+            }
+            else
+            {
+                OTA_LOG_L1( "[%s] HTTP transfer failed. Retrying when the request timer expires.\r\n", OTA_METHOD_NAME );
+            }
+        }
+
+        return eIngestResult;
+    }
+
+
+/* prvRetryHTTPTransfer
+ *
+ * The request timer expired while downloading over HTTP. If there's no connection because
+ * the last attempt failed, try again. Like the stream requests, each retry increases the
+ * momentum until the server answers and too much momentum aborts the OTA. A stalled
+ * connection is caught by the socket timeouts rather than here.
+ */
+    static OTA_Err_t prvRetryHTTPTransfer( OTA_FileContext_t * C )
+    {
+        OTA_Err_t xErr = kOTA_Err_None;
+
+        if( C->ulRequestMomentum < OTA_MAX_STREAM_REQUEST_MOMENTUM )
+        {
+            C->ulRequestMomentum++;
+
+            if( C->pxHTTPConnection == NULL )
+            {
+                ( void ) xEventGroupSetBits( xOTA_Agent.xOTA_EventFlags, OTA_EVT_MASK_HTTP_FETCH );
+            }
+
+            /* Restart the request timer to retry if we don't complete the update. */
+            prvStartRequestTimer( C );
+        }
+        else
+        {
+            /* Too many retries without a response. Abort. Store attempt count in low bits. */
+            xErr = ( uint32_t ) kOTA_Err_MomentumAbort | ( OTA_MAX_STREAM_REQUEST_MOMENTUM & ( uint32_t ) kOTA_PAL_ErrMask );
+        }
+
+        return xErr;
+    }
+
+#endif /* if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 ) */
+
+
 /* Subscribe to the OTA job notification topics. */
 
 static bool_t prvSubscribeToJobNotificationTopics( void )
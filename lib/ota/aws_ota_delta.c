@@ -0,0 +1,374 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_ota_delta.c
+ * @brief Streaming application of delta update patches for AWS IoT Over-the-Air updates.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* OTA includes. */
+#include "aws_ota_agent.h"
+#include "aws_ota_agent_config.h"
+#include "aws_ota_agent_config_defaults.h"
+#include "aws_ota_delta.h"
+
+/* General constants. */
+#define OTA_DELTA_HEADER_SIZE        12U /* Magic, base image size and new image size. */
+#define OTA_DELTA_COPY_CMD_SIZE      9U  /* Op, length and base offset. */
+#define OTA_DELTA_INSERT_CMD_SIZE    5U  /* Op and length. */
+#define OTA_DELTA_OP_COPY            0U
+#define OTA_DELTA_OP_INSERT          1U
+
+/* Where the patch has got to. */
+
+typedef enum
+{
+    eDeltaState_Header = 0, /* Receiving the header. */
+    eDeltaState_Command,    /* Receiving a command. */
+    eDeltaState_InsertData, /* Receiving the bytes of an INSERT. */
+    eDeltaState_Done        /* The whole new image has been produced. */
+} OTA_DeltaState_t;
+
+/* The state of a patch being applied. */
+
+struct OTA_DeltaPatch
+{
+    OTA_DeltaRead_t xRead;                          /* Reads the base image. */
+    OTA_DeltaWrite_t xWrite;                        /* Writes the new image. */
+    void * pvContext;                               /* Passed to xRead and xWrite. */
+    OTA_DeltaState_t eState;                        /* What the next patch bytes are. */
+    uint32_t ulPatchOffset;                         /* The number of patch bytes used so far. */
+    uint32_t ulBaseSize;                            /* The size of the base image. */
+    uint32_t ulImageSize;                           /* The size of the new image. */
+    uint32_t ulImageOffset;                         /* The number of new image bytes produced so far. */
+    uint32_t ulRunLength;                           /* The bytes left in the current command. */
+    uint32_t ulRunBase;                             /* The base image offset of the current COPY. */
+    uint32_t ulFieldLength;                         /* The bytes of the header or command received so far. */
+    uint8_t ucField[ OTA_DELTA_HEADER_SIZE ];       /* The header or command being received. */
+    uint32_t ulWindowUsed;                          /* The new image bytes in ucWindow not yet written. */
+    uint8_t ucWindow[ otaconfigDELTA_WINDOW_SIZE ]; /* The next piece of the new image. */
+};
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvGetUInt32( const uint8_t * pucBytes );
+
+/*-----------------------------------------------------------*/
+
+static OTA_DeltaResult_t prvFlushWindow( OTA_DeltaPatch_t * pxPatch );
+
+/*-----------------------------------------------------------*/
+
+static OTA_DeltaResult_t prvProduce( OTA_DeltaPatch_t * pxPatch,
+                                     const uint8_t * pucData,
+                                     uint32_t ulLength );
+
+/*-----------------------------------------------------------*/
+
+static OTA_DeltaResult_t prvStartCommand( OTA_DeltaPatch_t * pxPatch );
+
+/*-----------------------------------------------------------*/
+
+OTA_DeltaPatch_t * OTA_Delta_Create( OTA_DeltaRead_t xRead,
+                                     OTA_DeltaWrite_t xWrite,
+                                     void * pvContext )
+{
+    OTA_DeltaPatch_t * pxPatch = pvPortMalloc( sizeof( OTA_DeltaPatch_t ) );
+
+    if( pxPatch != NULL )
+    {
+        memset( pxPatch, 0, sizeof( OTA_DeltaPatch_t ) );
+        pxPatch->xRead = xRead;
+        pxPatch->xWrite = xWrite;
+        pxPatch->pvContext = pvContext;
+        pxPatch->eState = eDeltaState_Header;
+    }
+
+    return pxPatch;
+}
+/*-----------------------------------------------------------*/
+
+OTA_DeltaResult_t OTA_Delta_Apply( OTA_DeltaPatch_t * pxPatch,
+                                   uint32_t ulPatchOffset,
+                                   const uint8_t * pucData,
+                                   uint32_t ulLength )
+{
+    DEFINE_OTA_METHOD_NAME( "OTA_Delta_Apply" );
+
+    OTA_DeltaResult_t eResult = eDelta_Applied;
+    uint32_t ulFieldSize;
+    uint32_t ulCount;
+    uint8_t ucOp;
+
+    if( ulPatchOffset > pxPatch->ulPatchOffset )
+    {
+        eResult = eDelta_OutOfOrder;
+    }
+    else
+    {
+        /* Skip what has already been used, as when a block is received again. */
+        ulCount = pxPatch->ulPatchOffset - ulPatchOffset;
+
+        if( ulCount > ulLength )
+        {
+            ulCount = ulLength;
+        }
+
+        pucData += ulCount;
+        ulLength -= ulCount;
+    }
+
+    while( ( eResult == eDelta_Applied ) && ( ulLength > 0U ) )
+    {
+        switch( pxPatch->eState )
+        {
+            case eDeltaState_Header:
+            case eDeltaState_Command:
+
+                /* The size of a command depends on its op, which is its first byte. */
+                if( pxPatch->eState == eDeltaState_Header )
+                {
+                    ulFieldSize = OTA_DELTA_HEADER_SIZE;
+                }
+                else
+                {
+                    ucOp = ( pxPatch->ulFieldLength == 0U ) ? pucData[ 0 ] : pxPatch->ucField[ 0 ];
+                    ulFieldSize = ( ucOp == OTA_DELTA_OP_INSERT ) ? OTA_DELTA_INSERT_CMD_SIZE : OTA_DELTA_COPY_CMD_SIZE;
+                }
+
+                ulCount = ulFieldSize - pxPatch->ulFieldLength;
+
+                if( ulCount > ulLength )
+                {
+                    ulCount = ulLength;
+                }
+
+                memcpy( &pxPatch->ucField[ pxPatch->ulFieldLength ], pucData, ulCount );
+                pxPatch->ulFieldLength += ulCount;
+
+                if( pxPatch->ulFieldLength == ulFieldSize )
+                {
+                    pxPatch->ulFieldLength = 0U;
+
+                    if( pxPatch->eState == eDeltaState_Header )
+                    {
+                        pxPatch->ulBaseSize = prvGetUInt32( &pxPatch->ucField[ 4 ] );
+                        pxPatch->ulImageSize = prvGetUInt32( &pxPatch->ucField[ 8 ] );
+
+                        if( ( prvGetUInt32( pxPatch->ucField ) != OTA_DELTA_MAGIC ) || ( pxPatch->ulImageSize == 0U ) )
+                        {
+                            OTA_LOG_L1( "[%s] Not a delta update patch.\r\n", OTA_METHOD_NAME );
+                            eResult = eDelta_BadPatch;
+                        }
+                        else
+                        {
+                            OTA_LOG_L1( "[%s] Patching a %u byte image into a %u byte image.\r\n", OTA_METHOD_NAME,
+                                        pxPatch->ulBaseSize, pxPatch->ulImageSize );
+                            pxPatch->eState = eDeltaState_Command;
+                        }
+                    }
+                    else
+                    {
+                        eResult = prvStartCommand( pxPatch );
+                    }
+                }
+
+                break;
+
+            case eDeltaState_InsertData:
+                ulCount = sizeof( pxPatch->ucWindow ) - pxPatch->ulWindowUsed;
+
+                if( ulCount > pxPatch->ulRunLength )
+                {
+                    ulCount = pxPatch->ulRunLength;
+                }
+
+                if( ulCount > ulLength )
+                {
+                    ulCount = ulLength;
+                }
+
+                eResult = prvProduce( pxPatch, pucData, ulCount );
+                break;
+
+            case eDeltaState_Done:
+            default:
+                OTA_LOG_L1( "[%s] Patch continues past the end of the image.\r\n", OTA_METHOD_NAME );
+                eResult = eDelta_BadPatch;
+                ulCount = 0U;
+                break;
+        }
+
+        if( eResult == eDelta_Applied )
+        {
+            pxPatch->ulPatchOffset += ulCount;
+            pucData += ulCount;
+            ulLength -= ulCount;
+        }
+    }
+
+    return eResult;
+}
+/*-----------------------------------------------------------*/
+
+OTA_DeltaResult_t OTA_Delta_Finish( OTA_DeltaPatch_t * pxPatch,
+                                    uint32_t * pulImageSize )
+{
+    OTA_DeltaResult_t eResult = eDelta_Incomplete;
+
+    if( pxPatch->eState == eDeltaState_Done )
+    {
+        eResult = prvFlushWindow( pxPatch );
+        *pulImageSize = pxPatch->ulImageSize;
+    }
+
+    return eResult;
+}
+/*-----------------------------------------------------------*/
+
+void OTA_Delta_Delete( OTA_DeltaPatch_t * pxPatch )
+{
+    vPortFree( pxPatch );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvGetUInt32( const uint8_t * pucBytes )
+{
+    return ( uint32_t ) pucBytes[ 0 ] |
+           ( ( uint32_t ) pucBytes[ 1 ] << 8 ) |
+           ( ( uint32_t ) pucBytes[ 2 ] << 16 ) |
+           ( ( uint32_t ) pucBytes[ 3 ] << 24 );
+}
+/*-----------------------------------------------------------*/
+
+static OTA_DeltaResult_t prvFlushWindow( OTA_DeltaPatch_t * pxPatch )
+{
+    OTA_DeltaResult_t eResult = eDelta_Applied;
+    uint32_t ulOffset = pxPatch->ulImageOffset - pxPatch->ulWindowUsed;
+
+    if( pxPatch->ulWindowUsed > 0U )
+    {
+        if( pxPatch->xWrite( pxPatch->pvContext, ulOffset, pxPatch->ucWindow, pxPatch->ulWindowUsed ) < 0 )
+        {
+            eResult = eDelta_WriteFailed;
+        }
+
+        pxPatch->ulWindowUsed = 0U;
+    }
+
+    return eResult;
+}
+/*-----------------------------------------------------------*/
+
+/* Add ulLength bytes to the new image. With pucData NULL, the bytes have
+ * already been read into the window. Write the window out when it's full. */
+static OTA_DeltaResult_t prvProduce( OTA_DeltaPatch_t * pxPatch,
+                                     const uint8_t * pucData,
+                                     uint32_t ulLength )
+{
+    OTA_DeltaResult_t eResult = eDelta_Applied;
+
+    if( pucData != NULL )
+    {
+        memcpy( &pxPatch->ucWindow[ pxPatch->ulWindowUsed ], pucData, ulLength );
+    }
+
+    pxPatch->ulWindowUsed += ulLength;
+    pxPatch->ulImageOffset += ulLength;
+    pxPatch->ulRunBase += ulLength;
+    pxPatch->ulRunLength -= ulLength;
+
+    if( pxPatch->ulWindowUsed == sizeof( pxPatch->ucWindow ) )
+    {
+        eResult = prvFlushWindow( pxPatch );
+    }
+
+    if( pxPatch->ulRunLength == 0U )
+    {
+        pxPatch->eState = ( pxPatch->ulImageOffset == pxPatch->ulImageSize ) ? eDeltaState_Done : eDeltaState_Command;
+    }
+
+    return eResult;
+}
+/*-----------------------------------------------------------*/
+
+/* Check a command that has just been received and start it. A COPY needs no
+ * more patch data so it's carried out right away. */
+static OTA_DeltaResult_t prvStartCommand( OTA_DeltaPatch_t * pxPatch )
+{
+    DEFINE_OTA_METHOD_NAME( "prvStartCommand" );
+
+    OTA_DeltaResult_t eResult = eDelta_Applied;
+    uint8_t ucOp = pxPatch->ucField[ 0 ];
+    uint32_t ulCount;
+
+    pxPatch->ulRunLength = prvGetUInt32( &pxPatch->ucField[ 1 ] );
+    pxPatch->ulRunBase = ( ucOp == OTA_DELTA_OP_INSERT ) ? 0U : prvGetUInt32( &pxPatch->ucField[ 5 ] );
+
+    if( ( ucOp > OTA_DELTA_OP_INSERT ) ||
+        ( pxPatch->ulRunLength == 0U ) ||
+        ( pxPatch->ulRunLength > ( pxPatch->ulImageSize - pxPatch->ulImageOffset ) ) ||
+        ( ( ucOp != OTA_DELTA_OP_INSERT ) &&
+          ( ( pxPatch->ulRunBase > pxPatch->ulBaseSize ) ||
+            ( pxPatch->ulRunLength > ( pxPatch->ulBaseSize - pxPatch->ulRunBase ) ) ) ) )
+    {
+        OTA_LOG_L1( "[%s] Bad command %u at patch offset %u.\r\n", OTA_METHOD_NAME, ucOp, pxPatch->ulPatchOffset );
+        eResult = eDelta_BadPatch;
+    }
+    else if( ucOp == OTA_DELTA_OP_COPY )
+    {
+        while( ( eResult == eDelta_Applied ) && ( pxPatch->ulRunLength > 0U ) )
+        {
+            ulCount = sizeof( pxPatch->ucWindow ) - pxPatch->ulWindowUsed;
+
+            if( ulCount > pxPatch->ulRunLength )
+            {
+                ulCount = pxPatch->ulRunLength;
+            }
+
+            if( pxPatch->xRead( pxPatch->pvContext, pxPatch->ulRunBase,
+                                &pxPatch->ucWindow[ pxPatch->ulWindowUsed ], ulCount ) != ( int32_t ) ulCount )
+            {
+                eResult = eDelta_ReadFailed;
+            }
+            else
+            {
+                eResult = prvProduce( pxPatch, NULL, ulCount );
+            }
+        }
+    }
+    else
+    {
+        pxPatch->eState = eDeltaState_InsertData;
+    }
+
+    return eResult;
+}
@@ -0,0 +1,744 @@
+/*
+ * Amazon FreeRTOS OTA Agent V1.0.0
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_ota_http.c
+ * @brief HTTPS range requests for downloading AWS IoT Over-the-Air update files.
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <stdio.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* OTA includes. */
+#include "aws_ota_agent.h"
+#include "aws_ota_agent_config.h"
+#include "aws_ota_agent_config_defaults.h"
+#include "aws_ota_http.h"
+
+/* Secure sockets include. */
+#include "aws_secure_sockets.h"
+
+/* General constants. */
+#define OTA_HTTP_SCHEME               "https://"
+#define OTA_HTTP_DEFAULT_PORT         443U
+#define OTA_HTTP_RANGE_FIELD_MAX      48U  /* Room for the range field and the end of the request. */
+#define OTA_HTTP_STATUS_PARTIAL       206U /* The status of a successful range response. */
+
+/*lint -e830 -e9003 Keep these in one location for easy discovery should they change in the future. */
+static const char cOTA_HTTP_RequestTemplate[] = "GET %s HTTP/1.1\r\nHost: %s\r\nRange: ";
+static const char cOTA_HTTP_RangeTemplate[] = "bytes=%u-%u\r\n\r\n";
+static const char cOTA_HTTP_Version[] = "HTTP/1.";
+static const char cOTA_HTTP_ContentRangeField[] = "content-range";
+static const char cOTA_HTTP_ContentLengthField[] = "content-length";
+static const char cOTA_HTTP_ConnectionField[] = "connection";
+static const char cOTA_HTTP_TransferEncodingField[] = "transfer-encoding";
+static const char cOTA_HTTP_RangeUnit[] = "bytes ";
+static const char cOTA_HTTP_Close[] = "close";
+
+/* An HTTPS connection and the range requests in flight on it. */
+
+struct OTA_HTTP_Connection
+{
+    Socket_t xSocket;                                       /* The TLS socket connected to the server. */
+    BaseType_t xOpen;                                       /* pdFALSE once the server has said it will close the connection. */
+    char * pcRequest;                                       /* The request up to the range field, with room for the range after it. */
+    uint32_t ulRequestPrefixLen;                            /* The length of the request up to the range field. */
+    uint32_t ulRangeOffset[ otaconfigHTTP_PIPELINE_DEPTH ]; /* The file offset of each range in flight. */
+    uint32_t ulRangeLength[ otaconfigHTTP_PIPELINE_DEPTH ]; /* The length of each range in flight. */
+    uint32_t ulRangeHead;                                   /* The index of the oldest range in flight. */
+    uint32_t ulRangesInFlight;                              /* The number of requests waiting for a response. */
+    uint32_t ulRxStart;                                     /* The index of the first unread byte in ucRxBuffer. */
+    uint32_t ulRxEnd;                                       /* The index after the last received byte in ucRxBuffer. */
+    uint8_t ucRxBuffer[ otaconfigHTTP_RX_BUFFER_SIZE ];     /* Received bytes not yet parsed or passed on. */
+};
+
+/* Split an https:// URL into its host, port and path. */
+
+static BaseType_t prvParseURL( const char * pcURL,
+                               char * pcHost,
+                               uint16_t * pusPort,
+                               const char ** ppcPath );
+
+/* Check if the host name is a dotted decimal IP address. */
+
+static BaseType_t prvIsIPAddress( const char * pcHost );
+
+/* Open a TLS socket connected to the server. */
+
+static Socket_t prvOpenSocket( const char * pcHost,
+                               uint16_t usPort );
+
+/* Shut down and close a socket. */
+
+static void prvCloseSocket( Socket_t xSocket );
+
+/* Send all of a buffer on the socket. */
+
+static BaseType_t prvSendAll( Socket_t xSocket,
+                              const char * pcData,
+                              uint32_t ulLength );
+
+/* Receive more bytes at the end of the receive buffer, making room first if needed. */
+
+static BaseType_t prvReceiveMore( OTA_HTTP_Connection_t * pxConnection );
+
+/* Parse an unsigned decimal number, advancing the string pointer past it. */
+
+static BaseType_t prvParseNumber( const char ** ppcText,
+                                  const char * pcEnd,
+                                  uint32_t * pulValue );
+
+/* Compare a header field name with a lower case name, ignoring case. */
+
+static BaseType_t prvIsFieldName( const char * pcName,
+                                  uint32_t ulNameLen,
+                                  const char * pcLowerName );
+
+/* Parse the status line and the fields of a response header. */
+
+static BaseType_t prvParseResponseHeader( const char * pcHeader,
+                                          uint32_t ulHeaderLen,
+                                          OTA_HTTP_Response_t * pxResponse );
+
+/* Unit tests replace the socket calls to play the part of the server. */
+
+#ifdef AMAZON_FREERTOS_ENABLE_UNIT_TESTS
+    #include "aws_ota_http_test_access_declare.h"
+    static OTA_HTTP_SocketIO_t xOTA_HTTP_SocketIO = { prvOpenSocket, SOCKETS_Send, SOCKETS_Recv, prvCloseSocket };
+    #define OTA_HTTP_OPEN_SOCKET     xOTA_HTTP_SocketIO.pxOpen
+    #define OTA_HTTP_SEND            xOTA_HTTP_SocketIO.pxSend
+    #define OTA_HTTP_RECV            xOTA_HTTP_SocketIO.pxRecv
+    #define OTA_HTTP_CLOSE_SOCKET    xOTA_HTTP_SocketIO.pxClose
+#else
+    #define OTA_HTTP_OPEN_SOCKET     prvOpenSocket
+    #define OTA_HTTP_SEND            SOCKETS_Send
+    #define OTA_HTTP_RECV            SOCKETS_Recv
+    #define OTA_HTTP_CLOSE_SOCKET    prvCloseSocket
+#endif
+
+/*-----------------------------------------------------------*/
+
+OTA_HTTP_Connection_t * OTA_HTTP_Connect( const char * pcURL )
+{
+    DEFINE_OTA_METHOD_NAME( "OTA_HTTP_Connect" );
+
+    OTA_HTTP_Connection_t * pxConnection = NULL;
+    char cHost[ securesocketsMAX_DNS_NAME_LENGTH + 1 ];
+    const char * pcPath = NULL;
+    uint16_t usPort = 0U;
+    uint32_t ulPrefixLen;
+
+    if( prvParseURL( pcURL, cHost, &usPort, &pcPath ) == pdFAIL )
+    {
+        OTA_LOG_L1( "[%s] Not a valid https:// URL.\r\n", OTA_METHOD_NAME );
+    }
+    else
+    {
+        /* The request text is built once. Each range request only rewrites the
+         * range field at its end. */
+        ulPrefixLen = ( uint32_t ) ( CONST_STRLEN( cOTA_HTTP_RequestTemplate ) - 4U + strlen( pcPath ) + strlen( cHost ) );
+        pxConnection = pvPortMalloc( sizeof( OTA_HTTP_Connection_t ) + ulPrefixLen + OTA_HTTP_RANGE_FIELD_MAX );
+
+        if( pxConnection == NULL )
+        {
+            OTA_LOG_L1( "[%s] Out of memory.\r\n", OTA_METHOD_NAME );
+        }
+        else
+        {
+            memset( pxConnection, 0, sizeof( OTA_HTTP_Connection_t ) );
+            pxConnection->pcRequest = ( char * ) &pxConnection[ 1 ];
+            pxConnection->ulRequestPrefixLen = ulPrefixLen;
+            ( void ) snprintf( pxConnection->pcRequest, ( size_t ) ulPrefixLen + 1U, cOTA_HTTP_RequestTemplate, pcPath, cHost ); /*lint -e586 Intentionally using snprintf. */
+
+            pxConnection->xSocket = OTA_HTTP_OPEN_SOCKET( cHost, usPort );
+
+            if( pxConnection->xSocket != SOCKETS_INVALID_SOCKET )
+            {
+                pxConnection->xOpen = pdTRUE;
+                OTA_LOG_L1( "[%s] Connected to %s:%u.\r\n", OTA_METHOD_NAME, cHost, usPort );
+            }
+            else
+            {
+                vPortFree( pxConnection );
+                pxConnection = NULL;
+            }
+        }
+    }
+
+    return pxConnection;
+}
+/*-----------------------------------------------------------*/
+
+void OTA_HTTP_Disconnect( OTA_HTTP_Connection_t * pxConnection )
+{
+    if( pxConnection != NULL )
+    {
+        OTA_HTTP_CLOSE_SOCKET( pxConnection->xSocket );
+        vPortFree( pxConnection );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t OTA_HTTP_RequestRange( OTA_HTTP_Connection_t * pxConnection,
+                                  uint32_t ulOffset,
+                                  uint32_t ulLength )
+{
+    BaseType_t xStatus = pdFAIL;
+    uint32_t ulRequestLen;
+    uint32_t ulSlot;
+
+    if( ( pxConnection != NULL ) &&
+        ( pxConnection->xOpen == pdTRUE ) &&
+        ( pxConnection->ulRangesInFlight < otaconfigHTTP_PIPELINE_DEPTH ) &&
+        ( ulLength > 0U ) )
+    {
+        ulRequestLen = pxConnection->ulRequestPrefixLen;
+        ulRequestLen += ( uint32_t ) snprintf( &pxConnection->pcRequest[ ulRequestLen ], /*lint -e586 Intentionally using snprintf. */
+                                               OTA_HTTP_RANGE_FIELD_MAX,
+                                               cOTA_HTTP_RangeTemplate,
+                                               ulOffset,
+                                               ulOffset + ulLength - 1U );
+
+        if( prvSendAll( pxConnection->xSocket, pxConnection->pcRequest, ulRequestLen ) == pdPASS )
+        {
+            ulSlot = ( pxConnection->ulRangeHead + pxConnection->ulRangesInFlight ) % otaconfigHTTP_PIPELINE_DEPTH;
+            pxConnection->ulRangeOffset[ ulSlot ] = ulOffset;
+            pxConnection->ulRangeLength[ ulSlot ] = ulLength;
+            pxConnection->ulRangesInFlight++;
+            xStatus = pdPASS;
+        }
+        else
+        {
+            /* The server may have closed the connection after answering the
+             * requests already in flight, so those can still be read. */
+            pxConnection->xOpen = pdFALSE;
+        }
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t OTA_HTTP_ReadResponse( OTA_HTTP_Connection_t * pxConnection,
+                                  OTA_HTTP_BodyCallback_t xCallback,
+                                  void * pvContext )
+{
+    DEFINE_OTA_METHOD_NAME( "OTA_HTTP_ReadResponse" );
+
+    OTA_HTTP_Response_t xResponse;
+    BaseType_t xStatus = pdFAIL;
+    uint32_t ulOffset, ulRemaining, ulAvailable, ulIndex;
+    uint32_t ulHeaderLen = 0U;
+
+    if( ( pxConnection != NULL ) && ( pxConnection->ulRangesInFlight > 0U ) )
+    {
+        ulOffset = pxConnection->ulRangeOffset[ pxConnection->ulRangeHead ];
+        ulRemaining = pxConnection->ulRangeLength[ pxConnection->ulRangeHead ];
+        xStatus = pdPASS;
+
+        /* Receive until the blank line that ends the response header. Bytes
+         * already received after an earlier response are used first. */
+        while( ( xStatus == pdPASS ) && ( ulHeaderLen == 0U ) )
+        {
+            for( ulIndex = pxConnection->ulRxStart; ( ulIndex + 3U ) < pxConnection->ulRxEnd; ulIndex++ )
+            {
+                if( memcmp( &pxConnection->ucRxBuffer[ ulIndex ], "\r\n\r\n", 4 ) == 0 )
+                {
+                    ulHeaderLen = ulIndex + 4U - pxConnection->ulRxStart;
+                    break;
+                }
+            }
+
+            if( ulHeaderLen == 0U )
+            {
+                xStatus = prvReceiveMore( pxConnection );
+            }
+        }
+
+        if( xStatus == pdPASS )
+        {
+            xStatus = prvParseResponseHeader( ( const char * ) &pxConnection->ucRxBuffer[ pxConnection->ulRxStart ], ulHeaderLen, &xResponse );
+            pxConnection->ulRxStart += ulHeaderLen;
+
+            if( xStatus == pdFAIL )
+            {
+                OTA_LOG_L1( "[%s] Malformed response header.\r\n", OTA_METHOD_NAME );
+            }
+            else if( xResponse.ulStatus != OTA_HTTP_STATUS_PARTIAL )
+            {
+                OTA_LOG_L1( "[%s] Range request failed with status %u.\r\n", OTA_METHOD_NAME, xResponse.ulStatus );
+                xStatus = pdFAIL;
+            }
+            else if( ( xResponse.xChunked == ( bool_t ) pdTRUE ) ||
+                     ( xResponse.xHasRange == ( bool_t ) pdFALSE ) ||
+                     ( xResponse.ulRangeFirst != ulOffset ) ||
+                     ( ( xResponse.ulRangeLast - xResponse.ulRangeFirst ) != ( ulRemaining - 1U ) ) ||
+                     ( ( xResponse.xHasLength == ( bool_t ) pdTRUE ) && ( xResponse.ulContentLength != ulRemaining ) ) )
+            {
+                OTA_LOG_L1( "[%s] Response does not match the range asked for at %u.\r\n", OTA_METHOD_NAME, ulOffset );
+                xStatus = pdFAIL;
+            }
+            else
+            {
+                /* The request is answered, even if the body does not arrive. */
+            }
+        }
+
+        /* Pass the body on as it arrives. Bytes received past its end belong
+         * to the next response in the pipeline and stay in the buffer. */
+        while( ( xStatus == pdPASS ) && ( ulRemaining > 0U ) )
+        {
+            ulAvailable = pxConnection->ulRxEnd - pxConnection->ulRxStart;
+
+            if( ulAvailable == 0U )
+            {
+                xStatus = prvReceiveMore( pxConnection );
+            }
+            else
+            {
+                if( ulAvailable > ulRemaining )
+                {
+                    ulAvailable = ulRemaining;
+                }
+
+                xStatus = xCallback( pvContext, ulOffset, &pxConnection->ucRxBuffer[ pxConnection->ulRxStart ], ulAvailable );
+                pxConnection->ulRxStart += ulAvailable;
+                ulOffset += ulAvailable;
+                ulRemaining -= ulAvailable;
+            }
+        }
+
+        if( xStatus == pdPASS )
+        {
+            pxConnection->ulRangeHead = ( pxConnection->ulRangeHead + 1U ) % otaconfigHTTP_PIPELINE_DEPTH;
+            pxConnection->ulRangesInFlight--;
+
+            if( xResponse.xClose == ( bool_t ) pdTRUE )
+            {
+                pxConnection->xOpen = pdFALSE;
+            }
+        }
+        else
+        {
+            pxConnection->xOpen = pdFALSE;
+        }
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t OTA_HTTP_RequestsInFlight( const OTA_HTTP_Connection_t * pxConnection )
+{
+    return ( pxConnection != NULL ) ? pxConnection->ulRangesInFlight : 0U;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t OTA_HTTP_IsOpen( const OTA_HTTP_Connection_t * pxConnection )
+{
+    return ( pxConnection != NULL ) ? pxConnection->xOpen : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvParseURL( const char * pcURL,
+                               char * pcHost,
+                               uint16_t * pusPort,
+                               const char ** ppcPath )
+{
+    BaseType_t xStatus = pdFAIL;
+    const char * pcHostStart;
+    uint32_t ulHostLen = 0U;
+    uint32_t ulPort = OTA_HTTP_DEFAULT_PORT;
+    const char * pcText;
+
+    if( ( pcURL != NULL ) && ( strncmp( pcURL, OTA_HTTP_SCHEME, CONST_STRLEN( OTA_HTTP_SCHEME ) ) == 0 ) )
+    {
+        pcHostStart = &pcURL[ CONST_STRLEN( OTA_HTTP_SCHEME ) ];
+
+        while( ( pcHostStart[ ulHostLen ] != '\0' ) && ( pcHostStart[ ulHostLen ] != ':' ) && ( pcHostStart[ ulHostLen ] != '/' ) )
+        {
+            ulHostLen++;
+        }
+
+        pcText = &pcHostStart[ ulHostLen ];
+        xStatus = ( ( ulHostLen > 0U ) && ( ulHostLen <= securesocketsMAX_DNS_NAME_LENGTH ) ) ? pdPASS : pdFAIL;
+
+        if( ( xStatus == pdPASS ) && ( *pcText == ':' ) )
+        {
+            pcText++;
+            xStatus = prvParseNumber( &pcText, &pcText[ strlen( pcText ) ], &ulPort );
+
+            if( ( ulPort == 0U ) || ( ulPort > 0xffffU ) || ( ( *pcText != '\0' ) && ( *pcText != '/' ) ) )
+            {
+                xStatus = pdFAIL;
+            }
+        }
+
+        if( xStatus == pdPASS )
+        {
+            memcpy( pcHost, pcHostStart, ulHostLen );
+            pcHost[ ulHostLen ] = '\0';
+            *pusPort = ( uint16_t ) ulPort;
+            *ppcPath = ( *pcText == '/' ) ? pcText : "/";
+        }
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvIsIPAddress( const char * pcHost )
+{
+    BaseType_t xResult = pdTRUE;
+
+    while( *pcHost != '\0' )
+    {
+        if( ( ( *pcHost < '0' ) || ( *pcHost > '9' ) ) && ( *pcHost != '.' ) )
+        {
+            xResult = pdFALSE;
+            break;
+        }
+
+        pcHost++;
+    }
+
+    return xResult;
+}
+/*-----------------------------------------------------------*/
+
+static Socket_t prvOpenSocket( const char * pcHost,
+                               uint16_t usPort )
+{
+    DEFINE_OTA_METHOD_NAME( "prvOpenSocket" );
+
+    static const char * const pcServerCertificate = otaconfigHTTP_SERVER_CERTIFICATE_PEM;
+    const TickType_t xTimeout = pdMS_TO_TICKS( otaconfigHTTP_TIMEOUT_MS );
+    SocketsSockaddr_t xServerAddress;
+    Socket_t xSocket;
+    BaseType_t xStatus = pdPASS;
+
+    xSocket = SOCKETS_Socket( SOCKETS_AF_INET, SOCKETS_SOCK_STREAM, SOCKETS_IPPROTO_TCP );
+
+    if( xSocket != SOCKETS_INVALID_SOCKET )
+    {
+        xServerAddress.ucLength = sizeof( SocketsSockaddr_t );
+        xServerAddress.ucSocketDomain = SOCKETS_AF_INET;
+        xServerAddress.usPort = SOCKETS_htons( usPort );
+        xServerAddress.ulAddress = SOCKETS_GetHostByName( pcHost );
+
+        if( xServerAddress.ulAddress == 0U )
+        {
+            OTA_LOG_L1( "[%s] Could not resolve %s.\r\n", OTA_METHOD_NAME, pcHost );
+            xStatus = pdFAIL;
+        }
+
+        ( void ) SOCKETS_SetSockOpt( xSocket, 0, SOCKETS_SO_SNDTIMEO, &xTimeout, sizeof( xTimeout ) );
+        ( void ) SOCKETS_SetSockOpt( xSocket, 0, SOCKETS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+        ( void ) SOCKETS_SetSockOpt( xSocket, 0, SOCKETS_SO_REQUIRE_TLS, NULL, ( size_t ) 0 );
+
+        if( ( xStatus == pdPASS ) && ( pcServerCertificate != NULL ) )
+        {
+            if( SOCKETS_SetSockOpt( xSocket, 0, SOCKETS_SO_TRUSTED_SERVER_CERTIFICATE,
+                                    pcServerCertificate, strlen( pcServerCertificate ) + 1U ) != SOCKETS_ERROR_NONE )
+            {
+                xStatus = pdFAIL;
+            }
+        }
+
+        if( ( xStatus == pdPASS ) && ( prvIsIPAddress( pcHost ) == pdFALSE ) )
+        {
+            if( SOCKETS_SetSockOpt( xSocket, 0, SOCKETS_SO_SERVER_NAME_INDICATION,
+                                    pcHost, strlen( pcHost ) + 1U ) != SOCKETS_ERROR_NONE )
+            {
+                xStatus = pdFAIL;
+            }
+        }
+
+        if( xStatus == pdPASS )
+        {
+            if( SOCKETS_Connect( xSocket, &xServerAddress, sizeof( xServerAddress ) ) != SOCKETS_ERROR_NONE )
+            {
+                OTA_LOG_L1( "[%s] Could not connect to %s:%u.\r\n", OTA_METHOD_NAME, pcHost, usPort );
+                xStatus = pdFAIL;
+            }
+        }
+
+        if( xStatus == pdFAIL )
+        {
+            ( void ) SOCKETS_Close( xSocket );
+            xSocket = SOCKETS_INVALID_SOCKET;
+        }
+    }
+
+    return xSocket;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCloseSocket( Socket_t xSocket )
+{
+    ( void ) SOCKETS_Shutdown( xSocket, SOCKETS_SHUT_RDWR );
+    ( void ) SOCKETS_Close( xSocket );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSendAll( Socket_t xSocket,
+                              const char * pcData,
+                              uint32_t ulLength )
+{
+    uint32_t ulSent = 0U;
+    int32_t lResult;
+
+    while( ulSent < ulLength )
+    {
+        lResult = OTA_HTTP_SEND( xSocket, &pcData[ ulSent ], ( size_t ) ( ulLength - ulSent ), 0U );
+
+        if( lResult <= 0 )
+        {
+            break;
+        }
+
+        ulSent += ( uint32_t ) lResult;
+    }
+
+    return ( ulSent == ulLength ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReceiveMore( OTA_HTTP_Connection_t * pxConnection )
+{
+    DEFINE_OTA_METHOD_NAME( "prvReceiveMore" );
+
+    BaseType_t xStatus = pdFAIL;
+    int32_t lReceived;
+
+    /* Move unread bytes to the start of the buffer to make room after them. */
+    if( pxConnection->ulRxStart > 0U )
+    {
+        memmove( pxConnection->ucRxBuffer,
+                 &pxConnection->ucRxBuffer[ pxConnection->ulRxStart ],
+                 pxConnection->ulRxEnd - pxConnection->ulRxStart );
+        pxConnection->ulRxEnd -= pxConnection->ulRxStart;
+        pxConnection->ulRxStart = 0U;
+    }
+
+    if( pxConnection->ulRxEnd < sizeof( pxConnection->ucRxBuffer ) )
+    {
+        lReceived = OTA_HTTP_RECV( pxConnection->xSocket,
+                                   &pxConnection->ucRxBuffer[ pxConnection->ulRxEnd ],
+                                   sizeof( pxConnection->ucRxBuffer ) - pxConnection->ulRxEnd,
+                                   0U );
+
+        if( lReceived > 0 )
+        {
+            pxConnection->ulRxEnd += ( uint32_t ) lReceived;
+            xStatus = pdPASS;
+        }
+        else
+        {
+            OTA_LOG_L1( "[%s] Receive failed (%d).\r\n", OTA_METHOD_NAME, lReceived );
+        }
+    }
+    else
+    {
+        OTA_LOG_L1( "[%s] Response header is too large.\r\n", OTA_METHOD_NAME );
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvParseNumber( const char ** ppcText,
+                                  const char * pcEnd,
+                                  uint32_t * pulValue )
+{
+    const char * pcText = *ppcText;
+    uint32_t ulValue = 0U;
+    BaseType_t xStatus = pdFAIL;
+
+    while( ( pcText < pcEnd ) && ( *pcText >= '0' ) && ( *pcText <= '9' ) )
+    {
+        /* Reject values that do not fit in 32 bits. */
+        if( ulValue > ( ( 0xffffffffUL - 9UL ) / 10UL ) )
+        {
+            xStatus = pdFAIL;
+            break;
+        }
+
+        ulValue = ( ulValue * 10U ) + ( uint32_t ) ( *pcText - '0' );
+        pcText++;
+        xStatus = pdPASS;
+    }
+
+    *ppcText = pcText;
+    *pulValue = ulValue;
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvIsFieldName( const char * pcName,
+                                  uint32_t ulNameLen,
+                                  const char * pcLowerName )
+{
+    BaseType_t xResult = ( strlen( pcLowerName ) == ulNameLen ) ? pdTRUE : pdFALSE;
+    uint32_t ulIndex;
+    char cChar;
+
+    for( ulIndex = 0U; ( xResult == pdTRUE ) && ( ulIndex < ulNameLen ); ulIndex++ )
+    {
+        cChar = pcName[ ulIndex ];
+
+        if( ( cChar >= 'A' ) && ( cChar <= 'Z' ) )
+        {
+            cChar = ( char ) ( cChar - 'A' + 'a' );
+        }
+
+        if( cChar != pcLowerName[ ulIndex ] )
+        {
+            xResult = pdFALSE;
+        }
+    }
+
+    return xResult;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvParseResponseHeader( const char * pcHeader,
+                                          uint32_t ulHeaderLen,
+                                          OTA_HTTP_Response_t * pxResponse )
+{
+    const char * pcEnd = &pcHeader[ ulHeaderLen ];
+    const char * pcLine = pcHeader;
+    const char * pcLineEnd;
+    const char * pcColon;
+    const char * pcValue;
+    BaseType_t xStatus = pdFAIL;
+
+    memset( pxResponse, 0, sizeof( OTA_HTTP_Response_t ) );
+
+    /* The status line is "HTTP/1.x <status> <reason>". */
+    if( ( ulHeaderLen > ( CONST_STRLEN( cOTA_HTTP_Version ) + 2U ) ) &&
+        ( strncmp( pcHeader, cOTA_HTTP_Version, CONST_STRLEN( cOTA_HTTP_Version ) ) == 0 ) &&
+        ( pcHeader[ CONST_STRLEN( cOTA_HTTP_Version ) + 1U ] == ' ' ) )
+    {
+        pcValue = &pcHeader[ CONST_STRLEN( cOTA_HTTP_Version ) + 2U ];
+        xStatus = prvParseNumber( &pcValue, pcEnd, &pxResponse->ulStatus );
+    }
+
+    while( xStatus == pdPASS )
+    {
+        /* Move to the next line. The header always ends with a blank line. */
+        while( ( pcLine[ 0 ] != '\r' ) || ( pcLine[ 1 ] != '\n' ) )
+        {
+            pcLine++;
+        }
+
+        pcLine += 2;
+        pcLineEnd = pcLine;
+
+        while( ( pcLineEnd[ 0 ] != '\r' ) || ( pcLineEnd[ 1 ] != '\n' ) )
+        {
+            pcLineEnd++;
+        }
+
+        if( pcLineEnd == pcLine )
+        {
+            break; /* The blank line ends the header. */
+        }
+
+        pcColon = memchr( pcLine, ':', ( size_t ) ( pcLineEnd - pcLine ) );
+
+        if( pcColon == NULL )
+        {
+            xStatus = pdFAIL;
+            break;
+        }
+
+        pcValue = &pcColon[ 1 ];
+
+        while( ( pcValue < pcLineEnd ) && ( *pcValue == ' ' ) )
+        {
+            pcValue++;
+        }
+
+        if( prvIsFieldName( pcLine, ( uint32_t ) ( pcColon - pcLine ), cOTA_HTTP_ContentRangeField ) == pdTRUE )
+        {
+            /* The value is "bytes <first>-<last>/<total>". */
+            if( ( ( uint32_t ) ( pcLineEnd - pcValue ) > CONST_STRLEN( cOTA_HTTP_RangeUnit ) ) &&
+                ( strncmp( pcValue, cOTA_HTTP_RangeUnit, CONST_STRLEN( cOTA_HTTP_RangeUnit ) ) == 0 ) )
+            {
+                pcValue += CONST_STRLEN( cOTA_HTTP_RangeUnit );
+
+                if( ( prvParseNumber( &pcValue, pcLineEnd, &pxResponse->ulRangeFirst ) == pdPASS ) &&
+                    ( pcValue < pcLineEnd ) && ( *pcValue == '-' ) )
+                {
+                    pcValue++;
+
+                    if( ( prvParseNumber( &pcValue, pcLineEnd, &pxResponse->ulRangeLast ) == pdPASS ) &&
+                        ( pxResponse->ulRangeLast >= pxResponse->ulRangeFirst ) )
+                    {
+                        pxResponse->xHasRange = ( bool_t ) pdTRUE;
+                    }
+                }
+            }
+        }
+        else if( prvIsFieldName( pcLine, ( uint32_t ) ( pcColon - pcLine ), cOTA_HTTP_ContentLengthField ) == pdTRUE )
+        {
+            if( prvParseNumber( &pcValue, pcLineEnd, &pxResponse->ulContentLength ) == pdPASS )
+            {
+                pxResponse->xHasLength = ( bool_t ) pdTRUE;
+            }
+        }
+        else if( prvIsFieldName( pcLine, ( uint32_t ) ( pcColon - pcLine ), cOTA_HTTP_ConnectionField ) == pdTRUE )
+        {
+            if( prvIsFieldName( pcValue, ( uint32_t ) ( pcLineEnd - pcValue ), cOTA_HTTP_Close ) == pdTRUE )
+            {
+                pxResponse->xClose = ( bool_t ) pdTRUE;
+            }
+        }
+        else if( prvIsFieldName( pcLine, ( uint32_t ) ( pcColon - pcLine ), cOTA_HTTP_TransferEncodingField ) == pdTRUE )
+        {
+            pxResponse->xChunked = ( bool_t ) pdTRUE;
+        }
+        else
+        {
+            /* Other fields don't affect the download. */
+        }
+
+        pcLine = pcLineEnd;
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+/* Provide access to private members for testing. */
+#ifdef AMAZON_FREERTOS_ENABLE_UNIT_TESTS
+    #include "aws_ota_http_test_access_define.h"
+#endif
@@ -192,6 +192,48 @@ int16_t prvPAL_WriteBlock( OTA_FileContext_t * const C,
     return ( int16_t ) lResult;
 }
 
+/* Read a block of the running image, which on this platform is the executable itself. */
+
+int16_t prvPAL_ReadRunningImage( OTA_FileContext_t * const C,
+                                 uint32_t ulOffset,
+                                 uint8_t * const pacData,
+                                 uint32_t ulBlockSize )
+{
+    DEFINE_OTA_METHOD_NAME( "prvPAL_ReadRunningImage" );
+
+    char cModulePath[ MAX_PATH ];
+    FILE * pxImage = NULL;
+    int32_t lResult = -1;
+
+    ( void ) C;
+
+    if( GetModuleFileNameA( NULL, cModulePath, sizeof( cModulePath ) ) != 0UL )
+    {
+        pxImage = fopen( cModulePath, "rb" ); /*lint !e586
+                                               * C standard library call is being used for portability. */
+    }
+
+    if( pxImage != NULL )
+    {
+        if( fseek( pxImage, ulOffset, SEEK_SET ) == 0 ) /*lint !e586 !e713 !e9034
+                                                         * C standard library call is being used for portability. */
+        {
+            lResult = ( int32_t ) fread( pacData, 1, ulBlockSize, pxImage ); /*lint !e586
+                                                                             * C standard library call is being used for portability. */
+        }
+
+        ( void ) fclose( pxImage ); /*lint !e586
+                                     * C standard library call is being used for portability. */
+    }
+
+    if( lResult < 0 )
+    {
+        OTA_LOG_L1( "[%s] ERROR - Unable to read the running image.\r\n", OTA_METHOD_NAME );
+    }
+
+    return ( int16_t ) lResult;
+}
+
 /* Close the specified file. This shall authenticate the file if it is marked as secure. */
 
 OTA_Err_t prvPAL_CloseFile( OTA_FileContext_t * const C )
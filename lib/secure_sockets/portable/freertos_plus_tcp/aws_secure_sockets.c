@@ -81,6 +81,34 @@ static BaseType_t prvNetworkRecv( void * pvContext,
 }
 /*-----------------------------------------------------------*/
 
+/*
+ * @brief Network zero-copy receive callback.
+ */
+static BaseType_t prvNetworkRecvZeroCopy( void * pvContext,
+                                          unsigned char ** ppucData )
+{
+    SSOCKETContextPtr_t pxContext = ( SSOCKETContextPtr_t ) pvContext; /*lint !e9087 cast used for portability. */
+
+    /* Returns the bytes up to the end of the socket's receive stream, without
+     * removing them from it. */
+    return FreeRTOS_recv( pxContext->xSocket, ppucData, 0, pxContext->xRecvFlags | FREERTOS_ZERO_COPY );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * @brief Network zero-copy receive release callback.
+ */
+static void prvNetworkRecvRelease( void * pvContext,
+                                   size_t xLength )
+{
+    SSOCKETContextPtr_t pxContext = ( SSOCKETContextPtr_t ) pvContext; /*lint !e9087 cast used for portability. */
+
+    /* Receiving into no buffer removes the bytes from the receive stream, and
+     * reopens the TCP window if it had closed. */
+    ( void ) FreeRTOS_recv( pxContext->xSocket, NULL, xLength, 0 );
+}
+/*-----------------------------------------------------------*/
+
 /*
  * Interface routines.
  */
@@ -177,6 +205,8 @@ int32_t SOCKETS_Connect( Socket_t xSocket,
             xTLSParams.pvCallerContext = pxContext;
             xTLSParams.pxNetworkRecv = prvNetworkRecv;
             xTLSParams.pxNetworkSend = prvNetworkSend;
+            xTLSParams.pxNetworkRecvZeroCopy = prvNetworkRecvZeroCopy;
+            xTLSParams.pxNetworkRecvRelease = prvNetworkRecvRelease;
             lStatus = TLS_Init( &pxContext->pvTLSContext, &xTLSParams );
 
             if( SOCKETS_ERROR_NONE == lStatus )
@@ -238,6 +268,64 @@ int32_t SOCKETS_Recv( Socket_t xSocket,
 }
 /*-----------------------------------------------------------*/
 
+int32_t SOCKETS_RecvZeroCopy( Socket_t xSocket,
+                              const uint8_t ** ppucData )
+{
+    int32_t lStatus = SOCKETS_SOCKET_ERROR;
+    SSOCKETContextPtr_t pxContext = ( SSOCKETContextPtr_t ) xSocket; /*lint !e9087 cast used for portability. */
+
+    if( ( xSocket != SOCKETS_INVALID_SOCKET ) &&
+        ( ppucData != NULL ) )
+    {
+        pxContext->xRecvFlags = 0;
+
+        if( pdTRUE == pxContext->xRequireTLS )
+        {
+            /* Decrypt the next record, in the receive stream if it has fully
+             * arrived there. */
+            lStatus = TLS_RecvZeroCopy( pxContext->pvTLSContext, ppucData );
+        }
+        else
+        {
+            /* Lend the bytes in the receive stream. */
+            lStatus = prvNetworkRecvZeroCopy( pxContext, ( unsigned char ** ) ppucData ); /*lint !e9005 the data is only read. */
+        }
+    }
+    else
+    {
+        lStatus = SOCKETS_EINVAL;
+    }
+
+    return lStatus;
+}
+/*-----------------------------------------------------------*/
+
+int32_t SOCKETS_RecvRelease( Socket_t xSocket,
+                             size_t xLength )
+{
+    int32_t lStatus = SOCKETS_ERROR_NONE;
+    SSOCKETContextPtr_t pxContext = ( SSOCKETContextPtr_t ) xSocket; /*lint !e9087 cast used for portability. */
+
+    if( xSocket != SOCKETS_INVALID_SOCKET )
+    {
+        if( pdTRUE == pxContext->xRequireTLS )
+        {
+            lStatus = TLS_RecvRelease( pxContext->pvTLSContext, xLength );
+        }
+        else
+        {
+            prvNetworkRecvRelease( pxContext, xLength );
+        }
+    }
+    else
+    {
+        lStatus = SOCKETS_EINVAL;
+    }
+
+    return lStatus;
+}
+/*-----------------------------------------------------------*/
+
 int32_t SOCKETS_Send( Socket_t xSocket,
                       const void * pvBuffer,
                       size_t xDataLength,
@@ -1608,8 +1608,12 @@
  * Requires: MBEDTLS_HAVE_ASM
  *
  * This modules adds support for the AES-NI instructions on x86-64
+ *
+ * The instructions, and PCLMULQDQ for GCM, are only used when CPUID reports
+ * them at runtime, otherwise the portable C implementation is used.  The
+ * module compiles to nothing on other targets and compilers.
  */
-//#define MBEDTLS_AESNI_C
+#define MBEDTLS_AESNI_C
 
 /**
  * \def MBEDTLS_AES_C
@@ -27,6 +27,7 @@
 #include "FreeRTOS.h"
 #include "FreeRTOSIPConfig.h"
 #include "aws_tls.h"
+#include "aws_tls_config_defaults.h"
 #include "aws_crypto.h"
 #include "aws_pkcs11.h"
 #include "aws_pkcs11_config.h"
@@ -42,11 +43,45 @@
 #include "mbedtls/sha256.h"
 #include "mbedtls/pk.h"
 #include "mbedtls/pk_internal.h"
+#include "mbedtls/ssl_internal.h"
+#include "mbedtls/platform_util.h"
 #include "mbedtls/debug.h"
 #ifdef MBEDTLS_DEBUG_C
     #define tlsDEBUG_VERBOSE    4
 #endif
 
+/* The max_fragment_length extension code for tlsconfigMAX_FRAGMENT_LENGTH. */
+#if ( tlsconfigMAX_FRAGMENT_LENGTH == 0 )
+    #define tlsMAX_FRAGMENT_LENGTH_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_NONE
+#elif ( tlsconfigMAX_FRAGMENT_LENGTH == 512 )
+    #define tlsMAX_FRAGMENT_LENGTH_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_512
+#elif ( tlsconfigMAX_FRAGMENT_LENGTH == 1024 )
+    #define tlsMAX_FRAGMENT_LENGTH_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_1024
+#elif ( tlsconfigMAX_FRAGMENT_LENGTH == 2048 )
+    #define tlsMAX_FRAGMENT_LENGTH_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_2048
+#elif ( tlsconfigMAX_FRAGMENT_LENGTH == 4096 )
+    #define tlsMAX_FRAGMENT_LENGTH_CODE    MBEDTLS_SSL_MAX_FRAG_LEN_4096
+#else
+    #error "tlsconfigMAX_FRAGMENT_LENGTH must be 0, 512, 1024, 2048 or 4096."
+#endif
+
+/* The ciphersuites offered to the server, terminated by zero as mbedTLS
+ * requires. */
+#ifdef tlsconfigCIPHERSUITES
+    static const int lCiphersuites[] = { tlsconfigCIPHERSUITES, 0 };
+#endif
+
+/* The number of bytes of the receive record buffer that hold the incoming
+ * record sequence number, which must be kept while the buffer is freed. */
+#define tlsIN_COUNTER_LENGTH    ( 8 )
+
+/* The number of pointers mbedTLS keeps into each record buffer: the sequence
+ * number, header, length, IV and message. */
+#define tlsRECORD_POINTERS      ( 5 )
+
+/* The index of the record header pointer among them. */
+#define tlsHEADER_POINTER       ( 1 )
+
 /* C runtime includes. */
 #include <string.h>
 #include <time.h>
@@ -60,6 +95,10 @@
  * @param[in] ulServerCertificateLength Length in bytes of the server certificate.
  * @param[in] xNetworkRecv Callback for receiving data on an open TCP socket.
  * @param[in] xNetworkSend Callback for sending data on an open TCP socket.
+ * @param[in] xNetworkRecvZeroCopy Optional callback for accessing received data
+ * in the network buffer.
+ * @param[in] xNetworkRecvRelease Optional callback for releasing data accessed
+ * with xNetworkRecvZeroCopy.
  * @param[in] pvCallerContext Opaque pointer provided by caller for above callbacks.
  * @param[out] xTLSCHandshakeSuccessful Indicates whether TLS handshake was successfully completed.
  * @param[out] xMbedSslCtx Connection context for mbedTLS.
@@ -70,6 +109,25 @@
  * @param[out] xP11FunctionList PKCS#11 function list structure.
  * @param[out] xP11Session PKCS#11 session context.
  * @param[out] xP11PrivateKey PKCS#11 private key context.
+ * @param[out] xRecordBuffersReleased Indicates whether the record buffers have
+ * been freed, so are allocated when they are needed.
+ * @param[out] xOutBufferLength Size of the send record buffer when allocated.
+ * @param[out] xRecordBufferBytes Size of the record buffers currently allocated.
+ * @param[out] xPeakRecordBufferBytes Peak of xRecordBufferBytes.
+ * @param[out] ulRecordBufferReleases Number of times the record buffers were
+ * freed while the connection was idle.
+ * @param[out] ucInCounter Incoming record sequence number kept while the
+ * record buffers are freed.
+ * @param[out] xInOffsets Offsets of the mbedTLS receive pointers into the
+ * receive record buffer, kept while the record buffers are freed.
+ * @param[out] xOutOffsets Offsets of the mbedTLS send pointers into the send
+ * record buffer, kept while the record buffers are freed.
+ * @param[out] xInPlaceRecordLength Length of the record being decrypted in the
+ * network buffer, or zero if there is none.
+ * @param[out] xBytesDecryptedInPlace Number of received bytes decrypted in the
+ * network buffer.
+ * @param[out] xBytesCopied Number of received bytes copied into the receive
+ * record buffer.
  */
 typedef struct TLSContext
 {
@@ -81,6 +139,8 @@ typedef struct TLSContext
 
     NetworkRecv_t xNetworkRecv;
     NetworkSend_t xNetworkSend;
+    NetworkRecvZeroCopy_t xNetworkRecvZeroCopy;
+    NetworkRecvRelease_t xNetworkRecvRelease;
     void * pvCallerContext;
     BaseType_t xTLSHandshakeSuccessful;
 
@@ -96,6 +156,21 @@ typedef struct TLSContext
     CK_FUNCTION_LIST_PTR xP11FunctionList;
     CK_SESSION_HANDLE xP11Session;
     CK_OBJECT_HANDLE xP11PrivateKey;
+
+    /* Record buffers. */
+    BaseType_t xRecordBuffersReleased;
+    size_t xOutBufferLength;
+    size_t xRecordBufferBytes;
+    size_t xPeakRecordBufferBytes;
+    uint32_t ulRecordBufferReleases;
+    unsigned char ucInCounter[ tlsIN_COUNTER_LENGTH ];
+    size_t xInOffsets[ tlsRECORD_POINTERS ];
+    size_t xOutOffsets[ tlsRECORD_POINTERS ];
+
+    /* Records decrypted in the network buffer. */
+    size_t xInPlaceRecordLength;
+    size_t xBytesDecryptedInPlace;
+    size_t xBytesCopied;
 } TLSContext_t;
 
 
@@ -105,6 +180,344 @@ typedef struct TLSContext
  * Helper routines.
  */
 
+/**
+ * @brief Hands a record that was decrypted in the network buffer back to the
+ * network.
+ *
+ * The record is wiped, as the receive record buffer is when it is freed, and
+ * the mbedTLS receive pointers are cleared as if the buffer had been freed.
+ *
+ * @param[in] pxCtx TLS context.
+ */
+static void prvReleaseInPlaceRecord( TLSContext_t * pxCtx )
+{
+    mbedtls_ssl_context * pxSsl = &pxCtx->xMbedSslCtx;
+    unsigned char ** ppucInPointers[ tlsRECORD_POINTERS ] = { &pxSsl->in_ctr, &pxSsl->in_hdr, &pxSsl->in_len, &pxSsl->in_iv, &pxSsl->in_msg };
+    size_t xPointer;
+
+    if( 0 != pxCtx->xInPlaceRecordLength )
+    {
+        mbedtls_platform_zeroize( pxSsl->in_hdr, pxCtx->xInPlaceRecordLength );
+        pxCtx->xNetworkRecvRelease( pxCtx->pvCallerContext, pxCtx->xInPlaceRecordLength );
+        pxCtx->xInPlaceRecordLength = 0;
+
+        for( xPointer = 0; xPointer < tlsRECORD_POINTERS; xPointer++ )
+        {
+            *ppucInPointers[ xPointer ] = NULL;
+        }
+
+        pxSsl->in_buf = NULL;
+    }
+}
+
+/**
+ * @brief Releases the record decrypted in the network buffer once mbedTLS has
+ * no more data from it.
+ *
+ * @param[in] pxCtx TLS context.
+ */
+static void prvFinishInPlaceRecord( TLSContext_t * pxCtx )
+{
+    if( ( 0 != pxCtx->xInPlaceRecordLength ) &&
+        ( NULL == pxCtx->xMbedSslCtx.in_offt ) )
+    {
+        prvReleaseInPlaceRecord( pxCtx );
+    }
+}
+
+/**
+ * @brief Frees the mbedTLS record buffers, keeping the state needed to
+ * allocate them again.
+ *
+ * The incoming record sequence number is stored in the receive record buffer,
+ * so it is copied out, along with the offsets of the pointers mbedTLS keeps
+ * into both buffers.  A record being decrypted in the network buffer is
+ * released instead.
+ *
+ * @param[in] pxCtx TLS context.
+ */
+static void prvFreeRecordBuffers( TLSContext_t * pxCtx )
+{
+    mbedtls_ssl_context * pxSsl = &pxCtx->xMbedSslCtx;
+    unsigned char ** ppucInPointers[ tlsRECORD_POINTERS ] = { &pxSsl->in_ctr, &pxSsl->in_hdr, &pxSsl->in_len, &pxSsl->in_iv, &pxSsl->in_msg };
+    unsigned char ** ppucOutPointers[ tlsRECORD_POINTERS ] = { &pxSsl->out_ctr, &pxSsl->out_hdr, &pxSsl->out_len, &pxSsl->out_iv, &pxSsl->out_msg };
+    size_t xPointer;
+
+    prvReleaseInPlaceRecord( pxCtx );
+
+    if( NULL != pxSsl->in_buf )
+    {
+        memcpy( pxCtx->ucInCounter, pxSsl->in_ctr, tlsIN_COUNTER_LENGTH );
+
+        for( xPointer = 0; xPointer < tlsRECORD_POINTERS; xPointer++ )
+        {
+            pxCtx->xInOffsets[ xPointer ] = ( size_t ) ( *ppucInPointers[ xPointer ] - pxSsl->in_buf );
+            *ppucInPointers[ xPointer ] = NULL;
+        }
+
+        mbedtls_platform_zeroize( pxSsl->in_buf, MBEDTLS_SSL_IN_BUFFER_LEN );
+        mbedtls_free( pxSsl->in_buf );
+        pxSsl->in_buf = NULL;
+    }
+
+    if( NULL != pxSsl->out_buf )
+    {
+        for( xPointer = 0; xPointer < tlsRECORD_POINTERS; xPointer++ )
+        {
+            pxCtx->xOutOffsets[ xPointer ] = ( size_t ) ( *ppucOutPointers[ xPointer ] - pxSsl->out_buf );
+            *ppucOutPointers[ xPointer ] = NULL;
+        }
+
+        mbedtls_platform_zeroize( pxSsl->out_buf, pxCtx->xOutBufferLength );
+        mbedtls_free( pxSsl->out_buf );
+        pxSsl->out_buf = NULL;
+    }
+
+    pxCtx->xRecordBufferBytes = 0;
+    pxCtx->xRecordBuffersReleased = pdTRUE;
+}
+
+/**
+ * @brief Allocates the mbedTLS record buffers that were freed by
+ * prvFreeRecordBuffers().
+ *
+ * @param[in] pxCtx TLS context.
+ * @param[in] xReceive pdTRUE to allocate the receive record buffer as well as
+ * the send record buffer.
+ *
+ * @return Zero on success, or MBEDTLS_ERR_SSL_ALLOC_FAILED.
+ */
+static int prvAllocateRecordBuffers( TLSContext_t * pxCtx,
+                                     BaseType_t xReceive )
+{
+    mbedtls_ssl_context * pxSsl = &pxCtx->xMbedSslCtx;
+    unsigned char ** ppucInPointers[ tlsRECORD_POINTERS ] = { &pxSsl->in_ctr, &pxSsl->in_hdr, &pxSsl->in_len, &pxSsl->in_iv, &pxSsl->in_msg };
+    unsigned char ** ppucOutPointers[ tlsRECORD_POINTERS ] = { &pxSsl->out_ctr, &pxSsl->out_hdr, &pxSsl->out_len, &pxSsl->out_iv, &pxSsl->out_msg };
+    size_t xPointer;
+    int lResult = 0;
+
+    if( pdTRUE == pxCtx->xRecordBuffersReleased )
+    {
+        if( ( pdTRUE == xReceive ) && ( NULL == pxSsl->in_buf ) )
+        {
+            pxSsl->in_buf = mbedtls_calloc( 1, MBEDTLS_SSL_IN_BUFFER_LEN );
+
+            if( NULL == pxSsl->in_buf )
+            {
+                lResult = MBEDTLS_ERR_SSL_ALLOC_FAILED;
+            }
+            else
+            {
+                for( xPointer = 0; xPointer < tlsRECORD_POINTERS; xPointer++ )
+                {
+                    *ppucInPointers[ xPointer ] = pxSsl->in_buf + pxCtx->xInOffsets[ xPointer ];
+                }
+
+                memcpy( pxSsl->in_ctr, pxCtx->ucInCounter, tlsIN_COUNTER_LENGTH );
+                pxCtx->xRecordBufferBytes += MBEDTLS_SSL_IN_BUFFER_LEN;
+            }
+        }
+
+        if( ( 0 == lResult ) && ( NULL == pxSsl->out_buf ) )
+        {
+            pxSsl->out_buf = mbedtls_calloc( 1, pxCtx->xOutBufferLength );
+
+            if( NULL == pxSsl->out_buf )
+            {
+                lResult = MBEDTLS_ERR_SSL_ALLOC_FAILED;
+            }
+            else
+            {
+                for( xPointer = 0; xPointer < tlsRECORD_POINTERS; xPointer++ )
+                {
+                    *ppucOutPointers[ xPointer ] = pxSsl->out_buf + pxCtx->xOutOffsets[ xPointer ];
+                }
+
+                pxCtx->xRecordBufferBytes += pxCtx->xOutBufferLength;
+            }
+        }
+
+        if( pxCtx->xRecordBufferBytes > pxCtx->xPeakRecordBufferBytes )
+        {
+            pxCtx->xPeakRecordBufferBytes = pxCtx->xRecordBufferBytes;
+        }
+    }
+
+    return lResult;
+}
+
+/**
+ * @brief Checks whether mbedTLS holds any data in the record buffers.
+ *
+ * @param[in] pxCtx TLS context.
+ *
+ * @return pdTRUE if no part of a record is waiting to be read or sent.
+ */
+static BaseType_t prvRecordBuffersIdle( TLSContext_t * pxCtx )
+{
+    BaseType_t xIdle = pdFALSE;
+
+    if( ( 0 == pxCtx->xMbedSslCtx.in_left ) &&
+        ( 0 == pxCtx->xMbedSslCtx.out_left ) &&
+        ( 0 == mbedtls_ssl_check_pending( &pxCtx->xMbedSslCtx ) ) )
+    {
+        xIdle = pdTRUE;
+    }
+
+    return xIdle;
+}
+
+#if ( tlsconfigRELEASE_IDLE_RECORD_BUFFERS == 1 )
+
+/**
+ * @brief Frees the record buffers if the connection is idle.
+ *
+ * @param[in] pxCtx TLS context.
+ */
+    static void prvReleaseIdleRecordBuffers( TLSContext_t * pxCtx )
+    {
+        if( ( ( NULL != pxCtx->xMbedSslCtx.in_buf ) || ( NULL != pxCtx->xMbedSslCtx.out_buf ) ) &&
+            ( pdTRUE == prvRecordBuffersIdle( pxCtx ) ) )
+        {
+            prvFreeRecordBuffers( pxCtx );
+            pxCtx->ulRecordBufferReleases++;
+        }
+    }
+#endif /* if ( tlsconfigRELEASE_IDLE_RECORD_BUFFERS == 1 ) */
+
+/**
+ * @brief Points mbedTLS at the next record in the network buffer, if the
+ * whole record is there, so it is decrypted where it is.
+ *
+ * mbedTLS keeps the incoming record sequence number in the 8 bytes before the
+ * record header, which belong to the previous record in the network buffer,
+ * so it is pointed at the copy in the TLS context instead.  in_buf is only
+ * used to check record lengths against the size of the receive record buffer,
+ * so it is set to the record header, keeping every pointer inside the network
+ * buffer, and records longer than the receive record buffer would accept are
+ * copied, where mbedTLS rejects them as usual.  The send record buffer is
+ * allocated, as mbedTLS sends an alert if the record fails to decrypt.
+ *
+ * Only application data records are decrypted in place, as mbedTLS may keep a
+ * handshake message after the record is read, and only with the GCM and CCM
+ * ciphers, as mbedTLS checks CBC padding in constant time by reading up to 256
+ * bytes past the record.  Other records, and records that have not fully
+ * arrived or that wrap around the end of the network buffer, are copied into
+ * the receive record buffer as usual.
+ *
+ * @param[in] pxCtx TLS context.
+ *
+ * @return Zero if a record is ready to be read, MBEDTLS_ERR_SSL_WANT_READ if
+ * no data was received, or another negative value on error.
+ */
+static int prvPrepareInPlaceRecord( TLSContext_t * pxCtx )
+{
+    mbedtls_ssl_context * pxSsl = &pxCtx->xMbedSslCtx;
+    unsigned char ** ppucInPointers[ tlsRECORD_POINTERS ] = { &pxSsl->in_ctr, &pxSsl->in_hdr, &pxSsl->in_len, &pxSsl->in_iv, &pxSsl->in_msg };
+    unsigned char * pucRecord = NULL;
+    size_t xHeaderLength = mbedtls_ssl_hdr_len( pxSsl );
+    size_t xRecordLength = 0;
+    size_t xPointer;
+    mbedtls_cipher_mode_t xMode = mbedtls_cipher_get_cipher_mode( &pxSsl->transform_in->cipher_ctx_dec );
+    int lResult;
+
+    lResult = ( int ) pxCtx->xNetworkRecvZeroCopy( pxCtx->pvCallerContext, &pucRecord );
+
+    if( 0 == lResult )
+    {
+        lResult = MBEDTLS_ERR_SSL_WANT_READ;
+    }
+    else if( 0 < lResult )
+    {
+        if( ( ( size_t ) lResult >= xHeaderLength ) &&
+            ( MBEDTLS_SSL_MSG_APPLICATION_DATA == pucRecord[ 0 ] ) &&
+            ( ( MBEDTLS_MODE_GCM == xMode ) || ( MBEDTLS_MODE_CCM == xMode ) ) )
+        {
+            xRecordLength = xHeaderLength + ( ( ( size_t ) pucRecord[ 3 ] << 8 ) | ( size_t ) pucRecord[ 4 ] );
+        }
+
+        if( ( 0 != xRecordLength ) &&
+            ( ( size_t ) lResult >= xRecordLength ) &&
+            ( xRecordLength <= MBEDTLS_SSL_IN_BUFFER_LEN - pxCtx->xInOffsets[ tlsHEADER_POINTER ] ) )
+        {
+            lResult = prvAllocateRecordBuffers( pxCtx, pdFALSE );
+
+            if( 0 == lResult )
+            {
+                for( xPointer = tlsHEADER_POINTER; xPointer < tlsRECORD_POINTERS; xPointer++ )
+                {
+                    *ppucInPointers[ xPointer ] = pucRecord + ( pxCtx->xInOffsets[ xPointer ] - pxCtx->xInOffsets[ tlsHEADER_POINTER ] );
+                }
+
+                pxSsl->in_buf = pucRecord;
+                pxSsl->in_ctr = pxCtx->ucInCounter;
+                pxSsl->in_left = xRecordLength;
+                pxCtx->xInPlaceRecordLength = xRecordLength;
+                pxCtx->xBytesDecryptedInPlace += xRecordLength;
+            }
+        }
+        else
+        {
+            lResult = prvAllocateRecordBuffers( pxCtx, pdTRUE );
+        }
+    }
+
+    return lResult;
+}
+
+/**
+ * @brief Makes the record buffers ready for mbedtls_ssl_read().
+ *
+ * If the record buffers were freed, the next record is decrypted in the
+ * network buffer when the caller supplied the callbacks to do so.  Otherwise
+ * the first byte of the next record is read before they are allocated, so
+ * waiting for data on an idle connection does not allocate them.  The byte is
+ * then placed in the receive record buffer as if mbedTLS had read it.
+ *
+ * @param[in] pxCtx TLS context.
+ *
+ * @return Zero if the record buffers are ready, MBEDTLS_ERR_SSL_WANT_READ if
+ * no data was received, or another negative value on error.
+ */
+static int prvPrepareToReceive( TLSContext_t * pxCtx )
+{
+    mbedtls_ssl_context * pxSsl = &pxCtx->xMbedSslCtx;
+    unsigned char ucFirstByte = 0;
+    int lResult = 0;
+
+    if( ( pdTRUE == pxCtx->xRecordBuffersReleased ) &&
+        ( NULL == pxSsl->in_buf ) )
+    {
+        if( ( NULL != pxCtx->xNetworkRecvZeroCopy ) &&
+            ( NULL != pxCtx->xNetworkRecvRelease ) )
+        {
+            lResult = prvPrepareInPlaceRecord( pxCtx );
+        }
+        else
+        {
+            lResult = ( int ) pxCtx->xNetworkRecv( pxCtx->pvCallerContext, &ucFirstByte, 1 );
+
+            if( 1 == lResult )
+            {
+                pxCtx->xBytesCopied++;
+                lResult = prvAllocateRecordBuffers( pxCtx, pdTRUE );
+
+                if( 0 == lResult )
+                {
+                    pxSsl->in_hdr[ 0 ] = ucFirstByte;
+                    pxSsl->in_left = 1;
+                }
+            }
+            else if( 0 == lResult )
+            {
+                lResult = MBEDTLS_ERR_SSL_WANT_READ;
+            }
+        }
+    }
+
+    return lResult;
+}
+
 /**
  * @brief TLS internal context rundown helper routine.
  *
@@ -114,8 +527,15 @@ static void prvFreeContext( TLSContext_t * pxCtx )
 {
     if( NULL != pxCtx )
     {
-        /* Cleanup mbedTLS. */
-        mbedtls_ssl_close_notify( &pxCtx->xMbedSslCtx ); /*lint !e534 The error is already taken care of inside mbedtls_ssl_close_notify*/
+        /* Cleanup mbedTLS.  The record buffers are needed to send the close
+         * notification, and are then freed here because mbedTLS would assume
+         * the send record buffer is the size it allocated. */
+        if( 0 == prvAllocateRecordBuffers( pxCtx, pdFALSE ) )
+        {
+            mbedtls_ssl_close_notify( &pxCtx->xMbedSslCtx ); /*lint !e534 The error is already taken care of inside mbedtls_ssl_close_notify*/
+        }
+
+        prvFreeRecordBuffers( pxCtx );
         mbedtls_ssl_free( &pxCtx->xMbedSslCtx );
         mbedtls_ssl_config_free( &pxCtx->xMbedSslConfig );
 
@@ -151,6 +571,9 @@ static int prvNetworkSend( void * pvContext,
 /**
  * @brief Network receive callback shim.
  *
+ * While a record is decrypted in the network buffer, mbedTLS would read the
+ * next record over it, so reading is refused until the record is released.
+ *
  * @param[in] pvContext Caller context.
  * @param[out] pucReceiveBuffer Byte buffer to receive into.
  * @param[in] xReceiveLength Length of byte buffer for receive.
@@ -162,8 +585,19 @@ static int prvNetworkRecv( void * pvContext,
                            size_t xReceiveLength )
 {
     TLSContext_t * pxCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
+    int lResult = MBEDTLS_ERR_SSL_WANT_READ;
 
-    return ( int ) pxCtx->xNetworkRecv( pxCtx->pvCallerContext, pucReceiveBuffer, xReceiveLength );
+    if( 0 == pxCtx->xInPlaceRecordLength )
+    {
+        lResult = ( int ) pxCtx->xNetworkRecv( pxCtx->pvCallerContext, pucReceiveBuffer, xReceiveLength );
+
+        if( 0 < lResult )
+        {
+            pxCtx->xBytesCopied += ( size_t ) lResult;
+        }
+    }
+
+    return lResult;
 }
 
 /**
@@ -533,6 +967,8 @@ BaseType_t TLS_Init( void ** ppvContext,
         pxCtx->ulAlpnProtocolsCount = pxParams->ulAlpnProtocolsCount;
         pxCtx->xNetworkRecv = pxParams->pxNetworkRecv;
         pxCtx->xNetworkSend = pxParams->pxNetworkSend;
+        pxCtx->xNetworkRecvZeroCopy = pxParams->pxNetworkRecvZeroCopy;
+        pxCtx->xNetworkRecvRelease = pxParams->pxNetworkRecvRelease;
         pxCtx->pvCallerContext = pxParams->pvCallerContext;
 
         /* Get the function pointer list for the PKCS#11 module. */
@@ -677,12 +1113,37 @@ BaseType_t TLS_Connect( void * pvContext )
         mbedtls_debug_set_threshold( tlsDEBUG_VERBOSE );
     #endif
 
+    #ifdef tlsconfigCIPHERSUITES
+        if( 0 == xResult )
+        {
+            mbedtls_ssl_conf_ciphersuites( &pxCtx->xMbedSslConfig, lCiphersuites );
+        }
+    #endif
+
+    #if ( tlsconfigMAX_FRAGMENT_LENGTH != 0 )
+        if( 0 == xResult )
+        {
+            /* Ask the server to send smaller records. Records sent to the
+             * server are limited to this length whether or not it agrees. */
+            xResult = mbedtls_ssl_conf_max_frag_len( &pxCtx->xMbedSslConfig, tlsMAX_FRAGMENT_LENGTH_CODE );
+        }
+    #endif
+
     if( 0 == xResult )
     {
         /* Set the resulting protocol configuration. */
         xResult = mbedtls_ssl_setup( &pxCtx->xMbedSslCtx, &pxCtx->xMbedSslConfig );
     }
 
+    /* mbedTLS allocates full size record buffers for the handshake. */
+    if( 0 == xResult )
+    {
+        pxCtx->xRecordBuffersReleased = pdFALSE;
+        pxCtx->xOutBufferLength = MBEDTLS_SSL_OUT_BUFFER_LEN;
+        pxCtx->xRecordBufferBytes = MBEDTLS_SSL_IN_BUFFER_LEN + MBEDTLS_SSL_OUT_BUFFER_LEN;
+        pxCtx->xPeakRecordBufferBytes = pxCtx->xRecordBufferBytes;
+    }
+
     /* Set the hostname, if requested. */
     if( ( 0 == xResult ) && ( NULL != pxCtx->pcDestination ) )
     {
@@ -718,6 +1179,16 @@ BaseType_t TLS_Connect( void * pvContext )
     if( 0 == xResult )
     {
         pxCtx->xTLSHandshakeSuccessful = pdTRUE;
+
+        /* Records sent from now on carry no more than the maximum fragment
+         * length, so the send record buffer is allocated again at that size
+         * by the first TLS_Recv() or TLS_Send() call that needs it. */
+        if( pdTRUE == prvRecordBuffersIdle( pxCtx ) )
+        {
+            prvFreeRecordBuffers( pxCtx );
+            pxCtx->xOutBufferLength = MBEDTLS_SSL_OUT_BUFFER_LEN - MBEDTLS_SSL_OUT_CONTENT_LEN +
+                                      ( size_t ) mbedtls_ssl_get_max_out_record_payload( &pxCtx->xMbedSslCtx );
+        }
     }
 
     /* Free up allocated memory. */
@@ -741,9 +1212,22 @@ BaseType_t TLS_Recv( void * pvContext,
     {
         while( xRead < xReadLength )
         {
-            xResult = mbedtls_ssl_read( &pxCtx->xMbedSslCtx,
-                                        pucReadBuffer + xRead,
-                                        xReadLength - xRead );
+            /* A record decrypted in the network buffer is released once it
+             * is read, so the buffers are prepared for each record. */
+            xResult = prvPrepareToReceive( pxCtx );
+
+            if( 0 == xResult )
+            {
+                xResult = mbedtls_ssl_read( &pxCtx->xMbedSslCtx,
+                                            pucReadBuffer + xRead,
+                                            xReadLength - xRead );
+                prvFinishInPlaceRecord( pxCtx );
+            }
+            else if( MBEDTLS_ERR_SSL_WANT_READ == xResult )
+            {
+                /* No data received (and no error). */
+                xResult = 0;
+            }
 
             if( 0 < xResult )
             {
@@ -764,6 +1248,13 @@ BaseType_t TLS_Recv( void * pvContext,
                 break;
             }
         }
+
+        #if ( tlsconfigRELEASE_IDLE_RECORD_BUFFERS == 1 )
+            if( pdTRUE == pxCtx->xTLSHandshakeSuccessful )
+            {
+                prvReleaseIdleRecordBuffers( pxCtx );
+            }
+        #endif
     }
     else
     {
@@ -780,6 +1271,104 @@ BaseType_t TLS_Recv( void * pvContext,
 
 /*-----------------------------------------------------------*/
 
+BaseType_t TLS_RecvZeroCopy( void * pvContext,
+                             const unsigned char ** ppucData )
+{
+    BaseType_t xResult = 0;
+    TLSContext_t * pxCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
+    unsigned char ucUnused = 0;
+
+    if( ( NULL != pxCtx ) && ( NULL != ppucData ) && ( pdTRUE == pxCtx->xTLSHandshakeSuccessful ) )
+    {
+        *ppucData = NULL;
+
+        do
+        {
+            xResult = prvPrepareToReceive( pxCtx );
+
+            if( 0 == xResult )
+            {
+                /* Reading no bytes makes mbedTLS decrypt the next application
+                 * data record, if it has none pending, without copying any of
+                 * it out. */
+                xResult = mbedtls_ssl_read( &pxCtx->xMbedSslCtx, &ucUnused, 0 );
+                prvFinishInPlaceRecord( pxCtx );
+            }
+            else if( MBEDTLS_ERR_SSL_WANT_READ == xResult )
+            {
+                /* No data received (and no error). */
+                xResult = 0;
+            }
+        } while( MBEDTLS_ERR_SSL_WANT_READ == xResult );
+
+        if( 0 > xResult )
+        {
+            /* Hard error: invalidate the context. */
+            prvFreeContext( pxCtx );
+        }
+        else if( NULL != pxCtx->xMbedSslCtx.in_offt )
+        {
+            *ppucData = pxCtx->xMbedSslCtx.in_offt;
+            xResult = ( BaseType_t ) pxCtx->xMbedSslCtx.in_msglen;
+        }
+        else
+        {
+            #if ( tlsconfigRELEASE_IDLE_RECORD_BUFFERS == 1 )
+                prvReleaseIdleRecordBuffers( pxCtx );
+            #endif
+        }
+    }
+    else
+    {
+        xResult = MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+    }
+
+    return xResult;
+}
+
+/*-----------------------------------------------------------*/
+
+BaseType_t TLS_RecvRelease( void * pvContext,
+                            size_t xLength )
+{
+    BaseType_t xResult = 0;
+    TLSContext_t * pxCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
+    mbedtls_ssl_context * pxSsl;
+
+    if( ( NULL != pxCtx ) && ( pdTRUE == pxCtx->xTLSHandshakeSuccessful ) &&
+        ( NULL != pxCtx->xMbedSslCtx.in_offt ) && ( xLength <= pxCtx->xMbedSslCtx.in_msglen ) )
+    {
+        pxSsl = &pxCtx->xMbedSslCtx;
+
+        /* Consume the data as mbedtls_ssl_read() does when it copies it. */
+        pxSsl->in_msglen -= xLength;
+
+        if( 0 == pxSsl->in_msglen )
+        {
+            pxSsl->in_offt = NULL;
+            pxSsl->keep_current_message = 0;
+        }
+        else
+        {
+            pxSsl->in_offt += xLength;
+        }
+
+        prvFinishInPlaceRecord( pxCtx );
+
+        #if ( tlsconfigRELEASE_IDLE_RECORD_BUFFERS == 1 )
+            prvReleaseIdleRecordBuffers( pxCtx );
+        #endif
+    }
+    else
+    {
+        xResult = MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    return xResult;
+}
+
+/*-----------------------------------------------------------*/
+
 BaseType_t TLS_Send( void * pvContext,
                      const unsigned char * pucMsg,
                      size_t xMsgLength )
@@ -790,31 +1379,45 @@ BaseType_t TLS_Send( void * pvContext,
 
     if( ( NULL != pxCtx ) && ( pdTRUE == pxCtx->xTLSHandshakeSuccessful ) )
     {
-        while( xWritten < xMsgLength )
-        {
-            xResult = mbedtls_ssl_write( &pxCtx->xMbedSslCtx,
-                                         pucMsg + xWritten,
-                                         xMsgLength - xWritten );
+        /* If the record buffers cannot be allocated the connection is still
+         * usable, so the error is returned without invalidating the context. */
+        xResult = prvAllocateRecordBuffers( pxCtx, pdFALSE );
 
-            if( 0 < xResult )
-            {
-                /* Sent data, so update the tally and keep looping. */
-                xWritten += ( size_t ) xResult;
-            }
-            else if( 0 == xResult )
+        if( 0 == xResult )
+        {
+            while( xWritten < xMsgLength )
             {
-                /* No data sent (and no error). The secure sockets
-                 * API supports non-blocking send, so stop the loop but don't
-                 * flag an error. */
-                break;
+                xResult = mbedtls_ssl_write( &pxCtx->xMbedSslCtx,
+                                             pucMsg + xWritten,
+                                             xMsgLength - xWritten );
+
+                if( 0 < xResult )
+                {
+                    /* Sent data, so update the tally and keep looping. */
+                    xWritten += ( size_t ) xResult;
+                }
+                else if( 0 == xResult )
+                {
+                    /* No data sent (and no error). The secure sockets
+                     * API supports non-blocking send, so stop the loop but don't
+                     * flag an error. */
+                    break;
+                }
+                else if( MBEDTLS_ERR_SSL_WANT_WRITE != xResult )
+                {
+                    /* Hard error: invalidate the context and stop. */
+                    prvFreeContext( pxCtx );
+                    break;
+                }
             }
-            else if( MBEDTLS_ERR_SSL_WANT_WRITE != xResult )
+        }
+
+        #if ( tlsconfigRELEASE_IDLE_RECORD_BUFFERS == 1 )
+            if( pdTRUE == pxCtx->xTLSHandshakeSuccessful )
             {
-                /* Hard error: invalidate the context and stop. */
-                prvFreeContext( pxCtx );
-                break;
+                prvReleaseIdleRecordBuffers( pxCtx );
             }
-        }
+        #endif
     }
     else
     {
@@ -831,6 +1434,37 @@ BaseType_t TLS_Send( void * pvContext,
 
 /*-----------------------------------------------------------*/
 
+BaseType_t TLS_GetMemoryStats( void * pvContext,
+                               TLSMemoryStats_t * pxStats )
+{
+    BaseType_t xResult = 0;
+    TLSContext_t * pxCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
+
+    if( ( NULL != pxCtx ) && ( NULL != pxStats ) )
+    {
+        pxStats->xContextBytes = sizeof( TLSContext_t );
+        pxStats->xRecordBufferBytes = pxCtx->xRecordBufferBytes;
+        pxStats->xPeakRecordBufferBytes = pxCtx->xPeakRecordBufferBytes;
+        pxStats->xMaxFragmentLength = 0;
+
+        if( 0 != pxCtx->xOutBufferLength )
+        {
+            pxStats->xMaxFragmentLength = pxCtx->xOutBufferLength - ( MBEDTLS_SSL_OUT_BUFFER_LEN - MBEDTLS_SSL_OUT_CONTENT_LEN );
+        }
+        pxStats->ulRecordBufferReleases = pxCtx->ulRecordBufferReleases;
+        pxStats->xBytesDecryptedInPlace = pxCtx->xBytesDecryptedInPlace;
+        pxStats->xBytesCopied = pxCtx->xBytesCopied;
+    }
+    else
+    {
+        xResult = MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    return xResult;
+}
+
+/*-----------------------------------------------------------*/
+
 void TLS_Cleanup( void * pvContext )
 {
     TLSContext_t * pxCtx = ( TLSContext_t * ) pvContext; /*lint !e9087 !e9079 Allow casting void* to other types. */
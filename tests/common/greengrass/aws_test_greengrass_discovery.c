@@ -25,6 +25,10 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "FreeRTOS.h"
+#include "task.h"
+#include "aws_ggd_config.h"
+#include "aws_ggd_config_defaults.h"
 #include "aws_greengrass_discovery.h"
 #include "aws_helper_secure_connect.h"
 #include "jsmn.h"
@@ -92,6 +96,7 @@ TEST_GROUP_RUNNER( Full_GGD )
     RUN_TEST_CASE( Full_GGD, GetCore );
     RUN_TEST_CASE( Full_GGD, prvIsIPvalid );
     RUN_TEST_CASE( Full_GGD, GetGGCIPandCertificate );
+    RUN_TEST_CASE( Full_GGD, GetGGCIPandCertificateFromCache );
 }
 
 TEST( Full_GGD, JSONRequestAbort )
@@ -219,6 +224,70 @@ TEST( Full_GGD, GetGGCIPandCertificate )
 }
 
 
+TEST( Full_GGD, GetGGCIPandCertificateFromCache )
+{
+    BaseType_t xStatus;
+    GGD_HostAddressData_t xHostAddressData;
+    uint32_t ulCertificateSize;
+    uint16_t usPort;
+    TickType_t xDiscoveryTime;
+    TickType_t xCachedTime;
+    uint32_t ulBufferSize = testrunnerBUFFER_SIZE;
+
+    if( TEST_PROTECT() )
+    {
+        /** @brief Check a second call connects to the same core without discovery,
+         * and report the latency of both.
+         *  @{
+         */
+        GGD_DiscoveryCacheInvalidate();
+
+        xDiscoveryTime = xTaskGetTickCount();
+        xStatus = GGD_GetGGCIPandCertificate( cBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                              ulBufferSize,
+                                              &xHostAddressData );
+        xDiscoveryTime = xTaskGetTickCount() - xDiscoveryTime;
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+
+        ulCertificateSize = xHostAddressData.ulCertificateSize;
+        usPort = xHostAddressData.usPort;
+
+        xCachedTime = xTaskGetTickCount();
+        xStatus = GGD_GetGGCIPandCertificate( cBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                              ulBufferSize,
+                                              &xHostAddressData );
+        xCachedTime = xTaskGetTickCount() - xCachedTime;
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+        TEST_ASSERT_EQUAL_UINT32( ulCertificateSize, xHostAddressData.ulCertificateSize );
+        TEST_ASSERT_EQUAL_UINT16( usPort, xHostAddressData.usPort );
+        TEST_ASSERT_EQUAL_INT8( '\0', xHostAddressData.pcCertificate[ ulCertificateSize - 1 ] );
+
+        #if ( ggdconfigENABLE_DISCOVERY_CACHE == 1 )
+            configPRINTF( ( "Greengrass core found in %u ms by discovery, %u ms from the cache.\r\n",
+                            ( unsigned int ) ( xDiscoveryTime * portTICK_PERIOD_MS ),
+                            ( unsigned int ) ( xCachedTime * portTICK_PERIOD_MS ) ) );
+            TEST_ASSERT_TRUE( xCachedTime <= xDiscoveryTime );
+        #else
+            ( void ) xDiscoveryTime;
+            ( void ) xCachedTime;
+        #endif
+        /** @}*/
+
+        /** @brief Check a buffer too small for the cached core fails.
+         *  @{
+         */
+        xStatus = GGD_GetGGCIPandCertificate( cBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                              ulCertificateSize - 1,
+                                              &xHostAddressData );
+        TEST_ASSERT_EQUAL_INT32( pdFAIL, xStatus );
+        /** @}*/
+    }
+    else
+    {
+        TEST_FAIL();
+    }
+}
+
 TEST( Full_GGD, GetIPandCertificateFromJSON )
 {
     uint32_t ulJSONFileSize = strlen( cJSON_FILE );
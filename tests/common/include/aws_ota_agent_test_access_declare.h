@@ -45,10 +45,30 @@ IngestResult_t TEST_OTA_prvIngestDataBlock( OTA_FileContext_t * C,
 OTA_FileContext_t * TEST_OTA_prvParseJobDoc( const char * pacRawMsg,
                                              u32 iMsgLen );
 
+OTA_FileContext_t * TEST_OTA_prvProcessOTAJobMsg( const char * pcRawMsg,
+                                                  uint32_t ulMsgLen );
+
 bool_t TEST_OTA_prvOTA_Close( OTA_FileContext_t * const C );
 
 DocParseErr_t TEST_OTA_prvParseJSONbyModel( const char * pcJSON,
                                             uint32_t ulMsgLen,
                                             JSON_DocModel_t * pxDocModel );
 
+DocParseErr_t TEST_OTA_prvBuildDocKeyTable( const JSON_DocParam_t * pxBodyDef,
+                                            uint16_t usNumParams,
+                                            JSON_DocKeyTable_t * pxKeyTable );
+
+/* Only defined when otaconfigENABLE_HTTP_DATA_PLANE is 1. */
+
+BaseType_t TEST_OTA_prvWriteHTTPBody( OTA_FileContext_t * C,
+                                      uint32_t ulOffset,
+                                      const uint8_t * pucData,
+                                      uint32_t ulLength,
+                                      IngestResult_t * peResult );
+
+IngestResult_t TEST_OTA_prvFetchFileBlocksHTTP( OTA_FileContext_t * C,
+                                                OTA_Err_t * pxCloseResult );
+
+OTA_Err_t TEST_OTA_prvRetryHTTPTransfer( OTA_FileContext_t * C );
+
 #endif /* ifndef _AWS_OTA_AGENT_TEST_ACCESS_DECLARE_H_ */
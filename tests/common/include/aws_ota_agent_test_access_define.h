@@ -54,6 +54,14 @@ OTA_FileContext_t * TEST_OTA_prvParseJobDoc( const char * pacRawMsg,
 
 /*-----------------------------------------------------------*/
 
+OTA_FileContext_t * TEST_OTA_prvProcessOTAJobMsg( const char * pcRawMsg,
+                                                  uint32_t ulMsgLen )
+{
+    return prvProcessOTAJobMsg( pcRawMsg, ulMsgLen );
+}
+
+/*-----------------------------------------------------------*/
+
 bool_t TEST_OTA_prvOTA_Close( OTA_FileContext_t * const C )
 {
     return prvOTA_Close( C );
@@ -68,4 +76,51 @@ DocParseErr_t TEST_OTA_prvParseJSONbyModel( const char * pcJSON,
     return prvParseJSONbyModel( pcJSON, ulMsgLen, pxDocModel );
 }
 
+/*-----------------------------------------------------------*/
+
+DocParseErr_t TEST_OTA_prvBuildDocKeyTable( const JSON_DocParam_t * pxBodyDef,
+                                            uint16_t usNumParams,
+                                            JSON_DocKeyTable_t * pxKeyTable )
+{
+    return prvBuildDocKeyTable( pxBodyDef, usNumParams, pxKeyTable );
+}
+
+#if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 )
+
+/*-----------------------------------------------------------*/
+
+    BaseType_t TEST_OTA_prvWriteHTTPBody( OTA_FileContext_t * C,
+                                          uint32_t ulOffset,
+                                          const uint8_t * pucData,
+                                          uint32_t ulLength,
+                                          IngestResult_t * peResult )
+    {
+        HTTP_BodyWriter_t xWriter;
+        BaseType_t xStatus;
+
+        xWriter.pxC = C;
+        xWriter.eResult = eIngest_Result_Accepted_Continue;
+        xStatus = prvWriteHTTPBody( &xWriter, ulOffset, pucData, ulLength );
+        *peResult = xWriter.eResult;
+
+        return xStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    IngestResult_t TEST_OTA_prvFetchFileBlocksHTTP( OTA_FileContext_t * C,
+                                                    OTA_Err_t * pxCloseResult )
+    {
+        return prvFetchFileBlocksHTTP( C, pxCloseResult );
+    }
+
+/*-----------------------------------------------------------*/
+
+    OTA_Err_t TEST_OTA_prvRetryHTTPTransfer( OTA_FileContext_t * C )
+    {
+        return prvRetryHTTPTransfer( C );
+    }
+
+#endif /* if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 ) */
+
 #endif /* _AWS_OTA_AGENT_TEST_ACCESS_DEFINE_H_ */
@@ -0,0 +1,62 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_ota_http_test_access_define.h
+ * @brief Function wrappers that access private methods in aws_ota_http.c.
+ *
+ * Needed for testing private functions.
+ */
+
+#ifndef _AWS_OTA_HTTP_TEST_ACCESS_DEFINE_H_
+#define _AWS_OTA_HTTP_TEST_ACCESS_DEFINE_H_
+
+/*-----------------------------------------------------------*/
+
+void TEST_OTA_HTTP_SetSocketIO( const OTA_HTTP_SocketIO_t * pxSocketIO )
+{
+    if( pxSocketIO != NULL )
+    {
+        xOTA_HTTP_SocketIO = *pxSocketIO;
+    }
+    else
+    {
+        xOTA_HTTP_SocketIO.pxOpen = prvOpenSocket;
+        xOTA_HTTP_SocketIO.pxSend = SOCKETS_Send;
+        xOTA_HTTP_SocketIO.pxRecv = SOCKETS_Recv;
+        xOTA_HTTP_SocketIO.pxClose = prvCloseSocket;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+BaseType_t TEST_OTA_HTTP_prvParseResponseHeader( const char * pcHeader,
+                                                 uint32_t ulHeaderLen,
+                                                 OTA_HTTP_Response_t * pxResponse )
+{
+    return prvParseResponseHeader( pcHeader, ulHeaderLen, pxResponse );
+}
+
+#endif /* _AWS_OTA_HTTP_TEST_ACCESS_DEFINE_H_ */
@@ -67,6 +67,15 @@ extern unsigned int xHeapBefore;
  */
 extern unsigned int xHeapAfter;
 
+#if ( configUSE_HEAP_PROFILER == 1 )
+
+/**
+ * @brief Heap profiler snapshot taken before tests are run, used to list the
+ * blocks that were not freed by the tests.
+ */
+    extern HeapProfilerSnapshot_t xHeapSnapshotBefore;
+#endif
+
 
 /**
  * @brief Runs all the tests.
@@ -40,6 +40,20 @@
 
 #define memoryleakPRINTF( x )    vLoggingPrintf x
 
+#if ( configUSE_HEAP_PROFILER == 1 )
+
+/*
+ * Prints a line of the heap profiler's dump of the blocks not freed by the
+ * tests, which can be analysed with tools/heap_profiler/heap_report.py.
+ */
+    static void prvPrintHeapProfilerLine( const char * pcLine,
+                                          void * pvContext )
+    {
+        ( void ) pvContext;
+        memoryleakPRINTF( ( "%s\r\n", pcLine ) );
+    }
+#endif
+
 TEST_GROUP( Full_MemoryLeak );
 TEST_SETUP( Full_MemoryLeak )
 {
@@ -66,6 +80,13 @@ TEST( Full_MemoryLeak, CheckHeap )
                         xHeapAfter,
                         xHeapChange ) );
 
+    #if ( configUSE_HEAP_PROFILER == 1 )
+        if( xHeapChange != 0 )
+        {
+            vHeapProfilerDump( &xHeapSnapshotBefore, prvPrintHeapProfilerLine, NULL );
+        }
+    #endif
+
     TEST_ASSERT_EQUAL_INT32_MESSAGE( 0,
                                      xHeapChange,
                                      "Free heap before and after tests was not the same." );
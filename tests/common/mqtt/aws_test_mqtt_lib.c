@@ -90,6 +90,7 @@ typedef struct CallbackCounter
     uint32_t ulConnACK;           /**< Number of times the callback is invoked for CONNACK message. */
     uint32_t ulUnexpectedConnACK; /**< Number of times the callback is invoked for unexpected CONNACK messages. */
     uint32_t ulDisconnect;        /**< Number of times the callback is invoked for disconnect message. */
+    uint32_t ulRxTimeout;         /**< Number of those disconnects because the rest of a partially received packet did not arrive. */
     uint32_t ulUnidentified;      /**< Number of times the callback is invoked for un-handled events. */
 } CallbackCounter_t;
 /*-----------------------------------------------------------*/
@@ -206,6 +207,11 @@ static MQTTBool_t prvMQTTEventCallback( void * pvCallbackContext,
         case eMQTTClientDisconnected:
             xCallbackCounter.ulDisconnect += 1;
 
+            if( pxParams->u.xDisconnectData.xDisconnectReason == eMQTTDisconnectReasonRxTimeout )
+            {
+                xCallbackCounter.ulRxTimeout += 1;
+            }
+
             break;
 
         case eMQTTUnexpectedConnACK:
@@ -254,6 +260,7 @@ static void prvInitializeCallbackCounter( void )
     xCallbackCounter.ulConnACK = 0;
     xCallbackCounter.ulUnexpectedConnACK = 0;
     xCallbackCounter.ulDisconnect = 0;
+    xCallbackCounter.ulRxTimeout = 0;
     xCallbackCounter.ulUnidentified = 0;
 }
 /*-----------------------------------------------------------*/
@@ -381,6 +388,9 @@ TEST_GROUP_RUNNER( Full_MQTT )
     RUN_TEST_CASE( Full_MQTT, AFQP_MQTT_Connect_SecondConnectWhileAlreadyConnected );
     RUN_TEST_CASE( Full_MQTT, AFQP_MQTT_Connect_SecondConnectWhileWaitingForConnACK );
     RUN_TEST_CASE( Full_MQTT, AFQP_MQTT_Connect_NetworkSendFailed );
+
+    /* MQTT_ParseReceivedData tests. */
+    RUN_TEST_CASE( Full_MQTT, AFQP_MQTT_ParseReceivedData_PartialPacketTimeout );
 }
 /*-----------------------------------------------------------*/
 
@@ -1075,3 +1085,47 @@ TEST( Full_MQTT, AFQP_MQTT_Connect_NetworkSendFailed )
     TEST_ASSERT_EQUAL( 0, xCallbackCounter.ulUnidentified );
 }
 /*-----------------------------------------------------------*/
+
+/**
+ * @brief MQTT parse - The rest of a partially received packet never arrives.
+ */
+TEST( Full_MQTT, AFQP_MQTT_ParseReceivedData_PartialPacketTimeout )
+{
+    MQTTReturnCode_t xReturnCode;
+    static const uint8_t ucPartialConnACKMessage[] =
+    {
+        mqttCONTROL_CONNACK | mqttFLAGS_CONNACK, /* Fixed header control packet type. */
+        2,                                       /* Fixed header remaining length - always 2 for CONNACK. */
+        0                                        /* Bit 0 is SP - Session Present. The return code never arrives. */
+    };
+
+    /* Connect. */
+    xReturnCode = prvSendMQTTConnect();
+    TEST_ASSERT_EQUAL( eMQTTSuccess, xReturnCode );
+    xReturnCode = prvReceiveMQTTConnACK();
+    TEST_ASSERT_EQUAL( eMQTTSuccess, xReturnCode );
+    TEST_ASSERT_EQUAL( eMQTTConnected, xMQTTContext.xConnectionState );
+
+    /* Receive part of a packet. */
+    xReturnCode = MQTT_ParseReceivedData( &( xMQTTContext ), ucPartialConnACKMessage, sizeof( ucPartialConnACKMessage ) );
+    TEST_ASSERT_EQUAL( eMQTTSuccess, xReturnCode );
+
+    /* No get ticks function is registered, so the timeout starts from the
+     * first call to MQTT_Periodic. */
+    ( void ) MQTT_Periodic( &( xMQTTContext ), 1 );
+
+    /* One tick before the timeout the client must still be connected. */
+    ( void ) MQTT_Periodic( &( xMQTTContext ), mqttconfigRX_PARTIAL_MESSAGE_TIMEOUT_TICKS );
+    TEST_ASSERT_EQUAL( eMQTTConnected, xMQTTContext.xConnectionState );
+    TEST_ASSERT_EQUAL( 0, xCallbackCounter.ulDisconnect );
+
+    /* Once the timeout expires the client must be disconnected. */
+    ( void ) MQTT_Periodic( &( xMQTTContext ), mqttconfigRX_PARTIAL_MESSAGE_TIMEOUT_TICKS + 1 );
+    TEST_ASSERT_EQUAL( eMQTTNotConnected, xMQTTContext.xConnectionState );
+    TEST_ASSERT_EQUAL( 1, xCallbackCounter.ulDisconnect );
+    TEST_ASSERT_EQUAL( 1, xCallbackCounter.ulRxTimeout );
+
+    /* No other callback must have been invoked. */
+    TEST_ASSERT_EQUAL( 0, xCallbackCounter.ulUnidentified );
+}
+/*-----------------------------------------------------------*/
@@ -35,6 +35,8 @@
 #include "jsmn.h"
 #include "aws_ota_agent_test_access_declare.h"
 #include "aws_ota_agent.h"
+#include "aws_ota_agent_config.h"
+#include "aws_ota_agent_config_defaults.h"
 #include "aws_clientcredential.h"
 #include "aws_ota_agent_internal.h"
 
@@ -57,6 +59,7 @@
 #define otatestFILE_PATH                  "payload.bin"
 #define otatestCERT_FILE                  "rsasigner.crt"
 #define otatestATTRIBUTES                 3
+#define otatestUPDATE_DATA_URL            "https://ota.example.com/payload.bin"
 #define otatestFILE_ID                    0
 static const uint8_t ucOtatestSIGNATURE[] =
 {
@@ -108,6 +111,25 @@ static const uint8_t ucOtatestSIGNATURE[] =
  */
 #define otatestLASER_JSON_WITH_SELF_TEST         "{\"clientToken\":\"mytoken\",\"timestamp\":1508445004,\"execution\":{\"self_test\":\"true\",\"jobId\":\"15\",\"status\":\"QUEUED\",\"queuedAt\":1507697924,\"lastUpdatedAt\":1507697924,\"versionNumber\":1,\"executionNumber\":1,\"jobDocument\":{\"afr_ota\": {\"streamname\": \"1\",\"files\": [{\"filepath\": \"payload.bin\",\"version\":\"1.0.0.0\",\"filesize\": 90860,\"fileid\": 0,\"attr\": 3,\"certfile\":\"rsasigner.crt\", \"" otatestVALID_SIG_METHOD "\":\"OHj5sNjxqMNK3WNEwbyfs/PeSSS1kzLkAQ4MSu0yKNFoGxJrUKuIWhjQbQiPlXcDtXlSXE8ydAwoxnnw5lcwpJsbXxD1K1PwZJoc/3mv5XHXbvvEoFr4yA0rhY4tyrMDBesEtOVrW0yI4mM4Lde5OtdIxo8sjTSPGXo2Ejuhn+LDRD3gKdb1gtPpoJ/YBQmYKXHFQ5QW58GOSlB9prq5v+MloVCATjmzb9tu4msScXYYy41ikEhK2eyfl7/vpc2vMNX6uhyyeZhku9namI4OZmsp72tLL4D4pFt4/nDWYSAo8sQAwns1RNY+j52KfvgvKKN3u6G3suFyVQoxWJu3aA==\"}]}}}}"
 
+/**
+ * @brief Valid job document; the file is downloaded from an update data URL.
+ */
+#define otatestLASER_JSON_WITH_UPDATE_DATA_URL   "{\"clientToken\":\"mytoken\",\"timestamp\":1508445004,\"execution\":{\"jobId\":\"15\",\"status\":\"QUEUED\",\"queuedAt\":1507697924,\"lastUpdatedAt\":1507697924,\"versionNumber\":1,\"executionNumber\":1,\"jobDocument\":{\"afr_ota\": {\"streamname\": \"1\",\"files\": [{\"filepath\": \"payload.bin\",\"version\":\"1.0.0.0\",\"filesize\": 90860,\"fileid\": 0,\"attr\": 3,\"certfile\":\"rsasigner.crt\",\"update_data_url\":\"" otatestUPDATE_DATA_URL "\", \"" otatestVALID_SIG_METHOD "\":\"OHj5sNjxqMNK3WNEwbyfs/PeSSS1kzLkAQ4MSu0yKNFoGxJrUKuIWhjQbQiPlXcDtXlSXE8ydAwoxnnw5lcwpJsbXxD1K1PwZJoc/3mv5XHXbvvEoFr4yA0rhY4tyrMDBesEtOVrW0yI4mM4Lde5OtdIxo8sjTSPGXo2Ejuhn+LDRD3gKdb1gtPpoJ/YBQmYKXHFQ5QW58GOSlB9prq5v+MloVCATjmzb9tu4msScXYYy41ikEhK2eyfl7/vpc2vMNX6uhyyeZhku9namI4OZmsp72tLL4D4pFt4/nDWYSAo8sQAwns1RNY+j52KfvgvKKN3u6G3suFyVQoxWJu3aA==\"}]}}}}"
+
+/**
+ * @brief Don't store a parameter of the test document model; only note that it was received.
+ */
+#define otatestDONT_STORE_PARAM                  0xffffffffUL
+
+/**
+ * @brief Document model used to test the parser on small documents. Only "a" is required.
+ */
+static const JSON_DocParam_t xOtatestModelParams[] =
+{
+    { "a", ( bool_t ) pdTRUE,  { otatestDONT_STORE_PARAM }, eModelParamType_UInt32, JSMN_PRIMITIVE },
+    { "b", ( bool_t ) pdFALSE, { otatestDONT_STORE_PARAM }, eModelParamType_UInt32, JSMN_PRIMITIVE }
+};
+
 /**
  * @brief Shared MQTT client handle, used across setup, tests, and teardown.
  * But only used by one test at a time. */
@@ -120,6 +142,51 @@ static void vOTACompleteCallback( OTA_JobEvent_t eResult )
 {
 }
 
+/**
+ * @brief Parse pcJSON with the test document model, returning the bitmap of the
+ * parameters found in pulReceived.
+ */
+static DocParseErr_t prvParseWithTestModel( const char * pcJSON,
+                                            uint32_t * pulReceived )
+{
+    JSON_DocModel_t xDocModel = { 0 };
+    DocParseErr_t eErr;
+
+    xDocModel.pxBodyDef = xOtatestModelParams;
+    xDocModel.usNumModelParams = sizeof( xOtatestModelParams ) / sizeof( xOtatestModelParams[ 0 ] );
+    xDocModel.ulParamsRequiredBitmap = 1U;
+
+    eErr = TEST_OTA_prvParseJSONbyModel( pcJSON, strlen( pcJSON ), &xDocModel );
+    *pulReceived = xDocModel.ulParamsReceivedBitmap;
+
+    return eErr;
+}
+
+/**
+ * @brief Write a document to pcDoc whose unknown key "x" has ulArrays nested
+ * arrays as its value, followed by the required key "a".
+ */
+static void prvMakeNestedDoc( char * pcDoc,
+                              uint32_t ulArrays )
+{
+    uint32_t ulIndex;
+
+    strcpy( pcDoc, "{\"x\":" );
+    pcDoc += strlen( pcDoc );
+
+    for( ulIndex = 0U; ulIndex < ulArrays; ulIndex++ )
+    {
+        *pcDoc++ = '[';
+    }
+
+    for( ulIndex = 0U; ulIndex < ulArrays; ulIndex++ )
+    {
+        *pcDoc++ = ']';
+    }
+
+    strcpy( pcDoc, ",\"a\":1}" );
+}
+
 /**
  * @brief Test group definition.
  */
@@ -176,6 +243,8 @@ TEST_GROUP_RUNNER( Full_OTA_AGENT )
     RUN_TEST_CASE( Full_OTA_AGENT, OTA_SetImageState_InvalidParams );
     RUN_TEST_CASE( Full_OTA_AGENT, prvParseJobDocFromJSONandPrvOTA_Close );
     RUN_TEST_CASE( Full_OTA_AGENT, prvParseJSONbyModel_Errors );
+    RUN_TEST_CASE( Full_OTA_AGENT, prvBuildDocKeyTable );
+    RUN_TEST_CASE( Full_OTA_AGENT, prvParseJSONbyModel_SkipAndNesting );
 }
 
 TEST( Full_OTA_AGENT, OTA_SetImageState_InvalidParams )
@@ -273,6 +342,32 @@ TEST( Full_OTA_AGENT, prvParseJobDocFromJSONandPrvOTA_Close )
 
     /* End test. */
 
+    /* Test that the update data URL of a file is kept when the file can be
+     * downloaded over HTTP, and ignored otherwise.
+     * Start test.
+     */
+    if( TEST_PROTECT() )
+    {
+        pxUpdateFile = TEST_OTA_prvParseJobDoc( otatestLASER_JSON_WITH_UPDATE_DATA_URL, sizeof( otatestLASER_JSON_WITH_UPDATE_DATA_URL ) );
+        TEST_ASSERT_TRUE( pxUpdateFile != NULL );
+        TEST_ASSERT_EQUAL_STRING( otatestSTREAM_NAME, pxUpdateFile->pucStreamName );
+        TEST_ASSERT_EQUAL( otatestFILE_SIZE, pxUpdateFile->ulFileSize );
+
+        #if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 )
+            TEST_ASSERT_EQUAL_STRING( otatestUPDATE_DATA_URL, pxUpdateFile->pucUpdateDataURL );
+        #else
+            TEST_ASSERT_TRUE( pxUpdateFile->pucUpdateDataURL == NULL );
+        #endif
+    }
+
+    if( pxUpdateFile != NULL )
+    {
+        TEST_OTA_prvOTA_Close( pxUpdateFile );
+        pxUpdateFile = NULL;
+    }
+
+    /* End test. */
+
     /* Test that null is returned if JSON file with incorrect length is passed in parameter.
      * Start test.
      */
@@ -339,6 +434,16 @@ TEST( Full_OTA_AGENT, prvParseJSONbyModel_Errors )
     TEST_ASSERT_EQUAL( eDocParseErr_NoTokens, TEST_OTA_prvParseJSONbyModel( otatestLASER_JSON,
                                                                             0,
                                                                             &xDocModel ) );
+    TEST_ASSERT_EQUAL( eDocParseErr_InvalidSyntax,
+                       TEST_OTA_prvParseJSONbyModel( otatestLASER_JSON,
+                                                     sizeof( otatestLASER_JSON ) / 2,
+                                                     &xDocModel ) );
+
+    /* Ensure a model without a key table still walks the whole document. */
+    TEST_ASSERT_EQUAL( eDocParseErr_None,
+                       TEST_OTA_prvParseJSONbyModel( otatestLASER_JSON,
+                                                     sizeof( otatestLASER_JSON ),
+                                                     &xDocModel ) );
 
     /* Ensure usNumModelParams is rejected if too large. */
     xDocModel.usNumModelParams = ( uint16_t ) ( 0xffffU );
@@ -373,3 +478,82 @@ TEST( Full_OTA_AGENT, prvParseJSONbyModel_Errors )
     /* Shut down the OTA Agent. */
     ( void ) OTA_AgentShutdown( pdMS_TO_TICKS( otatestSHUTDOWN_WAIT ) );
 }
+
+TEST( Full_OTA_AGENT, prvBuildDocKeyTable )
+{
+    JSON_DocKeyTable_t xKeyTable;
+    uint32_t ulSlot, ulUsed = 0U, ulFound = 0U;
+
+    static const JSON_DocParam_t xDuplicateParams[] =
+    {
+        { "a", ( bool_t ) pdTRUE,  { otatestDONT_STORE_PARAM }, eModelParamType_UInt32, JSMN_PRIMITIVE },
+        { "b", ( bool_t ) pdFALSE, { otatestDONT_STORE_PARAM }, eModelParamType_UInt32, JSMN_PRIMITIVE },
+        { "a", ( bool_t ) pdFALSE, { otatestDONT_STORE_PARAM }, eModelParamType_UInt32, JSMN_PRIMITIVE }
+    };
+
+    /* Ensure each key of a model gets its own slot. */
+    TEST_ASSERT_EQUAL( eDocParseErr_None,
+                       TEST_OTA_prvBuildDocKeyTable( xOtatestModelParams,
+                                                     sizeof( xOtatestModelParams ) / sizeof( xOtatestModelParams[ 0 ] ),
+                                                     &xKeyTable ) );
+
+    for( ulSlot = 0U; ulSlot < OTA_DOC_KEY_TABLE_SIZE; ulSlot++ )
+    {
+        if( xKeyTable.ucParamIndex[ ulSlot ] != 0U )
+        {
+            ulUsed++;
+            ulFound |= 1UL << ( xKeyTable.ucParamIndex[ ulSlot ] - 1U );
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32( 2U, ulUsed );
+    TEST_ASSERT_EQUAL_UINT32( 3U, ulFound );
+
+    /* Ensure a model with a duplicate key is rejected, as the two copies share a
+     * slot whatever the seed. */
+    TEST_ASSERT_EQUAL( eDocParseErr_NoPerfectHash,
+                       TEST_OTA_prvBuildDocKeyTable( xDuplicateParams,
+                                                     sizeof( xDuplicateParams ) / sizeof( xDuplicateParams[ 0 ] ),
+                                                     &xKeyTable ) );
+}
+
+TEST( Full_OTA_AGENT, prvParseJSONbyModel_SkipAndNesting )
+{
+    char cDoc[ ( 2 * OTA_MAX_JSON_DEPTH ) + 16 ];
+    uint32_t ulReceived;
+
+    /* Ensure keys nested within the value of an unknown key are skipped, even if
+     * they match the model. */
+    TEST_ASSERT_EQUAL( eDocParseErr_None,
+                       prvParseWithTestModel( "{\"x\":{\"a\":1,\"b\":[{\"a\":2},[]],\"c\":{}},\"a\":3}", &ulReceived ) );
+    TEST_ASSERT_EQUAL_UINT32( 1U, ulReceived );
+    TEST_ASSERT_EQUAL( eDocParseErr_MalformedDoc,
+                       prvParseWithTestModel( "{\"x\":{\"a\":1},\"b\":2}", &ulReceived ) );
+    TEST_ASSERT_EQUAL_UINT32( 2U, ulReceived );
+
+    /* Ensure a key of the model may only appear once. */
+    TEST_ASSERT_EQUAL( eDocParseErr_DuplicatesNotAllowed,
+                       prvParseWithTestModel( "{\"a\":1,\"b\":2,\"a\":3}", &ulReceived ) );
+
+    /* Ensure trailing commas and mismatched brackets are rejected, whether or not
+     * the value is skipped. */
+    TEST_ASSERT_EQUAL( eDocParseErr_InvalidSyntax,
+                       prvParseWithTestModel( "{\"a\":1,}", &ulReceived ) );
+    TEST_ASSERT_EQUAL( eDocParseErr_InvalidSyntax,
+                       prvParseWithTestModel( "{\"x\":[1,2,],\"a\":1}", &ulReceived ) );
+    TEST_ASSERT_EQUAL( eDocParseErr_InvalidSyntax,
+                       prvParseWithTestModel( "{\"x\":{\"y\":1,},\"a\":1}", &ulReceived ) );
+    TEST_ASSERT_EQUAL( eDocParseErr_InvalidSyntax,
+                       prvParseWithTestModel( "{\"x\":[1,2},\"a\":1}", &ulReceived ) );
+    TEST_ASSERT_EQUAL( eDocParseErr_InvalidSyntax,
+                       prvParseWithTestModel( "{\"x\":{\"y\":1]},\"a\":1}", &ulReceived ) );
+    TEST_ASSERT_EQUAL( eDocParseErr_InvalidSyntax,
+                       prvParseWithTestModel( "{\"x\":{\"y\" 1},\"a\":1}", &ulReceived ) );
+
+    /* Ensure the document may be nested as deeply as OTA_MAX_JSON_DEPTH but no
+     * deeper. The document itself and the object holding "x" are two levels. */
+    prvMakeNestedDoc( cDoc, OTA_MAX_JSON_DEPTH - 2U );
+    TEST_ASSERT_EQUAL( eDocParseErr_None, prvParseWithTestModel( cDoc, &ulReceived ) );
+    prvMakeNestedDoc( cDoc, OTA_MAX_JSON_DEPTH - 1U );
+    TEST_ASSERT_EQUAL( eDocParseErr_InvalidSyntax, prvParseWithTestModel( cDoc, &ulReceived ) );
+}
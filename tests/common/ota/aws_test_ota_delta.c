@@ -0,0 +1,293 @@
+/*
+ * Amazon FreeRTOS OTA AFQP V1.1.4
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+#include "unity_fixture.h"
+#include "unity.h"
+#include "aws_ota_agent.h"
+#include "aws_ota_agent_config.h"
+#include "aws_ota_agent_config_defaults.h"
+#include "aws_ota_delta.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define otatestDELTA_BASE_SIZE     3000U
+#define otatestDELTA_IMAGE_SIZE    ( 2 * otaconfigDELTA_WINDOW_SIZE + 1000U )
+#define otatestDELTA_INSERT_SIZE   ( otaconfigDELTA_WINDOW_SIZE + 100U )
+#define otatestDELTA_PATCH_MAX     ( 100U + otatestDELTA_INSERT_SIZE )
+
+/**
+ * @brief The base image, the image rebuilt from it and the patch between them.
+ */
+static uint8_t ucBaseImage[ otatestDELTA_BASE_SIZE ];
+static uint8_t ucNewImage[ otatestDELTA_IMAGE_SIZE ];
+static uint8_t ucExpectedImage[ otatestDELTA_IMAGE_SIZE ];
+static uint8_t ucPatch[ otatestDELTA_PATCH_MAX ];
+static uint32_t ulPatchSize;
+static uint32_t ulLargestWrite;
+
+/*-----------------------------------------------------------*/
+
+static int32_t prvReadBase( void * pvContext,
+                            uint32_t ulOffset,
+                            uint8_t * pucData,
+                            uint32_t ulLength )
+{
+    ( void ) pvContext;
+    TEST_ASSERT_TRUE( ( ulOffset + ulLength ) <= sizeof( ucBaseImage ) );
+    memcpy( pucData, &ucBaseImage[ ulOffset ], ulLength );
+
+    return ( int32_t ) ulLength;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t prvWriteImage( void * pvContext,
+                              uint32_t ulOffset,
+                              uint8_t * pucData,
+                              uint32_t ulLength )
+{
+    ( void ) pvContext;
+    TEST_ASSERT_TRUE( ( ulOffset + ulLength ) <= sizeof( ucNewImage ) );
+    memcpy( &ucNewImage[ ulOffset ], pucData, ulLength );
+
+    if( ulLength > ulLargestWrite )
+    {
+        ulLargestWrite = ulLength;
+    }
+
+    return ( int32_t ) ulLength;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvPutUInt32( uint32_t ulValue )
+{
+    ucPatch[ ulPatchSize++ ] = ( uint8_t ) ulValue;
+    ucPatch[ ulPatchSize++ ] = ( uint8_t ) ( ulValue >> 8 );
+    ucPatch[ ulPatchSize++ ] = ( uint8_t ) ( ulValue >> 16 );
+    ucPatch[ ulPatchSize++ ] = ( uint8_t ) ( ulValue >> 24 );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvPutCopy( uint32_t ulLength,
+                        uint32_t ulBaseOffset )
+{
+    ucPatch[ ulPatchSize++ ] = 0U;
+    prvPutUInt32( ulLength );
+    prvPutUInt32( ulBaseOffset );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvPutInsert( const uint8_t * pucData,
+                          uint32_t ulLength )
+{
+    ucPatch[ ulPatchSize++ ] = 1U;
+    prvPutUInt32( ulLength );
+    memcpy( &ucPatch[ ulPatchSize ], pucData, ulLength );
+    ulPatchSize += ulLength;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Make a patch that moves part of the base image, inserts new bytes
+ * and copies the start of the base image to the end of the new one.
+ */
+static void prvMakePatch( void )
+{
+    uint32_t ulCopySize = otatestDELTA_IMAGE_SIZE - otatestDELTA_INSERT_SIZE - 300U;
+
+    ulPatchSize = 0U;
+    prvPutUInt32( OTA_DELTA_MAGIC );
+    prvPutUInt32( otatestDELTA_BASE_SIZE );
+    prvPutUInt32( otatestDELTA_IMAGE_SIZE );
+
+    prvPutCopy( ulCopySize, 100U );
+    memcpy( ucExpectedImage, &ucBaseImage[ 100 ], ulCopySize );
+
+    prvPutInsert( &ucExpectedImage[ ulCopySize ], otatestDELTA_INSERT_SIZE );
+
+    prvPutCopy( 300U, 0U );
+    memcpy( &ucExpectedImage[ ulCopySize + otatestDELTA_INSERT_SIZE ], ucBaseImage, 300U );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Apply the patch in pieces of ulPieceSize bytes.
+ */
+static OTA_DeltaResult_t prvApplyInPieces( OTA_DeltaPatch_t * pxPatch,
+                                           uint32_t ulPieceSize )
+{
+    OTA_DeltaResult_t eResult = eDelta_Applied;
+    uint32_t ulOffset;
+    uint32_t ulLength;
+
+    for( ulOffset = 0U; ( ulOffset < ulPatchSize ) && ( eResult == eDelta_Applied ); ulOffset += ulLength )
+    {
+        ulLength = ( ( ulPatchSize - ulOffset ) < ulPieceSize ) ? ( ulPatchSize - ulOffset ) : ulPieceSize;
+        eResult = OTA_Delta_Apply( pxPatch, ulOffset, &ucPatch[ ulOffset ], ulLength );
+    }
+
+    return eResult;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_OTA_DELTA );
+
+TEST_SETUP( Full_OTA_DELTA )
+{
+    uint32_t ulIndex;
+
+    for( ulIndex = 0U; ulIndex < sizeof( ucBaseImage ); ulIndex++ )
+    {
+        ucBaseImage[ ulIndex ] = ( uint8_t ) ( ( ulIndex * 7U ) + ( ulIndex >> 8 ) );
+    }
+
+    for( ulIndex = 0U; ulIndex < sizeof( ucExpectedImage ); ulIndex++ )
+    {
+        ucExpectedImage[ ulIndex ] = ( uint8_t ) ( ulIndex * 13U );
+    }
+
+    memset( ucNewImage, 0, sizeof( ucNewImage ) );
+    ulLargestWrite = 0U;
+    prvMakePatch();
+}
+
+TEST_TEAR_DOWN( Full_OTA_DELTA )
+{
+}
+
+TEST_GROUP_RUNNER( Full_OTA_DELTA )
+{
+    RUN_TEST_CASE( Full_OTA_DELTA, OTA_Delta_RebuildsImage );
+    RUN_TEST_CASE( Full_OTA_DELTA, OTA_Delta_OutOfOrder );
+    RUN_TEST_CASE( Full_OTA_DELTA, OTA_Delta_BadPatches );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_OTA_DELTA, OTA_Delta_RebuildsImage )
+{
+    static const uint32_t ulPieceSizes[] = { 1U, 7U, 1024U, otatestDELTA_PATCH_MAX };
+    OTA_DeltaPatch_t * pxPatch;
+    uint32_t ulImageSize = 0U;
+    uint32_t ulIndex;
+
+    for( ulIndex = 0U; ulIndex < ( sizeof( ulPieceSizes ) / sizeof( ulPieceSizes[ 0 ] ) ); ulIndex++ )
+    {
+        memset( ucNewImage, 0, sizeof( ucNewImage ) );
+        pxPatch = OTA_Delta_Create( prvReadBase, prvWriteImage, NULL );
+        TEST_ASSERT_NOT_NULL( pxPatch );
+
+        TEST_ASSERT_EQUAL( eDelta_Applied, prvApplyInPieces( pxPatch, ulPieceSizes[ ulIndex ] ) );
+        TEST_ASSERT_EQUAL( eDelta_Applied, OTA_Delta_Finish( pxPatch, &ulImageSize ) );
+        TEST_ASSERT_EQUAL_UINT32( otatestDELTA_IMAGE_SIZE, ulImageSize );
+        TEST_ASSERT_EQUAL_UINT8_ARRAY( ucExpectedImage, ucNewImage, otatestDELTA_IMAGE_SIZE );
+
+        OTA_Delta_Delete( pxPatch );
+    }
+
+    /* The new image is written at most a window at a time. */
+    TEST_ASSERT_EQUAL_UINT32( otaconfigDELTA_WINDOW_SIZE, ulLargestWrite );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_OTA_DELTA, OTA_Delta_OutOfOrder )
+{
+    OTA_DeltaPatch_t * pxPatch;
+    uint32_t ulImageSize = 0U;
+
+    pxPatch = OTA_Delta_Create( prvReadBase, prvWriteImage, NULL );
+    TEST_ASSERT_NOT_NULL( pxPatch );
+
+    /* Data past where the patch has got to isn't used. */
+    TEST_ASSERT_EQUAL( eDelta_Applied, OTA_Delta_Apply( pxPatch, 0U, ucPatch, 20U ) );
+    TEST_ASSERT_EQUAL( eDelta_OutOfOrder, OTA_Delta_Apply( pxPatch, 40U, &ucPatch[ 40 ], 20U ) );
+
+    /* Data that has already been used, in full or in part, is skipped. */
+    TEST_ASSERT_EQUAL( eDelta_Applied, OTA_Delta_Apply( pxPatch, 0U, ucPatch, 10U ) );
+    TEST_ASSERT_EQUAL( eDelta_Applied, OTA_Delta_Apply( pxPatch, 10U, &ucPatch[ 10 ], 30U ) );
+    TEST_ASSERT_EQUAL( eDelta_Applied, OTA_Delta_Apply( pxPatch, 40U, &ucPatch[ 40 ], ulPatchSize - 40U ) );
+
+    TEST_ASSERT_EQUAL( eDelta_Applied, OTA_Delta_Finish( pxPatch, &ulImageSize ) );
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( ucExpectedImage, ucNewImage, otatestDELTA_IMAGE_SIZE );
+
+    OTA_Delta_Delete( pxPatch );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_OTA_DELTA, OTA_Delta_BadPatches )
+{
+    OTA_DeltaPatch_t * pxPatch;
+    uint32_t ulImageSize = 0U;
+
+    /* Not a patch. */
+    pxPatch = OTA_Delta_Create( prvReadBase, prvWriteImage, NULL );
+    TEST_ASSERT_NOT_NULL( pxPatch );
+    ucPatch[ 0 ] ^= 0xffU;
+    TEST_ASSERT_EQUAL( eDelta_BadPatch, prvApplyInPieces( pxPatch, 1024U ) );
+    OTA_Delta_Delete( pxPatch );
+
+    /* A COPY past the end of the base image. */
+    prvMakePatch();
+    pxPatch = OTA_Delta_Create( prvReadBase, prvWriteImage, NULL );
+    TEST_ASSERT_NOT_NULL( pxPatch );
+    ucPatch[ 12 + 8 ] = 0xffU; /* The top byte of the base offset. */
+    TEST_ASSERT_EQUAL( eDelta_BadPatch, prvApplyInPieces( pxPatch, 1024U ) );
+    OTA_Delta_Delete( pxPatch );
+
+    /* A command past the end of the new image. */
+    prvMakePatch();
+    pxPatch = OTA_Delta_Create( prvReadBase, prvWriteImage, NULL );
+    TEST_ASSERT_NOT_NULL( pxPatch );
+    prvPutCopy( 1U, 0U );
+    TEST_ASSERT_EQUAL( eDelta_BadPatch, prvApplyInPieces( pxPatch, 1024U ) );
+    OTA_Delta_Delete( pxPatch );
+
+    /* A patch that ends before the new image is complete. */
+    prvMakePatch();
+    pxPatch = OTA_Delta_Create( prvReadBase, prvWriteImage, NULL );
+    TEST_ASSERT_NOT_NULL( pxPatch );
+    ulPatchSize -= 9U;
+    TEST_ASSERT_EQUAL( eDelta_Applied, prvApplyInPieces( pxPatch, 1024U ) );
+    TEST_ASSERT_EQUAL( eDelta_Incomplete, OTA_Delta_Finish( pxPatch, &ulImageSize ) );
+    OTA_Delta_Delete( pxPatch );
+}
@@ -0,0 +1,1034 @@
+/*
+ * Amazon FreeRTOS OTA AFQP V1.1.4
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+/* Standard includes. */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+#include "unity_fixture.h"
+#include "unity.h"
+#include "aws_ota_agent.h"
+#include "aws_ota_agent_config.h"
+#include "aws_ota_agent_config_defaults.h"
+#include "aws_ota_agent_test_access_declare.h"
+#include "aws_ota_http_test_access_declare.h"
+#include "aws_clientcredential.h"
+#include "aws_mqtt_agent.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define otatestHTTP_URL                   "https://ota.example.com:8443/images/payload.bin"
+#define otatestHTTP_HOST                  "ota.example.com"
+#define otatestHTTP_PORT                  8443U
+#define otatestHTTP_FILE_SIZE             90860U
+#define otatestHTTP_MAX_PENDING           16U
+#define otatestHTTP_MAX_CONNECTIONS       8U
+#define otatestHTTP_BODY_MAX              ( 4U * OTA_FILE_BLOCK_SIZE )
+#define otatestHTTP_AGENT_INIT_WAIT       10000
+#define otatestHTTP_SHUTDOWN_WAIT         10000
+
+/**
+ * @brief A job document whose file is downloaded from otatestHTTP_URL.
+ */
+#define otatestHTTP_JOB_JSON              "{\"clientToken\":\"mytoken\",\"timestamp\":1508445004,\"execution\":{\"jobId\":\"15\",\"status\":\"QUEUED\",\"queuedAt\":1507697924,\"lastUpdatedAt\":1507697924,\"versionNumber\":1,\"executionNumber\":1,\"jobDocument\":{\"afr_ota\": {\"streamname\": \"1\",\"files\": [{\"filepath\": \"payload.bin\",\"version\":\"1.0.0.0\",\"filesize\": 90860,\"fileid\": 0,\"attr\": 3,\"certfile\":\"rsasigner.crt\",\"update_data_url\":\"" otatestHTTP_URL "\",\"sig-sha256-rsa\":\"OHj5sNjxqMNK3WNEwbyfs/PeSSS1kzLkAQ4MSu0yKNFoGxJrUKuIWhjQbQiPlXcDtXlSXE8ydAwoxnnw5lcwpJsbXxD1K1PwZJoc/3mv5XHXbvvEoFr4yA0rhY4tyrMDBesEtOVrW0yI4mM4Lde5OtdIxo8sjTSPGXo2Ejuhn+LDRD3gKdb1gtPpoJ/YBQmYKXHFQ5QW58GOSlB9prq5v+MloVCATjmzb9tu4msScXYYy41ikEhK2eyfl7/vpc2vMNX6uhyyeZhku9namI4OZmsp72tLL4D4pFt4/nDWYSAo8sQAwns1RNY+j52KfvgvKKN3u6G3suFyVQoxWJu3aA==\"}]}}}}"
+
+/**
+ * @brief The server side of the connections the tests make.
+ *
+ * The server answers each range request with the bytes of a file whose byte at
+ * offset N is prvFileByte( N ), unless the test gives it a canned reply.
+ */
+typedef struct
+{
+    /* Set by the test. */
+    const char * pcCanned;     /* If not NULL, the bytes the server sends instead of answering requests. */
+    uint32_t ulChunk;          /* The most bytes one receive returns. */
+    uint32_t ulCloseAfter;     /* Close each connection after this many responses, or 0. */
+    uint32_t ulBadRange;       /* The number of the response, from 1, that gives the wrong range, or 0. */
+    uint32_t ulSendsAllowed;   /* The number of sends before they fail, or 0 for no limit. */
+    BaseType_t xRefuse;        /* Refuse connections. */
+
+    /* Recorded by the server. */
+    uint32_t ulOpens;                                          /* The number of connections opened. */
+    uint32_t ulCloses;                                         /* The number of connections closed. */
+    uint32_t ulSends;                                          /* The number of sends accepted. */
+    uint32_t ulResponses;                                      /* The number of responses started. */
+    char cHost[ securesocketsMAX_DNS_NAME_LENGTH + 1 ];        /* The host of the last connection. */
+    uint16_t usPort;                                           /* The port of the last connection. */
+    char cFirstRequest[ 128 ];                                 /* The first request sent on the last connection. */
+    uint32_t ulFirstOffset[ otatestHTTP_MAX_CONNECTIONS ];     /* The first offset asked for on each connection. */
+
+    /* The connection. */
+    uint32_t ulPendingFirst[ otatestHTTP_MAX_PENDING ]; /* The ranges asked for but not answered yet. */
+    uint32_t ulPendingLast[ otatestHTTP_MAX_PENDING ];
+    uint32_t ulPendingHead;
+    uint32_t ulPendingCount;
+    uint32_t ulConnectionResponses; /* The number of responses started on this connection. */
+    BaseType_t xClosing;            /* The server closes the connection after the response being sent. */
+    uint32_t ulCannedSent;          /* The number of canned bytes sent. */
+    char cHeader[ 160 ];            /* The header of the response being sent. */
+    uint32_t ulHeaderLen;
+    uint32_t ulHeaderSent;
+    uint32_t ulBodyOffset; /* The file offset of the next body byte to send. */
+    uint32_t ulBodyLeft;   /* The number of body bytes still to send. */
+} HTTPTestServer_t;
+
+static HTTPTestServer_t xServer;
+
+/**
+ * @brief The body received by prvSaveBody.
+ */
+static uint8_t ucBody[ otatestHTTP_BODY_MAX ];
+static uint32_t ulBodyStart;
+static uint32_t ulBodyLen;
+static uint32_t ulBodyCalls;
+
+/**
+ * @brief Shared MQTT client handle for the tests that run the OTA agent.
+ */
+static MQTTAgentHandle_t xMQTTClientHandle = NULL;
+
+/*-----------------------------------------------------------*/
+
+static uint8_t prvFileByte( uint32_t ulOffset )
+{
+    return ( uint8_t ) ( ( ulOffset * 31U ) + ( ulOffset >> 10 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+static Socket_t prvServerOpen( const char * pcHost,
+                               uint16_t usPort )
+{
+    Socket_t xSocket = SOCKETS_INVALID_SOCKET;
+
+    if( xServer.xRefuse == pdFALSE )
+    {
+        TEST_ASSERT_TRUE( strlen( pcHost ) < sizeof( xServer.cHost ) );
+        strcpy( xServer.cHost, pcHost );
+        xServer.usPort = usPort;
+        xServer.ulOpens++;
+
+        xServer.cFirstRequest[ 0 ] = '\0';
+        xServer.ulPendingHead = 0U;
+        xServer.ulPendingCount = 0U;
+        xServer.ulConnectionResponses = 0U;
+        xServer.xClosing = pdFALSE;
+        xServer.ulCannedSent = 0U;
+        xServer.ulHeaderLen = 0U;
+        xServer.ulHeaderSent = 0U;
+        xServer.ulBodyLeft = 0U;
+        xSocket = ( Socket_t ) &xServer;
+    }
+
+    return xSocket;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t prvServerSend( Socket_t xSocket,
+                              const void * pvBuffer,
+                              size_t xDataLength,
+                              uint32_t ulFlags )
+{
+    char cRequest[ sizeof( xServer.cFirstRequest ) ];
+    const char * pcRange;
+    char * pcEnd;
+    uint32_t ulSlot;
+    int32_t lResult = -1;
+
+    ( void ) ulFlags;
+    TEST_ASSERT_TRUE( xSocket == ( Socket_t ) &xServer );
+
+    if( ( xServer.ulSendsAllowed == 0U ) || ( xServer.ulSends < xServer.ulSendsAllowed ) )
+    {
+        xServer.ulSends++;
+
+        /* Each request is sent whole, ending with its range field. */
+        TEST_ASSERT_TRUE( xDataLength < sizeof( cRequest ) );
+        memcpy( cRequest, pvBuffer, xDataLength );
+        cRequest[ xDataLength ] = '\0';
+
+        if( xServer.cFirstRequest[ 0 ] == '\0' )
+        {
+            strcpy( xServer.cFirstRequest, cRequest );
+        }
+
+        pcRange = strstr( cRequest, "Range: bytes=" );
+        TEST_ASSERT_TRUE( pcRange != NULL );
+        TEST_ASSERT_TRUE( xServer.ulPendingCount < otatestHTTP_MAX_PENDING );
+
+        ulSlot = ( xServer.ulPendingHead + xServer.ulPendingCount ) % otatestHTTP_MAX_PENDING;
+        xServer.ulPendingFirst[ ulSlot ] = ( uint32_t ) strtoul( &pcRange[ 13 ], &pcEnd, 10 );
+        TEST_ASSERT_EQUAL( '-', *pcEnd );
+        xServer.ulPendingLast[ ulSlot ] = ( uint32_t ) strtoul( &pcEnd[ 1 ], &pcEnd, 10 );
+        TEST_ASSERT_EQUAL_STRING( "\r\n\r\n", pcEnd );
+
+        if( ( xServer.ulPendingCount == 0U ) && ( xServer.ulConnectionResponses == 0U ) &&
+            ( xServer.ulOpens <= otatestHTTP_MAX_CONNECTIONS ) )
+        {
+            xServer.ulFirstOffset[ xServer.ulOpens - 1U ] = xServer.ulPendingFirst[ ulSlot ];
+        }
+
+        xServer.ulPendingCount++;
+        lResult = ( int32_t ) xDataLength;
+    }
+
+    return lResult;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Start the response to the oldest request.
+ */
+static void prvServerStartResponse( void )
+{
+    uint32_t ulFirst = xServer.ulPendingFirst[ xServer.ulPendingHead ];
+    uint32_t ulLast = xServer.ulPendingLast[ xServer.ulPendingHead ];
+    uint32_t ulRangeFirst = ulFirst;
+
+    xServer.ulPendingHead = ( xServer.ulPendingHead + 1U ) % otatestHTTP_MAX_PENDING;
+    xServer.ulPendingCount--;
+    xServer.ulResponses++;
+    xServer.ulConnectionResponses++;
+    xServer.xClosing = ( ( xServer.ulCloseAfter != 0U ) && ( xServer.ulConnectionResponses == xServer.ulCloseAfter ) ) ? pdTRUE : pdFALSE;
+
+    if( xServer.ulResponses == xServer.ulBadRange )
+    {
+        ulRangeFirst += OTA_FILE_BLOCK_SIZE;
+    }
+
+    xServer.ulHeaderLen = ( uint32_t ) snprintf( xServer.cHeader, sizeof( xServer.cHeader ),
+                                                 "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes %u-%u/%u\r\nContent-Length: %u\r\n%s\r\n",
+                                                 ( unsigned ) ulRangeFirst,
+                                                 ( unsigned ) ( ulRangeFirst + ulLast - ulFirst ),
+                                                 ( unsigned ) otatestHTTP_FILE_SIZE,
+                                                 ( unsigned ) ( ulLast - ulFirst + 1U ),
+                                                 ( xServer.xClosing == pdTRUE ) ? "Connection: close\r\n" : "" );
+    TEST_ASSERT_TRUE( xServer.ulHeaderLen < sizeof( xServer.cHeader ) );
+    xServer.ulHeaderSent = 0U;
+    xServer.ulBodyOffset = ulFirst;
+    xServer.ulBodyLeft = ulLast - ulFirst + 1U;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t prvServerRecv( Socket_t xSocket,
+                              void * pvBuffer,
+                              size_t xBufferLength,
+                              uint32_t ulFlags )
+{
+    uint8_t * pucBuffer = ( uint8_t * ) pvBuffer;
+    uint32_t ulMax = ( uint32_t ) xBufferLength;
+    uint32_t ulCount = 0U;
+
+    ( void ) ulFlags;
+    TEST_ASSERT_TRUE( xSocket == ( Socket_t ) &xServer );
+
+    if( ulMax > xServer.ulChunk )
+    {
+        ulMax = xServer.ulChunk;
+    }
+
+    if( xServer.pcCanned != NULL )
+    {
+        while( ( ulCount < ulMax ) && ( xServer.pcCanned[ xServer.ulCannedSent ] != '\0' ) )
+        {
+            pucBuffer[ ulCount++ ] = ( uint8_t ) xServer.pcCanned[ xServer.ulCannedSent++ ];
+        }
+    }
+    else
+    {
+        while( ulCount < ulMax )
+        {
+            if( xServer.ulHeaderSent < xServer.ulHeaderLen )
+            {
+                pucBuffer[ ulCount++ ] = ( uint8_t ) xServer.cHeader[ xServer.ulHeaderSent++ ];
+            }
+            else if( xServer.ulBodyLeft > 0U )
+            {
+                pucBuffer[ ulCount++ ] = prvFileByte( xServer.ulBodyOffset++ );
+                xServer.ulBodyLeft--;
+            }
+            else if( ( xServer.xClosing == pdFALSE ) && ( xServer.ulPendingCount > 0U ) )
+            {
+                prvServerStartResponse();
+            }
+            else
+            {
+                break; /* Nothing more to send, as if the receive timed out or the server closed. */
+            }
+        }
+    }
+
+    return ( int32_t ) ulCount;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvServerClose( Socket_t xSocket )
+{
+    TEST_ASSERT_TRUE( xSocket == ( Socket_t ) &xServer );
+    xServer.ulCloses++;
+}
+
+/*-----------------------------------------------------------*/
+
+static const OTA_HTTP_SocketIO_t xServerSocketIO = { prvServerOpen, prvServerSend, prvServerRecv, prvServerClose };
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Body callback that saves the body in ucBody, checking it arrives in order.
+ */
+static BaseType_t prvSaveBody( void * pvContext,
+                               uint32_t ulOffset,
+                               const uint8_t * pucData,
+                               uint32_t ulLength )
+{
+    ( void ) pvContext;
+
+    if( ulBodyCalls == 0U )
+    {
+        ulBodyStart = ulOffset;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32( ulBodyStart + ulBodyLen, ulOffset );
+    TEST_ASSERT_TRUE( ( ulBodyLen + ulLength ) <= sizeof( ucBody ) );
+    memcpy( &ucBody[ ulBodyLen ], pucData, ulLength );
+    ulBodyLen += ulLength;
+    ulBodyCalls++;
+
+    return pdPASS;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Body callback that stops reading.
+ */
+static BaseType_t prvRefuseBody( void * pvContext,
+                                 uint32_t ulOffset,
+                                 const uint8_t * pucData,
+                                 uint32_t ulLength )
+{
+    ( void ) pvContext;
+    ( void ) ulOffset;
+    ( void ) pucData;
+    ( void ) ulLength;
+
+    return pdFAIL;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvResetBody( void )
+{
+    ulBodyStart = 0U;
+    ulBodyLen = 0U;
+    ulBodyCalls = 0U;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check that ucBody holds ulLength bytes of the file from ulOffset.
+ */
+static void prvCheckBody( uint32_t ulOffset,
+                          uint32_t ulLength )
+{
+    uint32_t ulIndex;
+
+    TEST_ASSERT_EQUAL_UINT32( ulOffset, ulBodyStart );
+    TEST_ASSERT_EQUAL_UINT32( ulLength, ulBodyLen );
+
+    for( ulIndex = 0U; ulIndex < ulLength; ulIndex++ )
+    {
+        TEST_ASSERT_EQUAL_UINT8( prvFileByte( ulOffset + ulIndex ), ucBody[ ulIndex ] );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvParseHeader( const char * pcHeader,
+                                  OTA_HTTP_Response_t * pxResponse )
+{
+    return TEST_OTA_HTTP_prvParseResponseHeader( pcHeader, ( uint32_t ) strlen( pcHeader ), pxResponse );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Ask for one range and read the canned reply to it.
+ */
+static BaseType_t prvReadCannedReply( const char * pcReply,
+                                      uint32_t ulOffset,
+                                      uint32_t ulLength )
+{
+    OTA_HTTP_Connection_t * pxConnection;
+    BaseType_t xRequested;
+    BaseType_t xStatus = pdFAIL;
+    BaseType_t xOpen;
+
+    xServer.pcCanned = pcReply;
+    prvResetBody();
+    pxConnection = OTA_HTTP_Connect( otatestHTTP_URL );
+    TEST_ASSERT_TRUE( pxConnection != NULL );
+
+    /* Nothing here may fail the test before the connection is freed, as a
+     * TEST_PROTECT in this function would be gone by the time it is used. */
+    xRequested = OTA_HTTP_RequestRange( pxConnection, ulOffset, ulLength );
+
+    if( xRequested == pdPASS )
+    {
+        xStatus = OTA_HTTP_ReadResponse( pxConnection, prvSaveBody, NULL );
+    }
+
+    xOpen = OTA_HTTP_IsOpen( pxConnection );
+    OTA_HTTP_Disconnect( pxConnection );
+
+    TEST_ASSERT_EQUAL( pdPASS, xRequested );
+
+    /* A failed response closes the connection to more requests. */
+    TEST_ASSERT_EQUAL( xStatus, xOpen );
+
+    return xStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check that a canned reply fails the response before any of its body
+ * is passed on.
+ */
+static void prvCheckRefused( const char * pcReply )
+{
+    TEST_ASSERT_EQUAL_MESSAGE( pdFAIL, prvReadCannedReply( pcReply, 4U, 4U ), pcReply );
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE( 0U, ulBodyCalls, pcReply );
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 )
+
+/**
+ * @brief Application-defined callback for the OTA agent.
+ */
+    static void vOTACompleteCallback( OTA_JobEvent_t eResult )
+    {
+        ( void ) eResult;
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Connect to the MQTT broker and start the OTA agent.
+ */
+    static void prvStartAgent( void )
+    {
+        MQTTAgentConnectParams_t xConnectParams;
+
+        TEST_ASSERT_EQUAL_INT( eMQTTAgentSuccess, MQTT_AGENT_Create( &xMQTTClientHandle ) );
+
+        memset( &xConnectParams, 0, sizeof( xConnectParams ) );
+        xConnectParams.pucClientId = ( const uint8_t * ) ( clientcredentialIOT_THING_NAME );
+        xConnectParams.usClientIdLength = sizeof( clientcredentialIOT_THING_NAME ) - 1; /* Length doesn't include trailing 0. */
+        xConnectParams.pcURL = clientcredentialMQTT_BROKER_ENDPOINT;
+        xConnectParams.usPort = clientcredentialMQTT_BROKER_PORT;
+        xConnectParams.xFlags = mqttagentREQUIRE_TLS;
+        TEST_ASSERT_EQUAL_INT_MESSAGE( eMQTTAgentSuccess,
+                                       MQTT_AGENT_Connect( xMQTTClientHandle,
+                                                           &xConnectParams,
+                                                           pdMS_TO_TICKS( otatestHTTP_AGENT_INIT_WAIT ) ),
+                                       "Failed to connect to the MQTT broker." );
+
+        TEST_ASSERT_EQUAL_INT( eOTA_AgentState_Ready,
+                               OTA_AgentInit( xMQTTClientHandle,
+                                              ( const uint8_t * ) clientcredentialIOT_THING_NAME,
+                                              vOTACompleteCallback,
+                                              pdMS_TO_TICKS( otatestHTTP_AGENT_INIT_WAIT ) ) );
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Stop the OTA agent and disconnect from the MQTT broker.
+ */
+    static void prvStopAgent( void )
+    {
+        ( void ) OTA_AgentShutdown( pdMS_TO_TICKS( otatestHTTP_SHUTDOWN_WAIT ) );
+
+        if( xMQTTClientHandle != NULL )
+        {
+            ( void ) MQTT_AGENT_Disconnect( xMQTTClientHandle, pdMS_TO_TICKS( otatestHTTP_SHUTDOWN_WAIT ) );
+            ( void ) MQTT_AGENT_Delete( xMQTTClientHandle );
+            xMQTTClientHandle = NULL;
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check whether a block of the file is still missing.
+ */
+    static BaseType_t prvBlockMissing( const OTA_FileContext_t * C,
+                                       uint32_t ulBlock )
+    {
+        return ( ( C->pucRxBlockBitmap[ ulBlock / 8U ] & ( 1U << ( ulBlock % 8U ) ) ) != 0U ) ? pdTRUE : pdFALSE;
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Write ulLength bytes of the file from ulOffset through prvWriteHTTPBody.
+ */
+    static BaseType_t prvWriteFilePiece( OTA_FileContext_t * C,
+                                         uint32_t ulOffset,
+                                         uint32_t ulLength )
+    {
+        IngestResult_t eResult;
+        BaseType_t xStatus;
+        uint32_t ulIndex;
+
+        TEST_ASSERT_TRUE( ulLength <= sizeof( ucBody ) );
+
+        for( ulIndex = 0U; ulIndex < ulLength; ulIndex++ )
+        {
+            ucBody[ ulIndex ] = prvFileByte( ulOffset + ulIndex );
+        }
+
+        xStatus = TEST_OTA_prvWriteHTTPBody( C, ulOffset, ucBody, ulLength, &eResult );
+        TEST_ASSERT_EQUAL( eIngest_Result_Accepted_Continue, eResult );
+
+        return xStatus;
+    }
+
+#endif /* if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 ) */
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_OTA_HTTP );
+
+TEST_SETUP( Full_OTA_HTTP )
+{
+    memset( &xServer, 0, sizeof( xServer ) );
+    xServer.ulChunk = 0xffffffffUL;
+    TEST_OTA_HTTP_SetSocketIO( &xServerSocketIO );
+}
+
+TEST_TEAR_DOWN( Full_OTA_HTTP )
+{
+    TEST_OTA_HTTP_SetSocketIO( NULL );
+}
+
+TEST_GROUP_RUNNER( Full_OTA_HTTP )
+{
+    RUN_TEST_CASE( Full_OTA_HTTP, prvParseResponseHeader );
+    RUN_TEST_CASE( Full_OTA_HTTP, OTA_HTTP_Connect );
+    RUN_TEST_CASE( Full_OTA_HTTP, OTA_HTTP_ReadResponse_RangeMismatch );
+    RUN_TEST_CASE( Full_OTA_HTTP, OTA_HTTP_ReadResponse_Pipelined );
+    RUN_TEST_CASE( Full_OTA_HTTP, OTA_HTTP_ReadResponse_ConnectionClosed );
+    RUN_TEST_CASE( Full_OTA_HTTP, prvWriteHTTPBody_WholeBlocks );
+    RUN_TEST_CASE( Full_OTA_HTTP, prvFetchFileBlocksHTTP_ReconnectAndRetry );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_OTA_HTTP, prvParseResponseHeader )
+{
+    static const char cFull[] = "HTTP/1.1 206 Partial Content\r\n"
+                                "content-RANGE: bytes 1024-2047/90860\r\n"
+                                "Content-Length:1024\r\n"
+                                "Server: test\r\n"
+                                "Connection: Close\r\n"
+                                "\r\n";
+    OTA_HTTP_Response_t xResponse;
+
+    /* Field names and values are matched without regard to case, and
+     * fields that don't matter are skipped. */
+    TEST_ASSERT_EQUAL( pdPASS, prvParseHeader( cFull, &xResponse ) );
+    TEST_ASSERT_EQUAL_UINT32( 206U, xResponse.ulStatus );
+    TEST_ASSERT_TRUE( xResponse.xHasRange );
+    TEST_ASSERT_EQUAL_UINT32( 1024U, xResponse.ulRangeFirst );
+    TEST_ASSERT_EQUAL_UINT32( 2047U, xResponse.ulRangeLast );
+    TEST_ASSERT_TRUE( xResponse.xHasLength );
+    TEST_ASSERT_EQUAL_UINT32( 1024U, xResponse.ulContentLength );
+    TEST_ASSERT_TRUE( xResponse.xClose );
+    TEST_ASSERT_FALSE( xResponse.xChunked );
+
+    /* Only the status line is needed. */
+    TEST_ASSERT_EQUAL( pdPASS, prvParseHeader( "HTTP/1.0 200 OK\r\n\r\n", &xResponse ) );
+    TEST_ASSERT_EQUAL_UINT32( 200U, xResponse.ulStatus );
+    TEST_ASSERT_FALSE( xResponse.xHasRange );
+    TEST_ASSERT_FALSE( xResponse.xHasLength );
+    TEST_ASSERT_FALSE( xResponse.xClose );
+
+    /* Malformed status lines and fields are rejected. */
+    TEST_ASSERT_EQUAL( pdFAIL, prvParseHeader( "HTTP/2 206\r\n\r\n", &xResponse ) );
+    TEST_ASSERT_EQUAL( pdFAIL, prvParseHeader( "HTTP/1.1 abc\r\n\r\n", &xResponse ) );
+    TEST_ASSERT_EQUAL( pdFAIL, prvParseHeader( "HTTP/1.1-206\r\n\r\n", &xResponse ) );
+    TEST_ASSERT_EQUAL( pdFAIL, prvParseHeader( "HTTP/1.1 206\r\nNoColon\r\n\r\n", &xResponse ) );
+
+    /* A Content-Range that isn't a byte range is treated as missing. */
+    TEST_ASSERT_EQUAL( pdPASS, prvParseHeader( "HTTP/1.1 206\r\nContent-Range: bytes 10-9/90\r\n\r\n", &xResponse ) );
+    TEST_ASSERT_FALSE( xResponse.xHasRange );
+    TEST_ASSERT_EQUAL( pdPASS, prvParseHeader( "HTTP/1.1 206\r\nContent-Range: bytes */90\r\n\r\n", &xResponse ) );
+    TEST_ASSERT_FALSE( xResponse.xHasRange );
+    TEST_ASSERT_EQUAL( pdPASS, prvParseHeader( "HTTP/1.1 206\r\nContent-Range: items 0-1/2\r\n\r\n", &xResponse ) );
+    TEST_ASSERT_FALSE( xResponse.xHasRange );
+
+    /* A length that doesn't fit in 32 bits is treated as missing. */
+    TEST_ASSERT_EQUAL( pdPASS, prvParseHeader( "HTTP/1.1 206\r\nContent-Length: 99999999999\r\n\r\n", &xResponse ) );
+    TEST_ASSERT_FALSE( xResponse.xHasLength );
+
+    /* Any transfer encoding is noted so the response can be refused. */
+    TEST_ASSERT_EQUAL( pdPASS, prvParseHeader( "HTTP/1.1 206\r\nTransfer-Encoding: chunked\r\n\r\n", &xResponse ) );
+    TEST_ASSERT_TRUE( xResponse.xChunked );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_OTA_HTTP, OTA_HTTP_Connect )
+{
+    static const char * const pcBadURLs[] =
+    {
+        "http://ota.example.com/payload.bin",
+        "https://",
+        "https:///payload.bin",
+        "https://ota.example.com:0/payload.bin",
+        "https://ota.example.com:70000/payload.bin",
+        "https://ota.example.com:12ab/payload.bin"
+    };
+    OTA_HTTP_Connection_t * pxConnection;
+    uint32_t ulIndex;
+
+    /* The host, port and path are taken from the URL, and the request asks
+     * for the range. */
+    pxConnection = OTA_HTTP_Connect( otatestHTTP_URL );
+    TEST_ASSERT_TRUE( pxConnection != NULL );
+
+    if( TEST_PROTECT() )
+    {
+        TEST_ASSERT_EQUAL_STRING( otatestHTTP_HOST, xServer.cHost );
+        TEST_ASSERT_EQUAL_UINT16( otatestHTTP_PORT, xServer.usPort );
+        TEST_ASSERT_EQUAL( pdTRUE, OTA_HTTP_IsOpen( pxConnection ) );
+        TEST_ASSERT_EQUAL( pdPASS, OTA_HTTP_RequestRange( pxConnection, 2048U, 1024U ) );
+        TEST_ASSERT_EQUAL_STRING( "GET /images/payload.bin HTTP/1.1\r\nHost: " otatestHTTP_HOST "\r\nRange: bytes=2048-3071\r\n\r\n",
+                                  xServer.cFirstRequest );
+        TEST_ASSERT_EQUAL_UINT32( 1U, OTA_HTTP_RequestsInFlight( pxConnection ) );
+
+        /* An empty range can't be asked for. */
+        TEST_ASSERT_EQUAL( pdFAIL, OTA_HTTP_RequestRange( pxConnection, 0U, 0U ) );
+        TEST_ASSERT_EQUAL_UINT32( 1U, OTA_HTTP_RequestsInFlight( pxConnection ) );
+    }
+
+    OTA_HTTP_Disconnect( pxConnection );
+    TEST_ASSERT_EQUAL_UINT32( 1U, xServer.ulCloses );
+
+    /* The port defaults to 443 and the path to "/". */
+    pxConnection = OTA_HTTP_Connect( "https://10.0.0.1" );
+    TEST_ASSERT_TRUE( pxConnection != NULL );
+    TEST_ASSERT_EQUAL_STRING( "10.0.0.1", xServer.cHost );
+    TEST_ASSERT_EQUAL_UINT16( 443U, xServer.usPort );
+    ( void ) OTA_HTTP_RequestRange( pxConnection, 0U, 1U );
+    OTA_HTTP_Disconnect( pxConnection );
+    TEST_ASSERT_EQUAL_STRING( "GET / HTTP/1.1\r\nHost: 10.0.0.1\r\nRange: bytes=0-0\r\n\r\n", xServer.cFirstRequest );
+
+    /* Bad URLs are refused without connecting. */
+    for( ulIndex = 0U; ulIndex < ( sizeof( pcBadURLs ) / sizeof( pcBadURLs[ 0 ] ) ); ulIndex++ )
+    {
+        TEST_ASSERT_TRUE_MESSAGE( OTA_HTTP_Connect( pcBadURLs[ ulIndex ] ) == NULL, pcBadURLs[ ulIndex ] );
+    }
+
+    TEST_ASSERT_EQUAL_UINT32( 2U, xServer.ulOpens );
+
+    /* A connection that can't be made gives NULL. */
+    xServer.xRefuse = pdTRUE;
+    TEST_ASSERT_TRUE( OTA_HTTP_Connect( otatestHTTP_URL ) == NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_OTA_HTTP, OTA_HTTP_ReadResponse_RangeMismatch )
+{
+    /* The range asked for is sent. */
+    TEST_ASSERT_EQUAL( pdPASS, prvReadCannedReply( "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes 4-7/100\r\nContent-Length: 4\r\n\r\nabcd", 4U, 4U ) );
+    TEST_ASSERT_EQUAL_UINT32( 4U, ulBodyStart );
+    TEST_ASSERT_EQUAL_UINT32( 4U, ulBodyLen );
+    TEST_ASSERT_EQUAL_MEMORY( "abcd", ucBody, 4 );
+
+    /* Content-Length is optional. */
+    TEST_ASSERT_EQUAL( pdPASS, prvReadCannedReply( "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes 4-7/100\r\n\r\nabcd", 4U, 4U ) );
+
+    /* The whole file instead of the range. */
+    prvCheckRefused( "HTTP/1.1 200 OK\r\nContent-Length: 4\r\n\r\nabcd" );
+
+    /* A range that starts somewhere else. */
+    prvCheckRefused( "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes 0-3/100\r\n\r\nabcd" );
+
+    /* A range that is shorter or longer than asked for. */
+    prvCheckRefused( "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes 4-6/100\r\n\r\nabc" );
+    prvCheckRefused( "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes 4-8/100\r\n\r\nabcde" );
+
+    /* A Content-Length that doesn't match the range. */
+    prvCheckRefused( "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes 4-7/100\r\nContent-Length: 5\r\n\r\nabcde" );
+
+    /* No Content-Range, or a body that isn't sent as is. */
+    prvCheckRefused( "HTTP/1.1 206 Partial Content\r\nContent-Length: 4\r\n\r\nabcd" );
+    prvCheckRefused( "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes 4-7/100\r\nTransfer-Encoding: chunked\r\n\r\n4\r\nabcd\r\n0\r\n\r\n" );
+
+    /* A body cut short by the server. What did arrive has been passed on. */
+    TEST_ASSERT_EQUAL( pdFAIL, prvReadCannedReply( "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes 4-7/100\r\n\r\nab", 4U, 4U ) );
+    TEST_ASSERT_EQUAL_UINT32( 2U, ulBodyLen );
+
+    /* A header that doesn't fit in the receive buffer. */
+    xServer.ulChunk = 64U;
+    memset( ucBody, 'x', sizeof( ucBody ) );
+    ucBody[ sizeof( ucBody ) - 1U ] = '\0';
+    prvCheckRefused( ( const char * ) ucBody );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_OTA_HTTP, OTA_HTTP_ReadResponse_Pipelined )
+{
+    static const uint32_t ulChunks[] = { 1U, 7U, 700U, 0xffffffffUL };
+    uint32_t ulOffset[ otaconfigHTTP_PIPELINE_DEPTH ];
+    uint32_t ulLength[ otaconfigHTTP_PIPELINE_DEPTH ];
+    OTA_HTTP_Connection_t * pxConnection;
+    uint32_t ulChunk, ulIndex;
+
+    /* Ranges of different lengths, including ones longer than the receive buffer. */
+    for( ulIndex = 0U; ulIndex < otaconfigHTTP_PIPELINE_DEPTH; ulIndex++ )
+    {
+        ulOffset[ ulIndex ] = ( ulIndex * 3U + 1U ) * OTA_FILE_BLOCK_SIZE;
+        ulLength[ ulIndex ] = ( ulIndex % 2U == 0U ) ? ( 3U * OTA_FILE_BLOCK_SIZE ) : 100U;
+    }
+
+    /* The responses arrive a byte at a time, in pieces that split headers and
+     * bodies, and all at once, so several responses share one receive. */
+    for( ulChunk = 0U; ulChunk < ( sizeof( ulChunks ) / sizeof( ulChunks[ 0 ] ) ); ulChunk++ )
+    {
+        xServer.ulChunk = ulChunks[ ulChunk ];
+        pxConnection = OTA_HTTP_Connect( otatestHTTP_URL );
+        TEST_ASSERT_TRUE( pxConnection != NULL );
+
+        if( TEST_PROTECT() )
+        {
+            for( ulIndex = 0U; ulIndex < otaconfigHTTP_PIPELINE_DEPTH; ulIndex++ )
+            {
+                TEST_ASSERT_EQUAL( pdPASS, OTA_HTTP_RequestRange( pxConnection, ulOffset[ ulIndex ], ulLength[ ulIndex ] ) );
+            }
+
+            /* The pipeline is full, but the connection stays open. */
+            TEST_ASSERT_EQUAL( pdFAIL, OTA_HTTP_RequestRange( pxConnection, 0U, 1U ) );
+            TEST_ASSERT_EQUAL( pdTRUE, OTA_HTTP_IsOpen( pxConnection ) );
+            TEST_ASSERT_EQUAL_UINT32( otaconfigHTTP_PIPELINE_DEPTH, OTA_HTTP_RequestsInFlight( pxConnection ) );
+
+            /* The responses are read in the order they were asked for. */
+            for( ulIndex = 0U; ulIndex < otaconfigHTTP_PIPELINE_DEPTH; ulIndex++ )
+            {
+                prvResetBody();
+                TEST_ASSERT_EQUAL( pdPASS, OTA_HTTP_ReadResponse( pxConnection, prvSaveBody, NULL ) );
+                prvCheckBody( ulOffset[ ulIndex ], ulLength[ ulIndex ] );
+                TEST_ASSERT_EQUAL_UINT32( otaconfigHTTP_PIPELINE_DEPTH - ulIndex - 1U, OTA_HTTP_RequestsInFlight( pxConnection ) );
+            }
+
+            /* There is nothing left to read. */
+            TEST_ASSERT_EQUAL( pdFAIL, OTA_HTTP_ReadResponse( pxConnection, prvSaveBody, NULL ) );
+        }
+
+        OTA_HTTP_Disconnect( pxConnection );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_OTA_HTTP, OTA_HTTP_ReadResponse_ConnectionClosed )
+{
+    OTA_HTTP_Connection_t * pxConnection;
+
+    /* The server answers two requests, saying it will close the connection
+     * after the second. */
+    xServer.ulCloseAfter = 2U;
+    pxConnection = OTA_HTTP_Connect( otatestHTTP_URL );
+    TEST_ASSERT_TRUE( pxConnection != NULL );
+
+    if( TEST_PROTECT() )
+    {
+        TEST_ASSERT_EQUAL( pdPASS, OTA_HTTP_RequestRange( pxConnection, 0U, 100U ) );
+        TEST_ASSERT_EQUAL( pdPASS, OTA_HTTP_RequestRange( pxConnection, 100U, 100U ) );
+        TEST_ASSERT_EQUAL( pdPASS, OTA_HTTP_RequestRange( pxConnection, 200U, 100U ) );
+
+        prvResetBody();
+        TEST_ASSERT_EQUAL( pdPASS, OTA_HTTP_ReadResponse( pxConnection, prvSaveBody, NULL ) );
+        TEST_ASSERT_EQUAL( pdTRUE, OTA_HTTP_IsOpen( pxConnection ) );
+
+        prvResetBody();
+        TEST_ASSERT_EQUAL( pdPASS, OTA_HTTP_ReadResponse( pxConnection, prvSaveBody, NULL ) );
+        prvCheckBody( 100U, 100U );
+        TEST_ASSERT_EQUAL( pdFALSE, OTA_HTTP_IsOpen( pxConnection ) );
+
+        /* No more requests can be sent, and the last one is never answered. */
+        TEST_ASSERT_EQUAL( pdFAIL, OTA_HTTP_RequestRange( pxConnection, 300U, 100U ) );
+        TEST_ASSERT_EQUAL_UINT32( 1U, OTA_HTTP_RequestsInFlight( pxConnection ) );
+        TEST_ASSERT_EQUAL( pdFAIL, OTA_HTTP_ReadResponse( pxConnection, prvSaveBody, NULL ) );
+    }
+
+    OTA_HTTP_Disconnect( pxConnection );
+
+    /* A request that can't be sent closes the connection to new requests, but
+     * the requests already sent can still be read. */
+    xServer.ulCloseAfter = 0U;
+    xServer.ulSendsAllowed = xServer.ulSends + 1U;
+    pxConnection = OTA_HTTP_Connect( otatestHTTP_URL );
+    TEST_ASSERT_TRUE( pxConnection != NULL );
+
+    if( TEST_PROTECT() )
+    {
+        TEST_ASSERT_EQUAL( pdPASS, OTA_HTTP_RequestRange( pxConnection, 0U, 100U ) );
+        TEST_ASSERT_EQUAL( pdFAIL, OTA_HTTP_RequestRange( pxConnection, 100U, 100U ) );
+        TEST_ASSERT_EQUAL( pdFALSE, OTA_HTTP_IsOpen( pxConnection ) );
+        TEST_ASSERT_EQUAL_UINT32( 1U, OTA_HTTP_RequestsInFlight( pxConnection ) );
+
+        prvResetBody();
+        TEST_ASSERT_EQUAL( pdPASS, OTA_HTTP_ReadResponse( pxConnection, prvSaveBody, NULL ) );
+        prvCheckBody( 0U, 100U );
+        TEST_ASSERT_EQUAL_UINT32( 0U, OTA_HTTP_RequestsInFlight( pxConnection ) );
+    }
+
+    OTA_HTTP_Disconnect( pxConnection );
+
+    /* A body callback that stops reading fails the response. */
+    xServer.ulSendsAllowed = 0U;
+    pxConnection = OTA_HTTP_Connect( otatestHTTP_URL );
+    TEST_ASSERT_TRUE( pxConnection != NULL );
+
+    if( TEST_PROTECT() )
+    {
+        TEST_ASSERT_EQUAL( pdPASS, OTA_HTTP_RequestRange( pxConnection, 0U, 100U ) );
+        TEST_ASSERT_EQUAL( pdFAIL, OTA_HTTP_ReadResponse( pxConnection, prvRefuseBody, NULL ) );
+        TEST_ASSERT_EQUAL( pdFALSE, OTA_HTTP_IsOpen( pxConnection ) );
+    }
+
+    OTA_HTTP_Disconnect( pxConnection );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_OTA_HTTP, prvWriteHTTPBody_WholeBlocks )
+{
+    #if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 )
+        OTA_FileContext_t * C = NULL;
+        uint32_t ulLastBlock = ( otatestHTTP_FILE_SIZE - 1U ) / OTA_FILE_BLOCK_SIZE;
+        uint32_t ulRemaining;
+        uint32_t ulIndex;
+
+        prvStartAgent();
+
+        if( TEST_PROTECT() )
+        {
+            C = TEST_OTA_prvProcessOTAJobMsg( otatestHTTP_JOB_JSON, sizeof( otatestHTTP_JOB_JSON ) );
+            TEST_ASSERT_TRUE( C != NULL );
+            TEST_ASSERT_EQUAL_STRING( otatestHTTP_URL, C->pucUpdateDataURL );
+
+            /* prvFetchFileBlocksHTTP allocates the block buffer with the connection. */
+            C->pucHTTPBlock = pvPortMalloc( OTA_FILE_BLOCK_SIZE );
+            TEST_ASSERT_TRUE( C->pucHTTPBlock != NULL );
+            ulRemaining = C->ulBlocksRemaining;
+            TEST_ASSERT_EQUAL_UINT32( ulLastBlock + 1U, ulRemaining );
+
+            /* A block that arrives in one piece is written from it. */
+            TEST_ASSERT_EQUAL( pdPASS, prvWriteFilePiece( C, 0U, OTA_FILE_BLOCK_SIZE ) );
+            TEST_ASSERT_FALSE( prvBlockMissing( C, 0U ) );
+            TEST_ASSERT_EQUAL_UINT32( --ulRemaining, C->ulBlocksRemaining );
+
+            /* A block that arrives in pieces is only written once it is whole. */
+            for( ulIndex = 0U; ulIndex < OTA_FILE_BLOCK_SIZE; ulIndex += 100U )
+            {
+                TEST_ASSERT_TRUE( prvBlockMissing( C, 1U ) );
+                TEST_ASSERT_EQUAL( pdPASS,
+                                   prvWriteFilePiece( C,
+                                                      OTA_FILE_BLOCK_SIZE + ulIndex,
+                                                      ( ( OTA_FILE_BLOCK_SIZE - ulIndex ) < 100U ) ? ( OTA_FILE_BLOCK_SIZE - ulIndex ) : 100U ) );
+            }
+
+            TEST_ASSERT_FALSE( prvBlockMissing( C, 1U ) );
+            TEST_ASSERT_EQUAL_UINT32( --ulRemaining, C->ulBlocksRemaining );
+
+            for( ulIndex = 0U; ulIndex < OTA_FILE_BLOCK_SIZE; ulIndex++ )
+            {
+                TEST_ASSERT_EQUAL_UINT8( prvFileByte( OTA_FILE_BLOCK_SIZE + ulIndex ), C->pucHTTPBlock[ ulIndex ] );
+            }
+
+            /* A piece that ends one block, fills the next and starts a third
+             * completes the first two. */
+            TEST_ASSERT_EQUAL( pdPASS, prvWriteFilePiece( C, 2U * OTA_FILE_BLOCK_SIZE, OTA_FILE_BLOCK_SIZE / 2U ) );
+            TEST_ASSERT_TRUE( prvBlockMissing( C, 2U ) );
+            TEST_ASSERT_EQUAL( pdPASS, prvWriteFilePiece( C, ( 5U * OTA_FILE_BLOCK_SIZE ) / 2U, 2U * OTA_FILE_BLOCK_SIZE ) );
+            TEST_ASSERT_FALSE( prvBlockMissing( C, 2U ) );
+            TEST_ASSERT_FALSE( prvBlockMissing( C, 3U ) );
+            TEST_ASSERT_TRUE( prvBlockMissing( C, 4U ) );
+            ulRemaining -= 2U;
+            TEST_ASSERT_EQUAL_UINT32( ulRemaining, C->ulBlocksRemaining );
+
+            /* A block written again isn't counted again. */
+            TEST_ASSERT_EQUAL( pdPASS, prvWriteFilePiece( C, 0U, OTA_FILE_BLOCK_SIZE ) );
+            TEST_ASSERT_EQUAL_UINT32( ulRemaining, C->ulBlocksRemaining );
+
+            /* The short last block is written once the end of the file arrives. */
+            TEST_ASSERT_EQUAL( pdPASS, prvWriteFilePiece( C, ulLastBlock * OTA_FILE_BLOCK_SIZE, 10U ) );
+            TEST_ASSERT_TRUE( prvBlockMissing( C, ulLastBlock ) );
+            TEST_ASSERT_EQUAL( pdPASS, prvWriteFilePiece( C, ( ulLastBlock * OTA_FILE_BLOCK_SIZE ) + 10U,
+                                                          otatestHTTP_FILE_SIZE - ( ulLastBlock * OTA_FILE_BLOCK_SIZE ) - 10U ) );
+            TEST_ASSERT_FALSE( prvBlockMissing( C, ulLastBlock ) );
+            TEST_ASSERT_EQUAL_UINT32( --ulRemaining, C->ulBlocksRemaining );
+
+            /* Data outside the file stops the response without failing the update. */
+            TEST_ASSERT_EQUAL( pdFAIL, prvWriteFilePiece( C, otatestHTTP_FILE_SIZE - 10U, 20U ) );
+            TEST_ASSERT_EQUAL( pdFAIL, prvWriteFilePiece( C, otatestHTTP_FILE_SIZE, 1U ) );
+            TEST_ASSERT_EQUAL_UINT32( ulRemaining, C->ulBlocksRemaining );
+        }
+
+        if( C != NULL )
+        {
+            ( void ) TEST_OTA_prvOTA_Close( C );
+        }
+
+        prvStopAgent();
+    #else /* if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 ) */
+        TEST_IGNORE_MESSAGE( "The HTTP data plane is disabled." );
+    #endif /* if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 ) */
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_OTA_HTTP, prvFetchFileBlocksHTTP_ReconnectAndRetry )
+{
+    #if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 )
+        const uint32_t ulRangeSize = otaconfigHTTP_BLOCKS_PER_REQUEST * OTA_FILE_BLOCK_SIZE;
+        OTA_FileContext_t * C = NULL;
+        OTA_Err_t xCloseResult;
+        OTA_Err_t xErr = kOTA_Err_None;
+        uint32_t ulRemaining;
+        uint32_t ulIndex;
+
+        prvStartAgent();
+
+        if( TEST_PROTECT() )
+        {
+            C = TEST_OTA_prvProcessOTAJobMsg( otatestHTTP_JOB_JSON, sizeof( otatestHTTP_JOB_JSON ) );
+            TEST_ASSERT_TRUE( C != NULL );
+            ulRemaining = C->ulBlocksRemaining;
+
+            /* A connection that can't be made is left for the request timer to retry. */
+            xServer.xRefuse = pdTRUE;
+            TEST_ASSERT_EQUAL( eIngest_Result_Accepted_Continue, TEST_OTA_prvFetchFileBlocksHTTP( C, &xCloseResult ) );
+            TEST_ASSERT_EQUAL( kOTA_Err_None, xCloseResult );
+            TEST_ASSERT_TRUE( C->pxHTTPConnection == NULL );
+            TEST_ASSERT_TRUE( C->pucHTTPBlock == NULL );
+            TEST_ASSERT_EQUAL( kOTA_Err_None, TEST_OTA_prvRetryHTTPTransfer( C ) );
+            TEST_ASSERT_EQUAL_UINT32( 1U, C->ulRequestMomentum );
+
+            /* Once the server answers, each fetch fills the pipeline and reads one
+             * response. Bodies arrive in pieces that don't line up with blocks. */
+            xServer.xRefuse = pdFALSE;
+            xServer.ulCloseAfter = 2U;
+            xServer.ulChunk = 700U;
+            TEST_ASSERT_EQUAL( eIngest_Result_Accepted_Continue, TEST_OTA_prvFetchFileBlocksHTTP( C, &xCloseResult ) );
+            TEST_ASSERT_EQUAL_UINT32( 1U, xServer.ulOpens );
+            TEST_ASSERT_EQUAL_UINT32( otaconfigHTTP_PIPELINE_DEPTH, xServer.ulSends );
+            TEST_ASSERT_EQUAL_UINT32( 0U, xServer.ulFirstOffset[ 0 ] );
+            TEST_ASSERT_EQUAL_UINT32( 0U, C->ulRequestMomentum );
+            ulRemaining -= otaconfigHTTP_BLOCKS_PER_REQUEST;
+            TEST_ASSERT_EQUAL_UINT32( ulRemaining, C->ulBlocksRemaining );
+
+            /* The server closes the connection after the second response. */
+            TEST_ASSERT_EQUAL( eIngest_Result_Accepted_Continue, TEST_OTA_prvFetchFileBlocksHTTP( C, &xCloseResult ) );
+            ulRemaining -= otaconfigHTTP_BLOCKS_PER_REQUEST;
+            TEST_ASSERT_EQUAL_UINT32( ulRemaining, C->ulBlocksRemaining );
+            TEST_ASSERT_TRUE( C->pxHTTPConnection == NULL );
+            TEST_ASSERT_EQUAL_UINT32( 1U, xServer.ulCloses );
+
+            /* The next fetch reconnects and asks again from the first missing block. */
+            xServer.ulBadRange = xServer.ulResponses + 2U;
+            TEST_ASSERT_EQUAL( eIngest_Result_Accepted_Continue, TEST_OTA_prvFetchFileBlocksHTTP( C, &xCloseResult ) );
+            TEST_ASSERT_EQUAL_UINT32( 2U, xServer.ulOpens );
+            TEST_ASSERT_EQUAL_UINT32( 2U * ulRangeSize, xServer.ulFirstOffset[ 1 ] );
+            ulRemaining -= otaconfigHTTP_BLOCKS_PER_REQUEST;
+            TEST_ASSERT_EQUAL_UINT32( ulRemaining, C->ulBlocksRemaining );
+
+            /* A response for the wrong range drops the connection without writing
+             * anything. The blocks are asked for again on the next connection. */
+            TEST_ASSERT_EQUAL( eIngest_Result_Accepted_Continue, TEST_OTA_prvFetchFileBlocksHTTP( C, &xCloseResult ) );
+            TEST_ASSERT_EQUAL( kOTA_Err_None, xCloseResult );
+            TEST_ASSERT_EQUAL_UINT32( ulRemaining, C->ulBlocksRemaining );
+            TEST_ASSERT_TRUE( C->pxHTTPConnection == NULL );
+
+            TEST_ASSERT_EQUAL( eIngest_Result_Accepted_Continue, TEST_OTA_prvFetchFileBlocksHTTP( C, &xCloseResult ) );
+            TEST_ASSERT_EQUAL_UINT32( 3U, xServer.ulOpens );
+            TEST_ASSERT_EQUAL_UINT32( 3U * ulRangeSize, xServer.ulFirstOffset[ 2 ] );
+            ulRemaining -= otaconfigHTTP_BLOCKS_PER_REQUEST;
+            TEST_ASSERT_EQUAL_UINT32( ulRemaining, C->ulBlocksRemaining );
+
+            for( ulIndex = 0U; ulIndex < ( 4U * otaconfigHTTP_BLOCKS_PER_REQUEST ); ulIndex++ )
+            {
+                TEST_ASSERT_FALSE( prvBlockMissing( C, ulIndex ) );
+            }
+
+            TEST_ASSERT_TRUE( prvBlockMissing( C, 4U * otaconfigHTTP_BLOCKS_PER_REQUEST ) );
+
+            /* Retries without an answer from the server eventually abort the update. */
+            xServer.xRefuse = pdTRUE;
+
+            for( ulIndex = 0U; ( ulIndex < 100U ) && ( xErr == kOTA_Err_None ); ulIndex++ )
+            {
+                ( void ) TEST_OTA_prvFetchFileBlocksHTTP( C, &xCloseResult );
+                xErr = TEST_OTA_prvRetryHTTPTransfer( C );
+            }
+
+            TEST_ASSERT_EQUAL_UINT32( kOTA_Err_MomentumAbort, xErr & kOTA_Main_ErrMask );
+            TEST_ASSERT_TRUE( C->pxHTTPConnection == NULL );
+        }
+
+        if( C != NULL )
+        {
+            ( void ) TEST_OTA_prvOTA_Close( C );
+        }
+
+        prvStopAgent();
+    #else /* if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 ) */
+        TEST_IGNORE_MESSAGE( "The HTTP data plane is disabled." );
+    #endif /* if ( otaconfigENABLE_HTTP_DATA_PLANE == 1 ) */
+}
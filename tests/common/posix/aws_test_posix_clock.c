@@ -46,6 +46,16 @@
  */
 #define posixtestTIME_BUFFER_SIZE    ( 16 )
 
+/**
+ * @brief Number of consecutive clock reads in the monotonic clock test.
+ */
+#define posixtestMONOTONIC_READS     ( 1000 )
+
+/**
+ * @brief Sleep time in the sub-tick nanosleep test, a quarter of a tick.
+ */
+#define posixtestSUB_TICK_SLEEP_NS    ( NANOSECONDS_PER_TICK / 4 )
+
 /*-----------------------------------------------------------*/
 
 static void prvClockSleep( const struct timespec * const pxSleepTime,
@@ -98,6 +108,7 @@ TEST_TEAR_DOWN( Full_POSIX_CLOCK )
 TEST_GROUP_RUNNER( Full_POSIX_CLOCK )
 {
     RUN_TEST_CASE( Full_POSIX_CLOCK, clock_gettime_nanosleep );
+    RUN_TEST_CASE( Full_POSIX_CLOCK, clock_gettime_monotonic );
     RUN_TEST_CASE( Full_POSIX_CLOCK, clock_getres );
     RUN_TEST_CASE( Full_POSIX_CLOCK, clock_nanosleep_absolute );
     RUN_TEST_CASE( Full_POSIX_CLOCK, clock_nanosleep_min_resolution );
@@ -105,6 +116,7 @@ TEST_GROUP_RUNNER( Full_POSIX_CLOCK )
     RUN_TEST_CASE( Full_POSIX_CLOCK, clock_nanosleep_absolute_in_past );
     RUN_TEST_CASE( Full_POSIX_CLOCK, nanosleep );
     RUN_TEST_CASE( Full_POSIX_CLOCK, nanosleep_invalid_params );
+    RUN_TEST_CASE( Full_POSIX_CLOCK, nanosleep_sub_tick );
     RUN_TEST_CASE( Full_POSIX_CLOCK, localtime_r );
     RUN_TEST_CASE( Full_POSIX_CLOCK, strftime );
     RUN_TEST_CASE( Full_POSIX_CLOCK, time );
@@ -128,6 +140,42 @@ TEST( Full_POSIX_CLOCK, clock_gettime_nanosleep )
 
 /*-----------------------------------------------------------*/
 
+TEST( Full_POSIX_CLOCK, clock_gettime_monotonic )
+{
+    int iStatus = 0, iRead = 0, iSubTickSteps = 0;
+    struct timespec xPreviousTime = { 0 }, xCurrentTime = { 0 }, xStep = { 0 };
+
+    iStatus = clock_gettime( CLOCK_MONOTONIC, &xPreviousTime );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    for( iRead = 0; iRead < posixtestMONOTONIC_READS; iRead++ )
+    {
+        iStatus = clock_gettime( CLOCK_MONOTONIC, &xCurrentTime );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        /* Verify that the time did not go backwards. */
+        TEST_ASSERT_EQUAL_INT( 0, UTILS_TimespecSubtract( &xCurrentTime, &xPreviousTime, &xStep ) );
+
+        /* Count the steps smaller than a tick. */
+        if( ( xStep.tv_sec == 0 ) && ( xStep.tv_nsec > 0 ) && ( xStep.tv_nsec < NANOSECONDS_PER_TICK ) )
+        {
+            iSubTickSteps++;
+        }
+
+        xPreviousTime = xCurrentTime;
+    }
+
+    /* If the port has a high resolution count, the clock should advance
+     * between ticks. */
+    #ifdef portGET_HIGH_RESOLUTION_COUNT
+        TEST_ASSERT_GREATER_THAN( 0, iSubTickSteps );
+    #else
+        ( void ) iSubTickSteps;
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
 TEST( Full_POSIX_CLOCK, clock_getres )
 {
     int iStatus = 0;
@@ -280,6 +328,36 @@ TEST( Full_POSIX_CLOCK, nanosleep_invalid_params )
 
 /*-----------------------------------------------------------*/
 
+TEST( Full_POSIX_CLOCK, nanosleep_sub_tick )
+{
+    int iStatus = 0;
+    struct timespec xSleepTime = { .tv_sec = 0, .tv_nsec = posixtestSUB_TICK_SLEEP_NS },
+                    xStartTime = { 0 }, xEndTime = { 0 }, xElapsedTime = { 0 };
+
+    iStatus = clock_gettime( CLOCK_MONOTONIC, &xStartTime );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    iStatus = nanosleep( &xSleepTime, NULL );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    iStatus = clock_gettime( CLOCK_MONOTONIC, &xEndTime );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    TEST_ASSERT_EQUAL_INT( 0, UTILS_TimespecSubtract( &xEndTime, &xStartTime, &xElapsedTime ) );
+
+    /* Verify that at least the requested time elapsed. */
+    TEST_ASSERT_TRUE( ( xElapsedTime.tv_sec > 0 ) || ( xElapsedTime.tv_nsec >= posixtestSUB_TICK_SLEEP_NS ) );
+
+    /* A high resolution sleep busy waits for the part of a tick that is
+     * left, so it should wake before the tick would have woken it. */
+    #if ( posixconfigENABLE_HIGH_RESOLUTION_SLEEP == 1 ) && defined( portGET_HIGH_RESOLUTION_COUNT )
+        TEST_ASSERT_EQUAL_INT( 0, xElapsedTime.tv_sec );
+        TEST_ASSERT_TRUE( xElapsedTime.tv_nsec < NANOSECONDS_PER_TICK );
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
 TEST( Full_POSIX_CLOCK, localtime_r )
 {
     time_t xTime = time( NULL );
@@ -109,6 +109,34 @@ static void * prvBarrierThread( void * pvArgs )
 
 /*-----------------------------------------------------------*/
 
+static void * prvTryRwlockThread( void * pvArgs )
+{
+    pthread_rwlock_t * pxRwlock = ( pthread_rwlock_t * ) pvArgs;
+    intptr_t xStatus = 0;
+
+    /* Report whether a read lock and a write lock could be taken, then exit.
+     * Each is released straight away if it is taken. */
+    if( pthread_rwlock_tryrdlock( pxRwlock ) == 0 )
+    {
+        ( void ) pthread_rwlock_unlock( pxRwlock );
+        xStatus |= 1;
+    }
+
+    if( pthread_rwlock_trywrlock( pxRwlock ) == 0 )
+    {
+        ( void ) pthread_rwlock_unlock( pxRwlock );
+        xStatus |= 2;
+    }
+
+    pthread_exit( ( void * ) xStatus );
+
+    /* Silence compiler warnings about return values. This line will never be
+     * reached. */
+    return NULL;
+}
+
+/*-----------------------------------------------------------*/
+
 static void * prvSignalCondThread( void * pvArgs )
 {
     SignalCondThreadArgs_t * pxArgs = ( SignalCondThreadArgs_t * ) pvArgs;
@@ -290,6 +318,7 @@ TEST_GROUP_RUNNER( Full_POSIX_PTHREAD )
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_mutex_lock_unlock );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_mutex_trylock_timedlock );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_barrier );
+    RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_rwlock );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_cond_signal );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_cond_broadcast );
 }
@@ -525,6 +554,80 @@ TEST( Full_POSIX_PTHREAD, pthread_barrier )
 
 /*-----------------------------------------------------------*/
 
+TEST( Full_POSIX_PTHREAD, pthread_rwlock )
+{
+    int iStatus = 0;
+    intptr_t xThreadReturnValue = 0;
+    pthread_t xNewThread;
+    pthread_rwlock_t xRwlock = PTHREAD_RWLOCK_INITIALIZER;
+    struct timespec xTimeout;
+
+    if( TEST_PROTECT() )
+    {
+        /* Take two read locks. The lock is initialized by the first. */
+        iStatus = pthread_rwlock_rdlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        iStatus = pthread_rwlock_tryrdlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        /* Another thread can read, but not write. */
+        ( void ) pthread_create( &xNewThread, NULL, prvTryRwlockThread, &xRwlock );
+        ( void ) pthread_join( xNewThread, ( void ** ) &xThreadReturnValue );
+        TEST_ASSERT_EQUAL_INT( 1, ( int ) xThreadReturnValue );
+
+        /* A lock that is held cannot be destroyed. */
+        iStatus = pthread_rwlock_destroy( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( EBUSY, iStatus );
+
+        /* Writing times out while the read locks are held. */
+        ( void ) clock_gettime( CLOCK_REALTIME, &xTimeout );
+        ( void ) UTILS_TimespecAddNanoseconds( &xTimeout, 100000000LL, &xTimeout );
+        iStatus = pthread_rwlock_timedwrlock( &xRwlock, &xTimeout );
+        TEST_ASSERT_EQUAL_INT( ETIMEDOUT, iStatus );
+
+        /* Release both read locks. A further unlock is an error. */
+        TEST_ASSERT_EQUAL_INT( 0, pthread_rwlock_unlock( &xRwlock ) );
+        TEST_ASSERT_EQUAL_INT( 0, pthread_rwlock_unlock( &xRwlock ) );
+        TEST_ASSERT_EQUAL_INT( EPERM, pthread_rwlock_unlock( &xRwlock ) );
+
+        /* Take the write lock. Another thread can neither read nor write, and
+         * this thread cannot take the lock again. */
+        iStatus = pthread_rwlock_wrlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        ( void ) pthread_create( &xNewThread, NULL, prvTryRwlockThread, &xRwlock );
+        ( void ) pthread_join( xNewThread, ( void ** ) &xThreadReturnValue );
+        TEST_ASSERT_EQUAL_INT( 0, ( int ) xThreadReturnValue );
+
+        TEST_ASSERT_EQUAL_INT( EDEADLK, pthread_rwlock_rdlock( &xRwlock ) );
+        TEST_ASSERT_EQUAL_INT( EBUSY, pthread_rwlock_trywrlock( &xRwlock ) );
+
+        ( void ) clock_gettime( CLOCK_REALTIME, &xTimeout );
+        ( void ) UTILS_TimespecAddNanoseconds( &xTimeout, 100000000LL, &xTimeout );
+        iStatus = pthread_rwlock_timedrdlock( &xRwlock, &xTimeout );
+        TEST_ASSERT_EQUAL_INT( EDEADLK, iStatus );
+
+        /* Release the write lock, after which another thread can do both. */
+        TEST_ASSERT_EQUAL_INT( 0, pthread_rwlock_unlock( &xRwlock ) );
+
+        ( void ) pthread_create( &xNewThread, NULL, prvTryRwlockThread, &xRwlock );
+        ( void ) pthread_join( xNewThread, ( void ** ) &xThreadReturnValue );
+        TEST_ASSERT_EQUAL_INT( 3, ( int ) xThreadReturnValue );
+    }
+
+    /* Destroy the lock. */
+    iStatus = pthread_rwlock_destroy( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    /* A lock can be initialized again after it has been destroyed. */
+    iStatus = pthread_rwlock_init( &xRwlock, NULL );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+    iStatus = pthread_rwlock_destroy( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+}
+
+/*-----------------------------------------------------------*/
+
 TEST( Full_POSIX_PTHREAD, pthread_cond_signal )
 {
     int iStatus = 0;
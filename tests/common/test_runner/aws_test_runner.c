@@ -55,6 +55,10 @@ char cBuffer[ testrunnerBUFFER_SIZE ];
 /* Heap leak variables. */
 unsigned int xHeapBefore;
 unsigned int xHeapAfter;
+
+#if ( configUSE_HEAP_PROFILER == 1 )
+    HeapProfilerSnapshot_t xHeapSnapshotBefore;
+#endif
 /*-----------------------------------------------------------*/
 
 /* This function will be generated by the test automation framework,
@@ -111,6 +115,14 @@ static void RunTests( void )
         RUN_TEST_GROUP( Full_OTA_AGENT );
     #endif
 
+    #if ( testrunnerFULL_OTA_DELTA_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_OTA_DELTA );
+    #endif
+
+    #if ( testrunnerFULL_OTA_HTTP_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_OTA_HTTP );
+    #endif
+
     #if ( testrunnerFULL_OTA_PAL_ENABLED == 1 )
         RUN_TEST_GROUP( Full_OTA_PAL );
     #endif
@@ -173,6 +185,10 @@ void TEST_RUNNER_RunTests_task( void * pvParameters )
     /* Measure the heap size before any tests are run. */
     #if ( testrunnerFULL_MEMORYLEAK_ENABLED == 1 )
         xHeapBefore = xPortGetFreeHeapSize();
+
+        #if ( configUSE_HEAP_PROFILER == 1 )
+            vHeapProfilerGetSnapshot( &xHeapSnapshotBefore );
+        #endif
     #endif
 
     RunTests();
@@ -33,6 +33,9 @@
 /* Secure sockets includes */
 #include "aws_secure_sockets.h"
 
+/* TLS includes. */
+#include "aws_tls.h"
+
 /* Credential includes. */
 #include "aws_clientcredential.h"
 #include "aws_test_tls.h"
@@ -83,6 +86,8 @@ TEST_GROUP_RUNNER( Full_TLS )
     RUN_TEST_CASE( Full_TLS, AFQP_TLS_ConnectMalformedCert );
     RUN_TEST_CASE( Full_TLS, AFQP_TLS_ConnectUntrustedCert );
     RUN_TEST_CASE( Full_TLS, AFQP_TLS_ConnectBYOCCredentials );
+    RUN_TEST_CASE( Full_TLS, AFQP_TLS_ReleaseIdleRecordBuffers );
+    RUN_TEST_CASE( Full_TLS, AFQP_TLS_RecvZeroCopy );
 }
 
 /*-----------------------------------------------------------*/
@@ -111,6 +116,128 @@ static void prvSecureSocketClose( Socket_t xSocket )
 }
 /*-----------------------------------------------------------*/
 
+/* Network receive callback for TLS_Init(), over a socket without TLS. */
+static BaseType_t prvSocketRecv( void * pvCallerContext,
+                                 unsigned char * pucReceiveBuffer,
+                                 size_t xReceiveLength )
+{
+    int32_t lResult;
+
+    lResult = SOCKETS_Recv( ( Socket_t ) pvCallerContext, pucReceiveBuffer, xReceiveLength, 0 );
+
+    /* A timeout is reported as no data. */
+    if( SOCKETS_EWOULDBLOCK == lResult )
+    {
+        lResult = 0;
+    }
+
+    return ( BaseType_t ) lResult;
+}
+/*-----------------------------------------------------------*/
+
+/* Network send callback for TLS_Init(), over a socket without TLS. */
+static BaseType_t prvSocketSend( void * pvCallerContext,
+                                 const unsigned char * pucData,
+                                 size_t xDataLength )
+{
+    return ( BaseType_t ) SOCKETS_Send( ( Socket_t ) pvCallerContext, pucData, xDataLength, 0 );
+}
+/*-----------------------------------------------------------*/
+
+/* Bytes received for the zero-copy callbacks, where TLS decrypts them. */
+static unsigned char ucReceived[ 512 ];
+static size_t xReceivedStart = 0;
+static size_t xReceivedLength = 0;
+
+/* Network zero-copy receive callback for TLS_Init(), over a socket without
+ * TLS. */
+static BaseType_t prvSocketRecvZeroCopy( void * pvCallerContext,
+                                         unsigned char ** ppucData )
+{
+    BaseType_t xResult = 0;
+
+    if( 0 == xReceivedLength )
+    {
+        xReceivedStart = 0;
+        xResult = prvSocketRecv( pvCallerContext, ucReceived, sizeof( ucReceived ) );
+    }
+
+    if( 0 <= xResult )
+    {
+        xReceivedLength += ( size_t ) xResult;
+        *ppucData = &ucReceived[ xReceivedStart ];
+        xResult = ( BaseType_t ) xReceivedLength;
+    }
+
+    return xResult;
+}
+/*-----------------------------------------------------------*/
+
+/* Network zero-copy release callback for TLS_Init(). */
+static void prvSocketRecvRelease( void * pvCallerContext,
+                                  size_t xLength )
+{
+    ( void ) pvCallerContext;
+
+    xReceivedStart += xLength;
+    xReceivedLength -= xLength;
+}
+/*-----------------------------------------------------------*/
+
+/* Network receive callback for TLS_Init() used with the zero-copy callbacks,
+ * which returns the bytes they hold first. */
+static BaseType_t prvSocketRecvHeld( void * pvCallerContext,
+                                     unsigned char * pucReceiveBuffer,
+                                     size_t xReceiveLength )
+{
+    BaseType_t xResult;
+
+    if( 0 != xReceivedLength )
+    {
+        xResult = ( BaseType_t ) ( ( xReceiveLength < xReceivedLength ) ? xReceiveLength : xReceivedLength );
+        memcpy( pucReceiveBuffer, &ucReceived[ xReceivedStart ], ( size_t ) xResult );
+        prvSocketRecvRelease( pvCallerContext, ( size_t ) xResult );
+    }
+    else
+    {
+        xResult = prvSocketRecv( pvCallerContext, pucReceiveBuffer, xReceiveLength );
+    }
+
+    return xResult;
+}
+/*-----------------------------------------------------------*/
+
+/* Receives until a whole TLS record is held for the zero-copy callbacks, so
+ * that TLS decrypts it where it is. */
+static void prvReceiveWholeRecord( Socket_t xSocket )
+{
+    size_t xRecordLength = 5;
+    uint32_t ulAttempt;
+    BaseType_t xResult;
+
+    if( 0 == xReceivedLength )
+    {
+        xReceivedStart = 0;
+    }
+
+    for( ulAttempt = 0; ( ulAttempt < 50 ) && ( xReceivedLength < xRecordLength ); ulAttempt++ )
+    {
+        xResult = prvSocketRecv( xSocket,
+                                 &ucReceived[ xReceivedStart + xReceivedLength ],
+                                 sizeof( ucReceived ) - xReceivedStart - xReceivedLength );
+        TEST_ASSERT_GREATER_THAN_INT32_MESSAGE( -1, xResult, "Socket receive failed" );
+        xReceivedLength += ( size_t ) xResult;
+
+        if( xReceivedLength >= 5 )
+        {
+            xRecordLength = 5 + ( ( ( size_t ) ucReceived[ xReceivedStart + 3 ] << 8 ) | ( size_t ) ucReceived[ xReceivedStart + 4 ] );
+        }
+    }
+
+    TEST_ASSERT_MESSAGE( xReceivedLength >= xRecordLength, "No whole TLS record was received" );
+}
+/*-----------------------------------------------------------*/
+
 static void prvConnectWithProvisioning( ProvisioningParams_t * pxProvisioningParams,
                                         BaseType_t xConnectExpectedToSucceed )
 {
@@ -344,3 +471,188 @@ TEST( Full_TLS, AFQP_TLS_ConnectBYOCCredentials )
                                 );
 }
 /*-----------------------------------------------------------*/
+
+TEST( Full_TLS, AFQP_TLS_ReleaseIdleRecordBuffers )
+{
+    const char * pcAWSIoTAddress = clientcredentialMQTT_BROKER_ENDPOINT;
+    uint16_t usAWSIoTPort = clientcredentialMQTT_BROKER_PORT;
+    SocketsSockaddr_t xMQTTServerAddress = { 0 };
+    TickType_t xTimeout = pdMS_TO_TICKS( 100 );
+    TLSParams_t xTLSParams = { 0 };
+    TLSMemoryStats_t xStats;
+    void * pvTLSContext = NULL;
+    unsigned char ucByte;
+    Socket_t xSocket;
+    BaseType_t xResult;
+
+    xMQTTServerAddress.ulAddress = SOCKETS_GetHostByName( pcAWSIoTAddress );
+    xMQTTServerAddress.usPort = SOCKETS_htons( usAWSIoTPort );
+    xMQTTServerAddress.ucSocketDomain = SOCKETS_AF_INET;
+
+    /* TLS is run over the socket here rather than by secure sockets, so the
+     * TLS context can be queried. */
+    xSocket = SOCKETS_Socket( SOCKETS_AF_INET, SOCKETS_SOCK_STREAM, SOCKETS_IPPROTO_TCP );
+    TEST_ASSERT_NOT_EQUAL( xSocket, SOCKETS_INVALID_SOCKET );
+
+    if( TEST_PROTECT() )
+    {
+        xResult = SOCKETS_SetSockOpt( xSocket, 0, SOCKETS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, xResult, "Socket set sock opt receive timeout failed" );
+
+        xResult = SOCKETS_Connect( xSocket, &xMQTTServerAddress, sizeof( xMQTTServerAddress ) );
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, xResult, "Socket connect failed" );
+
+        xTLSParams.ulSize = sizeof( xTLSParams );
+        xTLSParams.pcDestination = pcAWSIoTAddress;
+        xTLSParams.pxNetworkRecv = prvSocketRecv;
+        xTLSParams.pxNetworkSend = prvSocketSend;
+        xTLSParams.pvCallerContext = xSocket;
+
+        xResult = TLS_Init( &pvTLSContext, &xTLSParams );
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( 0, xResult, "TLS init failed" );
+
+        xResult = TLS_Connect( pvTLSContext );
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( 0, xResult, "TLS connect failed" );
+
+        /* The full size record buffers used for the handshake are freed once
+         * it completes. */
+        xResult = TLS_GetMemoryStats( pvTLSContext, &xStats );
+        TEST_ASSERT_EQUAL_INT32( 0, xResult );
+        TEST_ASSERT_GREATER_THAN( 0, xStats.xPeakRecordBufferBytes );
+        TEST_ASSERT_EQUAL( 0, xStats.xRecordBufferBytes );
+
+        /* The broker sends nothing until it receives an MQTT CONNECT, so
+         * waiting for data must not allocate the record buffers. */
+        xResult = TLS_Recv( pvTLSContext, &ucByte, sizeof( ucByte ) );
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( 0, xResult, "TLS receive on an idle connection failed" );
+
+        xResult = TLS_GetMemoryStats( pvTLSContext, &xStats );
+        TEST_ASSERT_EQUAL_INT32( 0, xResult );
+        TEST_ASSERT_EQUAL( 0, xStats.xRecordBufferBytes );
+    }
+
+    TLS_Cleanup( pvTLSContext );
+    prvSecureSocketClose( xSocket );
+}
+/*-----------------------------------------------------------*/
+
+TEST( Full_TLS, AFQP_TLS_RecvZeroCopy )
+{
+    const char * pcAWSIoTAddress = clientcredentialMQTT_BROKER_ENDPOINT;
+    uint16_t usAWSIoTPort = clientcredentialMQTT_BROKER_PORT;
+    SocketsSockaddr_t xMQTTServerAddress = { 0 };
+    TickType_t xTimeout = pdMS_TO_TICKS( 100 );
+    TLSParams_t xTLSParams = { 0 };
+    TLSMemoryStats_t xStats;
+    void * pvTLSContext = NULL;
+    const unsigned char * pucData = NULL;
+    const unsigned char * pucConnack = NULL;
+    const unsigned char ucExpectedConnack[] = { 0x20, 0x02, 0x00, 0x00 };
+    unsigned char ucConnect[ 64 ];
+    size_t xClientIdLength = strlen( clientcredentialIOT_THING_NAME );
+    size_t xBytesCopied;
+    Socket_t xSocket;
+    BaseType_t xResult;
+
+    xMQTTServerAddress.ulAddress = SOCKETS_GetHostByName( pcAWSIoTAddress );
+    xMQTTServerAddress.usPort = SOCKETS_htons( usAWSIoTPort );
+    xMQTTServerAddress.ucSocketDomain = SOCKETS_AF_INET;
+    xReceivedStart = 0;
+    xReceivedLength = 0;
+
+    xSocket = SOCKETS_Socket( SOCKETS_AF_INET, SOCKETS_SOCK_STREAM, SOCKETS_IPPROTO_TCP );
+    TEST_ASSERT_NOT_EQUAL( xSocket, SOCKETS_INVALID_SOCKET );
+
+    if( TEST_PROTECT() )
+    {
+        xResult = SOCKETS_SetSockOpt( xSocket, 0, SOCKETS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, xResult, "Socket set sock opt receive timeout failed" );
+
+        xResult = SOCKETS_Connect( xSocket, &xMQTTServerAddress, sizeof( xMQTTServerAddress ) );
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( SOCKETS_ERROR_NONE, xResult, "Socket connect failed" );
+
+        xTLSParams.ulSize = sizeof( xTLSParams );
+        xTLSParams.pcDestination = pcAWSIoTAddress;
+        xTLSParams.pxNetworkRecv = prvSocketRecvHeld;
+        xTLSParams.pxNetworkSend = prvSocketSend;
+        xTLSParams.pxNetworkRecvZeroCopy = prvSocketRecvZeroCopy;
+        xTLSParams.pxNetworkRecvRelease = prvSocketRecvRelease;
+        xTLSParams.pvCallerContext = xSocket;
+
+        xResult = TLS_Init( &pvTLSContext, &xTLSParams );
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( 0, xResult, "TLS init failed" );
+
+        xResult = TLS_Connect( pvTLSContext );
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( 0, xResult, "TLS connect failed" );
+
+        /* The broker sends nothing until it receives an MQTT CONNECT, so no
+         * data is lent and the record buffers are not allocated. */
+        xResult = TLS_RecvZeroCopy( pvTLSContext, &pucData );
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( 0, xResult, "TLS zero-copy receive on an idle connection failed" );
+        TEST_ASSERT_NULL( pucData );
+
+        xResult = TLS_GetMemoryStats( pvTLSContext, &xStats );
+        TEST_ASSERT_EQUAL_INT32( 0, xResult );
+        TEST_ASSERT_EQUAL( 0, xStats.xRecordBufferBytes );
+
+        /* Nothing can be released when nothing is lent. */
+        xResult = TLS_RecvRelease( pvTLSContext, 1 );
+        TEST_ASSERT_LESS_THAN( 0, xResult );
+
+        xBytesCopied = xStats.xBytesCopied;
+
+        /* An MQTT 3.1.1 CONNECT with a clean session, a 60 second keep alive
+         * and the thing name as client identifier, so the broker answers with
+         * a CONNACK. */
+        TEST_ASSERT_LESS_THAN( sizeof( ucConnect ) - 14, xClientIdLength );
+        ucConnect[ 0 ] = 0x10;
+        ucConnect[ 1 ] = ( unsigned char ) ( 12 + xClientIdLength );
+        memcpy( &ucConnect[ 2 ], "\x00\x04MQTT\x04\x02\x00\x3c", 10 );
+        ucConnect[ 12 ] = ( unsigned char ) ( xClientIdLength >> 8 );
+        ucConnect[ 13 ] = ( unsigned char ) xClientIdLength;
+        memcpy( &ucConnect[ 14 ], clientcredentialIOT_THING_NAME, xClientIdLength );
+
+        xResult = TLS_Send( pvTLSContext, ucConnect, 14 + xClientIdLength );
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( 14 + xClientIdLength, xResult, "TLS send failed" );
+
+        /* The CONNACK record is decrypted where it was received and lent from
+         * there, without allocating the receive record buffer. */
+        prvReceiveWholeRecord( xSocket );
+
+        xResult = TLS_RecvZeroCopy( pvTLSContext, &pucConnack );
+        TEST_ASSERT_EQUAL_INT32_MESSAGE( sizeof( ucExpectedConnack ), xResult, "TLS zero-copy receive of the CONNACK failed" );
+        TEST_ASSERT_EQUAL_HEX8_ARRAY( ucExpectedConnack, pucConnack, sizeof( ucExpectedConnack ) );
+        TEST_ASSERT_TRUE( ( pucConnack >= ucReceived ) && ( pucConnack < &ucReceived[ sizeof( ucReceived ) ] ) );
+
+        xResult = TLS_GetMemoryStats( pvTLSContext, &xStats );
+        TEST_ASSERT_EQUAL_INT32( 0, xResult );
+        TEST_ASSERT_GREATER_THAN( 0, xStats.xBytesDecryptedInPlace );
+        TEST_ASSERT_EQUAL( xBytesCopied, xStats.xBytesCopied );
+
+        /* Releasing part of the data lends the rest. */
+        xResult = TLS_RecvRelease( pvTLSContext, 2 );
+        TEST_ASSERT_EQUAL_INT32( 0, xResult );
+
+        xResult = TLS_RecvZeroCopy( pvTLSContext, &pucData );
+        TEST_ASSERT_EQUAL_INT32( 2, xResult );
+        TEST_ASSERT_EQUAL_PTR( pucConnack + 2, pucData );
+
+        xResult = TLS_RecvRelease( pvTLSContext, 2 );
+        TEST_ASSERT_EQUAL_INT32( 0, xResult );
+
+        /* The record is handed back to the network once it is all released. */
+        TEST_ASSERT_EQUAL( 0, xReceivedLength );
+
+        xResult = TLS_RecvZeroCopy( pvTLSContext, &pucData );
+        TEST_ASSERT_EQUAL_INT32( 0, xResult );
+        TEST_ASSERT_NULL( pucData );
+
+        xResult = TLS_GetMemoryStats( pvTLSContext, &xStats );
+        TEST_ASSERT_EQUAL_INT32( 0, xResult );
+        TEST_ASSERT_EQUAL( 0, xStats.xRecordBufferBytes );
+    }
+
+    TLS_Cleanup( pvTLSContext );
+    prvSecureSocketClose( xSocket );
+}
+/*-----------------------------------------------------------*/
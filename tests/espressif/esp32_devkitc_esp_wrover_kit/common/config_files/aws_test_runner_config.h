@@ -36,6 +36,8 @@
 
 /* Enable tests by setting defines to 1 */
 #define testrunnerFULL_OTA_AGENT_ENABLED           0
+#define testrunnerFULL_OTA_DELTA_ENABLED           0
+#define testrunnerFULL_OTA_HTTP_ENABLED            0
 #define testrunnerFULL_OTA_PAL_ENABLED             0
 #define testrunnerFULL_MQTT_ALPN_ENABLED           0
 #define testrunnerFULL_PKCS11_ENABLED              0
@@ -33,6 +33,8 @@
 
 #define testrunnerFULL_OTA_CBOR_ENABLED            testrunnerUNSUPPORTED
 #define testrunnerFULL_OTA_AGENT_ENABLED           testrunnerUNSUPPORTED
+#define testrunnerFULL_OTA_DELTA_ENABLED           testrunnerUNSUPPORTED
+#define testrunnerFULL_OTA_HTTP_ENABLED            testrunnerUNSUPPORTED
 #define testrunnerFULL_OTA_PAL_ENABLED             testrunnerUNSUPPORTED
 
 /* Enable tests by setting defines to 1 */
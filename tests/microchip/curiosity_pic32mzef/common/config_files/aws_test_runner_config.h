@@ -57,6 +57,8 @@
 #define testrunnerFULL_TCP_ENABLED                 1
 #define testrunnerFULL_TLS_ENABLED                 0
 #define testrunnerFULL_OTA_AGENT_ENABLED           0
+#define testrunnerFULL_OTA_DELTA_ENABLED           0
+#define testrunnerFULL_OTA_HTTP_ENABLED            0
 #define testrunnerFULL_OTA_PAL_ENABLED             0
 #define testrunnerOTA_END_TO_END_ENABLED           0
 
@@ -43,4 +43,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #define ggdconfigJSON_MAX_TOKENS            ( 128 )
 
+/**
+ * @brief Remember the core found by discovery for fast reconnects.
+ */
+#define ggdconfigENABLE_DISCOVERY_CACHE     ( 1 )
+
 #endif /* _AWS_GGD_CONFIG_H_ */
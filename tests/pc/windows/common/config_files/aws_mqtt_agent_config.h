@@ -98,6 +98,11 @@
  */
 #define mqttconfigRX_BUFFER_SIZE               ( 1024 + 128 )
 
+/**
+ * @brief Parse received data where the FreeRTOS+TCP secure sockets port holds it.
+ */
+#define mqttconfigENABLE_ZERO_COPY_RECEIVE     ( 1 )
+
 /**
  * @brief The maximum time in ticks for which the MQTT task is permitted to block.
  */
@@ -55,6 +55,8 @@
 #define testrunnerFULL_MEMORYLEAK_ENABLED          0
 #define testrunnerFULL_OTA_CBOR_ENABLED            0
 #define testrunnerFULL_OTA_AGENT_ENABLED           0
+#define testrunnerFULL_OTA_DELTA_ENABLED           0
+#define testrunnerFULL_OTA_HTTP_ENABLED            0
 #define testrunnerFULL_OTA_PAL_ENABLED             0
 #define testrunnerOTA_END_TO_END_ENABLED           0
 
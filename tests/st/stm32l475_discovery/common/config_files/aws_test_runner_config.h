@@ -34,6 +34,8 @@
 /* Unsupported tests. */
 #define testrunnerFULL_OTA_CBOR_ENABLED            testrunnerUNSUPPORTED
 #define testrunnerFULL_OTA_AGENT_ENABLED           testrunnerUNSUPPORTED
+#define testrunnerFULL_OTA_DELTA_ENABLED           testrunnerUNSUPPORTED
+#define testrunnerFULL_OTA_HTTP_ENABLED            testrunnerUNSUPPORTED
 #define testrunnerFULL_OTA_PAL_ENABLED             testrunnerUNSUPPORTED
 #define testrunnerFULL_MQTT_ALPN_ENABLED           testrunnerUNSUPPORTED
 
@@ -0,0 +1,235 @@
+#!/usr/bin/python
+"""Reports on heap profiler dumps written by vHeapProfilerDump() (lib/FreeRTOS/heap_profiler.c).
+
+Prints the heap's free space and fragmentation, the current and peak bytes
+allocated by each tag and task, and the blocks in the dump grouped by the
+address they were allocated from, largest first.  Given two dumps, prints the
+change in each tag and task, and the blocks in the second dump that are not in
+the first, which are typically leaks.
+
+Usage:
+    heap_report.py dump.txt [--elf aws_demos]
+    heap_report.py before.txt after.txt [--elf aws_demos]
+
+A dump can be embedded in other logging - only the text from "heapprof" to the
+end of each line is read, and if a file holds several dumps the last is used.
+With --elf, call sites are converted to function names and source lines by
+addr2line.  This only works if the image was not relocated when it was loaded,
+so not for position independent executables such as the Linux simulator.
+
+Each line of the dump is "heapprof" followed by one of:
+    version <format version> <next sequence> <since sequence> <blocks recorded> <blocks not recorded>
+    heap <free bytes> <minimum ever free bytes> <largest free block> <smallest free block> <free blocks> <allocations> <frees>
+    tag <tag> <current bytes> <peak bytes> <allocations> <frees> <failures> <name>
+    task <index> <current bytes> <peak bytes> <allocations> <frees> <failures> <deleted> <name>
+    alloc <address> <size> <tag> <task index> <call site> <sequence>
+    end <blocks written>
+The heap line is only written if the profiler reads the heap statistics.  Only
+blocks allocated after the "since" sequence number are written.
+"""
+
+import argparse
+import subprocess
+import sys
+
+DUMP_VERSION = 1
+NO_TASK = 0xff
+
+
+class DumpError(Exception):
+    pass
+
+
+class Dump(object):
+    """One dump read from a file."""
+
+    def __init__(self, file_name):
+        with open(file_name, "r") as dump_file:
+            lines = [line[line.index("heapprof"):].split(None, 8)
+                     for line in dump_file if "heapprof" in line]
+
+        # Use the last complete dump in the file.
+        starts = [index for index, fields in enumerate(lines) if fields[1:2] == ["version"]]
+        if not starts:
+            raise DumpError("%s: no heap profiler dump found" % file_name)
+        lines = lines[starts[-1]:]
+        if lines[-1][1:2] != ["end"]:
+            raise DumpError("%s: the dump is incomplete" % file_name)
+
+        self.heap = None
+        self.tags = {}
+        self.tasks = {}
+        self.blocks = {}
+
+        for fields in lines:
+            kind = fields[1]
+            values = fields[2:]
+            if kind == "version":
+                if int(values[0]) != DUMP_VERSION:
+                    raise DumpError("%s: unsupported dump version %s" % (file_name, values[0]))
+                (self.sequence, self.since, self.recorded, self.untracked) = [int(value) for value in values[1:5]]
+            elif kind == "heap":
+                self.heap = [int(value) for value in values[:7]]
+            elif kind == "tag":
+                # The name is the rest of the line, and may be empty or contain spaces.
+                numbers = " ".join(values).split(None, 6)
+                self.tags[int(numbers[0])] = Totals(numbers[1:6], numbers[6] if len(numbers) > 6 else "")
+            elif kind == "task":
+                numbers = " ".join(values).split(None, 7)
+                totals = Totals(numbers[1:6], numbers[7] if len(numbers) > 7 else "")
+                totals.deleted = numbers[6] == "1"
+                self.tasks[int(numbers[0])] = totals
+            elif kind == "alloc":
+                (address, size, tag, task, call_site, sequence) = values[:6]
+                self.blocks[(int(address, 16), int(sequence))] = Block(
+                    int(size), int(tag), int(task), int(call_site, 16))
+
+    def tag_name(self, tag):
+        if tag in self.tags and self.tags[tag].name:
+            return "%d %s" % (tag, self.tags[tag].name)
+        return "%d" % tag
+
+    def task_name(self, task):
+        if task == NO_TASK:
+            return "(none)"
+        if task in self.tasks:
+            return self.tasks[task].name + (" (deleted)" if self.tasks[task].deleted else "")
+        return "task %d" % task
+
+
+class Totals(object):
+    def __init__(self, numbers, name):
+        (self.current, self.peak, self.allocations, self.frees, self.failures) = [int(number) for number in numbers]
+        self.name = name.strip()
+        self.deleted = False
+
+
+class Block(object):
+    def __init__(self, size, tag, task, call_site):
+        self.size = size
+        self.tag = tag
+        self.task = task
+        self.call_site = call_site
+
+
+class Symbols(object):
+    """Converts call sites to function names using addr2line, if an image is given."""
+
+    def __init__(self, elf_file):
+        self.elf_file = elf_file
+        self.names = {}
+
+    def lookup(self, call_sites):
+        missing = sorted(set(call_sites) - set(self.names))
+        if self.elf_file and missing:
+            try:
+                output = subprocess.check_output(
+                    ["addr2line", "-f", "-C", "-e", self.elf_file] + ["0x%x" % (address - 1) for address in missing])
+                output = output.decode("ascii", "replace").splitlines()
+                for (index, address) in enumerate(missing):
+                    self.names[address] = "%s %s" % (output[2 * index], output[2 * index + 1])
+            except (OSError, subprocess.CalledProcessError, IndexError) as error:
+                sys.stderr.write("addr2line failed: %s\n" % error)
+                self.elf_file = None
+
+    def name(self, call_site):
+        if call_site in self.names and not self.names[call_site].startswith("??"):
+            return "0x%x %s" % (call_site, self.names[call_site])
+        return "0x%x" % call_site
+
+
+def print_totals(title, totals, name):
+    print("%-24s %10s %10s %10s %10s %8s" % (title, "current", "peak", "allocs", "frees", "failed"))
+    for key in sorted(totals):
+        entry = totals[key]
+        print("%-24s %10d %10d %10d %10d %8d" % (
+            name(key), entry.current, entry.peak, entry.allocations, entry.frees, entry.failures))
+    print("")
+
+
+def print_delta(title, before, after, name):
+    print("%-24s %10s %10s %10s" % (title, "change", "allocs", "frees"))
+    for key in sorted(set(before) | set(after)):
+        old = before.get(key, Totals([0] * 5, ""))
+        new = after.get(key, Totals([0] * 5, ""))
+        if (new.current, new.allocations, new.frees) != (old.current, old.allocations, old.frees):
+            print("%-24s %+10d %10d %10d" % (
+                name(key), new.current - old.current, new.allocations - old.allocations, new.frees - old.frees))
+    print("")
+
+
+def print_blocks(title, dump, blocks, symbols):
+    """Prints the blocks grouped by call site, tag and task, largest total first."""
+    groups = {}
+    for block in blocks:
+        key = (block.call_site, block.tag, block.task)
+        (count, size) = groups.get(key, (0, 0))
+        groups[key] = (count + 1, size + block.size)
+
+    symbols.lookup([key[0] for key in groups])
+
+    print("%s: %d blocks, %d bytes" % (title, len(blocks), sum(block.size for block in blocks)))
+    print("%10s %7s  %-16s %-20s %s" % ("bytes", "blocks", "tag", "task", "call site"))
+    for (key, (count, size)) in sorted(groups.items(), key=lambda item: -item[1][1]):
+        print("%10d %7d  %-16s %-20s %s" % (
+            size, count, dump.tag_name(key[1]), dump.task_name(key[2]), symbols.name(key[0])))
+    print("")
+
+
+def print_report(dump, symbols):
+    print("%d blocks recorded, %d not recorded as the table was full" % (dump.recorded, dump.untracked))
+    if dump.heap:
+        (free, minimum, largest, smallest, free_blocks, allocations, frees) = dump.heap
+        fragmentation = 100.0 * (1.0 - float(largest) / free) if free else 0.0
+        print("Heap: %d bytes free, minimum ever %d, %d free blocks from %d to %d bytes, %.1f%% fragmented" % (
+            free, minimum, free_blocks, smallest, largest, fragmentation))
+        print("      %d allocations, %d frees" % (allocations, frees))
+    print("")
+
+    print_totals("Tag", dump.tags, dump.tag_name)
+    print_totals("Task", dump.tasks, dump.task_name)
+
+    if dump.since:
+        title = "Blocks allocated after sequence %d" % dump.since
+    else:
+        title = "Blocks allocated"
+    print_blocks(title, dump, list(dump.blocks.values()), symbols)
+
+
+def print_diff(before, after, symbols):
+    print_delta("Tag", before.tags, after.tags, after.tag_name)
+    print_delta("Task", before.tasks, after.tasks, after.task_name)
+
+    # Blocks are identified by address and sequence number, as an address can
+    # be reused.  Only blocks in both dumps' ranges can be compared.
+    new_blocks = [block for (key, block) in after.blocks.items()
+                  if key not in before.blocks and key[1] >= before.since]
+    print_blocks("Blocks in the second dump that are not in the first", after, new_blocks, symbols)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Report on FreeRTOS heap profiler dumps.")
+    parser.add_argument("dumps", nargs="+", metavar="DUMP", help="one dump to report on, or two to compare")
+    parser.add_argument("--elf", help="the image the dump came from, to look up call sites")
+    args = parser.parse_args()
+
+    if len(args.dumps) > 2:
+        parser.error("give one dump to report on, or two to compare")
+
+    try:
+        dumps = [Dump(file_name) for file_name in args.dumps]
+    except (DumpError, ValueError, IndexError) as error:
+        sys.stderr.write("%s\n" % error)
+        return 1
+
+    symbols = Symbols(args.elf)
+    if len(dumps) == 1:
+        print_report(dumps[0], symbols)
+    else:
+        print_diff(dumps[0], dumps[1], symbols)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,359 @@
+#!/usr/bin/python
+"""Decodes trace data saved from the FreeRTOS trace ring (lib/FreeRTOS/trace_ring.c).
+
+Prints a summary of the trace, the time each task ran, a histogram of
+scheduling latency (the time from a task becoming ready to it running) and a
+histogram of blocking time (the time from a task blocking to it becoming ready
+again) for each reason a task blocks.  Optionally writes the trace in the
+Chrome trace event format, which can be opened in chrome://tracing or
+https://ui.perfetto.dev.
+
+Usage:
+    trace_decode.py kernel_trace.bin [--chrome trace.json]
+
+The trace data is the block of memory returned by pvTraceRingGetData(), saved
+to a file by the application or by a debugger.  For example, with GDB:
+    call pvTraceRingGetData(&xSize)
+    dump binary memory kernel_trace.bin $ $+xSize
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_RING_MAGIC = 0x52545246
+TRACE_RING_VERSION = 1
+
+# Event identifiers, from trace_ring.h.
+EVENT_TASK_CREATE = 1
+EVENT_TASK_DELETE = 2
+EVENT_TASK_SWITCHED_IN = 3
+EVENT_TASK_READY = 4
+EVENT_TASK_BLOCK = 5
+EVENT_QUEUE_SEND = 6
+EVENT_QUEUE_RECEIVE = 7
+EVENT_ISR_ENTER = 8
+EVENT_ISR_EXIT = 9
+EVENT_IP = 10
+EVENT_USER = 11
+
+BLOCK_REASONS = {
+    1: "queue send",
+    2: "queue receive",
+    3: "delay",
+    4: "notification",
+    5: "event group",
+    6: "stream buffer send",
+    7: "stream buffer receive",
+}
+
+IP_EVENTS = {
+    1: "network interface receive",
+    2: "network interface transmit",
+    3: "network event received",
+    4: "sending UDP packet",
+    5: "failed to obtain network buffer",
+    6: "Ethernet RX event lost",
+    7: "stack TX event lost",
+}
+
+# Queue types, from queue.h.
+QUEUE_TYPES = {
+    0: "queue",
+    1: "mutex",
+    2: "counting semaphore",
+    3: "binary semaphore",
+    4: "recursive mutex",
+}
+
+HEADER_FORMAT = "IHHHHIIIIII"
+EVENT_FORMAT = "IBBHII"
+
+
+class TraceError(Exception):
+    pass
+
+
+class Trace(object):
+    """The decoded trace data, with timestamps converted to nanoseconds."""
+
+    def __init__(self, data):
+        for byte_order in ("<", ">"):
+            (magic,) = struct.unpack_from(byte_order + "I", data, 0)
+            if magic == TRACE_RING_MAGIC:
+                break
+        else:
+            raise TraceError("not trace ring data, or pvTraceRingGetData() was not called")
+
+        header = struct.unpack_from(byte_order + HEADER_FORMAT, data, 0)
+        (_, version, event_size, self.core_count, name_length,
+         self.events_per_core, self.timestamp_hz, stop_timestamp, recording,
+         name_slots, names_recorded) = header
+
+        if version != TRACE_RING_VERSION:
+            raise TraceError("unsupported trace version %d" % version)
+        if event_size != struct.calcsize("<" + EVENT_FORMAT):
+            raise TraceError("unexpected event size %d" % event_size)
+
+        offset = struct.calcsize("<" + HEADER_FORMAT)
+
+        self.task_names = {}
+        for slot in range(min(name_slots, names_recorded)):
+            (task,) = struct.unpack_from(byte_order + "I", data, offset)
+            name = data[offset + 4:offset + 4 + name_length]
+            self.task_names[task] = name.split(b"\0", 1)[0].decode("ascii", "replace")
+            offset += 4 + name_length
+
+        offset += (name_slots - min(name_slots, names_recorded)) * (4 + name_length)
+
+        # Each core's events, oldest first, as (raw timestamp, event, arg1, arg2).
+        raw_cores = []
+        self.events_recorded = 0
+        self.events_lost = 0
+        for core in range(self.core_count):
+            (event_count,) = struct.unpack_from(byte_order + "I", data, offset)
+            offset += 8
+            held = min(event_count, self.events_per_core)
+            first = event_count - held
+            events = []
+            for index in range(first, event_count):
+                position = offset + (index % self.events_per_core) * event_size
+                (timestamp, event, _, _, arg1, arg2) = struct.unpack_from(
+                    byte_order + EVENT_FORMAT, data, position)
+                events.append((timestamp, event, arg1, arg2))
+            raw_cores.append(events)
+            self.events_recorded += event_count
+            self.events_lost += first
+            offset += self.events_per_core * event_size
+
+        if offset > len(data):
+            raise TraceError("trace data is truncated")
+
+        self.events = self._unwrap(raw_cores, stop_timestamp if recording == 0 else None)
+
+    def _unwrap(self, raw_cores, stop_timestamp):
+        """Returns every event as (time in ns, core, event, arg1, arg2), in time order.
+
+        The 32-bit timestamps wrap, so each core's events are walked back from
+        a point known to be after all of them - the time recording stopped if
+        it did, otherwise the latest event - adding a wrap whenever a
+        timestamp is greater than the one after it.  This is correct as long
+        as no two consecutive events on a core are a whole wrap apart.
+        """
+        if stop_timestamp is None:
+            newest = [events[-1][0] for events in raw_cores if events]
+            if not newest:
+                return []
+            # The latest of the newest events, comparing modulo 2^32.
+            stop_timestamp = newest[0]
+            for timestamp in newest[1:]:
+                if 0 < ((timestamp - stop_timestamp) & 0xffffffff) < 0x80000000:
+                    stop_timestamp = timestamp
+
+        scale = 1e9 / self.timestamp_hz
+        merged = []
+        for core, events in enumerate(raw_cores):
+            ticks = 0
+            later = stop_timestamp
+            for (timestamp, event, arg1, arg2) in reversed(events):
+                ticks -= (later - timestamp) & 0xffffffff
+                later = timestamp
+                merged.append((ticks * scale, core, event, arg1, arg2))
+
+        merged.sort(key=lambda entry: (entry[0], entry[1]))
+        if merged:
+            base = merged[0][0]
+            merged = [(entry[0] - base,) + entry[1:] for entry in merged]
+        return merged
+
+    def task_name(self, task):
+        if task in self.task_names:
+            return "%s (%d)" % (self.task_names[task], task)
+        return "task %d" % task
+
+
+class Analysis(object):
+    """Replays the events to find task run times, latencies and blocking times."""
+
+    def __init__(self, trace):
+        self.trace = trace
+        self.run_time = {}
+        self.switch_count = {}
+        self.scheduling_latency = {}
+        self.blocking_time = {}
+        self.slices = []            # (core, task, start, end)
+        self.isr_slices = []        # (core, isr, start, end)
+        self.instants = []          # (core, time, name, args)
+
+        running = [None] * trace.core_count
+        running_since = [None] * trace.core_count
+        isr_stack = [[] for _ in range(trace.core_count)]
+        ready_since = {}
+        blocked_since = {}
+        end = trace.events[-1][0] if trace.events else 0.0
+
+        for (time, core, event, arg1, arg2) in trace.events:
+            if event == EVENT_TASK_SWITCHED_IN:
+                self._end_slice(core, running[core], running_since[core], time)
+                running[core] = arg1
+                running_since[core] = time
+                self.switch_count[arg1] = self.switch_count.get(arg1, 0) + 1
+                if arg1 in ready_since:
+                    self.scheduling_latency.setdefault(arg1, []).append(
+                        time - ready_since.pop(arg1))
+            elif event == EVENT_TASK_READY:
+                if arg1 in blocked_since:
+                    (since, reason) = blocked_since.pop(arg1)
+                    self.blocking_time.setdefault(reason, []).append(time - since)
+                # A task can be made ready while it is still running on
+                # another core, in which case it is not waiting to run.
+                if arg1 not in running and arg1 not in ready_since:
+                    ready_since[arg1] = time
+            elif event == EVENT_TASK_BLOCK:
+                # Only known if the task's switch in was recorded.
+                if running[core] is not None:
+                    blocked_since[running[core]] = (time, arg2)
+                    ready_since.pop(running[core], None)
+                self.instants.append((core, time, "block: " + BLOCK_REASONS.get(arg2, str(arg2)),
+                                      {"object": "0x%08x" % arg1}))
+            elif event == EVENT_TASK_CREATE:
+                self.instants.append((core, time, "create " + trace.task_name(arg1),
+                                      {"priority": arg2}))
+            elif event == EVENT_TASK_DELETE:
+                ready_since.pop(arg1, None)
+                blocked_since.pop(arg1, None)
+                self.instants.append((core, time, "delete " + trace.task_name(arg1), {}))
+            elif event in (EVENT_QUEUE_SEND, EVENT_QUEUE_RECEIVE):
+                operation = "send" if event == EVENT_QUEUE_SEND else "receive"
+                self.instants.append((core, time, "%s %s" % (QUEUE_TYPES.get(arg2, "queue"), operation),
+                                      {"object": "0x%08x" % arg1}))
+            elif event == EVENT_ISR_ENTER:
+                isr_stack[core].append((arg1, time))
+            elif event == EVENT_ISR_EXIT:
+                if isr_stack[core]:
+                    (isr, start) = isr_stack[core].pop()
+                    self.isr_slices.append((core, isr, start, time))
+            elif event == EVENT_IP:
+                self.instants.append((core, time, "IP: " + IP_EVENTS.get(arg1, str(arg1)),
+                                      {"value": arg2}))
+            elif event == EVENT_USER:
+                self.instants.append((core, time, "user %d" % arg1, {"value": arg2}))
+
+        for core in range(trace.core_count):
+            self._end_slice(core, running[core], running_since[core], end)
+
+    def _end_slice(self, core, task, start, end):
+        if task is not None:
+            self.run_time[task] = self.run_time.get(task, 0.0) + (end - start)
+            self.slices.append((core, task, start, end))
+
+
+def format_time(ns):
+    if ns < 1e3:
+        return "%.0f ns" % ns
+    if ns < 1e6:
+        return "%.1f us" % (ns / 1e3)
+    if ns < 1e9:
+        return "%.1f ms" % (ns / 1e6)
+    return "%.2f s" % (ns / 1e9)
+
+
+def percentile(ordered, fraction):
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def print_histogram(title, samples):
+    """Prints samples in power of two buckets of nanoseconds."""
+    if not samples:
+        return
+    ordered = sorted(samples)
+    print("%s: %d samples, min %s, median %s, 99%% %s, max %s" % (
+        title, len(ordered), format_time(ordered[0]), format_time(percentile(ordered, 0.5)),
+        format_time(percentile(ordered, 0.99)), format_time(ordered[-1])))
+
+    buckets = {}
+    for sample in ordered:
+        bucket = max(0, int(sample)).bit_length()
+        buckets[bucket] = buckets.get(bucket, 0) + 1
+    largest = max(buckets.values())
+    for bucket in range(min(buckets), max(buckets) + 1):
+        count = buckets.get(bucket, 0)
+        low = 0 if bucket == 0 else 1 << (bucket - 1)
+        print("  %10s - %-10s %7d %s" % (format_time(low), format_time((1 << bucket) - 1), count,
+                                          "#" * int(round(40.0 * count / largest))))
+    print("")
+
+
+def print_report(trace, analysis):
+    duration = trace.events[-1][0] - trace.events[0][0] if trace.events else 0.0
+    print("%d core(s), %d events recorded, %d overwritten, %d decoded covering %s" % (
+        trace.core_count, trace.events_recorded, trace.events_lost, len(trace.events),
+        format_time(duration)))
+    print("")
+
+    print("Task run time:")
+    for task in sorted(analysis.run_time, key=lambda task: -analysis.run_time[task]):
+        share = 100.0 * analysis.run_time[task] / (duration * trace.core_count) if duration else 0.0
+        print("  %-24s %10s %5.1f%% %7d switches in" % (
+            trace.task_name(task), format_time(analysis.run_time[task]), share,
+            analysis.switch_count.get(task, 0)))
+    print("")
+
+    all_latencies = [sample for samples in analysis.scheduling_latency.values() for sample in samples]
+    print_histogram("Scheduling latency, all tasks", all_latencies)
+    for task in sorted(analysis.scheduling_latency):
+        print_histogram("Scheduling latency, " + trace.task_name(task),
+                        analysis.scheduling_latency[task])
+
+    for reason in sorted(analysis.blocking_time):
+        print_histogram("Blocking time, " + BLOCK_REASONS.get(reason, str(reason)),
+                        analysis.blocking_time[reason])
+
+
+def write_chrome_trace(trace, analysis, file_name):
+    events = [{"ph": "M", "pid": 0, "name": "process_name", "args": {"name": "FreeRTOS"}}]
+    for core in range(trace.core_count):
+        events.append({"ph": "M", "pid": 0, "tid": core, "name": "thread_name",
+                       "args": {"name": "Core %d" % core}})
+    for (core, task, start, end) in analysis.slices:
+        events.append({"ph": "X", "pid": 0, "tid": core, "cat": "task",
+                       "name": trace.task_name(task), "ts": start / 1e3, "dur": (end - start) / 1e3})
+    for (core, isr, start, end) in analysis.isr_slices:
+        events.append({"ph": "X", "pid": 0, "tid": core, "cat": "isr",
+                       "name": "ISR %d" % isr, "ts": start / 1e3, "dur": (end - start) / 1e3})
+    for (core, time, name, args) in analysis.instants:
+        events.append({"ph": "i", "s": "t", "pid": 0, "tid": core, "cat": "event",
+                       "name": name, "ts": time / 1e3, "args": args})
+
+    with open(file_name, "w") as chrome_file:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, chrome_file)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode FreeRTOS trace ring data.")
+    parser.add_argument("trace_file", help="trace data saved from pvTraceRingGetData()")
+    parser.add_argument("--chrome", metavar="JSON_FILE",
+                        help="also write the trace in the Chrome trace event format")
+    args = parser.parse_args()
+
+    with open(args.trace_file, "rb") as trace_file:
+        data = trace_file.read()
+
+    try:
+        trace = Trace(data)
+    except (TraceError, struct.error) as error:
+        sys.stderr.write("%s: %s\n" % (args.trace_file, error))
+        return 1
+
+    analysis = Analysis(trace)
+    print_report(trace, analysis)
+
+    if args.chrome:
+        write_chrome_trace(trace, analysis, args.chrome)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,184 @@
+#!/usr/bin/python
+"""Makes and applies delta update patches for OTA jobs (lib/ota/aws_ota_delta.c).
+
+A patch rebuilds a new image from the base image running on the device.  The
+OTA job that delivers it gives the patch as the file to download and the base
+image's application version as the file's "delta_base_version"; the file's
+signature is that of the new image, which the device checks after rebuilding
+it.  The format is described in lib/include/private/aws_ota_delta.h.
+
+Usage:
+    ota_delta.py make base.bin new.bin patch.bin
+    ota_delta.py apply base.bin patch.bin out.bin
+
+make finds runs of the new image that are also in the base image by looking
+up every MATCH_KEY_SIZE byte sequence of the new image in an index of the
+base image, preferring to carry on from where the last run was found, since
+code that moved tends to move together.  Runs too short to pay for a COPY
+command are sent as they are.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+MAGIC = 0x44524641  # "AFRD"
+OP_COPY = 0
+OP_INSERT = 1
+COPY_CMD_SIZE = 9
+INSERT_CMD_SIZE = 5
+MATCH_KEY_SIZE = 8
+MIN_COPY = COPY_CMD_SIZE + INSERT_CMD_SIZE + 2  # Shorter runs cost more than sending them.
+MAX_CANDIDATES = 4
+
+
+class PatchError(Exception):
+    pass
+
+
+def index_base(base):
+    """Map each MATCH_KEY_SIZE byte sequence of the base image to where it is."""
+    index = {}
+    for offset in range(len(base) - MATCH_KEY_SIZE + 1):
+        places = index.setdefault(base[offset:offset + MATCH_KEY_SIZE], [])
+        if len(places) < MAX_CANDIDATES:
+            places.append(offset)
+    return index
+
+
+def match_length(base, base_offset, new, new_offset):
+    """Return the number of bytes that are the same from the two offsets on."""
+    length = 0
+    limit = min(len(base) - base_offset, len(new) - new_offset)
+    step = 256
+    while length < limit:
+        count = min(step, limit - length)
+        if base[base_offset + length:base_offset + length + count] == new[new_offset + length:new_offset + length + count]:
+            length += count
+            continue
+        while count and base[base_offset + length] == new[new_offset + length]:
+            length += 1
+            count -= 1
+        break
+    return length
+
+
+def make_patch(base, new):
+    index = index_base(base)
+    commands = []
+    literal_start = 0
+    offset = 0
+    last_delta = None
+
+    def add_insert(end):
+        if end > literal_start:
+            commands.append((OP_INSERT, new[literal_start:end]))
+
+    while offset < len(new):
+        candidates = []
+        if last_delta is not None and 0 <= offset + last_delta < len(base):
+            candidates.append(offset + last_delta)
+        candidates.extend(index.get(new[offset:offset + MATCH_KEY_SIZE], ()))
+
+        best_base, best_length = None, 0
+        for base_offset in candidates:
+            length = match_length(base, base_offset, new, offset)
+            if length > best_length:
+                best_base, best_length = base_offset, length
+
+        if best_length < MIN_COPY:
+            offset += 1
+            continue
+
+        # Take back the end of the literal bytes if it also matches.
+        start = offset
+        while start > literal_start and best_base > 0 and base[best_base - 1] == new[start - 1]:
+            start -= 1
+            best_base -= 1
+            best_length += 1
+
+        add_insert(start)
+        commands.append((OP_COPY, best_base, best_length))
+        last_delta = best_base - start
+        offset = start + best_length
+        literal_start = offset
+
+    add_insert(len(new))
+
+    patch = [struct.pack("<III", MAGIC, len(base), len(new))]
+    for command in commands:
+        if command[0] == OP_COPY:
+            patch.append(struct.pack("<BII", OP_COPY, command[2], command[1]))
+        else:
+            patch.append(struct.pack("<BI", OP_INSERT, len(command[1])))
+            patch.append(command[1])
+    return b"".join(patch), commands
+
+
+def apply_patch(base, patch):
+    magic, base_size, new_size = struct.unpack_from("<III", patch, 0)
+    if magic != MAGIC:
+        raise PatchError("not a delta update patch")
+    if base_size != len(base):
+        raise PatchError("the patch is for a %u byte base image, not %u bytes" % (base_size, len(base)))
+    offset = 12
+    out = []
+    produced = 0
+    while produced < new_size:
+        op, length = struct.unpack_from("<BI", patch, offset)
+        if op == OP_COPY:
+            base_offset, = struct.unpack_from("<I", patch, offset + 5)
+            out.append(base[base_offset:base_offset + length])
+            offset += COPY_CMD_SIZE
+        elif op == OP_INSERT:
+            out.append(patch[offset + INSERT_CMD_SIZE:offset + INSERT_CMD_SIZE + length])
+            offset += INSERT_CMD_SIZE + length
+        else:
+            raise PatchError("bad command %u at patch offset %u" % (op, offset))
+        produced += length
+    if produced != new_size or offset != len(patch):
+        raise PatchError("the patch does not match its header")
+    return b"".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Make and apply OTA delta update patches.")
+    commands = parser.add_subparsers(dest="command")
+    make = commands.add_parser("make", help="make a patch from base to new")
+    make.add_argument("base")
+    make.add_argument("new")
+    make.add_argument("patch")
+    apply = commands.add_parser("apply", help="rebuild the new image from base and patch")
+    apply.add_argument("base")
+    apply.add_argument("patch")
+    apply.add_argument("out")
+    args = parser.parse_args()
+
+    try:
+        if args.command == "make":
+            base = open(args.base, "rb").read()
+            new = open(args.new, "rb").read()
+            start = time.time()
+            patch, patch_commands = make_patch(base, new)
+            if apply_patch(base, patch) != new:
+                raise PatchError("the patch does not rebuild the new image")
+            open(args.patch, "wb").write(patch)
+            copied = sum(command[2] for command in patch_commands if command[0] == OP_COPY)
+            print("%s: %u bytes for a %u byte image (%.1f%%), %u commands, %.1f%% of the image copied, %.1f s" % (
+                args.patch, len(patch), len(new), 100.0 * len(patch) / max(len(new), 1),
+                len(patch_commands), 100.0 * copied / max(len(new), 1), time.time() - start))
+        elif args.command == "apply":
+            base = open(args.base, "rb").read()
+            open(args.out, "wb").write(apply_patch(base, open(args.patch, "rb").read()))
+        else:
+            parser.print_help()
+            return 2
+    except (IOError, PatchError, struct.error) as error:
+        sys.stderr.write("%s\n" % error)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
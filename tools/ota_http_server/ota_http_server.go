@@ -0,0 +1,144 @@
+/*
+ * Amazon FreeRTOS OTA HTTP Server V1.0.0
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+// A stand-in for the server an OTA job's update_data_url points at. It serves
+// the files in a folder over HTTPS with range requests and keep-alive, and
+// logs the requests and throughput of each connection. Use the same
+// certificates as the echo server (see ../echo_server/readme-gencert.txt).
+//
+// Usage: go run ota_http_server.go [folder]
+package main
+
+import (
+	"log"
+	"net"
+	"net/http"
+	"os"
+	"sync"
+	"time"
+)
+
+//************** CONFIG SECTION *************//
+//Folder were certs are put
+const sCertPath string = "certs/"
+const sServerCert string = "server.pem"
+const sServerKey string = "server.key"
+const sSecurePort string = "9443"
+const sUnSecurePort string = "9080"
+const xIdleTimeoutSeconds = 300
+
+// The statistics of one client connection.
+type connectionStats struct {
+	xStart     time.Time
+	ulRequests uint64
+	ulBytes    uint64
+}
+
+var xStatsLock sync.Mutex
+var xStats = map[string]*connectionStats{}
+
+func main() {
+	sFolder := "."
+	if len(os.Args) > 1 {
+		sFolder = os.Args[1]
+	}
+
+	xFiles := http.FileServer(http.Dir(sFolder))
+	xHandler := http.HandlerFunc(func(xWriter http.ResponseWriter, xRequest *http.Request) {
+		xCounter := &countingWriter{ResponseWriter: xWriter}
+		xFiles.ServeHTTP(xCounter, xRequest)
+
+		xStatsLock.Lock()
+		if xConnStats, xFound := xStats[xRequest.RemoteAddr]; xFound {
+			xConnStats.ulRequests++
+			xConnStats.ulBytes += xCounter.ulBytes
+		}
+		xStatsLock.Unlock()
+
+		log.Printf("%s %s %s range %q -> %d, %d bytes", xRequest.RemoteAddr, xRequest.Method,
+			xRequest.URL.Path, xRequest.Header.Get("Range"), xCounter.lStatus, xCounter.ulBytes)
+	})
+
+	// The unsecure port is for host tests that talk to the client over plain TCP.
+	go serve(&http.Server{Addr: ":" + sUnSecurePort}, xHandler, false)
+	serve(&http.Server{Addr: ":" + sSecurePort}, xHandler, true)
+}
+
+func serve(xServer *http.Server, xHandler http.Handler, xSecure bool) {
+	xServer.Handler = xHandler
+	xServer.IdleTimeout = xIdleTimeoutSeconds * time.Second
+	xServer.ConnState = trackConnection
+
+	var xStatus error
+	if xSecure {
+		log.Print("Secure server listening to port " + xServer.Addr)
+		xStatus = xServer.ListenAndServeTLS(sCertPath+sServerCert, sCertPath+sServerKey)
+	} else {
+		log.Print("UnSecure server listening to port " + xServer.Addr)
+		xStatus = xServer.ListenAndServe()
+	}
+	log.Printf("Error %s while serving", xStatus)
+}
+
+// Log the throughput of each connection when it closes.
+func trackConnection(xConnection net.Conn, xState http.ConnState) {
+	sAddress := xConnection.RemoteAddr().String()
+
+	xStatsLock.Lock()
+	defer xStatsLock.Unlock()
+
+	switch xState {
+	case http.StateNew:
+		xStats[sAddress] = &connectionStats{xStart: time.Now()}
+	case http.StateClosed, http.StateHijacked:
+		if xConnStats, xFound := xStats[sAddress]; xFound {
+			xElapsed := time.Since(xConnStats.xStart).Seconds()
+			log.Printf("%s closed: %d requests, %d bytes in %.3f s (%.1f KB/s)", sAddress,
+				xConnStats.ulRequests, xConnStats.ulBytes, xElapsed, float64(xConnStats.ulBytes)/1024/xElapsed)
+			delete(xStats, sAddress)
+		}
+	}
+}
+
+// A ResponseWriter that counts the body bytes and remembers the status.
+type countingWriter struct {
+	http.ResponseWriter
+	lStatus int
+	ulBytes uint64
+}
+
+func (xWriter *countingWriter) WriteHeader(lStatus int) {
+	xWriter.lStatus = lStatus
+	xWriter.ResponseWriter.WriteHeader(lStatus)
+}
+
+func (xWriter *countingWriter) Write(pucData []byte) (int, error) {
+	if xWriter.lStatus == 0 {
+		xWriter.lStatus = http.StatusOK
+	}
+	lWritten, xStatus := xWriter.ResponseWriter.Write(pucData)
+	xWriter.ulBytes += uint64(lWritten)
+	return lWritten, xStatus
+}